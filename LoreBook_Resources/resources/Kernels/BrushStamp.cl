@@ -0,0 +1,54 @@
+/// Stamp a batch of brush dabs into per-chunk delta patches.
+///
+/// Each patch is a w×h sub-rectangle of one chunk's delta grid (row 0 =
+/// north, matching the region buffers), stored back-to-back in `patches`.
+/// Texel centres are given in lon/lat radians so one dispatch can cover
+/// chunks at different quadtree depths.  Falloff is linear in the
+/// brush's normalised radius, exactly like the former CPU brush:
+///   mode=0 (Add):  v += strength * (1 - d)
+///   mode=1 (Set):  v  = strength * (1 - d)
+/// Dabs are applied in order, so overlapping Set dabs keep the last one.
+///
+/// NDRange = {patchCount, maxTexelsPerPatch}
+
+#define BRUSH_TWO_PI 6.28318530717958647692f
+
+__kernel void brush_stamp_patches(
+    __global float* patches,          // in/out: current delta values per patch
+    __global const int4* rects,       // (offset, width, height, unused)
+    __global const float4* origins,   // (lon of first texel, lat of first texel, dLon, dLat)
+    __global const float2* dabs,      // (lon, lat) in radians
+    int dabCount,
+    float radiusLon,                  // brush radius along longitude (radians)
+    float radiusLat,                  // brush radius along latitude (radians)
+    float strength,
+    int mode)                         // 0=Add, 1=Set
+{
+    int p = get_global_id(0);
+    int t = get_global_id(1);
+
+    int4 r = rects[p];
+    if (t >= r.y * r.z)
+        return;
+
+    int col = t % r.y;
+    int row = t / r.y;
+    float4 o = origins[p];
+    float lon = o.x + (float)col * o.z;
+    float lat = o.y - (float)row * o.w;   // rows run north → south
+
+    float v = patches[r.x + t];
+    for (int i = 0; i < dabCount; i++) {
+        float2 dab = dabs[i];
+        float dx = lon - dab.x;
+        dx -= BRUSH_TWO_PI * round(dx / BRUSH_TWO_PI);   // shortest way round
+        dx /= radiusLon;
+        float dy = (lat - dab.y) / radiusLat;
+        float d = sqrt(dx * dx + dy * dy);
+        if (d > 1.0f)
+            continue;
+        float s = strength * (1.0f - d);
+        v = (mode == 0) ? v + s : s;
+    }
+    patches[r.x + t] = v;
+}
@@ -141,3 +141,103 @@ __kernel void drawBuildings(
 
     output[idx] = result;
 }
+
+// ── region kernel ───────────────────────────────────────────────────────────
+//
+// Renders one chunk. Texel (row, col) maps to map cell
+// (originX + row * stepX, originY + col * stepY), so the chunk resolves
+// building detail at whatever scale its depth implies. The host culls the
+// geometry against the chunk footprint and passes only the overlapping
+// rooms / buildings as index lists.
+
+__kernel void drawBuildingsRegion(
+    // ── room polygon data (shared with drawBuildings) ──
+    __global const float2* roomVertices,
+    __global const int*    roomVertStart,
+    __global const int*    roomVertCount,
+    __global const float4* roomFillColors,
+    __global const float4* roomBounds,
+    __global const int*    visibleRooms,    // room indices overlapping the chunk
+    const int              visibleRoomCount,
+
+    // ── segment data (shared with drawBuildings) ──
+    __global const float4* segments,
+    __global const float4* segColors,
+    __global const float*  segHalfThick,
+
+    // ── per-building culling data ──
+    __global const float4* buildingBounds,
+    __global const int*    buildingSegStart,
+    __global const int*    buildingSegEnd,
+    __global const int*    visibleBuildings,// building indices overlapping the chunk
+    const int              visibleBuildingCount,
+
+    // ── output ──
+    const int              resLat,
+    const int              resLon,
+    const float            originX,
+    const float            originY,
+    const float            stepX,
+    const float            stepY,
+    __global float4*       output)
+{
+    int row = get_global_id(0);
+    int col = get_global_id(1);
+    if (row >= resLat || col >= resLon) return;
+
+    float px = originX + (float)row * stepX;
+    float py = originY + (float)col * stepY;
+    float2 p = (float2)(px, py);
+
+    float4 result = (float4)(0.88f, 0.85f, 0.78f, 1.0f);
+
+    // ── 1. Room fills ──
+    for (int i = 0; i < visibleRoomCount; i++) {
+        int r = visibleRooms[i];
+        float4 rb = roomBounds[r];
+        if (px < rb.x || px > rb.z || py < rb.y || py > rb.w)
+            continue;
+
+        if (pointInPolygon(p, roomVertices, roomVertStart[r], roomVertCount[r])) {
+            float4 fc = roomFillColors[r];
+            float srcA = clamp(fc.w, 0.0f, 1.0f);
+            result.xyz = fc.xyz * srcA + result.xyz * (1.0f - srcA);
+            result.w   = srcA + result.w * (1.0f - srcA);
+        }
+    }
+
+    // ── 2. Segments ──
+    // Keep strokes at least half a texel wide so walls stay visible when a
+    // coarse chunk covers many map cells per texel.
+    float minHalf = 0.5f * max(stepX, stepY);
+    float  bestDistSq = 1e20f;
+    float4 bestColor  = (float4)(0.0f, 0.0f, 0.0f, 0.0f);
+
+    for (int i = 0; i < visibleBuildingCount; i++) {
+        int b = visibleBuildings[i];
+        float4 bb = buildingBounds[b];
+        float  margin = 20.0f + minHalf;
+        if (px < bb.x - margin || px > bb.z + margin ||
+            py < bb.y - margin || py > bb.w + margin)
+            continue;
+
+        for (int s = buildingSegStart[b]; s < buildingSegEnd[b]; s++) {
+            float4 seg = segments[s];
+            float dSq = distToSegmentSq(p, (float2)(seg.x, seg.y), (float2)(seg.z, seg.w));
+            float ht  = max(segHalfThick[s], minHalf);
+
+            if (dSq < ht * ht && dSq <= bestDistSq) {
+                bestDistSq = dSq;
+                bestColor  = segColors[s];
+            }
+        }
+    }
+
+    if (bestDistSq < 1e19f) {
+        float srcA = clamp(bestColor.w, 0.0f, 1.0f);
+        result.xyz = bestColor.xyz * srcA + result.xyz * (1.0f - srcA);
+        result.w   = srcA + result.w * (1.0f - srcA);
+    }
+
+    output[row * resLon + col] = result;
+}
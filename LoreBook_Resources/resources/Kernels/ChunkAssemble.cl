@@ -72,3 +72,81 @@ __kernel void clear_viewport_rgba(
 
     viewportData[y * viewportW + x] = clearColor;
 }
+
+// ─────────────────────────────────────────────────────────────────────
+// Batched assembly: one dispatch composes every visible chunk.
+//
+// Chunk texels are packed into a single atlas buffer (one fixed-size
+// slot per chunk).  The descriptor table tells each work-group slice
+// where its chunk lives in the atlas and where it lands in the viewport.
+// Layout must match ChunkAssembler::ChunkDescriptor on the host.
+// ─────────────────────────────────────────────────────────────────────
+
+typedef struct {
+    int srcOffset; // first texel of this chunk inside the atlas
+    int resX;      // chunk columns
+    int resY;      // chunk rows
+    int destX;     // top-left column in the viewport
+    int destY;     // top-left row in the viewport
+    int pad0;
+    int pad1;
+    int pad2;
+} ChunkDescriptor;
+
+/// NDRange = {maxResX, maxResY, chunkCount}
+__kernel void assemble_chunks_rgba(
+    __global const float4* atlas,
+    __global const ChunkDescriptor* descriptors,
+    int chunkCount,
+    __global float4* viewportData,
+    int viewportW,
+    int viewportH)
+{
+    int cx = get_global_id(0);
+    int cy = get_global_id(1);
+    int ci = get_global_id(2);
+
+    if (ci >= chunkCount)
+        return;
+
+    ChunkDescriptor d = descriptors[ci];
+    if (cx >= d.resX || cy >= d.resY)
+        return;
+
+    int dx = d.destX + cx;
+    int dy = d.destY + cy;
+
+    if (dx < 0 || dx >= viewportW || dy < 0 || dy >= viewportH)
+        return;
+
+    viewportData[dy * viewportW + dx] = atlas[d.srcOffset + cy * d.resX + cx];
+}
+
+/// Scalar (float) variant of assemble_chunks_rgba.
+__kernel void assemble_chunks_scalar(
+    __global const float* atlas,
+    __global const ChunkDescriptor* descriptors,
+    int chunkCount,
+    __global float* viewportData,
+    int viewportW,
+    int viewportH)
+{
+    int cx = get_global_id(0);
+    int cy = get_global_id(1);
+    int ci = get_global_id(2);
+
+    if (ci >= chunkCount)
+        return;
+
+    ChunkDescriptor d = descriptors[ci];
+    if (cx >= d.resX || cy >= d.resY)
+        return;
+
+    int dx = d.destX + cx;
+    int dy = d.destY + cy;
+
+    if (dx < 0 || dx >= viewportW || dy < 0 || dy >= viewportH)
+        return;
+
+    viewportData[dy * viewportW + dx] = atlas[d.srcOffset + cy * d.resX + cx];
+}
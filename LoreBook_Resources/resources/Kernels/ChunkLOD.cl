@@ -0,0 +1,139 @@
+// ChunkLOD.cl — Rebuild chunk buffers from neighbouring quadtree levels.
+//
+// All buffers are row-major with row 0 at the northern edge.  A parent's
+// quadrant (qx, qy) is one child: qx = 0 west / 1 east, qy = 0 south /
+// 1 north (ChunkCoord::y counts from the south).
+
+// ── helpers ─────────────────────────────────────────────────────────────────
+
+// Catmull-Rom weights for fractional offset t in [0, 1)
+float4 lod_cubic_weights(float t)
+{
+    float t2 = t * t;
+    float t3 = t2 * t;
+    return (float4)(-0.5f * t3 + t2 - 0.5f * t,
+                     1.5f * t3 - 2.5f * t2 + 1.0f,
+                    -1.5f * t3 + 2.0f * t2 + 0.5f * t,
+                     0.5f * t3 - 0.5f * t2);
+}
+
+// Parent texel-space position (texel centres at integers) of child texel
+// (row, col) in quadrant (qx, qy)
+float2 lod_parent_position(int row, int col, int qx, int qy,
+                           int resY, int resX, int parentResY, int parentResX)
+{
+    float u = ((float)qx + ((float)col + 0.5f) / (float)resX) * 0.5f;
+    float v = ((float)(1 - qy) + ((float)row + 0.5f) / (float)resY) * 0.5f;
+    return (float2)(u * (float)parentResX - 0.5f, v * (float)parentResY - 0.5f);
+}
+
+// ── kernels ─────────────────────────────────────────────────────────────────
+
+// Bicubic crop of one parent quadrant at child resolution.  Taps clamp at
+// the parent's border; the result is a stand-in until the child is
+// generated, so the slight seam there is never permanent.
+__kernel void lod_upsample_rgba(
+    __global const float4* parent,
+    __global float4*       child,
+    const int              parentResY,
+    const int              parentResX,
+    const int              resY,
+    const int              resX,
+    const int              qx,
+    const int              qy)
+{
+    int row = get_global_id(0);
+    int col = get_global_id(1);
+    if (row >= resY || col >= resX) return;
+
+    float2 p = lod_parent_position(row, col, qx, qy, resY, resX, parentResY, parentResX);
+    float2 base = floor(p);
+    float4 wx = lod_cubic_weights(p.x - base.x);
+    float4 wy = lod_cubic_weights(p.y - base.y);
+    int bx = (int)base.x - 1;
+    int by = (int)base.y - 1;
+
+    float w[4] = {wy.x, wy.y, wy.z, wy.w};
+    float4 sum = (float4)(0.0f);
+    for (int j = 0; j < 4; j++) {
+        int r = clamp(by + j, 0, parentResY - 1);
+        __global const float4* src = parent + r * parentResX;
+        float4 line = src[clamp(bx,     0, parentResX - 1)] * wx.x
+                    + src[clamp(bx + 1, 0, parentResX - 1)] * wx.y
+                    + src[clamp(bx + 2, 0, parentResX - 1)] * wx.z
+                    + src[clamp(bx + 3, 0, parentResX - 1)] * wx.w;
+        sum += line * w[j];
+    }
+    // Catmull-Rom overshoots around hard edges
+    child[row * resX + col] = clamp(sum, 0.0f, 1.0f);
+}
+
+// Nearest-texel crop for scalar buffers: several layers store ids (land
+// type, nation) that must not be blended into values that do not exist.
+__kernel void lod_upsample_scalar(
+    __global const float* parent,
+    __global float*       child,
+    const int             parentResY,
+    const int             parentResX,
+    const int             resY,
+    const int             resX,
+    const int             qx,
+    const int             qy)
+{
+    int row = get_global_id(0);
+    int col = get_global_id(1);
+    if (row >= resY || col >= resX) return;
+
+    float2 p = lod_parent_position(row, col, qx, qy, resY, resX, parentResY, parentResX);
+    int pc = clamp((int)round(p.x), 0, parentResX - 1);
+    int pr = clamp((int)round(p.y), 0, parentResY - 1);
+    child[row * resX + col] = parent[pr * parentResX + pc];
+}
+
+// Source texel (row, col) of the 2 × 2-child mosaic, children at resY × resX
+#define LOD_MOSAIC_AT(nw, ne, sw, se, row, col, resY, resX)                          \
+    ((row) < (resY)                                                                   \
+        ? ((col) < (resX) ? (nw)[(row) * (resX) + (col)]                              \
+                          : (ne)[(row) * (resX) + (col) - (resX)])                    \
+        : ((col) < (resX) ? (sw)[((row) - (resY)) * (resX) + (col)]                   \
+                          : (se)[((row) - (resY)) * (resX) + (col) - (resX)]))
+
+// Parent from its four children by 2 × 2 box filter
+__kernel void lod_downsample_rgba(
+    __global const float4* nw,
+    __global const float4* ne,
+    __global const float4* sw,
+    __global const float4* se,
+    __global float4*       parent,
+    const int              resY,   // child (and parent) resolution
+    const int              resX)
+{
+    int row = get_global_id(0);
+    int col = get_global_id(1);
+    if (row >= resY || col >= resX) return;
+
+    int r = row * 2;
+    int c = col * 2;
+    float4 sum = LOD_MOSAIC_AT(nw, ne, sw, se, r,     c,     resY, resX)
+               + LOD_MOSAIC_AT(nw, ne, sw, se, r,     c + 1, resY, resX)
+               + LOD_MOSAIC_AT(nw, ne, sw, se, r + 1, c,     resY, resX)
+               + LOD_MOSAIC_AT(nw, ne, sw, se, r + 1, c + 1, resY, resX);
+    parent[row * resX + col] = sum * 0.25f;
+}
+
+// Scalar parents keep one child texel per footprint (ids stay ids)
+__kernel void lod_downsample_scalar(
+    __global const float* nw,
+    __global const float* ne,
+    __global const float* sw,
+    __global const float* se,
+    __global float*       parent,
+    const int             resY,
+    const int             resX)
+{
+    int row = get_global_id(0);
+    int col = get_global_id(1);
+    if (row >= resY || col >= resX) return;
+
+    parent[row * resX + col] = LOD_MOSAIC_AT(nw, ne, sw, se, row * 2, col * 2, resY, resX);
+}
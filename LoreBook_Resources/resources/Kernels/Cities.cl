@@ -0,0 +1,67 @@
+// Cities.cl — Draws settlements as discs over a lon/lat region.
+//
+// Sites arrive as unit vectors with their squared chord radius, so the
+// coverage test is a dot product and works across the antimeridian and
+// near the poles.  Where discs overlap the most populous site wins.
+
+// ── helpers ─────────────────────────────────────────────────────────────────
+
+float3 cities_unit(float lon, float lat)
+{
+    float cl = cos(lat);
+    return (float3)(cl * cos(lon), cl * sin(lon), sin(lat));
+}
+
+// ── kernel ──────────────────────────────────────────────────────────────────
+
+__kernel void cities_region(
+    __global const float4* sites,      // (x, y, z, chord² radius)
+    __global const float2* siteInfo,   // (population, capital ? 1 : 0)
+    const int              siteCount,
+    const int              resLat,
+    const int              resLon,
+    const float            lonMin,
+    const float            lonMax,
+    const float            latMin,
+    const float            latMax,
+    __global float*        population,
+    __global float4*       output)
+{
+    int row = get_global_id(0);
+    int col = get_global_id(1);
+    if (row >= resLat || col >= resLon) return;
+
+    // Row 0 is the northern edge
+    float lat = latMax - ((float)row + 0.5f) / (float)resLat * (latMax - latMin);
+    float lon = lonMin + ((float)col + 0.5f) / (float)resLon * (lonMax - lonMin);
+    float3 p = cities_unit(lon, lat);
+
+    int   best = -1;
+    float bestPop = -1.0f;
+    float bestT = 0.0f;
+    for (int i = 0; i < siteCount; i++) {
+        float4 s = sites[i];
+        float3 d = p - s.xyz;
+        float t = dot(d, d) / s.w;
+        if (t < 1.0f && siteInfo[i].x > bestPop) {
+            best = i;
+            bestPop = siteInfo[i].x;
+            bestT = t;
+        }
+    }
+
+    int idx = row * resLon + col;
+    if (best < 0) {
+        population[idx] = 0.0f;
+        output[idx] = (float4)(0.0f, 0.0f, 0.0f, 0.0f);
+        return;
+    }
+
+    bool capital = siteInfo[best].y > 0.5f;
+    float4 fill = capital ? (float4)(0.78f, 0.16f, 0.16f, 1.0f)
+                          : (float4)(0.20f, 0.18f, 0.16f, 1.0f);
+    float4 rim  = (float4)(0.96f, 0.94f, 0.90f, 1.0f);
+    // t is the squared distance ratio: outer 30% of the radius is the rim
+    population[idx] = bestPop;
+    output[idx] = bestT > 0.49f ? rim : fill;
+}
@@ -201,3 +201,46 @@ __kernel void orbital_view_orbit_lines(
         );
     }
 }
+
+// Orbit path generation for orbital_view_orbit_lines: pointsPerOrbit samples
+// evenly spaced in time along each orbit, offset by the parent's position.
+// Each orbit is three float4s:
+//   orbits[o*3+0] = (P.xyz, semiMajorAxis)   P = unit vector towards periapsis
+//   orbits[o*3+1] = (Q.xyz, eccentricity)    Q = in-plane, 90° ahead of P
+//   orbits[o*3+2] = (meanAnomalyEpoch, sqrt(1 - e^2), 0, 0)
+// Kepler's equation is solved with a fixed number of Newton steps from
+// Danby's starting guess, matching solveKeplerBatch on the host.
+
+#define KEPLER_PATH_ITERATIONS 8
+
+__kernel void orbital_orbit_paths(
+    __global const float4* orbits,
+    __global const float4* parentOffsets,  // one per orbit
+    int orbitCount,
+    int pointsPerOrbit,
+    __global float4* points                // orbitCount * pointsPerOrbit
+)
+{
+    int gid = get_global_id(0);
+    if (gid >= orbitCount * pointsPerOrbit) return;
+    int o = gid / pointsPerOrbit;
+    int k = gid - o * pointsPerOrbit;
+
+    float4 p = orbits[o * 3 + 0];
+    float4 q = orbits[o * 3 + 1];
+    float4 m = orbits[o * 3 + 2];
+    float e = q.w;
+
+    const float twoPi = 6.28318530718f;
+    float M = m.x + twoPi * (float)k / (float)pointsPerOrbit;
+    M -= twoPi * floor(M / twoPi);
+
+    float E = M + (sin(M) < 0.0f ? -0.85f : 0.85f) * e;
+    for (int it = 0; it < KEPLER_PATH_ITERATIONS; ++it)
+        E -= (E - e * sin(E) - M) / (1.0f - e * cos(E));
+
+    float xo = p.w * (cos(E) - e);
+    float yo = p.w * m.y * sin(E);
+    float3 pos = parentOffsets[o].xyz + p.xyz * xo + q.xyz * yo;
+    points[gid] = (float4)(pos, 0.0f);
+}
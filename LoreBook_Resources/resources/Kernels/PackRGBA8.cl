@@ -0,0 +1,13 @@
+// PackRGBA8.cl — converts float4 RGBA (0..1) to packed 8-bit UNORM texels
+// so projection output can be uploaded to an RGBA8 texture.
+
+__kernel void pack_rgba8(
+    __global const float4* src,
+    __global uchar4*       dst,
+    const int              count)
+{
+    int i = get_global_id(0);
+    if (i >= count) return;
+
+    dst[i] = convert_uchar4_sat_rte(clamp(src[i], 0.0f, 1.0f) * 255.0f);
+}
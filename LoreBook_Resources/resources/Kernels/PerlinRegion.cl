@@ -10,12 +10,10 @@
 /// The output buffer is row-major: output[latIdx * resLon + lonIdx].
 /// NDRange = {resLat, resLon}.
 
-inline float perlin3_region(float3 p, uint seed)
+/// Perlin noise at a point given its lattice cell `i`, offset `f` in the
+/// cell and fade weights `u`; fields on the same lattice share these.
+inline float perlin3_cell(int3 i, float3 f, float3 u, uint seed)
 {
-    int3 i = convert_int3(floor(p));
-    float3 f = p - floor(p);
-    float3 u = fade(f);
-
     float n000 = dot(gradient(i, seed), f);
     float n100 = dot(gradient(i + (int3)(1,0,0), seed), f - (float3)(1,0,0));
     float n010 = dot(gradient(i + (int3)(0,1,0), seed), f - (float3)(0,1,0));
@@ -36,6 +34,13 @@ inline float perlin3_region(float3 p, uint seed)
     return mix(nxy0, nxy1, u.z);
 }
 
+inline float perlin3_region(float3 p, uint seed)
+{
+    int3 i = convert_int3(floor(p));
+    float3 f = p - floor(p);
+    return perlin3_cell(i, f, fade(f), seed);
+}
+
 __kernel void perlin_fbm_3d_sphere_region(
     __global float* output,
     int resLat,           // vertical samples (rows)
@@ -86,8 +91,28 @@ __kernel void perlin_fbm_3d_sphere_region(
     output[latIdx * resLon + lonIdx] = value * 0.5f + 0.5f;
 }
 
-/// Multi-channel variant: per-channel parameters.
-__kernel void perlin_fbm_3d_sphere_region_channels(
+/// One field of a fused request; mirrors NoiseField in NoiseBackend.hpp.
+typedef struct {
+    float frequency;
+    float lacunarity;
+    float persistence;
+    int   octaves;
+    uint  seed;
+} NoiseField;
+
+/// Longest run of fields evaluated together on one lattice.
+#define FUSED_GROUP_MAX 16
+
+/// Fused multi-field variant: evaluates `fieldCount` FBM fields in one
+/// dispatch, each with its own parameters, into a planar buffer:
+/// output[f * resLat * resLon + latIdx * resLon + lonIdx].
+///
+/// The sphere position is computed once per sample.  Consecutive fields
+/// with the same frequency and lacunarity sit on the same lattice at every
+/// octave, so the cell, offset and fade weights are shared between them and
+/// only the seeded corner gradients differ.  Each field matches
+/// perlin_fbm_3d_sphere_region with the same parameters exactly.
+__kernel void perlin_fbm_3d_sphere_region_fields(
     __global float* output,
     int resLat,
     int resLon,
@@ -95,48 +120,78 @@ __kernel void perlin_fbm_3d_sphere_region_channels(
     float thetaMax,
     float phiMin,
     float phiMax,
-    int   channels,
-    __global const float* frequency,
-    __global const float* lacunarity,
-    __global const int*   octaves,
-    __global const float* persistence,
-    __global const uint*  seed)
+    int   fieldCount,
+    __constant NoiseField* fields)
 {
     int latIdx = get_global_id(0);
     int lonIdx = get_global_id(1);
 
-    if (latIdx >= resLat || lonIdx >= resLon || channels <= 0)
+    if (latIdx >= resLat || lonIdx >= resLon)
         return;
 
     float theta = thetaMin + ((float)latIdx + 0.5f) / (float)resLat * (thetaMax - thetaMin);
     float phi   = phiMin   + ((float)lonIdx + 0.5f) / (float)resLon * (phiMax   - phiMin);
 
-    for (int c = 0; c < channels; c++)
-    {
-        float3 p = (float3)(
-            sin(theta) * cos(phi),
-            sin(theta) * sin(phi),
-            cos(theta)
-        ) * frequency[c];
+    float3 unit = (float3)(
+        sin(theta) * cos(phi),
+        sin(theta) * sin(phi),
+        cos(theta)
+    );
 
-        float value = 0.0f;
-        float amplitude = 1.0f;
-        float maxAmp = 0.0f;
+    int plane = resLat * resLon;
+    int idx = latIdx * resLon + lonIdx;
+
+    float value[FUSED_GROUP_MAX];
+    float amplitude[FUSED_GROUP_MAX];
+    float maxAmp[FUSED_GROUP_MAX];
+
+    int g0 = 0;
+    while (g0 < fieldCount)
+    {
+        // Gather the run of fields sharing this lattice
+        int g1 = g0 + 1;
+        int maxOctaves = fields[g0].octaves;
+        while (g1 < fieldCount && g1 - g0 < FUSED_GROUP_MAX &&
+               fields[g1].frequency == fields[g0].frequency &&
+               fields[g1].lacunarity == fields[g0].lacunarity)
+        {
+            maxOctaves = max(maxOctaves, fields[g1].octaves);
+            g1++;
+        }
+        int count = g1 - g0;
 
-        for (int i = 0; i < octaves[c]; i++)
+        for (int k = 0; k < count; k++)
         {
-            value += perlin3_region(p, seed[c] + (uint)i * 101u) * amplitude;
-            maxAmp += amplitude;
-            amplitude *= persistence[c];
-            p *= lacunarity[c];
+            value[k] = 0.0f;
+            amplitude[k] = 1.0f;
+            maxAmp[k] = 0.0f;
         }
 
-        if (maxAmp <= 0.0f)
-            value = 0.0f;
-        else
-            value = value / maxAmp;
+        float3 p = unit * fields[g0].frequency;
+        for (int i = 0; i < maxOctaves; i++)
+        {
+            float3 fl = floor(p);
+            int3 cell = convert_int3(fl);
+            float3 f = p - fl;
+            float3 u = fade(f);
+
+            for (int k = 0; k < count; k++)
+            {
+                __constant NoiseField* fd = &fields[g0 + k];
+                if (i >= fd->octaves)
+                    continue;
+                value[k] += perlin3_cell(cell, f, u, fd->seed + (uint)i * 101u) * amplitude[k];
+                maxAmp[k] += amplitude[k];
+                amplitude[k] *= fd->persistence;
+            }
+            p *= fields[g0].lacunarity;
+        }
 
-        int idx = c * (resLat * resLon) + latIdx * resLon + lonIdx;
-        output[idx] = value * 0.5f + 0.5f;
+        for (int k = 0; k < count; k++)
+        {
+            float v = (maxAmp[k] <= 0.0f) ? 0.0f : value[k] / maxAmp[k];
+            output[(g0 + k) * plane + idx] = v * 0.5f + 0.5f;
+        }
+        g0 = g1;
     }
 }
@@ -0,0 +1,154 @@
+// Political.cl — Nation partition by weighted jump flooding.
+//
+// The flood runs on a padded grid: the requested region plus `margin`
+// texels on every side, so seeds just outside the region still propagate
+// into it.  Each texel stores the index of its best seed; candidates are
+// scored by weighted angular distance from their true positions on the
+// sphere (seeds may have been clamped onto the grid border when planted).
+
+// ── helpers ─────────────────────────────────────────────────────────────────
+
+// Unit vector of padded texel (row, col); row 0 is the northern edge
+float3 political_texel_unit(int row, int col, int margin, int resLat, int resLon,
+                            float lonMin, float lonMax, float latMin, float latMax)
+{
+    float lat = latMax - ((float)(row - margin) + 0.5f) / (float)resLat * (latMax - latMin);
+    float lon = lonMin + ((float)(col - margin) + 0.5f) / (float)resLon * (lonMax - lonMin);
+    lat = clamp(lat, -1.5707963f, 1.5707963f);
+    float cl = cos(lat);
+    return (float3)(cl * cos(lon), cl * sin(lon), sin(lat));
+}
+
+// Weighted angular distance; seeds are (x, y, z, weight)
+float political_cost(float3 p, float4 seed)
+{
+    return acos(clamp(dot(p, seed.xyz), -1.0f, 1.0f)) / seed.w;
+}
+
+// Nation id of padded texel (row, col), or -1 when unowned / out of range
+float political_nation_at(__global const int* owner, __global const float4* seeds,
+                          __global const float* nations, float range,
+                          int row, int col, int padLat, int padLon, int margin,
+                          int resLat, int resLon,
+                          float lonMin, float lonMax, float latMin, float latMax)
+{
+    row = clamp(row, 0, padLat - 1);
+    col = clamp(col, 0, padLon - 1);
+    int s = owner[row * padLon + col];
+    if (s < 0) return -1.0f;
+    float3 p = political_texel_unit(row, col, margin, resLat, resLon, lonMin, lonMax, latMin, latMax);
+    if (political_cost(p, seeds[s]) > range) return -1.0f;
+    return nations[s];
+}
+
+float4 political_nation_color(float id)
+{
+    // Golden-ratio hue walk keeps neighbouring ids apart
+    uint n = (uint)id;
+    float h = fract((float)(n % 4096u) * 0.6180340f);
+    float s = 0.45f + 0.25f * (float)((n >> 12) % 3u) / 2.0f;
+    float v = 0.80f;
+    float3 k = (float3)(1.0f, 2.0f / 3.0f, 1.0f / 3.0f);
+    float3 p = fabs(fract((float3)(h) + k) * 6.0f - (float3)(3.0f));
+    float3 rgb = v * mix((float3)(1.0f), clamp(p - (float3)(1.0f), 0.0f, 1.0f), s);
+    return (float4)(rgb, 0.6f);
+}
+
+// ── kernels ─────────────────────────────────────────────────────────────────
+
+__kernel void political_jfa_step(
+    __global const int*    src,
+    __global int*          dst,
+    __global const float4* seeds,
+    const int              padLat,
+    const int              padLon,
+    const int              step,
+    const int              margin,
+    const int              resLat,
+    const int              resLon,
+    const float            lonMin,
+    const float            lonMax,
+    const float            latMin,
+    const float            latMax)
+{
+    int row = get_global_id(0);
+    int col = get_global_id(1);
+    if (row >= padLat || col >= padLon) return;
+
+    float3 p = political_texel_unit(row, col, margin, resLat, resLon, lonMin, lonMax, latMin, latMax);
+    int idx = row * padLon + col;
+    int best = src[idx];
+    float bestCost = best >= 0 ? political_cost(p, seeds[best]) : INFINITY;
+
+    for (int dy = -1; dy <= 1; dy++) {
+        int r = row + dy * step;
+        if (r < 0 || r >= padLat) continue;
+        for (int dx = -1; dx <= 1; dx++) {
+            int c = col + dx * step;
+            if (c < 0 || c >= padLon) continue;
+            int cand = src[r * padLon + c];
+            if (cand < 0 || cand == best) continue;
+            float cost = political_cost(p, seeds[cand]);
+            // Ties go to the lower index so results are order independent
+            if (cost < bestCost || (cost == bestCost && cand < best)) {
+                best = cand;
+                bestCost = cost;
+            }
+        }
+    }
+    dst[idx] = best;
+}
+
+__kernel void political_resolve(
+    __global const int*    owner,
+    __global const float4* seeds,
+    __global const float*  nations,
+    __global const float*  elevation,   // resLat × resLon, ignored when !hasElevation
+    const int              hasElevation,
+    const float            seaLevel,
+    const float            range,
+    const int              padLat,
+    const int              padLon,
+    const int              margin,
+    const int              resLat,
+    const int              resLon,
+    const float            lonMin,
+    const float            lonMax,
+    const float            latMin,
+    const float            latMax,
+    __global float*        sampleOut,
+    __global float4*       colorOut)
+{
+    int row = get_global_id(0);
+    int col = get_global_id(1);
+    if (row >= resLat || col >= resLon) return;
+
+    int idx = row * resLon + col;
+    if (hasElevation && elevation[idx] < seaLevel) {
+        sampleOut[idx] = 0.0f;
+        colorOut[idx] = (float4)(0.0f, 0.0f, 0.0f, 0.0f);
+        return;
+    }
+
+    int pr = row + margin;
+    int pc = col + margin;
+    float id = political_nation_at(owner, seeds, nations, range, pr, pc, padLat, padLon, margin,
+                                   resLat, resLon, lonMin, lonMax, latMin, latMax);
+    sampleOut[idx] = id + 1.0f;
+    if (id < 0.0f) {
+        colorOut[idx] = (float4)(0.55f, 0.53f, 0.48f, 0.35f);
+        return;
+    }
+
+    // Border where a 4-neighbour (read from the padded grid, so chunk
+    // edges see across) belongs to another nation
+    bool border = false;
+    const int2 offsets[4] = {(int2)(-1, 0), (int2)(1, 0), (int2)(0, -1), (int2)(0, 1)};
+    for (int i = 0; i < 4 && !border; i++) {
+        float other = political_nation_at(owner, seeds, nations, range,
+                                          pr + offsets[i].x, pc + offsets[i].y, padLat, padLon, margin,
+                                          resLat, resLon, lonMin, lonMax, latMin, latMax);
+        border = other != id;
+    }
+    colorOut[idx] = border ? (float4)(0.12f, 0.10f, 0.10f, 0.9f) : political_nation_color(id);
+}
@@ -1,4 +1,8 @@
-#include "Util.cl"
+// Rivers.cl — Drainage accumulation and river rasterisation.
+//
+// The drainage network itself (depression filling, D8 receivers) is built
+// on the host by Hydrology; these kernels accumulate drainage area down the
+// receiver tree and draw the resulting rivers into map regions.
 
 inline void atomic_add_float(__global float* addr, float val) {
     __global volatile uint* iptr = (__global volatile uint*)addr;
@@ -14,191 +18,117 @@ inline void atomic_add_float(__global float* addr, float val) {
     }
 }
 
-__kernel void river_flow_source(
-    __global const float* elevation,
-    __global const float* water,
-    int latitudeResolution,
-    int longitudeResolution,
-    __global float* flow,
-    float minHeight,
-    float maxHeight,
-    float chance
+// ── Accumulation (topological wavefront) ────────────────────────────────────
+
+// Cells whose donors have all pushed join this wave's frontier.
+__kernel void river_d8_frontier(
+    __global const int* pending,
+    __global uchar* done,
+    __global uchar* frontier,
+    int count
 )
 {
-    int x = get_global_id(0);
-    int y = get_global_id(1);
-
-    if (x >= longitudeResolution || y >= latitudeResolution)
-        return;
-
-    int idx = x + y * longitudeResolution;
-
-    float h0 = elevation[idx];
-
-    // if underwater, no flow source
-    if (water[idx] > 0.0f ||
-     elevation[idx] <= minHeight ||
-     elevation[idx] >= maxHeight) {
-        flow[idx] = 0.0f;
-        return;
-    }
+    int i = get_global_id(0);
+    if (i >= count) return;
 
-    flow[idx] = rand_chance(12345, x, y, chance) ? 1.0f : 0.0f;
+    bool ready = !done[i] && pending[i] == 0;
+    frontier[i] = ready ? 1 : 0;
+    if (ready) done[i] = 1;
 }
 
-inline int2 compute_flow_direction(
-    int latitude,
-    int longitude,
-    __global const float* elevation,
-    __global const float* water_table,
-    int latitudeResolution,
-    int longitudeResolution
-) {
-    if (latitude <= 0 || longitude <= 0 ||
-        latitude >= latitudeResolution - 1 ||
-        longitude >= longitudeResolution - 1) {
-        return (int2)(latitude, longitude);
-    }
-
-    int idx = longitude * latitudeResolution + latitude;
-
-    // Ocean is terminal
-    if (water_table[idx] > 0.0f) {
-        return (int2)(latitude, longitude);
-    }
-
-    float min_h = elevation[idx];
-    int2 best = (int2)(latitude, longitude);
-
-    for (int dy = -1; dy <= 1; dy++) {
-        for (int dx = -1; dx <= 1; dx++) {
-            if (dx == 0 && dy == 0) continue;
-
-            int nx = latitude + dx;
-            int ny = longitude + dy;
-            int nidx = ny * latitudeResolution + nx;
-
-            // Hard preference: drain into ocean
-            if (water_table[nidx] > 0.0f) {
-                return (int2)(nx, ny);
-            }
-
-            float nh = elevation[nidx];
-            if (nh < min_h) {
-                min_h = nh;
-                best = (int2)(nx, ny);
-            }
-        }
-    }
-
-    return best;
+// Frontier cells pass their (now final) area on to their receiver.
+__kernel void river_d8_push(
+    __global const int* receivers,
+    __global const uchar* frontier,
+    __global float* accumulation,
+    __global int* pending,
+    __global int* pushed,
+    int count
+)
+{
+    int i = get_global_id(0);
+    if (i >= count || !frontier[i]) return;
+
+    atomic_inc(pushed);
+    int r = receivers[i];
+    if (r < 0) return;
+    atomic_add_float(&accumulation[r], accumulation[i]);
+    atomic_dec(&pending[r]);
 }
 
-__kernel void river_flow_accumulate(
-    __global const float* elevation,
-    __global const float* water,
-    __global const float* flow_sources,
-    int latitudeResolution,
-    int longitudeResolution,
-    __global const float* flow_in,
-    __global float* flow_out,
-    __global const float2* momentum_in,
-    __global float2* momentum_out,
-    const float river_threshold,
-    const float slope_epsilon,
-    const float height_epsilon,
-    const float momentum_strength
-) {
-    int latitude  = get_global_id(0);
-    int longitude = get_global_id(1);
-
-    if (latitude <= 0 || longitude <= 0 ||
-        latitude >= latitudeResolution - 1 ||
-        longitude >= longitudeResolution - 1) {
-        return;
-    }
-
-    int idx = longitude * latitudeResolution + latitude;
-
-    // Ocean absorbs everything
-    if (water[idx] > 0.0f) {
-        flow_out[idx] = 0.0f;
-        return;
-    }
-
-    // Start with incoming flow + local source
-    float local_flow = flow_in[idx] + flow_sources[idx];
-
-    // Get gravity-based flow direction (steepest descent)
-    int2 gravity_dir = compute_flow_direction(
-        latitude,
-        longitude,
-        elevation,
-        water,
-        latitudeResolution,
-        longitudeResolution
-    );
-
-    // Compute gravity direction vector
-    float2 gravity_vec = (float2)(
-        (float)(gravity_dir.x - latitude),
-        (float)(gravity_dir.y - longitude)
-    );
-
-    // Get previous momentum
-    float2 prev_momentum = momentum_in[idx];
-
-    // Blend momentum with gravity (momentum gives rivers inertia)
-    float2 new_momentum = normalize(prev_momentum * momentum_strength + gravity_vec * (1.0f - momentum_strength));
-    
-    // Handle zero vector case
-    if (length(new_momentum) < 0.001f) {
-        new_momentum = gravity_vec;
-    }
-    
-    // Store updated momentum
-    momentum_out[idx] = new_momentum;
-
-    // Convert momentum back to discrete direction
-    int2 d = (int2)(
-        latitude + (int)round(new_momentum.x),
-        longitude + (int)round(new_momentum.y)
-    );
-
-    // Clamp to valid range
-    d.x = clamp(d.x, 0, latitudeResolution - 1);
-    d.y = clamp(d.y, 0, longitudeResolution - 1);
-
-    int didx = d.y * latitudeResolution + d.x;
-
-    // Push flow downstream (atomic for safety)
-    if (didx != idx && water[didx] <= 0.0f) {
-        atomic_add_float(&flow_out[didx], local_flow);
-    }
-
-    // Keep own value for river detection
-    flow_out[idx] += local_flow;
-
-    // River logic
-    if (flow_out[idx] < river_threshold)
-        return;
-
-    float slope = elevation[idx] - elevation[didx];
-
-    // Plateau spreading (braiding / floodplain)
-    if (slope < slope_epsilon) {
-        for (int dy = -1; dy <= 1; dy++) {
-            for (int dx = -1; dx <= 1; dx++) {
-                int nx = latitude + dx;
-                int ny = longitude + dy;
-                int nidx = ny * latitudeResolution + nx;
+// ── Region rasterisation ────────────────────────────────────────────────────
+
+// Nearest-cell lookup of the river grid; used when a region texel covers
+// at least half a drainage cell.  Rows of both grids start at the north.
+__kernel void river_grid_region(
+    __global const float* grid,
+    int gridRows,
+    int gridCols,
+    int resLat,
+    int resLon,
+    float lonMin,
+    float lonMax,
+    float latMin,
+    float latMax,
+    __global float* output
+)
+{
+    int row = get_global_id(0);
+    int col = get_global_id(1);
+    if (row >= resLat || col >= resLon) return;
+
+    const float pi = 3.14159265f;
+    float lat = latMax - ((float)row + 0.5f) / (float)resLat * (latMax - latMin);
+    float lon = lonMin + ((float)col + 0.5f) / (float)resLon * (lonMax - lonMin);
+    int gr = clamp((int)floor((0.5f * pi - lat) / pi * (float)gridRows), 0, gridRows - 1);
+    int gc = (int)floor((lon + pi) / (2.0f * pi) * (float)gridCols);
+    gc = ((gc % gridCols) + gridCols) % gridCols;
+
+    output[row * resLon + col] = grid[gr * gridCols + gc];
+}
 
-                if (water[nidx] <= 0.0f &&
-                    fabs(elevation[nidx] - elevation[idx]) < height_epsilon) {
+// Squared distance from p to segment a→b.
+float river_dist_sq(float2 p, float2 a, float2 b)
+{
+    float2 ab = b - a;
+    float ab2 = dot(ab, ab);
+    float t = ab2 > 1e-20f ? clamp(dot(p - a, ab) / ab2, 0.0f, 1.0f) : 0.0f;
+    float2 d = p - (a + t * ab);
+    return dot(d, d);
+}
 
-                    atomic_add_float(&flow_out[nidx], local_flow * 0.25f);
-                }
-            }
-        }
+// River segments drawn as capsules once the region is finer than the
+// drainage grid.  Segments are in region-local radians (x = longitude
+// offset scaled by cos of the region's mid latitude, y = latitude).
+__kernel void river_segments_region(
+    __global const float4* segments,      // (xA, yA, xB, yB)
+    __global const float2* segmentInfo,   // (intensity, half width)
+    int segmentCount,
+    int resLat,
+    int resLon,
+    float lonMin,
+    float lonMax,
+    float latMin,
+    float latMax,
+    float lonScale,
+    __global float* output
+)
+{
+    int row = get_global_id(0);
+    int col = get_global_id(1);
+    if (row >= resLat || col >= resLon) return;
+
+    float lat = latMax - ((float)row + 0.5f) / (float)resLat * (latMax - latMin);
+    float lon = lonMin + ((float)col + 0.5f) / (float)resLon * (lonMax - lonMin);
+    float2 p = (float2)((lon - lonMin) * lonScale, lat);
+
+    float best = 0.0f;
+    for (int i = 0; i < segmentCount; i++) {
+        float2 info = segmentInfo[i];
+        if (info.x <= best) continue;
+        float4 s = segments[i];
+        if (river_dist_sq(p, s.xy, s.zw) < info.y * info.y)
+            best = info.x;
     }
+    output[row * resLon + col] = best;
 }
@@ -274,22 +274,8 @@ inline void directionToFaceUV(float3 dir, int* face, float* u, float* v) {
     }
 }
 
-__kernel void tec_cubemap_to_latlon(
-    __global const float* cubemap,
-    __global float* latlon,
-    int uvRes,
-    int latRes,
-    int lonRes
-) {
-    int lat_idx = get_global_id(0);
-    int lon_idx = get_global_id(1);
-    
-    if (lat_idx >= latRes || lon_idx >= lonRes) return;
-    
-    // Convert to spherical
-    float lat = PI * ((float)lat_idx + 0.5f) / (float)latRes - PI * 0.5f;
-    float lon = 2.0f * PI * ((float)lon_idx + 0.5f) / (float)lonRes - PI;
-    
+// Bilinearly sample the cubemap surface in the direction of (lat, lon).
+inline float sampleCubemapLatLon(__global const float* cubemap, int uvRes, float lat, float lon) {
     // To 3D direction
     float3 dir = (float3)(cos(lat) * cos(lon), sin(lat), cos(lat) * sin(lon));
     
@@ -318,7 +304,48 @@ __kernel void tec_cubemap_to_latlon(
     
     float h0 = mix(h00, h10, su);
     float h1 = mix(h01, h11, su);
-    float height = mix(h0, h1, sv);
+    return mix(h0, h1, sv);
+}
+
+__kernel void tec_cubemap_to_latlon(
+    __global const float* cubemap,
+    __global float* latlon,
+    int uvRes,
+    int latRes,
+    int lonRes
+) {
+    int lat_idx = get_global_id(0);
+    int lon_idx = get_global_id(1);
+    
+    if (lat_idx >= latRes || lon_idx >= lonRes) return;
+    
+    // Convert to spherical
+    float lat = PI * ((float)lat_idx + 0.5f) / (float)latRes - PI * 0.5f;
+    float lon = 2.0f * PI * ((float)lon_idx + 0.5f) / (float)lonRes - PI;
     
-    latlon[lat_idx * lonRes + lon_idx] = height;
+    latlon[lat_idx * lonRes + lon_idx] = sampleCubemapLatLon(cubemap, uvRes, lat, lon);
+}
+
+// Resample the cubemap surface into a lat/lon sub-region (one chunk).
+// Row 0 is the northern edge (latMax), matching the other region layers.
+__kernel void tec_cubemap_to_region(
+    __global const float* cubemap,
+    __global float* region,
+    int uvRes,
+    int resLat,
+    int resLon,
+    float lonMin,
+    float lonMax,
+    float latMin,
+    float latMax
+) {
+    int row = get_global_id(0);
+    int col = get_global_id(1);
+
+    if (row >= resLat || col >= resLon) return;
+
+    float lat = latMax - (latMax - latMin) * ((float)row + 0.5f) / (float)resLat;
+    float lon = lonMin + (lonMax - lonMin) * ((float)col + 0.5f) / (float)resLon;
+
+    region[row * resLon + col] = sampleCubemapLatLon(cubemap, uvRes, lat, lon);
 }
@@ -4,7 +4,9 @@
 #include <CL/cl_gl.h>
 #include <glm/glm.hpp>
 #include <vector>
+#include <array>
 #include <cstdint>
+#include <random>
 
 namespace Markdown {
 
@@ -42,9 +44,20 @@ public:
     void clear();
     
     // ── CPU readback (for emission points, debugging) ──
+    //
+    // Readback is asynchronous: requestReadback() copies the mask into one
+    // of READBACK_BUFFERS pixel buffers and fences it, and pollReadback()
+    // adopts the newest copy the GPU has finished, so the CPU data lags the
+    // mask by a frame or two but never stalls the pipeline.
     
-    /// Read collision texture back to CPU buffer
-    void readback();
+    /// Queue a copy of the mask as rendered now.  `originY` is the document
+    /// y the mask was rendered at and comes back with the data.  Returns
+    /// false (nothing queued) while every buffer is still in flight.
+    bool requestReadback(float originY);
+    
+    /// Adopt the newest finished readback, if any.  Returns true when the
+    /// CPU data changed.
+    bool pollReadback();
     
     /// Sample alpha at a given document coordinate (0-1 range)
     float sample(float x, float y) const;
@@ -57,7 +70,10 @@ public:
     /// Compute approximate surface normal at a point
     glm::vec2 surfaceNormal(float x, float y) const;
     
-    /// Get emission points within a bounding box where alpha > threshold
+    /// Get emission points (mask texels) within a bounding box where
+    /// alpha > threshold.  Every texel when there are at most maxPoints,
+    /// else maxPoints uniform samples (which may repeat) drawn from the
+    /// per-row runs of solid texels.
     void getEmissionPoints(const glm::vec2& min, const glm::vec2& max,
                            float threshold, std::vector<glm::vec2>& outPoints,
                            int maxPoints = 100);
@@ -83,10 +99,18 @@ public:
     bool hasCPUData() const { return !m_cpuBuffer.empty(); }
     const uint8_t* getCPUData() const { return m_cpuBuffer.data(); }
     size_t getCPUDataSize() const { return m_cpuBuffer.size(); }
+    /// Document y the CPU data was rendered at (see requestReadback)
+    float getCPUDataOriginY() const { return m_cpuOriginY; }
+    /// Incremented whenever the CPU data changes
+    uint64_t getCPUDataGeneration() const { return m_cpuGeneration; }
 
 private:
     void createCLImage();
     void destroyCLImage();
+    void destroyReadbackBuffers();
+    
+    /// Rebuild m_runs for texels above thresh8 if the data or threshold changed
+    void ensureRuns(uint8_t thresh8);
     
     GLuint m_fbo = 0;
     GLuint m_texture = 0;       // R8 texture storing alpha values
@@ -99,7 +123,34 @@ private:
     int m_height = 0;
     
     std::vector<uint8_t> m_cpuBuffer;
+    float m_cpuOriginY = 0.0f;
+    uint64_t m_cpuGeneration = 0;
     GLint m_prevFBO = 0;
+    
+    // Asynchronous readback ring
+    static constexpr int READBACK_BUFFERS = 3;
+    struct Readback {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+        float originY = 0.0f;
+        uint64_t serial = 0;      // request order; 0 = idle
+    };
+    std::array<Readback, READBACK_BUFFERS> m_readbacks;
+    uint64_t m_readbackSerial = 0;
+    
+    // Solid texel runs [x0, x1) per row, rebuilt lazily per CPU data generation
+    struct Run { int x0, x1; };
+    std::vector<Run> m_runs;
+    std::vector<uint32_t> m_rowRuns;          // first run of each row, size = height + 1
+    uint64_t m_runsGeneration = 0;
+    int m_runsThreshold = -1;
+    
+    // Runs clipped to a query rectangle, with cumulative texel counts
+    std::vector<Run> m_queryRuns;
+    std::vector<uint32_t> m_queryRows;
+    std::vector<uint64_t> m_queryCumulative;
+    
+    std::mt19937 m_rng{std::random_device{}()};
 };
 
 } // namespace Markdown
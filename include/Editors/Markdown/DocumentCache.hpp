@@ -0,0 +1,69 @@
+#pragma once
+#include <Editors/Markdown/MarkdownDocument.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Markdown {
+
+// ────────────────────────────────────────────────────────────────────
+// DocumentCache - parsed documents shared by content
+// ────────────────────────────────────────────────────────────────────
+
+/// Parsed documents keyed by a hash of their source, so previews showing
+/// the same text (split panes, popups, embedded nodes) parse it once and
+/// hold the same MarkdownDocument.
+///
+/// Holders keep documents alive through their shared_ptr; the cache keeps
+/// up to `capacity` documents nobody holds, least recently used first out.
+/// Block ids are unique across documents, so layout caches keyed by
+/// Block::id stay valid when a preview switches documents.
+class DocumentCache {
+public:
+    static DocumentCache& get();
+
+    DocumentCache(const DocumentCache&) = delete;
+    DocumentCache& operator=(const DocumentCache&) = delete;
+
+    /// Parsed document for `source`.  On a miss, `previous` (the caller's
+    /// current document) is reparsed in place when nobody else holds it,
+    /// which keeps the ids of unchanged blocks; otherwise a new one is made.
+    std::shared_ptr<MarkdownDocument> acquire(const std::string& source,
+                                              const std::shared_ptr<MarkdownDocument>& previous = nullptr);
+
+    /// Unreferenced documents kept for reuse
+    void setCapacity(size_t capacity);
+    size_t getCapacity() const { return m_capacity; }
+
+    struct Stats {
+        size_t entries = 0;     // documents in the cache
+        size_t shared = 0;      // of those, held by more than one preview
+        uint64_t hits = 0;
+        uint64_t misses = 0;    // parses
+        uint64_t evictions = 0;
+    };
+    Stats getStats() const;
+
+    /// FNV-1a of a source text (also what previews compare to skip unchanged input)
+    static uint64_t hashSource(std::string_view source);
+
+private:
+    DocumentCache() = default;
+
+    struct Entry {
+        std::shared_ptr<MarkdownDocument> document;
+        uint64_t lastUse = 0;
+    };
+
+    void trim();
+
+    std::unordered_map<uint64_t, Entry> m_entries;  // by hashSource()
+    size_t m_capacity = 16;
+    uint64_t m_clock = 0;
+    Stats m_stats;
+};
+
+} // namespace Markdown
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace Markdown {
+
+/// Per-particle-count timings of the SPH fluid step.
+struct FluidBenchResult {
+    size_t particles = 0;
+    double hostGridMs = 0.0;    // readback + host hash grid + upload (the previous path)
+    double deviceGridMs = 0.0;  // FluidSolver::buildGrid on the device
+    double stepMs = 0.0;        // device grid + density + forces
+    bool gridMatches = false;   // device buckets hold the same particles as the host build
+};
+
+/// Drop a block of fluid particles (a dam break, SPH defaults) of each
+/// size in `counts` and time the neighbour grid and full SPH step, host
+/// grid against device grid.  Requires an initialized OpenCLContext and
+/// the embedded resources mounted.
+std::vector<FluidBenchResult> runFluidBenchmark(const std::vector<size_t>& counts = {4096, 16384, 32768, 65536},
+                                                int steps = 32);
+
+/// Print a result table through PLOG.  Returns false if a device grid
+/// disagreed with the host build.
+bool logFluidBenchmark(const std::vector<FluidBenchResult>& results);
+
+} // namespace Markdown
@@ -0,0 +1,89 @@
+#pragma once
+#include <Editors/Markdown/Effect.hpp>
+#include <CL/cl.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Markdown {
+
+// ────────────────────────────────────────────────────────────────────
+// FluidSolver - SPH passes for fluid particle behaviors
+// ────────────────────────────────────────────────────────────────────
+
+/// Runs the SPH density/pressure and force passes over a particle buffer
+/// in place.  The neighbour grid is a spatial hash rebuilt on the device
+/// every step (histogram, single work-group prefix scan, scatter), so the
+/// solver never reads particles back or uploads a grid from the host.
+class FluidSolver {
+public:
+    static constexpr size_t MAX_BEHAVIORS = 16;
+    /// Hash table size (prime), large enough that tens of thousands of
+    /// particles rarely share a bucket with a distant cell
+    static constexpr uint32_t GRID_TABLE_SIZE = 16381;
+
+    FluidSolver() = default;
+    ~FluidSolver() { cleanup(); }
+
+    FluidSolver(const FluidSolver&) = delete;
+    FluidSolver& operator=(const FluidSolver&) = delete;
+
+    /// Build the program and size the buffers for `capacity` particles.
+    /// Needs a ready OpenCL context and the embedded resources mounted.
+    bool init(size_t capacity);
+    void cleanup();
+    bool isReady() const { return m_ready; }
+
+    /// Per-behavior fluid flags and parameters; uploaded only when they change
+    void setBehaviors(const std::array<int, MAX_BEHAVIORS>& isFluid,
+                      const std::array<SPHParams, MAX_BEHAVIORS>& params);
+
+    /// True when at least one behavior is flagged as a fluid
+    bool hasFluidBehaviors() const;
+
+    /// Enqueue the grid build and both SPH passes on `particles[0, count)`.
+    /// Non-blocking; returns the first failing enqueue's error.
+    cl_int step(cl_command_queue queue, cl_mem particles, uint32_t count,
+                float dt, bool allowMixing);
+
+    /// Enqueue only the neighbour grid build (step() starts with it)
+    cl_int buildGrid(cl_command_queue queue, cl_mem particles, uint32_t count);
+
+    /// Grid cell size (largest active smoothing radius)
+    float getCellSize() const { return m_cellSize; }
+
+    /// Grid buffers, for diagnostics: uint2 (start, count) per hash bucket
+    /// and the particle indices they point into
+    cl_mem getGridBuffer() const { return m_grid; }
+    cl_mem getGridEntriesBuffer() const { return m_gridEntries; }
+
+private:
+    bool m_ready = false;
+    size_t m_capacity = 0;
+
+    cl_program m_program = nullptr;
+    cl_kernel m_densityKernel = nullptr;     // Pass 1: density + pressure
+    cl_kernel m_forcesKernel = nullptr;      // Pass 2: pressure + viscosity + cohesion
+    cl_kernel m_gridClearKernel = nullptr;   // zero the per-cell histogram
+    cl_kernel m_gridCountKernel = nullptr;   // histogram + per-particle cell/rank
+    cl_kernel m_gridScanKernel = nullptr;    // histogram → (start, count) cells
+    cl_kernel m_gridScatterKernel = nullptr; // particle indices sorted by cell
+    size_t m_scanLocalSize = 1;
+
+    cl_mem m_density = nullptr;              // float[capacity]
+    cl_mem m_pressure = nullptr;             // float[capacity]
+    cl_mem m_grid = nullptr;                 // uint2[GRID_TABLE_SIZE] (start, count)
+    cl_mem m_gridEntries = nullptr;          // uint[capacity] particle indices by cell
+    cl_mem m_cellCounts = nullptr;           // uint[GRID_TABLE_SIZE]
+    cl_mem m_particleCell = nullptr;         // uint[capacity] cell hash, ~0 if not fluid
+    cl_mem m_particleRank = nullptr;         // uint[capacity] slot within the cell
+    cl_mem m_behaviorFlags = nullptr;        // int[MAX_BEHAVIORS]
+    cl_mem m_params = nullptr;               // SPHParams[MAX_BEHAVIORS]
+
+    std::array<int, MAX_BEHAVIORS> m_isFluid = {};
+    std::array<SPHParams, MAX_BEHAVIORS> m_sphParams = {};
+    bool m_behaviorsUploaded = false;
+    float m_cellSize = 5.0f;
+};
+
+} // namespace Markdown
@@ -0,0 +1,98 @@
+#pragma once
+#include <Editors/Markdown/PreviewEffectSystem.hpp>
+#include <Editors/Markdown/LayoutEngine.hpp>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace Markdown {
+
+// ────────────────────────────────────────────────────────────────────
+// GlyphStore - retained glyph instances for the preview
+// ────────────────────────────────────────────────────────────────────
+
+/// Keeps one GlyphInstance per laid-out glyph in a persistent GL buffer.
+///
+/// Every top-level block owns a slot of the buffer holding its glyphs
+/// sorted by effect.  A slot is rewritten only when its block is laid out
+/// again or moves, so a static document uploads nothing per frame.  The
+/// effect batches are rebuilt from the slots only when the emitted blocks
+/// change; drawing one is a few instanced 4-vertex strips.
+class GlyphStore {
+public:
+    GlyphStore() = default;
+    ~GlyphStore() = default;
+
+    /// Create the buffer and VAO (call with the GL context current)
+    void init();
+    void cleanup();
+
+    /// Bring the buffer in line with the last layout.  Returns true when
+    /// the batches changed.
+    bool update(const std::vector<LayoutGlyph>& glyphs,
+                const std::vector<LayoutEngine::EmittedBlock>& blocks);
+
+    /// Emitted glyphs grouped by effect, ordered by behavior ID
+    const std::vector<EffectBatch>& getBatches() const { return m_batches; }
+
+    /// Draw a batch with the currently bound program
+    void draw(const EffectBatch& batch) const;
+
+    /// Instances written by the last update (0 when nothing changed)
+    size_t getLastUploadCount() const { return m_lastUpload; }
+
+    /// Vertex-stage declarations every glyph shader starts with (after
+    /// #version): the instance attributes and expandGlyphInstance(), which
+    /// sets in_pos, in_uv, in_color and in_effectID for the quad corner
+    /// being shaded, so per-vertex effect code reads them as before.
+    static const char* vertexInputsGLSL();
+
+private:
+    /// Glyphs of one effect within a slot
+    struct Run {
+        EffectDef* effect = nullptr;
+        uint32_t first = 0;
+        uint32_t count = 0;
+        glm::vec2 boundsMin = {0, 0};
+        glm::vec2 boundsMax = {0, 0};
+    };
+
+    struct Slot {
+        uint64_t revision = 0;
+        float top = 0;
+        uint32_t first = 0;       // instance offset in the buffer
+        uint32_t capacity = 0;
+        std::vector<Run> runs;    // sorted by effect
+    };
+
+    /// Write a block's glyphs into its slot, allocating one if it is new or outgrew it
+    void writeSlot(Slot& slot, const LayoutGlyph* glyphs, size_t count);
+    /// Drop every slot and write the emitted blocks contiguously, growing the buffer if needed
+    void repack(const std::vector<LayoutGlyph>& glyphs,
+                const std::vector<LayoutEngine::EmittedBlock>& blocks);
+    void rebuildBatches(const std::vector<LayoutEngine::EmittedBlock>& blocks);
+    /// Point the instance attributes at `first` (GL 3.3 has no base instance)
+    void bindInstances(uint32_t first) const;
+
+    static uint32_t slotCapacity(size_t count) {
+        return static_cast<uint32_t>(count + count / 4 + 16);
+    }
+
+    GLuint m_vao = 0;
+    GLuint m_vbo = 0;
+    uint32_t m_capacity = 0;       // instances
+    uint32_t m_used = 0;           // allocation high-water mark
+
+    std::unordered_map<uint64_t, Slot> m_slots;   // by Block::id
+    std::vector<uint64_t> m_emittedIds;           // blocks behind m_batches
+    std::vector<EffectBatch> m_batches;
+    std::vector<GlyphInstance> m_scratch;
+    std::vector<uint32_t> m_order;
+    size_t m_lastUpload = 0;
+
+    static constexpr uint32_t INITIAL_CAPACITY = 16384;
+};
+
+} // namespace Markdown
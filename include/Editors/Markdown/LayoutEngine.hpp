@@ -6,6 +6,10 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <limits>
+#include <cstdint>
+#include <unordered_map>
+#include <algorithm>
 
 namespace Markdown {
 
@@ -32,6 +36,7 @@ struct OverlayWidget {
     std::string data;        // URL, script path, etc.
     std::string altText;     // for images
     bool checked = false;    // for checkboxes
+    uint64_t blockId = 0;    // top-level Block::id it was laid out in
 };
 
 // ────────────────────────────────────────────────────────────────────
@@ -44,20 +49,98 @@ public:
     ~LayoutEngine() = default;
     
     /// Set the effect system for resolving effect names
-    void setEffectSystem(PreviewEffectSystem* system) { m_effectSystem = system; }
+    void setEffectSystem(PreviewEffectSystem* system) { m_effectSystem = system; invalidateCache(); }
     
     /// Set base zoom scale (1.0 = default, >1 = zoomed in, <1 = zoomed out)
     void setBaseScale(float scale) { m_baseScale = scale; }
     
-    /// Perform layout on a document
+    /// Perform layout on a document.
+    ///
+    /// Top-level blocks are laid out once per (Block::id, wrap width, scale)
+    /// and cached in block-local coordinates; only blocks overlapping
+    /// [viewTop, viewBottom] plus a margin are laid out and emitted.  Blocks
+    /// never laid out at the current width take an estimated height until
+    /// they are measured, a few per call, or scrolled into view.
+    ///
+    /// Blocks further than the retain margin from the view keep only their
+    /// measured height; their glyphs, widgets and effect clones are freed
+    /// and rebuilt (identically) when they come back.
     void layout(const MarkdownDocument& doc, float wrapWidth,
                 std::vector<LayoutGlyph>& outGlyphs,
-                std::vector<OverlayWidget>& outWidgets);
+                std::vector<OverlayWidget>& outWidgets,
+                float viewTop = 0.0f,
+                float viewBottom = std::numeric_limits<float>::max());
     
     /// Get the total content height after layout
     float getContentHeight() const { return m_contentHeight; }
+    
+    /// Top-level blocks of the last layout and their document positions
+    size_t getBlockCount() const { return m_blockTops.empty() ? 0 : m_blockTops.size() - 1; }
+    float getBlockTop(size_t index) const {
+        return m_blockTops.empty() ? 0.0f : m_blockTops[std::min(index, m_blockTops.size() - 1)];
+    }
+    /// Index of the block containing document y (binary search)
+    size_t getBlockAtY(float y) const;
+    
+    /// How far the last layout moved the content at the top of the view
+    /// (blocks above it were measured); add to the scroll position to keep
+    /// the view still.
+    float getScrollAdjustment() const { return m_scrollAdjustment; }
+    
+    /// Drop every cached block layout (fonts or effects changed)
+    void invalidateCache() { m_blockCache.clear(); }
+    
+    /// Distance beyond the view edges within which laid-out blocks keep
+    /// their glyphs; further blocks keep only their height
+    void setRetainMargin(float margin) { m_retainMargin = std::max(margin, VIEW_MARGIN); }
+    float getRetainMargin() const { return m_retainMargin; }
+    
+    /// Blocks currently holding glyphs (the rest are height-only)
+    size_t getMaterializedBlockCount() const { return m_materializedBlocks; }
+    
+    /// A top-level block emitted by the last layout
+    struct EmittedBlock {
+        uint64_t id = 0;          // Block::id
+        uint64_t revision = 0;    // changes whenever the block is laid out again
+        float top = 0;            // document y its glyphs were shifted by
+        size_t firstGlyph = 0;    // range in the output glyph vector
+        size_t glyphCount = 0;
+    };
+    /// Blocks behind the glyphs of the last layout, in document order
+    const std::vector<EmittedBlock>& getEmittedBlocks() const { return m_emittedBlocks; }
 
 private:
+    /// One top-level block laid out at y = 0
+    struct BlockLayout {
+        float wrapWidth = 0;
+        float scale = 0;
+        size_t sourceOffset = 0;   // block offset when laid out
+        float height = 0;
+        uint64_t revision = 0;
+        uint64_t lastUse = 0;
+        bool materialized = false; // glyphs/widgets present (else height only)
+        std::vector<LayoutGlyph> glyphs;
+        std::vector<OverlayWidget> widgets;
+        // Effect definitions the glyphs point at
+        std::vector<std::unique_ptr<EffectDef>> inlineEffects;
+        std::vector<std::unique_ptr<Effect>> clonedEffects;
+    };
+    
+    BlockLayout& layoutTopLevelBlock(const Block& block, float wrapWidth);
+    float estimateBlockHeight(const Block& block, float wrapWidth) const;
+    static void releaseBlock(BlockLayout& entry);
+    
+    std::unordered_map<uint64_t, BlockLayout> m_blockCache;  // by Block::id
+    std::vector<float> m_blockTops;   // prefix sums of block heights, size = blocks + 1
+    std::vector<EmittedBlock> m_emittedBlocks;
+    uint64_t m_nextRevision = 1;
+    uint64_t m_layoutFrame = 0;
+    intptr_t m_cachedFontAtlas = 0;
+    const ImFont* m_cachedFont = nullptr;
+    float m_scrollAdjustment = 0;
+    float m_retainMargin = 4096.0f;
+    size_t m_materializedBlocks = 0;
+    
     // Layout state
     void resetState(float wrapWidth);
     
@@ -134,6 +217,8 @@ private:
     static constexpr float LIST_INDENT = 24.0f;
     static constexpr float QUOTE_INDENT = 20.0f;
     static constexpr float CODE_PADDING = 8.0f;
+    static constexpr float VIEW_MARGIN = 512.0f;       // laid out beyond the view edges
+    static constexpr int   MEASURE_PER_LAYOUT = 32;    // off-screen blocks measured per call
 };
 
 } // namespace Markdown
@@ -4,6 +4,7 @@
 #include <memory>
 #include <functional>
 #include <cstddef>
+#include <cstdint>
 #include <md4c.h>
 
 namespace Markdown {
@@ -73,6 +74,10 @@ class Block : public Node {
 public:
     BlockType type = BlockType::Paragraph;
     
+    /// Identity of a top-level block: kept while an incremental reparse
+    /// reuses it, fresh whenever the block is rebuilt.  0 for nested blocks.
+    uint64_t id = 0;
+    
     // Block-specific data
     int headingLevel = 0;              // 1-6 for Heading
     std::string codeLanguage;          // for CodeBlock
@@ -102,9 +107,26 @@ public:
     MarkdownDocument(MarkdownDocument&&) = default;
     MarkdownDocument& operator=(MarkdownDocument&&) = default;
     
-    /// Parse markdown string and build AST
+    /// Parse markdown string and build AST.
+    ///
+    /// The source is split at top-level block boundaries (a blank line
+    /// followed by an unindented line that cannot continue a list, quote,
+    /// code fence or effect tag) and each piece is hashed.  Only the pieces
+    /// between the unchanged prefix and suffix of the previous parse go
+    /// through md4c; the reused blocks keep their ids.  Documents with link
+    /// reference definitions, which resolve across blocks, are parsed whole.
     void parseString(const std::string& markdown);
     
+    /// Top-level blocks rebuilt by the last parseString(): the blocks at
+    /// [first, first + inserted) of getBlocks() replaced `removed` old ones.
+    struct BlockChange {
+        size_t first = 0;
+        size_t removed = 0;
+        size_t inserted = 0;
+        bool empty() const { return removed == 0 && inserted == 0; }
+    };
+    const BlockChange& lastChange() const { return m_lastChange; }
+    
     /// Clear the document
     void clear();
     
@@ -117,6 +139,9 @@ public:
     /// Get hash of last parsed source (for change detection)
     size_t sourceHash() const { return m_sourceHash; }
     
+    /// Source text of the last parse
+    const std::string& getSource() const { return m_source; }
+    
     /// Access the root document block
     Block& getRoot() { return m_root; }
     const Block& getRoot() const { return m_root; }
@@ -131,11 +156,30 @@ public:
     void visitSpans(Block& block, const SpanVisitor& visitor);
 
 private:
+    /// A run of source parsed independently into `blockCount` top-level blocks
+    struct SourceSegment {
+        size_t offset = 0;
+        size_t length = 0;
+        uint64_t hash = 0;
+        size_t blockCount = 0;
+    };
+    
     Block m_root;
     std::vector<Block*> m_blocks;  // flat view of top-level blocks
     size_t m_sourceHash = 0;
     bool m_dirty = true;
     
+    std::string m_source;                  // source of the last parse
+    std::vector<SourceSegment> m_segments; // its top-level pieces, in order
+    /// Block ids are unique across documents, so a layout cache keyed by
+    /// Block::id survives a preview switching to another document
+    static uint64_t nextBlockId();
+    BlockChange m_lastChange;
+    
+    /// Parse source[offset, offset + length) and append its top-level blocks
+    void parseSegment(const std::string& source, size_t offset, size_t length,
+                      std::vector<std::unique_ptr<Block>>& out);
+    
     // md4c parser state
     struct ParseState;
     static int enterBlock(MD_BLOCKTYPE type, void* detail, void* userdata);
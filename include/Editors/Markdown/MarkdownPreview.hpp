@@ -3,6 +3,8 @@
 #include <Editors/Markdown/PreviewEffectSystem.hpp>
 #include <Editors/Markdown/CollisionMask.hpp>
 #include <Editors/Markdown/LayoutEngine.hpp>
+#include <Editors/Markdown/GlyphStore.hpp>
+#include <Editors/Markdown/FluidSolver.hpp>
 #include <WorldMaps/World/World.hpp>
 #include <WorldMaps/World/Projections/MercatorProjection.hpp>
 #include <WorldMaps/World/Projections/SphereProjection.hpp>
@@ -16,8 +18,11 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <chrono>
 #include <memory>
+#include <array>
+#include <algorithm>
 
 class LuaScriptManager;
 class LuaEngine;
@@ -44,12 +49,14 @@ public:
     /// Check if initialized
     bool isInitialized() const { return m_initialized; }
     
-    /// Set the markdown source text
+    /// Set the markdown source text.  Unchanged text (by hash) is a no-op;
+    /// new text is parsed through the shared DocumentCache, so previews of
+    /// the same content share one parsed document.
     void setSource(const std::string& markdown);
     
-    /// Get the parsed document
-    MarkdownDocument& getDocument() { return m_document; }
-    const MarkdownDocument& getDocument() const { return m_document; }
+    /// Get the parsed document (may be shared with other previews)
+    MarkdownDocument& getDocument() { return *m_document; }
+    const MarkdownDocument& getDocument() const { return *m_document; }
     
     /// Render the preview and return the size used
     /// This renders to an FBO and displays via ImGui::Image
@@ -71,6 +78,47 @@ public:
     void setFOV(float fovDegrees) { m_fovY = fovDegrees; }
     float getFOV() const { return m_fovY; }
 
+    // ── Particle budget ──
+    /// Live particles allowed across all effects (clamped to MAX_PARTICLES).
+    /// Effects that emit share it max-min fairly: none is held below an
+    /// equal share while another exceeds it.
+    void setParticleBudget(size_t budget) { m_particleBudget = std::min(budget, MAX_PARTICLES); }
+    size_t getParticleBudget() const { return m_particleBudget; }
+    size_t getLiveParticleCount() const { return m_liveParticles; }
+
+    // ── Off-screen content ──
+    /// GPU bytes vault images drawn by previews may hold before the least
+    /// recently visible ones are released (shared by all previews; an
+    /// evicted image reloads when it scrolls back into view)
+    static void setImageMemoryBudget(size_t bytes) { s_imageBudgetBytes = bytes; }
+    static size_t getImageMemoryBudget() { return s_imageBudgetBytes; }
+    static size_t getResidentImageBytes() { return s_residentImageBytes; }
+
+    // ── Embed caches (world maps, orbital views; shared by all previews) ──
+    struct EmbedCacheStats {
+        size_t entries = 0;
+        size_t capacity = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+    /// Most worlds / orbital systems kept loaded; the least recently drawn
+    /// beyond that are released (their view state is kept)
+    static void setEmbedCacheCapacity(size_t worlds, size_t orbitals) {
+        s_worldCacheStats.capacity = std::max<size_t>(worlds, 1);
+        s_orbitalCacheStats.capacity = std::max<size_t>(orbitals, 1);
+    }
+    static EmbedCacheStats getWorldCacheStats() {
+        EmbedCacheStats st = s_worldCacheStats;
+        st.entries = s_worldCache.size();
+        return st;
+    }
+    static EmbedCacheStats getOrbitalCacheStats() {
+        EmbedCacheStats st = s_orbitalCacheStats;
+        st.entries = s_orbitalCache.size();
+        return st;
+    }
+
 private:
     // Rendering setup
     void ensureFBO(int width, int height);
@@ -83,6 +131,9 @@ private:
     void renderCollisionMask(const std::vector<EffectBatch>& batches);
     void renderGlyphBatches(const std::vector<EffectBatch>& batches, const glm::mat4& mvp);
     void renderEmbeddedContent(const glm::mat4& mvp);
+    static void evictEmbedCaches();
+    static void touchResidentImage(const std::string& key, int64_t aid, int width, int height);
+    static void evictResidentImages();
     void emitParticles(float dt, const std::vector<EffectBatch>& batches);
     void updateParticlesGPU(float dt);
     void renderParticlesFromGPU(const glm::mat4& mvp);
@@ -92,11 +143,10 @@ private:
     // OpenCL kernel management
     void updateCollisionCLImage();
     
-    // Helper methods
-    void uploadGlyphBatch(const std::vector<GlyphVertex>& vertices);
-    
     // ── Document & Layout ──
-    MarkdownDocument m_document;
+    std::shared_ptr<MarkdownDocument> m_document = std::make_shared<MarkdownDocument>();
+    std::string m_rawSource;           // setSource() input, to skip unchanged text
+    bool m_hasSource = false;
     LayoutEngine m_layoutEngine;
     std::vector<LayoutGlyph> m_layoutGlyphs;
     std::vector<OverlayWidget> m_overlayWidgets;
@@ -126,20 +176,10 @@ private:
     GLuint m_quadVBO = 0;
     
     // ── SPH / Fluid (multi-fluid support) ─────────────────────────────────────
-    cl_program m_sphProgram = nullptr;
-    cl_kernel m_sphDensityKernel = nullptr;   // Pass 1: density + pressure
-    cl_kernel m_sphForcesKernel = nullptr;    // Pass 2: pressure + viscosity + cohesion
-    cl_mem m_clSPHDensity = nullptr;          // float[MAX_PARTICLES]
-    cl_mem m_clSPHPressure = nullptr;         // float[MAX_PARTICLES]
-    cl_mem m_clSPHGrid = nullptr;             // Spatial hash grid cell starts
-    cl_mem m_clSPHGridEntries = nullptr;      // Spatial hash particle entries
-
-    // Per-behavior SPH descriptor buffers (host → CL)
-    cl_mem m_clSPHBehaviourFlags = nullptr;   // int[MAX_FLUID_BEHAVIORS] (isFluid)
-    cl_mem m_clSPHParams = nullptr;           // SPHParams[MAX_FLUID_BEHAVIORS]
+    FluidSolver m_fluidSolver;
 
     // Per-behavior density render targets (R16F) — indexed by behaviorID
-    static constexpr size_t MAX_FLUID_BEHAVIORS = 16;
+    static constexpr size_t MAX_FLUID_BEHAVIORS = FluidSolver::MAX_BEHAVIORS;
     std::array<GLuint, MAX_FLUID_BEHAVIORS> m_fluidDensityFBO = {0};
     std::array<GLuint, MAX_FLUID_BEHAVIORS> m_fluidDensityTex = {0};
 
@@ -151,7 +191,6 @@ private:
     GLuint m_bloodDensityTex = 0;             // legacy: R16F density texture (behaviorID==2)
     GLuint m_bloodFluidShader = 0;            // Post-process: density → fluid surface (generic)
 
-    void initSPH();
     void renderBloodFluid();
 
     // Ensure per-behavior density FBO exists (lazy-create)
@@ -165,16 +204,20 @@ private:
     
     // ── Scroll state ──
     float m_scrollY = 0.0f;
+    float m_viewHeight = 0.0f;     // visible document span below m_scrollY
+    /// Particles further than this outside the view are retired rather than simulated
+    static constexpr float PARTICLE_CULL_MARGIN = 512.0f;
     
     // ── Shaders ──
     GLuint m_collisionShader = 0;
+    bool m_collisionMaskDirty = true;      // glyphs, scroll or size changed since last render
+    float m_collisionMaskScrollY = 0.0f;
     static constexpr float COLLISION_SCALE = 5.0f;  // 2x supersampled collision mask
     GLuint m_particleShader = 0;
     GLuint m_embedShader = 0;              // Textured quad shader for embedded content
     
     // ── VAO/VBO ──
-    GLuint m_glyphVAO = 0;
-    GLuint m_glyphVBO = 0;
+    GlyphStore m_glyphStore;
     GLuint m_particleVAO = 0;
     GLuint m_particleVBO = 0;
     GLuint m_particleEBO = 0;
@@ -186,14 +229,19 @@ private:
     cl_mem m_clCollisionImage = nullptr;  // CL image for collision sampling
     int m_clCollisionWidth = 0;           // Tracked collision image dimensions
     int m_clCollisionHeight = 0;
+    uint64_t m_clCollisionGeneration = 0; // mask CPU data last uploaded
     size_t m_particleCount = 0;
     uint32_t m_deadCount = 0;
-    static constexpr size_t MAX_PARTICLES = 10000;
+    static constexpr size_t MAX_PARTICLES = 65536;      // buffer capacity
+    size_t m_particleBudget = 16384;                     // live particles allowed (≤ MAX_PARTICLES)
+    size_t m_liveParticles = 0;
+    std::array<uint32_t, 16> m_liveByBehavior = {};      // live particles per behaviorID
     
     // CPU particle buffer (for CPU-side emission before GPU update)
     std::vector<Particle> m_cpuParticles;
     std::vector<uint32_t> m_cpuDeadIndices;
     float m_emitAccumulators[16] = {0};  // Per-effect emission accumulators (indexed by behaviorID)
+    std::vector<glm::vec2> m_emitPoints; // glyph-shaped emission points (scratch)
     std::unordered_map<uint32_t, std::vector<uint32_t>> m_particleBehaviorGroups;
     
     // ── State ──
@@ -202,7 +250,8 @@ private:
     glm::vec4 m_clearColor = {0.1f, 0.1f, 0.12f, 1.0f};  // FBO background (from frontmatter)
     LuaScriptManager* m_scriptManager = nullptr;
     Vault* m_vault = nullptr;
-    int m_embedCounter = 0;  // Per-frame unique embed counter
+    int m_embedCounter = 0;  // Lua canvases seen so far in the current block
+    uint64_t m_embedBlockId = 0;
 
     // Active canvas instances (populated by renderEmbeddedContent, consumed by renderOverlayWidgets)
     struct ActiveCanvas {
@@ -282,6 +331,39 @@ private:
         CachedOrbitalState() : last_used(std::chrono::steady_clock::now()) {}
     };
     static std::unordered_map<std::string, CachedOrbitalState> s_orbitalCache;
+    static EmbedCacheStats s_worldCacheStats;
+    static EmbedCacheStats s_orbitalCacheStats;
+    /// Entries drawn this recently are never evicted for capacity
+    static constexpr std::chrono::seconds EMBED_IN_USE{1};
+    /// Entries not drawn for this long are evicted regardless of capacity
+    static constexpr std::chrono::seconds EMBED_EXPIRY{30};
+    static constexpr size_t MAX_PARKED_VIEWS = 256;
+
+    // View state of embeds evicted from the caches above, so one that
+    // scrolls back in resumes where it was rather than from defaults
+    struct ParkedWorldView {
+        float mercCenterLon = 0.0f, mercCenterLat = 0.0f, mercZoom = 1.0f;
+        float globeCenterLon = 0.0f, globeCenterLat = 0.0f, globeZoom = 3.0f, globeFovDeg = 45.0f;
+        int selectedLayer = 0;
+    };
+    struct ParkedOrbitalView {
+        double time = 0.0;
+        float timeSpeed = 1.0f;
+        bool playing = false;
+    };
+    static std::unordered_map<std::string, ParkedWorldView> s_parkedWorldViews;
+    static std::unordered_map<std::string, ParkedOrbitalView> s_parkedOrbitalViews;
+
+    // Vault images drawn by any preview, least recently visible evicted first
+    struct ResidentImage {
+        int64_t aid = -1;
+        size_t bytes = 0;
+        int lastFrame = 0;     // ImGui frame it was last in a layout window
+    };
+    static std::unordered_map<std::string, ResidentImage> s_residentImages;
+    static std::unordered_set<int64_t> s_pendingImageLoads;
+    static size_t s_residentImageBytes;
+    static size_t s_imageBudgetBytes;
 
     std::string m_sourceText;
     GLuint m_fontAtlasTexture = 0;
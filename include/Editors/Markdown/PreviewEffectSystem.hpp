@@ -84,16 +84,21 @@ struct LayoutGlyph {
 };
 
 // ────────────────────────────────────────────────────────────────────
-// Glyph Vertex (GPU format)
+// Glyph Instance (GPU format) — one per glyph, expanded to a quad in
+// the vertex shader (see GlyphStore::vertexInputsGLSL)
 // ────────────────────────────────────────────────────────────────────
 
-struct GlyphVertex {
-    glm::vec3 pos;      // 12 bytes
-    glm::vec2 uv;       // 8 bytes
-    glm::vec4 color;    // 16 bytes
+struct GlyphInstance {
+    glm::vec2 pos;      // 8 bytes  — top-left, document space
+    glm::vec2 size;     // 8 bytes
+    glm::vec2 uvMin;    // 8 bytes
+    glm::vec2 uvMax;    // 8 bytes
+    float z;            // 4 bytes
+    uint32_t color;     // 4 bytes  — RGBA8, red in the low byte
     uint32_t effectID;  // 4 bytes
-    float pad[3];       // 12 bytes — align to 52
+    uint32_t pad;       // 4 bytes  — align to 48
 };
+static_assert(sizeof(GlyphInstance) == 48, "GlyphInstance must match the instance attribute layout");
 
 // ────────────────────────────────────────────────────────────────────
 // GPU Particle (must match OpenCL kernel struct layout)
@@ -125,9 +130,18 @@ struct alignas(16) Particle {
 // Effect Batch (for batched rendering)
 // ────────────────────────────────────────────────────────────────────
 
+/// Contiguous instances in the GlyphStore buffer
+struct InstanceRange {
+    uint32_t first = 0;
+    uint32_t count = 0;
+};
+
 struct EffectBatch {
     EffectDef* effect = nullptr;
-    std::vector<GlyphVertex> vertices;
+    std::vector<InstanceRange> ranges;
+    uint32_t instanceCount = 0;
+    glm::vec2 boundsMin = {0, 0};   // document-space extent of the glyphs
+    glm::vec2 boundsMax = {0, 0};
 };
 
 // ────────────────────────────────────────────────────────────────────
@@ -178,10 +192,6 @@ public:
     void loadEffectsFromFile(const std::string& path);
     void reloadAll();
     
-    // Batching: group glyphs by effect for efficient rendering
-    void buildBatches(const std::vector<LayoutGlyph>& glyphs,
-                      std::vector<EffectBatch>& outBatches);
-    
     // Get shader program for an Effect's glyph rendering (falls back to base)
     GLuint getGlyphShader(const EffectDef* def);
     
@@ -213,6 +223,9 @@ public:
 
 private:
     void registerBuiltinEffects();
+    /// Hand the effect stacks remembered by ShaderProgramCache to its
+    /// background pre-warm (needs the effects registered)
+    void prewarmKnownCombinations();
     GLuint compileShaderProgram(const char* vertSrc, const char* fragSrc, const char* geomSrc = nullptr);
     
     /// Compile shaders and kernel for an Effect instance
@@ -0,0 +1,111 @@
+#pragma once
+#include <Editors/Markdown/ShaderCompositor.hpp>
+#include <GL/glew.h>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct GLFWwindow;
+
+namespace Markdown {
+
+// ────────────────────────────────────────────────────────────────────
+// ShaderProgramCache - linked GL programs persisted across launches
+// ────────────────────────────────────────────────────────────────────
+
+/// On-disk cache of linked shader programs (glGetProgramBinary /
+/// glProgramBinary), keyed by the composed sources and the GL vendor,
+/// renderer and version strings, so a driver update invalidates it.
+///
+/// It also remembers which effect-stack combinations were composed, and
+/// can pre-warm them on a hidden context sharing the main one: the
+/// worker compiles whatever is not on disk yet, and the preview later
+/// loads the binaries instead of compiling on the frame that needs them.
+class ShaderProgramCache {
+public:
+    static ShaderProgramCache& get();
+
+    ShaderProgramCache(const ShaderProgramCache&) = delete;
+    ShaderProgramCache& operator=(const ShaderProgramCache&) = delete;
+
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    bool isEnabled() const { return m_enabled; }
+    void setCacheDir(const std::filesystem::path& dir);
+    std::filesystem::path getCacheDir();
+
+    /// Whether the current context can save and load program binaries
+    bool isSupported();
+
+    /// Cache key for a program linked from `sources` on the current driver
+    std::string key(const ComposedShaderSources& sources);
+
+    /// Program from the cached binary for `key`, or 0 (miss, disabled,
+    /// or a binary the driver rejected, which is then deleted)
+    GLuint load(const std::string& key);
+
+    /// Call on a fresh program before glLinkProgram so the driver keeps a
+    /// retrievable binary
+    void prepareForLink(GLuint program);
+
+    /// Save a successfully linked program's binary under `key`
+    void store(const std::string& key, GLuint program);
+
+    // ── Known combinations ──
+
+    /// Remember that effect stack `signature` was composed as `kind`
+    /// ("glyph" or "particle"), for pre-warming on later launches
+    void rememberCombination(const std::string& kind, const std::string& signature);
+
+    /// (kind, signature) pairs remembered by previous runs
+    std::vector<std::pair<std::string, std::string>> knownCombinations();
+
+    // ── Pre-warming ──
+
+    struct PrewarmJob {
+        std::string name;
+        ComposedShaderSources sources;
+    };
+
+    void setPrewarmEnabled(bool enabled) { m_prewarmEnabled = enabled; }
+    bool isPrewarmEnabled() const { return m_prewarmEnabled; }
+
+    /// Compile the jobs missing from disk on a background thread with a
+    /// hidden context shared with `mainWindow`.  Call on the main thread
+    /// with the main context current; does nothing if a pre-warm is
+    /// already running or binaries are unsupported.
+    void prewarm(GLFWwindow* mainWindow, std::vector<PrewarmJob> jobs);
+
+    /// Wait for a running pre-warm and destroy its context (main thread).
+    /// Shared by every preview, so called once at application shutdown.
+    void finishPrewarm();
+
+    bool isPrewarming() const { return m_prewarmRunning; }
+
+private:
+    ShaderProgramCache() = default;
+    ~ShaderProgramCache();
+
+    std::filesystem::path entryPath(const std::string& key);
+    void loadCombinations();
+
+    bool m_enabled = true;
+    bool m_prewarmEnabled = true;
+    int m_supported = -1;                   // -1 = not checked yet
+
+    std::mutex m_mutex;                     // guards the fields below
+    std::filesystem::path m_cacheDir;
+    std::string m_fingerprint;              // vendor|renderer|version|GLSL version
+    bool m_combinationsLoaded = false;
+    std::set<std::pair<std::string, std::string>> m_combinations;
+
+    GLFWwindow* m_prewarmWindow = nullptr;
+    std::thread m_prewarmThread;
+    std::atomic<bool> m_prewarmRunning{false};
+};
+
+} // namespace Markdown
@@ -99,6 +99,9 @@ bool HasDynamicTexture(const std::string& key);
 // Get a dynamic texture by key (returns empty IconTexture if not found)
 IconTexture GetDynamicTexture(const std::string& key);
 
+// Delete a dynamic texture and forget its key (a later load recreates it)
+void ReleaseDynamicTexture(const std::string& key);
+
 // Get the dimensions of an icon
 bool GetIconDimensions(const std::string& iconName, int& width, int& height);
 
@@ -14,6 +14,13 @@
 #include <regex>
 #include <unordered_set>
 #include <GL/glew.h>
+#include <filesystem>
+#include <future>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <WorldMaps/World/NoiseBackend.hpp>
 
 inline static std::string normalizePath(const std::string &p) {
     std::vector<std::string> parts;
@@ -131,9 +138,52 @@ public:
     size_t getTotalAllocated() const;
 
     //program and kernel helpers
-    void createProgram(cl_program& program,std::string file_path);
+    // createProgram consults the on-disk binary cache (and any pending warm-up build)
+    // before compiling from source; on a miss the freshly built binary is stored.
+    void createProgram(cl_program& program,std::string file_path, const std::string &buildOptions = "");
     void createKernelFromProgram(cl_kernel& kernel,cl_program program, const std::string &kernelName);
 
+    // Program binary cache (CL_PROGRAM_BINARIES) — entries live under cacheDir and are
+    // keyed by a hash of preprocessed source + build options + device + driver version.
+    void setProgramCacheEnabled(bool enabled) { programCacheEnabled_ = enabled; }
+    bool isProgramCacheEnabled() const { return programCacheEnabled_; }
+    void setProgramCacheDir(const std::filesystem::path &dir);
+    const std::filesystem::path &getProgramCacheDir() const { return programCacheDir_; }
+
+    // Build every kernel file under `dir` on worker threads. Call after initGLInterop()
+    // (which recreates the context) and once the resource VFS is mounted; later
+    // createProgram() calls for those paths block on the warm-up result instead of compiling.
+    void warmUpPrograms(const std::string &dir = "Kernels");
+    void waitForWarmUp();
+
+    // Pipeline counters (cumulative since start or the last resetCounters()).
+    // Kernel times are only collected with kernel profiling enabled.
+    struct Counters {
+        uint64_t buffersCreated = 0;
+        uint64_t bytesCreated = 0;
+        uint64_t bytesReadBack = 0;
+        uint64_t kernelLaunches = 0;
+        double kernelMs = 0.0;
+        std::unordered_map<std::string, double> kernelMsByName;
+    };
+
+    // Profile every kernel launched through enqueueNDRangeKernel. Set before
+    // init()/initGLInterop(): the queue must be created with profiling enabled.
+    void setKernelProfiling(bool enabled) { kernelProfiling_ = enabled; }
+    bool isKernelProfiling() const { return kernelProfiling_; }
+
+    // Counted drop-in replacements for clEnqueueNDRangeKernel / clEnqueueReadBuffer
+    cl_int enqueueNDRangeKernel(cl_command_queue queue, cl_kernel kernel, cl_uint workDim,
+                                const size_t *globalOffset, const size_t *globalSize, const size_t *localSize,
+                                cl_uint numEvents = 0, const cl_event *waitList = nullptr, cl_event *event = nullptr);
+    cl_int enqueueReadBuffer(cl_command_queue queue, cl_mem buffer, cl_bool blocking, size_t offset, size_t size,
+                             void *ptr, cl_uint numEvents = 0, const cl_event *waitList = nullptr,
+                             cl_event *event = nullptr);
+
+    // Waits for profiled kernels still in flight, then returns the totals
+    Counters counters();
+    void resetCounters();
+
     // CL/GL interop — call after GL context is active
     bool initGLInterop();
     bool hasGLInterop() const { return clGLInterop; }
@@ -142,8 +192,17 @@ public:
     cl_mem createFromGLTexture(GLuint texID, cl_mem_flags flags, GLenum target = GL_TEXTURE_2D, GLint mipLevel = 0);
 
     // Acquire/release GL objects for CL usage
-    void acquireGLObjects(cl_mem *memObjects, int count);
-    void releaseGLObjects(cl_mem *memObjects, int count);
+    void acquireGLObjects(cl_mem *memObjects, int count, cl_uint numEvents = 0,
+                          const cl_event *waitList = nullptr, cl_event *event = nullptr);
+    void releaseGLObjects(cl_mem *memObjects, int count, cl_uint numEvents = 0,
+                          const cl_event *waitList = nullptr, cl_event *event = nullptr);
+
+    // cl_khr_gl_event: acquire/release are implicitly ordered against GL
+    // commands on this thread, and a GL fence can become a CL wait event
+    bool hasGLEventSync() const { return clGLEventFromSync != nullptr; }
+    // CL event that completes when `sync` signals; nullptr if unsupported.
+    // Keep `sync` alive until the event completes.
+    cl_event createEventFromGLsync(GLsync sync);
 
 private:
     OpenCLContext() = default;
@@ -161,6 +220,8 @@ private:
     bool clDeviceIsGPU = false;
     bool clGLInterop = false;
     bool clGLInteropAttempted = false;
+    using CreateEventFromGLsyncFn = cl_event (CL_API_CALL *)(cl_context, cl_GLsync, cl_int *);
+    CreateEventFromGLsyncFn clGLEventFromSync = nullptr;
 
     // Persistent debug buffer (always-on)
     cl_mem debugBuf_ = nullptr;
@@ -169,6 +230,31 @@ private:
     mutable std::mutex memTrackMutex_;
     std::unordered_map<cl_mem, size_t> memSizes_;
     size_t totalAllocated_ = 0;
+
+    // program binary cache
+    cl_program buildProgramFromSource(const std::string &source, const std::string &buildOptions, std::string *log);
+    cl_program loadCachedProgram(const std::string &key, const std::string &buildOptions);
+    void storeCachedProgram(const std::string &key, cl_program program);
+    std::string programCacheKey(const std::string &source, const std::string &buildOptions);
+    void releaseWarmPrograms();
+
+    bool programCacheEnabled_ = true;
+    std::filesystem::path programCacheDir_;
+    std::string deviceFingerprint_;
+    mutable std::mutex programMutex_;
+    std::unordered_map<std::string, std::shared_future<cl_program>> warmPrograms_;
+    std::vector<std::thread> warmWorkers_;
+
+    // pipeline counters
+    std::atomic<uint64_t> buffersCreated_{0};
+    std::atomic<uint64_t> bytesCreated_{0};
+    std::atomic<uint64_t> bytesReadBack_{0};
+    std::atomic<uint64_t> kernelLaunches_{0};
+    bool kernelProfiling_ = false;
+    std::mutex profileMutex_;
+    std::vector<std::pair<cl_kernel, cl_event>> profiledKernels_;
+    std::unordered_map<std::string, double> kernelMsByName_;
+    void resolveProfiledKernels();
 };
 
 
@@ -245,7 +331,7 @@ static void perlin(cl_mem& output,
     size_t global[2] = {(size_t)latitudeResolution, (size_t)longitudeResolution};
     {
         ZoneScopedN("Perlin Enqueue");
-        err = clEnqueueNDRangeKernel(queue, gPerlinKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, gPerlinKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
         if (err != CL_SUCCESS)
         {
             throw std::runtime_error("clEnqueueNDRangeKernel failed for perlin");
@@ -335,7 +421,7 @@ static void perlin_channels(cl_mem& output,
     size_t global[2] = {(size_t)latitudeResolution, (size_t)longitudeResolution};
     {
         ZoneScopedN("Perlin Channels Enqueue");
-        err = clEnqueueNDRangeKernel(queue, gPerlinChannelsKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, gPerlinChannelsKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
         if (err != CL_SUCCESS)
         {
             throw std::runtime_error("clEnqueueNDRangeKernel failed for perlin channels");
@@ -420,7 +506,7 @@ static void scalarToColor(cl_mem& output,
     
     {
         ZoneScopedN("ScalarToColor Enqueue");
-        err = clEnqueueNDRangeKernel(queue, gScalarToColorKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, gScalarToColorKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
     }
 
     OpenCLContext::get().releaseMem(paletteBuf);
@@ -503,7 +589,7 @@ static void weightedScalarToColor(cl_mem& output,
     
     {
         ZoneScopedN("WeightedScalarToColor Enqueue");
-        err = clEnqueueNDRangeKernel(queue, gWeightedScalarToColorKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, gWeightedScalarToColorKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
     }
     OpenCLContext::get().releaseMem(paletteBuf);
     OpenCLContext::get().releaseMem(weightsBuf);
@@ -577,7 +663,7 @@ static void alphaBlend(cl_mem& output,
     size_t global[2] = {(size_t)width, (size_t)height};
     {
         ZoneScopedN("AlphaBlend Enqueue");
-        err = clEnqueueNDRangeKernel(queue, gAlphaBlendKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, gAlphaBlendKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
         if (err != CL_SUCCESS)
         {
             throw std::runtime_error("clEnqueueNDRangeKernel failed for alphaBlend");
@@ -653,7 +739,7 @@ static void multiplyColor(cl_mem& output,
     size_t global[2] = {(size_t)width, (size_t)height};
     {
         ZoneScopedN("MultiplyColor Enqueue");
-        err = clEnqueueNDRangeKernel(queue, gMultiplyKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, gMultiplyKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
         if (err != CL_SUCCESS)
         {
             throw std::runtime_error("clEnqueueNDRangeKernel failed for multiplyColor");
@@ -671,6 +757,8 @@ static cl_program gPerlinRegionProgram = nullptr;
 ///
 /// The region is specified in colatitude (theta ∈ [0,π]) and azimuth
 /// (phi ∈ [0,2π]).  Use lonLatToThetaPhi() to convert.
+/// Runs on the CPU noise backend instead when activeNoiseBackend() says so;
+/// its result is uploaded into `output`, so a ready context is required.
 ///
 /// output: cl_mem float buffer of resLat × resLon.
 static void perlinRegion(cl_mem& output,
@@ -688,17 +776,6 @@ static void perlinRegion(cl_mem& output,
     cl_command_queue queue = OpenCLContext::get().getQueue();
     cl_int err = CL_SUCCESS;
 
-    static cl_kernel gPerlinRegionKernel = nullptr;
-    try {
-        OpenCLContext::get().createProgram(gPerlinRegionProgram, "Kernels/PerlinRegion.cl");
-        OpenCLContext::get().createKernelFromProgram(gPerlinRegionKernel,
-                                                     gPerlinRegionProgram,
-                                                     "perlin_fbm_3d_sphere_region");
-    } catch (const std::runtime_error &e) {
-        printf("Error initializing PerlinRegion OpenCL: %s\n", e.what());
-        return;
-    }
-
     {
         ZoneScopedN("PerlinRegion Buffer Alloc");
         size_t total = (size_t)resLat * (size_t)resLon * sizeof(float);
@@ -718,6 +795,31 @@ static void perlinRegion(cl_mem& output,
         }
     }
 
+    // CPU backend: evaluate on the host and upload
+    if (activeNoiseBackend() == NoiseBackendKind::CPU) {
+        PerlinRegionParams params{resLat, resLon, thetaMin, thetaMax, phiMin, phiMax,
+                                  frequency, lacunarity, octaves, persistence, seed};
+        std::vector<float> host((size_t)resLat * (size_t)resLon);
+        if (cpuNoiseBackend().perlinRegion(params, host.data())) {
+            err = clEnqueueWriteBuffer(queue, output, CL_TRUE, 0, host.size() * sizeof(float),
+                                       host.data(), 0, nullptr, nullptr);
+            if (err != CL_SUCCESS)
+                throw std::runtime_error("clEnqueueWriteBuffer failed for perlinRegion output");
+            return;
+        }
+    }
+
+    static cl_kernel gPerlinRegionKernel = nullptr;
+    try {
+        OpenCLContext::get().createProgram(gPerlinRegionProgram, "Kernels/PerlinRegion.cl");
+        OpenCLContext::get().createKernelFromProgram(gPerlinRegionKernel,
+                                                     gPerlinRegionProgram,
+                                                     "perlin_fbm_3d_sphere_region");
+    } catch (const std::runtime_error &e) {
+        printf("Error initializing PerlinRegion OpenCL: %s\n", e.what());
+        return;
+    }
+
     clSetKernelArg(gPerlinRegionKernel,  0, sizeof(cl_mem), &output);
     clSetKernelArg(gPerlinRegionKernel,  1, sizeof(int),    &resLat);
     clSetKernelArg(gPerlinRegionKernel,  2, sizeof(int),    &resLon);
@@ -734,46 +836,34 @@ static void perlinRegion(cl_mem& output,
     size_t global[2] = { (size_t)resLat, (size_t)resLon };
     {
         ZoneScopedN("PerlinRegion Enqueue");
-        err = clEnqueueNDRangeKernel(queue, gPerlinRegionKernel, 2,
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, gPerlinRegionKernel, 2,
                                       nullptr, global, nullptr, 0, nullptr, nullptr);
         if (err != CL_SUCCESS)
             throw std::runtime_error("clEnqueueNDRangeKernel failed for perlinRegion");
     }
 }
 
-/// Multi-channel region-bounded Perlin noise on a sphere sub-region.
-/// Output layout: output[c * resLat * resLon + latIdx * resLon + lonIdx].
-static void perlinRegionChannels(cl_mem& output,
-                                  int resLat, int resLon,
-                                  float thetaMin, float thetaMax,
-                                  float phiMin,   float phiMax,
-                                  int channels,
-                                  const std::vector<float>& frequency,
-                                  const std::vector<float>& lacunarity,
-                                  const std::vector<int>& octaves,
-                                  const std::vector<float>& persistence,
-                                  const std::vector<unsigned int>& seed)
+/// Fused multi-field region-bounded Perlin noise on a sphere sub-region:
+/// every field in one dispatch (perlin_fbm_3d_sphere_region_fields).
+/// Output layout: output[f * resLat * resLon + latIdx * resLon + lonIdx].
+/// Runs on the CPU noise backend instead when activeNoiseBackend() says so;
+/// its result is uploaded into `output`, so a ready context is required.
+static void perlinRegionFields(cl_mem& output,
+                               int resLat, int resLon,
+                               float thetaMin, float thetaMax,
+                               float phiMin,   float phiMax,
+                               const std::vector<NoiseField>& fields)
 {
-    ZoneScopedN("PerlinRegionChannels");
-    if (!OpenCLContext::get().isReady()) return;
+    ZoneScopedN("PerlinRegionFields");
+    if (!OpenCLContext::get().isReady() || fields.empty()) return;
 
     cl_command_queue queue = OpenCLContext::get().getQueue();
     cl_int err = CL_SUCCESS;
-
-    static cl_kernel gPerlinRegionChannelsKernel = nullptr;
-    try {
-        OpenCLContext::get().createProgram(gPerlinRegionProgram, "Kernels/PerlinRegion.cl");
-        OpenCLContext::get().createKernelFromProgram(gPerlinRegionChannelsKernel,
-                                                     gPerlinRegionProgram,
-                                                     "perlin_fbm_3d_sphere_region_channels");
-    } catch (const std::runtime_error &e) {
-        printf("Error initializing PerlinRegionChannels OpenCL: %s\n", e.what());
-        return;
-    }
+    int fieldCount = static_cast<int>(fields.size());
 
     {
-        ZoneScopedN("PerlinRegionChannels Buffer Alloc");
-        size_t total = (size_t)channels * resLat * resLon * sizeof(float);
+        ZoneScopedN("PerlinRegionFields Buffer Alloc");
+        size_t total = fields.size() * (size_t)resLat * (size_t)resLon * sizeof(float);
         size_t existing = 0;
         if (output != nullptr) {
             err = clGetMemObjectInfo(output, CL_MEM_SIZE, sizeof(existing), &existing, NULL);
@@ -784,52 +874,68 @@ static void perlinRegionChannels(cl_mem& output,
         }
         if (output == nullptr) {
             output = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, total,
-                                                       nullptr, &err, "perlinRegionChannels output");
+                                                       nullptr, &err, "perlinRegionFields output");
             if (err != CL_SUCCESS || output == nullptr)
-                throw std::runtime_error("clCreateBuffer failed for perlinRegionChannels output");
+                throw std::runtime_error("clCreateBuffer failed for perlinRegionFields output");
+        }
+    }
+
+    // CPU backend: one host pass per field, uploaded as a single block
+    if (activeNoiseBackend() == NoiseBackendKind::CPU) {
+        size_t plane = (size_t)resLat * (size_t)resLon;
+        std::vector<float> host(fields.size() * plane);
+        bool ok = true;
+        for (size_t f = 0; f < fields.size() && ok; ++f) {
+            const NoiseField& nf = fields[f];
+            PerlinRegionParams params{resLat, resLon, thetaMin, thetaMax, phiMin, phiMax,
+                                      nf.frequency, nf.lacunarity, nf.octaves, nf.persistence, nf.seed};
+            ok = cpuNoiseBackend().perlinRegion(params, host.data() + f * plane);
+        }
+        if (ok) {
+            err = clEnqueueWriteBuffer(queue, output, CL_TRUE, 0, host.size() * sizeof(float),
+                                       host.data(), 0, nullptr, nullptr);
+            if (err != CL_SUCCESS)
+                throw std::runtime_error("clEnqueueWriteBuffer failed for perlinRegionFields output");
+            return;
         }
     }
 
-    // Upload per-channel parameter arrays
-    cl_mem freqBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-        sizeof(float) * frequency.size(), (void*)frequency.data(), &err, "perlinRegionCh freqBuf");
-    cl_mem lacBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-        sizeof(float) * lacunarity.size(), (void*)lacunarity.data(), &err, "perlinRegionCh lacBuf");
-    cl_mem octBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-        sizeof(int) * octaves.size(), (void*)octaves.data(), &err, "perlinRegionCh octBuf");
-    cl_mem persBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-        sizeof(float) * persistence.size(), (void*)persistence.data(), &err, "perlinRegionCh persBuf");
-    cl_mem seedBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-        sizeof(unsigned int) * seed.size(), (void*)seed.data(), &err, "perlinRegionCh seedBuf");
-
-    clSetKernelArg(gPerlinRegionChannelsKernel,  0, sizeof(cl_mem), &output);
-    clSetKernelArg(gPerlinRegionChannelsKernel,  1, sizeof(int),    &resLat);
-    clSetKernelArg(gPerlinRegionChannelsKernel,  2, sizeof(int),    &resLon);
-    clSetKernelArg(gPerlinRegionChannelsKernel,  3, sizeof(float),  &thetaMin);
-    clSetKernelArg(gPerlinRegionChannelsKernel,  4, sizeof(float),  &thetaMax);
-    clSetKernelArg(gPerlinRegionChannelsKernel,  5, sizeof(float),  &phiMin);
-    clSetKernelArg(gPerlinRegionChannelsKernel,  6, sizeof(float),  &phiMax);
-    clSetKernelArg(gPerlinRegionChannelsKernel,  7, sizeof(int),    &channels);
-    clSetKernelArg(gPerlinRegionChannelsKernel,  8, sizeof(cl_mem), &freqBuf);
-    clSetKernelArg(gPerlinRegionChannelsKernel,  9, sizeof(cl_mem), &lacBuf);
-    clSetKernelArg(gPerlinRegionChannelsKernel, 10, sizeof(cl_mem), &octBuf);
-    clSetKernelArg(gPerlinRegionChannelsKernel, 11, sizeof(cl_mem), &persBuf);
-    clSetKernelArg(gPerlinRegionChannelsKernel, 12, sizeof(cl_mem), &seedBuf);
+    static cl_kernel gPerlinRegionFieldsKernel = nullptr;
+    try {
+        OpenCLContext::get().createProgram(gPerlinRegionProgram, "Kernels/PerlinRegion.cl");
+        OpenCLContext::get().createKernelFromProgram(gPerlinRegionFieldsKernel,
+                                                     gPerlinRegionProgram,
+                                                     "perlin_fbm_3d_sphere_region_fields");
+    } catch (const std::runtime_error &e) {
+        printf("Error initializing PerlinRegionFields OpenCL: %s\n", e.what());
+        return;
+    }
+
+    // All per-field parameters travel in one constant buffer
+    cl_mem fieldBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+        sizeof(NoiseField) * fields.size(), (void*)fields.data(), &err, "perlinRegionFields fieldBuf");
+    if (err != CL_SUCCESS || fieldBuf == nullptr)
+        throw std::runtime_error("clCreateBuffer failed for perlinRegionFields parameters");
+
+    clSetKernelArg(gPerlinRegionFieldsKernel, 0, sizeof(cl_mem), &output);
+    clSetKernelArg(gPerlinRegionFieldsKernel, 1, sizeof(int),    &resLat);
+    clSetKernelArg(gPerlinRegionFieldsKernel, 2, sizeof(int),    &resLon);
+    clSetKernelArg(gPerlinRegionFieldsKernel, 3, sizeof(float),  &thetaMin);
+    clSetKernelArg(gPerlinRegionFieldsKernel, 4, sizeof(float),  &thetaMax);
+    clSetKernelArg(gPerlinRegionFieldsKernel, 5, sizeof(float),  &phiMin);
+    clSetKernelArg(gPerlinRegionFieldsKernel, 6, sizeof(float),  &phiMax);
+    clSetKernelArg(gPerlinRegionFieldsKernel, 7, sizeof(int),    &fieldCount);
+    clSetKernelArg(gPerlinRegionFieldsKernel, 8, sizeof(cl_mem), &fieldBuf);
 
     size_t global[2] = { (size_t)resLat, (size_t)resLon };
     {
-        ZoneScopedN("PerlinRegionChannels Enqueue");
-        err = clEnqueueNDRangeKernel(queue, gPerlinRegionChannelsKernel, 2,
+        ZoneScopedN("PerlinRegionFields Enqueue");
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, gPerlinRegionFieldsKernel, 2,
                                       nullptr, global, nullptr, 0, nullptr, nullptr);
-        if (err != CL_SUCCESS)
-            throw std::runtime_error("clEnqueueNDRangeKernel failed for perlinRegionChannels");
     }
-
-    OpenCLContext::get().releaseMem(freqBuf);
-    OpenCLContext::get().releaseMem(lacBuf);
-    OpenCLContext::get().releaseMem(octBuf);
-    OpenCLContext::get().releaseMem(persBuf);
-    OpenCLContext::get().releaseMem(seedBuf);
+    OpenCLContext::get().releaseMem(fieldBuf);
+    if (err != CL_SUCCESS)
+        throw std::runtime_error("clEnqueueNDRangeKernel failed for perlinRegionFields");
 }
 
 /// Apply a delta buffer to a base buffer on the GPU.
@@ -854,7 +960,7 @@ static void applyDeltaScalar(cl_mem base, cl_mem delta,
     clSetKernelArg(kern, 4, sizeof(int),    &mode);
 
     size_t global[2] = { (size_t)resLat, (size_t)resLon };
-    clEnqueueNDRangeKernel(OpenCLContext::get().getQueue(), kern, 2,
+    OpenCLContext::get().enqueueNDRangeKernel(OpenCLContext::get().getQueue(), kern, 2,
                             nullptr, global, nullptr, 0, nullptr, nullptr);
 }
 
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Shared pieces of the on-disk caches (OpenCL and GL program binaries): the
+/// key hash, the cache location, and entry files that are validated on read
+/// and replaced atomically on write.
+namespace CacheFile {
+
+constexpr uint64_t kFnvOffset = 1469598103934665603ull;
+
+/// 64-bit FNV-1a. Pass a previous result as `h` to hash several fields.
+uint64_t fnv1a64(const void* data, size_t len, uint64_t h = kFnvOffset);
+inline uint64_t fnv1a64(std::string_view data, uint64_t h = kFnvOffset) {
+    return fnv1a64(data.data(), data.size(), h);
+}
+
+/// 16 lowercase hex digits, the form cache keys are stored in
+std::string toHex(uint64_t h);
+
+/// $XDG_CACHE_HOME/LoreBook/<subdir>, else ~/.cache/LoreBook/<subdir>,
+/// else the temp (or working) directory
+std::filesystem::path defaultDir(const std::string& subdir);
+
+/// Entry layout: 8-byte magic, the 16-char key (guards against renamed or
+/// foreign files), payload.
+///
+/// Returns the payload, or nothing if the file is missing. A malformed
+/// entry (wrong magic or key, empty payload) is deleted and logged under
+/// `label`.
+std::optional<std::vector<char>> read(const std::filesystem::path& file, const char (&magic)[8],
+                                      const std::string& key, const char* label);
+
+/// Write an entry as the concatenation of `payload`, creating the directory
+/// if needed. The entry goes to a per-thread temp file that is renamed into
+/// place, so concurrent readers and writers never see a partial entry.
+bool write(const std::filesystem::path& file, const char (&magic)[8], const std::string& key,
+           std::initializer_list<std::string_view> payload, const char* label);
+
+/// Delete an entry whose payload the consumer rejected
+void discard(const std::filesystem::path& file);
+
+} // namespace CacheFile
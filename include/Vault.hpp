@@ -426,6 +426,162 @@ public:
         return result;
     }
 
+    // Write a batch of layer deltas in one transaction through a single
+    // prepared statement per operation.  Records in `removals` (matched on
+    // chunk coordinate + layer name) are deleted.  All-or-nothing: returns
+    // false and rolls back if any row fails.
+    bool saveLayerDeltasBatch(const std::vector<LayerDeltaRecord>& upserts,
+                              const std::vector<LayerDeltaRecord>& removals = {})
+    {
+        if (!dbConnection) return false;
+        if (upserts.empty() && removals.empty()) return true;
+
+        const char* upsertSQL =
+            "INSERT OR REPLACE INTO LayerDeltas "
+            "(ChunkX, ChunkY, ChunkDepth, LayerName, ChannelCount, Resolution, "
+            " DeltaMode, DeltaData, ParamOverrides, UpdatedAt) "
+            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, strftime('%s','now'));";
+        const char* deleteSQL =
+            "DELETE FROM LayerDeltas WHERE ChunkX=? AND ChunkY=? AND ChunkDepth=? AND LayerName=?;";
+
+        if (sqlite3_exec(dbConnection, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK)
+            return false;
+
+        bool ok = true;
+        sqlite3_stmt* stmt = nullptr;
+        if (!upserts.empty()) {
+            ok = sqlite3_prepare_v2(dbConnection, upsertSQL, -1, &stmt, nullptr) == SQLITE_OK;
+            for (size_t i = 0; ok && i < upserts.size(); ++i) {
+                const LayerDeltaRecord& r = upserts[i];
+                sqlite3_reset(stmt);
+                sqlite3_clear_bindings(stmt);
+                sqlite3_bind_int(stmt, 1, r.chunkX);
+                sqlite3_bind_int(stmt, 2, r.chunkY);
+                sqlite3_bind_int(stmt, 3, r.chunkDepth);
+                sqlite3_bind_text(stmt, 4, r.layerName.c_str(), -1, SQLITE_STATIC);
+                sqlite3_bind_int(stmt, 5, r.channelCount);
+                sqlite3_bind_int(stmt, 6, r.resolution);
+                sqlite3_bind_int(stmt, 7, r.deltaMode);
+                if (!r.deltaData.empty())
+                    sqlite3_bind_blob(stmt, 8, r.deltaData.data(),
+                                      static_cast<int>(r.deltaData.size()), SQLITE_STATIC);
+                else
+                    sqlite3_bind_null(stmt, 8);
+                sqlite3_bind_text(stmt, 9, r.paramOverrides.c_str(), -1, SQLITE_STATIC);
+                ok = (sqlite3_step(stmt) == SQLITE_DONE);
+            }
+            sqlite3_finalize(stmt);
+            stmt = nullptr;
+        }
+        if (ok && !removals.empty()) {
+            ok = sqlite3_prepare_v2(dbConnection, deleteSQL, -1, &stmt, nullptr) == SQLITE_OK;
+            for (size_t i = 0; ok && i < removals.size(); ++i) {
+                const LayerDeltaRecord& r = removals[i];
+                sqlite3_reset(stmt);
+                sqlite3_clear_bindings(stmt);
+                sqlite3_bind_int(stmt, 1, r.chunkX);
+                sqlite3_bind_int(stmt, 2, r.chunkY);
+                sqlite3_bind_int(stmt, 3, r.chunkDepth);
+                sqlite3_bind_text(stmt, 4, r.layerName.c_str(), -1, SQLITE_STATIC);
+                ok = (sqlite3_step(stmt) == SQLITE_DONE);
+            }
+            sqlite3_finalize(stmt);
+        }
+
+        if (ok)
+            ok = sqlite3_exec(dbConnection, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK;
+        if (!ok) {
+            PLOGW << "saveLayerDeltasBatch failed: " << sqlite3_errmsg(dbConnection);
+            sqlite3_exec(dbConnection, "ROLLBACK;", nullptr, nullptr, nullptr);
+        }
+        return ok;
+    }
+
+    // ── WorldMap simulation checkpoints ─────────────────────────
+    // Long-running layer simulations (e.g. tectonics) persist their state
+    // keyed by a hash of the parameters that produced it.  Saves arrive from
+    // worker threads, so these take dbMutex like the background fetches.
+    bool saveSimulationCheckpoint(const std::string& layerName,
+                                  const std::string& paramHash,
+                                  int step, int totalSteps,
+                                  uint64_t rawSize,
+                                  const std::vector<uint8_t>& stateData)
+    {
+        if (!dbConnection) return false;
+        std::lock_guard<std::mutex> l(dbMutex);
+        const char* sql =
+            "INSERT OR REPLACE INTO SimulationCheckpoints "
+            "(LayerName, ParamHash, Step, TotalSteps, RawSize, StateData, UpdatedAt) "
+            "VALUES (?, ?, ?, ?, ?, ?, strftime('%s','now'));";
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(dbConnection, sql, -1, &stmt, nullptr) != SQLITE_OK)
+            return false;
+        sqlite3_bind_text(stmt, 1, layerName.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, paramHash.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 3, step);
+        sqlite3_bind_int(stmt, 4, totalSteps);
+        sqlite3_bind_int64(stmt, 5, static_cast<sqlite3_int64>(rawSize));
+        if (!stateData.empty())
+            sqlite3_bind_blob(stmt, 6, stateData.data(),
+                              static_cast<int>(stateData.size()), SQLITE_TRANSIENT);
+        else
+            sqlite3_bind_null(stmt, 6);
+        bool ok = (sqlite3_step(stmt) == SQLITE_DONE);
+        sqlite3_finalize(stmt);
+        return ok;
+    }
+
+    // Load the checkpoint for layerName+paramHash. Returns true if found.
+    bool loadSimulationCheckpoint(const std::string& layerName,
+                                  const std::string& paramHash,
+                                  int& step, int& totalSteps,
+                                  uint64_t& rawSize,
+                                  std::vector<uint8_t>& stateData)
+    {
+        if (!dbConnection) return false;
+        std::lock_guard<std::mutex> l(dbMutex);
+        const char* sql =
+            "SELECT Step, TotalSteps, RawSize, StateData FROM SimulationCheckpoints "
+            "WHERE LayerName=? AND ParamHash=?;";
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(dbConnection, sql, -1, &stmt, nullptr) != SQLITE_OK)
+            return false;
+        sqlite3_bind_text(stmt, 1, layerName.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, paramHash.c_str(), -1, SQLITE_TRANSIENT);
+        bool found = false;
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            step = sqlite3_column_int(stmt, 0);
+            totalSteps = sqlite3_column_int(stmt, 1);
+            rawSize = static_cast<uint64_t>(sqlite3_column_int64(stmt, 2));
+            const void* blob = sqlite3_column_blob(stmt, 3);
+            int blobSize = sqlite3_column_bytes(stmt, 3);
+            if (blob && blobSize > 0) {
+                stateData.resize(blobSize);
+                std::memcpy(stateData.data(), blob, blobSize);
+            } else {
+                stateData.clear();
+            }
+            found = true;
+        }
+        sqlite3_finalize(stmt);
+        return found;
+    }
+
+    bool deleteSimulationCheckpoint(const std::string& layerName, const std::string& paramHash)
+    {
+        if (!dbConnection) return false;
+        std::lock_guard<std::mutex> l(dbMutex);
+        const char* sql = "DELETE FROM SimulationCheckpoints WHERE LayerName=? AND ParamHash=?;";
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(dbConnection, sql, -1, &stmt, nullptr) != SQLITE_OK)
+            return false;
+        sqlite3_bind_text(stmt, 1, layerName.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, paramHash.c_str(), -1, SQLITE_TRANSIENT);
+        bool ok = (sqlite3_step(stmt) == SQLITE_DONE);
+        sqlite3_finalize(stmt);
+        return ok;
+    }
+
     // ── Orbital System CRUD ──────────────────────────────────────
     int64_t createOrbitalSystem(const std::string& name, const std::string& systemType = "Stellar",
                                  int64_t parentSystemID = -1,
@@ -1545,6 +1701,28 @@ public:
                 }
             }
 
+            // ============================================================
+            // WorldMap SimulationCheckpoints table: resumable layer sims
+            // ============================================================
+            {
+                const char *createCheckpointsSQL = "CREATE TABLE IF NOT EXISTS SimulationCheckpoints ("
+                                                    "LayerName TEXT NOT NULL, "
+                                                    "ParamHash TEXT NOT NULL, "
+                                                    "Step INTEGER DEFAULT 0, "
+                                                    "TotalSteps INTEGER DEFAULT 0, "
+                                                    "RawSize INTEGER DEFAULT 0, "
+                                                    "StateData BLOB, "
+                                                    "UpdatedAt INTEGER DEFAULT (strftime('%s','now')), "
+                                                    "PRIMARY KEY(LayerName, ParamHash)"
+                                                    ");";
+                char *cErr = nullptr;
+                if (sqlite3_exec(dbConnection, createCheckpointsSQL, nullptr, nullptr, &cErr) != SQLITE_OK)
+                {
+                    if (cErr)
+                        sqlite3_free(cErr);
+                }
+            }
+
             // ── OrbitalSystems table ─────────────────────────────
             {
                 const char *sql = "CREATE TABLE IF NOT EXISTS OrbitalSystems ("
@@ -1,6 +1,8 @@
 #pragma once
 #include <WorldMaps/Map/MapLayer.hpp>
 #include <WorldMaps/Buildings/FloorPlan.hpp>
+#include <WorldMaps/World/Chunk.hpp>
+#include <unordered_map>
 #include <vector>
 #include <random>
 
@@ -10,7 +12,7 @@ class Vault;
 struct PlacedBuilding {
     float mapX = 0.0f;      // adjusted origin in map cells (latitude axis)
     float mapY = 0.0f;      // adjusted origin in map cells (longitude axis)
-    float scatterX = 0.0f;  // original scatter centre (for min-distance)
+    float scatterX = 0.0f;  // scatter centre (for min-distance)
     float scatterY = 0.0f;
     FloorPlan plan;
     // Bounding box in map coordinates (recomputed after placement)
@@ -18,9 +20,17 @@ struct PlacedBuilding {
 };
 
 /// Map layer that loads FloorPlan templates from the vault,
-/// scatters them randomly across the map, and renders full-detail
-/// footprints (rooms, walls, doors, windows, furniture, staircases)
-/// via an OpenCL kernel.
+/// scatters them across the map, and renders full-detail footprints
+/// (rooms, walls, doors, windows, furniture, staircases) via an OpenCL
+/// kernel.
+///
+/// Placement is a Poisson-disk process evaluated per placement tile (a
+/// ChunkCoord at a depth chosen from the minimum distance): each tile draws
+/// candidates from a seed derived from its coordinate, and a candidate is
+/// kept when no candidate of higher priority lies within the minimum
+/// distance, found through a spatial hash over the 3×3 neighbouring tiles.
+/// The result does not depend on which tiles were generated first, so tiles
+/// are generated lazily when a chunk first needs them.
 class BuildingLayer : public MapLayer
 {
 public:
@@ -30,32 +40,121 @@ public:
     cl_mem sample() override;
     cl_mem getColor() override;
 
+    // ── Region support ─────────────────────────────────
+    // Chunks are rasterized directly from the flattened building geometry;
+    // only the buildings binned to placement tiles under the chunk are
+    // culled and submitted.
+    bool supportsRegion() const override { return true; }
+
+    cl_mem sampleRegion(float lonMinRad, float lonMaxRad,
+                        float latMinRad, float latMaxRad,
+                        int resX, int resY,
+                        const LayerDelta* delta = nullptr) override;
+
+    cl_mem getColorRegion(float lonMinRad, float lonMaxRad,
+                          float latMinRad, float latMaxRad,
+                          int resX, int resY,
+                          const LayerDelta* delta = nullptr) override;
+
     /// Parse configuration parameters.
-    /// Format: "minDistance:100,maxBuildings:200,seed:42,cellsPerMeter:3.0"
+    /// Format: "minDistance:100,density:1.0,seed:42,cellsPerMeter:3.0"
     void parseParameters(const std::string& params) override;
 
     /// Set floorplan templates directly (alternative to vault loading).
     void setTemplates(const std::vector<FloorPlan>& templates);
 
 private:
-    void loadTemplatesAndScatter();
+    /// Device array grown by appending; earlier contents are kept.
+    struct DeviceArray {
+        cl_mem mem = nullptr;
+        size_t count = 0;
+        size_t capacity = 0;
+        bool append(const void* data, size_t n, size_t elemSize, const char* tag);
+        void release();
+    };
+
+    /// Flattened render geometry of every building generated so far,
+    /// appended tile by tile and shared by the full-map and per-chunk kernels.
+    struct Geometry {
+        // Host copies of the culling data
+        std::vector<cl_float4> roomBounds;        // (minX, minY, maxX, maxY) per room
+        std::vector<cl_float4> buildingBounds;    // (minX, minY, maxX, maxY) per building
+        std::vector<cl_int>    buildingRoomStart; // first room index per building
+        std::vector<cl_int>    buildingRoomEnd;   // one-past-last room index
+
+        int roomCount = 0;
+        int segCount = 0;
+        int vertCount = 0;
+        int buildingCount = 0;
+        bool valid = true;
+
+        DeviceArray roomVerts, roomStart, roomVertCount, roomColors, roomBoundsDev;
+        DeviceArray coords, colors, thick;
+        DeviceArray bBounds, bSegStart, bSegEnd;
+    };
+
+    /// Per-template placement data, relative to the scatter centre.
+    struct TemplateMeta {
+        float centerX = 0, centerY = 0;          // centroid (plan meters)
+        float localMinX = 0, localMinY = 0;      // footprint bounds (map cells)
+        float localMaxX = 0, localMaxY = 0;
+    };
+
+    /// Buildings accepted in one placement tile, as a range of geometry_.
+    struct PlacementTile {
+        int firstBuilding = 0;
+        int buildingCount = 0;
+    };
+
+    struct Candidate {
+        float x = 0.0f, y = 0.0f;   // scatter centre (map cells)
+        uint32_t priority = 0;
+        uint32_t templateIndex = 0;
+        int tileX = 0, tileY = 0, index = 0;
+    };
+
+    /// Reload templates and reset placement if parameters or templates
+    /// changed.  Returns true when the layout was reset.
+    bool ensureLayout();
+    void loadTemplates();
+    void preparePlacement();
+    void releaseGeometry();
     void rasterizeToGPU();
+    cl_mem rasterizeRegion(float lonMinRad, float lonMaxRad,
+                           float latMinRad, float latMaxRad,
+                           int resX, int resY);
     void computeBuildingBounds(PlacedBuilding& b);
+    static bool ensureKernels(cl_kernel* full, cl_kernel* region);
 
-    // Placed buildings with their floorplans and map positions
-    std::vector<PlacedBuilding> placedBuildings;
+    // ── Placement ──
+    const PlacementTile& placementTile(int tileX, int tileY);
+    std::vector<Candidate> tileCandidates(int tileX, int tileY) const;
+    void tileBoundsCells(int tileX, int tileY, float& minX, float& minY,
+                         float& maxX, float& maxY) const;
+    void appendGeometry(const std::vector<PlacedBuilding>& buildings);
 
     // Available templates loaded from vault
     std::vector<FloorPlan> templates_;
+    std::vector<TemplateMeta> templateMeta_;
     bool templatesLoaded_ = false;
 
+    // Placement state (reset by ensureLayout)
+    int tileDepth_ = 0;                  // ChunkCoord depth of placement tiles
+    int candidatesPerTile_ = 0;
+    float effectiveMinDist_ = 0.0f;      // min distance between scatter centres
+    float maxBuildingRadius_ = 0.0f;     // farthest footprint extent from a centre
+    int latRes_ = 4096, lonRes_ = 4096;  // map cells
+    std::unordered_map<ChunkCoord, PlacementTile, ChunkCoordHash> tiles_;
+
+    Geometry geometry_;
+
     // Output buffer
     cl_mem colorBuffer_ = nullptr;
     bool dirty_ = true;
 
     // Scatter parameters
     float minDistance_    = 250.0f;  // min distance (cells) between buildings
-    int   maxBuildings_  = 200;     // max buildings to place
+    float density_        = 1.0f;    // candidates per minDistance² of map area
     unsigned int seed_   = 42;      // RNG seed
     float cellsPerMeter_ = 10.0f;  // scale: map cells per floorplan meter
 };
@@ -0,0 +1,119 @@
+#pragma once
+#include <WorldMaps/Map/MapLayer.hpp>
+#include <WorldMaps/World/Chunk.hpp>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct LayerDelta;
+
+/// A settlement seeded on the sphere.
+struct Settlement {
+    float lon = 0.0f;          // radians, [-π, π]
+    float lat = 0.0f;          // radians, [-π/2, π/2]
+    float population = 0.0f;   // relative size in (0, 1]
+    uint32_t id = 0;           // stable 24-bit id (exact as a float sample)
+    bool capital = false;      // largest settlement of its nation cell
+};
+
+/// Deterministic settlement placement shared by the city and political
+/// layers.
+///
+/// The sphere is divided into settlement regions (ChunkCoords at a fixed
+/// depth).  Each region evaluates elevation and land-type noise on a coarse
+/// candidate grid in one dispatch, scores every candidate's suitability
+/// (lowland above sea level, fertile soil, temperate latitude) and keeps it
+/// with a probability drawn from a hash of its grid cell, so a region's
+/// settlements never depend on which other regions were generated first.
+/// The most populous settlement of each region quadrant becomes a capital.
+class SettlementGenerator
+{
+public:
+    void setWorld(World* world) { world_ = world; }
+
+    void setSeed(uint32_t seed) { seed_ = seed; clear(); }
+    void setDensity(float density) { density_ = density; clear(); }
+    void setSeaLevel(float level) { seaLevel_ = level; clear(); }
+    uint32_t seed() const { return seed_; }
+    float density() const { return density_; }
+    float seaLevel() const { return seaLevel_; }
+
+    /// Depth of the settlement regions; capitals are chosen one depth below.
+    int regionDepth() const { return regionDepth_; }
+
+    /// Settlements of one region, generated on first use.
+    const std::vector<Settlement>& region(const ChunkCoord& rc);
+
+    /// Settlements within `marginRad` of the given bounds (longitude wraps).
+    void gather(float lonMinRad, float lonMaxRad, float latMinRad, float latMaxRad,
+                float marginRad, bool capitalsOnly, std::vector<Settlement>& out);
+
+    void clear();
+
+private:
+    World* world_ = nullptr;
+    uint32_t seed_ = 1337u;
+    float density_ = 0.12f;    // acceptance probability of a fully suitable cell
+    float seaLevel_ = 0.5f;    // matches WaterTableLayer::water_table_level
+    int regionDepth_ = 3;
+    int gridRes_ = 32;         // candidate cells per region axis
+
+    std::mutex mutex_;
+    std::unordered_map<ChunkCoord, std::vector<Settlement>, ChunkCoordHash> regions_;
+
+    std::vector<Settlement> generate(const ChunkCoord& rc);
+};
+
+/// Map layer drawing settlements as discs sized by population, capitals
+/// highlighted.  Chunks only look at the settlements of the regions they
+/// overlap, so cities are drawn at any zoom depth without a global pass.
+///
+/// Scalar samples hold the population of the covering settlement (0 where
+/// there is none); colour is transparent outside settlements so the layer
+/// can be blended over terrain.
+class CityLayer : public MapLayer
+{
+public:
+    CityLayer() = default;
+    ~CityLayer() override;
+
+    cl_mem sample() override;
+    cl_mem getColor() override;
+
+    // ── Region support ─────────────────────────────────
+    bool supportsRegion() const override { return true; }
+
+    cl_mem sampleRegion(float lonMinRad, float lonMaxRad,
+                        float latMinRad, float latMaxRad,
+                        int resX, int resY,
+                        const LayerDelta* delta = nullptr) override;
+
+    cl_mem getColorRegion(float lonMinRad, float lonMaxRad,
+                          float latMinRad, float latMaxRad,
+                          int resX, int resY,
+                          const LayerDelta* delta = nullptr) override;
+
+    /// Format: "seed:1337,density:0.12,radius:0.004,sealevel:0.5"
+    void parseParameters(const std::string& params) override;
+
+    /// Settlements of this layer; PoliticalLayer seeds its nations from them.
+    SettlementGenerator& settlements();
+
+private:
+    SettlementGenerator generator_;
+    float cityRadius_ = 0.004f;     // angular radius of a mid-sized settlement
+    float minRadiusTexels_ = 1.5f;  // keeps settlements visible when zoomed out
+
+    cl_mem sampleBuffer_ = nullptr;
+    cl_mem colorBuffer_ = nullptr;
+
+    /// Rasterises settlements over the bounds into a population buffer
+    /// and/or an RGBA buffer (either may be null).
+    bool render(float lonMinRad, float lonMaxRad, float latMinRad, float latMaxRad,
+                int resX, int resY, cl_mem* sampleOut, cl_mem* colorOut);
+
+    /// Full-world buffer rendered tile by tile, each tile only submitting
+    /// its nearby settlements.
+    cl_mem renderWorld(bool color);
+};
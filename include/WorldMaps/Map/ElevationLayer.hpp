@@ -20,6 +20,10 @@ public:
                           int resX, int resY,
                           const LayerDelta* delta = nullptr) override;
 
+    std::vector<NoiseField> regionNoiseFields() const override {
+        return {{frequency_, lacunarity_, persistence_, octaves_, seed_}};
+    }
+
     // Procedural parameters (can be overridden per-chunk via delta)
     float frequency_   = 1.5f;
     float lacunarity_  = 2.0f;
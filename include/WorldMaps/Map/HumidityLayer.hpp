@@ -26,6 +26,11 @@ public:
                           int resX, int resY,
                           const LayerDelta* delta = nullptr) override;
 
+    /// Weather noise; the land type channels come from LandTypeLayer.
+    std::vector<NoiseField> regionNoiseFields() const override {
+        return {{0.008f, 2.0f, 0.5f, 6, 98765u}};
+    }
+
 private:
     cl_mem getHumidityBuffer();
 
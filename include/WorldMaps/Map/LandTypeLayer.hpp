@@ -46,6 +46,9 @@ public:
                           int resX, int resY,
                           const LayerDelta* delta = nullptr) override;
 
+    /// One field per land type; HumidityLayer reads the same channels.
+    std::vector<NoiseField> regionNoiseFields() const override;
+
 private:
     cl_mem outColor = nullptr;
     bool outColorDirty = true;
@@ -64,6 +64,21 @@ public:
     /// Number of data channels (1 for scalar layers, N for multichannel).
     virtual int getChannelCount() const { return 1; }
 
+    /// Perlin fields this layer's region generation reads through
+    /// World::regionNoise.  The world evaluates every layer's fields for a
+    /// chunk in one fused dispatch, so declare them all, in a stable order.
+    virtual std::vector<NoiseField> regionNoiseFields() const { return {}; }
+
+    // ── Incremental generation ─────────────────────────────────────
+    /// Advance long-running generation (e.g. a simulation) by one frame's
+    /// worth of work.  Returns true when the layer's output changed and
+    /// cached chunks must be regenerated.
+    virtual bool tick() { return false; }
+
+    /// Generation progress in [0, 1].  Layers without background work are
+    /// always complete.
+    virtual float getProgress() const { return 1.0f; }
+
     static cl_float4 rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
     {
         return {r / 255.0f, g / 255.0f, b / 255.0f, a / 255.0f};
@@ -0,0 +1,91 @@
+#pragma once
+#include <WorldMaps/Map/MapLayer.hpp>
+#include <WorldMaps/Map/CityLayer.hpp>
+#include <WorldMaps/World/Chunk.hpp>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct LayerDelta;
+
+/// Map layer dividing land between nations grown from capital settlements.
+///
+/// Each capital claims the land closest to it in weighted angular distance
+/// (distance / weight, weight from population), up to a maximum range.  The
+/// partition is a multiplicatively weighted Voronoi diagram, evaluated per
+/// chunk with jump flooding on the GPU over the chunk plus a halo margin:
+/// capitals within range of the chunk are planted on the padded grid
+/// (clamped onto its border when farther out) and every flood step scores
+/// candidates by their true positions, so borders line up across chunks
+/// without a global pass.
+///
+/// Flood results are cached per ChunkCoord.  Scalar samples hold the
+/// owning capital's id + 1 (0 for ocean and unclaimed land).
+class PoliticalLayer : public MapLayer
+{
+public:
+    PoliticalLayer() = default;
+    ~PoliticalLayer() override;
+
+    cl_mem sample() override;
+    cl_mem getColor() override;
+
+    // ── Region support ─────────────────────────────────
+    bool supportsRegion() const override { return true; }
+
+    cl_mem sampleRegion(float lonMinRad, float lonMaxRad,
+                        float latMinRad, float latMaxRad,
+                        int resX, int resY,
+                        const LayerDelta* delta = nullptr) override;
+
+    cl_mem getColorRegion(float lonMinRad, float lonMaxRad,
+                          float latMinRad, float latMaxRad,
+                          int resX, int resY,
+                          const LayerDelta* delta = nullptr) override;
+
+    /// Format: "range:0.25,seed:1337,sealevel:0.5,cache:64"
+    /// seed and sealevel only apply when the world has no cities layer.
+    void parseParameters(const std::string& params) override;
+
+private:
+    /// Jump-flood result for one region: owning seed per padded texel.
+    struct Flood {
+        int resX = 0, resY = 0;
+        int margin = 0;
+        cl_mem owner = nullptr;     // int per padded texel, -1 = none
+        cl_mem seeds = nullptr;     // float4 (x, y, z, weight) per seed
+        cl_mem nations = nullptr;   // float nation id per seed
+        uint64_t lastUse = 0;
+        void release();
+    };
+
+    SettlementGenerator ownSettlements_;
+    float range_ = 0.25f;           // claim range of a weight-1 capital (radians)
+    int marginTexels_ = 8;          // halo around each chunk
+    size_t maxCachedChunks_ = 64;
+
+    std::mutex cacheMutex_;
+    std::unordered_map<ChunkCoord, Flood, ChunkCoordHash> cache_;
+    uint64_t useCounter_ = 0;
+
+    cl_mem sampleBuffer_ = nullptr;
+    cl_mem colorBuffer_ = nullptr;
+
+    /// The cities layer's settlements when present, so both layers agree.
+    SettlementGenerator& settlements();
+
+    /// Flood over the bounds; `out` is owned by the caller unless cached.
+    bool flood(float lonMinRad, float lonMaxRad, float latMinRad, float latMaxRad,
+               int resX, int resY, Flood& out);
+
+    /// Cached flood for chunk-aligned bounds, else a fresh one in `scratch`.
+    Flood* acquireFlood(float lonMinRad, float lonMaxRad, float latMinRad, float latMaxRad,
+                        int resX, int resY, Flood& scratch);
+
+    /// Resolves a flood into nation ids (sampleOut) and/or RGBA (colorOut).
+    bool resolve(const Flood& f, float lonMinRad, float lonMaxRad, float latMinRad, float latMaxRad,
+                 cl_mem* sampleOut, cl_mem* colorOut);
+
+    void clearCache();
+};
@@ -1,5 +1,7 @@
 #pragma once
 #include <WorldMaps/Map/MapLayer.hpp>
+#include <WorldMaps/World/Hydrology.hpp>
+#include <memory>
 
 class RiverLayer : public MapLayer
 {
@@ -10,16 +12,47 @@ public:
 
     cl_mem getColor() override;
 
+    /// Format: "resolution:1024,area:48,width:0.0015"
+    /// resolution is the drainage grid's latitude cell count (longitude is
+    /// twice that); area is the drainage area, in equator cells, where
+    /// rivers start; width is the angular half-width of the largest river.
+    void parseParameters(const std::string &params) override;
+
+    // ── Region support ─────────────────────────────────
+    // Rivers come from one world-wide drainage network (see Hydrology),
+    // built once per elevation seed; chunks only look up the cells under
+    // them, so rivers stay continuous across seams at any depth.
+    bool supportsRegion() const override { return true; }
+
+    cl_mem sampleRegion(float lonMinRad, float lonMaxRad,
+                        float latMinRad, float latMaxRad,
+                        int resX, int resY,
+                        const LayerDelta* delta = nullptr) override;
+
+    cl_mem getColorRegion(float lonMinRad, float lonMaxRad,
+                          float latMinRad, float latMaxRad,
+                          int resX, int resY,
+                          const LayerDelta* delta = nullptr) override;
+
 private:
     cl_mem getRiverBuffer();
 
-    // Flow directions
+    // River intensity
     cl_mem riverBuffer = nullptr;
     cl_mem coloredBuffer = nullptr;
 
-    static void generateRiverPaths(cl_mem elevationBuf,
-                               cl_mem waterTableBuf,
-                               cl_mem& riverVolumeBuf,
-                               int latitudeResolution, int longitudeResolution,
-                               uint32_t maxSteps);
-};
\ No newline at end of file
+    int gridRows_ = 1024;
+    float riverArea_ = 48.0f;
+    float riverWidth_ = 0.0015f;
+
+    std::shared_ptr<const Hydrology> hydrology_;
+
+    /// The network for the world's current elevation field and sea level.
+    const Hydrology* ensureHydrology();
+
+    /// Rasterise river intensity over a region into a new buffer.
+    cl_mem rasterizeRegion(const Hydrology& hydro,
+                           float lonMinRad, float lonMaxRad,
+                           float latMinRad, float latMaxRad,
+                           int resX, int resY);
+};
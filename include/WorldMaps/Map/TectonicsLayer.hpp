@@ -1,5 +1,6 @@
 #pragma once
 #include <WorldMaps/Map/MapLayer.hpp>
+#include <future>
 
 // POD struct matching OpenCL kernel layout
 // Must match typedef struct TecVoxel in Tectonics.cl exactly
@@ -20,13 +21,52 @@ public:
     cl_mem getColor() override;
     void parseParameters(const std::string &params) override;
 
+    // ── Region support (per-chunk resample of the cubemap surface) ──
+    bool supportsRegion() const override { return true; }
+
+    cl_mem sampleRegion(float lonMinRad, float lonMaxRad,
+                        float latMinRad, float latMaxRad,
+                        int resX, int resY,
+                        const LayerDelta* delta = nullptr) override;
+
+    cl_mem getColorRegion(float lonMinRad, float lonMaxRad,
+                          float latMinRad, float latMaxRad,
+                          int resX, int resY,
+                          const LayerDelta* delta = nullptr) override;
+
+    // ── Incremental simulation ──
+    // The simulation runs stepsPerFrame steps per tick() instead of blocking
+    // the first sample(); sample()/sampleRegion() return the latest preview.
+    enum class SimulationState { Idle, Running, Complete, Cancelled, Failed };
+
+    bool tick() override;
+    float getProgress() const override;
+
+    SimulationState getState() const { return state; }
+    int getCompletedSteps() const { return completedSteps; }
+    int getTotalSteps() const { return simulationSteps; }
+
+    void cancel();                 // stop stepping, keep preview, checkpoint progress
+    void resume();                 // continue a cancelled simulation
+    void restart();                // discard progress (and the stored checkpoint)
+    bool runToCompletion();        // blocking: finish the remaining steps now
+
 private:
     // Resolution settings
     size_t uvResolution = 512;       // resolution per cubemap face
     
     // Simulation control
     int simulationSteps = 500;       // steps to run
-    bool simulationComplete = false;
+    int stepsPerFrame = 8;           // steps enqueued per tick()
+    int previewInterval = 50;        // steps between preview extractions
+    int checkpointInterval = 100;    // steps between vault checkpoints
+    SimulationState state = SimulationState::Idle;
+    int completedSteps = 0;
+    int lastPreviewStep = -1;
+    int lastCheckpointStep = 0;
+    std::string activeParamHash;     // hash the running simulation was started with
+    std::string configuredParamHash; // parameterHash() of the parsed parameters; empty = stale
+    bool outputChanged = false;      // preview replaced outside tick(); reported on next tick
     
     // Physics parameters
     float dt = 0.5f;                 // timestep
@@ -46,9 +86,32 @@ private:
     
     // Private methods
     bool initializeSimulation();
+    bool startSimulation();
+    bool ensureSurface();
+    bool stepSimulation(int steps);
     void runSimulation(int steps);
-    void extractHeightmap();
+    void extractSurface();
+    void invalidateOutputs();
     void releaseBuffers();
+
+    // Checkpoints (vault, keyed by parameter hash)
+    std::string parameterHash() const;
+    const std::string& currentParamHash();
+    bool loadCheckpoint();
+    void saveCheckpoint();           // starts an async checkpoint
+    void pollCheckpoint(bool wait);  // advances it; wait = block until stored
+
+    // A checkpoint in flight: non-blocking voxel readback, then compression
+    // and the vault write on a worker.
+    struct PendingCheckpoint {
+        std::vector<uint8_t> raw;
+        cl_event readDone = nullptr;
+        std::string paramHash;
+        int step = 0;
+        int totalSteps = 0;
+        std::future<bool> write;
+    };
+    std::unique_ptr<PendingCheckpoint> pendingCheckpoint;
     
     // Cubemap to lat/lon projection
     void cubemapToLatLon(cl_mem cubemapSurface, cl_mem& latlonOutput,
@@ -12,6 +12,9 @@ public:
 
     cl_mem getColor() override;
 
+    /// Format: "seed:1234".  Without a seed the layer is seeded from the clock.
+    void parseParameters(const std::string &params) override;
+
     // ── Region support (dynamic resolution) ────────────
     bool supportsRegion() const override { return true; }
 
@@ -25,6 +28,11 @@ public:
                           int resX, int resY,
                           const LayerDelta* delta = nullptr) override;
 
+    std::vector<NoiseField> regionNoiseFields() const override {
+        auto lock = lockParameters();
+        return {{frequency_, lacunarity_, persistence_, octaves_, seed_}};
+    }
+
     // Procedural parameters
     float frequency_   = 1.5f;
     float lacunarity_  = 2.0f;
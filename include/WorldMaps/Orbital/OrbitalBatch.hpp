@@ -0,0 +1,70 @@
+#pragma once
+#include <WorldMaps/Orbital/OrbitalMechanics.hpp>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Orbital {
+
+// Newton steps taken by the batched solvers.  Fixed so every lane does the
+// same work; from Danby's starting guess this reaches double precision for
+// e < 0.99 (solveKeplerEquation stays the reference for single bodies).
+constexpr int KEPLER_BATCH_ITERATIONS = 8;
+
+// ── Batched Kepler solver ────────────────────────────────────────────
+// E[i] = eccentric anomaly for mean anomaly M[i] and eccentricity e[i].
+// Vectorised where <experimental/simd> is available.
+void solveKeplerBatch(const double* M, const double* e, double* E, size_t n);
+
+// ── Structure-of-arrays orbital elements ─────────────────────────────
+// Keplerian elements of many bodies, with the per-orbit constants (mean
+// motion, minor-axis factor, perifocal → parent-frame basis) folded in so a
+// position is one Kepler solve plus six multiply-adds.
+struct OrbitBatch {
+    std::vector<double> meanAnomalyEpoch;
+    std::vector<double> meanMotion;       // 2π / period
+    std::vector<double> eccentricity;
+    std::vector<double> semiMajorAxis;    // 0 for invalid elements
+    std::vector<double> minorFactor;      // √(1 - e²)
+    std::vector<double> px, py, pz;       // unit vector towards periapsis
+    std::vector<double> qx, qy, qz;       // in-plane, 90° ahead of periapsis
+
+    size_t size() const { return meanAnomalyEpoch.size(); }
+    void clear();
+    void assign(const std::vector<KeplerianElements>& elements);
+    void push(const KeplerianElements& elem);
+};
+
+// Positions of every orbit in `batch` at time t, in each parent's frame.
+// Matches orbitalPosition(); invalid elements give the origin.
+void orbitalPositionsBatch(const OrbitBatch& batch, double t, std::vector<glm::dvec3>& out);
+
+// Same samples as orbitPathPoints(), solved as one batch.
+void orbitPathPointsBatch(const KeplerianElements& elem, int segments, std::vector<glm::dvec3>& out);
+
+// ── Orbit path cache ─────────────────────────────────────────────────
+// Orbit polylines keyed by their elements, so paths are only regenerated
+// when a body's orbit changes rather than on every frame.  Entries not
+// requested since the previous sweep() are dropped.
+class OrbitPathCache {
+public:
+    const std::vector<glm::dvec3>& path(const KeplerianElements& elem, int segments);
+
+    // Drop paths not requested since the last sweep.
+    void sweep();
+    void clear() { m_paths.clear(); }
+    size_t size() const { return m_paths.size(); }
+
+private:
+    struct Entry {
+        KeplerianElements elements;   // guards against hash collisions
+        int segments = 0;
+        std::vector<glm::dvec3> points;
+        bool used = false;
+    };
+    std::unordered_map<uint64_t, Entry> m_paths;
+};
+
+} // namespace Orbital
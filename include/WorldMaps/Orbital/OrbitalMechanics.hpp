@@ -1,5 +1,8 @@
 #pragma once
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
 #include <glm/glm.hpp>
 
 namespace Orbital {
@@ -13,8 +16,31 @@ struct KeplerianElements {
     double argPeriapsis    = 0.0;   // argument of periapsis (radians)
     double meanAnomalyEpoch = 0.0;  // mean anomaly at epoch t=0 (radians)
     double period          = 1.0;   // orbital period in time units
+
+    bool operator==(const KeplerianElements& o) const {
+        return semiMajorAxis == o.semiMajorAxis && eccentricity == o.eccentricity &&
+               inclination == o.inclination && longAscNode == o.longAscNode &&
+               argPeriapsis == o.argPeriapsis && meanAnomalyEpoch == o.meanAnomalyEpoch &&
+               period == o.period;
+    }
+    bool operator!=(const KeplerianElements& o) const { return !(*this == o); }
 };
 
+// FNV-1a over the element bits; keys cached orbit data (paths, batches).
+inline uint64_t orbitalElementsHash(const KeplerianElements& elem, uint64_t h = 1469598103934665603ull) {
+    const double fields[] = { elem.semiMajorAxis, elem.eccentricity, elem.inclination, elem.longAscNode,
+                              elem.argPeriapsis, elem.meanAnomalyEpoch, elem.period };
+    for (double f : fields) {
+        uint64_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        for (int i = 0; i < 8; ++i) {
+            h ^= (bits >> (i * 8)) & 0xFF;
+            h *= 1099511628211ull;
+        }
+    }
+    return h;
+}
+
 // ── Kepler equation solver ───────────────────────────────────────────
 // Solves M = E - e*sin(E) for E using Newton-Raphson iteration.
 // M = mean anomaly, e = eccentricity. Returns eccentric anomaly E.
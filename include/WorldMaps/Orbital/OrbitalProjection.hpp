@@ -1,15 +1,62 @@
 #pragma once
 #include <WorldMaps/Orbital/OrbitalSystem.hpp>
 #include <WorldMaps/Orbital/OrbitalMechanics.hpp>
+#include <WorldMaps/Orbital/OrbitalBatch.hpp>
 #include <OpenCLContext.hpp>
+#include <WorldMaps/World/Projections/ProjectionUpload.hpp>
 #include <GL/glew.h>
 #include <CL/cl.h>
 #include <glm/glm.hpp>
 #include <vector>
 #include <cmath>
+#include <unordered_map>
+#include <utility>
 
 namespace Orbital {
 
+// Orbit line geometry of one drawing style (plain orbits or asteroid belts).
+// Owns its device buffers; they grow as needed and are reused across frames.
+struct OrbitLineGroup {
+    std::vector<const CelestialBody*> bodies;   // orbiting bodies drawn this frame
+    std::vector<cl_float4> hostPoints;          // CPU path: world-space path points
+    std::vector<cl_float4> hostOrbits;          // GPU path: per-orbit basis (3 float4s)
+    std::vector<cl_float4> hostOffsets;         // GPU path: parent position per orbit
+    cl_mem points = nullptr;                    // line kernel input
+    cl_mem orbits = nullptr;                    // re-uploaded only when elements change
+    cl_mem offsets = nullptr;
+    size_t pointCapacity = 0, orbitCapacity = 0, offsetCapacity = 0;
+    uint64_t orbitsHash = 0;
+
+    OrbitLineGroup() = default;
+    ~OrbitLineGroup() { release(); }
+    OrbitLineGroup(const OrbitLineGroup&) = delete;
+    OrbitLineGroup& operator=(const OrbitLineGroup&) = delete;
+    OrbitLineGroup(OrbitLineGroup&& o) noexcept { *this = std::move(o); }
+    OrbitLineGroup& operator=(OrbitLineGroup&& o) noexcept {
+        if (this != &o) {
+            release();
+            bodies = std::move(o.bodies);
+            hostPoints = std::move(o.hostPoints);
+            hostOrbits = std::move(o.hostOrbits);
+            hostOffsets = std::move(o.hostOffsets);
+            points = std::exchange(o.points, nullptr);
+            orbits = std::exchange(o.orbits, nullptr);
+            offsets = std::exchange(o.offsets, nullptr);
+            pointCapacity = std::exchange(o.pointCapacity, 0);
+            orbitCapacity = std::exchange(o.orbitCapacity, 0);
+            offsetCapacity = std::exchange(o.offsetCapacity, 0);
+            orbitsHash = std::exchange(o.orbitsHash, 0);
+        }
+        return *this;
+    }
+    void release() {
+        for (cl_mem* m : { &points, &orbits, &offsets })
+            if (*m) { OpenCLContext::get().releaseMem(*m); *m = nullptr; }
+        pointCapacity = orbitCapacity = offsetCapacity = 0;
+        orbitsHash = 0;
+    }
+};
+
 // Projects an OrbitalSystem into a 2D image using OpenCL multi-sphere ray tracing.
 // Manages GPU buffers, kernel dispatch, and GL texture readback.
 class OrbitalProjection {
@@ -21,20 +68,24 @@ public:
     OrbitalProjection(OrbitalProjection&& o) noexcept
         : m_centerLon(o.m_centerLon), m_centerLat(o.m_centerLat), m_zoom(o.m_zoom),
           m_fovY(o.m_fovY), m_time(o.m_time), m_drawOrbits(o.m_drawOrbits),
+          m_uploadFormat(o.m_uploadFormat),
+          m_gpuOrbitPaths(o.m_gpuOrbitPaths),
           m_outputBuffer(o.m_outputBuffer), m_bodyDefBuffer(o.m_bodyDefBuffer),
-          m_orbitPointsBuffer(o.m_orbitPointsBuffer) {
-        o.m_outputBuffer = nullptr; o.m_bodyDefBuffer = nullptr; o.m_orbitPointsBuffer = nullptr;
+          m_pathCache(std::move(o.m_pathCache)),
+          m_orbitLines(std::move(o.m_orbitLines)), m_beltLines(std::move(o.m_beltLines)) {
+        o.m_outputBuffer = nullptr; o.m_bodyDefBuffer = nullptr;
     }
     OrbitalProjection& operator=(OrbitalProjection&& o) noexcept {
         if (this != &o) {
             if (m_outputBuffer) OpenCLContext::get().releaseMem(m_outputBuffer);
             if (m_bodyDefBuffer) OpenCLContext::get().releaseMem(m_bodyDefBuffer);
-            if (m_orbitPointsBuffer) OpenCLContext::get().releaseMem(m_orbitPointsBuffer);
             m_centerLon = o.m_centerLon; m_centerLat = o.m_centerLat; m_zoom = o.m_zoom;
             m_fovY = o.m_fovY; m_time = o.m_time; m_drawOrbits = o.m_drawOrbits;
+            m_uploadFormat = o.m_uploadFormat; m_gpuOrbitPaths = o.m_gpuOrbitPaths;
             m_outputBuffer = o.m_outputBuffer; m_bodyDefBuffer = o.m_bodyDefBuffer;
-            m_orbitPointsBuffer = o.m_orbitPointsBuffer;
-            o.m_outputBuffer = nullptr; o.m_bodyDefBuffer = nullptr; o.m_orbitPointsBuffer = nullptr;
+            m_pathCache = std::move(o.m_pathCache);
+            m_orbitLines = std::move(o.m_orbitLines); m_beltLines = std::move(o.m_beltLines);
+            o.m_outputBuffer = nullptr; o.m_bodyDefBuffer = nullptr;
         }
         return *this;
     }
@@ -56,12 +107,21 @@ public:
     void setDrawOrbits(bool d) { m_drawOrbits = d; }
     bool drawOrbits() const { return m_drawOrbits; }
 
+    // Generate orbit path points on the device (orbital_orbit_paths) instead
+    // of from the host-side path cache
+    void setGpuOrbitPaths(bool v) { m_gpuOrbitPaths = v; }
+    bool gpuOrbitPaths() const { return m_gpuOrbitPaths; }
+
     // Optional N-body simulation (numerical)
     void setUseNBody(bool v) { m_useNBody = v; }
     bool useNBody() const { return m_useNBody; }
     void setNBodyTimestep(double dt) { m_nbodyDt = dt; }
     double nbodyTimestep() const { return m_nbodyDt; }
 
+    // Texture format for the uploaded frame (RGBA8 quarters the transfer)
+    void setUploadFormat(ProjectionUpload::Format f) { m_uploadFormat = f; }
+    ProjectionUpload::Format uploadFormat() const { return m_uploadFormat; }
+
     // Render the system into the given GL texture.
     // Creates/resizes the texture as needed.
     void project(OrbitalSystem& system, int width, int height, GLuint& texture);
@@ -79,14 +139,22 @@ private:
     bool m_useNBody = false;
     double m_nbodyDt = 0.01; // years per integrator step
 
+    ProjectionUpload::Format m_uploadFormat = ProjectionUpload::Format::RGBA32F;
+    bool m_gpuOrbitPaths = false;
+
     // OpenCL resources
     cl_mem m_outputBuffer = nullptr;
     cl_mem m_bodyDefBuffer = nullptr;
-    cl_mem m_orbitPointsBuffer = nullptr;
+
+    // Orbit lines: paths relative to the parent, cached per orbital elements
+    OrbitPathCache m_pathCache;
+    OrbitLineGroup m_orbitLines;
+    OrbitLineGroup m_beltLines;
 
     static cl_program s_program;
     static cl_kernel s_sphereKernel;
     static cl_kernel s_orbitKernel;
+    static cl_kernel s_pathKernel;
 
     void ensureProgram();
     void dispatchSpheres(const std::vector<OrbitalSystem::BodyPosition>& positions,
@@ -97,12 +165,21 @@ private:
                          float camRightX, float camRightY, float camRightZ,
                          float camUpX, float camUpY, float camUpZ);
     void dispatchOrbitLines(const OrbitalSystem& system,
+                            const std::vector<OrbitalSystem::BodyPosition>& analytic,
                             int width, int height,
                             float camPosX, float camPosY, float camPosZ,
                             float camFwdX, float camFwdY, float camFwdZ,
                             float camRightX, float camRightY, float camRightZ,
                             float camUpX, float camUpY, float camUpZ);
     void ensureOutputBuffer(int width, int height);
+
+    // Fill group.points for this frame; returns the point count (0 = skip)
+    int preparePathsCPU(OrbitLineGroup& group,
+                        const std::unordered_map<const CelestialBody*, glm::dvec3>& worldPos,
+                        int pointsPerOrbit);
+    int preparePathsGPU(OrbitLineGroup& group,
+                        const std::unordered_map<const CelestialBody*, glm::dvec3>& worldPos,
+                        int pointsPerOrbit);
 };
 
 } // namespace Orbital
@@ -1,5 +1,6 @@
 #pragma once
 #include <WorldMaps/Orbital/CelestialBody.hpp>
+#include <WorldMaps/Orbital/OrbitalBatch.hpp>
 #include <string>
 #include <vector>
 #include <memory>
@@ -57,7 +58,8 @@ public:
     // Get all root bodies (stars, or top-level objects with no parent)
     std::vector<CelestialBody*> rootBodies() const;
     
-    // Compute all body positions at a given time
+    // Compute all body positions at a given time (batched; same results as
+    // CelestialBody::worldPositionAt for every body)
     struct BodyPosition {
         CelestialBody* body;
         glm::dvec3 position;
@@ -78,8 +80,16 @@ private:
     std::vector<std::unique_ptr<CelestialBody>> m_bodies;
     std::vector<OrbitalSystemInfo> m_childSystems;  // for galaxies: child stellar systems
     bool m_loaded = false;
+
+    // Batched analytic positions; rebuilt when an orbit or parent link changes
+    mutable OrbitBatch m_batch;
+    mutable std::vector<int> m_batchParent;         // parent body index, -1 for none
+    mutable std::vector<glm::dvec3> m_batchLocal;
+    mutable uint64_t m_batchHash = 0;
+    mutable bool m_batchValid = false;
     
     void buildHierarchy();
+    void refreshBatch() const;
 };
 
 } // namespace Orbital
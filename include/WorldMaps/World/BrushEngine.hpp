@@ -0,0 +1,68 @@
+#pragma once
+#include <WorldMaps/World/World.hpp>
+#include <string>
+#include <vector>
+
+/// Paints brush strokes into world layer deltas.
+///
+/// A stroke is fed one cursor position (lon/lat radians) per frame.  The
+/// segment from the previous position is resampled into evenly spaced
+/// dabs.  All dabs of a frame are stamped on the GPU into every chunk they
+/// overlap, at every depth where the brush still covers half a sample
+/// (plus already-populated finer depths).  Afterwards only the touched
+/// sub-rectangles of the cached chunk buffers are regenerated.
+class BrushEngine
+{
+public:
+    struct Settings {
+        float radius = 4.0f;            // samples at the stroke's paint depth
+        float strength = 0.1f;
+        DeltaMode mode = DeltaMode::Add;
+        float spacing = 0.25f;          // dab spacing as a fraction of the radius
+        int extraDepths = 4;            // finer depths stamped where chunks already exist
+    };
+
+    BrushEngine() = default;
+    ~BrushEngine();
+
+    BrushEngine(const BrushEngine&) = delete;
+    BrushEngine& operator=(const BrushEngine&) = delete;
+
+    /// Start a stroke on `layerName`; `depth` fixes the sample spacing the
+    /// radius is measured in for the whole stroke.
+    void beginStroke(const std::string& layerName, int depth);
+
+    /// Extend the stroke to a new cursor position and stamp it.
+    void strokeTo(World& world, float lonRad, float latRad, const Settings& settings);
+
+    void endStroke();
+    bool isStroking() const { return active_; }
+
+private:
+    struct Dab { float lon, lat; };
+    struct Patch {
+        ChunkCoord coord;
+        int x0 = 0, y0 = 0, w = 0, h = 0; // texel rect, row 0 = north
+        size_t offset = 0;                // first texel in the patch buffer
+    };
+
+    bool active_ = false;
+    bool hasLast_ = false;
+    std::string layerName_;
+    int depth_ = 0;
+    float lastLon_ = 0.0f;
+    float lastLat_ = 0.0f;
+    float carry_ = 0.0f;                  // samples travelled since the last dab
+
+    // GPU staging, grown on demand and reused across frames
+    cl_mem patchBuf_ = nullptr;  size_t patchCap_ = 0;
+    cl_mem rectBuf_ = nullptr;   size_t rectCap_ = 0;
+    cl_mem originBuf_ = nullptr; size_t originCap_ = 0;
+    cl_mem dabBuf_ = nullptr;    size_t dabCap_ = 0;
+
+    void collectDabs(float lonRad, float latRad, const Settings& settings, std::vector<Dab>& out);
+    void collectPatches(World& world, const std::vector<Dab>& dabs, const Settings& settings,
+                        std::vector<Patch>& out);
+    void stamp(World& world, const std::vector<Dab>& dabs, const Settings& settings);
+    void releaseBuffers();
+};
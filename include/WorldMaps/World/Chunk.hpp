@@ -6,6 +6,7 @@
 #include <unordered_map>
 #include <string>
 #include <chrono>
+#include <atomic>
 #include <CL/cl.h>
 #include <WorldMaps/World/LayerDelta.hpp>
 
@@ -100,12 +101,26 @@ struct ChunkCoordHash {
 // ChunkLayerCache – per-layer GPU cache entry for one chunk
 // ─────────────────────────────────────────────────────────────────────
 
+/// Process-wide monotonic id stamped on a cache entry each time its
+/// buffers are regenerated.  Lets consumers (e.g. the ChunkAssembler
+/// atlas) detect stale copies even if a cl_mem handle value is recycled.
+inline uint64_t nextChunkGeneration() {
+    static std::atomic<uint64_t> counter{0};
+    return ++counter;
+}
+
 struct ChunkLayerCache {
     cl_mem sampleBuffer = nullptr; // scalar data (float per texel)
     cl_mem colorBuffer  = nullptr; // RGBA data  (float4 per texel)
     int    generatedResX = 0;      // resolution this was last generated at
     int    generatedResY = 0;
     bool   dirty         = true;   // needs (re-)generation
+    uint64_t generation  = 0;      // nextChunkGeneration() at last regeneration
+    /// Buffer is a stand-in cropped from the parent (see ChunkLOD) and
+    /// still has to be generated.  Tracked per buffer: the colour and
+    /// sample paths refine independently.
+    bool   provisionalSample = false;
+    bool   provisionalColor  = false;
 
     std::chrono::steady_clock::time_point lastAccess;
 
@@ -1,7 +1,11 @@
 #pragma once
 #include <WorldMaps/World/Chunk.hpp>
 #include <OpenCLContext.hpp>
+#include <array>
 #include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
 #include <tracy/Tracy.hpp>
 
 #ifndef M_PI
@@ -11,8 +15,15 @@
 /// Assembles chunk GPU buffers into a single viewport-sized buffer.
 ///
 /// Each chunk is a small (CHUNK_BASE_RES × CHUNK_BASE_RES) cl_mem.
-/// The assembler copies each chunk into the correct sub-rectangle of
-/// a larger viewport buffer using an OpenCL kernel.
+/// By default the assembler works in batched mode: chunk texels are
+/// packed into a persistent atlas (one fixed-size slot per chunk, reused
+/// across frames while the chunk buffer is unchanged), a descriptor table
+/// is uploaded once, and a single NDRange composes every chunk.  If the
+/// batched kernels are unavailable the assembler falls back to one
+/// copy_chunk_to_viewport_* dispatch per chunk.
+///
+/// Neither path blocks the host: work is flushed to the (in-order) queue
+/// and completion can be observed through the optional cl_event.
 class ChunkAssembler {
 public:
     /// Information about one chunk to be assembled.
@@ -21,8 +32,25 @@ public:
         cl_mem      buffer; // RGBA float4 or scalar float
         int         resX;   // actual resolution of the chunk buffer (columns)
         int         resY;   // actual resolution of the chunk buffer (rows)
+        uint64_t    generation = 0; // ChunkLayerCache::generation (0 = never reuse atlas slot)
+    };
+
+    /// Host mirror of the ChunkDescriptor struct in ChunkAssemble.cl.
+    struct ChunkDescriptor {
+        cl_int srcOffset;
+        cl_int resX;
+        cl_int resY;
+        cl_int destX;
+        cl_int destY;
+        cl_int pad0;
+        cl_int pad1;
+        cl_int pad2;
     };
 
+    /// Enable/disable the single-dispatch batched path (on by default).
+    static void setBatchedEnabled(bool enabled) { batchedEnabled() = enabled; }
+    static bool isBatchedEnabled() { return batchedEnabled(); }
+
     /// Assemble RGBA chunk buffers into a viewport buffer.
     ///
     /// @param chunks       List of chunks with their buffers and resolutions.
@@ -33,18 +61,20 @@ public:
     /// @param viewLonMax   Viewport east edge (degrees).
     /// @param viewLatMin   Viewport south edge (degrees).
     /// @param viewLatMax   Viewport north edge (degrees).
+    /// @param completion   Optional: receives an event that completes when
+    ///                     outputBuffer is fully assembled (caller releases).
     static void assembleRGBA(
         const std::vector<ChunkEntry>& chunks,
         cl_mem& outputBuffer,
         int viewportW, int viewportH,
         float viewLonMin, float viewLonMax,
-        float viewLatMin, float viewLatMax)
+        float viewLatMin, float viewLatMax,
+        cl_event* completion = nullptr)
     {
         ZoneScopedN("ChunkAssembler::assembleRGBA");
+        if (completion) *completion = nullptr;
         if (!OpenCLContext::get().isReady()) return;
 
-        cl_int err = CL_SUCCESS;
-
         // Ensure output buffer is large enough
         size_t outSize = static_cast<size_t>(viewportW) * viewportH * sizeof(cl_float4);
         ensureBuffer(outputBuffer, outSize);
@@ -52,34 +82,28 @@ public:
         // Clear the viewport buffer to transparent black
         clearViewport(outputBuffer, viewportW, viewportH);
 
-        // Copy each chunk into the correct position
-        for (const auto& chunk : chunks) {
-            if (!chunk.buffer) continue;
-
-            // Compute chunk bounds in degrees
-            float cLonMin, cLonMax, cLatMin, cLatMax;
-            chunk.coord.getBoundsDegrees(cLonMin, cLonMax, cLatMin, cLatMax);
-
-            // Compute destination position in viewport texels
-            float viewLonSpan = viewLonMax - viewLonMin;
-            float viewLatSpan = viewLatMax - viewLatMin;
-            if (viewLonSpan <= 0.0f || viewLatSpan <= 0.0f) continue;
-
-            // destX = fraction along viewport width where chunk starts
-            int destX = static_cast<int>(std::round(
-                (cLonMin - viewLonMin) / viewLonSpan * viewportW));
-            // destY = fraction along viewport height (north = row 0)
-            int destY = static_cast<int>(std::round(
-                (viewLatMax - cLatMax) / viewLatSpan * viewportH));
-
-            copyChunkToViewport(
-                chunk.buffer, chunk.resX, chunk.resY,
-                outputBuffer, viewportW, viewportH,
-                destX, destY);
+        bool batched = batchedEnabled() &&
+            assembleBatched(batchState(true), sizeof(cl_float4), "assemble_chunks_rgba",
+                            chunks, outputBuffer, viewportW, viewportH,
+                            viewLonMin, viewLonMax, viewLatMin, viewLatMax);
+
+        if (!batched) {
+            // Copy each chunk into the correct position
+            for (const auto& chunk : chunks) {
+                int destX, destY;
+                if (!chunk.buffer || !destinationFor(chunk, viewportW, viewportH,
+                                                     viewLonMin, viewLonMax,
+                                                     viewLatMin, viewLatMax,
+                                                     destX, destY))
+                    continue;
+                copyChunkToViewport(
+                    chunk.buffer, chunk.resX, chunk.resY,
+                    outputBuffer, viewportW, viewportH,
+                    destX, destY);
+            }
         }
 
-        // Flush the queue
-        clFinish(OpenCLContext::get().getQueue());
+        signalCompletion(completion);
     }
 
     /// Same as assembleRGBA but for scalar (float) buffers.
@@ -88,46 +112,289 @@ public:
         cl_mem& outputBuffer,
         int viewportW, int viewportH,
         float viewLonMin, float viewLonMax,
-        float viewLatMin, float viewLatMax)
+        float viewLatMin, float viewLatMax,
+        cl_event* completion = nullptr)
     {
         ZoneScopedN("ChunkAssembler::assembleScalar");
+        if (completion) *completion = nullptr;
         if (!OpenCLContext::get().isReady()) return;
 
-        cl_int err = CL_SUCCESS;
         size_t outSize = static_cast<size_t>(viewportW) * viewportH * sizeof(float);
         ensureBuffer(outputBuffer, outSize);
 
         // Clear (zero fill)
         float zero = 0.0f;
-        err = clEnqueueFillBuffer(OpenCLContext::get().getQueue(), outputBuffer,
-                                   &zero, sizeof(float), 0, outSize,
-                                   0, nullptr, nullptr);
+        clEnqueueFillBuffer(OpenCLContext::get().getQueue(), outputBuffer,
+                            &zero, sizeof(float), 0, outSize,
+                            0, nullptr, nullptr);
+
+        bool batched = batchedEnabled() &&
+            assembleBatched(batchState(false), sizeof(float), "assemble_chunks_scalar",
+                            chunks, outputBuffer, viewportW, viewportH,
+                            viewLonMin, viewLonMax, viewLatMin, viewLatMax);
+
+        if (!batched) {
+            for (const auto& chunk : chunks) {
+                int destX, destY;
+                if (!chunk.buffer || !destinationFor(chunk, viewportW, viewportH,
+                                                     viewLonMin, viewLonMax,
+                                                     viewLatMin, viewLatMax,
+                                                     destX, destY))
+                    continue;
+                copyChunkToViewportScalar(
+                    chunk.buffer, chunk.resX, chunk.resY,
+                    outputBuffer, viewportW, viewportH,
+                    destX, destY);
+            }
+        }
+
+        signalCompletion(completion);
+    }
+
+    /// Release the persistent atlas / descriptor buffers (used before shutdown).
+    static void releaseBatchBuffers() {
+        for (BatchState* st : { &batchState(true), &batchState(false) }) {
+            for (DescriptorTable& t : st->tables) {
+                if (t.uploadDone) { clWaitForEvents(1, &t.uploadDone); clReleaseEvent(t.uploadDone); }
+                if (t.buffer) OpenCLContext::get().releaseMem(t.buffer);
+            }
+            if (st->atlas) OpenCLContext::get().releaseMem(st->atlas);
+            *st = BatchState{};
+        }
+    }
+
+private:
+    /// One fixed-size region of the atlas and the chunk buffer it mirrors.
+    struct AtlasSlot {
+        cl_mem   source     = nullptr;
+        uint64_t generation = 0;
+    };
+
+    /// A descriptor table and the device buffer it is uploaded to.  The
+    /// host copy must outlive its non-blocking upload.
+    struct DescriptorTable {
+        cl_mem buffer = nullptr;
+        size_t capacity = 0;                  // descriptors the device buffer can hold
+        std::vector<ChunkDescriptor> host;
+        cl_event uploadDone = nullptr;
+    };
+
+    /// Persistent per-format state for the batched path.
+    struct BatchState {
+        cl_mem atlas        = nullptr;
+        size_t slotTexels   = 0;   // texels reserved per chunk slot
+        std::vector<AtlasSlot> slots;
+        std::unordered_map<cl_mem, size_t> residentSlots; // source buffer -> slot
+        // Alternated per call, so a call only waits on the upload from two
+        // calls back (long finished) rather than the one just enqueued
+        std::array<DescriptorTable, 2> tables;
+        size_t nextTable = 0;
+    };
+
+    static bool& batchedEnabled() { static bool enabled = true; return enabled; }
 
+    static BatchState& batchState(bool rgba) {
+        static BatchState rgbaState;
+        static BatchState scalarState;
+        return rgba ? rgbaState : scalarState;
+    }
+
+    /// Viewport texel where a chunk's top-left corner lands.
+    static bool destinationFor(const ChunkEntry& chunk, int viewportW, int viewportH,
+                               float viewLonMin, float viewLonMax,
+                               float viewLatMin, float viewLatMax,
+                               int& destX, int& destY) {
+        // Compute chunk bounds in degrees
+        float cLonMin, cLonMax, cLatMin, cLatMax;
+        chunk.coord.getBoundsDegrees(cLonMin, cLonMax, cLatMin, cLatMax);
+
+        float viewLonSpan = viewLonMax - viewLonMin;
+        float viewLatSpan = viewLatMax - viewLatMin;
+        if (viewLonSpan <= 0.0f || viewLatSpan <= 0.0f) return false;
+
+        // destX = fraction along viewport width where chunk starts
+        destX = static_cast<int>(std::round(
+            (cLonMin - viewLonMin) / viewLonSpan * viewportW));
+        // destY = fraction along viewport height (north = row 0)
+        destY = static_cast<int>(std::round(
+            (viewLatMax - cLatMax) / viewLatSpan * viewportH));
+        return true;
+    }
+
+    /// Flush the queue and hand out an event for the last enqueued command.
+    static void signalCompletion(cl_event* completion) {
+        cl_command_queue queue = OpenCLContext::get().getQueue();
+        if (completion)
+            clEnqueueMarkerWithWaitList(queue, 0, nullptr, completion);
+        clFlush(queue);
+    }
+
+    /// Pack chunks into the atlas and compose them with a single dispatch.
+    /// Returns false if the batched kernel is unavailable (caller falls back).
+    static bool assembleBatched(BatchState& st, size_t texelBytes, const char* kernelName,
+                                const std::vector<ChunkEntry>& chunks,
+                                cl_mem outputBuffer, int viewportW, int viewportH,
+                                float viewLonMin, float viewLonMax,
+                                float viewLatMin, float viewLatMax) {
+        ZoneScopedN("ChunkAssembler::assembleBatched");
+        static cl_program prog = nullptr;
+        static std::unordered_map<std::string, cl_kernel> kernels;
+        cl_kernel& kern = kernels[kernelName];
+        try {
+            OpenCLContext::get().createProgram(prog, "Kernels/ChunkAssemble.cl");
+            OpenCLContext::get().createKernelFromProgram(kern, prog, kernelName);
+        } catch (...) { return false; }
+
+        cl_command_queue queue = OpenCLContext::get().getQueue();
+        cl_int err = CL_SUCCESS;
+
+        // This call's descriptor table; its host copy may still be owned by
+        // the upload from two calls ago.
+        DescriptorTable& table = st.tables[st.nextTable];
+        st.nextTable = (st.nextTable + 1) % st.tables.size();
+        if (table.uploadDone) {
+            clWaitForEvents(1, &table.uploadDone);
+            clReleaseEvent(table.uploadDone);
+            table.uploadDone = nullptr;
+        }
+
+        if (st.slotTexels == 0)
+            st.slotTexels = static_cast<size_t>(CHUNK_BASE_RES) * CHUNK_BASE_RES;
+
+        struct Placement { const ChunkEntry* entry; int destX, destY; long slot; };
+        std::vector<Placement> placements;
+        placements.reserve(chunks.size());
         for (const auto& chunk : chunks) {
-            if (!chunk.buffer) continue;
+            int destX, destY;
+            if (!chunk.buffer || !destinationFor(chunk, viewportW, viewportH,
+                                                 viewLonMin, viewLonMax,
+                                                 viewLatMin, viewLatMax,
+                                                 destX, destY))
+                continue;
+            if (static_cast<size_t>(chunk.resX) * chunk.resY > st.slotTexels) {
+                // Oversized chunk: doesn't fit an atlas slot, copy it directly.
+                if (texelBytes == sizeof(cl_float4))
+                    copyChunkToViewport(chunk.buffer, chunk.resX, chunk.resY,
+                                        outputBuffer, viewportW, viewportH, destX, destY);
+                else
+                    copyChunkToViewportScalar(chunk.buffer, chunk.resX, chunk.resY,
+                                              outputBuffer, viewportW, viewportH, destX, destY);
+                continue;
+            }
+            placements.push_back({ &chunk, destX, destY, -1 });
+        }
+        if (placements.empty()) return true;
+
+        // Grow the atlas when the visible set no longer fits.  Growing drops
+        // residency, so every chunk is re-packed once.
+        if (placements.size() > st.slots.size()) {
+            size_t newSlots = std::max<size_t>({ placements.size(), st.slots.size() * 2, 64 });
+            if (st.atlas) OpenCLContext::get().releaseMem(st.atlas);
+            st.atlas = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE,
+                newSlots * st.slotTexels * texelBytes, nullptr, &err, "chunk assemble atlas");
+            if (err != CL_SUCCESS || !st.atlas) {
+                st.atlas = nullptr;
+                st.slots.clear();
+                st.residentSlots.clear();
+                return false;
+            }
+            st.slots.assign(newSlots, AtlasSlot{});
+            st.residentSlots.clear();
+        }
 
-            float cLonMin, cLonMax, cLatMin, cLatMax;
-            chunk.coord.getBoundsDegrees(cLonMin, cLonMax, cLatMin, cLatMax);
+        // Reuse slots whose contents still mirror the chunk buffer.
+        std::vector<char> used(st.slots.size(), 0);
+        for (auto& p : placements) {
+            const ChunkEntry& e = *p.entry;
+            if (e.generation == 0) continue;
+            auto it = st.residentSlots.find(e.buffer);
+            if (it == st.residentSlots.end()) continue;
+            if (st.slots[it->second].generation != e.generation || used[it->second]) continue;
+            p.slot = static_cast<long>(it->second);
+            used[it->second] = 1;
+        }
 
-            float viewLonSpan = viewLonMax - viewLonMin;
-            float viewLatSpan = viewLatMax - viewLatMin;
-            if (viewLonSpan <= 0.0f || viewLatSpan <= 0.0f) continue;
+        // Pack the remaining chunks into free slots (device-side copies only).
+        size_t cursor = 0;
+        for (auto& p : placements) {
+            if (p.slot >= 0) continue;
+            while (used[cursor]) ++cursor;
+            AtlasSlot& slot = st.slots[cursor];
+            if (slot.source) {
+                auto it = st.residentSlots.find(slot.source);
+                if (it != st.residentSlots.end() && it->second == cursor)
+                    st.residentSlots.erase(it);
+            }
+            const ChunkEntry& e = *p.entry;
+            size_t bytes = static_cast<size_t>(e.resX) * e.resY * texelBytes;
+            err = clEnqueueCopyBuffer(queue, e.buffer, st.atlas, 0,
+                                      cursor * st.slotTexels * texelBytes, bytes,
+                                      0, nullptr, nullptr);
+            if (err != CL_SUCCESS) {
+                slot = AtlasSlot{};
+                continue;
+            }
+            slot.source = e.buffer;
+            slot.generation = e.generation;
+            st.residentSlots[e.buffer] = cursor;
+            p.slot = static_cast<long>(cursor);
+            used[cursor] = 1;
+        }
 
-            int destX = static_cast<int>(std::round(
-                (cLonMin - viewLonMin) / viewLonSpan * viewportW));
-            int destY = static_cast<int>(std::round(
-                (viewLatMax - cLatMax) / viewLatSpan * viewportH));
+        // Build and upload the descriptor table.
+        table.host.clear();
+        int maxResX = 0, maxResY = 0;
+        for (const auto& p : placements) {
+            if (p.slot < 0) continue;
+            ChunkDescriptor d{};
+            d.srcOffset = static_cast<cl_int>(static_cast<size_t>(p.slot) * st.slotTexels);
+            d.resX = p.entry->resX;
+            d.resY = p.entry->resY;
+            d.destX = p.destX;
+            d.destY = p.destY;
+            table.host.push_back(d);
+            maxResX = std::max(maxResX, d.resX);
+            maxResY = std::max(maxResY, d.resY);
+        }
+        if (table.host.empty()) return true;
+
+        if (table.host.size() > table.capacity) {
+            size_t newCap = std::max<size_t>(table.host.size(), table.capacity * 2);
+            if (table.buffer) OpenCLContext::get().releaseMem(table.buffer);
+            table.buffer = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY,
+                newCap * sizeof(ChunkDescriptor), nullptr, &err, "chunk assemble descriptors");
+            if (err != CL_SUCCESS || !table.buffer) {
+                table.buffer = nullptr;
+                table.capacity = 0;
+                return false;
+            }
+            table.capacity = newCap;
+        }
 
-            copyChunkToViewportScalar(
-                chunk.buffer, chunk.resX, chunk.resY,
-                outputBuffer, viewportW, viewportH,
-                destX, destY);
+        err = clEnqueueWriteBuffer(queue, table.buffer, CL_FALSE, 0,
+                                   table.host.size() * sizeof(ChunkDescriptor),
+                                   table.host.data(), 0, nullptr, &table.uploadDone);
+        if (err != CL_SUCCESS) {
+            table.uploadDone = nullptr;
+            return false;
         }
 
-        clFinish(OpenCLContext::get().getQueue());
+        int count = static_cast<int>(table.host.size());
+        clSetKernelArg(kern, 0, sizeof(cl_mem), &st.atlas);
+        clSetKernelArg(kern, 1, sizeof(cl_mem), &table.buffer);
+        clSetKernelArg(kern, 2, sizeof(int),    &count);
+        clSetKernelArg(kern, 3, sizeof(cl_mem), &outputBuffer);
+        clSetKernelArg(kern, 4, sizeof(int),    &viewportW);
+        clSetKernelArg(kern, 5, sizeof(int),    &viewportH);
+
+        size_t global[3] = { static_cast<size_t>(maxResX),
+                             static_cast<size_t>(maxResY),
+                             static_cast<size_t>(count) };
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, kern, 3, nullptr, global, nullptr,
+                                     0, nullptr, nullptr);
+        return err == CL_SUCCESS;
     }
 
-private:
     /// Ensure a cl_mem buffer is at least `minSize` bytes.
     static void ensureBuffer(cl_mem& buf, size_t minSize) {
         if (buf) {
@@ -160,7 +427,7 @@ private:
         clSetKernelArg(kern, 3, sizeof(cl_float4), &clearColor);
 
         size_t global[2] = { static_cast<size_t>(w), static_cast<size_t>(h) };
-        clEnqueueNDRangeKernel(OpenCLContext::get().getQueue(), kern, 2,
+        OpenCLContext::get().enqueueNDRangeKernel(OpenCLContext::get().getQueue(), kern, 2,
                                nullptr, global, nullptr, 0, nullptr, nullptr);
     }
 
@@ -186,7 +453,7 @@ private:
         clSetKernelArg(kern, 7, sizeof(int), &destY);
 
         size_t global[2] = { static_cast<size_t>(chunkW), static_cast<size_t>(chunkH) };
-        clEnqueueNDRangeKernel(OpenCLContext::get().getQueue(), kern, 2,
+        OpenCLContext::get().enqueueNDRangeKernel(OpenCLContext::get().getQueue(), kern, 2,
                                nullptr, global, nullptr, 0, nullptr, nullptr);
     }
 
@@ -212,7 +479,7 @@ private:
         clSetKernelArg(kern, 7, sizeof(int), &destY);
 
         size_t global[2] = { static_cast<size_t>(chunkW), static_cast<size_t>(chunkH) };
-        clEnqueueNDRangeKernel(OpenCLContext::get().getQueue(), kern, 2,
+        OpenCLContext::get().enqueueNDRangeKernel(OpenCLContext::get().getQueue(), kern, 2,
                                nullptr, global, nullptr, 0, nullptr, nullptr);
     }
 };
@@ -0,0 +1,116 @@
+#pragma once
+#include <WorldMaps/World/Chunk.hpp>
+#include <OpenCLContext.hpp>
+#include <array>
+#include <string>
+#include <tracy/Tracy.hpp>
+
+/// How World reuses cached chunks of neighbouring quadtree levels instead
+/// of generating every newly visible chunk from scratch.
+struct ChunkLODOptions {
+    /// Show a crop of the cached parent while a zoomed-in chunk waits for
+    /// generation.  The crop is provisional and replaced within a few calls.
+    bool upsampleParents = true;
+    /// Build a parent from its four cached children (zooming out) instead of
+    /// generating it.  Box-filtered colour; scalar ids are kept as ids.
+    bool downsampleChildren = true;
+    /// Chunks generated per region call while provisional crops are
+    /// available; the rest are refined on the following calls.
+    int refineBudget = 64;
+};
+
+/// GPU helpers that rebuild a chunk buffer from the levels around it.
+/// Every buffer is CHUNK_BASE_RES-style row-major data (row 0 = north),
+/// float4 for colour and float for scalar samples.
+class ChunkLOD {
+public:
+    /// New resX × resY buffer holding the parent's quadrant for `child`,
+    /// upsampled (bicubic colour, nearest scalar).  Null on failure.
+    static cl_mem upsampleQuadrant(cl_mem parent, int parentResX, int parentResY,
+                                   const ChunkCoord& child, int resX, int resY, bool rgba)
+    {
+        ZoneScopedN("ChunkLOD::upsampleQuadrant");
+        if (!parent || !OpenCLContext::get().isReady()) return nullptr;
+        cl_kernel kern = kernel(rgba ? "lod_upsample_rgba" : "lod_upsample_scalar");
+        if (!kern) return nullptr;
+
+        cl_mem out = createOutput(resX, resY, rgba, "ChunkLOD upsample");
+        if (!out) return nullptr;
+
+        int qx = child.x & 1;
+        int qy = child.y & 1;
+        clSetKernelArg(kern, 0, sizeof(cl_mem), &parent);
+        clSetKernelArg(kern, 1, sizeof(cl_mem), &out);
+        clSetKernelArg(kern, 2, sizeof(int), &parentResY);
+        clSetKernelArg(kern, 3, sizeof(int), &parentResX);
+        clSetKernelArg(kern, 4, sizeof(int), &resY);
+        clSetKernelArg(kern, 5, sizeof(int), &resX);
+        clSetKernelArg(kern, 6, sizeof(int), &qx);
+        clSetKernelArg(kern, 7, sizeof(int), &qy);
+        return dispatch(kern, out, resX, resY);
+    }
+
+    /// New resX × resY parent buffer from its four children, each resX ×
+    /// resY, in ChunkCoord::children() order.  Null on failure.
+    static cl_mem downsampleChildren(const std::array<cl_mem, 4>& children,
+                                     int resX, int resY, bool rgba)
+    {
+        ZoneScopedN("ChunkLOD::downsampleChildren");
+        if (!OpenCLContext::get().isReady()) return nullptr;
+        for (cl_mem c : children)
+            if (!c) return nullptr;
+        cl_kernel kern = kernel(rgba ? "lod_downsample_rgba" : "lod_downsample_scalar");
+        if (!kern) return nullptr;
+
+        cl_mem out = createOutput(resX, resY, rgba, "ChunkLOD downsample");
+        if (!out) return nullptr;
+
+        // children() runs west-to-east, south-to-north; the kernel takes
+        // the quadrants as laid out on screen
+        cl_mem nw = children[2], ne = children[3], sw = children[0], se = children[1];
+        clSetKernelArg(kern, 0, sizeof(cl_mem), &nw);
+        clSetKernelArg(kern, 1, sizeof(cl_mem), &ne);
+        clSetKernelArg(kern, 2, sizeof(cl_mem), &sw);
+        clSetKernelArg(kern, 3, sizeof(cl_mem), &se);
+        clSetKernelArg(kern, 4, sizeof(cl_mem), &out);
+        clSetKernelArg(kern, 5, sizeof(int), &resY);
+        clSetKernelArg(kern, 6, sizeof(int), &resX);
+        return dispatch(kern, out, resX, resY);
+    }
+
+private:
+    static cl_kernel kernel(const std::string& name) {
+        static cl_program prog = nullptr;
+        static cl_kernel upRGBA = nullptr, upScalar = nullptr;
+        static cl_kernel downRGBA = nullptr, downScalar = nullptr;
+        try {
+            OpenCLContext::get().createProgram(prog, "Kernels/ChunkLOD.cl");
+            OpenCLContext::get().createKernelFromProgram(upRGBA, prog, "lod_upsample_rgba");
+            OpenCLContext::get().createKernelFromProgram(upScalar, prog, "lod_upsample_scalar");
+            OpenCLContext::get().createKernelFromProgram(downRGBA, prog, "lod_downsample_rgba");
+            OpenCLContext::get().createKernelFromProgram(downScalar, prog, "lod_downsample_scalar");
+        } catch (...) { return nullptr; }
+        if (name == "lod_upsample_rgba") return upRGBA;
+        if (name == "lod_upsample_scalar") return upScalar;
+        if (name == "lod_downsample_rgba") return downRGBA;
+        return downScalar;
+    }
+
+    static cl_mem createOutput(int resX, int resY, bool rgba, const char* tag) {
+        cl_int err = CL_SUCCESS;
+        size_t bytes = static_cast<size_t>(resX) * resY * (rgba ? sizeof(cl_float4) : sizeof(float));
+        cl_mem out = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, bytes, nullptr, &err, tag);
+        return err == CL_SUCCESS ? out : nullptr;
+    }
+
+    static cl_mem dispatch(cl_kernel kern, cl_mem out, int resX, int resY) {
+        size_t global[2] = { static_cast<size_t>(resY), static_cast<size_t>(resX) };
+        cl_int err = OpenCLContext::get().enqueueNDRangeKernel(OpenCLContext::get().getQueue(), kern, 2,
+                                                               nullptr, global, nullptr, 0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            OpenCLContext::get().releaseMem(out);
+            return nullptr;
+        }
+        return out;
+    }
+};
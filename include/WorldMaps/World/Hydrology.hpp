@@ -0,0 +1,95 @@
+#pragma once
+#include <WorldMaps/World/NoiseBackend.hpp>
+#include <CL/cl.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// Inputs a drainage network is built from; equal keys give the same network.
+struct HydrologyKey {
+    NoiseField elevation;       // the world's elevation field (carries its seed)
+    float seaLevel = 0.5f;      // elevation below this is ocean
+    float riverArea = 48.0f;    // drainage area (in equator cells) where rivers start
+    int rows = 1024;            // latitude cells, row 0 at the north pole
+    int cols = 2048;            // longitude cells, column 0 at the antimeridian
+
+    bool operator==(const HydrologyKey& o) const {
+        return elevation == o.elevation && seaLevel == o.seaLevel && riverArea == o.riverArea &&
+               rows == o.rows && cols == o.cols;
+    }
+    bool operator!=(const HydrologyKey& o) const { return !(*this == o); }
+    uint64_t hash() const;
+};
+
+/// World-wide drainage network on an equirectangular grid.
+///
+/// Built once per key and shared by every world asking for the same one:
+///   1. depressions in the elevation field are filled with Priority-Flood+ε
+///      (Barnes et al. 2014), seeded from the ocean, so every land cell has
+///      a strictly lower neighbour and water always reaches the sea;
+///   2. each land cell drains to its steepest D8 neighbour on the filled
+///      surface (longitude wraps; spacing shrinks with cos(latitude));
+///   3. drainage area is accumulated down the resulting tree in topological
+///      order — a wavefront of cells whose donors are all done — on the
+///      OpenCL device when it is a GPU, else with a host queue.
+///
+/// Chunks then only look up the cells under them, so rivers are continuous
+/// across chunk seams and cost nothing to query at depth.
+class Hydrology
+{
+public:
+    /// River piece from a cell centre to its receiver's, in radians.  The
+    /// receiver end is unwrapped to lie next to the source across the
+    /// antimeridian.
+    struct Segment {
+        float lonA, latA, lonB, latB;
+        float intensity;
+    };
+
+    /// Network for `key`, built on first request.  Null when OpenCL is not
+    /// available.
+    static std::shared_ptr<const Hydrology> acquire(const HydrologyKey& key);
+
+    ~Hydrology();
+    Hydrology(const Hydrology&) = delete;
+    Hydrology& operator=(const Hydrology&) = delete;
+
+    const HydrologyKey& key() const { return key_; }
+    int rows() const { return key_.rows; }
+    int cols() const { return key_.cols; }
+    float cellLatRad() const;
+
+    const std::vector<float>& filled() const { return filled_; }
+    /// D8 receiver of each cell; -1 for ocean (and the outlet of a world
+    /// without ocean).
+    const std::vector<int32_t>& receivers() const { return receivers_; }
+    /// Upstream drainage area of each cell, in equator-cell units.
+    const std::vector<float>& accumulation() const { return accumulation_; }
+    /// River strength in [0, 1]: 0 below riverArea, log-scaled to 1 at the
+    /// largest river.
+    const std::vector<float>& intensity() const { return intensity_; }
+    /// Device copy of intensity(), row-major like the grid.
+    cl_mem intensityBuffer() const { return intensityBuf_; }
+
+    /// River segments of the cells within the bounds (longitude wraps).
+    void segments(float lonMinRad, float lonMaxRad, float latMinRad, float latMaxRad,
+                  std::vector<Segment>& out) const;
+
+private:
+    explicit Hydrology(const HydrologyKey& key) : key_(key) {}
+
+    HydrologyKey key_;
+    std::vector<float> filled_;
+    std::vector<int32_t> receivers_;
+    std::vector<float> accumulation_;
+    std::vector<float> intensity_;
+    cl_mem intensityBuf_ = nullptr;
+
+    bool build();
+    void fillDepressions(const std::vector<float>& elevation);
+    void routeD8();
+    bool accumulateGPU();
+    void accumulateCPU();
+    void computeIntensity();
+};
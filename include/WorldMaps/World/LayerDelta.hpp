@@ -4,6 +4,8 @@
 #include <unordered_map>
 #include <cstdint>
 #include <cstring>
+#include <algorithm>
+#include <zstd.h>
 
 /// How a delta value is applied to the procedural base
 enum class DeltaMode : int {
@@ -12,47 +14,104 @@ enum class DeltaMode : int {
 };
 
 /// Per-layer per-chunk edit data.
-/// Stores a dense grid of floating-point edits that overlay on top of
-/// the procedurally generated base values.
+/// Edits that overlay the procedurally generated base values are stored
+/// sparsely: the grid is split into TILE×TILE tiles that are only
+/// allocated once a sample inside them becomes non-zero, and released
+/// again when the tile returns to all zeros.
 struct LayerDelta {
+    static constexpr int TILE = 8;
+
     DeltaMode mode = DeltaMode::Add;
     int channelCount = 1;
     int resolution = 32; // samples per side (32×32)
-    std::vector<float> data; // resolution * resolution * channelCount
 
     /// Per-chunk parameter overrides (e.g. "seed" -> 99999, "frequency" -> 3.0)
     std::unordered_map<std::string, float> paramOverrides;
 
-    /// Check if any edits exist
+    /// Check if any edits exist (O(1): non-zero samples are counted on write)
     bool hasEdits() const {
-        if (!paramOverrides.empty()) return true;
-        for (float v : data) {
-            if (v != 0.0f) return true;
-        }
-        return false;
+        return editCount_ > 0 || !paramOverrides.empty();
     }
 
-    /// Initialize data grid to zeros
+    /// True if any sample tile is allocated (i.e. there is grid data to upload)
+    bool hasGridData() const { return editCount_ > 0; }
+
+    /// Number of non-zero samples across all channels
+    size_t editCount() const { return editCount_; }
+
+    /// Number of allocated tiles
+    size_t allocatedTiles() const { return allocatedTiles_; }
+
+    /// True once initGrid() has sized the tile table
+    bool isInitialized() const { return !tiles_.empty(); }
+
+    /// Changed since the last markClean() (i.e. needs persisting)
+    bool isDirty() const { return revision_ != savedRevision_; }
+    uint64_t revision() const { return revision_; }
+    void markClean(uint64_t savedRevision) { savedRevision_ = savedRevision; }
+    void markClean() { savedRevision_ = revision_; }
+
+    /// Initialize an empty tile table (no tiles allocated)
     void initGrid(int res, int channels) {
         resolution = res;
         channelCount = channels;
-        data.assign(static_cast<size_t>(res) * res * channels, 0.0f);
+        tilesPerSide_ = (res + TILE - 1) / TILE;
+        tiles_.assign(static_cast<size_t>(tilesPerSide_) * tilesPerSide_, Tile{});
+        editCount_ = 0;
+        allocatedTiles_ = 0;
+        ++revision_;
     }
 
     /// Get delta value at position
     float getDelta(int x, int y, int channel = 0) const {
-        if (data.empty()) return 0.0f;
-        int idx = (y * resolution + x) * channelCount + channel;
-        if (idx < 0 || idx >= static_cast<int>(data.size())) return 0.0f;
-        return data[idx];
+        if (!inBounds(x, y, channel) || tiles_.empty()) return 0.0f;
+        const Tile& t = tiles_[tileIndex(x, y)];
+        if (t.values.empty()) return 0.0f;
+        return t.values[sampleIndex(x, y, channel)];
     }
 
     /// Set delta value at position
     void setDelta(int x, int y, int channel, float value) {
-        if (data.empty()) initGrid(resolution, channelCount);
-        int idx = (y * resolution + x) * channelCount + channel;
-        if (idx >= 0 && idx < static_cast<int>(data.size()))
-            data[idx] = value;
+        if (tiles_.empty()) initGrid(resolution, channelCount);
+        if (!inBounds(x, y, channel)) return;
+        Tile& t = tiles_[tileIndex(x, y)];
+        if (t.values.empty()) {
+            if (value == 0.0f) return;
+            t.values.assign(static_cast<size_t>(TILE) * TILE * channelCount, 0.0f);
+            ++allocatedTiles_;
+        }
+        float& slot = t.values[sampleIndex(x, y, channel)];
+        if (slot == value) return;
+        if (slot == 0.0f) { ++t.nonZero; ++editCount_; }
+        if (value == 0.0f) { --t.nonZero; --editCount_; }
+        slot = value;
+        ++revision_;
+        if (t.nonZero == 0) {
+            t.values.clear();
+            t.values.shrink_to_fit();
+            --allocatedTiles_;
+        }
+    }
+
+    /// Expand to a dense resolution × resolution × channelCount grid
+    /// (row-major, interleaved channels) for GPU upload.
+    std::vector<float> toDense() const {
+        std::vector<float> dense(static_cast<size_t>(resolution) * resolution * channelCount, 0.0f);
+        for (int ty = 0; ty < tilesPerSide_; ++ty) {
+            for (int tx = 0; tx < tilesPerSide_; ++tx) {
+                const Tile& t = tiles_[static_cast<size_t>(ty) * tilesPerSide_ + tx];
+                if (t.values.empty()) continue;
+                for (int ly = 0; ly < TILE; ++ly) {
+                    int y = ty * TILE + ly;
+                    if (y >= resolution) break;
+                    int cols = std::min(TILE, resolution - tx * TILE);
+                    std::memcpy(&dense[(static_cast<size_t>(y) * resolution + tx * TILE) * channelCount],
+                                &t.values[static_cast<size_t>(ly) * TILE * channelCount],
+                                static_cast<size_t>(cols) * channelCount * sizeof(float));
+                }
+            }
+        }
+        return dense;
     }
 
     /// Get parameter override, returns defaultVal if not overridden
@@ -64,29 +123,117 @@ struct LayerDelta {
     /// Set parameter override
     void setParam(const std::string& key, float value) {
         paramOverrides[key] = value;
+        ++revision_;
     }
 
     /// Clear all edits
     void clear() {
-        data.clear();
+        tiles_.clear();
+        tilesPerSide_ = 0;
+        editCount_ = 0;
+        allocatedTiles_ = 0;
         paramOverrides.clear();
+        ++revision_;
     }
 
-    /// Serialize data to binary blob for DB storage
+    /// Serialize data to a zstd-compressed blob for DB storage.
+    /// Layout before compression: header {magic, resolution, channels,
+    /// tileCount} followed by (uint32 tileIndex, TILE²·channels floats)
+    /// for every allocated tile.
     std::vector<uint8_t> serializeData() const {
-        std::vector<uint8_t> blob(data.size() * sizeof(float));
-        if (!data.empty()) {
-            std::memcpy(blob.data(), data.data(), blob.size());
+        if (editCount_ == 0) return {};
+        const size_t tileFloats = static_cast<size_t>(TILE) * TILE * channelCount;
+        std::vector<uint8_t> raw;
+        raw.reserve(sizeof(uint32_t) * 4 + allocatedTiles_ * (sizeof(uint32_t) + tileFloats * sizeof(float)));
+        auto put32 = [&raw](uint32_t v) {
+            uint8_t b[4];
+            std::memcpy(b, &v, 4);
+            raw.insert(raw.end(), b, b + 4);
+        };
+        put32(kTiledMagic);
+        put32(static_cast<uint32_t>(resolution));
+        put32(static_cast<uint32_t>(channelCount));
+        put32(static_cast<uint32_t>(allocatedTiles_));
+        for (size_t i = 0; i < tiles_.size(); ++i) {
+            if (tiles_[i].values.empty()) continue;
+            put32(static_cast<uint32_t>(i));
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(tiles_[i].values.data());
+            raw.insert(raw.end(), p, p + tileFloats * sizeof(float));
         }
+
+        std::vector<uint8_t> blob(ZSTD_compressBound(raw.size()));
+        size_t n = ZSTD_compress(blob.data(), blob.size(), raw.data(), raw.size(), 3);
+        if (ZSTD_isError(n)) return raw; // uncompressed tiled payload is still readable
+        blob.resize(n);
         return blob;
     }
 
-    /// Deserialize data from binary blob
+    /// Deserialize data from a binary blob.  Accepts the compressed tiled
+    /// format, its uncompressed payload, and the legacy dense float grid
+    /// (resolution/channelCount must already be set for the latter).
     void deserializeData(const uint8_t* blob, size_t blobSize) {
-        size_t floatCount = blobSize / sizeof(float);
-        data.resize(floatCount);
-        if (floatCount > 0) {
-            std::memcpy(data.data(), blob, floatCount * sizeof(float));
+        std::vector<uint8_t> raw;
+        uint32_t lead = 0;
+        if (blobSize >= 4) std::memcpy(&lead, blob, 4);
+        if (lead == ZSTD_MAGICNUMBER) {
+            unsigned long long size = ZSTD_getFrameContentSize(blob, blobSize);
+            if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN) {
+                initGrid(resolution, channelCount);
+                return;
+            }
+            raw.resize(static_cast<size_t>(size));
+            size_t n = ZSTD_decompress(raw.data(), raw.size(), blob, blobSize);
+            if (ZSTD_isError(n)) {
+                initGrid(resolution, channelCount);
+                return;
+            }
+            raw.resize(n);
+            blob = raw.data();
+            blobSize = raw.size();
+        }
+
+        uint32_t magic = 0;
+        if (blobSize >= sizeof(uint32_t) * 4) std::memcpy(&magic, blob, 4);
+        if (magic != kTiledMagic) {
+            // Legacy dense grid
+            initGrid(resolution, channelCount);
+            size_t floatCount = std::min(blobSize / sizeof(float),
+                                         static_cast<size_t>(resolution) * resolution * channelCount);
+            for (size_t i = 0; i < floatCount; ++i) {
+                float v;
+                std::memcpy(&v, blob + i * sizeof(float), sizeof(float));
+                if (v == 0.0f) continue;
+                int c = static_cast<int>(i % channelCount);
+                int s = static_cast<int>(i / channelCount);
+                setDelta(s % resolution, s / resolution, c, v);
+            }
+            return;
+        }
+
+        uint32_t res, channels, tileCount;
+        std::memcpy(&res, blob + 4, 4);
+        std::memcpy(&channels, blob + 8, 4);
+        std::memcpy(&tileCount, blob + 12, 4);
+        initGrid(static_cast<int>(res), static_cast<int>(channels));
+
+        const size_t tileFloats = static_cast<size_t>(TILE) * TILE * channelCount;
+        const size_t tileBytes = sizeof(uint32_t) + tileFloats * sizeof(float);
+        size_t off = sizeof(uint32_t) * 4;
+        for (uint32_t k = 0; k < tileCount && off + tileBytes <= blobSize; ++k, off += tileBytes) {
+            uint32_t idx;
+            std::memcpy(&idx, blob + off, 4);
+            if (idx >= tiles_.size()) continue;
+            Tile& t = tiles_[idx];
+            if (t.values.empty()) ++allocatedTiles_;
+            t.values.resize(tileFloats);
+            std::memcpy(t.values.data(), blob + off + 4, tileFloats * sizeof(float));
+            t.nonZero = 0;
+            for (float v : t.values) if (v != 0.0f) ++t.nonZero;
+            editCount_ += t.nonZero;
+            if (t.nonZero == 0) {
+                t.values.clear();
+                --allocatedTiles_;
+            }
         }
     }
 
@@ -103,6 +250,7 @@ struct LayerDelta {
     /// Deserialize param overrides from "key=value;key=value" string
     void deserializeParams(const std::string& str) {
         paramOverrides.clear();
+        ++revision_;
         if (str.empty()) return;
         size_t pos = 0;
         while (pos < str.size()) {
@@ -117,4 +265,30 @@ struct LayerDelta {
             pos = semi + 1;
         }
     }
+
+private:
+    static constexpr uint32_t kTiledMagic = 0x3154444Cu; // "LDT1"
+
+    struct Tile {
+        std::vector<float> values; // TILE*TILE*channelCount, empty = all zero
+        int nonZero = 0;
+    };
+
+    std::vector<Tile> tiles_;      // tilesPerSide_² slots, row-major
+    int tilesPerSide_ = 0;
+    size_t editCount_ = 0;
+    size_t allocatedTiles_ = 0;
+    uint64_t revision_ = 0;
+    uint64_t savedRevision_ = 0;
+
+    bool inBounds(int x, int y, int channel) const {
+        return x >= 0 && y >= 0 && x < resolution && y < resolution &&
+               channel >= 0 && channel < channelCount;
+    }
+    size_t tileIndex(int x, int y) const {
+        return static_cast<size_t>(y / TILE) * tilesPerSide_ + (x / TILE);
+    }
+    size_t sampleIndex(int x, int y, int channel) const {
+        return (static_cast<size_t>(y % TILE) * TILE + (x % TILE)) * channelCount + channel;
+    }
 };
@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/// Parameters of one sphere sub-region FBM evaluation; mirrors the
+/// arguments of perlin_fbm_3d_sphere_region in PerlinRegion.cl.
+struct PerlinRegionParams {
+    int resLat = 0;          // rows (north → south)
+    int resLon = 0;          // columns
+    float thetaMin = 0.0f;   // colatitude range (radians)
+    float thetaMax = 0.0f;
+    float phiMin = 0.0f;     // azimuth range (radians)
+    float phiMax = 0.0f;
+    float frequency = 1.0f;
+    float lacunarity = 2.0f;
+    int octaves = 1;
+    float persistence = 0.5f;
+    uint32_t seed = 0;
+};
+
+/// One FBM field of a fused region request; mirrors NoiseField in
+/// PerlinRegion.cl, so the layout must stay five packed 32-bit values.
+struct NoiseField {
+    float frequency = 1.0f;
+    float lacunarity = 2.0f;
+    float persistence = 0.5f;
+    int32_t octaves = 1;
+    uint32_t seed = 0;
+
+    bool operator==(const NoiseField& o) const {
+        return frequency == o.frequency && lacunarity == o.lacunarity &&
+               persistence == o.persistence && octaves == o.octaves && seed == o.seed;
+    }
+    bool operator!=(const NoiseField& o) const { return !(*this == o); }
+};
+static_assert(sizeof(NoiseField) == 20, "NoiseField must match the OpenCL struct");
+
+/// Where region noise is evaluated.
+enum class NoiseBackendKind : int {
+    Auto = 0,   // CPU when the OpenCL device is a CPU ICD
+    OpenCL = 1,
+    CPU = 2
+};
+
+/// Host-side region noise generator.
+class NoiseBackend {
+public:
+    virtual ~NoiseBackend() = default;
+    virtual const char* name() const = 0;
+
+    /// Fill `out` (resLat × resLon floats, row-major, row 0 = thetaMin) with
+    /// FBM in [0,1].  Returns false if the backend cannot run right now.
+    virtual bool perlinRegion(const PerlinRegionParams& params, float* out) = 0;
+};
+
+/// Vectorised, multithreaded CPU implementation of PerlinRegion.cl.
+///
+/// Uses the same integer lattice hashing as Util.cl, so lattice cells and
+/// gradient hashes match the kernel exactly.  The output is NOT bit-exact
+/// with the kernel: OpenCL leaves sin/cos (up to 4 ulp) and division
+/// (2.5 ulp) precision to the device, so no host code can reproduce every
+/// driver.  The trigonometry here is a fixed polynomial instead, which
+/// makes results identical across CPUs, SIMD widths and thread counts,
+/// and keeps them within kNoiseGpuTolerance of the GPU (--bench-noise).
+class CpuNoiseBackend : public NoiseBackend {
+public:
+    enum class Path { Scalar, SIMD };
+
+    CpuNoiseBackend();
+    ~CpuNoiseBackend() override;
+
+    const char* name() const override;
+    bool perlinRegion(const PerlinRegionParams& params, float* out) override;
+
+    /// False when the toolchain has no portable SIMD support.
+    static bool available();
+
+    /// Force a code path.  Scalar runs the same arithmetic one lane at a
+    /// time and is the reference the SIMD path is checked against.
+    void setPath(Path path);
+    Path path() const { return path_; }
+    size_t laneWidth() const;
+
+    /// Worker threads used in addition to the calling thread.
+    void setThreadCount(unsigned workers);
+    unsigned threadCount() const;
+
+private:
+    struct Pool;
+    std::unique_ptr<Pool> pool_;
+    Path path_;
+};
+
+/// Shared CPU backend instance.
+CpuNoiseBackend& cpuNoiseBackend();
+
+/// Runtime backend selection.  The initial setting comes from the
+/// LOREBOOK_NOISE environment variable (auto / opencl / cpu).
+void setNoiseBackend(NoiseBackendKind kind);
+NoiseBackendKind noiseBackendSetting();
+
+/// Resolve Auto against the current OpenCL device: OpenCL or CPU.
+/// Layers consume region noise as cl_mem, so either backend needs a ready
+/// OpenCL context; call this only once OpenCLContext::isReady().
+NoiseBackendKind activeNoiseBackend();
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/// One conformance case: the CPU noise backend against a reference.
+struct NoiseConformanceResult {
+    std::string name;
+    std::string reference;       // "OpenCL" or "CPU scalar"
+    size_t samples = 0;
+    size_t exactMatches = 0;     // bit-identical samples
+    float maxAbsError = 0.0f;
+    double meanAbsError = 0.0;
+    bool pass = false;
+};
+
+/// Sustained throughput of one backend configuration.
+struct NoiseThroughputResult {
+    std::string backend;
+    unsigned threads = 0;        // total threads including the caller
+    size_t lanes = 1;
+    double samplesPerSec = 0.0;
+};
+
+/// Run the CPU backend over a fixed set of regions and compare it with
+/// its scalar path (must be bit-identical) and, when an OpenCL context is
+/// ready, with PerlinRegion.cl (within kNoiseGpuTolerance).
+std::vector<NoiseConformanceResult> runNoiseConformance();
+
+/// Samples/sec for the CPU scalar, SIMD and threaded SIMD paths, and the
+/// OpenCL kernel (with readback) when a context is ready.
+std::vector<NoiseThroughputResult> runNoiseThroughput();
+
+/// Maximum |CPU − GPU| accepted by the conformance check.  OpenCL allows
+/// sin/cos up to 4 ulp, so exact equality with every device is not a goal.
+constexpr float kNoiseGpuTolerance = 1e-4f;
+
+/// Log both result tables through PLOG; returns false if any case failed.
+bool logNoiseDiagnostics(const std::vector<NoiseConformanceResult>& conformance,
+                         const std::vector<NoiseThroughputResult>& throughput);
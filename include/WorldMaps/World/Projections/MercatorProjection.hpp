@@ -15,6 +15,10 @@ public:
     //caller must cleanup texture when done
     void project(World &world, int width, int height, GLuint& texture, std::string layerName="") override;
 
+    /// Render the view into an OpenCL float4 buffer (width × height, owned by
+    /// this projection) without touching GL; project() uploads this buffer.
+    cl_mem projectToBuffer(World &world, int width, int height, const std::string &layerName = "");
+
 private:
     GLuint texture = 0;
     cl_mem mercatorBuffer = nullptr;
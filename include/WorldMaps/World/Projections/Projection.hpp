@@ -12,6 +12,7 @@
 #include <atomic>
 #include <array>
 #include <plog/Log.h>
+#include <WorldMaps/World/Projections/ProjectionUpload.hpp>
 
 class World;
 
@@ -21,4 +22,11 @@ public:
     Projection()= default;
     virtual ~Projection()= default;
     virtual void project(World &world, int width, int height, GLuint& texture, std::string layerName="") = 0;
+
+    /// Texture format used when the projected frame is uploaded to GL.
+    void setUploadFormat(ProjectionUpload::Format f) { uploadFormat = f; }
+    ProjectionUpload::Format getUploadFormat() const { return uploadFormat; }
+
+protected:
+    ProjectionUpload::Format uploadFormat = ProjectionUpload::Format::RGBA32F;
 };
\ No newline at end of file
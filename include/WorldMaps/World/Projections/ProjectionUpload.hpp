@@ -0,0 +1,373 @@
+#pragma once
+#include <OpenCLContext.hpp>
+#include <GL/glew.h>
+#include <unordered_map>
+#include <cstdint>
+#include <plog/Log.h>
+#include <tracy/Tracy.hpp>
+
+/// Moves a projection's RGBA output (one float4 per texel in a cl_mem) into
+/// the GL texture the UI displays, without the blocking
+/// read → clFinish → glTexSubImage2D round trip.
+///
+/// Two transports are used, in order of preference:
+///   1. CL/GL interop: the texture is shared with OpenCL and the buffer is
+///      copied device-side with clEnqueueCopyBufferToImage, synchronised
+///      through cl_khr_gl_event where the driver has it.
+///   2. Double-buffered PBOs: the CL buffer is read non-blocking straight
+///      into a mapped pixel-unpack buffer; the texture upload from that PBO
+///      happens on the next call, fenced so a PBO is never rewritten while
+///      GL is still sourcing from it. This adds one frame of latency.
+///
+/// Format::RGBA8 packs the float output to 8-bit UNORM on the device first,
+/// cutting transfer size and texture memory by 4×.
+///
+/// State is keyed by GL texture name because projections are often
+/// constructed per frame while their textures persist; call release()
+/// before deleting a texture that went through upload().
+class ProjectionUpload {
+public:
+    enum class Format {
+        RGBA32F,    // full float precision (previous behaviour)
+        RGBA8       // 8-bit UNORM — colour layers only need this much
+    };
+
+    /// Upload `source` (width × height float4 texels, row-major) into
+    /// `texture`, creating or reallocating it as needed.
+    static void upload(cl_mem source, int width, int height, GLuint& texture,
+                       Format format = Format::RGBA32F, GLint wrap = GL_REPEAT)
+    {
+        ZoneScopedN("ProjectionUpload::upload");
+        if (!source || width <= 0 || height <= 0) return;
+
+        bool fresh = (texture == 0);
+        if (fresh) createTexture(texture, wrap);
+        TextureState& state = states()[texture];
+        // GL may recycle the name of a texture deleted without release();
+        // free what that one left behind rather than overwrite it
+        if (fresh) releaseState(state);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        bool reallocated = ensureStorage(state, width, height, format);
+
+        cl_mem pixels = source;
+        if (format == Format::RGBA8) {
+            pixels = packRGBA8(state, source, width, height);
+            if (!pixels) return;
+        }
+
+        if (uploadInterop(state, texture, pixels, width, height)) return;
+        uploadPBO(state, texture, pixels, width, height, reallocated);
+    }
+
+    /// Drop the upload state (PBOs, fences, shared CL image) for a texture.
+    static void release(GLuint texture)
+    {
+        auto it = states().find(texture);
+        if (it == states().end()) return;
+        releaseState(it->second);
+        states().erase(it);
+    }
+
+private:
+    struct Slot {
+        GLuint   pbo = 0;
+        size_t   bytes = 0;
+        void*    mapped = nullptr;
+        cl_event ready = nullptr;   // CL read into `mapped` finished
+        GLsync   fence = nullptr;   // GL finished sourcing from `pbo`
+        bool     pending = false;   // read issued, texture not yet updated
+        int      width = 0, height = 0;
+    };
+
+    struct TextureState {
+        int    width = 0, height = 0;
+        Format format = Format::RGBA32F;
+        bool   allocated = false;
+
+        cl_mem packed = nullptr;        // RGBA8 staging buffer
+        size_t packedBytes = 0;
+
+        cl_mem sharedImage = nullptr;   // interop image aliasing the texture
+        bool   interopFailed = false;
+        GLsync   glDone = nullptr;      // cl_khr_gl_event: fence the last acquire waited on
+        cl_event acquired = nullptr;    // ... and that acquire, which keeps glDone in use
+
+        Slot   slots[2];
+        int    nextSlot = 0;
+    };
+
+    static std::unordered_map<GLuint, TextureState>& states()
+    {
+        static std::unordered_map<GLuint, TextureState> s;
+        return s;
+    }
+
+    static size_t texelBytes(Format f) { return f == Format::RGBA8 ? 4 : sizeof(cl_float4); }
+
+    // ── Texture management ──────────────────────────────────────────
+
+    static void createTexture(GLuint& texture, GLint wrap)
+    {
+        ZoneScopedN("ProjectionUpload Texture Create");
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+
+    /// (Re)allocate storage for the bound texture if size or format changed.
+    /// Returns true if the storage was (re)allocated.
+    static bool ensureStorage(TextureState& st, int w, int h, Format format)
+    {
+        if (st.allocated && st.width == w && st.height == h && st.format == format)
+            return false;
+
+        ZoneScopedN("ProjectionUpload Texture Alloc");
+        if (format == Format::RGBA8)
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        else
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, w, h, 0, GL_RGBA, GL_FLOAT, nullptr);
+
+        // The shared CL image aliases the old storage — recreate on demand
+        if (st.sharedImage) {
+            OpenCLContext::get().releaseMem(st.sharedImage);
+            st.sharedImage = nullptr;
+        }
+        st.width = w;
+        st.height = h;
+        st.format = format;
+        st.allocated = true;
+        return true;
+    }
+
+    // ── RGBA8 packing ───────────────────────────────────────────────
+
+    static cl_mem packRGBA8(TextureState& st, cl_mem source, int w, int h)
+    {
+        ZoneScopedN("ProjectionUpload::packRGBA8");
+        static cl_program prog = nullptr;
+        static cl_kernel  kern = nullptr;
+        try {
+            OpenCLContext::get().createProgram(prog, "Kernels/PackRGBA8.cl");
+            OpenCLContext::get().createKernelFromProgram(kern, prog, "pack_rgba8");
+        } catch (const std::exception& e) {
+            PLOGE << "ProjectionUpload: pack_rgba8 unavailable: " << e.what();
+            return nullptr;
+        }
+
+        size_t bytes = static_cast<size_t>(w) * h * 4;
+        if (st.packed && st.packedBytes < bytes) {
+            OpenCLContext::get().releaseMem(st.packed);
+            st.packed = nullptr;
+        }
+        if (!st.packed) {
+            cl_int err = CL_SUCCESS;
+            st.packed = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, bytes, nullptr,
+                                                          &err, "projection rgba8 staging");
+            if (err != CL_SUCCESS || !st.packed) { st.packed = nullptr; return nullptr; }
+            st.packedBytes = bytes;
+        }
+
+        int count = w * h;
+        clSetKernelArg(kern, 0, sizeof(cl_mem), &source);
+        clSetKernelArg(kern, 1, sizeof(cl_mem), &st.packed);
+        clSetKernelArg(kern, 2, sizeof(int), &count);
+        size_t global = static_cast<size_t>(count);
+        cl_int err = OpenCLContext::get().enqueueNDRangeKernel(OpenCLContext::get().getQueue(), kern, 1,
+                                            nullptr, &global, nullptr, 0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            PLOGE << "ProjectionUpload: pack_rgba8 enqueue failed: " << err;
+            return nullptr;
+        }
+        return st.packed;
+    }
+
+    // ── Path 1: CL/GL interop ───────────────────────────────────────
+
+    static bool uploadInterop(TextureState& st, GLuint texture, cl_mem pixels, int w, int h)
+    {
+        auto& cl = OpenCLContext::get();
+        if (!cl.hasGLInterop() || st.interopFailed) return false;
+        ZoneScopedN("ProjectionUpload Interop");
+
+        if (!st.sharedImage) {
+            st.sharedImage = cl.createFromGLTexture(texture, CL_MEM_WRITE_ONLY);
+            if (!st.sharedImage) {
+                PLOGW << "ProjectionUpload: texture sharing failed, using PBO uploads";
+                st.interopFailed = true;
+                return false;
+            }
+        }
+
+        // GL must be done with the texture before CL acquires it, and CL
+        // must be done writing before GL samples it.
+        //
+        // With cl_khr_gl_event neither wait touches the host: a GL fence
+        // becomes the acquire's wait event, and the release is ordered
+        // before later GL commands on this thread by the extension, so a
+        // flush is enough.  Without it the sharing spec leaves no option
+        // but glFinish before the acquire and a host wait on the release
+        // event (not the whole queue) before GL may sample the texture.
+        retireInteropFence(st);
+        cl_event glDone = nullptr;
+        if (cl.hasGLEventSync()) {
+            st.glDone = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glFlush();
+            glDone = cl.createEventFromGLsync(st.glDone);
+            if (!glDone) { glDeleteSync(st.glDone); st.glDone = nullptr; }
+        }
+        if (!glDone) glFinish();
+
+        cl.acquireGLObjects(&st.sharedImage, 1, glDone ? 1 : 0, glDone ? &glDone : nullptr,
+                            glDone ? &st.acquired : nullptr);
+        if (glDone) clReleaseEvent(glDone);
+        size_t origin[3] = {0, 0, 0};
+        size_t region[3] = {static_cast<size_t>(w), static_cast<size_t>(h), 1};
+        cl_int err = clEnqueueCopyBufferToImage(cl.getQueue(), pixels, st.sharedImage, 0,
+                                                origin, region, 0, nullptr, nullptr);
+        if (st.glDone) {
+            cl.releaseGLObjects(&st.sharedImage, 1);
+            clFlush(cl.getQueue());
+        } else {
+            cl_event released = nullptr;
+            cl.releaseGLObjects(&st.sharedImage, 1, 0, nullptr, &released);
+            if (released) {
+                clWaitForEvents(1, &released);
+                clReleaseEvent(released);
+            } else {
+                clFinish(cl.getQueue());
+            }
+        }
+        if (err != CL_SUCCESS) {
+            PLOGW << "ProjectionUpload: clEnqueueCopyBufferToImage failed (" << err
+                  << "), using PBO uploads";
+            OpenCLContext::get().releaseMem(st.sharedImage);
+            st.sharedImage = nullptr;
+            st.interopFailed = true;
+            return false;
+        }
+        return true;
+    }
+
+    /// Delete the fence of the previous interop acquire once CL no longer
+    /// waits on it (it has always completed by the next frame)
+    static void retireInteropFence(TextureState& st)
+    {
+        if (st.acquired) {
+            clWaitForEvents(1, &st.acquired);
+            clReleaseEvent(st.acquired);
+            st.acquired = nullptr;
+        }
+        if (st.glDone) {
+            glDeleteSync(st.glDone);
+            st.glDone = nullptr;
+        }
+    }
+
+    // ── Path 2: double-buffered PBOs ────────────────────────────────
+
+    static void uploadPBO(TextureState& st, GLuint texture, cl_mem pixels, int w, int h,
+                          bool reallocated)
+    {
+        ZoneScopedN("ProjectionUpload PBO");
+        size_t bytes = static_cast<size_t>(w) * h * texelBytes(st.format);
+
+        // Publish the frame read on the previous call, if any
+        Slot& prev = st.slots[st.nextSlot ^ 1];
+        if (prev.pending) finishSlot(st, prev, texture);
+
+        // Start this frame's read into the other PBO
+        Slot& slot = st.slots[st.nextSlot];
+        if (slot.pending) finishSlot(st, slot, texture);
+        if (slot.fence) {
+            glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GLuint64(1000000000));
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+
+        if (slot.pbo == 0) glGenBuffers(1, &slot.pbo);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.pbo);
+        if (slot.bytes < bytes) {
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+            slot.bytes = bytes;
+        }
+        slot.mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                                       GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (!slot.mapped) {
+            PLOGE << "ProjectionUpload: glMapBufferRange failed";
+            return;
+        }
+
+        cl_int err = OpenCLContext::get().enqueueReadBuffer(OpenCLContext::get().getQueue(), pixels, CL_FALSE, 0,
+                                         bytes, slot.mapped, 0, nullptr, &slot.ready);
+        if (err != CL_SUCCESS) {
+            PLOGE << "ProjectionUpload: clEnqueueReadBuffer failed: " << err;
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.pbo);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            slot.mapped = nullptr;
+            slot.ready = nullptr;
+            return;
+        }
+        clFlush(OpenCLContext::get().getQueue());
+        slot.pending = true;
+        slot.width = w;
+        slot.height = h;
+        st.nextSlot ^= 1;
+
+        // Freshly (re)allocated storage has no previous frame to show, so
+        // publish immediately rather than display an undefined texture.
+        if (reallocated) finishSlot(st, slot, texture);
+    }
+
+    static void finishSlot(TextureState& st, Slot& slot, GLuint texture)
+    {
+        if (slot.ready) {
+            clWaitForEvents(1, &slot.ready);
+            clReleaseEvent(slot.ready);
+            slot.ready = nullptr;
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.pbo);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        slot.mapped = nullptr;
+        slot.pending = false;
+
+        // A resize since the read was issued makes the frame stale
+        if (slot.width == st.width && slot.height == st.height) {
+            glBindTexture(GL_TEXTURE_2D, texture);
+            if (st.format == Format::RGBA8)
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, slot.width, slot.height,
+                                GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            else
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, slot.width, slot.height,
+                                GL_RGBA, GL_FLOAT, nullptr);
+            slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    static void releaseState(TextureState& st)
+    {
+        for (Slot& slot : st.slots) {
+            if (slot.ready) {
+                clWaitForEvents(1, &slot.ready);
+                clReleaseEvent(slot.ready);
+            }
+            if (slot.mapped) {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.pbo);
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            }
+            if (slot.fence) glDeleteSync(slot.fence);
+            if (slot.pbo) glDeleteBuffers(1, &slot.pbo);
+            slot = Slot{};
+        }
+        retireInteropFence(st);
+        if (st.packed) OpenCLContext::get().releaseMem(st.packed);
+        if (st.sharedImage) OpenCLContext::get().releaseMem(st.sharedImage);
+        st = TextureState{};
+    }
+};
@@ -169,45 +169,9 @@ public:
                 return;
             }
         }
-        // Recreate texture if needed or channels changed
-        if (texture == 0)
-        {
-            ZoneScopedN("SphericalProjection Texture Create");
-            glGenTextures(1, &texture);
-            glBindTexture(GL_TEXTURE_2D, texture);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
-            glBindTexture(GL_TEXTURE_2D, texture);
-        }else{
-            ZoneScopedN("SphericalProjection Texture Resize Check");
-            // Texture exists, make sure its the right size
-            glBindTexture(GL_TEXTURE_2D, texture);
-            GLint texWidth = 0, texHeight = 0;
-            glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &texWidth);
-            glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &texHeight);
-            if(texWidth != width || texHeight != height){
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
-            }
-        }
-
-        // Download data from sphereBuffer to a host buffer and upload to the GL texture
         if (sphereBuffer)
         {
-            ZoneScopedN("SphericalProjection Readback");
-            cl_int err = CL_SUCCESS;
-            size_t bufSize = (size_t)width * (size_t)height * sizeof(float)*4;
-            std::vector<float> hostBuf((size_t)width * (size_t)height*4);
-            err = clEnqueueReadBuffer(OpenCLContext::get().getQueue(), sphereBuffer, CL_TRUE, 0, bufSize, hostBuf.data(), 0, nullptr, nullptr);
-            if (err != CL_SUCCESS)
-            {
-                PLOGE << "clEnqueueReadBuffer failed: " << err;
-            }
-            clFinish(OpenCLContext::get().getQueue());
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_FLOAT, hostBuf.data());
+            ProjectionUpload::upload(sphereBuffer, width, height, texture, uploadFormat, GL_REPEAT);
         }
         else
         {
@@ -278,24 +242,7 @@ public:
         if (spherePerspectiveProgram == nullptr)
         {
             ZoneScopedN("spherePerspectiveSample Program Init");
-            std::string kernel_code = preprocessCLIncludes("Kernels/SpherePerspective.cl");
-            const char *src = kernel_code.c_str();
-            size_t len = kernel_code.length();
-            spherePerspectiveProgram = clCreateProgramWithSource(ctx, 1, &src, &len, &err);
-            if (err != CL_SUCCESS || spherePerspectiveProgram == nullptr)
-                throw std::runtime_error("clCreateProgramWithSource failed");
-
-            err = clBuildProgram(spherePerspectiveProgram, 1, &device, nullptr, nullptr, nullptr);
-            if (err != CL_SUCCESS)
-            {
-                // retrieve build log
-                size_t log_size = 0;
-                clGetProgramBuildInfo(spherePerspectiveProgram, device, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
-                std::string log;
-                log.resize(log_size);
-                clGetProgramBuildInfo(spherePerspectiveProgram, device, CL_PROGRAM_BUILD_LOG, log_size, &log[0], nullptr);
-                throw std::runtime_error(std::string("Failed to build OpenCL program: ") + log);
-            }
+            OpenCLContext::get().createProgram(spherePerspectiveProgram, "Kernels/SpherePerspective.cl");
         }
 
         if(spherePerspectiveKernel == nullptr){
@@ -372,7 +319,7 @@ public:
         size_t global[2] = {(size_t)screenW, (size_t)screenH};
         {
             ZoneScopedN("spherePerspectiveSample Enqueue");
-            err = clEnqueueNDRangeKernel(queue, spherePerspectiveKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+            err = OpenCLContext::get().enqueueNDRangeKernel(queue, spherePerspectiveKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
         }
     }
 
@@ -409,23 +356,7 @@ public:
         if (spherePerspectiveProgram == nullptr)
         {
             ZoneScopedN("spherePerspectiveSampleRegion Program Init");
-            std::string kernel_code = preprocessCLIncludes("Kernels/SpherePerspective.cl");
-            const char *src = kernel_code.c_str();
-            size_t len = kernel_code.length();
-            spherePerspectiveProgram = clCreateProgramWithSource(ctx, 1, &src, &len, &err);
-            if (err != CL_SUCCESS || spherePerspectiveProgram == nullptr)
-                throw std::runtime_error("clCreateProgramWithSource failed for SpherePerspective");
-
-            err = clBuildProgram(spherePerspectiveProgram, 1, &device, nullptr, nullptr, nullptr);
-            if (err != CL_SUCCESS)
-            {
-                size_t log_size = 0;
-                clGetProgramBuildInfo(spherePerspectiveProgram, device, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
-                std::string log;
-                log.resize(log_size);
-                clGetProgramBuildInfo(spherePerspectiveProgram, device, CL_PROGRAM_BUILD_LOG, log_size, &log[0], nullptr);
-                throw std::runtime_error(std::string("Failed to build SpherePerspective program: ") + log);
-            }
+            OpenCLContext::get().createProgram(spherePerspectiveProgram, "Kernels/SpherePerspective.cl");
         }
 
         if (spherePerspectiveRegionKernel == nullptr)
@@ -486,7 +417,7 @@ public:
         size_t global[2] = {(size_t)screenW, (size_t)screenH};
         {
             ZoneScopedN("spherePerspectiveSampleRegion Enqueue");
-            err = clEnqueueNDRangeKernel(queue, spherePerspectiveRegionKernel, 2,
+            err = OpenCLContext::get().enqueueNDRangeKernel(queue, spherePerspectiveRegionKernel, 2,
                                           nullptr, global, nullptr, 0, nullptr, nullptr);
         }
     }
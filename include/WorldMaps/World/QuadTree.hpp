@@ -2,29 +2,95 @@
 #include <WorldMaps/World/Chunk.hpp>
 #include <unordered_map>
 #include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
 #include <algorithm>
 #include <cmath>
 #include <mutex>
+#include <thread>
+#include <cassert>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-/// Flat-map quadtree over the world surface.
+/// Linear quadtree over the world surface.
 ///
-/// Nodes are stored in a hash map keyed by ChunkCoord.  A node is considered
-/// a leaf when none of its four children exist in the map.  The tree is
-/// lazily expanded by ensureDepth() which creates nodes down to the requested
-/// depth for a given viewport bounding box.
+/// Every node is identified by a 64-bit locational key: the Morton
+/// (Z-order) code of its south-west corner at CHUNK_MAX_DEPTH, shifted up
+/// five bits, with the node depth in the low bits.  Sorting by that key
+/// puts every node directly in front of its descendants, so a subtree is
+/// one contiguous key range and parent/child keys are bit arithmetic.
+///
+/// Node payloads live in stable storage and are never removed.  The sorted
+/// key index is published as an immutable snapshot (RCU style): readers
+/// enter the current epoch, scan the snapshot and leave without taking any
+/// lock, while writers (ensureDepth / getOrCreate on a miss) serialise on
+/// a mutex, build the next snapshot, swap it in and free the old one once
+/// the readers of the previous epoch have drained.
+///
+/// Because the writer waits for those readers inline, the mutating calls
+/// (ensureDepth, ensureNodes, getOrCreate) must not run on a thread that
+/// is inside a read-side section of the same tree; that would wait on
+/// itself.  Read-side sections never escape the query calls, so this only
+/// matters for code added inside QuadTree; debug builds assert on it.
+///
+/// A node is a leaf when no descendant key follows it in the index.
 class QuadTree {
 public:
     QuadTree() {
         // Create root node (depth 0, covers the entire world)
-        ChunkCoord root{0, 0, 0};
-        ChunkData rootData;
-        rootData.coord = root;
+        ChunkData& rootData = storage_.emplace_back();
+        rootData.coord = {0, 0, 0};
         rootData.isLeaf = true;
-        nodes_[root] = std::move(rootData);
+        auto snap = new Snapshot;
+        snap->base = buildBase({{mortonKey(rootData.coord), &rootData}});
+        current_.store(snap);
+    }
+
+    ~QuadTree() { delete current_.load(); }
+
+    QuadTree(const QuadTree&) = delete;
+    QuadTree& operator=(const QuadTree&) = delete;
+
+    // ── Morton keys ──────────────────────────────────────────────────
+
+    /// Locational key of a coordinate (see class comment).
+    static uint64_t mortonKey(const ChunkCoord& c) {
+        return (cornerCode(c) << kDepthBits) | static_cast<uint64_t>(c.depth);
+    }
+
+    /// Inverse of mortonKey().
+    static ChunkCoord coordFromKey(uint64_t key) {
+        int depth = static_cast<int>(key & kDepthMask);
+        uint64_t code = (key >> kDepthBits) >> (2 * (CHUNK_MAX_DEPTH - depth));
+        return { static_cast<int>(compactBits(code)),
+                 static_cast<int>(compactBits(code >> 1)), depth };
+    }
+
+    /// First key past the subtree rooted at `key` (exclusive upper bound).
+    static uint64_t subtreeEnd(uint64_t key) {
+        int depth = static_cast<int>(key & kDepthMask);
+        uint64_t span = uint64_t(1) << (2 * (CHUNK_MAX_DEPTH - depth));
+        return ((key >> kDepthBits) + span) << kDepthBits;
+    }
+
+    /// Key of the parent node.  The root returns itself.
+    static uint64_t parentKey(uint64_t key) {
+        int depth = static_cast<int>(key & kDepthMask);
+        if (depth == 0) return key;
+        uint64_t span = uint64_t(1) << (2 * (CHUNK_MAX_DEPTH - depth + 1));
+        return (((key >> kDepthBits) & ~(span - 1)) << kDepthBits) |
+               static_cast<uint64_t>(depth - 1);
+    }
+
+    /// Key of child `i` (same order as ChunkCoord::children()).
+    static uint64_t childKey(uint64_t key, int i) {
+        int depth = static_cast<int>(key & kDepthMask);
+        uint64_t step = uint64_t(1) << (2 * (CHUNK_MAX_DEPTH - depth - 1));
+        return (((key >> kDepthBits) + static_cast<uint64_t>(i) * step) << kDepthBits) |
+               static_cast<uint64_t>(depth + 1);
     }
 
     // ── Depth / LOD helpers ──────────────────────────────────────────
@@ -104,95 +170,116 @@ public:
 
     /// Ensure that all chunks overlapping the given world-space bounding box
     /// (radians) exist down to the requested depth.  Ancestor nodes along the
-    /// path are created as needed and marked non-leaf.
+    /// path are created as needed and marked non-leaf.  Existing nodes are
+    /// checked against the snapshot first, so the writer lock is only taken
+    /// when something actually has to be inserted.
+    /// Must not be called from inside a read-side section (see class comment).
     void ensureDepth(float lonMin, float lonMax,
                      float latMin, float latMax, int depth) {
-        std::lock_guard<std::mutex> lk(mutex_);
         depth = std::clamp(depth, 0, CHUNK_MAX_DEPTH);
+        int xMin, xMax, yMin, yMax;
+        cellRange(lonMin, lonMax, latMin, latMax, depth, xMin, xMax, yMin, yMax);
+
+        std::vector<ChunkCoord> missing;
+        {
+            ReadGuard guard(*this);
+            const Snapshot* snap = guard.snapshot();
+            for (int cy = yMin; cy <= yMax; ++cy)
+                for (int cx = xMin; cx <= xMax; ++cx)
+                    if (!snap->find(mortonKey({cx, cy, depth})))
+                        missing.push_back({cx, cy, depth});
+        }
+        if (missing.empty()) return;
 
-        int cells = 1 << depth;
-        float lonRange = static_cast<float>(2.0 * M_PI);
-        float latRange = static_cast<float>(M_PI);
-        float cellW = lonRange / cells;
-        float cellH = latRange / cells;
-
-        // Determine index range that overlaps the bounding box
-        int xMin = static_cast<int>(std::floor((lonMin + static_cast<float>(M_PI)) / cellW));
-        int xMax = static_cast<int>(std::floor((lonMax + static_cast<float>(M_PI)) / cellW));
-        int yMin = static_cast<int>(std::floor((latMin + static_cast<float>(M_PI / 2.0)) / cellH));
-        int yMax = static_cast<int>(std::floor((latMax + static_cast<float>(M_PI / 2.0)) / cellH));
-
-        xMin = std::clamp(xMin, 0, cells - 1);
-        xMax = std::clamp(xMax, 0, cells - 1);
-        yMin = std::clamp(yMin, 0, cells - 1);
-        yMax = std::clamp(yMax, 0, cells - 1);
+        std::lock_guard<std::mutex> lk(writeMutex_);
+        insertLocked(missing);
+    }
 
-        for (int cy = yMin; cy <= yMax; ++cy) {
-            for (int cx = xMin; cx <= xMax; ++cx) {
-                ensureNode({cx, cy, depth});
-            }
-        }
+    /// Create many nodes (and their ancestors) under a single publish,
+    /// e.g. when loading stored deltas.
+    /// Must not be called from inside a read-side section (see class comment).
+    void ensureNodes(const std::vector<ChunkCoord>& coords) {
+        std::lock_guard<std::mutex> lk(writeMutex_);
+        insertLocked(coords);
     }
 
     /// Return coordinates of all leaf nodes that overlap the given bounds
     /// (radians).  If a maxDepth is provided, only returns leaves at that
     /// depth (or the deepest available ancestor).
+    /// Lock-free.
     std::vector<ChunkCoord> getLeavesInBounds(float lonMin, float lonMax,
                                               float latMin, float latMax,
-                                              int maxDepth = -1) {
-        std::lock_guard<std::mutex> lk(mutex_);
+                                              int maxDepth = -1) const {
+        ReadGuard guard(*this);
+        auto leaves = collectLeaves(guard.snapshot(), lonMin, lonMax, latMin, latMax, maxDepth);
         std::vector<ChunkCoord> result;
-        collectLeaves({0, 0, 0}, lonMin, lonMax, latMin, latMax,
-                      maxDepth, result);
+        result.reserve(leaves.size());
+        for (const auto& e : leaves) result.push_back(coordFromKey(e.key));
+        return result;
+    }
+
+    /// Same as getLeavesInBounds() but returns the nodes themselves, saving
+    /// the per-leaf lookup in the frame loop.
+    std::vector<ChunkData*> getLeafNodesInBounds(float lonMin, float lonMax,
+                                                 float latMin, float latMax,
+                                                 int maxDepth = -1) const {
+        ReadGuard guard(*this);
+        auto leaves = collectLeaves(guard.snapshot(), lonMin, lonMax, latMin, latMax, maxDepth);
+        std::vector<ChunkData*> result;
+        result.reserve(leaves.size());
+        for (const auto& e : leaves) result.push_back(e.node);
         return result;
     }
 
     /// Get or create the ChunkData for a coordinate.  Returns nullptr only
     /// if depth is out of range.
+    /// Must not be called from inside a read-side section (see class comment).
     ChunkData* getOrCreate(const ChunkCoord& coord) {
-        std::lock_guard<std::mutex> lk(mutex_);
-        return ensureNode(coord);
+        if (coord.depth < 0 || coord.depth > CHUNK_MAX_DEPTH) return nullptr;
+        if (ChunkData* cd = get(coord)) return cd;
+        std::lock_guard<std::mutex> lk(writeMutex_);
+        insertLocked({coord});
+        return current_.load()->find(mortonKey(coord)); // writer: no guard needed
     }
 
     /// Get ChunkData for an existing coordinate (returns nullptr if absent).
-    ChunkData* get(const ChunkCoord& coord) {
-        std::lock_guard<std::mutex> lk(mutex_);
-        auto it = nodes_.find(coord);
-        return (it != nodes_.end()) ? &it->second : nullptr;
+    /// Lock-free.
+    ChunkData* get(const ChunkCoord& coord) const {
+        if (coord.depth < 0 || coord.depth > CHUNK_MAX_DEPTH) return nullptr;
+        ReadGuard guard(*this);
+        return guard.snapshot()->find(mortonKey(coord));
     }
 
     /// Evict GPU buffers of least-recently-used chunks to stay within a
     /// maximum cache count.  Deltas are NOT evicted — only cl_mem caches.
     void evictLRU(size_t maxCachedNodes) {
-        std::lock_guard<std::mutex> lk(mutex_);
+        std::lock_guard<std::mutex> lk(writeMutex_);
         // Collect all nodes that have cached GPU data
-        struct Entry {
-            ChunkCoord coord;
+        struct Cached {
+            ChunkData* node;
             std::chrono::steady_clock::time_point oldest;
         };
-        std::vector<Entry> cached;
-        for (auto& [coord, data] : nodes_) {
+        std::vector<Cached> cached;
+        for (auto& data : storage_) {
             for (auto& [layer, cache] : data.layerCaches) {
                 if (cache.sampleBuffer || cache.colorBuffer) {
                     auto tp = cache.lastAccess;
-                    cached.push_back({coord, tp});
+                    cached.push_back({&data, tp});
                     break; // one entry per node
                 }
             }
         }
         if (cached.size() <= maxCachedNodes) return;
 
-        // Sort by oldest access first
-        std::sort(cached.begin(), cached.end(),
-                  [](const Entry& a, const Entry& b) {
-                      return a.oldest < b.oldest;
-                  });
-
+        // Only the oldest entries need ordering
         size_t toEvict = cached.size() - maxCachedNodes;
+        std::nth_element(cached.begin(), cached.begin() + (toEvict - 1), cached.end(),
+                         [](const Cached& a, const Cached& b) {
+                             return a.oldest < b.oldest;
+                         });
+
         for (size_t i = 0; i < toEvict; ++i) {
-            auto it = nodes_.find(cached[i].coord);
-            if (it == nodes_.end()) continue;
-            for (auto& [layer, cache] : it->second.layerCaches) {
+            for (auto& [layer, cache] : cached[i].node->layerCaches) {
                 // Release buffers through OpenCLContext tracked allocator
                 if (cache.sampleBuffer) {
                     clReleaseMemObject(cache.sampleBuffer);
@@ -202,6 +289,7 @@ public:
                     clReleaseMemObject(cache.colorBuffer);
                     cache.colorBuffer = nullptr;
                 }
+                cache.provisionalSample = cache.provisionalColor = false;
                 cache.dirty = true;
             }
         }
@@ -209,14 +297,14 @@ public:
 
     /// Total number of nodes currently in the tree.
     size_t nodeCount() const {
-        std::lock_guard<std::mutex> lk(mutex_);
-        return nodes_.size();
+        ReadGuard guard(*this);
+        return guard.snapshot()->size();
     }
 
     /// Clear all GPU caches (used before shutdown).
     void releaseAllBuffers() {
-        std::lock_guard<std::mutex> lk(mutex_);
-        for (auto& [coord, data] : nodes_) {
+        std::lock_guard<std::mutex> lk(writeMutex_);
+        for (auto& data : storage_) {
             for (auto& [layer, cache] : data.layerCaches) {
                 if (cache.sampleBuffer) {
                     clReleaseMemObject(cache.sampleBuffer);
@@ -226,6 +314,7 @@ public:
                     clReleaseMemObject(cache.colorBuffer);
                     cache.colorBuffer = nullptr;
                 }
+                cache.provisionalSample = cache.provisionalColor = false;
                 cache.dirty = true;
             }
         }
@@ -235,8 +324,8 @@ public:
     /// The callback must not modify the tree structure.
     template<typename Fn>
     void forEachNode(Fn&& fn) {
-        std::lock_guard<std::mutex> lk(mutex_);
-        for (auto& [coord, data] : nodes_) {
+        std::lock_guard<std::mutex> lk(writeMutex_);
+        for (auto& data : storage_) {
             fn(data);
         }
     }
@@ -244,85 +333,372 @@ public:
     /// Const version: iterate all nodes read-only.
     template<typename Fn>
     void forEachNode(Fn&& fn) const {
-        std::lock_guard<std::mutex> lk(mutex_);
-        for (const auto& [coord, data] : nodes_) {
+        std::lock_guard<std::mutex> lk(writeMutex_);
+        for (const auto& data : storage_) {
             fn(data);
         }
     }
 
 private:
-    mutable std::mutex mutex_;
-    std::unordered_map<ChunkCoord, ChunkData, ChunkCoordHash> nodes_;
+    static constexpr int kDepthBits = 5;
+    static constexpr uint64_t kDepthMask = (uint64_t(1) << kDepthBits) - 1;
+    static_assert(CHUNK_MAX_DEPTH < (1 << kDepthBits) && 2 * CHUNK_MAX_DEPTH + kDepthBits < 64,
+                  "locational key does not fit in 64 bits");
+
+    /// Query cells per getLeavesInBounds() call before the query depth stops
+    /// refining.
+    static constexpr int64_t kMaxQueryCells = 64;
+
+    /// Inserts accumulate in a sorted side array that is merged into the
+    /// hashed base once it outgrows max(kRecentMin, base / kRecentRatio),
+    /// so a publish copies only the side array and the O(n) rebuild is
+    /// amortised over many inserts.
+    static constexpr size_t kRecentMin = 256;
+    static constexpr size_t kRecentRatio = 8;
+
+    struct Entry {
+        uint64_t key;
+        ChunkData* node;
+        bool operator<(uint64_t k) const { return key < k; }
+    };
+
+    /// Merged forward iteration over the two sorted arrays of a snapshot.
+    class Cursor {
+    public:
+        Cursor(const Entry* a, const Entry* aEnd, const Entry* b, const Entry* bEnd)
+            : a_(a), aEnd_(aEnd), b_(b), bEnd_(bEnd) {}
+        bool done() const { return a_ == aEnd_ && b_ == bEnd_; }
+        uint64_t key() const { return front()->key; }
+        ChunkData* node() const { return front()->node; }
+        void next() { if (takeA()) ++a_; else ++b_; }
+        /// Advance to the first key >= k.  Short hops (the common case when
+        /// skipping a small subtree) are walked, longer ones binary-searched.
+        void seek(uint64_t k) {
+            for (int i = 0; i < 4 && a_ != aEnd_ && a_->key < k; ++i) ++a_;
+            if (a_ != aEnd_ && a_->key < k) a_ = std::lower_bound(a_, aEnd_, k);
+            for (int i = 0; i < 4 && b_ != bEnd_ && b_->key < k; ++i) ++b_;
+            if (b_ != bEnd_ && b_->key < k) b_ = std::lower_bound(b_, bEnd_, k);
+        }
+    private:
+        const Entry *a_, *aEnd_, *b_, *bEnd_;
+        bool takeA() const { return b_ == bEnd_ || (a_ != aEnd_ && a_->key < b_->key); }
+        const Entry* front() const { return takeA() ? a_ : b_; }
+    };
+
+    /// Sorted bulk of the index plus an open-addressed key table over it
+    /// (slot = entry index + 1, 0 = empty) for point lookups.
+    struct Base {
+        std::vector<Entry> entries;
+        std::vector<uint32_t> slots;
+        uint64_t mask = 0;
+
+        static uint64_t hash(uint64_t k) { return (k * 0x9E3779B97F4A7C15ull) >> 17; }
+
+        ChunkData* find(uint64_t k) const {
+            for (uint64_t h = hash(k) & mask;; h = (h + 1) & mask) {
+                uint32_t s = slots[h];
+                if (s == 0) return nullptr;
+                if (entries[s - 1].key == k) return entries[s - 1].node;
+            }
+        }
+    };
+
+    /// Immutable index published to readers.  `base` is shared between
+    /// consecutive snapshots; `recent` holds the latest inserts.
+    struct Snapshot {
+        std::shared_ptr<const Base> base;
+        std::vector<Entry> recent;
+
+        size_t size() const { return base->entries.size() + recent.size(); }
+
+        Cursor seek(uint64_t k) const {
+            const auto& e = base->entries;
+            Cursor c(e.data(), e.data() + e.size(),
+                     recent.data(), recent.data() + recent.size());
+            c.seek(k);
+            return c;
+        }
 
-    /// Ensure node and all its ancestors exist.  Returns pointer to the node.
-    ChunkData* ensureNode(const ChunkCoord& coord) {
-        if (coord.depth < 0 || coord.depth > CHUNK_MAX_DEPTH) return nullptr;
+        ChunkData* find(uint64_t k) const {
+            if (ChunkData* cd = base->find(k)) return cd;
+            auto it = std::lower_bound(recent.begin(), recent.end(), k);
+            return (it != recent.end() && it->key == k) ? it->node : nullptr;
+        }
 
-        // Ensure ancestors first (non-recursive, bottom-up collection)
-        std::vector<ChunkCoord> toCreate;
-        ChunkCoord c = coord;
-        while (c.depth > 0) {
-            if (nodes_.find(c) != nodes_.end()) break;
-            toCreate.push_back(c);
-            c = c.parent();
+        bool isLeaf(uint64_t k) const {
+            Cursor c = seek(k + 1);
+            return c.done() || c.key() >= subtreeEnd(k);
         }
-        // Create from top (ancestor) to bottom
-        for (int i = static_cast<int>(toCreate.size()) - 1; i >= 0; --i) {
-            auto& cc = toCreate[i];
-            // Mark parent as non-leaf
-            ChunkCoord par = cc.parent();
-            auto pit = nodes_.find(par);
-            if (pit != nodes_.end()) pit->second.isLeaf = false;
-
-            ChunkData newData;
-            newData.coord = cc;
-            newData.isLeaf = true;
-            nodes_[cc] = std::move(newData);
+    };
+
+    /// Epoch-based read-side critical section.  Readers count themselves
+    /// in the slot of the current epoch's parity; a writer flips the epoch
+    /// after publishing and waits for the old parity to drain before it
+    /// frees the snapshot it replaced.  Readers never wait.
+    class ReadGuard {
+    public:
+        explicit ReadGuard(const QuadTree& tree) : tree_(tree) {
+            ++heldOnThread();
+            for (;;) {
+                uint64_t e = tree_.epoch_.load();
+                slot_ = static_cast<int>(e & 1);
+                tree_.readers_[slot_].count.fetch_add(1);
+                if (tree_.epoch_.load() == e) break;
+                tree_.readers_[slot_].count.fetch_sub(1);
+            }
         }
-
-        // Ensure the target node exists (may already exist)
-        auto it = nodes_.find(coord);
-        if (it == nodes_.end()) {
-            ChunkCoord par = coord.parent();
-            auto pit = nodes_.find(par);
-            if (pit != nodes_.end()) pit->second.isLeaf = false;
-
-            ChunkData newData;
-            newData.coord = coord;
-            newData.isLeaf = true;
-            nodes_[coord] = std::move(newData);
-            it = nodes_.find(coord);
+        ~ReadGuard() {
+            tree_.readers_[slot_].count.fetch_sub(1);
+            --heldOnThread();
+        }
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        const Snapshot* snapshot() const { return tree_.current_.load(); }
+        /// Guards open on the calling thread, across all trees.  publish()
+        /// asserts it is zero rather than hang waiting on its own slot.
+        static int& heldOnThread() {
+            static thread_local int held = 0;
+            return held;
         }
-        return &it->second;
+    private:
+        const QuadTree& tree_;
+        int slot_ = 0;
+    };
+
+    struct alignas(64) ReaderCount { std::atomic<int64_t> count{0}; };
+
+    mutable std::mutex writeMutex_;
+    std::deque<ChunkData> storage_; // stable addresses, append-only
+    std::atomic<const Snapshot*> current_{nullptr};
+    std::atomic<uint64_t> epoch_{0};
+    mutable ReaderCount readers_[2];
+
+    static uint64_t spreadBits(uint32_t v) {
+        uint64_t x = v;
+        x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+        x = (x | (x << 8))  & 0x00FF00FF00FF00FFull;
+        x = (x | (x << 4))  & 0x0F0F0F0F0F0F0F0Full;
+        x = (x | (x << 2))  & 0x3333333333333333ull;
+        x = (x | (x << 1))  & 0x5555555555555555ull;
+        return x;
     }
 
-    /// Recursive collection of leaves that overlap the viewport.
-    void collectLeaves(const ChunkCoord& coord,
-                       float lonMin, float lonMax,
-                       float latMin, float latMax,
-                       int maxDepth,
-                       std::vector<ChunkCoord>& out) {
-        auto it = nodes_.find(coord);
-        if (it == nodes_.end()) return;
+    static uint32_t compactBits(uint64_t x) {
+        x &= 0x5555555555555555ull;
+        x = (x | (x >> 1))  & 0x3333333333333333ull;
+        x = (x | (x >> 2))  & 0x0F0F0F0F0F0F0F0Full;
+        x = (x | (x >> 4))  & 0x00FF00FF00FF00FFull;
+        x = (x | (x >> 8))  & 0x0000FFFF0000FFFFull;
+        x = (x | (x >> 16)) & 0x00000000FFFFFFFFull;
+        return static_cast<uint32_t>(x);
+    }
+
+    /// Morton code of the node's corner cell at CHUNK_MAX_DEPTH
+    /// (x in the even bits, y in the odd bits).
+    static uint64_t cornerCode(const ChunkCoord& c) {
+        uint64_t code = spreadBits(static_cast<uint32_t>(c.x)) |
+                        (spreadBits(static_cast<uint32_t>(c.y)) << 1);
+        return code << (2 * (CHUNK_MAX_DEPTH - c.depth));
+    }
 
-        // Check if this node overlaps the viewport
+    static bool overlaps(const ChunkCoord& c, float lonMin, float lonMax,
+                         float latMin, float latMax) {
         float cLonMin, cLonMax, cLatMin, cLatMax;
-        coord.getBoundsRadians(cLonMin, cLonMax, cLatMin, cLatMax);
-        if (cLonMax <= lonMin || cLonMin >= lonMax ||
-            cLatMax <= latMin || cLatMin >= latMax)
-            return; // no overlap
+        c.getBoundsRadians(cLonMin, cLonMax, cLatMin, cLatMax);
+        return !(cLonMax <= lonMin || cLonMin >= lonMax ||
+                 cLatMax <= latMin || cLatMin >= latMax);
+    }
+
+    /// Index range of the cells at `depth` overlapping the bounding box.
+    static void cellRange(float lonMin, float lonMax, float latMin, float latMax,
+                          int depth, int& xMin, int& xMax, int& yMin, int& yMax) {
+        int cells = 1 << depth;
+        float lonRange = static_cast<float>(2.0 * M_PI);
+        float latRange = static_cast<float>(M_PI);
+        float cellW = lonRange / cells;
+        float cellH = latRange / cells;
+
+        // Determine index range that overlaps the bounding box
+        xMin = static_cast<int>(std::floor((lonMin + static_cast<float>(M_PI)) / cellW));
+        xMax = static_cast<int>(std::floor((lonMax + static_cast<float>(M_PI)) / cellW));
+        yMin = static_cast<int>(std::floor((latMin + static_cast<float>(M_PI / 2.0)) / cellH));
+        yMax = static_cast<int>(std::floor((latMax + static_cast<float>(M_PI / 2.0)) / cellH));
+
+        xMin = std::clamp(xMin, 0, cells - 1);
+        xMax = std::clamp(xMax, 0, cells - 1);
+        yMin = std::clamp(yMin, 0, cells - 1);
+        yMax = std::clamp(yMax, 0, cells - 1);
+    }
+
+    /// Leaf scan behind getLeavesInBounds(): the bounds are covered by a
+    /// handful of query cells and each cell's subtree is scanned as one
+    /// contiguous key range, skipping whole subtrees outside the bounds.
+    static std::vector<Entry> collectLeaves(const Snapshot* snap,
+                                            float lonMin, float lonMax,
+                                            float latMin, float latMax,
+                                            int maxDepth) {
+        if (maxDepth > CHUNK_MAX_DEPTH) maxDepth = CHUNK_MAX_DEPTH;
+
+        // Pick the deepest query depth that still keeps the cell count small
+        int limit = (maxDepth >= 0) ? maxDepth : CHUNK_MAX_DEPTH;
+        int qd = 0;
+        while (qd < limit) {
+            int xMin, xMax, yMin, yMax;
+            cellRange(lonMin, lonMax, latMin, latMax, qd + 1, xMin, xMax, yMin, yMax);
+            if (static_cast<int64_t>(xMax - xMin + 1) * (yMax - yMin + 1) > kMaxQueryCells) break;
+            ++qd;
+        }
+
+        int xMin, xMax, yMin, yMax;
+        cellRange(lonMin, lonMax, latMin, latMax, qd, xMin, xMax, yMin, yMax);
+        std::vector<uint64_t> cells;
+        for (int cy = yMin; cy <= yMax; ++cy)
+            for (int cx = xMin; cx <= xMax; ++cx)
+                if (overlaps({cx, cy, qd}, lonMin, lonMax, latMin, latMax))
+                    cells.push_back(mortonKey({cx, cy, qd}));
+        // Visiting the cells in key order keeps the output sorted
+        std::sort(cells.begin(), cells.end());
+
+        std::vector<Entry> keys;
+        bool unordered = false;
+        for (uint64_t qk : cells) {
+            if (!snap->find(qk)) {
+                // Cell not populated: the recursion would stop at the
+                // deepest existing ancestor, which only counts if it is
+                // itself a leaf (or already at maxDepth).
+                uint64_t a = qk;
+                do { a = parentKey(a); } while ((a & kDepthMask) > 0 && !snap->find(a));
+                int ad = static_cast<int>(a & kDepthMask);
+                if ((maxDepth >= 0 && ad >= maxDepth) || snap->isLeaf(a)) {
+                    keys.push_back({a, snap->find(a)});
+                    unordered = true;
+                }
+                continue;
+            }
+
+            // Descendants of a cell strictly inside the bounds need no test
+            float cLonMin, cLonMax, cLatMin, cLatMax;
+            coordFromKey(qk).getBoundsRadians(cLonMin, cLonMax, cLatMin, cLatMax);
+            bool inside = cLonMin > lonMin && cLonMax < lonMax &&
+                          cLatMin > latMin && cLatMax < latMax;
+
+            uint64_t end = subtreeEnd(qk);
+            Cursor cur = snap->seek(qk);
+            while (!cur.done() && cur.key() < end) {
+                uint64_t k = cur.key();
+                ChunkData* node = cur.node();
+                if (!inside && !overlaps(coordFromKey(k), lonMin, lonMax, latMin, latMax)) {
+                    cur.seek(subtreeEnd(k));
+                    continue;
+                }
+                if (maxDepth >= 0 && static_cast<int>(k & kDepthMask) >= maxDepth) {
+                    keys.push_back({k, node});
+                    cur.next();
+                    cur.seek(subtreeEnd(k));
+                    continue;
+                }
+                cur.next();
+                if (cur.done() || cur.key() >= subtreeEnd(k))
+                    keys.push_back({k, node}); // leaf
+            }
+        }
+
+        // Key order is the depth-first child order of the old recursion
+        if (unordered) {
+            std::sort(keys.begin(), keys.end(),
+                      [](const Entry& x, const Entry& y) { return x.key < y.key; });
+            keys.erase(std::unique(keys.begin(), keys.end(),
+                                   [](const Entry& x, const Entry& y) { return x.key == y.key; }),
+                       keys.end());
+        }
+        return keys;
+    }
+
+    /// Insert the given nodes and all missing ancestors, then publish one
+    /// new snapshot.  Caller holds writeMutex_.
+    void insertLocked(const std::vector<ChunkCoord>& coords) {
+        const Snapshot* snap = current_.load(); // writer: stable until publish()
+
+        std::vector<Entry> batch;
+        std::unordered_map<uint64_t, ChunkData*> batchNodes;
+        batchNodes.reserve(coords.size() * 2);
+        auto lookup = [&](uint64_t k) -> ChunkData* {
+            if (ChunkData* cd = snap->find(k)) return cd;
+            auto it = batchNodes.find(k);
+            return (it != batchNodes.end()) ? it->second : nullptr;
+        };
 
-        bool atMaxDepth = (maxDepth >= 0 && coord.depth >= maxDepth);
+        for (const auto& coord : coords) {
+            if (coord.depth < 0 || coord.depth > CHUNK_MAX_DEPTH) continue;
 
-        if (it->second.isLeaf || atMaxDepth) {
-            out.push_back(coord);
-            return;
+            // Ensure ancestors first (collect bottom-up, create top-down)
+            std::vector<uint64_t> toCreate;
+            uint64_t k = mortonKey(coord);
+            while (!lookup(k)) {
+                toCreate.push_back(k);
+                if ((k & kDepthMask) == 0) break;
+                k = parentKey(k);
+            }
+            for (int i = static_cast<int>(toCreate.size()) - 1; i >= 0; --i) {
+                uint64_t ck = toCreate[i];
+                if ((ck & kDepthMask) > 0) {
+                    // Mark parent as non-leaf
+                    if (ChunkData* par = lookup(parentKey(ck))) par->isLeaf = false;
+                }
+                ChunkData& newData = storage_.emplace_back();
+                newData.coord = coordFromKey(ck);
+                newData.isLeaf = true;
+                batch.push_back({ck, &newData});
+                batchNodes.emplace(ck, &newData);
+            }
         }
+        if (batch.empty()) return;
+
+        auto byKey = [](const Entry& a, const Entry& b) { return a.key < b.key; };
+        std::sort(batch.begin(), batch.end(), byKey);
+
+        auto next = new Snapshot;
+        next->recent.reserve(snap->recent.size() + batch.size());
+        std::merge(snap->recent.begin(), snap->recent.end(), batch.begin(), batch.end(),
+                   std::back_inserter(next->recent), byKey);
+
+        if (next->recent.size() > std::max(kRecentMin, snap->base->entries.size() / kRecentRatio)) {
+            std::vector<Entry> merged;
+            merged.reserve(snap->base->entries.size() + next->recent.size());
+            std::merge(snap->base->entries.begin(), snap->base->entries.end(),
+                       next->recent.begin(), next->recent.end(),
+                       std::back_inserter(merged), byKey);
+            next->base = buildBase(std::move(merged));
+            next->recent.clear();
+        } else {
+            next->base = snap->base;
+        }
+        publish(next);
+    }
+
+    /// Swap in a new snapshot and free the old one after a grace period.
+    /// Caller holds writeMutex_ and no ReadGuard.
+    void publish(const Snapshot* next) {
+        assert(ReadGuard::heldOnThread() == 0 && "QuadTree written from inside a read-side section");
+        const Snapshot* old = current_.exchange(next);
+        uint64_t e = epoch_.fetch_add(1);
+        auto& drained = readers_[e & 1].count;
+        while (drained.load() != 0) std::this_thread::yield();
+        delete old;
+    }
 
-        // Recurse into children
-        auto kids = coord.children();
-        for (auto& kid : kids) {
-            collectLeaves(kid, lonMin, lonMax, latMin, latMax, maxDepth, out);
+    static std::shared_ptr<const Base> buildBase(std::vector<Entry> entries) {
+        auto base = std::make_shared<Base>();
+        size_t cap = 16;
+        while (cap < entries.size() * 2) cap <<= 1;
+        base->slots.assign(cap, 0);
+        base->mask = cap - 1;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            uint64_t h = Base::hash(entries[i].key) & base->mask;
+            while (base->slots[h] != 0) h = (h + 1) & base->mask;
+            base->slots[h] = static_cast<uint32_t>(i + 1);
         }
+        base->entries = std::move(entries);
+        return base;
     }
 };
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/// Per-tree timings for one depth of the QuadTree microbenchmark.
+struct QuadTreeBenchTimings {
+    double ensureUs = 0.0;        // ensureDepth() per panned frame
+    double queryUs = 0.0;         // getLeavesInBounds() per frame
+    double lookupNs = 0.0;        // get() per visible leaf
+    double contendedP99Us = 0.0;  // getLeavesInBounds() p99 while a writer inserts
+};
+
+struct QuadTreeBenchResult {
+    int depth = 0;
+    size_t nodes = 0;             // nodes in the tree after the pan
+    QuadTreeBenchTimings legacy;  // flat unordered_map + single mutex
+    QuadTreeBenchTimings linear;  // Morton-keyed snapshot tree (QuadTree)
+};
+
+/// Pan a 1024px viewport across the world at each depth in
+/// [minDepth, maxDepth] and time the frame-loop tree operations on the
+/// current QuadTree and on the previous hash-map implementation.
+std::vector<QuadTreeBenchResult> runQuadTreeBenchmark(int minDepth = 10, int maxDepth = 20,
+                                                      int frames = 64);
+
+/// Print a result table through PLOG.
+void logQuadTreeBenchmark(const std::vector<QuadTreeBenchResult>& results);
@@ -0,0 +1,74 @@
+#pragma once
+#include <WorldMaps/World/NoiseBackend.hpp>
+#include <CL/cl.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/// Chunk region a set of noise fields was evaluated over (radians, samples).
+struct RegionNoiseKey {
+    float lonMin = 0.0f, lonMax = 0.0f, latMin = 0.0f, latMax = 0.0f;
+    int resX = 0, resY = 0;
+
+    bool operator==(const RegionNoiseKey& o) const {
+        return lonMin == o.lonMin && lonMax == o.lonMax && latMin == o.latMin &&
+               latMax == o.latMax && resX == o.resX && resY == o.resY;
+    }
+};
+
+struct RegionNoiseKeyHash {
+    size_t operator()(const RegionNoiseKey& k) const;
+};
+
+/// Noise fields of recently generated chunk regions, kept on the device.
+///
+/// Layers ask for the fields they need over a chunk; on a miss the cache
+/// evaluates them together with every field the world's layers declare
+/// (MapLayer::regionNoiseFields) in one fused perlinRegionFields dispatch.
+/// Dependent layers (Humidity reading elevation, temperature and land
+/// types; Color reading all of them) then find their fields already there
+/// instead of launching their own noise kernels.
+class RegionNoiseCache
+{
+public:
+    /// Returns the fields to evaluate alongside a miss.
+    using FieldProvider = std::function<std::vector<NoiseField>()>;
+
+    explicit RegionNoiseCache(size_t maxRegions = 256) : maxRegions_(maxRegions) {}
+    ~RegionNoiseCache();
+    RegionNoiseCache(const RegionNoiseCache&) = delete;
+    RegionNoiseCache& operator=(const RegionNoiseCache&) = delete;
+
+    /// New caller-owned buffer holding `fields` as planes, in order.
+    cl_mem acquire(const RegionNoiseKey& key, const std::vector<NoiseField>& fields,
+                   const FieldProvider& declared);
+
+    /// Read `fields` back to the host as planes, in order.
+    bool read(const RegionNoiseKey& key, const std::vector<NoiseField>& fields,
+              const FieldProvider& declared, std::vector<float>& out);
+
+    void clear();
+    void setMaxRegions(size_t maxRegions);
+    size_t size() const;
+
+private:
+    struct Entry {
+        std::vector<NoiseField> fields;   // plane order of `buffer`
+        cl_mem buffer = nullptr;
+        uint64_t lastUse = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<RegionNoiseKey, Entry, RegionNoiseKeyHash> entries_;
+    size_t maxRegions_;
+    uint64_t useCounter_ = 0;
+
+    /// Entry containing every field, generating it on a miss; fills
+    /// `planes` with each field's plane index.  Call with mutex_ held.
+    Entry* ensure(const RegionNoiseKey& key, const std::vector<NoiseField>& fields,
+                  const FieldProvider& declared, std::vector<size_t>& planes);
+    void evict();
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include <WorldMaps/World/World.hpp>
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/// Output encoding of exported tiles.
+enum class TileFormat {
+    PNG,      // 8-bit RGBA from the layer's color ramp
+    Float32   // raw little-endian float samples, tileSize² values
+};
+
+struct TileExportOptions {
+    std::filesystem::path outputDir;
+    std::vector<std::string> layers;    // empty = every layer in the world
+    int minZoom = 0;
+    int maxZoom = 4;
+    float lonMinDeg = -180.0f;          // export bounds; tiles touching them are included
+    float lonMaxDeg = 180.0f;
+    float latMinDeg = -85.0511f;
+    float latMaxDeg = 85.0511f;
+    int tileSize = 256;
+    TileFormat format = TileFormat::PNG;
+    unsigned workers = 0;               // encode/write threads, 0 = hardware threads − 1
+    int blockTiles = 4;                 // tiles per axis generated by one region request
+    bool overwrite = false;             // rewrite tiles that already exist
+    size_t maxCachedChunks = 4096;      // chunk GPU caches kept between blocks
+    std::string configTag;              // recorded in the manifest to detect mismatched resumes
+};
+
+struct TileExportStats {
+    size_t planned = 0;
+    size_t written = 0;
+    size_t skipped = 0;                 // already present from an earlier run
+    size_t failed = 0;
+    double seconds = 0.0;
+    double tilesPerSec() const { return seconds > 0.0 ? static_cast<double>(written) / seconds : 0.0; }
+};
+
+/// Bakes world layers into a standard XYZ (Web Mercator, y = 0 at the
+/// north edge) tile pyramid: <outputDir>/<layer>/<z>/<x>/<y>.png|.f32.
+///
+/// The calling thread drives generation through World::getColorForRegion /
+/// getSampleForRegion, one block of tiles per request, and reads the
+/// assembled region back.  A worker pool resamples each tile into Mercator
+/// and encodes and writes it.  Tiles are written to a temporary name and
+/// renamed, so a file on disk is always complete; an interrupted export
+/// resumes by skipping existing tiles.  A manifest.json records the job
+/// and its progress.
+class TileExporter
+{
+public:
+    TileExporter(World& world, TileExportOptions options);
+
+    /// Run the export.  `cancel` is polled between blocks.
+    TileExportStats run(const std::atomic<bool>* cancel = nullptr);
+
+    /// Advance incremental layers (e.g. tectonics) until they report
+    /// completion, so exported tiles show the finished simulation.
+    static void settleLayers(World& world, int maxTicks = 100000);
+
+    /// XYZ tile helpers (Web Mercator, y = 0 at the north edge).
+    static int lonToTileX(float lonDeg, int zoom);
+    static int latToTileY(float latDeg, int zoom);
+    static float tileXToLon(int x, int zoom);
+    static float tileYToLat(int y, int zoom);
+
+private:
+    World& world_;
+    TileExportOptions opts_;
+
+    bool checkManifest() const;
+    void writeManifest(const TileExportStats& stats, bool complete) const;
+};
@@ -12,15 +12,36 @@
 #include <WorldMaps/Map/LatitudeLayer.hpp>
 #include <WorldMaps/Map/TectonicsLayer.hpp>
 #include <WorldMaps/Map/BuildingLayer.hpp>
+#include <WorldMaps/Map/CityLayer.hpp>
+#include <WorldMaps/Map/PoliticalLayer.hpp>
 #include <WorldMaps/World/QuadTree.hpp>
 #include <WorldMaps/World/ChunkAssembler.hpp>
+#include <WorldMaps/World/ChunkLOD.hpp>
 #include <WorldMaps/World/LayerDelta.hpp>
+#include <WorldMaps/World/RegionNoiseCache.hpp>
 #include <memory>
 #include <stack>
+#include <chrono>
 #include <stringUtils.hpp>
 
 class Vault;
 
+/// Optional timing of World's region pipeline, filled in by
+/// getColorForRegion / getSampleForRegion while attached with
+/// World::setPipelineStats().  Used by the world benchmark.
+struct RegionPipelineStats {
+    bool synchronous = true;        // clFinish after each stage so times include device work
+    std::vector<double> chunkUs;    // one entry per generated chunk
+    double selectUs = 0.0;          // ensureDepth + leaf query
+    double generateUs = 0.0;        // all chunk generation
+    double assembleUs = 0.0;        // ChunkAssembler
+    size_t calls = 0;
+    size_t chunksVisited = 0;
+    size_t chunksGenerated = 0;
+    size_t chunksUpsampled = 0;     // provisional parent crops shown
+    size_t chunksDownsampled = 0;   // parents built from cached children
+};
+
 class World
 {
 public:
@@ -30,7 +51,7 @@ public:
         parseConfig(config);
     }
     
-    virtual ~World() = default;
+    virtual ~World() { releaseAssemblyEvent(); }
 
     // ── Full-world API (existing, backward-compatible) ───────────
     cl_mem sample(const std::string &layerName = "") const
@@ -149,57 +170,41 @@ public:
         outW = numChunksX * CHUNK_BASE_RES;
         outH = numChunksY * CHUNK_BASE_RES;
 
+        PipelineTimer timer(pipelineStats_);
         quadTree_.ensureDepth(lonMinRad, lonMaxRad, latMinRad, latMaxRad, depth);
 
         // Get all leaf chunks in the visible region
-        auto leaves = quadTree_.getLeavesInBounds(
+        auto leaves = quadTree_.getLeafNodesInBounds(
             lonMinRad, lonMaxRad, latMinRad, latMaxRad, depth);
+        timer.lap(&RegionPipelineStats::selectUs);
 
         // Generate color data for each chunk that needs it
         std::vector<ChunkAssembler::ChunkEntry> entries;
         entries.reserve(leaves.size());
 
-        for (auto& coord : leaves) {
-            ChunkData* cd = quadTree_.getOrCreate(coord);
-            if (!cd) continue;
-
-            auto& cache = cd->layerCaches[layerName];
-            cache.touch();
-
-            // Generate if dirty or not yet generated
-            if (cache.dirty || !cache.colorBuffer) {
-                float cLonMin, cLonMax, cLatMin, cLatMax;
-                coord.getBoundsRadians(cLonMin, cLonMax, cLatMin, cLatMax);
-
-                // Get delta for this chunk+layer if it exists
-                const LayerDelta* delta = nullptr;
-                auto dit = cd->layerDeltas.find(layerName);
-                if (dit != cd->layerDeltas.end() && dit->second.hasEdits()) {
-                    delta = &dit->second;
-                }
-
-                cache.colorBuffer = layer->getColorRegion(
-                    cLonMin, cLonMax, cLatMin, cLatMax,
-                    CHUNK_BASE_RES, CHUNK_BASE_RES, delta);
-                cache.generatedResX = CHUNK_BASE_RES;
-                cache.generatedResY = CHUNK_BASE_RES;
-                cache.dirty = false;
-            }
-
+        int budget = lodOptions_.refineBudget;
+        for (ChunkData* cd : leaves) {
+            const ChunkLayerCache& cache = resolveChunk(layer, layerName, cd, true, budget);
             entries.push_back({
-                coord,
+                cd->coord,
                 cache.colorBuffer,
                 cache.generatedResX,
-                cache.generatedResY
+                cache.generatedResY,
+                cache.generation
             });
         }
 
+        timer.lap(&RegionPipelineStats::generateUs, leaves.size());
+
         // Assemble chunks into viewport buffer (bounds are now grid-snapped,
         // so each chunk maps to exactly CHUNK_BASE_RES pixels)
+        releaseAssemblyEvent();
         ChunkAssembler::assembleRGBA(
             entries, regionAssemblyBuffer_,
             outW, outH,
-            lonMinDeg, lonMaxDeg, latMinDeg, latMaxDeg);
+            lonMinDeg, lonMaxDeg, latMinDeg, latMaxDeg,
+            &assemblyDone_);
+        timer.lap(&RegionPipelineStats::assembleUs);
 
         return regionAssemblyBuffer_;
     }
@@ -254,51 +259,44 @@ public:
         outW = numChunksX * CHUNK_BASE_RES;
         outH = numChunksY * CHUNK_BASE_RES;
 
+        PipelineTimer timer(pipelineStats_);
         quadTree_.ensureDepth(lonMinRad, lonMaxRad, latMinRad, latMaxRad, depth);
-        auto leaves = quadTree_.getLeavesInBounds(
+        auto leaves = quadTree_.getLeafNodesInBounds(
             lonMinRad, lonMaxRad, latMinRad, latMaxRad, depth);
+        timer.lap(&RegionPipelineStats::selectUs);
 
         std::vector<ChunkAssembler::ChunkEntry> entries;
         entries.reserve(leaves.size());
 
-        for (auto& coord : leaves) {
-            ChunkData* cd = quadTree_.getOrCreate(coord);
-            if (!cd) continue;
-
-            auto& cache = cd->layerCaches[layerName];
-            cache.touch();
-
-            if (cache.dirty || !cache.sampleBuffer) {
-                float cLonMin, cLonMax, cLatMin, cLatMax;
-                coord.getBoundsRadians(cLonMin, cLonMax, cLatMin, cLatMax);
-
-                const LayerDelta* delta = nullptr;
-                auto dit = cd->layerDeltas.find(layerName);
-                if (dit != cd->layerDeltas.end() && dit->second.hasEdits())
-                    delta = &dit->second;
-
-                cache.sampleBuffer = layer->sampleRegion(
-                    cLonMin, cLonMax, cLatMin, cLatMax,
-                    CHUNK_BASE_RES, CHUNK_BASE_RES, delta);
-                cache.generatedResX = CHUNK_BASE_RES;
-                cache.generatedResY = CHUNK_BASE_RES;
-                cache.dirty = false;
-            }
-
+        int budget = lodOptions_.refineBudget;
+        for (ChunkData* cd : leaves) {
+            const ChunkLayerCache& cache = resolveChunk(layer, layerName, cd, false, budget);
             entries.push_back({
-                coord, cache.sampleBuffer,
-                cache.generatedResX, cache.generatedResY
+                cd->coord, cache.sampleBuffer,
+                cache.generatedResX, cache.generatedResY,
+                cache.generation
             });
         }
 
+        timer.lap(&RegionPipelineStats::generateUs, leaves.size());
+
+        releaseAssemblyEvent();
         ChunkAssembler::assembleScalar(
             entries, sampleAssemblyBuffer_,
             outW, outH,
-            lonMinDeg, lonMaxDeg, latMinDeg, latMaxDeg);
+            lonMinDeg, lonMaxDeg, latMinDeg, latMaxDeg,
+            &assemblyDone_);
+        timer.lap(&RegionPipelineStats::assembleUs);
 
         return sampleAssemblyBuffer_;
     }
 
+    /// Event that completes when the buffer returned by the last
+    /// getColorForRegion / getSampleForRegion call is fully assembled.
+    /// Kernels on the shared in-order queue need not wait on it; host
+    /// readers and other queues should.  May be null.
+    cl_event getAssemblyEvent() const { return assemblyDone_; }
+
     // ── Layer management ─────────────────────────────────────────
 
     void addLayer(const std::string &name, std::unique_ptr<MapLayer> layer)
@@ -349,10 +347,96 @@ public:
     LayerDelta& getOrCreateDelta(const ChunkCoord& coord, const std::string& layerName) {
         ChunkData* cd = quadTree_.getOrCreate(coord);
         auto& delta = cd->layerDeltas[layerName];
-        if (delta.data.empty()) delta.initGrid(CHUNK_BASE_RES, 1);
+        if (!delta.isInitialized()) delta.initGrid(CHUNK_BASE_RES, 1);
         return delta;
     }
 
+    /// Regenerate only the [x0, x0+w) × [y0, y0+h) texels (row 0 = north)
+    /// of a chunk's cached buffers for one layer, e.g. after a brush stamp.
+    /// Falls back to marking the whole chunk dirty when the layer cannot
+    /// generate sub-regions.  Returns false in that case.
+    bool refreshChunkRect(const ChunkCoord& coord, const std::string& layerName,
+                          int x0, int y0, int w, int h)
+    {
+        ZoneScopedN("World::refreshChunkRect");
+        ChunkData* cd = quadTree_.get(coord);
+        if (!cd) return true;
+        auto cit = cd->layerCaches.find(layerName);
+        if (cit == cd->layerCaches.end()) return true; // nothing cached yet
+        ChunkLayerCache& cache = cit->second;
+        if (cache.dirty || cache.provisionalColor || cache.provisionalSample)
+            return true;                                // full regeneration pending anyway
+
+        MapLayer* layer = getLayer(layerName);
+        if (!layer || !layer->supportsRegion() ||
+            cache.generatedResX != CHUNK_BASE_RES || cache.generatedResY != CHUNK_BASE_RES) {
+            cache.dirty = true;
+            return false;
+        }
+
+        // Region generation takes square deltas: grow the rect to a square
+        // that stays inside the chunk.
+        int side = std::clamp(std::max(w, h), 1, CHUNK_BASE_RES);
+        x0 = std::clamp(x0 - (side - w) / 2, 0, CHUNK_BASE_RES - side);
+        y0 = std::clamp(y0 - (side - h) / 2, 0, CHUNK_BASE_RES - side);
+
+        float cLonMin, cLonMax, cLatMin, cLatMax;
+        coord.getBoundsRadians(cLonMin, cLonMax, cLatMin, cLatMax);
+        float dLon = (cLonMax - cLonMin) / CHUNK_BASE_RES;
+        float dLat = (cLatMax - cLatMin) / CHUNK_BASE_RES;
+        float sLonMin = cLonMin + x0 * dLon;
+        float sLatMax = cLatMax - y0 * dLat;
+
+        LayerDelta sub;
+        const LayerDelta* subPtr = nullptr;
+        auto dit = cd->layerDeltas.find(layerName);
+        if (dit != cd->layerDeltas.end() && dit->second.hasEdits()) {
+            const LayerDelta& full = dit->second;
+            sub.mode = full.mode;
+            sub.paramOverrides = full.paramOverrides;
+            sub.initGrid(side, 1);
+            for (int y = 0; y < side; ++y)
+                for (int x = 0; x < side; ++x)
+                    sub.setDelta(x, y, 0, full.getDelta(x0 + x, y0 + y));
+            subPtr = &sub;
+        }
+
+        // Copy a freshly generated side×side patch into the cached buffer
+        auto patch = [&](cl_mem target, cl_mem fresh, size_t texelBytes) {
+            if (!fresh) return false;
+            size_t srcOrigin[3] = { 0, 0, 0 };
+            size_t dstOrigin[3] = { x0 * texelBytes, static_cast<size_t>(y0), 0 };
+            size_t region[3] = { side * texelBytes, static_cast<size_t>(side), 1 };
+            cl_int err = clEnqueueCopyBufferRect(OpenCLContext::get().getQueue(), fresh, target,
+                                                 srcOrigin, dstOrigin, region,
+                                                 side * texelBytes, 0,
+                                                 CHUNK_BASE_RES * texelBytes, 0,
+                                                 0, nullptr, nullptr);
+            OpenCLContext::get().releaseMem(fresh);
+            return err == CL_SUCCESS;
+        };
+
+        bool ok = true;
+        if (cache.colorBuffer)
+            ok &= patch(cache.colorBuffer,
+                        layer->getColorRegion(sLonMin, sLonMin + side * dLon,
+                                              sLatMax - side * dLat, sLatMax,
+                                              side, side, subPtr),
+                        sizeof(cl_float4));
+        if (cache.sampleBuffer)
+            ok &= patch(cache.sampleBuffer,
+                        layer->sampleRegion(sLonMin, sLonMin + side * dLon,
+                                            sLatMax - side * dLat, sLatMax,
+                                            side, side, subPtr),
+                        sizeof(float));
+        if (!ok) {
+            cache.dirty = true;
+            return false;
+        }
+        cache.generation = nextChunkGeneration(); // atlas slots re-copy this chunk
+        return true;
+    }
+
     /// Get delta (const, may return nullptr if not present).
     const LayerDelta* getDelta(const ChunkCoord& coord, const std::string& layerName) const {
         // Note: getOrCreate is non-const so we search directly
@@ -360,11 +444,53 @@ public:
         return nullptr; // simplified for now; editing code uses getOrCreateDelta
     }
 
+    /// Advance incremental layer generation by one frame.  Layers whose
+    /// output changed get their cached chunks marked dirty.  Call once per
+    /// frame before projecting.  Returns true if anything changed.
+    bool tick() {
+        ZoneScopedN("World::tick");
+        bool changed = false;
+        for (auto& [name, layer] : layers) {
+            if (!layer->tick()) continue;
+            changed = true;
+            const std::string& layerName = name;
+            quadTree_.forEachNode([&](ChunkData& data) { data.markDirty(layerName); });
+        }
+        return changed;
+    }
+
+    /// Attach (or detach with nullptr) timing of the region pipeline.
+    void setPipelineStats(RegionPipelineStats* stats) { pipelineStats_ = stats; }
+
+    /// Reuse of cached parents/children when the view changes depth.
+    void setLODOptions(const ChunkLODOptions& options) { lodOptions_ = options; }
+    const ChunkLODOptions& getLODOptions() const { return lodOptions_; }
+
     /// Evict least-recently-used chunk GPU caches.
     void evictChunkCaches(size_t maxCached = 512) {
         quadTree_.evictLRU(maxCached);
     }
 
+    // ── Shared region noise ──────────────────────────────────────
+
+    /// Perlin fields over a chunk region as a new caller-owned planar
+    /// buffer (plane i = fields[i]).  A region seen for the first time gets
+    /// every layer's regionNoiseFields() in one fused dispatch, so the
+    /// layers (and their dependents) asking next reuse them.
+    cl_mem regionNoise(float lonMinRad, float lonMaxRad, float latMinRad, float latMaxRad,
+                       int resX, int resY, const std::vector<NoiseField>& fields) {
+        return noiseCache_.acquire({lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY},
+                                   fields, [this] { return declaredNoiseFields(); });
+    }
+
+    /// Same as regionNoise(), read back to the host.
+    bool readRegionNoise(float lonMinRad, float lonMaxRad, float latMinRad, float latMaxRad,
+                         int resX, int resY, const std::vector<NoiseField>& fields,
+                         std::vector<float>& out) {
+        return noiseCache_.read({lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY},
+                                fields, [this] { return declaredNoiseFields(); }, out);
+    }
+
     /// Load all persisted layer deltas from the vault DB into the quadtree.
     /// Call this after parseConfig() when a vault is available.
     void loadDeltasFromVault();
@@ -396,7 +522,9 @@ public:
             }
             else if (layerName == "temperature")
             {
-                addLayer(layerName, std::make_unique<TemperatureLayer>());
+                auto layer = std::make_unique<TemperatureLayer>();
+                layer->parseParameters(layerParams);
+                addLayer(layerName, std::move(layer));
             }
             else if (layerName == "color")
             {
@@ -432,6 +560,18 @@ public:
                 layer->parseParameters(layerParams);
                 addLayer(layerName, std::move(layer));
             }
+            else if (layerName == "cities" || layerName == "city")
+            {
+                auto layer = std::make_unique<CityLayer>();
+                layer->parseParameters(layerParams);
+                addLayer("cities", std::move(layer));
+            }
+            else if (layerName == "political")
+            {
+                auto layer = std::make_unique<PoliticalLayer>();
+                layer->parseParameters(layerParams);
+                addLayer(layerName, std::move(layer));
+            }
         }     
     }
 
@@ -448,4 +588,165 @@ private:
     // Viewport assembly buffers (reused across frames)
     cl_mem regionAssemblyBuffer_ = nullptr;
     cl_mem sampleAssemblyBuffer_ = nullptr;
+    cl_event assemblyDone_ = nullptr;
+
+    RegionNoiseCache noiseCache_;
+
+    std::vector<NoiseField> declaredNoiseFields() const {
+        std::vector<NoiseField> fields;
+        for (const auto& [name, layer] : layers) {
+            std::vector<NoiseField> own = layer->regionNoiseFields();
+            fields.insert(fields.end(), own.begin(), own.end());
+        }
+        return fields;
+    }
+
+    RegionPipelineStats* pipelineStats_ = nullptr;
+    ChunkLODOptions lodOptions_;
+
+    /// Accumulates stage times into pipelineStats_ (no-op when detached).
+    struct PipelineTimer {
+        using Clock = std::chrono::steady_clock;
+        RegionPipelineStats* stats;
+        Clock::time_point t0;
+        explicit PipelineTimer(RegionPipelineStats* s) : stats(s) {
+            if (stats) { ++stats->calls; t0 = Clock::now(); }
+        }
+        void lap(double RegionPipelineStats::* stage, size_t visited = 0) {
+            if (!stats) return;
+            if (stats->synchronous) clFinish(OpenCLContext::get().getQueue());
+            Clock::time_point now = Clock::now();
+            stats->*stage += std::chrono::duration<double, std::micro>(now - t0).count();
+            stats->chunksVisited += visited;
+            t0 = now;
+        }
+    };
+
+    /// Records one chunk generation into pipelineStats_->chunkUs.
+    struct ChunkTimer {
+        RegionPipelineStats* stats;
+        PipelineTimer::Clock::time_point t0;
+        explicit ChunkTimer(RegionPipelineStats* s) : stats(s) {
+            if (stats) t0 = PipelineTimer::Clock::now();
+        }
+        ~ChunkTimer() {
+            if (!stats) return;
+            if (stats->synchronous) clFinish(OpenCLContext::get().getQueue());
+            stats->chunkUs.push_back(std::chrono::duration<double, std::micro>(
+                PipelineTimer::Clock::now() - t0).count());
+            ++stats->chunksGenerated;
+        }
+    };
+
+    // ── Chunk resolution ─────────────────────────────────────────
+
+    /// Bring one leaf's colour (rgba) or sample buffer for a layer up to
+    /// date.  In order of preference: keep a clean cache, build it from
+    /// four clean children, generate it, or — once `budget` generations
+    /// have been spent this call — show a crop of the parent and generate
+    /// on a later call.
+    const ChunkLayerCache& resolveChunk(MapLayer* layer, const std::string& layerName,
+                                        ChunkData* cd, bool rgba, int& budget)
+    {
+        const ChunkCoord& coord = cd->coord;
+        ChunkLayerCache& cache = cd->layerCaches[layerName];
+        cache.touch();
+        cl_mem& buffer = rgba ? cache.colorBuffer : cache.sampleBuffer;
+        bool& provisional = rgba ? cache.provisionalColor : cache.provisionalSample;
+
+        // Keep the parent resident while its children are on screen: it is
+        // what the next zoom-in crops from.
+        ChunkLayerCache* parent = nullptr;
+        if (lodOptions_.upsampleParents && coord.depth > 0) {
+            if (ChunkData* pd = quadTree_.get(coord.parent())) {
+                auto pit = pd->layerCaches.find(layerName);
+                if (pit != pd->layerCaches.end()) {
+                    parent = &pit->second;
+                    parent->touch();
+                }
+            }
+        }
+
+        if (!cache.dirty && buffer && !provisional) return cache;
+
+        const LayerDelta* delta = nullptr;
+        auto dit = cd->layerDeltas.find(layerName);
+        if (dit != cd->layerDeltas.end() && dit->second.hasEdits())
+            delta = &dit->second;
+
+        auto install = [&](cl_mem fresh, bool standIn) {
+            if (buffer) OpenCLContext::get().releaseMem(buffer);
+            buffer = fresh;
+            cache.generatedResX = CHUNK_BASE_RES;
+            cache.generatedResY = CHUNK_BASE_RES;
+            cache.generation = nextChunkGeneration();
+            provisional = standIn;
+            if (!standIn) cache.dirty = false;
+        };
+
+        // Zooming out: the children already hold this chunk's texels
+        if (!delta && lodOptions_.downsampleChildren) {
+            if (cl_mem built = downsampleFromChildren(cd, layerName, rgba)) {
+                install(built, false);
+                if (pipelineStats_) ++pipelineStats_->chunksDownsampled;
+                return cache;
+            }
+        }
+
+        // Zooming in past the budget: keep (or start) showing the parent
+        if (budget <= 0 && lodOptions_.upsampleParents) {
+            if (provisional && buffer) return cache;
+            const cl_mem parentBuffer = parent ? (rgba ? parent->colorBuffer : parent->sampleBuffer) : nullptr;
+            if (parentBuffer && !parent->dirty) {
+                if (cl_mem crop = ChunkLOD::upsampleQuadrant(parentBuffer, parent->generatedResX,
+                                                             parent->generatedResY, coord,
+                                                             CHUNK_BASE_RES, CHUNK_BASE_RES, rgba)) {
+                    install(crop, true);
+                    if (pipelineStats_) ++pipelineStats_->chunksUpsampled;
+                    return cache;
+                }
+            }
+        }
+
+        ChunkTimer chunkTimer(pipelineStats_);
+        float cLonMin, cLonMax, cLatMin, cLatMax;
+        coord.getBoundsRadians(cLonMin, cLonMax, cLatMin, cLatMax);
+        cl_mem fresh = rgba
+            ? layer->getColorRegion(cLonMin, cLonMax, cLatMin, cLatMax,
+                                    CHUNK_BASE_RES, CHUNK_BASE_RES, delta)
+            : layer->sampleRegion(cLonMin, cLonMax, cLatMin, cLatMax,
+                                  CHUNK_BASE_RES, CHUNK_BASE_RES, delta);
+        install(fresh, false);
+        --budget;
+        return cache;
+    }
+
+    /// Parent buffer box-filtered from its four children, or null unless
+    /// every child holds a clean, generated buffer of the same format.
+    cl_mem downsampleFromChildren(const ChunkData* cd, const std::string& layerName, bool rgba) const
+    {
+        if (cd->coord.depth >= CHUNK_MAX_DEPTH) return nullptr;
+        std::array<cl_mem, 4> buffers{};
+        std::array<ChunkCoord, 4> kids = cd->coord.children();
+        for (size_t i = 0; i < kids.size(); ++i) {
+            const ChunkData* child = quadTree_.get(kids[i]);
+            if (!child) return nullptr;
+            auto it = child->layerCaches.find(layerName);
+            if (it == child->layerCaches.end()) return nullptr;
+            const ChunkLayerCache& c = it->second;
+            buffers[i] = rgba ? c.colorBuffer : c.sampleBuffer;
+            bool provisional = rgba ? c.provisionalColor : c.provisionalSample;
+            if (!buffers[i] || c.dirty || provisional ||
+                c.generatedResX != CHUNK_BASE_RES || c.generatedResY != CHUNK_BASE_RES)
+                return nullptr;
+        }
+        return ChunkLOD::downsampleChildren(buffers, CHUNK_BASE_RES, CHUNK_BASE_RES, rgba);
+    }
+
+    void releaseAssemblyEvent() {
+        if (assemblyDone_) {
+            clReleaseEvent(assemblyDone_);
+            assemblyDone_ = nullptr;
+        }
+    }
 };
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// A world config the benchmark generates, with fixed seeds so runs on
+/// different commits produce the same terrain.
+struct WorldBenchConfig {
+    std::string name;
+    std::string config;             // World::parseConfig string
+    std::string displayLayer;       // layer passed to the projection
+};
+
+/// A camera move replayed frame by frame: linear in lon/lat, geometric in
+/// zoom, like dragging and wheel-zooming the map in WorldMap.
+struct WorldBenchScript {
+    enum class View { Mercator, Globe };
+    std::string name;
+    View view = View::Mercator;
+    int frames = 120;
+    float lon0 = 0.0f, lat0 = 0.0f, zoom0 = 1.0f;   // degrees / projection zoom level
+    float lon1 = 0.0f, lat1 = 0.0f, zoom1 = 1.0f;
+};
+
+struct WorldBenchOptions {
+    int width = 1024;               // projected texture size
+    int height = 768;
+    int frames = 0;                 // > 0 overrides every script's frame count
+    bool useGL = true;              // project() + texture upload; false = Mercator buffer only
+    bool synchronous = true;        // clFinish between pipeline stages
+    std::string layerOverride;      // projects this layer instead of displayLayer
+};
+
+struct WorldBenchResult {
+    std::string config;
+    std::string script;
+    bool skipped = false;           // globe script without GL
+    int frames = 0;
+    double frameP50Ms = 0.0;
+    double frameP99Ms = 0.0;
+    double chunkP50Us = 0.0;        // per generated chunk, all layers
+    double chunkP99Us = 0.0;
+    size_t chunksGenerated = 0;
+    size_t chunksUpsampled = 0;     // provisional parent crops
+    size_t chunksDownsampled = 0;   // parents built from children
+    size_t regionCalls = 0;
+    double selectMs = 0.0;          // QuadTree leaf selection
+    double generateMs = 0.0;        // layer chunk generation
+    double assembleMs = 0.0;        // ChunkAssembler
+    uint64_t buffersCreated = 0;
+    uint64_t bytesCreated = 0;
+    uint64_t bytesReadBack = 0;
+    uint64_t kernelLaunches = 0;
+    double kernelMs = 0.0;          // 0 unless kernel profiling is enabled
+    std::vector<std::pair<std::string, double>> topKernels;   // name, ms; descending
+};
+
+/// Canonical configs: elevation only, full climate, and climate plus
+/// rivers, tectonics and buildings.
+std::vector<WorldBenchConfig> defaultWorldBenchConfigs();
+
+/// Canonical camera scripts: Mercator pan, zoom-in, zoom-out and
+/// zoom-while-panning, and a globe spin.
+std::vector<WorldBenchScript> defaultWorldBenchScripts();
+
+/// Run every script against a fresh World built from every config and
+/// measure the same tick + project path WorldMap drives each frame.
+/// Requires an initialized OpenCLContext (and a current GL context when
+/// options.useGL is set).
+std::vector<WorldBenchResult> runWorldBenchmark(const std::vector<WorldBenchConfig>& configs,
+                                                const std::vector<WorldBenchScript>& scripts,
+                                                const WorldBenchOptions& options);
+
+/// Print a result table through PLOG.
+void logWorldBenchmark(const std::vector<WorldBenchResult>& results);
+
+/// JSON report (device, backend and per-run results) for comparing commits.
+std::string worldBenchmarkJson(const std::vector<WorldBenchResult>& results,
+                               const WorldBenchOptions& options, const std::string& tag = "");
+
+/// Compare against a report written by worldBenchmarkJson.  Logs every run
+/// whose frame or chunk p99 grew by more than thresholdPct and returns the
+/// number of regressions, or -1 if the baseline cannot be read.
+int compareWorldBenchmark(const std::vector<WorldBenchResult>& results,
+                          const std::string& baselineJson, double thresholdPct);
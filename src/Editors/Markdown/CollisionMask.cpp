@@ -1,7 +1,8 @@
 #include <Editors/Markdown/CollisionMask.hpp>
 #include <plog/Log.h>
+#include <algorithm>
 #include <cmath>
-#include <random>
+#include <cstring>
 
 namespace Markdown {
 
@@ -27,6 +28,9 @@ void CollisionMask::resize(int width, int height) {
     // Clean up CL resources first (they reference GL texture)
     destroyCLImage();
     
+    // In-flight readbacks are sized for the old mask
+    destroyReadbackBuffers();
+    
     // Clean up existing GL resources
     if (m_fbo) {
         glDeleteFramebuffers(1, &m_fbo);
@@ -39,11 +43,12 @@ void CollisionMask::resize(int width, int height) {
     
     m_width = width;
     m_height = height;
-    // Don't shrink_to_fit here - it causes heap corruption during rapid resize
-    // The buffer will be properly sized in readback()
+    // Don't shrink_to_fit here - it causes heap corruption during rapid resize.
+    // The old data no longer matches the size; pollReadback() refills it.
+    m_cpuBuffer.clear();
+    ++m_cpuGeneration;
     
     if (width <= 0 || height <= 0) {
-        m_cpuBuffer.clear();
         return;
     }
     
@@ -89,6 +94,7 @@ void CollisionMask::cleanup() {
     
     // Release CL resources first (they depend on GL)
     destroyCLImage();
+    destroyReadbackBuffers();
     
     if (m_fbo) {
         glDeleteFramebuffers(1, &m_fbo);
@@ -100,6 +106,9 @@ void CollisionMask::cleanup() {
     }
     
     m_cpuBuffer.clear();
+    ++m_cpuGeneration;
+    m_runs.clear();
+    m_rowRuns.clear();
     m_width = 0;
     m_height = 0;
 }
@@ -149,21 +158,103 @@ void CollisionMask::clear() {
     glBindFramebuffer(GL_FRAMEBUFFER, prevFBO);
 }
 
-void CollisionMask::readback() {
-    if (!m_texture || m_width <= 0 || m_height <= 0) {
-        m_cpuBuffer.clear();
-        return;
+void CollisionMask::destroyReadbackBuffers() {
+    for (auto& rb : m_readbacks) {
+        if (rb.fence) {
+            glDeleteSync(rb.fence);
+            rb.fence = nullptr;
+        }
+        if (rb.pbo) {
+            glDeleteBuffers(1, &rb.pbo);
+            rb.pbo = 0;
+        }
+        rb.serial = 0;
     }
-    
-    // Ensure proper buffer size
-    size_t requiredSize = static_cast<size_t>(m_width) * static_cast<size_t>(m_height);
-    if (m_cpuBuffer.size() != requiredSize) {
-        m_cpuBuffer.resize(requiredSize);
+}
+
+bool CollisionMask::requestReadback(float originY) {
+    if (!m_fbo || m_width <= 0 || m_height <= 0) return false;
+    
+    // All buffers in flight: the GPU is behind, skip rather than stall
+    Readback* slot = nullptr;
+    for (auto& rb : m_readbacks) {
+        if (rb.serial == 0) {
+            slot = &rb;
+            break;
+        }
+    }
+    if (!slot) return false;
+    
+    size_t bytes = static_cast<size_t>(m_width) * static_cast<size_t>(m_height);
+    if (!slot->pbo) {
+        glGenBuffers(1, &slot->pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_READ);
+    } else {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
     }
     
-    glBindTexture(GL_TEXTURE_2D, m_texture);
-    glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_UNSIGNED_BYTE, m_cpuBuffer.data());
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLint prevFBO, prevAlignment;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFBO);
+    glGetIntegerv(GL_PACK_ALIGNMENT, &prevAlignment);
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_width, m_height, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+    
+    glPixelStorei(GL_PACK_ALIGNMENT, prevAlignment);
+    glBindFramebuffer(GL_FRAMEBUFFER, prevFBO);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot->originY = originY;
+    slot->serial = ++m_readbackSerial;
+    return true;
+}
+
+bool CollisionMask::pollReadback() {
+    // Fences signal in submission order; take the newest finished copy
+    Readback* newest = nullptr;
+    for (auto& rb : m_readbacks) {
+        if (rb.serial == 0 || !rb.fence) continue;
+        GLenum status = glClientWaitSync(rb.fence, 0, 0);
+        if (status == GL_WAIT_FAILED) {
+            glDeleteSync(rb.fence);
+            rb.fence = nullptr;
+            rb.serial = 0;
+            continue;
+        }
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) continue;
+        if (!newest || rb.serial > newest->serial) newest = &rb;
+    }
+    if (!newest) return false;
+    
+    size_t bytes = static_cast<size_t>(m_width) * static_cast<size_t>(m_height);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, newest->pbo);
+    const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes), GL_MAP_READ_BIT);
+    bool adopted = false;
+    if (mapped) {
+        m_cpuBuffer.resize(bytes);
+        std::memcpy(m_cpuBuffer.data(), mapped, bytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        m_cpuOriginY = newest->originY;
+        ++m_cpuGeneration;
+        adopted = true;
+    } else {
+        PLOG_WARNING << "CollisionMask: failed to map readback buffer";
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    
+    // Older copies are superseded
+    const uint64_t serial = newest->serial;
+    for (auto& rb : m_readbacks) {
+        if (rb.serial == 0 || rb.serial > serial) continue;
+        glDeleteSync(rb.fence);
+        rb.fence = nullptr;
+        rb.serial = 0;
+    }
+    return adopted;
 }
 
 float CollisionMask::sample(float x, float y) const {
@@ -208,12 +299,38 @@ glm::vec2 CollisionMask::surfaceNormal(float x, float y) const {
     return glm::vec2(0, -1);  // Default up
 }
 
+void CollisionMask::ensureRuns(uint8_t thresh8) {
+    if (m_runsGeneration == m_cpuGeneration && m_runsThreshold == thresh8) return;
+    m_runsGeneration = m_cpuGeneration;
+    m_runsThreshold = thresh8;
+    
+    m_runs.clear();
+    m_rowRuns.clear();
+    size_t expectedSize = static_cast<size_t>(m_width) * static_cast<size_t>(m_height);
+    if (m_cpuBuffer.size() != expectedSize || expectedSize == 0) return;
+    
+    m_rowRuns.resize(static_cast<size_t>(m_height) + 1);
+    for (int y = 0; y < m_height; ++y) {
+        m_rowRuns[y] = static_cast<uint32_t>(m_runs.size());
+        const uint8_t* row = m_cpuBuffer.data() + static_cast<size_t>(y) * static_cast<size_t>(m_width);
+        int x = 0;
+        while (x < m_width) {
+            while (x < m_width && row[x] <= thresh8) ++x;
+            if (x >= m_width) break;
+            int start = x;
+            while (x < m_width && row[x] > thresh8) ++x;
+            m_runs.push_back({start, x});
+        }
+    }
+    m_rowRuns[m_height] = static_cast<uint32_t>(m_runs.size());
+}
+
 void CollisionMask::getEmissionPoints(const glm::vec2& min, const glm::vec2& max,
                                        float threshold, std::vector<glm::vec2>& outPoints,
                                        int maxPoints) {
     outPoints.clear();
     
-    if (m_cpuBuffer.empty() || m_width <= 0 || m_height <= 0) {
+    if (m_cpuBuffer.empty() || m_width <= 0 || m_height <= 0 || maxPoints <= 0) {
         return;
     }
     
@@ -227,29 +344,52 @@ void CollisionMask::getEmissionPoints(const glm::vec2& min, const glm::vec2& max
     int y0 = std::max(0, static_cast<int>(min.y));
     int x1 = std::min(m_width - 1, static_cast<int>(max.x));
     int y1 = std::min(m_height - 1, static_cast<int>(max.y));
+    if (x0 > x1 || y0 > y1) return;
     
-    // Collect candidate points where alpha > threshold
-    std::vector<glm::vec2> candidates;
     uint8_t thresh8 = static_cast<uint8_t>(threshold * 255);
-    
+    ensureRuns(thresh8);
+    if (m_rowRuns.empty()) return;
+    
+    // Solid runs inside the box, with cumulative texel counts
+    m_queryRuns.clear();
+    m_queryRows.clear();
+    m_queryCumulative.clear();
+    uint64_t total = 0;
     for (int y = y0; y <= y1; ++y) {
-        for (int x = x0; x <= x1; ++x) {
-            size_t index = static_cast<size_t>(y) * static_cast<size_t>(m_width) + static_cast<size_t>(x);
-            if (index < m_cpuBuffer.size() && m_cpuBuffer[index] > thresh8) {
-                candidates.push_back({static_cast<float>(x), static_cast<float>(y)});
-            }
+        auto first = m_runs.begin() + m_rowRuns[y];
+        auto last = m_runs.begin() + m_rowRuns[y + 1];
+        auto it = std::partition_point(first, last, [&](const Run& r) { return r.x1 <= x0; });
+        for (; it != last && it->x0 <= x1; ++it) {
+            int a = std::max(it->x0, x0);
+            int b = std::min(it->x1, x1 + 1);
+            if (a >= b) continue;
+            m_queryRuns.push_back({a, b});
+            m_queryRows.push_back(static_cast<uint32_t>(y));
+            total += static_cast<uint64_t>(b - a);
+            m_queryCumulative.push_back(total);
         }
     }
+    if (total == 0) return;
     
-    // If too many candidates, randomly sample
-    if (candidates.size() > static_cast<size_t>(maxPoints)) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::shuffle(candidates.begin(), candidates.end(), gen);
-        candidates.resize(maxPoints);
+    if (total <= static_cast<uint64_t>(maxPoints)) {
+        for (size_t i = 0; i < m_queryRuns.size(); ++i) {
+            for (int x = m_queryRuns[i].x0; x < m_queryRuns[i].x1; ++x)
+                outPoints.push_back({static_cast<float>(x), static_cast<float>(m_queryRows[i])});
+        }
+        return;
     }
     
-    outPoints = std::move(candidates);
+    // Uniform over solid texels: pick a texel index, find its run
+    std::uniform_int_distribution<uint64_t> pick(0, total - 1);
+    outPoints.reserve(static_cast<size_t>(maxPoints));
+    for (int k = 0; k < maxPoints; ++k) {
+        uint64_t r = pick(m_rng);
+        size_t i = static_cast<size_t>(std::upper_bound(m_queryCumulative.begin(), m_queryCumulative.end(), r) -
+                                       m_queryCumulative.begin());
+        uint64_t before = i > 0 ? m_queryCumulative[i - 1] : 0;
+        int x = m_queryRuns[i].x0 + static_cast<int>(r - before);
+        outPoints.push_back({static_cast<float>(x), static_cast<float>(m_queryRows[i])});
+    }
 }
 
 void CollisionMask::acquireForCL(cl_command_queue queue) {
@@ -0,0 +1,87 @@
+#include <Editors/Markdown/DocumentCache.hpp>
+#include <Util/CacheFile.hpp>
+#include <plog/Log.h>
+#include <algorithm>
+#include <vector>
+
+namespace Markdown {
+
+DocumentCache& DocumentCache::get() {
+    static DocumentCache instance;
+    return instance;
+}
+
+uint64_t DocumentCache::hashSource(std::string_view source) {
+    return CacheFile::fnv1a64(source);
+}
+
+std::shared_ptr<MarkdownDocument> DocumentCache::acquire(const std::string& source,
+                                                         const std::shared_ptr<MarkdownDocument>& previous) {
+    const uint64_t key = hashSource(source);
+    ++m_clock;
+
+    // Hits are confirmed byte-wise; a colliding entry is replaced below
+    auto it = m_entries.find(key);
+    if (it != m_entries.end() && it->second.document->getSource() == source) {
+        it->second.lastUse = m_clock;
+        ++m_stats.hits;
+        return it->second.document;
+    }
+    ++m_stats.misses;
+
+    // Reparse the caller's document in place when no other preview holds
+    // it: unchanged blocks keep their ids and their cached layout.  Its
+    // entry (the text before this edit) goes, so typing doesn't fill the
+    // cache with every intermediate version.
+    std::shared_ptr<MarkdownDocument> document;
+    if (previous) {
+        long holders = previous.use_count();
+        auto owned = std::find_if(m_entries.begin(), m_entries.end(),
+                                  [&](const auto& kv) { return kv.second.document == previous; });
+        if (owned != m_entries.end()) --holders;
+        if (holders == 1) {
+            document = previous;
+            if (owned != m_entries.end()) m_entries.erase(owned);
+        }
+    }
+    if (!document) document = std::make_shared<MarkdownDocument>();
+
+    document->markDirty();
+    document->parseString(source);
+    m_entries[key] = Entry{document, m_clock};
+
+    trim();
+    return document;
+}
+
+void DocumentCache::setCapacity(size_t capacity) {
+    m_capacity = capacity;
+    trim();
+}
+
+void DocumentCache::trim() {
+    // Only documents no preview holds count against the capacity
+    std::vector<std::unordered_map<uint64_t, Entry>::iterator> idle;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+        if (it->second.document.use_count() == 1) idle.push_back(it);
+    if (idle.size() <= m_capacity) return;
+
+    std::sort(idle.begin(), idle.end(),
+              [](const auto& a, const auto& b) { return a->second.lastUse < b->second.lastUse; });
+    const size_t excess = idle.size() - m_capacity;
+    for (size_t i = 0; i < excess; ++i) {
+        m_entries.erase(idle[i]);
+        ++m_stats.evictions;
+    }
+    PLOGV << "DocumentCache: evicted " << excess << " idle documents, " << m_entries.size() << " left";
+}
+
+DocumentCache::Stats DocumentCache::getStats() const {
+    Stats stats = m_stats;
+    stats.entries = m_entries.size();
+    stats.shared = static_cast<size_t>(std::count_if(m_entries.begin(), m_entries.end(),
+                                                     [](const auto& kv) { return kv.second.document.use_count() > 2; }));
+    return stats;
+}
+
+} // namespace Markdown
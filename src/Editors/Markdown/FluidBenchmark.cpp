@@ -0,0 +1,228 @@
+#include <Editors/Markdown/FluidBenchmark.hpp>
+#include <Editors/Markdown/FluidSolver.hpp>
+#include <Editors/Markdown/PreviewEffectSystem.hpp>
+#include <Editors/Markdown/Effects/WaterEffect.hpp>
+#include <Editors/Markdown/Effects/HoneyEffect.hpp>
+#include <OpenCLContext.hpp>
+#include <plog/Log.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace Markdown {
+
+namespace {
+
+using BenchClock = std::chrono::steady_clock;
+
+/// Two columns of fluid, water on the left and honey on the right, packed
+/// at half a smoothing radius and falling onto each other
+std::vector<Particle> damBreak(size_t count, uint32_t leftID, uint32_t rightID, float spacing) {
+    std::vector<Particle> particles(count);
+    const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    for (size_t i = 0; i < count; ++i) {
+        Particle& p = particles[i];
+        size_t col = i % columns;
+        size_t row = i / columns;
+        // A little jitter so rows don't settle into a perfect lattice
+        float jitter = static_cast<float>((i * 2654435761u) % 1000) / 1000.0f - 0.5f;
+        p.pos = glm::vec2(col * spacing + jitter * 0.1f * spacing, row * spacing);
+        p.vel = glm::vec2(0.0f, -20.0f);
+        p.z = 0.0f;
+        p.zVel = 0.0f;
+        p.life = 1000.0f;
+        p.maxLife = p.life;
+        p.color = glm::vec4(1.0f);
+        p.size = 2.0f;
+        p.meshID = 0;
+        p.rotation = glm::vec3(0.0f);
+        p.rotVel = glm::vec3(0.0f);
+        p.behaviorID = col < columns / 2 ? leftID : rightID;
+    }
+    return particles;
+}
+
+uint32_t hostCellHash(int cx, int cy, uint32_t tableSize) {
+    uint32_t h = static_cast<uint32_t>((cx * 92837111) ^ (cy * 689287499));
+    return h % tableSize;
+}
+
+/// The grid build the preview used before FluidSolver: read the
+/// particles back, count, prefix-sum and scatter on the host, upload.
+/// Kept only as the benchmark baseline and the reference for the device build.
+struct HostGrid {
+    std::vector<cl_uint2> cells;
+    std::vector<cl_uint> entries;
+
+    void build(const std::vector<Particle>& particles, const std::array<int, FluidSolver::MAX_BEHAVIORS>& isFluid,
+               float cellSize) {
+        const uint32_t tableSize = FluidSolver::GRID_TABLE_SIZE;
+        std::vector<uint32_t> counts(tableSize, 0);
+        auto cellOf = [&](const Particle& p) {
+            int cx = static_cast<int>(std::floor(p.pos.x / cellSize));
+            int cy = static_cast<int>(std::floor(p.pos.y / cellSize));
+            return hostCellHash(cx, cy, tableSize);
+        };
+        auto inGrid = [&](const Particle& p) {
+            return p.life > 0 && p.behaviorID < isFluid.size() && isFluid[p.behaviorID];
+        };
+        for (const Particle& p : particles)
+            if (inGrid(p)) counts[cellOf(p)]++;
+
+        cells.resize(tableSize);
+        uint32_t running = 0;
+        for (uint32_t c = 0; c < tableSize; ++c) {
+            cells[c] = {{running, counts[c]}};
+            running += counts[c];
+        }
+        entries.assign(std::max<uint32_t>(running, 1), 0);
+        std::vector<uint32_t> insert(tableSize, 0);
+        for (size_t i = 0; i < particles.size(); ++i) {
+            if (!inGrid(particles[i])) continue;
+            uint32_t ch = cellOf(particles[i]);
+            entries[cells[ch].s[0] + insert[ch]++] = static_cast<cl_uint>(i);
+        }
+    }
+};
+
+/// Same particles in every bucket (order within a bucket is not fixed on the device)
+bool sameGrid(const HostGrid& host, const std::vector<cl_uint2>& cells, const std::vector<cl_uint>& entries) {
+    for (size_t c = 0; c < host.cells.size(); ++c) {
+        cl_uint n = host.cells[c].s[1];
+        if (cells[c].s[1] != n) return false;
+        if (n == 0) continue;
+        std::vector<cl_uint> a(host.entries.begin() + host.cells[c].s[0],
+                               host.entries.begin() + host.cells[c].s[0] + n);
+        std::vector<cl_uint> b(entries.begin() + cells[c].s[0], entries.begin() + cells[c].s[0] + n);
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        if (a != b) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+std::vector<FluidBenchResult> runFluidBenchmark(const std::vector<size_t>& counts, int steps)
+{
+    std::vector<FluidBenchResult> results;
+    auto& cl = OpenCLContext::get();
+    if (!cl.isReady() || counts.empty()) {
+        PLOGW << "Fluid benchmark: OpenCL unavailable";
+        return results;
+    }
+    steps = std::max(steps, 1);
+
+    const WaterEffect water;
+    const HoneyEffect honey;
+    std::array<int, FluidSolver::MAX_BEHAVIORS> isFluid = {};
+    std::array<SPHParams, FluidSolver::MAX_BEHAVIORS> params = {};
+    isFluid[water.getBehaviorID()] = 1;
+    params[water.getBehaviorID()] = water.getSPHParams();
+    isFluid[honey.getBehaviorID()] = 1;
+    params[honey.getBehaviorID()] = honey.getSPHParams();
+
+    const size_t capacity = *std::max_element(counts.begin(), counts.end());
+    FluidSolver solver;
+    if (!solver.init(capacity)) {
+        PLOGE << "Fluid benchmark: FluidSolver failed to initialize";
+        return results;
+    }
+    solver.setBehaviors(isFluid, params);
+    const float cellSize = solver.getCellSize();
+
+    cl_int err = CL_SUCCESS;
+    cl_mem particleBuf = cl.createBuffer(CL_MEM_READ_WRITE, capacity * sizeof(Particle),
+                                         nullptr, &err, "Fluid benchmark particles");
+    cl_mem hostGridBuf = cl.createBuffer(CL_MEM_READ_WRITE, FluidSolver::GRID_TABLE_SIZE * sizeof(cl_uint2),
+                                         nullptr, &err, "Fluid benchmark host grid");
+    cl_mem hostEntriesBuf = cl.createBuffer(CL_MEM_READ_WRITE, capacity * sizeof(cl_uint),
+                                            nullptr, &err, "Fluid benchmark host entries");
+    if (!particleBuf || !hostGridBuf || !hostEntriesBuf) {
+        PLOGE << "Fluid benchmark: buffer allocation failed";
+        for (cl_mem m : {particleBuf, hostGridBuf, hostEntriesBuf})
+            if (m) cl.releaseMem(m);
+        return results;
+    }
+
+    cl_command_queue q = cl.getQueue();
+    const float dt = 1.0f / 60.0f;
+    for (size_t n : counts) {
+        FluidBenchResult r;
+        r.particles = n;
+        std::vector<Particle> scene = damBreak(n, water.getBehaviorID(), honey.getBehaviorID(), cellSize * 0.5f);
+        const uint32_t count = static_cast<uint32_t>(n);
+        auto reset = [&] {
+            clEnqueueWriteBuffer(q, particleBuf, CL_TRUE, 0, n * sizeof(Particle), scene.data(),
+                                 0, nullptr, nullptr);
+        };
+
+        // Host grid: blocking readback, build, upload, as the preview did every step
+        reset();
+        std::vector<Particle> readback(n);
+        HostGrid host;
+        auto t0 = BenchClock::now();
+        for (int s = 0; s < steps; ++s) {
+            clEnqueueReadBuffer(q, particleBuf, CL_TRUE, 0, n * sizeof(Particle), readback.data(),
+                                0, nullptr, nullptr);
+            host.build(readback, isFluid, cellSize);
+            clEnqueueWriteBuffer(q, hostGridBuf, CL_TRUE, 0, host.cells.size() * sizeof(cl_uint2),
+                                 host.cells.data(), 0, nullptr, nullptr);
+            clEnqueueWriteBuffer(q, hostEntriesBuf, CL_TRUE, 0, host.entries.size() * sizeof(cl_uint),
+                                 host.entries.data(), 0, nullptr, nullptr);
+        }
+        clFinish(q);
+        r.hostGridMs = std::chrono::duration<double, std::milli>(BenchClock::now() - t0).count() / steps;
+
+        // Device grid, checked against the host build of the same particles
+        solver.buildGrid(q, particleBuf, count);
+        clFinish(q);
+        t0 = BenchClock::now();
+        for (int s = 0; s < steps; ++s) solver.buildGrid(q, particleBuf, count);
+        clFinish(q);
+        r.deviceGridMs = std::chrono::duration<double, std::milli>(BenchClock::now() - t0).count() / steps;
+
+        std::vector<cl_uint2> cells(FluidSolver::GRID_TABLE_SIZE);
+        std::vector<cl_uint> entries(n);
+        clEnqueueReadBuffer(q, solver.getGridBuffer(), CL_TRUE, 0, cells.size() * sizeof(cl_uint2),
+                            cells.data(), 0, nullptr, nullptr);
+        clEnqueueReadBuffer(q, solver.getGridEntriesBuffer(), CL_TRUE, 0, entries.size() * sizeof(cl_uint),
+                            entries.data(), 0, nullptr, nullptr);
+        host.build(scene, isFluid, cellSize);
+        r.gridMatches = sameGrid(host, cells, entries);
+
+        // Full SPH step on the device (the dam breaks as it runs)
+        reset();
+        solver.step(q, particleBuf, count, dt, true);
+        clFinish(q);
+        t0 = BenchClock::now();
+        for (int s = 0; s < steps; ++s) solver.step(q, particleBuf, count, dt, true);
+        clFinish(q);
+        r.stepMs = std::chrono::duration<double, std::milli>(BenchClock::now() - t0).count() / steps;
+
+        results.push_back(r);
+    }
+
+    for (cl_mem m : {particleBuf, hostGridBuf, hostEntriesBuf}) cl.releaseMem(m);
+    return results;
+}
+
+bool logFluidBenchmark(const std::vector<FluidBenchResult>& results)
+{
+    bool allMatch = true;
+    PLOGI << "SPH fluid step (water/honey dam break, ms per step)";
+    PLOGI << "particles   host grid   device grid   device step   grid";
+    for (const auto& r : results) {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%9zu   %9.3f   %11.3f   %11.3f   %s",
+                      r.particles, r.hostGridMs, r.deviceGridMs, r.stepMs,
+                      r.gridMatches ? "ok" : "MISMATCH");
+        if (r.gridMatches) PLOGI << line; else PLOGE << line;
+        allMatch = allMatch && r.gridMatches;
+    }
+    return allMatch;
+}
+
+} // namespace Markdown
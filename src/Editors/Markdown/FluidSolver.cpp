@@ -0,0 +1,584 @@
+#include <Editors/Markdown/FluidSolver.hpp>
+#include <OpenCLContext.hpp>
+#include <LoreBook_Resources/LoreBook_ResourcesEmbeddedVFS.hpp>
+#include <plog/Log.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace Markdown {
+
+// ────────────────────────────────────────────────────────────────────
+// SPH Fluid Simulation kernel (OpenCL) — with spatial hash grid
+// ────────────────────────────────────────────────────────────────────
+
+static const char* s_sphKernelSource = R"(
+#include "common.cl"
+
+// Small struct to hold per-behavior SPH parameters
+typedef struct {
+    float smoothingRadius;
+    float restDensity;
+    float stiffness;
+    float viscosity;
+    float cohesion;
+    float particleMass;
+} SPHParams;
+
+// ═══════════════════════════════════════════════════════════════════
+// Spatial Hash Grid — O(N) neighbor lookup
+// ═══════════════════════════════════════════════════════════════════
+// Grid maps 2D space into cells of size = cellSize (the largest
+// smoothing radius in use, so a 3x3 search covers every behavior).
+// Each cell stores a range [start, start+count) into a sorted
+// particle entry array.  The grid is rebuilt on the device each step
+// by sphGridClear → sphGridCount → sphGridScan → sphGridScatter.
+
+// Grid cell: (start, count) packed as uint2
+// gridEntries[]: particle indices sorted by cell
+
+// Hash a 2D cell coordinate to a flat index with wrapping
+uint cellHash(int cx, int cy, uint tableSize) {
+    // Simple spatial hash (prime mixing)
+    uint h = (uint)((cx * 92837111) ^ (cy * 689287499));
+    return h % tableSize;
+}
+
+int2 cellOf(float2 pos, float cellSize) {
+    return (int2)((int)floor(pos.x / cellSize), (int)floor(pos.y / cellSize));
+}
+
+// ── Grid build 1: clear the per-cell histogram ──
+__kernel void sphGridClear(
+    __global uint* cellCounts,
+    const uint tableSize
+) {
+    uint c = get_global_id(0);
+    if (c < tableSize) cellCounts[c] = 0;
+}
+
+// ── Grid build 2: histogram; each fluid particle keeps its cell and
+//    its rank within the cell for the scatter ──
+__kernel void sphGridCount(
+    __global const Particle* particles,
+    __global uint* cellCounts,
+    __global uint* particleCell,       // cell hash, 0xFFFFFFFF = not in grid
+    __global uint* particleRank,
+    const uint count,
+    const uint tableSize,
+    const float cellSize,
+    __constant int* isFluid,
+    const uint maxBehaviors
+) {
+    uint i = get_global_id(0);
+    if (i >= count) return;
+
+    Particle p = particles[i];
+    if (p.life <= 0.0f || p.behaviorID >= maxBehaviors || !isFluid[p.behaviorID]) {
+        particleCell[i] = 0xFFFFFFFFu;
+        return;
+    }
+    int2 c = cellOf(p.pos, cellSize);
+    uint ch = cellHash(c.x, c.y, tableSize);
+    particleCell[i] = ch;
+    particleRank[i] = atomic_inc(&cellCounts[ch]);
+}
+
+// ── Grid build 3: exclusive prefix scan of the histogram into
+//    (start, count) cells.  Run as ONE work-group: each item scans a
+//    contiguous chunk serially, chunk totals are scanned in local memory. ──
+__kernel void sphGridScan(
+    __global const uint* cellCounts,
+    __global uint2* grid,
+    const uint tableSize,
+    __local uint* partial
+) {
+    uint lid = get_local_id(0);
+    uint lsize = get_local_size(0);
+    uint chunk = (tableSize + lsize - 1) / lsize;
+    uint begin = min(lid * chunk, tableSize);
+    uint end = min(begin + chunk, tableSize);
+
+    uint sum = 0;
+    for (uint c = begin; c < end; ++c) sum += cellCounts[c];
+    partial[lid] = sum;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // Inclusive Hillis-Steele scan of the chunk totals
+    for (uint offset = 1; offset < lsize; offset <<= 1) {
+        uint v = lid >= offset ? partial[lid - offset] : 0;
+        barrier(CLK_LOCAL_MEM_FENCE);
+        partial[lid] += v;
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    uint running = partial[lid] - sum;
+    for (uint c = begin; c < end; ++c) {
+        uint n = cellCounts[c];
+        grid[c] = (uint2)(running, n);
+        running += n;
+    }
+}
+
+// ── Grid build 4: scatter particle indices into their cell ranges ──
+__kernel void sphGridScatter(
+    __global const uint* particleCell,
+    __global const uint* particleRank,
+    __global const uint2* grid,
+    __global uint* gridEntries,
+    const uint count
+) {
+    uint i = get_global_id(0);
+    if (i >= count) return;
+    uint ch = particleCell[i];
+    if (ch == 0xFFFFFFFFu) return;
+    gridEntries[grid[ch].x + particleRank[i]] = i;
+}
+
+// ── SPH kernel functions ──
+
+float poly6_2d(float r2, float h2) {
+    if (r2 >= h2) return 0.0f;
+    float diff = h2 - r2;
+    return diff * diff * diff;
+}
+
+float2 spikyGrad_2d(float2 rij, float r, float h) {
+    if (r >= h || r < 0.001f) return (float2)(0.0f, 0.0f);
+    float diff = h - r;
+    return (diff * diff) * (rij / r);
+}
+
+float viscLaplacian_2d(float r, float h) {
+    if (r >= h) return 0.0f;
+    return (h - r);
+}
+
+// ── Pass 1: Compute density + pressure using spatial hash ──
+__kernel void sphDensityPressure(
+    __global Particle* particles,
+    __global float* density,
+    __global float* pressure,
+    __global const uint2* grid,        // [tableSize] cells: (start, count)
+    __global const uint* gridEntries,  // sorted particle indices
+    const uint count,
+    const uint tableSize,
+    __constant int* isFluid,           // per-behavior flags
+    __constant SPHParams* sphParams,
+    const uint maxBehaviors,
+    const int mixingEnabled,
+    const float cellSize
+) {
+    uint i = get_global_id(0);
+    if (i >= count) return;
+
+    Particle pi = particles[i];
+    uint bid = pi.behaviorID;
+    if (pi.life <= 0.0f || bid >= maxBehaviors || !isFluid[bid]) {
+        density[i] = 0.0f;
+        pressure[i] = 0.0f;
+        return;
+    }
+
+    SPHParams sp = sphParams[bid];
+    float h = sp.smoothingRadius;
+    float h2 = h * h;
+    float poly6Norm = 4.0f / (M_PI_F * pown(h, 8));
+    float rho = 0.0f;
+    float particleMass = sp.particleMass;
+    float restDensity = sp.restDensity;
+    float stiffness = sp.stiffness;
+
+    // Grid cell of this particle
+    int2 cell0 = cellOf(pi.pos, cellSize);
+    int cx = cell0.x;
+    int cy = cell0.y;
+
+    // Search 3x3 neighborhood
+    for (int dx = -1; dx <= 1; ++dx) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            uint ch = cellHash(cx + dx, cy + dy, tableSize);
+            uint2 cell = grid[ch];
+            uint start = cell.x;
+            uint cellCount = cell.y;
+            for (uint k = 0; k < cellCount; ++k) {
+                uint j = gridEntries[start + k];
+                if (j >= count) continue;
+                Particle pj = particles[j];
+                if (pj.life <= 0.0f) continue;
+                if (pj.behaviorID != bid && !mixingEnabled) continue;
+
+                // Use particle mass from pj's behavior when mixing, otherwise pi's mass
+                float pmass_j = particleMass;
+                if (pj.behaviorID < maxBehaviors) pmass_j = sphParams[pj.behaviorID].particleMass;
+
+                float2 rij = pi.pos - pj.pos;
+                float r2 = dot(rij, rij);
+                rho += pmass_j * poly6Norm * poly6_2d(r2, h2);
+            }
+        }
+    }
+
+    density[i] = rho;
+    pressure[i] = max(stiffness * (rho - restDensity), 0.0f);
+}
+
+// ── Pass 2: Pressure + viscosity + cohesion forces ──
+__kernel void sphForces(
+    __global Particle* particles,
+    __global const float* density,
+    __global const float* pressure,
+    __global const uint2* grid,
+    __global const uint* gridEntries,
+    const float deltaTime,
+    const uint count,
+    const uint tableSize,
+    __constant int* isFluid,
+    __constant SPHParams* sphParams,
+    const uint maxBehaviors,
+    const int mixingEnabled,
+    const float cellSize
+) {
+    uint i = get_global_id(0);
+    if (i >= count) return;
+
+    Particle pi = particles[i];
+    uint bid = pi.behaviorID;
+    if (pi.life <= 0.0f || bid >= maxBehaviors || !isFluid[bid]) return;
+
+    float rho_i = density[i];
+    if (rho_i < 0.0001f) return;
+
+    float p_i = pressure[i];
+    SPHParams sp = sphParams[bid];
+    float h = sp.smoothingRadius;
+    float h2 = h * h;
+    float viscosity = sp.viscosity;
+    float cohesionStrength = sp.cohesion;
+    float particleMass = sp.particleMass;
+
+    float spikyNorm = -30.0f / (M_PI_F * pown(h, 5));
+    float viscNorm = 20.0f / (3.0f * M_PI_F * pown(h, 5));
+    float poly6Norm = 4.0f / (M_PI_F * pown(h, 8));
+
+    float2 fPressure = (float2)(0.0f);
+    float2 fViscosity = (float2)(0.0f);
+    float2 fCohesion = (float2)(0.0f);
+
+    int2 cell0 = cellOf(pi.pos, cellSize);
+    int cx = cell0.x;
+    int cy = cell0.y;
+
+    for (int ddx = -1; ddx <= 1; ++ddx) {
+        for (int ddy = -1; ddy <= 1; ++ddy) {
+            uint ch = cellHash(cx + ddx, cy + ddy, tableSize);
+            uint2 cell = grid[ch];
+            uint start = cell.x;
+            uint cellCount = cell.y;
+            for (uint k = 0; k < cellCount; ++k) {
+                uint j = gridEntries[start + k];
+                if (j == i || j >= count) continue;
+                Particle pj = particles[j];
+                if (pj.life <= 0.0f) continue;
+                if (pj.behaviorID != bid && !mixingEnabled) continue;
+
+                float rho_j = density[j];
+                if (rho_j < 0.0001f) continue;
+                float p_j = pressure[j];
+
+                float2 rij = pi.pos - pj.pos;
+                float r2 = dot(rij, rij);
+                if (r2 >= h2) continue;
+                float r = sqrt(r2);
+
+                // Pressure force (symmetric). Use pj particle mass for scaling when mixing
+                float pmass_j = particleMass;
+                if (pj.behaviorID < maxBehaviors) pmass_j = sphParams[pj.behaviorID].particleMass;
+                float2 pGrad = spikyNorm * spikyGrad_2d(rij, r, h);
+                fPressure -= pmass_j * (p_i / (rho_i * rho_i) + p_j / (rho_j * rho_j)) * pGrad;
+
+                // Viscosity force (use averaged viscosity when mixing)
+                float vLap = viscNorm * viscLaplacian_2d(r, h);
+                float visPair = viscosity;
+                if (pj.behaviorID < maxBehaviors) visPair = 0.5f * (viscosity + sphParams[pj.behaviorID].viscosity);
+                fViscosity += pmass_j * (pj.vel - pi.vel) / rho_j * vLap * visPair;
+
+                // Cohesion (surface tension) - averaged when mixing
+                if (r > 0.001f) {
+                    float w = poly6Norm * poly6_2d(r2, h2);
+                    float coh = cohesionStrength;
+                    if (pj.behaviorID < maxBehaviors) coh = 0.5f * (cohesionStrength + sphParams[pj.behaviorID].cohesion);
+                    fCohesion -= coh * pmass_j * (rij / r) * w;
+                }
+            }
+        }
+    }
+
+    // Note: fViscosity already multiplied by pairwise viscosity above
+
+    float2 accel = (fPressure + fViscosity + fCohesion) / rho_i;
+
+    // Stability clamp
+    float accelLen = length(accel);
+    if (accelLen > 800.0f) {
+        accel = accel / accelLen * 800.0f;
+    }
+
+    pi.vel += accel * deltaTime;
+    particles[i] = pi;
+}
+)";
+
+// ────────────────────────────────────────────────────────────────────
+// Setup
+// ────────────────────────────────────────────────────────────────────
+
+bool FluidSolver::init(size_t capacity) {
+    auto& cl = OpenCLContext::get();
+    if (m_ready || !cl.isReady() || capacity == 0) return m_ready;
+
+    // Load common.cl for #include replacement
+    std::string commonCL = loadLoreBook_ResourcesEmbeddedFileAsString("Kernels/particles/common.cl");
+
+    // Replace #include with actual common.cl content
+    std::string fullSource = s_sphKernelSource;
+    size_t includePos = fullSource.find("#include \"common.cl\"");
+    if (includePos != std::string::npos) {
+        fullSource.replace(includePos, 20, commonCL);
+    }
+
+    const char* src = fullSource.c_str();
+    size_t len = fullSource.size();
+    cl_int err;
+
+    m_program = clCreateProgramWithSource(cl.getContext(), 1, &src, &len, &err);
+    if (err != CL_SUCCESS) {
+        PLOG_ERROR << "SPH: clCreateProgramWithSource failed: " << err;
+        m_program = nullptr;
+        return false;
+    }
+
+    cl_device_id dev = cl.getDevice();
+    err = clBuildProgram(m_program, 1, &dev, "-cl-fast-relaxed-math", nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        size_t logSize;
+        clGetProgramBuildInfo(m_program, dev, CL_PROGRAM_BUILD_LOG, 0, nullptr, &logSize);
+        std::string log(logSize, '\0');
+        clGetProgramBuildInfo(m_program, dev, CL_PROGRAM_BUILD_LOG, logSize, &log[0], nullptr);
+        PLOG_ERROR << "SPH kernel build failed: " << log;
+        cleanup();
+        return false;
+    }
+
+    auto createKernel = [&](cl_kernel& kernel, const char* name) {
+        kernel = clCreateKernel(m_program, name, &err);
+        if (err != CL_SUCCESS) {
+            PLOG_ERROR << "SPH kernel " << name << " failed: " << err;
+            kernel = nullptr;
+            return false;
+        }
+        return true;
+    };
+    bool kernelsOK = createKernel(m_densityKernel, "sphDensityPressure");
+    kernelsOK = createKernel(m_forcesKernel, "sphForces") && kernelsOK;
+    kernelsOK = createKernel(m_gridClearKernel, "sphGridClear") && kernelsOK;
+    kernelsOK = createKernel(m_gridCountKernel, "sphGridCount") && kernelsOK;
+    kernelsOK = createKernel(m_gridScanKernel, "sphGridScan") && kernelsOK;
+    kernelsOK = createKernel(m_gridScatterKernel, "sphGridScatter") && kernelsOK;
+    if (!kernelsOK) {
+        cleanup();
+        return false;
+    }
+
+    // The scan runs as a single work-group; a few hundred items keep the
+    // serial chunk per item short without tripping small device limits
+    size_t maxLocal = 1;
+    clGetKernelWorkGroupInfo(m_gridScanKernel, dev, CL_KERNEL_WORK_GROUP_SIZE,
+                             sizeof(size_t), &maxLocal, nullptr);
+    m_scanLocalSize = std::clamp<size_t>(maxLocal, 1, 256);
+
+    m_capacity = capacity;
+    bool buffersOK = true;
+    auto createBuffer = [&](cl_mem& mem, cl_mem_flags flags, size_t bytes, const char* tag) {
+        mem = cl.createBuffer(flags, bytes, nullptr, &err, tag);
+        if (err != CL_SUCCESS) {
+            mem = nullptr;
+            buffersOK = false;
+        }
+    };
+    createBuffer(m_density, CL_MEM_READ_WRITE, capacity * sizeof(float), "SPH density");
+    createBuffer(m_pressure, CL_MEM_READ_WRITE, capacity * sizeof(float), "SPH pressure");
+    createBuffer(m_grid, CL_MEM_READ_WRITE, GRID_TABLE_SIZE * sizeof(cl_uint2), "SPH grid");
+    createBuffer(m_gridEntries, CL_MEM_READ_WRITE, capacity * sizeof(cl_uint), "SPH grid entries");
+    createBuffer(m_cellCounts, CL_MEM_READ_WRITE, GRID_TABLE_SIZE * sizeof(cl_uint), "SPH cell counts");
+    createBuffer(m_particleCell, CL_MEM_READ_WRITE, capacity * sizeof(cl_uint), "SPH particle cells");
+    createBuffer(m_particleRank, CL_MEM_READ_WRITE, capacity * sizeof(cl_uint), "SPH particle ranks");
+    createBuffer(m_behaviorFlags, CL_MEM_READ_ONLY, MAX_BEHAVIORS * sizeof(cl_int), "SPH behavior flags");
+    createBuffer(m_params, CL_MEM_READ_ONLY, MAX_BEHAVIORS * sizeof(SPHParams), "SPH params");
+    if (!buffersOK) {
+        PLOG_ERROR << "SPH: buffer allocation failed for " << capacity << " particles";
+        cleanup();
+        return false;
+    }
+
+    m_behaviorsUploaded = false;
+    m_ready = true;
+    PLOG_INFO << "SPH fluid simulation initialized (grid table size: " << GRID_TABLE_SIZE
+              << ", capacity: " << capacity << ")";
+    return true;
+}
+
+void FluidSolver::cleanup() {
+    for (cl_kernel* k : {&m_densityKernel, &m_forcesKernel, &m_gridClearKernel,
+                         &m_gridCountKernel, &m_gridScanKernel, &m_gridScatterKernel}) {
+        if (*k) { clReleaseKernel(*k); *k = nullptr; }
+    }
+    if (m_program) { clReleaseProgram(m_program); m_program = nullptr; }
+    for (cl_mem* m : {&m_density, &m_pressure, &m_grid, &m_gridEntries, &m_cellCounts,
+                      &m_particleCell, &m_particleRank, &m_behaviorFlags, &m_params}) {
+        if (*m) { OpenCLContext::get().releaseMem(*m); *m = nullptr; }
+    }
+    m_capacity = 0;
+    m_behaviorsUploaded = false;
+    m_ready = false;
+}
+
+// ────────────────────────────────────────────────────────────────────
+// Behaviors
+// ────────────────────────────────────────────────────────────────────
+
+void FluidSolver::setBehaviors(const std::array<int, MAX_BEHAVIORS>& isFluid,
+                               const std::array<SPHParams, MAX_BEHAVIORS>& params) {
+    if (!m_ready) return;
+    if (m_behaviorsUploaded && isFluid == m_isFluid &&
+        std::memcmp(params.data(), m_sphParams.data(), sizeof(SPHParams) * MAX_BEHAVIORS) == 0)
+        return;
+
+    m_isFluid = isFluid;
+    m_sphParams = params;
+
+    // Grid cell size is the maximum smoothing radius of active fluids
+    m_cellSize = 0.0f;
+    for (size_t b = 0; b < MAX_BEHAVIORS; ++b) {
+        if (m_isFluid[b]) m_cellSize = std::max(m_cellSize, m_sphParams[b].smoothingRadius);
+    }
+    if (m_cellSize <= 0.001f) m_cellSize = 5.0f; // fallback
+
+    // Blocking: the host arrays are members and may change before the copy runs
+    cl_command_queue q = OpenCLContext::get().getQueue();
+    clEnqueueWriteBuffer(q, m_behaviorFlags, CL_TRUE, 0, MAX_BEHAVIORS * sizeof(cl_int),
+                         m_isFluid.data(), 0, nullptr, nullptr);
+    clEnqueueWriteBuffer(q, m_params, CL_TRUE, 0, MAX_BEHAVIORS * sizeof(SPHParams),
+                         m_sphParams.data(), 0, nullptr, nullptr);
+    m_behaviorsUploaded = true;
+}
+
+bool FluidSolver::hasFluidBehaviors() const {
+    return std::any_of(m_isFluid.begin(), m_isFluid.end(), [](int f) { return f != 0; });
+}
+
+// ────────────────────────────────────────────────────────────────────
+// Step
+// ────────────────────────────────────────────────────────────────────
+
+cl_int FluidSolver::buildGrid(cl_command_queue q, cl_mem particles, uint32_t count) {
+    uint32_t tableSize = GRID_TABLE_SIZE;
+    uint32_t maxBeh = static_cast<uint32_t>(MAX_BEHAVIORS);
+    size_t tableGlobal = GRID_TABLE_SIZE;
+    size_t particleGlobal = count;
+
+    clSetKernelArg(m_gridClearKernel, 0, sizeof(cl_mem), &m_cellCounts);
+    clSetKernelArg(m_gridClearKernel, 1, sizeof(uint32_t), &tableSize);
+    cl_int err = clEnqueueNDRangeKernel(q, m_gridClearKernel, 1, nullptr, &tableGlobal,
+                                        nullptr, 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) return err;
+
+    clSetKernelArg(m_gridCountKernel, 0, sizeof(cl_mem), &particles);
+    clSetKernelArg(m_gridCountKernel, 1, sizeof(cl_mem), &m_cellCounts);
+    clSetKernelArg(m_gridCountKernel, 2, sizeof(cl_mem), &m_particleCell);
+    clSetKernelArg(m_gridCountKernel, 3, sizeof(cl_mem), &m_particleRank);
+    clSetKernelArg(m_gridCountKernel, 4, sizeof(uint32_t), &count);
+    clSetKernelArg(m_gridCountKernel, 5, sizeof(uint32_t), &tableSize);
+    clSetKernelArg(m_gridCountKernel, 6, sizeof(float), &m_cellSize);
+    clSetKernelArg(m_gridCountKernel, 7, sizeof(cl_mem), &m_behaviorFlags);
+    clSetKernelArg(m_gridCountKernel, 8, sizeof(uint32_t), &maxBeh);
+    err = clEnqueueNDRangeKernel(q, m_gridCountKernel, 1, nullptr, &particleGlobal,
+                                 nullptr, 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) return err;
+
+    clSetKernelArg(m_gridScanKernel, 0, sizeof(cl_mem), &m_cellCounts);
+    clSetKernelArg(m_gridScanKernel, 1, sizeof(cl_mem), &m_grid);
+    clSetKernelArg(m_gridScanKernel, 2, sizeof(uint32_t), &tableSize);
+    clSetKernelArg(m_gridScanKernel, 3, m_scanLocalSize * sizeof(cl_uint), nullptr);
+    err = clEnqueueNDRangeKernel(q, m_gridScanKernel, 1, nullptr, &m_scanLocalSize,
+                                 &m_scanLocalSize, 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) return err;
+
+    clSetKernelArg(m_gridScatterKernel, 0, sizeof(cl_mem), &m_particleCell);
+    clSetKernelArg(m_gridScatterKernel, 1, sizeof(cl_mem), &m_particleRank);
+    clSetKernelArg(m_gridScatterKernel, 2, sizeof(cl_mem), &m_grid);
+    clSetKernelArg(m_gridScatterKernel, 3, sizeof(cl_mem), &m_gridEntries);
+    clSetKernelArg(m_gridScatterKernel, 4, sizeof(uint32_t), &count);
+    return clEnqueueNDRangeKernel(q, m_gridScatterKernel, 1, nullptr, &particleGlobal,
+                                  nullptr, 0, nullptr, nullptr);
+}
+
+cl_int FluidSolver::step(cl_command_queue q, cl_mem particles, uint32_t count,
+                         float dt, bool allowMixing) {
+    if (!m_ready || !m_behaviorsUploaded || count == 0) return CL_SUCCESS;
+    if (count > m_capacity) return CL_INVALID_BUFFER_SIZE;
+
+    cl_int err = buildGrid(q, particles, count);
+    if (err != CL_SUCCESS) {
+        PLOG_ERROR << "SPH grid build dispatch failed: " << err;
+        return err;
+    }
+
+    uint32_t tableSize = GRID_TABLE_SIZE;
+    uint32_t maxBeh = static_cast<uint32_t>(MAX_BEHAVIORS);
+    int mixingFlag = allowMixing ? 1 : 0;
+    size_t globalSize = count;
+
+    // Pass 1: density + pressure
+    clSetKernelArg(m_densityKernel, 0, sizeof(cl_mem), &particles);
+    clSetKernelArg(m_densityKernel, 1, sizeof(cl_mem), &m_density);
+    clSetKernelArg(m_densityKernel, 2, sizeof(cl_mem), &m_pressure);
+    clSetKernelArg(m_densityKernel, 3, sizeof(cl_mem), &m_grid);
+    clSetKernelArg(m_densityKernel, 4, sizeof(cl_mem), &m_gridEntries);
+    clSetKernelArg(m_densityKernel, 5, sizeof(uint32_t), &count);
+    clSetKernelArg(m_densityKernel, 6, sizeof(uint32_t), &tableSize);
+    clSetKernelArg(m_densityKernel, 7, sizeof(cl_mem), &m_behaviorFlags);
+    clSetKernelArg(m_densityKernel, 8, sizeof(cl_mem), &m_params);
+    clSetKernelArg(m_densityKernel, 9, sizeof(uint32_t), &maxBeh);
+    clSetKernelArg(m_densityKernel, 10, sizeof(int), &mixingFlag);
+    clSetKernelArg(m_densityKernel, 11, sizeof(float), &m_cellSize);
+    err = clEnqueueNDRangeKernel(q, m_densityKernel, 1, nullptr, &globalSize,
+                                 nullptr, 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        PLOG_ERROR << "SPH density kernel dispatch failed: " << err;
+        return err;
+    }
+
+    // Pass 2: forces
+    clSetKernelArg(m_forcesKernel, 0, sizeof(cl_mem), &particles);
+    clSetKernelArg(m_forcesKernel, 1, sizeof(cl_mem), &m_density);
+    clSetKernelArg(m_forcesKernel, 2, sizeof(cl_mem), &m_pressure);
+    clSetKernelArg(m_forcesKernel, 3, sizeof(cl_mem), &m_grid);
+    clSetKernelArg(m_forcesKernel, 4, sizeof(cl_mem), &m_gridEntries);
+    clSetKernelArg(m_forcesKernel, 5, sizeof(float), &dt);
+    clSetKernelArg(m_forcesKernel, 6, sizeof(uint32_t), &count);
+    clSetKernelArg(m_forcesKernel, 7, sizeof(uint32_t), &tableSize);
+    clSetKernelArg(m_forcesKernel, 8, sizeof(cl_mem), &m_behaviorFlags);
+    clSetKernelArg(m_forcesKernel, 9, sizeof(cl_mem), &m_params);
+    clSetKernelArg(m_forcesKernel, 10, sizeof(uint32_t), &maxBeh);
+    clSetKernelArg(m_forcesKernel, 11, sizeof(int), &mixingFlag);
+    clSetKernelArg(m_forcesKernel, 12, sizeof(float), &m_cellSize);
+    err = clEnqueueNDRangeKernel(q, m_forcesKernel, 1, nullptr, &globalSize,
+                                 nullptr, 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        PLOG_ERROR << "SPH forces kernel dispatch failed: " << err;
+    }
+    return err;
+}
+
+} // namespace Markdown
@@ -0,0 +1,281 @@
+#include <Editors/Markdown/GlyphStore.hpp>
+#include <Editors/Markdown/Effect.hpp>
+#include <plog/Log.h>
+#include <algorithm>
+#include <cfloat>
+#include <cstddef>
+#include <functional>
+
+namespace Markdown {
+
+// ────────────────────────────────────────────────────────────────────
+// Instance attributes
+// ────────────────────────────────────────────────────────────────────
+
+static const char* s_glyphInstanceGLSL = R"(
+// One GlyphInstance per glyph, drawn as a 4-vertex triangle strip
+layout(location = 0) in vec4 inst_rect;       // pos.xy, size.xy
+layout(location = 1) in vec4 inst_uvRect;     // uvMin.xy, uvMax.xy
+layout(location = 2) in vec4 inst_color;      // RGBA8, normalized
+layout(location = 3) in uint inst_effectID;
+layout(location = 4) in float inst_z;
+
+// The quad corner being shaded
+vec3 in_pos;
+vec2 in_uv;
+vec4 in_color;
+uint in_effectID;
+
+void expandGlyphInstance() {
+    vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));
+    in_pos = vec3(inst_rect.xy + corner * inst_rect.zw, inst_z);
+    in_uv = mix(inst_uvRect.xy, inst_uvRect.zw, corner);
+    in_color = inst_color;
+    in_effectID = inst_effectID;
+}
+)";
+
+const char* GlyphStore::vertexInputsGLSL() {
+    return s_glyphInstanceGLSL;
+}
+
+static uint32_t packColor(const glm::vec4& c) {
+    auto channel = [](float v) {
+        return static_cast<uint32_t>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+    };
+    return channel(c.r) | (channel(c.g) << 8) | (channel(c.b) << 16) | (channel(c.a) << 24);
+}
+
+static uint32_t behaviorID(const EffectDef* effect) {
+    return effect && effect->effect ? effect->effect->getBehaviorID() : 0;
+}
+
+// ────────────────────────────────────────────────────────────────────
+// Setup
+// ────────────────────────────────────────────────────────────────────
+
+void GlyphStore::init() {
+    if (m_vao) return;
+
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vbo);
+
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+    m_capacity = INITIAL_CAPACITY;
+    glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(GlyphInstance), nullptr, GL_DYNAMIC_DRAW);
+
+    for (GLuint attr = 0; attr <= 4; ++attr) {
+        glEnableVertexAttribArray(attr);
+        glVertexAttribDivisor(attr, 1);
+    }
+    bindInstances(0);
+
+    glBindVertexArray(0);
+}
+
+void GlyphStore::cleanup() {
+    if (m_vao) {
+        glDeleteVertexArrays(1, &m_vao);
+        m_vao = 0;
+    }
+    if (m_vbo) {
+        glDeleteBuffers(1, &m_vbo);
+        m_vbo = 0;
+    }
+    m_capacity = 0;
+    m_used = 0;
+    m_slots.clear();
+    m_emittedIds.clear();
+    m_batches.clear();
+}
+
+void GlyphStore::bindInstances(uint32_t first) const {
+    const GLsizei stride = sizeof(GlyphInstance);
+    const uintptr_t base = static_cast<uintptr_t>(first) * stride;
+
+    // GlyphInstance layout: pos+size(4), uvMin+uvMax(4), z(1), color(RGBA8), effectID(1)
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride,
+                          (void*)(base + offsetof(GlyphInstance, pos)));
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride,
+                          (void*)(base + offsetof(GlyphInstance, uvMin)));
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                          (void*)(base + offsetof(GlyphInstance, color)));
+    glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, stride,
+                           (void*)(base + offsetof(GlyphInstance, effectID)));
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, stride,
+                          (void*)(base + offsetof(GlyphInstance, z)));
+}
+
+// ────────────────────────────────────────────────────────────────────
+// Update
+// ────────────────────────────────────────────────────────────────────
+
+bool GlyphStore::update(const std::vector<LayoutGlyph>& glyphs,
+                        const std::vector<LayoutEngine::EmittedBlock>& blocks) {
+    m_lastUpload = 0;
+    if (!m_vbo) return false;
+
+    // Blocks laid out again or moved since their slot was written
+    std::vector<size_t> dirty;
+    uint32_t newSpace = 0;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const auto& b = blocks[i];
+        auto it = m_slots.find(b.id);
+        if (it != m_slots.end() && it->second.revision == b.revision && it->second.top == b.top)
+            continue;
+        dirty.push_back(i);
+        if (it == m_slots.end() || it->second.capacity < b.glyphCount)
+            newSpace += slotCapacity(b.glyphCount);
+    }
+
+    bool sameBlocks = blocks.size() == m_emittedIds.size();
+    for (size_t i = 0; sameBlocks && i < blocks.size(); ++i)
+        sameBlocks = blocks[i].id == m_emittedIds[i];
+    if (dirty.empty() && sameBlocks) return false;
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    if (static_cast<size_t>(m_used) + newSpace > m_capacity) {
+        repack(glyphs, blocks);
+    } else {
+        for (size_t i : dirty) {
+            const auto& b = blocks[i];
+            Slot& slot = m_slots[b.id];
+            writeSlot(slot, glyphs.data() + b.firstGlyph, b.glyphCount);
+            slot.revision = b.revision;
+            slot.top = b.top;
+        }
+    }
+
+    m_emittedIds.clear();
+    for (const auto& b : blocks) m_emittedIds.push_back(b.id);
+    rebuildBatches(blocks);
+    return true;
+}
+
+void GlyphStore::repack(const std::vector<LayoutGlyph>& glyphs,
+                        const std::vector<LayoutEngine::EmittedBlock>& blocks) {
+    // Slots of blocks scrolled away are dropped; they are rewritten on return
+    size_t needed = 0;
+    for (const auto& b : blocks) needed += slotCapacity(b.glyphCount);
+
+    uint32_t capacity = std::max(m_capacity, INITIAL_CAPACITY);
+    while (capacity < needed * 2) capacity *= 2;
+    if (capacity != m_capacity) {
+        m_capacity = capacity;
+        glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(GlyphInstance), nullptr, GL_DYNAMIC_DRAW);
+        PLOG_DEBUG << "GlyphStore grown to " << m_capacity << " instances";
+    }
+
+    m_slots.clear();
+    m_used = 0;
+    for (const auto& b : blocks) {
+        Slot& slot = m_slots[b.id];
+        writeSlot(slot, glyphs.data() + b.firstGlyph, b.glyphCount);
+        slot.revision = b.revision;
+        slot.top = b.top;
+    }
+}
+
+void GlyphStore::writeSlot(Slot& slot, const LayoutGlyph* glyphs, size_t count) {
+    if (slot.capacity < count || slot.capacity == 0) {
+        slot.capacity = slotCapacity(count);
+        slot.first = m_used;
+        m_used += slot.capacity;
+    }
+
+    // Same order in every block, so runs of neighbouring slots line up
+    m_order.resize(count);
+    for (uint32_t i = 0; i < count; ++i) m_order[i] = i;
+    std::stable_sort(m_order.begin(), m_order.end(), [&](uint32_t a, uint32_t b) {
+        return std::less<const EffectDef*>()(glyphs[a].effect, glyphs[b].effect);
+    });
+
+    m_scratch.resize(count);
+    slot.runs.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        const LayoutGlyph& g = glyphs[m_order[i]];
+        GlyphInstance& inst = m_scratch[i];
+        inst.pos = glm::vec2(g.pos);
+        inst.size = g.size;
+        inst.uvMin = g.uvMin;
+        inst.uvMax = g.uvMax;
+        inst.z = g.pos.z;
+        inst.color = packColor(g.color);
+        inst.effectID = behaviorID(g.effect);
+        inst.pad = 0;
+
+        if (slot.runs.empty() || slot.runs.back().effect != g.effect) {
+            Run run;
+            run.effect = g.effect;
+            run.first = slot.first + i;
+            run.boundsMin = glm::vec2(FLT_MAX);
+            run.boundsMax = glm::vec2(-FLT_MAX);
+            slot.runs.push_back(run);
+        }
+        Run& run = slot.runs.back();
+        ++run.count;
+        run.boundsMin = glm::min(run.boundsMin, inst.pos);
+        run.boundsMax = glm::max(run.boundsMax, inst.pos + inst.size);
+    }
+
+    if (count > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, slot.first * sizeof(GlyphInstance),
+                        count * sizeof(GlyphInstance), m_scratch.data());
+    }
+    m_lastUpload += count;
+}
+
+void GlyphStore::rebuildBatches(const std::vector<LayoutEngine::EmittedBlock>& blocks) {
+    m_batches.clear();
+    std::unordered_map<const EffectDef*, size_t> batchIndex;
+
+    for (const auto& b : blocks) {
+        auto it = m_slots.find(b.id);
+        if (it == m_slots.end()) continue;
+        for (const Run& run : it->second.runs) {
+            auto [entry, inserted] = batchIndex.try_emplace(run.effect, m_batches.size());
+            if (inserted) {
+                EffectBatch batch;
+                batch.effect = run.effect;
+                batch.boundsMin = run.boundsMin;
+                batch.boundsMax = run.boundsMax;
+                m_batches.push_back(std::move(batch));
+            }
+            EffectBatch& batch = m_batches[entry->second];
+
+            // Consecutive slots are usually adjacent in the buffer
+            if (!batch.ranges.empty() &&
+                batch.ranges.back().first + batch.ranges.back().count == run.first) {
+                batch.ranges.back().count += run.count;
+            } else {
+                batch.ranges.push_back({run.first, run.count});
+            }
+            batch.instanceCount += run.count;
+            batch.boundsMin = glm::min(batch.boundsMin, run.boundsMin);
+            batch.boundsMax = glm::max(batch.boundsMax, run.boundsMax);
+        }
+    }
+
+    std::stable_sort(m_batches.begin(), m_batches.end(), [](const EffectBatch& a, const EffectBatch& b) {
+        return behaviorID(a.effect) < behaviorID(b.effect);
+    });
+}
+
+// ────────────────────────────────────────────────────────────────────
+// Drawing
+// ────────────────────────────────────────────────────────────────────
+
+void GlyphStore::draw(const EffectBatch& batch) const {
+    if (!m_vao || batch.ranges.empty()) return;
+
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    for (const InstanceRange& range : batch.ranges) {
+        bindInstances(range.first);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(range.count));
+    }
+}
+
+} // namespace Markdown
@@ -51,25 +51,198 @@ void LayoutEngine::resetState(float wrapWidth) {
 
 void LayoutEngine::layout(const MarkdownDocument& doc, float wrapWidth,
                           std::vector<LayoutGlyph>& outGlyphs,
-                          std::vector<OverlayWidget>& outWidgets) {
+                          std::vector<OverlayWidget>& outWidgets,
+                          float viewTop, float viewBottom) {
     outGlyphs.clear();
     outWidgets.clear();
-    
-    m_outGlyphs = &outGlyphs;
-    m_outWidgets = &outWidgets;
+    m_emittedBlocks.clear();
+    m_scrollAdjustment = 0;
+    ++m_layoutFrame;
     
     resetState(wrapWidth);
     
-    // Layout all children of the root document block
-    const Block& root = doc.getRoot();
-    for (const auto& child : root.children) {
-        layoutBlock(*child, 0);
+    // Cached glyphs hold atlas UVs and font metrics
+    intptr_t atlas = (intptr_t)ImGui::GetIO().Fonts->TexID;
+    if (atlas != m_cachedFontAtlas || m_font != m_cachedFont) {
+        invalidateCache();
+        m_cachedFontAtlas = atlas;
+        m_cachedFont = m_font;
+    }
+    
+    const std::vector<Block*>& blocks = doc.getBlocks();
+    const size_t count = blocks.size();
+    
+    auto isCurrent = [&](const BlockLayout* e) {
+        return e && e->wrapWidth == wrapWidth && e->scale == m_baseScale;
+    };
+    
+    // Heights: cached, else rescaled from another width, else estimated
+    std::vector<BlockLayout*> entries(count, nullptr);
+    std::vector<float> heights(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto it = m_blockCache.find(blocks[i]->id);
+        if (it != m_blockCache.end()) {
+            entries[i] = &it->second;
+            entries[i]->lastUse = m_layoutFrame;
+        }
+        const BlockLayout* e = entries[i];
+        if (isCurrent(e))
+            heights[i] = e->height;
+        else if (e && wrapWidth > 0.0f)
+            heights[i] = e->height * (e->wrapWidth / wrapWidth) * (m_baseScale / e->scale);
+        else
+            heights[i] = estimateBlockHeight(*blocks[i], wrapWidth);
+    }
+    auto rebuildTops = [&] {
+        m_blockTops.resize(count + 1);
+        m_blockTops[0] = 0.0f;
+        for (size_t i = 0; i < count; ++i) m_blockTops[i + 1] = m_blockTops[i] + heights[i];
+    };
+    rebuildTops();
+    
+    auto relayout = [&](size_t i) {
+        entries[i] = &layoutTopLevelBlock(*blocks[i], wrapWidth);
+        entries[i]->lastUse = m_layoutFrame;
+        heights[i] = entries[i]->height;
+    };
+    
+    // Blocks in view (plus margin); measuring them can pull more in
+    const float top = viewTop - VIEW_MARGIN;
+    const float bottom = viewBottom > std::numeric_limits<float>::max() - VIEW_MARGIN
+                       ? viewBottom : viewBottom + VIEW_MARGIN;
+    size_t first = 0, last = 0;
+    for (int pass = 0; pass < 4 && count > 0; ++pass) {
+        first = getBlockAtY(top);
+        last = static_cast<size_t>(std::lower_bound(m_blockTops.begin(), m_blockTops.begin() + count, bottom) -
+                                   m_blockTops.begin());
+        last = std::clamp(last, first + 1, count);
+        bool changed = false;
+        for (size_t i = first; i < last; ++i) {
+            if (isCurrent(entries[i]) && entries[i]->materialized) continue;
+            relayout(i);
+            changed = true;
+        }
+        if (!changed) break;
+        rebuildTops();
+    }
+    
+    // Measure a few off-screen blocks so the content height converges,
+    // keeping the first visible block where it was on screen
+    if (count > 0) {
+        float anchor = m_blockTops[first];
+        int budget = MEASURE_PER_LAYOUT;
+        for (size_t i = 0; i < count && budget > 0; ++i) {
+            if (isCurrent(entries[i])) continue;
+            relayout(i);
+            --budget;
+        }
+        if (budget < MEASURE_PER_LAYOUT) {
+            rebuildTops();
+            m_scrollAdjustment = m_blockTops[first] - anchor;
+        }
+    }
+    
+    // Emit the visible blocks at their document positions
+    for (size_t i = first; i < last && i < count; ++i) {
+        const BlockLayout& e = *entries[i];
+        const float dy = m_blockTops[i];
+        const std::ptrdiff_t shift = static_cast<std::ptrdiff_t>(blocks[i]->sourceOffset) -
+                                     static_cast<std::ptrdiff_t>(e.sourceOffset);
+        m_emittedBlocks.push_back({blocks[i]->id, e.revision, dy, outGlyphs.size(), e.glyphs.size()});
+        for (LayoutGlyph g : e.glyphs) {
+            g.pos.y += dy;
+            g.sourceOffset = static_cast<size_t>(static_cast<std::ptrdiff_t>(g.sourceOffset) + shift);
+            outGlyphs.push_back(g);
+        }
+        for (OverlayWidget w : e.widgets) {
+            w.docPos.y += dy;
+            w.blockId = blocks[i]->id;
+            w.sourceOffset = static_cast<size_t>(static_cast<std::ptrdiff_t>(w.sourceOffset) + shift);
+            outWidgets.push_back(std::move(w));
+        }
     }
     
-    m_contentHeight = m_curY;
+    // Keep glyphs only near the view; the rest keep their measured height
+    // so positions and the content height stay put
+    m_materializedBlocks = 0;
+    if (count > 0) {
+        const float keepTop = viewTop - m_retainMargin;
+        const float keepBottom = viewBottom > std::numeric_limits<float>::max() - m_retainMargin
+                               ? viewBottom : viewBottom + m_retainMargin;
+        for (size_t i = 0; i < count; ++i) {
+            BlockLayout* e = entries[i];
+            if (!e || !e->materialized) continue;
+            if (m_blockTops[i + 1] < keepTop || m_blockTops[i] > keepBottom)
+                releaseBlock(*e);
+            else
+                ++m_materializedBlocks;
+        }
+    }
+    
+    // Forget blocks that left the document
+    if (m_blockCache.size() > count + 256) {
+        for (auto it = m_blockCache.begin(); it != m_blockCache.end(); ) {
+            if (it->second.lastUse != m_layoutFrame) it = m_blockCache.erase(it);
+            else ++it;
+        }
+    }
+    
+    m_contentHeight = count > 0 ? m_blockTops[count] : 0.0f;
+}
+
+LayoutEngine::BlockLayout& LayoutEngine::layoutTopLevelBlock(const Block& block, float wrapWidth) {
+    BlockLayout& entry = m_blockCache[block.id];
+    entry.glyphs.clear();
+    entry.widgets.clear();
+    
+    resetState(wrapWidth);
+    m_outGlyphs = &entry.glyphs;
+    m_outWidgets = &entry.widgets;
+    
+    layoutBlock(block, 0);
+    
+    entry.wrapWidth = wrapWidth;
+    entry.scale = m_baseScale;
+    entry.sourceOffset = block.sourceOffset;
+    entry.height = m_curY;
+    entry.revision = m_nextRevision++;
+    entry.materialized = true;
+    entry.inlineEffects = std::move(m_inlineEffects);
+    entry.clonedEffects = std::move(m_clonedEffects);
+    m_inlineEffects.clear();
+    m_clonedEffects.clear();
     
     m_outGlyphs = nullptr;
     m_outWidgets = nullptr;
+    return entry;
+}
+
+void LayoutEngine::releaseBlock(BlockLayout& entry) {
+    // swap() rather than clear() so the capacity goes too
+    std::vector<LayoutGlyph>().swap(entry.glyphs);
+    std::vector<OverlayWidget>().swap(entry.widgets);
+    entry.inlineEffects.clear();
+    entry.inlineEffects.shrink_to_fit();
+    entry.clonedEffects.clear();
+    entry.clonedEffects.shrink_to_fit();
+    entry.materialized = false;
+}
+
+float LayoutEngine::estimateBlockHeight(const Block& block, float wrapWidth) const {
+    // Half an em per byte of the block's own text is close for prose;
+    // exact once measured
+    float fontSize = (m_font ? m_font->FontSize : 16.0f) * m_baseScale;
+    float chars = block.sourceLength > 0 ? static_cast<float>(block.sourceLength) : 80.0f;
+    float lines = std::ceil(chars * fontSize * 0.5f / std::max(wrapWidth, fontSize));
+    return std::max(lines, 1.0f) * m_lineHeight * m_baseScale + PARAGRAPH_SPACING;
+}
+
+size_t LayoutEngine::getBlockAtY(float y) const {
+    if (m_blockTops.size() < 2) return 0;
+    size_t count = m_blockTops.size() - 1;
+    auto it = std::upper_bound(m_blockTops.begin(), m_blockTops.begin() + count, y);
+    size_t index = static_cast<size_t>(it - m_blockTops.begin());
+    return index > 0 ? std::min(index - 1, count - 1) : 0;
 }
 
 void LayoutEngine::layoutBlock(const Block& block, int depth) {
@@ -3,6 +3,8 @@
 #include <functional>
 #include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <unordered_set>
 #include <plog/Log.h>
 
@@ -40,13 +42,19 @@ struct EffectTagRecord {
 // ────────────────────────────────────────────────────────────────────
 
 struct MDParseState {
-    MarkdownDocument* doc = nullptr;
+    Block* root = nullptr;         // receives the top-level blocks
     const char* sourceBase = nullptr;
     size_t sourceLen = 0;
+    size_t baseOffset = 0;         // document offset of sourceBase[0]
     
     // Stack of current block context
     std::stack<Block*> blockStack;
     
+    // Processed-source byte range seen so far by each block on blockStack
+    // (md4c reports no block positions; text callbacks point into the source)
+    struct Extent { size_t begin = SIZE_MAX; size_t end = 0; };
+    std::vector<Extent> blockExtents;
+    
     // Stack of current span context
     std::stack<Span*> spanStack;
     
@@ -80,6 +88,160 @@ static size_t computeHash(const std::string& s) {
     return hash;
 }
 
+// FNV-1a over a source range; segment matches are confirmed byte-wise
+static uint64_t hashRange(const char* data, size_t size) {
+    uint64_t hash = 1469598103934665603ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// ────────────────────────────────────────────────────────────────────
+// Top-level block boundaries
+//
+// A segment ends before an unindented line that follows a blank line,
+// unless that line could still belong to the previous block: a list item
+// or quote marker (loose lists and quotes span blank lines), or anything
+// inside a code fence or an open effect tag.  Segments therefore parse
+// to the same blocks on their own as they do inside the full document.
+// ────────────────────────────────────────────────────────────────────
+
+struct SegmentRange {
+    size_t offset;
+    size_t length;
+};
+
+static bool isBlankLine(const std::string& s, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i)
+        if (s[i] != ' ' && s[i] != '\t' && s[i] != '\r') return false;
+    return true;
+}
+
+// List item marker ("- ", "* ", "+ ", "1. ", "1) ") or block quote at p
+static bool startsContainerLine(const std::string& s, size_t p, size_t end) {
+    auto spaceOrEnd = [&](size_t i) {
+        return i >= end || s[i] == ' ' || s[i] == '\t' || s[i] == '\r';
+    };
+    if (p >= end) return false;
+    char c = s[p];
+    if (c == '>') return true;
+    if (c == '-' || c == '*' || c == '+') return spaceOrEnd(p + 1);
+    size_t d = p;
+    while (d < end && d - p < 9 && std::isdigit(static_cast<unsigned char>(s[d]))) ++d;
+    return d > p && d < end && (s[d] == '.' || s[d] == ')') && spaceOrEnd(d + 1);
+}
+
+// Net effect-tag nesting change of s[begin, end)
+static int effectDepthChange(const std::string& s, size_t begin, size_t end) {
+    const auto& knownTags = getKnownEffectTags();
+    int change = 0;
+    for (size_t p = begin; p < end; ++p) {
+        if (s[p] != '<') continue;
+        size_t q = p + 1;
+        bool closing = q < end && s[q] == '/';
+        if (closing) ++q;
+        size_t nameStart = q;
+        while (q < end && !std::isspace(static_cast<unsigned char>(s[q])) && s[q] != '>' && s[q] != '/') ++q;
+        if (q == nameStart) continue;
+        std::string name(s, nameStart, q - nameStart);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        if (knownTags.find(name) == knownTags.end()) continue;
+        size_t close = s.find('>', q);
+        if (close == std::string::npos || close >= end) continue;
+        bool selfClosing = !closing && close > q && s[close - 1] == '/';
+        if (closing) --change;
+        else if (!selfClosing) ++change;
+        p = close;
+    }
+    return change;
+}
+
+// "[label]: destination" at the start of a line makes links resolve
+// across blocks, so such documents cannot be split
+static bool hasReferenceDefinitions(const std::string& s) {
+    size_t p = 0;
+    while (p < s.size()) {
+        size_t end = s.find('\n', p);
+        if (end == std::string::npos) end = s.size();
+        size_t q = p;
+        while (q < end && q - p < 3 && s[q] == ' ') ++q;
+        if (q < end && s[q] == '[') {
+            size_t close = s.find("]:", q);
+            if (close != std::string::npos && close < end) return true;
+        }
+        p = end + 1;
+    }
+    return false;
+}
+
+static std::vector<SegmentRange> splitTopLevelBlocks(const std::string& s) {
+    std::vector<SegmentRange> segments;
+    if (hasReferenceDefinitions(s)) {
+        segments.push_back({0, s.size()});
+        return segments;
+    }
+    
+    size_t segStart = 0;
+    bool prevBlank = false;
+    char fenceChar = 0;
+    size_t fenceLen = 0;
+    int effectDepth = 0;
+    
+    size_t p = 0;
+    while (p < s.size()) {
+        size_t end = s.find('\n', p);
+        if (end == std::string::npos) end = s.size();
+        bool blank = isBlankLine(s, p, end);
+        
+        size_t indent = 0;
+        while (p + indent < end && s[p + indent] == ' ') ++indent;
+        bool tabbed = p + indent < end && s[p + indent] == '\t';
+        
+        if (!fenceChar && prevBlank && !blank && indent == 0 && !tabbed && effectDepth <= 0 &&
+            p > segStart && !startsContainerLine(s, p, end)) {
+            segments.push_back({segStart, p - segStart});
+            segStart = p;
+        }
+        
+        // Code fences (``` or ~~~, up to three spaces of indent)
+        size_t f = p + indent;
+        if (indent <= 3 && f < end && (s[f] == '`' || s[f] == '~')) {
+            char c = s[f];
+            size_t run = 0;
+            while (f + run < end && s[f + run] == c) ++run;
+            if (run >= 3) {
+                if (!fenceChar) {
+                    fenceChar = c;
+                    fenceLen = run;
+                } else if (c == fenceChar && run >= fenceLen && isBlankLine(s, f + run, end)) {
+                    fenceChar = 0;
+                }
+            }
+        }
+        if (!fenceChar) effectDepth = std::max(0, effectDepth + effectDepthChange(s, p, end));
+        
+        prevBlank = blank && !fenceChar;
+        p = end + 1;
+    }
+    if (segStart < s.size() || segments.empty())
+        segments.push_back({segStart, s.size() - segStart});
+    return segments;
+}
+
+// Move a reused block (and everything under it) to a new source position
+static void shiftSpanOffsets(Span& span, std::ptrdiff_t delta) {
+    span.sourceOffset = static_cast<size_t>(static_cast<std::ptrdiff_t>(span.sourceOffset) + delta);
+    for (auto& child : span.children) shiftSpanOffsets(*child, delta);
+}
+
+static void shiftBlockOffsets(Block& block, std::ptrdiff_t delta) {
+    block.sourceOffset = static_cast<size_t>(static_cast<std::ptrdiff_t>(block.sourceOffset) + delta);
+    for (auto& span : block.inlineContent) shiftSpanOffsets(*span, delta);
+    for (auto& child : block.children) shiftBlockOffsets(*child, delta);
+}
+
 // ────────────────────────────────────────────────────────────────────
 // Helper: parse effect tag attributes
 // ────────────────────────────────────────────────────────────────────
@@ -268,7 +430,7 @@ static void emitTextSpan(void* userdata,
     auto span = std::make_unique<Span>();
     span->type = SpanType::Text;
     span->text.assign(text, size);
-    span->sourceOffset = text - state->sourceBase;
+    span->sourceOffset = state->baseOffset + (text - state->sourceBase);
     span->sourceLength = size;
     
     if (!state->spanStack.empty()) {
@@ -321,7 +483,7 @@ static void processTextWithMarkers(void* userdata,
                     span->type = SpanType::Effect;
                     span->effectName = record.effectiveName;
                     span->effectParams = record.params;
-                    span->sourceOffset = (text + markerPos) - state->sourceBase;
+                    span->sourceOffset = state->baseOffset + ((text + markerPos) - state->sourceBase);
                     
                     Span* spanPtr = span.get();
                     
@@ -371,13 +533,20 @@ static void processTextWithMarkers(void* userdata,
 int MarkdownDocument::enterBlock(MD_BLOCKTYPE type, void* detail, void* userdata) {
     auto* state = static_cast<ParseState*>(userdata);
     
+    // The document itself is the caller's root
+    if (type == MD_BLOCK_DOC) {
+        state->blockStack.push(state->root);
+        state->blockExtents.emplace_back();
+        return 0;
+    }
+    
+    // Offset/length become the block's own span in leaveBlock()
     auto block = std::make_unique<Block>();
     Block* blockPtr = block.get();
+    block->sourceOffset = state->baseOffset;
+    block->sourceLength = 0;
     
     switch (type) {
-        case MD_BLOCK_DOC:
-            block->type = BlockType::Document;
-            break;
         case MD_BLOCK_P:
             block->type = BlockType::Paragraph;
             break;
@@ -440,17 +609,11 @@ int MarkdownDocument::enterBlock(MD_BLOCKTYPE type, void* detail, void* userdata
             break;
     }
     
-    // Add to parent
-    if (!state->blockStack.empty()) {
-        Block* parent = state->blockStack.top();
-        parent->children.push_back(std::move(block));
-    } else {
-        // Root level
-        state->doc->m_root.children.push_back(std::move(block));
-        state->doc->m_blocks.push_back(blockPtr);
-    }
-    
+    // Add to parent (the root is always on the stack once md4c starts)
+    if (state->blockStack.empty()) return 0;
+    state->blockStack.top()->children.push_back(std::move(block));
     state->blockStack.push(blockPtr);
+    state->blockExtents.emplace_back();
     return 0;
 }
 
@@ -463,6 +626,19 @@ int MarkdownDocument::leaveBlock(MD_BLOCKTYPE type, void* detail, void* userdata
     }
     
     if (!state->blockStack.empty()) {
+        // Record the bytes this block's text covered and widen the parent
+        ParseState::Extent extent = state->blockExtents.back();
+        state->blockExtents.pop_back();
+        if (extent.begin != SIZE_MAX) {
+            Block* block = state->blockStack.top();
+            block->sourceOffset = state->baseOffset + extent.begin;
+            block->sourceLength = extent.end - extent.begin;
+            if (!state->blockExtents.empty()) {
+                ParseState::Extent& parent = state->blockExtents.back();
+                parent.begin = std::min(parent.begin, extent.begin);
+                parent.end = std::max(parent.end, extent.end);
+            }
+        }
         state->blockStack.pop();
     }
     return 0;
@@ -537,6 +713,15 @@ int MarkdownDocument::leaveSpan(MD_SPANTYPE type, void* detail, void* userdata)
 int MarkdownDocument::textCallback(MD_TEXTTYPE type, const MD_CHAR* text, MD_SIZE size, void* userdata) {
     auto* state = static_cast<ParseState*>(userdata);
     
+    // Line breaks and NUL replacements point at static strings, not the source
+    if (!state->blockExtents.empty() && text >= state->sourceBase &&
+        text + size <= state->sourceBase + state->sourceLen) {
+        ParseState::Extent& extent = state->blockExtents.back();
+        size_t begin = static_cast<size_t>(text - state->sourceBase);
+        extent.begin = std::min(extent.begin, begin);
+        extent.end = std::max(extent.end, begin + size);
+    }
+    
     // Code block content: append directly, don't process markers
     if (!state->blockStack.empty() && state->blockStack.top()->type == BlockType::CodeBlock) {
         state->blockStack.top()->codeContent.append(text, size);
@@ -554,24 +739,18 @@ int MarkdownDocument::textCallback(MD_TEXTTYPE type, const MD_CHAR* text, MD_SIZ
 // Public API
 // ────────────────────────────────────────────────────────────────────
 
-void MarkdownDocument::parseString(const std::string& markdown) {
-    size_t newHash = computeHash(markdown);
-    if (newHash == m_sourceHash && !m_dirty) {
-        return;  // No change
-    }
-    
-    clear();
-    m_sourceHash = newHash;
-    m_dirty = false;
-    
-    m_root.type = BlockType::Document;
+void MarkdownDocument::parseSegment(const std::string& source, size_t offset, size_t length,
+                                    std::vector<std::unique_ptr<Block>>& out) {
+    Block segmentRoot;
+    segmentRoot.type = BlockType::Document;
     
     ParseState state;
-    state.doc = this;
+    state.root = &segmentRoot;
+    state.baseOffset = offset;
     
     // Pre-process: extract effect tags and replace with byte markers
     // This bypasses md4c's HTML handling entirely for our custom tags
-    std::string processedSource = preprocessEffectTags(markdown, state.effectRecords);
+    std::string processedSource = preprocessEffectTags(source.substr(offset, length), state.effectRecords);
     
     state.sourceBase = processedSource.c_str();
     state.sourceLen = processedSource.size();
@@ -589,12 +768,94 @@ void MarkdownDocument::parseString(const std::string& markdown) {
     if (result != 0) {
         PLOG_WARNING << "md4c parse error: " << result;
     }
+    
+    for (auto& block : segmentRoot.children) {
+        block->id = nextBlockId();
+        out.push_back(std::move(block));
+    }
+}
+
+uint64_t MarkdownDocument::nextBlockId() {
+    static std::atomic<uint64_t> s_nextBlockId{1};
+    return s_nextBlockId.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MarkdownDocument::parseString(const std::string& markdown) {
+    size_t newHash = computeHash(markdown);
+    if (newHash == m_sourceHash && !m_dirty) {
+        return;  // No change
+    }
+    
+    m_sourceHash = newHash;
+    m_dirty = false;
+    m_root.type = BlockType::Document;
+    
+    std::vector<SourceSegment> segments;
+    for (const SegmentRange& r : splitTopLevelBlocks(markdown))
+        segments.push_back({r.offset, r.length, hashRange(markdown.data() + r.offset, r.length), 0});
+    
+    // Unchanged leading and trailing segments keep their blocks
+    auto same = [&](const SourceSegment& before, const SourceSegment& now) {
+        return before.hash == now.hash && before.length == now.length &&
+               m_source.compare(before.offset, before.length, markdown, now.offset, now.length) == 0;
+    };
+    const size_t oldCount = m_segments.size();
+    const size_t newCount = segments.size();
+    size_t prefix = 0;
+    while (prefix < oldCount && prefix < newCount && same(m_segments[prefix], segments[prefix])) {
+        segments[prefix].blockCount = m_segments[prefix].blockCount;
+        ++prefix;
+    }
+    size_t suffix = 0;
+    while (suffix < oldCount - prefix && suffix < newCount - prefix &&
+           same(m_segments[oldCount - 1 - suffix], segments[newCount - 1 - suffix])) {
+        segments[newCount - 1 - suffix].blockCount = m_segments[oldCount - 1 - suffix].blockCount;
+        ++suffix;
+    }
+    
+    size_t firstBlock = 0;
+    for (size_t i = 0; i < prefix; ++i) firstBlock += m_segments[i].blockCount;
+    size_t removedBlocks = 0;
+    for (size_t i = prefix; i < oldCount - suffix; ++i) removedBlocks += m_segments[i].blockCount;
+    
+    // Reparse the changed middle
+    std::vector<std::unique_ptr<Block>> fresh;
+    for (size_t i = prefix; i < newCount - suffix; ++i) {
+        size_t before = fresh.size();
+        parseSegment(markdown, segments[i].offset, segments[i].length, fresh);
+        segments[i].blockCount = fresh.size() - before;
+    }
+    
+    // Reused trailing blocks moved with the edit
+    auto& children = m_root.children;
+    if (suffix > 0) {
+        std::ptrdiff_t delta = static_cast<std::ptrdiff_t>(segments[newCount - suffix].offset) -
+                               static_cast<std::ptrdiff_t>(m_segments[oldCount - suffix].offset);
+        if (delta != 0)
+            for (size_t i = firstBlock + removedBlocks; i < children.size(); ++i)
+                shiftBlockOffsets(*children[i], delta);
+    }
+    
+    children.erase(children.begin() + firstBlock, children.begin() + firstBlock + removedBlocks);
+    children.insert(children.begin() + firstBlock,
+                    std::make_move_iterator(fresh.begin()), std::make_move_iterator(fresh.end()));
+    
+    m_blocks.clear();
+    m_blocks.reserve(children.size());
+    for (auto& child : children) m_blocks.push_back(child.get());
+    
+    m_lastChange = {firstBlock, removedBlocks, fresh.size()};
+    m_segments = std::move(segments);
+    m_source = markdown;
 }
 
 void MarkdownDocument::clear() {
     m_root.children.clear();
     m_root.inlineContent.clear();
     m_blocks.clear();
+    m_segments.clear();
+    m_source.clear();
+    m_lastChange = {};
     m_sourceHash = 0;
     m_dirty = true;
 }
@@ -1,7 +1,9 @@
 #include <Editors/Markdown/MarkdownPreview.hpp>
+#include <Editors/Markdown/DocumentCache.hpp>
 #include <Editors/Markdown/Effect.hpp>
 #include <Editors/Markdown/Effects/BloodEffect.hpp>
 #include <OpenCLContext.hpp>
+#include <WorldMaps/World/Projections/ProjectionUpload.hpp>
 #include <LoreBook_Resources/LoreBook_ResourcesEmbeddedVFS.hpp>
 #include <LuaScriptManager.hpp>
 #include <LuaEngine.hpp>
@@ -22,21 +24,28 @@ namespace Markdown {
 // Static member definition
 std::unordered_map<std::string, MarkdownPreview::CachedWorldState> MarkdownPreview::s_worldCache;
 std::unordered_map<std::string, MarkdownPreview::CachedOrbitalState> MarkdownPreview::s_orbitalCache;
+MarkdownPreview::EmbedCacheStats MarkdownPreview::s_worldCacheStats = {0, 8};
+MarkdownPreview::EmbedCacheStats MarkdownPreview::s_orbitalCacheStats = {0, 8};
+std::unordered_map<std::string, MarkdownPreview::ParkedWorldView> MarkdownPreview::s_parkedWorldViews;
+std::unordered_map<std::string, MarkdownPreview::ParkedOrbitalView> MarkdownPreview::s_parkedOrbitalViews;
+std::unordered_map<std::string, MarkdownPreview::ResidentImage> MarkdownPreview::s_residentImages;
+std::unordered_set<int64_t> MarkdownPreview::s_pendingImageLoads;
+size_t MarkdownPreview::s_residentImageBytes = 0;
+size_t MarkdownPreview::s_imageBudgetBytes = size_t(256) << 20;
 
 // ────────────────────────────────────────────────────────────────────
 // Collision shader sources
 // ────────────────────────────────────────────────────────────────────
 
+// Glyph vertex shaders (collision, bloom glow) are bodies: compiled after the version line
+// and GlyphStore::vertexInputsGLSL()
 static const char* s_collisionVert = R"(
-#version 330 core
-layout(location = 0) in vec3 in_pos;
-layout(location = 1) in vec2 in_uv;
-
 uniform mat4 uMVP;
 
 out vec2 v_uv;
 
 void main() {
+    expandGlyphInstance();
     gl_Position = uMVP * vec4(in_pos, 1.0);
     v_uv = in_uv;
 }
@@ -183,20 +192,16 @@ void main() {
 
 // Renders glyph as a bright white silhouette tinted with glow color
 static const char* s_bloomGlowVert = R"(
-#version 330 core
-layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec2 aUV;
-layout(location = 2) in vec4 aColor;
-
 uniform mat4 uMVP;
 
 out vec2 v_uv;
 out vec4 v_color;
 
 void main() {
-    gl_Position = uMVP * vec4(aPos, 1.0);
-    v_uv = aUV;
-    v_color = aColor;
+    expandGlyphInstance();
+    gl_Position = uMVP * vec4(in_pos, 1.0);
+    v_uv = in_uv;
+    v_color = in_color;
 }
 )";
 
@@ -288,231 +293,6 @@ void main() {
 }
 )";
 
-// ────────────────────────────────────────────────────────────────────
-// SPH Fluid Simulation kernel (OpenCL) — with spatial hash grid
-// ────────────────────────────────────────────────────────────────────
-
-static const char* s_sphKernelSource = R"(
-#include "common.cl"
-
-// Small struct to hold per-behavior SPH parameters
-typedef struct {
-    float smoothingRadius;
-    float restDensity;
-    float stiffness;
-    float viscosity;
-    float cohesion;
-    float particleMass;
-} SPHParams;
-
-// ═══════════════════════════════════════════════════════════════════
-// Spatial Hash Grid — O(N) neighbor lookup
-// ═══════════════════════════════════════════════════════════════════
-// Grid maps 2D space into cells of size = smoothingRadius.
-// Each cell stores a range [start, start+count) into a sorted
-// particle entry array.  Building the grid is done on CPU (simple
-// for <1000 particles); kernels only read it.
-
-// Grid cell: (start, count) packed as uint2
-// gridEntries[]: particle indices sorted by cell
-
-// Hash a 2D cell coordinate to a flat index with wrapping
-uint cellHash(int cx, int cy, uint tableSize) {
-    // Simple spatial hash (prime mixing)
-    uint h = (uint)((cx * 92837111) ^ (cy * 689287499));
-    return h % tableSize;
-}
-
-// ── SPH kernel functions ──
-
-float poly6_2d(float r2, float h2) {
-    if (r2 >= h2) return 0.0f;
-    float diff = h2 - r2;
-    return diff * diff * diff;
-}
-
-float2 spikyGrad_2d(float2 rij, float r, float h) {
-    if (r >= h || r < 0.001f) return (float2)(0.0f, 0.0f);
-    float diff = h - r;
-    return (diff * diff) * (rij / r);
-}
-
-float viscLaplacian_2d(float r, float h) {
-    if (r >= h) return 0.0f;
-    return (h - r);
-}
-
-// ── Pass 1: Compute density + pressure using spatial hash ──
-__kernel void sphDensityPressure(
-    __global Particle* particles,
-    __global float* density,
-    __global float* pressure,
-    __global const uint2* grid,        // [tableSize] cells: (start, count)
-    __global const uint* gridEntries,  // sorted particle indices
-    const uint count,
-    const uint tableSize,
-    __constant int* isFluid,           // per-behavior flags
-    __constant SPHParams* sphParams,
-    const uint maxBehaviors,
-    const int mixingEnabled
-) {
-    uint i = get_global_id(0);
-    if (i >= count) return;
-
-    Particle pi = particles[i];
-    uint bid = pi.behaviorID;
-    if (pi.life <= 0.0f || bid >= maxBehaviors || !isFluid[bid]) {
-        density[i] = 0.0f;
-        pressure[i] = 0.0f;
-        return;
-    }
-
-    SPHParams sp = sphParams[bid];
-    float h = sp.smoothingRadius;
-    float h2 = h * h;
-    float poly6Norm = 4.0f / (M_PI_F * pown(h, 8));
-    float rho = 0.0f;
-    float particleMass = sp.particleMass;
-    float restDensity = sp.restDensity;
-    float stiffness = sp.stiffness;
-
-    // Grid cell of this particle
-    int cx = (int)floor(pi.pos.x / h);
-    int cy = (int)floor(pi.pos.y / h);
-
-    // Search 3x3 neighborhood
-    for (int dx = -1; dx <= 1; ++dx) {
-        for (int dy = -1; dy <= 1; ++dy) {
-            uint ch = cellHash(cx + dx, cy + dy, tableSize);
-            uint2 cell = grid[ch];
-            uint start = cell.x;
-            uint cellCount = cell.y;
-            for (uint k = 0; k < cellCount; ++k) {
-                uint j = gridEntries[start + k];
-                if (j >= count) continue;
-                Particle pj = particles[j];
-                if (pj.life <= 0.0f) continue;
-                if (pj.behaviorID != bid && !mixingEnabled) continue;
-
-                // Use particle mass from pj's behavior when mixing, otherwise pi's mass
-                float pmass_j = particleMass;
-                if (pj.behaviorID < maxBehaviors) pmass_j = sphParams[pj.behaviorID].particleMass;
-
-                float2 rij = pi.pos - pj.pos;
-                float r2 = dot(rij, rij);
-                rho += pmass_j * poly6Norm * poly6_2d(r2, h2);
-            }
-        }
-    }
-
-    density[i] = rho;
-    pressure[i] = max(stiffness * (rho - restDensity), 0.0f);
-}
-
-// ── Pass 2: Pressure + viscosity + cohesion forces ──
-__kernel void sphForces(
-    __global Particle* particles,
-    __global const float* density,
-    __global const float* pressure,
-    __global const uint2* grid,
-    __global const uint* gridEntries,
-    const float deltaTime,
-    const uint count,
-    const uint tableSize,
-    __constant int* isFluid,
-    __constant SPHParams* sphParams,
-    const uint maxBehaviors,
-    const int mixingEnabled
-) {
-    uint i = get_global_id(0);
-    if (i >= count) return;
-
-    Particle pi = particles[i];
-    uint bid = pi.behaviorID;
-    if (pi.life <= 0.0f || bid >= maxBehaviors || !isFluid[bid]) return;
-
-    float rho_i = density[i];
-    if (rho_i < 0.0001f) return;
-
-    float p_i = pressure[i];
-    SPHParams sp = sphParams[bid];
-    float h = sp.smoothingRadius;
-    float h2 = h * h;
-    float viscosity = sp.viscosity;
-    float cohesionStrength = sp.cohesion;
-    float particleMass = sp.particleMass;
-
-    float spikyNorm = -30.0f / (M_PI_F * pown(h, 5));
-    float viscNorm = 20.0f / (3.0f * M_PI_F * pown(h, 5));
-    float poly6Norm = 4.0f / (M_PI_F * pown(h, 8));
-
-    float2 fPressure = (float2)(0.0f);
-    float2 fViscosity = (float2)(0.0f);
-    float2 fCohesion = (float2)(0.0f);
-
-    int cx = (int)floor(pi.pos.x / h);
-    int cy = (int)floor(pi.pos.y / h);
-
-    for (int ddx = -1; ddx <= 1; ++ddx) {
-        for (int ddy = -1; ddy <= 1; ++ddy) {
-            uint ch = cellHash(cx + ddx, cy + ddy, tableSize);
-            uint2 cell = grid[ch];
-            uint start = cell.x;
-            uint cellCount = cell.y;
-            for (uint k = 0; k < cellCount; ++k) {
-                uint j = gridEntries[start + k];
-                if (j == i || j >= count) continue;
-                Particle pj = particles[j];
-                if (pj.life <= 0.0f) continue;
-                if (pj.behaviorID != bid && !mixingEnabled) continue;
-
-                float rho_j = density[j];
-                if (rho_j < 0.0001f) continue;
-                float p_j = pressure[j];
-
-                float2 rij = pi.pos - pj.pos;
-                float r2 = dot(rij, rij);
-                if (r2 >= h2) continue;
-                float r = sqrt(r2);
-
-                // Pressure force (symmetric). Use pj particle mass for scaling when mixing
-                float pmass_j = particleMass;
-                if (pj.behaviorID < maxBehaviors) pmass_j = sphParams[pj.behaviorID].particleMass;
-                float2 pGrad = spikyNorm * spikyGrad_2d(rij, r, h);
-                fPressure -= pmass_j * (p_i / (rho_i * rho_i) + p_j / (rho_j * rho_j)) * pGrad;
-
-                // Viscosity force (use averaged viscosity when mixing)
-                float vLap = viscNorm * viscLaplacian_2d(r, h);
-                float visPair = viscosity;
-                if (pj.behaviorID < maxBehaviors) visPair = 0.5f * (viscosity + sphParams[pj.behaviorID].viscosity);
-                fViscosity += pmass_j * (pj.vel - pi.vel) / rho_j * vLap * visPair;
-
-                // Cohesion (surface tension) - averaged when mixing
-                if (r > 0.001f) {
-                    float w = poly6Norm * poly6_2d(r2, h2);
-                    float coh = cohesionStrength;
-                    if (pj.behaviorID < maxBehaviors) coh = 0.5f * (cohesionStrength + sphParams[pj.behaviorID].cohesion);
-                    fCohesion -= coh * pmass_j * (rij / r) * w;
-                }
-            }
-        }
-    }
-
-    // Note: fViscosity already multiplied by pairwise viscosity above
-
-    float2 accel = (fPressure + fViscosity + fCohesion) / rho_i;
-
-    // Stability clamp
-    float accelLen = length(accel);
-    if (accelLen > 800.0f) {
-        accel = accel / accelLen * 800.0f;
-    }
-
-    pi.vel += accel * deltaTime;
-    particles[i] = pi;
-}
-)";
-
 // ────────────────────────────────────────────────────────────────────
 // Blood fluid post-process shader (density field → fluid surface)
 // ────────────────────────────────────────────────────────────────────
@@ -663,14 +443,7 @@ void MarkdownPreview::cleanup() {
         glDeleteProgram(m_particleShader);
         m_particleShader = 0;
     }
-    if (m_glyphVAO) {
-        glDeleteVertexArrays(1, &m_glyphVAO);
-        m_glyphVAO = 0;
-    }
-    if (m_glyphVBO) {
-        glDeleteBuffers(1, &m_glyphVBO);
-        m_glyphVBO = 0;
-    }
+    m_glyphStore.cleanup();
     if (m_particleVAO) {
         glDeleteVertexArrays(1, &m_particleVAO);
         m_particleVAO = 0;
@@ -708,17 +481,7 @@ void MarkdownPreview::cleanup() {
     if (m_quadVBO) { glDeleteBuffers(1, &m_quadVBO); m_quadVBO = 0; }
     
     // Cleanup SPH fluid resources
-    if (m_sphDensityKernel) { clReleaseKernel(m_sphDensityKernel); m_sphDensityKernel = nullptr; }
-    if (m_sphForcesKernel) { clReleaseKernel(m_sphForcesKernel); m_sphForcesKernel = nullptr; }
-    if (m_sphProgram) { clReleaseProgram(m_sphProgram); m_sphProgram = nullptr; }
-    if (m_clSPHDensity) { OpenCLContext::get().releaseMem(m_clSPHDensity); m_clSPHDensity = nullptr; }
-    if (m_clSPHPressure) { OpenCLContext::get().releaseMem(m_clSPHPressure); m_clSPHPressure = nullptr; }
-    if (m_clSPHGrid) { OpenCLContext::get().releaseMem(m_clSPHGrid); m_clSPHGrid = nullptr; }
-    if (m_clSPHGridEntries) { OpenCLContext::get().releaseMem(m_clSPHGridEntries); m_clSPHGridEntries = nullptr; }
-
-    // Release per-behavior SPH CL buffers
-    if (m_clSPHBehaviourFlags) { OpenCLContext::get().releaseMem(m_clSPHBehaviourFlags); m_clSPHBehaviourFlags = nullptr; }
-    if (m_clSPHParams) { OpenCLContext::get().releaseMem(m_clSPHParams); m_clSPHParams = nullptr; }
+    m_fluidSolver.cleanup();
 
     // Delete per-behavior GL density textures/FBOs
     for (size_t bi = 0; bi < MAX_FLUID_BEHAVIORS; ++bi) {
@@ -768,11 +531,11 @@ static bool parseHexColor(const std::string& hex, glm::vec4& out) {
 }
 
 void MarkdownPreview::setSource(const std::string& markdown) {
-    static std::string s_lastRawSource;
-    if (markdown == s_lastRawSource) return;
-    s_lastRawSource = markdown;
-    
-    m_document.markDirty();
+    // Callers pass the editor text every frame; only a change does work.
+    // Compared byte for byte (length first), as a hash alone could drop an edit.
+    if (m_hasSource && markdown == m_rawSource) return;
+    m_rawSource = markdown;
+    m_hasSource = true;
     
     // Parse YAML-like frontmatter for preview metadata
     // Format: lines between opening "---" and closing "---"
@@ -813,13 +576,18 @@ void MarkdownPreview::setSource(const std::string& markdown) {
         }
     }
     m_sourceText = body;
+    m_document = DocumentCache::get().acquire(m_sourceText, m_document);
 }
 
 void MarkdownPreview::initShaders() {
+    const std::string glyphVertPrefix = std::string("#version 330 core\n") + GlyphStore::vertexInputsGLSL();
+    
     // Compile collision shader
     {
+        std::string vertSrc = glyphVertPrefix + s_collisionVert;
+        const char* vert = vertSrc.c_str();
         GLuint vs = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vs, 1, &s_collisionVert, nullptr);
+        glShaderSource(vs, 1, &vert, nullptr);
         glCompileShader(vs);
         
         GLuint fs = glCreateShader(GL_FRAGMENT_SHADER);
@@ -881,8 +649,10 @@ void MarkdownPreview::initShaders() {
     
     // Compile bloom glow shader (renders glyph silhouettes for bloom source)
     {
+        std::string vertSrc = glyphVertPrefix + s_bloomGlowVert;
+        const char* vert = vertSrc.c_str();
         GLuint vs = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vs, 1, &s_bloomGlowVert, nullptr);
+        glShaderSource(vs, 1, &vert, nullptr);
         glCompileShader(vs);
         
         GLuint fs = glCreateShader(GL_FRAGMENT_SHADER);
@@ -988,28 +758,8 @@ void MarkdownPreview::initShaders() {
 }
 
 void MarkdownPreview::initVAOs() {
-    // Glyph VAO
-    glGenVertexArrays(1, &m_glyphVAO);
-    glGenBuffers(1, &m_glyphVBO);
-    
-    glBindVertexArray(m_glyphVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_glyphVBO);
-    
-    // GlyphVertex layout: pos(3), uv(2), color(4), effectID(1), pad(3)
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(GlyphVertex),
-                          (void*)offsetof(GlyphVertex, pos));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(GlyphVertex),
-                          (void*)offsetof(GlyphVertex, uv));
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphVertex),
-                          (void*)offsetof(GlyphVertex, color));
-    glEnableVertexAttribArray(3);
-    glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(GlyphVertex),
-                           (void*)offsetof(GlyphVertex, effectID));
-    
-    glBindVertexArray(0);
+    // Glyph instances
+    m_glyphStore.init();
     
     // Particle VAO
     glGenVertexArrays(1, &m_particleVAO);
@@ -1048,6 +798,10 @@ void MarkdownPreview::updateCollisionCLImage() {
     if (!OpenCLContext::get().isReady()) return;
     if (!m_collisionMask.hasCPUData() || m_collisionMask.getWidth() <= 0) return;
     
+    // Upload only when a new readback arrived
+    if (m_clCollisionImage && m_clCollisionGeneration == m_collisionMask.getCPUDataGeneration()) return;
+    m_clCollisionGeneration = m_collisionMask.getCPUDataGeneration();
+    
     int w = m_collisionMask.getWidth();
     int h = m_collisionMask.getHeight();
     
@@ -1107,14 +861,19 @@ void MarkdownPreview::initParticleSystem() {
     m_cpuParticles.resize(MAX_PARTICLES);
     m_cpuDeadIndices.resize(MAX_PARTICLES);
     
-    // Initially, all particles are dead
+    // Initially, all particles are dead.  The free list is a stack popped
+    // from the end, so it holds indices in reverse: low slots are handed
+    // out first and m_particleCount (the range updated and uploaded each
+    // frame) stays near the live count instead of the capacity.
     for (size_t i = 0; i < MAX_PARTICLES; ++i) {
         m_cpuParticles[i].life = 0.0f;
         m_cpuParticles[i].maxLife = -1.0f;  // sentinel: already in dead list
-        m_cpuDeadIndices[i] = static_cast<uint32_t>(i);
+        m_cpuDeadIndices[i] = static_cast<uint32_t>(MAX_PARTICLES - 1 - i);
     }
     m_deadCount = static_cast<uint32_t>(MAX_PARTICLES);
     m_particleCount = 0;
+    m_liveParticles = 0;
+    m_liveByBehavior.fill(0);
     
     // OpenCL buffer is optional
     if (!OpenCLContext::get().isReady()) return;
@@ -1131,82 +890,7 @@ void MarkdownPreview::initParticleSystem() {
         m_clParticleBuffer = nullptr;
     }
     
-    initSPH();
-}
-
-void MarkdownPreview::initSPH() {
-    auto& cl = OpenCLContext::get();
-    if (!cl.isReady()) return;
-    
-    // Load common.cl for #include replacement
-    std::string commonCL = loadLoreBook_ResourcesEmbeddedFileAsString("Kernels/particles/common.cl");
-    
-    // Replace #include with actual common.cl content
-    std::string fullSource = s_sphKernelSource;
-    size_t includePos = fullSource.find("#include \"common.cl\"");
-    if (includePos != std::string::npos) {
-        fullSource.replace(includePos, 20, commonCL);
-    }
-    
-    const char* src = fullSource.c_str();
-    size_t len = fullSource.size();
-    cl_int err;
-    
-    m_sphProgram = clCreateProgramWithSource(cl.getContext(), 1, &src, &len, &err);
-    if (err != CL_SUCCESS) {
-        PLOG_ERROR << "SPH: clCreateProgramWithSource failed: " << err;
-        return;
-    }
-    
-    cl_device_id dev = cl.getDevice();
-    err = clBuildProgram(m_sphProgram, 1, &dev, "-cl-fast-relaxed-math", nullptr, nullptr);
-    if (err != CL_SUCCESS) {
-        size_t logSize;
-        clGetProgramBuildInfo(m_sphProgram, dev, CL_PROGRAM_BUILD_LOG, 0, nullptr, &logSize);
-        std::string log(logSize, '\0');
-        clGetProgramBuildInfo(m_sphProgram, dev, CL_PROGRAM_BUILD_LOG, logSize, &log[0], nullptr);
-        PLOG_ERROR << "SPH kernel build failed: " << log;
-        clReleaseProgram(m_sphProgram);
-        m_sphProgram = nullptr;
-        return;
-    }
-    
-    m_sphDensityKernel = clCreateKernel(m_sphProgram, "sphDensityPressure", &err);
-    if (err != CL_SUCCESS) {
-        PLOG_ERROR << "SPH density kernel failed: " << err;
-        m_sphDensityKernel = nullptr;
-    }
-    
-    m_sphForcesKernel = clCreateKernel(m_sphProgram, "sphForces", &err);
-    if (err != CL_SUCCESS) {
-        PLOG_ERROR << "SPH forces kernel failed: " << err;
-        m_sphForcesKernel = nullptr;
-    }
-    
-    // Allocate density/pressure buffers
-    m_clSPHDensity = cl.createBuffer(CL_MEM_READ_WRITE, MAX_PARTICLES * sizeof(float),
-                                      nullptr, &err, "SPH density");
-    m_clSPHPressure = cl.createBuffer(CL_MEM_READ_WRITE, MAX_PARTICLES * sizeof(float),
-                                       nullptr, &err, "SPH pressure");
-    
-    // Grid buffers — table size is a prime that accommodates sparse spatial cells
-    constexpr uint32_t SPH_GRID_TABLE_SIZE = 4099;
-    m_clSPHGrid = cl.createBuffer(CL_MEM_READ_WRITE,
-                                   SPH_GRID_TABLE_SIZE * sizeof(cl_uint2),
-                                   nullptr, &err, "SPH grid");
-    m_clSPHGridEntries = cl.createBuffer(CL_MEM_READ_WRITE,
-                                          MAX_PARTICLES * sizeof(cl_uint),
-                                          nullptr, &err, "SPH grid entries");
-
-    // Per-behavior flags + params (host → CL)
-    m_clSPHBehaviourFlags = cl.createBuffer(CL_MEM_READ_ONLY,
-                                            MAX_FLUID_BEHAVIORS * sizeof(cl_int),
-                                            nullptr, &err, "SPH behavior flags");
-    m_clSPHParams = cl.createBuffer(CL_MEM_READ_ONLY,
-                                    MAX_FLUID_BEHAVIORS * sizeof(SPHParams),
-                                    nullptr, &err, "SPH params");
-    
-    PLOG_INFO << "SPH fluid simulation initialized (grid table size: " << SPH_GRID_TABLE_SIZE << ")";
+    m_fluidSolver.init(MAX_PARTICLES);
 }
 
 void MarkdownPreview::ensureFBO(int width, int height) {
@@ -1331,6 +1015,7 @@ void MarkdownPreview::ensureFBO(int width, int height) {
     m_collisionMask.resize(
         static_cast<int>(allocWidth * COLLISION_SCALE),
         static_cast<int>(allocHeight * COLLISION_SCALE));
+    m_collisionMaskDirty = true;
     
     // ── Blood fluid density FBO (full res, R16F for density accumulation) ──
     // Clean legacy blood FBO
@@ -1432,23 +1117,27 @@ ImVec2 MarkdownPreview::render() {
     }
     
     // 1. Parse if dirty
-    if (m_document.isDirty()) {
-        m_document.parseString(m_sourceText);
+    if (m_document->isDirty()) {
+        m_document->parseString(m_sourceText);
     }
     
-    // 2. Layout
+    // 2. Layout (only the blocks around the view; the rest stay cached)
     m_layoutGlyphs.clear();
     m_overlayWidgets.clear();
-    m_layoutEngine.layout(m_document, avail.x, m_layoutGlyphs, m_overlayWidgets);
+    m_layoutEngine.layout(*m_document, avail.x, m_layoutGlyphs, m_overlayWidgets,
+                          m_scrollY, m_scrollY + avail.y);
+    m_scrollY += m_layoutEngine.getScrollAdjustment();
+    m_viewHeight = avail.y;
     
     // Clamp scroll to content bounds
     float contentHeight = m_layoutEngine.getContentHeight();
     float maxScroll = std::max(0.0f, contentHeight - avail.y);
     m_scrollY = std::clamp(m_scrollY, 0.0f, maxScroll);
     
-    // 3. Batch glyphs by effect
-    std::vector<EffectBatch> batches;
-    m_effectSystem.buildBatches(m_layoutGlyphs, batches);
+    // 3. Sync the retained glyph instances (uploads only blocks that changed)
+    if (m_glyphStore.update(m_layoutGlyphs, m_layoutEngine.getEmittedBlocks()))
+        m_collisionMaskDirty = true;
+    const std::vector<EffectBatch>& batches = m_glyphStore.getBatches();
     
     // 4. Resize FBOs if needed
     ensureFBO(static_cast<int>(avail.x), static_cast<int>(avail.y));
@@ -1477,9 +1166,16 @@ ImVec2 MarkdownPreview::render() {
     glGetIntegerv(GL_BLEND_SRC_RGB, &prevBlendSrcRGB);
     glGetIntegerv(GL_BLEND_DST_RGB, &prevBlendDstRGB);
     
-    // 6. Render collision mask
-    renderCollisionMask(batches);
-    m_collisionMask.readback();
+    // 6. Render collision mask when the glyphs or the view changed.  The
+    //    CPU copy arrives asynchronously a frame or two later.
+    m_collisionMask.pollReadback();
+    if (m_scrollY != m_collisionMaskScrollY) m_collisionMaskDirty = true;
+    if (m_collisionMaskDirty) {
+        renderCollisionMask(batches);
+        m_collisionMaskScrollY = m_scrollY;
+        // Stay dirty until a readback of this state is queued
+        m_collisionMaskDirty = !m_collisionMask.requestReadback(m_scrollY);
+    }
     
     // 7. Setup 2.5D camera – compute Z so viewport dimensions match layout at Z=0
     float aspect = avail.x / avail.y;
@@ -1578,7 +1274,7 @@ ImVec2 MarkdownPreview::render() {
 }
 
 void MarkdownPreview::renderCollisionMask(const std::vector<EffectBatch>& batches) {
-    if (!m_collisionShader || !m_glyphVAO || !m_glyphVBO) return;
+    if (!m_collisionShader) return;
     
     // Refresh font atlas texture ID from ImGui (it may have been rebuilt)
     m_fontAtlasTexture = (GLuint)(intptr_t)ImGui::GetIO().Fonts->TexID;
@@ -1615,13 +1311,10 @@ void MarkdownPreview::renderCollisionMask(const std::vector<EffectBatch>& batche
     glUniform1i(glGetUniformLocation(m_collisionShader, "uFontAtlas"), 0);
     
     // Render all glyphs (we just need their alpha)
-    int totalVerts = 0;
+    int totalGlyphs = 0;
     for (const auto& batch : batches) {
-        if (batch.vertices.empty()) continue;
-        uploadGlyphBatch(batch.vertices);
-        glBindVertexArray(m_glyphVAO);
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(batch.vertices.size()));
-        totalVerts += static_cast<int>(batch.vertices.size());
+        m_glyphStore.draw(batch);
+        totalGlyphs += static_cast<int>(batch.instanceCount);
     }
     
     // ── One-time diagnostic ──
@@ -1636,7 +1329,7 @@ void MarkdownPreview::renderCollisionMask(const std::vector<EffectBatch>& batche
             uint8_t afterDrawPixel = 0;
             glReadPixels(cx, cy, 1, 1, GL_RED, GL_UNSIGNED_BYTE, &afterDrawPixel);
             PLOG_INFO << "[CollMaskDiag] pixel after draws=" << (int)afterDrawPixel
-                      << " totalVerts=" << totalVerts
+                      << " totalGlyphs=" << totalGlyphs
                       << " batches=" << batches.size()
                       << " fboW=" << m_fboWidth << " fboH=" << m_fboHeight;
         }
@@ -1646,15 +1339,13 @@ void MarkdownPreview::renderCollisionMask(const std::vector<EffectBatch>& batche
 }
 
 void MarkdownPreview::renderGlyphBatches(const std::vector<EffectBatch>& batches, const glm::mat4& mvp) {
-    if (!m_glyphVAO || !m_glyphVBO) return;
-    
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_fontAtlasTexture);
     
     float time = static_cast<float>(glfwGetTime());
     
     for (const auto& batch : batches) {
-        if (batch.vertices.empty()) continue;
+        if (batch.instanceCount == 0) continue;
         
         GLuint shader = m_effectSystem.getGlyphShader(batch.effect);
         if (!shader) continue;
@@ -1665,19 +1356,10 @@ void MarkdownPreview::renderGlyphBatches(const std::vector<EffectBatch>& batches
         
         m_effectSystem.uploadEffectUniforms(shader, batch.effect, time);
         
-        uploadGlyphBatch(batch.vertices);
-        glBindVertexArray(m_glyphVAO);
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(batch.vertices.size()));
+        m_glyphStore.draw(batch);
     }
 }
 
-void MarkdownPreview::uploadGlyphBatch(const std::vector<GlyphVertex>& vertices) {
-    if (vertices.empty() || !m_glyphVBO) return;
-    glBindBuffer(GL_ARRAY_BUFFER, m_glyphVBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GlyphVertex),
-                 vertices.data(), GL_DYNAMIC_DRAW);
-}
-
 void MarkdownPreview::renderGlowBloom(const std::vector<EffectBatch>& batches, const glm::mat4& mvp) {
     if (!m_bloomGlowShader || !m_bloomBlurShader || !m_bloomCompositeShader ||
         !m_bloomSrcFBO || !m_quadVAO || m_fboWidth <= 0 || m_fboHeight <= 0) {
@@ -1723,7 +1405,7 @@ void MarkdownPreview::renderGlowBloom(const std::vector<EffectBatch>& batches, c
     glBindTexture(GL_TEXTURE_2D, m_fontAtlasTexture);
     
     for (const auto& batch : batches) {
-        if (!batch.effect || batch.vertices.empty()) continue;
+        if (!batch.effect || batch.instanceCount == 0) continue;
         
         // Find the bloom-contributing effect: check bloomEffect, then stack, then primary
         Effect* bloomFx = batch.effect->bloomEffect;
@@ -1744,9 +1426,7 @@ void MarkdownPreview::renderGlowBloom(const std::vector<EffectBatch>& batches, c
         glUniform4fv(glGetUniformLocation(m_bloomGlowShader, "uColor1"), 1, &bloomFx->color1[0]);
         glUniform1f(glGetUniformLocation(m_bloomGlowShader, "uIntensity"), bloomFx->intensity);
         
-        uploadGlyphBatch(batch.vertices);
-        glBindVertexArray(m_glyphVAO);
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(batch.vertices.size()));
+        m_glyphStore.draw(batch);
     }
     
     // === Pass 2: Downsample bloom source to half-res ping texture ===
@@ -1823,24 +1503,16 @@ void MarkdownPreview::renderEmbeddedContent(const glm::mat4& mvp) {
     m_activeWorldMaps.clear();
     m_activeOrbitalViews.clear();
 
-    // Evict stale world cache entries
-    {
-        auto now = std::chrono::steady_clock::now();
-        for (auto it = s_worldCache.begin(); it != s_worldCache.end();) {
-            if (now - it->second.last_used > std::chrono::seconds(30))
-                it = s_worldCache.erase(it);
-            else
-                ++it;
-        }
-        for (auto it = s_orbitalCache.begin(); it != s_orbitalCache.end();) {
-            if (now - it->second.last_used > std::chrono::seconds(30)) {
-                if (it->second.texture) { glDeleteTextures(1, &it->second.texture); }
-                it = s_orbitalCache.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    evictEmbedCaches();
+
+    // Widgets come from the layout window, which reaches past the view.
+    // Simulated embeds outside the view are skipped entirely: they are
+    // neither ticked nor drawn, so they resume from the same state.
+    const float viewTop = m_scrollY;
+    const float viewBottom = m_scrollY + m_viewHeight;
+    auto inView = [&](const OverlayWidget& w) {
+        return w.docPos.y + w.size.y >= viewTop && w.docPos.y <= viewBottom;
+    };
 
     // Helper lambda: draw a textured quad in document space
     auto drawTexturedQuad = [&](GLuint texID, float x0, float y0, float displayW, float displayH,
@@ -1883,13 +1555,21 @@ void MarkdownPreview::renderEmbeddedContent(const glm::mat4& mvp) {
     };
 
     m_embedCounter = 0;
+    m_embedBlockId = 0;
     for (const auto& widget : m_overlayWidgets) {
         // ── Lua Canvas ───────────────────────────────────────────
         if (widget.type == OverlayWidget::LuaCanvas) {
             if (!m_scriptManager) continue;
 
+            // Numbered within the block so the ID doesn't depend on which
+            // other canvases happen to be in the layout window
+            if (widget.blockId != m_embedBlockId) {
+                m_embedBlockId = widget.blockId;
+                m_embedCounter = 0;
+            }
             const std::string& scriptName = widget.data;
-            std::string embedID = std::to_string(widget.sourceOffset) + ":" + std::to_string(++m_embedCounter);
+            std::string embedID = std::to_string(widget.blockId) + ":" + std::to_string(++m_embedCounter);
+            if (!inView(widget)) continue;
 
             LuaEngine* eng = m_scriptManager->getOrCreateEngine(scriptName, embedID, 0);
             if (!eng) continue;
@@ -1919,6 +1599,7 @@ void MarkdownPreview::renderEmbeddedContent(const glm::mat4& mvp) {
 
         // ── World Map ────────────────────────────────────────────
         if (widget.type == OverlayWidget::WorldMap) {
+            if (!inView(widget)) continue;
             std::vector<std::string> parts = splitBracketAware(widget.data, "/");
             if (parts.size() < 2) continue;
 
@@ -1928,8 +1609,23 @@ void MarkdownPreview::renderEmbeddedContent(const glm::mat4& mvp) {
             std::transform(projection.begin(), projection.end(), projection.begin(), ::tolower);
 
             // Get or create cached world + camera state
-            auto it = s_worldCache.try_emplace(worldName, config).first;
+            auto [it, created] = s_worldCache.try_emplace(worldName, config);
             CachedWorldState& cw = it->second;
+            ++(created ? s_worldCacheStats.misses : s_worldCacheStats.hits);
+            if (created) {
+                if (auto parked = s_parkedWorldViews.find(worldName); parked != s_parkedWorldViews.end()) {
+                    const ParkedWorldView& v = parked->second;
+                    cw.mercCenterLon = v.mercCenterLon;
+                    cw.mercCenterLat = v.mercCenterLat;
+                    cw.mercZoom = v.mercZoom;
+                    cw.globeCenterLon = v.globeCenterLon;
+                    cw.globeCenterLat = v.globeCenterLat;
+                    cw.globeZoom = v.globeZoom;
+                    cw.globeFovDeg = v.globeFovDeg;
+                    cw.selectedLayer = v.selectedLayer;
+                    s_parkedWorldViews.erase(parked);
+                }
+            }
             if (cw.config != config) {
                 try { cw.world.parseConfig(config); cw.config = config; }
                 catch (const std::exception& e) {
@@ -1937,6 +1633,7 @@ void MarkdownPreview::renderEmbeddedContent(const glm::mat4& mvp) {
                 }
             }
             cw.last_used = std::chrono::steady_clock::now();
+            cw.world.tick();
 
             // Determine which layer to render
             std::vector<std::string> layerNames = cw.world.getLayerNames();
@@ -2013,11 +1710,21 @@ void MarkdownPreview::renderEmbeddedContent(const glm::mat4& mvp) {
         // ── Orbital View ─────────────────────────────────────────
         if (widget.type == OverlayWidget::OrbitalView) {
             std::string systemName = widget.data;
-            if (systemName.empty()) continue;
+            if (systemName.empty() || !inView(widget)) continue;
 
             // Get or create cached orbital state
-            auto it = s_orbitalCache.try_emplace(systemName).first;
+            auto [it, created] = s_orbitalCache.try_emplace(systemName);
             CachedOrbitalState& co = it->second;
+            ++(created ? s_orbitalCacheStats.misses : s_orbitalCacheStats.hits);
+            if (created) {
+                if (auto parked = s_parkedOrbitalViews.find(systemName); parked != s_parkedOrbitalViews.end()) {
+                    co.time = parked->second.time;
+                    co.timeSpeed = parked->second.timeSpeed;
+                    co.playing = parked->second.playing;
+                    co.projection.setTime(co.time);
+                    s_parkedOrbitalViews.erase(parked);
+                }
+            }
             co.last_used = std::chrono::steady_clock::now();
 
             // Load system from vault if not yet loaded
@@ -2067,6 +1774,7 @@ void MarkdownPreview::renderEmbeddedContent(const glm::mat4& mvp) {
 
         // ── ModelViewer (embedded GLB/etc) ─────────────────────────
         if (widget.type == OverlayWidget::ModelViewer) {
+            if (!inView(widget)) continue;
             const std::string& src = widget.data;
             ModelViewer* mv = nullptr;
             if (m_vault) mv = m_vault->getOrCreateModelViewerForSrc(src);
@@ -2121,13 +1829,15 @@ void MarkdownPreview::renderEmbeddedContent(const glm::mat4& mvp) {
                         texID = cached.textureID;
                         texW = cached.width;
                         texH = cached.height;
+                        // Anywhere in the layout window counts as in use, so
+                        // images just past the view edge are not evicted
+                        touchResidentImage(key, aid, texW, texH);
                     } else {
                         // If DB blob is present, schedule a background read -> main-thread texture creation
                         auto meta = m_vault->getAttachmentMeta(aid);
                         if (meta.size > 0 && meta.mimeType.rfind("image/", 0) == 0) {
-                            static std::unordered_set<int64_t> s_pendingTextureLoads;
-                            if (s_pendingTextureLoads.find(aid) == s_pendingTextureLoads.end()) {
-                                s_pendingTextureLoads.insert(aid);
+                            if (s_pendingImageLoads.find(aid) == s_pendingImageLoads.end()) {
+                                s_pendingImageLoads.insert(aid);
                                 std::thread([vaultPtr = m_vault, aid, key]() {
                                     auto data = vaultPtr->getAttachmentData(aid);
                                     if (!data.empty()) {
@@ -2144,6 +1854,8 @@ void MarkdownPreview::renderEmbeddedContent(const glm::mat4& mvp) {
                 }
             }
 
+            if (!inView(widget)) continue;
+
             if (texID) {
                 float displayW = widget.size.x;
                 float displayH = widget.size.y;
@@ -2194,6 +1906,123 @@ void MarkdownPreview::renderEmbeddedContent(const glm::mat4& mvp) {
             continue;
         }
     }
+
+    evictResidentImages();
+}
+
+/// Evict entries of a world/orbital cache: any not drawn for `expiry`, then
+/// the least recently drawn beyond `stats.capacity`, sparing those drawn
+/// within `inUse`.  `release` parks an entry's view state and frees its textures.
+template <typename Cache, typename Release>
+static void evictEmbedCache(Cache& cache, MarkdownPreview::EmbedCacheStats& stats,
+                            std::chrono::seconds expiry, std::chrono::seconds inUse, Release&& release) {
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = cache.begin(); it != cache.end();) {
+        if (now - it->second.last_used > expiry) {
+            release(it->first, it->second);
+            it = cache.erase(it);
+            ++stats.evictions;
+        } else {
+            ++it;
+        }
+    }
+    while (cache.size() > stats.capacity) {
+        auto victim = cache.end();
+        for (auto it = cache.begin(); it != cache.end(); ++it) {
+            if (now - it->second.last_used < inUse) continue;
+            if (victim == cache.end() || it->second.last_used < victim->second.last_used) victim = it;
+        }
+        if (victim == cache.end()) break;  // everything is on screen
+        release(victim->first, victim->second);
+        cache.erase(victim);
+        ++stats.evictions;
+    }
+}
+
+/// Free an evicted embed's projection texture along with the upload state
+/// (PBOs, CL buffers, events) registered under its GL name.  Done here rather
+/// than in the cache entries' destructors: the caches are statics that
+/// outlive both the GL context and the upload registry.
+static void releaseEmbedTexture(GLuint& texture) {
+    if (!texture) return;
+    ProjectionUpload::release(texture);
+    glDeleteTextures(1, &texture);
+    texture = 0;
+}
+
+void MarkdownPreview::evictEmbedCaches() {
+    // Parked views are a few floats each; keep a bounded number of them
+    auto park = [](auto& parked, const std::string& key, auto view) {
+        if (parked.size() >= MAX_PARKED_VIEWS && !parked.count(key)) parked.erase(parked.begin());
+        parked[key] = view;
+    };
+    evictEmbedCache(s_worldCache, s_worldCacheStats, EMBED_EXPIRY, EMBED_IN_USE,
+                    [&](const std::string& name, CachedWorldState& cw) {
+        park(s_parkedWorldViews, name,
+             ParkedWorldView{cw.mercCenterLon, cw.mercCenterLat, cw.mercZoom,
+                             cw.globeCenterLon, cw.globeCenterLat, cw.globeZoom,
+                             cw.globeFovDeg, cw.selectedLayer});
+        releaseEmbedTexture(cw.mercTexture);
+        releaseEmbedTexture(cw.globeTexture);
+    });
+    evictEmbedCache(s_orbitalCache, s_orbitalCacheStats, EMBED_EXPIRY, EMBED_IN_USE,
+                    [&](const std::string& name, CachedOrbitalState& co) {
+        park(s_parkedOrbitalViews, name, ParkedOrbitalView{co.time, co.timeSpeed, co.playing});
+        releaseEmbedTexture(co.texture);
+    });
+}
+
+void MarkdownPreview::touchResidentImage(const std::string& key, int64_t aid, int width, int height) {
+    ResidentImage& r = s_residentImages[key];
+    if (r.bytes == 0) {
+        r.aid = aid;
+        r.bytes = static_cast<size_t>(std::max(width, 0)) * static_cast<size_t>(std::max(height, 0)) * 4;
+        s_residentImageBytes += r.bytes;
+    }
+    r.lastFrame = ImGui::GetFrameCount();
+}
+
+void MarkdownPreview::evictResidentImages() {
+    // Only images no preview has in its layout window this frame can go
+    const int frame = ImGui::GetFrameCount();
+    while (s_residentImageBytes > s_imageBudgetBytes) {
+        auto victim = s_residentImages.end();
+        for (auto it = s_residentImages.begin(); it != s_residentImages.end(); ++it) {
+            if (it->second.lastFrame >= frame) continue;
+            if (victim == s_residentImages.end() || it->second.lastFrame < victim->second.lastFrame)
+                victim = it;
+        }
+        if (victim == s_residentImages.end()) break;
+
+        PLOGV << "markdown: evicting image aid=" << victim->second.aid
+              << " (" << (victim->second.bytes >> 10) << " KiB)";
+        ReleaseDynamicTexture(victim->first);
+        // Let the next sighting schedule a fresh load
+        s_pendingImageLoads.erase(victim->second.aid);
+        s_residentImageBytes -= victim->second.bytes;
+        s_residentImages.erase(victim);
+    }
+}
+
+/// Max-min fair split of `budget` between behaviors asking for `demand`
+/// live particles each: demands under an equal share are met in full and
+/// what they leave is split between the rest.
+template <size_t N>
+static std::array<size_t, N> fairShares(const std::array<size_t, N>& demand, size_t budget) {
+    std::array<size_t, N> order;
+    size_t n = 0;
+    for (size_t b = 0; b < N; ++b)
+        if (demand[b] > 0) order[n++] = b;
+    std::sort(order.begin(), order.begin() + n,
+              [&](size_t a, size_t b) { return demand[a] < demand[b]; });
+
+    std::array<size_t, N> shares = {};
+    for (size_t k = 0; k < n; ++k) {
+        size_t b = order[k];
+        shares[b] = std::min(demand[b], budget / (n - k));
+        budget -= shares[b];
+    }
+    return shares;
 }
 
 void MarkdownPreview::emitParticles(float dt, const std::vector<EffectBatch>& batches) {
@@ -2202,6 +2031,29 @@ void MarkdownPreview::emitParticles(float dt, const std::vector<EffectBatch>& ba
         return;
     }
     
+    constexpr int MAX_EMIT_PER_BATCH = 4;  // particles per batch per frame
+    constexpr size_t BEHAVIORS = std::tuple_size_v<decltype(m_liveByBehavior)>;
+    auto batchBehavior = [](const EffectBatch& batch) {
+        uint32_t bid = batch.effect->effect ? batch.effect->effect->getBehaviorID() : 0;
+        return bid < BEHAVIORS ? bid : 0;
+    };
+
+    // Share the budget between the behaviors emitting this frame; live
+    // particles of the others still hold their part of it until they die
+    std::array<size_t, BEHAVIORS> demand = {};
+    for (const EffectBatch& batch : batches) {
+        if (!batch.effect || !batch.effect->hasParticles) continue;
+        uint32_t bid = batchBehavior(batch);
+        if (demand[bid] == 0) demand[bid] = m_liveByBehavior[bid];
+        demand[bid] += MAX_EMIT_PER_BATCH;
+    }
+    size_t shared = m_particleBudget;
+    for (size_t b = 0; b < BEHAVIORS; ++b)
+        if (demand[b] == 0) shared -= std::min<size_t>(shared, m_liveByBehavior[b]);
+    std::array<size_t, BEHAVIORS> allowance = fairShares(demand, shared);
+    for (size_t b = 0; b < BEHAVIORS; ++b)
+        allowance[b] = allowance[b] > m_liveByBehavior[b] ? allowance[b] - m_liveByBehavior[b] : 0;
+
     // Find effects that emit particles
     for (size_t batchIdx = 0; batchIdx < batches.size(); ++batchIdx) {
         const EffectBatch& batch = batches[batchIdx];
@@ -2211,8 +2063,7 @@ void MarkdownPreview::emitParticles(float dt, const std::vector<EffectBatch>& ba
         
         // Use behaviorID for accumulator index (stable across frames,
         // unlike batchIdx which depends on unordered_map iteration order)
-        uint32_t bid = batch.effect->effect ? batch.effect->effect->getBehaviorID() : 0;
-        if (bid >= 16) bid = 0;
+        uint32_t bid = batchBehavior(batch);
         
         // Accumulate emission time
         m_emitAccumulators[bid] += dt * emission.rate;
@@ -2221,16 +2072,30 @@ void MarkdownPreview::emitParticles(float dt, const std::vector<EffectBatch>& ba
         int toEmit = static_cast<int>(m_emitAccumulators[bid]);
         if (toEmit <= 0) continue;
         // Cap particles emitted per batch per frame
-        toEmit = std::min(toEmit, 4);
+        toEmit = std::min(toEmit, MAX_EMIT_PER_BATCH);
         m_emitAccumulators[bid] -= toEmit;
+        // Over its share of the budget the behavior waits for its own
+        // particles to die (the accumulator is drained, not banked)
+        toEmit = static_cast<int>(std::min<size_t>(toEmit, allowance[bid]));
+        if (toEmit <= 0) continue;
+        allowance[bid] -= toEmit;
+        
+        // Bounds of this effect batch for emission area
+        const glm::vec2 minPos = batch.boundsMin;
+        const glm::vec2 maxPos = batch.boundsMax;
         
-        // Calculate bounds of this effect batch for emission area
-        glm::vec2 minPos(FLT_MAX), maxPos(-FLT_MAX);
-        for (const auto& vert : batch.vertices) {
-            minPos.x = std::min(minPos.x, vert.pos.x);
-            minPos.y = std::min(minPos.y, vert.pos.y);
-            maxPos.x = std::max(maxPos.x, vert.pos.x);
-            maxPos.y = std::max(maxPos.y, vert.pos.y);
+        // Glyph-shaped emission: solid mask texels under the batch bounds
+        m_emitPoints.clear();
+        if (emission.shape == EmissionConfig::GlyphAlpha && m_collisionMask.hasCPUData() &&
+            m_fboWidth > 0 && m_fboHeight > 0) {
+            const float sx = static_cast<float>(m_collisionMask.getWidth()) / m_fboWidth;
+            const float sy = static_cast<float>(m_collisionMask.getHeight()) / m_fboHeight;
+            const float maskTop = m_collisionMask.getCPUDataOriginY() + m_fboHeight;  // doc y of mask row 0
+            m_collisionMask.getEmissionPoints(glm::vec2(minPos.x * sx, (maskTop - maxPos.y) * sy),
+                                              glm::vec2(maxPos.x * sx, (maskTop - minPos.y) * sy),
+                                              0.5f, m_emitPoints, toEmit);
+            for (glm::vec2& pt : m_emitPoints)
+                pt = glm::vec2((pt.x + 0.5f) / sx, maskTop - (pt.y + 0.5f) / sy);
         }
         
         // Emit from within the glyph region
@@ -2242,13 +2107,18 @@ void MarkdownPreview::emitParticles(float dt, const std::vector<EffectBatch>& ba
             
             Particle& p = m_cpuParticles[idx];
             
-            // Position: random within glyph bounds
-            float rx = static_cast<float>(rand()) / RAND_MAX;
-            float ry = static_cast<float>(rand()) / RAND_MAX;
-            p.pos = glm::vec2(
-                minPos.x + rx * (maxPos.x - minPos.x),
-                minPos.y + ry * (maxPos.y - minPos.y)
-            );
+            // Position: on a glyph when the mask has one in view, else
+            // random within the batch bounds
+            if (!m_emitPoints.empty()) {
+                p.pos = m_emitPoints[static_cast<size_t>(i) % m_emitPoints.size()];
+            } else {
+                float rx = static_cast<float>(rand()) / RAND_MAX;
+                float ry = static_cast<float>(rand()) / RAND_MAX;
+                p.pos = glm::vec2(
+                    minPos.x + rx * (maxPos.x - minPos.x),
+                    minPos.y + ry * (maxPos.y - minPos.y)
+                );
+            }
             
             // Add velocity variation
             float vx = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 2.0f;
@@ -2280,6 +2150,8 @@ void MarkdownPreview::emitParticles(float dt, const std::vector<EffectBatch>& ba
             }
             
             m_particleCount = std::max(m_particleCount, static_cast<size_t>(idx + 1));
+            ++m_liveByBehavior[bid];
+            ++m_liveParticles;
         }
     }
 }
@@ -2321,7 +2193,8 @@ void MarkdownPreview::updateParticlesGPU(float dt) {
     cl_command_queue q = cl.getQueue();
     uint32_t count = static_cast<uint32_t>(m_particleCount);
     size_t globalSize = m_particleCount;
-    float scrollY = m_scrollY;
+    // The CPU mask (and the CL image made from it) may be a frame behind
+    float scrollY = m_collisionMask.hasCPUData() ? m_collisionMask.getCPUDataOriginY() : m_scrollY;
     float maskH = static_cast<float>(m_collisionMask.getHeight());
     float time = static_cast<float>(glfwGetTime());
     
@@ -2356,10 +2229,9 @@ void MarkdownPreview::updateParticlesGPU(float dt) {
         maskH = 1.0f;
     }
     
-    // 2.5. Run SPH fluid passes for any registered fluid behaviors
-    if (m_sphDensityKernel && m_sphForcesKernel && m_clSPHDensity && m_clSPHPressure
-        && m_clSPHGrid && m_clSPHGridEntries && m_clSPHBehaviourFlags && m_clSPHParams) {
-
+    // 2.5. Run SPH fluid passes for any registered fluid behaviors.  The
+    // neighbour grid is built on the device from the buffer just uploaded.
+    if (m_fluidSolver.isReady()) {
         // Build per-behavior tables (isFluid + SPH params)
         std::array<int, MAX_FLUID_BEHAVIORS> isFluid = {};
         std::array<SPHParams, MAX_FLUID_BEHAVIORS> sphParams = {};
@@ -2372,121 +2244,15 @@ void MarkdownPreview::updateParticlesGPU(float dt) {
                 sphParams[bid] = def->effect->getSPHParams();
             }
         }
+        m_fluidSolver.setBehaviors(isFluid, sphParams);
 
-        // Quick check: any live particles belonging to a fluid behavior?
+        // Any live particles belonging to a fluid behavior?
         bool hasAnyFluid = false;
-        for (size_t i = 0; i < m_particleCount && !hasAnyFluid; ++i) {
-            const auto& p = m_cpuParticles[i];
-            if (p.life > 0 && p.behaviorID < MAX_FLUID_BEHAVIORS && isFluid[p.behaviorID]) hasAnyFluid = true;
-        }
-
-        if (hasAnyFluid) {
-            // Choose grid cell size as the maximum smoothing radius of active fluids
-            float gridCellSize = 0.0f;
-            for (size_t b = 0; b < MAX_FLUID_BEHAVIORS; ++b) {
-                if (isFluid[b]) gridCellSize = fmaxf(gridCellSize, sphParams[b].smoothingRadius);
-            }
-            if (gridCellSize <= 0.001f) gridCellSize = 5.0f; // fallback
-
-            // Build spatial hash grid on CPU (fast for <1000 particles)
-            constexpr uint32_t SPH_GRID_TABLE_SIZE = 4099;
-            auto sphCellHash = [](int cx, int cy, uint32_t tableSize) -> uint32_t {
-                uint32_t h = static_cast<uint32_t>((cx * 92837111) ^ (cy * 689287499));
-                return h % tableSize;
-            };
-
-            // Count particles per cell (include all fluid particles)
-            std::vector<uint32_t> cellCounts(SPH_GRID_TABLE_SIZE, 0);
-            for (size_t i = 0; i < m_particleCount; ++i) {
-                const auto& p = m_cpuParticles[i];
-                if (p.life <= 0) continue;
-                if (p.behaviorID >= MAX_FLUID_BEHAVIORS || !isFluid[p.behaviorID]) continue;
-                int cx = static_cast<int>(std::floor(p.pos.x / gridCellSize));
-                int cy = static_cast<int>(std::floor(p.pos.y / gridCellSize));
-                cellCounts[sphCellHash(cx, cy, SPH_GRID_TABLE_SIZE)]++;
-            }
-
-            // Prefix sum → cell start offsets
-            std::vector<cl_uint2> gridCells(SPH_GRID_TABLE_SIZE);
-            uint32_t runningOffset = 0;
-            for (uint32_t c = 0; c < SPH_GRID_TABLE_SIZE; ++c) {
-                gridCells[c] = {{runningOffset, cellCounts[c]}};
-                runningOffset += cellCounts[c];
-            }
+        for (size_t b = 0; b < MAX_FLUID_BEHAVIORS && !hasAnyFluid; ++b)
+            hasAnyFluid = isFluid[b] && m_liveByBehavior[b] > 0;
 
-            // Fill sorted entries
-            std::vector<cl_uint> gridEntries(runningOffset > 0 ? runningOffset : 1, 0);
-            std::vector<uint32_t> cellInsert(SPH_GRID_TABLE_SIZE, 0);
-            for (size_t i = 0; i < m_particleCount; ++i) {
-                const auto& p = m_cpuParticles[i];
-                if (p.life <= 0) continue;
-                if (p.behaviorID >= MAX_FLUID_BEHAVIORS || !isFluid[p.behaviorID]) continue;
-                int cx = static_cast<int>(std::floor(p.pos.x / gridCellSize));
-                int cy = static_cast<int>(std::floor(p.pos.y / gridCellSize));
-                uint32_t ch = sphCellHash(cx, cy, SPH_GRID_TABLE_SIZE);
-                uint32_t slot = gridCells[ch].s[0] + cellInsert[ch]++;
-                if (slot < gridEntries.size()) gridEntries[slot] = static_cast<cl_uint>(i);
-            }
-
-            // Upload grid + behavior tables to CL
-            clEnqueueWriteBuffer(q, m_clSPHGrid, CL_FALSE, 0,
-                                  SPH_GRID_TABLE_SIZE * sizeof(cl_uint2),
-                                  gridCells.data(), 0, nullptr, nullptr);
-            if (runningOffset > 0) {
-                clEnqueueWriteBuffer(q, m_clSPHGridEntries, CL_FALSE, 0,
-                                      runningOffset * sizeof(cl_uint),
-                                      gridEntries.data(), 0, nullptr, nullptr);
-            }
-
-            // Upload behavior flags & params
-            clEnqueueWriteBuffer(q, m_clSPHBehaviourFlags, CL_FALSE, 0,
-                                  MAX_FLUID_BEHAVIORS * sizeof(cl_int),
-                                  isFluid.data(), 0, nullptr, nullptr);
-            clEnqueueWriteBuffer(q, m_clSPHParams, CL_FALSE, 0,
-                                  MAX_FLUID_BEHAVIORS * sizeof(SPHParams),
-                                  sphParams.data(), 0, nullptr, nullptr);
-
-            uint32_t tableSize = SPH_GRID_TABLE_SIZE;
-            uint32_t maxBeh = static_cast<uint32_t>(MAX_FLUID_BEHAVIORS);
-
-            // Pass 1: density + pressure (new signature: behaviour flags + params)
-            clSetKernelArg(m_sphDensityKernel, 0, sizeof(cl_mem), &m_clParticleBuffer);
-            clSetKernelArg(m_sphDensityKernel, 1, sizeof(cl_mem), &m_clSPHDensity);
-            clSetKernelArg(m_sphDensityKernel, 2, sizeof(cl_mem), &m_clSPHPressure);
-            clSetKernelArg(m_sphDensityKernel, 3, sizeof(cl_mem), &m_clSPHGrid);
-            clSetKernelArg(m_sphDensityKernel, 4, sizeof(cl_mem), &m_clSPHGridEntries);
-            clSetKernelArg(m_sphDensityKernel, 5, sizeof(uint32_t), &count);
-            clSetKernelArg(m_sphDensityKernel, 6, sizeof(uint32_t), &tableSize);
-            clSetKernelArg(m_sphDensityKernel, 7, sizeof(cl_mem), &m_clSPHBehaviourFlags);
-            clSetKernelArg(m_sphDensityKernel, 8, sizeof(cl_mem), &m_clSPHParams);
-            clSetKernelArg(m_sphDensityKernel, 9, sizeof(uint32_t), &maxBeh);
-            int mixingFlag = m_sphAllowMixing ? 1 : 0;
-            clSetKernelArg(m_sphDensityKernel, 10, sizeof(int), &mixingFlag);
-            err = clEnqueueNDRangeKernel(q, m_sphDensityKernel, 1, nullptr, &globalSize,
-                                          nullptr, 0, nullptr, nullptr);
-            if (err != CL_SUCCESS) {
-                PLOG_ERROR << "SPH density kernel dispatch failed: " << err;
-            }
-
-            // Pass 2: forces (new signature)
-            clSetKernelArg(m_sphForcesKernel, 0, sizeof(cl_mem), &m_clParticleBuffer);
-            clSetKernelArg(m_sphForcesKernel, 1, sizeof(cl_mem), &m_clSPHDensity);
-            clSetKernelArg(m_sphForcesKernel, 2, sizeof(cl_mem), &m_clSPHPressure);
-            clSetKernelArg(m_sphForcesKernel, 3, sizeof(cl_mem), &m_clSPHGrid);
-            clSetKernelArg(m_sphForcesKernel, 4, sizeof(cl_mem), &m_clSPHGridEntries);
-            clSetKernelArg(m_sphForcesKernel, 5, sizeof(float), &dt);
-            clSetKernelArg(m_sphForcesKernel, 6, sizeof(uint32_t), &count);
-            clSetKernelArg(m_sphForcesKernel, 7, sizeof(uint32_t), &tableSize);
-            clSetKernelArg(m_sphForcesKernel, 8, sizeof(cl_mem), &m_clSPHBehaviourFlags);
-            clSetKernelArg(m_sphForcesKernel, 9, sizeof(cl_mem), &m_clSPHParams);
-            clSetKernelArg(m_sphForcesKernel, 10, sizeof(uint32_t), &maxBeh);
-            clSetKernelArg(m_sphForcesKernel, 11, sizeof(int), &mixingFlag);
-            err = clEnqueueNDRangeKernel(q, m_sphForcesKernel, 1, nullptr, &globalSize,
-                                          nullptr, 0, nullptr, nullptr);
-            if (err != CL_SUCCESS) {
-                PLOG_ERROR << "SPH forces kernel dispatch failed: " << err;
-            }
-        }
+        if (hasAnyFluid)
+            m_fluidSolver.step(q, m_clParticleBuffer, count, dt, m_sphAllowMixing);
     }
     
     // 3. Dispatch each Effect's particle kernel
@@ -2582,8 +2348,15 @@ void MarkdownPreview::updateParticlesGPU(float dt) {
         }
     }
     
-    // 5. Mark dead particles for recycling (only newly-dead, using maxLife sentinel)
+    // 5. Mark dead particles for recycling (only newly-dead, using maxLife sentinel).
+    //    Particles that drifted well outside the view are retired too: their
+    //    emitters are off-screen, and re-emit when they scroll back in.
+    const float cullTop = m_scrollY - PARTICLE_CULL_MARGIN;
+    const float cullBottom = m_scrollY + m_viewHeight + PARTICLE_CULL_MARGIN;
     for (size_t i = 0; i < m_particleCount && i < m_cpuParticles.size(); ++i) {
+        Particle& p = m_cpuParticles[i];
+        if (p.life > 0.0f && (p.pos.y < cullTop || p.pos.y > cullBottom))
+            p.life = 0.0f;
         if (m_cpuParticles[i].life <= 0.0f && m_cpuParticles[i].maxLife > 0.0f
             && m_deadCount < m_cpuDeadIndices.size()) {
             m_cpuDeadIndices[m_deadCount++] = static_cast<uint32_t>(i);
@@ -2591,12 +2364,17 @@ void MarkdownPreview::updateParticlesGPU(float dt) {
         }
     }
     
-    // 5b. Build per-behaviorID index groups for per-effect rendering
+    // 5b. Build per-behaviorID index groups for per-effect rendering, and
+    // the live counts the emission budget is shared by
     m_particleBehaviorGroups.clear();
+    m_liveByBehavior.fill(0);
+    m_liveParticles = 0;
     for (size_t i = 0; i < m_particleCount && i < m_cpuParticles.size(); ++i) {
         if (m_cpuParticles[i].life > 0.0f) {
-            m_particleBehaviorGroups[m_cpuParticles[i].behaviorID].push_back(
-                static_cast<uint32_t>(i));
+            uint32_t bid = m_cpuParticles[i].behaviorID;
+            m_particleBehaviorGroups[bid].push_back(static_cast<uint32_t>(i));
+            if (bid < m_liveByBehavior.size()) ++m_liveByBehavior[bid];
+            ++m_liveParticles;
         }
     }
     
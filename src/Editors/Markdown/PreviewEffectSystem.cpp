@@ -2,9 +2,12 @@
 #include <Editors/Markdown/Effect.hpp>
 #include <Editors/Markdown/Effects/AllEffects.hpp>
 #include <Editors/Markdown/ShaderCompositor.hpp>
+#include <Editors/Markdown/GlyphStore.hpp>
+#include <Editors/Markdown/ShaderProgramCache.hpp>
 #include <OpenCLContext.hpp>
 #include <LoreBook_Resources/LoreBook_ResourcesEmbeddedVFS.hpp>
 #include <plog/Log.h>
+#include <GLFW/glfw3.h>
 #include <algorithm>
 #include <sstream>
 
@@ -45,13 +48,8 @@ void EffectStack::clear() {
 // Base glyph shader (used when an Effect has no custom glyph shader)
 // ────────────────────────────────────────────────────────────────────
 
+// Body only: compiled after the version line and GlyphStore::vertexInputsGLSL()
 static const char* s_baseGlyphVert = R"(
-#version 330 core
-layout(location = 0) in vec3 in_pos;
-layout(location = 1) in vec2 in_uv;
-layout(location = 2) in vec4 in_color;
-layout(location = 3) in uint in_effectID;
-
 uniform mat4 uMVP;
 
 out vec2 v_uv;
@@ -60,6 +58,7 @@ out vec3 v_worldPos;
 flat out uint v_effectID;
 
 void main() {
+    expandGlyphInstance();
     gl_Position = uMVP * vec4(in_pos, 1.0);
     v_uv = in_uv;
     v_color = in_color;
@@ -102,7 +101,8 @@ bool PreviewEffectSystem::init(cl_context clContext, cl_device_id clDevice) {
     m_clDevice = clDevice;
     
     // Compile the base glyph shader
-    m_baseGlyphShader = compileShaderProgram(s_baseGlyphVert, s_baseGlyphFrag);
+    std::string baseVert = std::string("#version 330 core\n") + GlyphStore::vertexInputsGLSL() + s_baseGlyphVert;
+    m_baseGlyphShader = compileShaderProgram(baseVert.c_str(), s_baseGlyphFrag);
     
     // Load common.cl once for kernel compilation
     if (existsLoreBook_ResourcesEmbeddedFile("Kernels/particles/common.cl")) {
@@ -115,12 +115,18 @@ bool PreviewEffectSystem::init(cl_context clContext, cl_device_id clDevice) {
     // Register all effects from the EffectRegistry (auto-registered via REGISTER_EFFECT macro)
     registerBuiltinEffects();
     
+    // Effect stacks composed on earlier launches compile in the background
+    prewarmKnownCombinations();
+    
     m_initialized = true;
     PLOG_INFO << "PreviewEffectSystem initialized with " << m_effects.size() << " effects";
     return true;
 }
 
 void PreviewEffectSystem::cleanup() {
+    // The shared shader pre-warm outlives any one preview; LoreBook.cpp
+    // stops it at shutdown
+    
     // Release base glyph shader
     if (m_baseGlyphShader) {
         glDeleteProgram(m_baseGlyphShader);
@@ -229,6 +235,39 @@ void PreviewEffectSystem::registerBuiltinEffects() {
     { auto e = std::make_unique<BloodEffect>(); e->color1 = {0,1,0,1}; variant("matrix_blood", std::move(e)); }
 }
 
+void PreviewEffectSystem::prewarmKnownCombinations() {
+    auto& cache = ShaderProgramCache::get();
+    if (!cache.isEnabled() || !cache.isPrewarmEnabled()) return;
+
+    std::vector<ShaderProgramCache::PrewarmJob> jobs;
+    for (const auto& [kind, signature] : cache.knownCombinations()) {
+        // Signatures are effect names joined outer→inner with '+'
+        std::vector<Effect*> stack;
+        std::stringstream ss(signature);
+        std::string name;
+        bool resolved = true;
+        while (std::getline(ss, name, '+')) {
+            EffectDef* def = getEffect(name);
+            if (!def || !def->effect) { resolved = false; break; }
+            stack.push_back(def->effect);
+        }
+        if (!resolved || stack.size() < 2) continue;
+
+        bool glyph = kind == "glyph";
+        bool hasSnippets = std::any_of(stack.begin(), stack.end(), [&](Effect* fx) {
+            return glyph ? !fx->getGlyphSnippets().empty() : !fx->getParticleSnippets().empty();
+        });
+        if (!hasSnippets) continue;
+
+        ShaderProgramCache::PrewarmJob job;
+        job.name = kind + ":" + signature;
+        job.sources = glyph ? m_compositor.composeGlyphShader(stack)
+                            : m_compositor.composeParticleShader(stack);
+        jobs.push_back(std::move(job));
+    }
+    cache.prewarm(glfwGetCurrentContext(), std::move(jobs));
+}
+
 // ────────────────────────────────────────────────────────────────────
 // Registration
 // ────────────────────────────────────────────────────────────────────
@@ -483,8 +522,10 @@ GLuint PreviewEffectSystem::getOrCompileSnippetGlyphShader(
     GLuint shader = ShaderCompositor::compileProgram("glyph:" + signature, sources);
     m_snippetGlyphShaderCache[cacheKey] = shader;
     
-    if (shader)
+    if (shader) {
+        ShaderProgramCache::get().rememberCombination("glyph", signature);
         PLOG_INFO << "Compiled snippet glyph shader for stack: " << signature;
+    }
     else
         PLOG_ERROR << "Failed to compile snippet glyph shader for: " << signature;
     
@@ -512,8 +553,10 @@ GLuint PreviewEffectSystem::getOrCompileSnippetParticleShader(
     GLuint shader = ShaderCompositor::compileProgram("particle:" + signature, sources);
     m_snippetParticleShaderCache[cacheKey] = shader;
     
-    if (shader)
+    if (shader) {
+        ShaderProgramCache::get().rememberCombination("particle", signature);
         PLOG_INFO << "Compiled snippet particle shader for stack: " << signature;
+    }
     else
         PLOG_ERROR << "Failed to compile snippet particle shader for: " << signature;
     
@@ -544,67 +587,6 @@ void PreviewEffectSystem::uploadParticleSnippetUniforms(GLuint shader, const Eff
     }
 }
 
-// ────────────────────────────────────────────────────────────────────
-// Batching
-// ────────────────────────────────────────────────────────────────────
-
-void PreviewEffectSystem::buildBatches(const std::vector<LayoutGlyph>& glyphs,
-                                        std::vector<EffectBatch>& outBatches) {
-    outBatches.clear();
-    
-    // Group glyphs by EffectDef pointer (each composite gets its own unique EffectDef)
-    std::unordered_map<EffectDef*, std::vector<size_t>> effectGroups;
-    
-    for (size_t i = 0; i < glyphs.size(); ++i) {
-        effectGroups[glyphs[i].effect].push_back(i);
-    }
-    
-    for (auto& [effect, indices] : effectGroups) {
-        EffectBatch batch;
-        batch.effect = effect;
-        
-        uint32_t effectID = 0;
-        if (effect && effect->effect) {
-            effectID = effect->effect->getBehaviorID();
-        }
-        
-        for (size_t idx : indices) {
-            const auto& g = glyphs[idx];
-            
-            GlyphVertex tl, tr, bl, br;
-            
-            tl.pos = g.pos;
-            tl.uv = g.uvMin;
-            tl.color = g.color;
-            tl.effectID = effectID;
-            
-            tr.pos = g.pos + glm::vec3(g.size.x, 0, 0);
-            tr.uv = {g.uvMax.x, g.uvMin.y};
-            tr.color = g.color;
-            tr.effectID = effectID;
-            
-            bl.pos = g.pos + glm::vec3(0, g.size.y, 0);
-            bl.uv = {g.uvMin.x, g.uvMax.y};
-            bl.color = g.color;
-            bl.effectID = effectID;
-            
-            br.pos = g.pos + glm::vec3(g.size.x, g.size.y, 0);
-            br.uv = g.uvMax;
-            br.color = g.color;
-            br.effectID = effectID;
-            
-            batch.vertices.push_back(tl);
-            batch.vertices.push_back(tr);
-            batch.vertices.push_back(bl);
-            batch.vertices.push_back(tr);
-            batch.vertices.push_back(br);
-            batch.vertices.push_back(bl);
-        }
-        
-        outBatches.push_back(std::move(batch));
-    }
-}
-
 // ────────────────────────────────────────────────────────────────────
 // Query
 // ────────────────────────────────────────────────────────────────────
@@ -1,5 +1,7 @@
 #include <Editors/Markdown/ShaderCompositor.hpp>
 #include <Editors/Markdown/Effect.hpp>
+#include <Editors/Markdown/GlyphStore.hpp>
+#include <Editors/Markdown/ShaderProgramCache.hpp>
 #include <plog/Log.h>
 #include <sstream>
 #include <set>
@@ -39,10 +41,7 @@ ComposedShaderSources ShaderCompositor::composeGlyphShader(const std::vector<Eff
     {
         std::ostringstream vs;
         vs << "#version 330 core\n"
-           << "layout(location = 0) in vec3 in_pos;\n"
-           << "layout(location = 1) in vec2 in_uv;\n"
-           << "layout(location = 2) in vec4 in_color;\n"
-           << "layout(location = 3) in uint in_effectID;\n\n"
+           << GlyphStore::vertexInputsGLSL() << "\n"
            << "uniform mat4 uMVP;\n"
            << "uniform float uTime;\n";
 
@@ -72,6 +71,7 @@ ComposedShaderSources ShaderCompositor::composeGlyphShader(const std::vector<Eff
         }
 
         vs << "void main() {\n"
+           << "    expandGlyphInstance();\n"
            << "    vec3 pos = in_pos;\n";
 
         // Vertex snippets: outer→inner order
@@ -716,6 +716,14 @@ GLuint ShaderCompositor::compileProgram(const std::string& name,
         return 0;
     }
 
+    // A binary from an earlier launch skips compiling and linking entirely
+    auto& cache = ShaderProgramCache::get();
+    const std::string cacheKey = cache.key(sources);
+    if (GLuint cached = cache.load(cacheKey)) {
+        PLOG_DEBUG << "Loaded cached shader program: " << name;
+        return cached;
+    }
+
     auto compileStage = [&](GLenum type, const std::string& src, const char* stageName) -> GLuint {
         GLuint shader = glCreateShader(type);
         const char* srcPtr = src.c_str();
@@ -762,6 +770,7 @@ GLuint ShaderCompositor::compileProgram(const std::string& name,
     if (geom) glAttachShader(program, geom);
     if (tcs) glAttachShader(program, tcs);
     if (tes) glAttachShader(program, tes);
+    cache.prepareForLink(program);
     glLinkProgram(program);
 
     GLint success;
@@ -780,8 +789,10 @@ GLuint ShaderCompositor::compileProgram(const std::string& name,
     if (tcs) glDeleteShader(tcs);
     if (tes) glDeleteShader(tes);
 
-    if (program)
+    if (program) {
+        cache.store(cacheKey, program);
         PLOG_DEBUG << "Compiled shader program: " << name;
+    }
 
     return program;
 }
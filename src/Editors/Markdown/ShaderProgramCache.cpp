@@ -0,0 +1,239 @@
+#include <Editors/Markdown/ShaderProgramCache.hpp>
+#include <Util/CacheFile.hpp>
+#include <GLFW/glfw3.h>
+#include <plog/Log.h>
+#include <cstring>
+#include <fstream>
+
+namespace Markdown {
+
+// ────────────────────────────────────────────────────────────────────
+// Helpers
+// ────────────────────────────────────────────────────────────────────
+
+static std::string glString(GLenum name) {
+    const GLubyte* s = glGetString(name);
+    return s ? reinterpret_cast<const char*>(s) : "";
+}
+
+static std::filesystem::path defaultCacheDir() {
+    return CacheFile::defaultDir("gl_programs");
+}
+
+// Cache entries (see CacheFile) hold the 4-byte binary format, then the binary
+static constexpr char kEntryMagic[8] = {'L', 'B', 'G', 'L', 'B', 'I', 'N', '1'};
+static constexpr const char* kCombinationsFile = "combinations.txt";
+static constexpr size_t kMaxCombinations = 512;
+
+// ────────────────────────────────────────────────────────────────────
+// Setup
+// ────────────────────────────────────────────────────────────────────
+
+ShaderProgramCache& ShaderProgramCache::get() {
+    static ShaderProgramCache instance;
+    return instance;
+}
+
+ShaderProgramCache::~ShaderProgramCache() {
+    // The context is gone by now; only the thread is left to reclaim
+    if (m_prewarmThread.joinable()) m_prewarmThread.join();
+}
+
+void ShaderProgramCache::setCacheDir(const std::filesystem::path& dir) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_cacheDir = dir;
+    m_combinationsLoaded = false;
+    m_combinations.clear();
+}
+
+std::filesystem::path ShaderProgramCache::getCacheDir() {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (m_cacheDir.empty()) m_cacheDir = defaultCacheDir();
+    return m_cacheDir;
+}
+
+std::filesystem::path ShaderProgramCache::entryPath(const std::string& key) {
+    return getCacheDir() / (key + ".glbin");
+}
+
+bool ShaderProgramCache::isSupported() {
+    if (m_supported < 0) {
+        GLint formats = 0;
+        if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        m_supported = formats > 0 ? 1 : 0;
+        if (!m_supported)
+            PLOG_INFO << "Shader program cache: driver exposes no program binary formats; disabled";
+    }
+    return m_supported == 1;
+}
+
+std::string ShaderProgramCache::key(const ComposedShaderSources& sources) {
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (m_fingerprint.empty()) {
+            m_fingerprint = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" +
+                            glString(GL_VERSION) + "|" + glString(GL_SHADING_LANGUAGE_VERSION);
+        }
+    }
+    uint64_t h = CacheFile::kFnvOffset;
+    for (const std::string* stage : {&sources.vertex, &sources.fragment, &sources.geometry,
+                                     &sources.tessControl, &sources.tessEval}) {
+        h = CacheFile::fnv1a64(*stage, h);
+        h = CacheFile::fnv1a64("\0", 1, h);
+    }
+    h = CacheFile::fnv1a64(m_fingerprint, h);
+    return CacheFile::toHex(h);
+}
+
+// ────────────────────────────────────────────────────────────────────
+// Entries
+// ────────────────────────────────────────────────────────────────────
+
+GLuint ShaderProgramCache::load(const std::string& key) {
+    if (!m_enabled || !isSupported()) return 0;
+
+    std::filesystem::path file = entryPath(key);
+    std::optional<std::vector<char>> data = CacheFile::read(file, kEntryMagic, key, "Shader program cache");
+    if (!data) return 0;
+    if (data->size() <= sizeof(GLenum)) {
+        PLOG_WARNING << "Shader program cache: discarding malformed entry " << file.string();
+        CacheFile::discard(file);
+        return 0;
+    }
+
+    GLenum format = 0;
+    std::memcpy(&format, data->data(), sizeof(GLenum));
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, format, data->data() + sizeof(GLenum),
+                    static_cast<GLsizei>(data->size() - sizeof(GLenum)));
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        // Driver changed without changing its version string, or a format it no longer accepts
+        PLOG_WARNING << "Shader program cache: rejected " << file.string() << ", recompiling";
+        glDeleteProgram(program);
+        CacheFile::discard(file);
+        return 0;
+    }
+    return program;
+}
+
+void ShaderProgramCache::prepareForLink(GLuint program) {
+    if (m_enabled && isSupported())
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void ShaderProgramCache::store(const std::string& key, GLuint program) {
+    if (!m_enabled || !program || !isSupported()) return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) return;
+
+    // Atomic replace: the pre-warm thread and the main thread never expose
+    // a partial entry to each other
+    CacheFile::write(entryPath(key), kEntryMagic, key,
+                     {std::string_view(reinterpret_cast<const char*>(&format), sizeof(GLenum)),
+                      std::string_view(binary.data(), static_cast<size_t>(written))},
+                     "Shader program cache");
+}
+
+// ────────────────────────────────────────────────────────────────────
+// Known combinations
+// ────────────────────────────────────────────────────────────────────
+
+void ShaderProgramCache::loadCombinations() {
+    // m_mutex held
+    if (m_combinationsLoaded) return;
+    m_combinationsLoaded = true;
+    if (m_cacheDir.empty()) m_cacheDir = defaultCacheDir();
+
+    std::ifstream in(m_cacheDir / kCombinationsFile);
+    std::string kind, signature;
+    while (in >> kind >> signature && m_combinations.size() < kMaxCombinations)
+        m_combinations.emplace(kind, signature);
+}
+
+void ShaderProgramCache::rememberCombination(const std::string& kind, const std::string& signature) {
+    if (!m_enabled || signature.empty() || signature.find_first_of(" \t\n") != std::string::npos) return;
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    loadCombinations();
+    if (m_combinations.size() >= kMaxCombinations) return;
+    if (!m_combinations.emplace(kind, signature).second) return;
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_cacheDir, ec);
+    std::ofstream out(m_cacheDir / kCombinationsFile, std::ios::app);
+    if (out) out << kind << ' ' << signature << '\n';
+}
+
+std::vector<std::pair<std::string, std::string>> ShaderProgramCache::knownCombinations() {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    loadCombinations();
+    return {m_combinations.begin(), m_combinations.end()};
+}
+
+// ────────────────────────────────────────────────────────────────────
+// Pre-warming
+// ────────────────────────────────────────────────────────────────────
+
+void ShaderProgramCache::prewarm(GLFWwindow* mainWindow, std::vector<PrewarmJob> jobs) {
+    if (!m_enabled || !m_prewarmEnabled || !mainWindow || jobs.empty()) return;
+    if (m_prewarmRunning || m_prewarmWindow || !isSupported()) return;
+
+    // Keys and the fingerprint come from the main context; skip what is on disk
+    std::vector<std::pair<std::string, PrewarmJob>> missing;
+    for (PrewarmJob& job : jobs) {
+        std::string k = key(job.sources);
+        std::error_code ec;
+        if (!std::filesystem::exists(entryPath(k), ec))
+            missing.emplace_back(std::move(k), std::move(job));
+    }
+    if (missing.empty()) return;
+
+    // Hidden 1×1 window whose context shares objects with the main one.
+    // Window creation has to happen on the main thread; the other hints
+    // (version, profile) are still the ones the main window was made with.
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    m_prewarmWindow = glfwCreateWindow(1, 1, "LoreBook shader pre-warm", nullptr, mainWindow);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if (!m_prewarmWindow) {
+        PLOG_WARNING << "Shader program cache: no shared context for pre-warming";
+        return;
+    }
+
+    PLOG_INFO << "Shader program cache: pre-warming " << missing.size() << " programs";
+    m_prewarmRunning = true;
+    m_prewarmThread = std::thread([this, missing = std::move(missing)]() {
+        glfwMakeContextCurrent(m_prewarmWindow);
+        for (const auto& [k, job] : missing) {
+            if (!m_prewarmRunning) break;
+            // compileProgram stores the binary; the program itself is not needed here
+            GLuint program = ShaderCompositor::compileProgram(job.name, job.sources);
+            if (program) glDeleteProgram(program);
+        }
+        glFinish();
+        glfwMakeContextCurrent(nullptr);
+        m_prewarmRunning = false;
+    });
+}
+
+void ShaderProgramCache::finishPrewarm() {
+    // The worker stops after the program it is compiling
+    m_prewarmRunning = false;
+    if (m_prewarmThread.joinable()) m_prewarmThread.join();
+    if (m_prewarmWindow) {
+        glfwDestroyWindow(m_prewarmWindow);
+        m_prewarmWindow = nullptr;
+    }
+}
+
+} // namespace Markdown
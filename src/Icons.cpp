@@ -339,6 +339,13 @@ IconTexture GetDynamicTexture(const std::string& key){
     return IconTexture();
 }
 
+void ReleaseDynamicTexture(const std::string& key){
+    auto it = s_dynamicTextures.find(key);
+    if(it == s_dynamicTextures.end()) return;
+    if(it->second.textureID) glDeleteTextures(1, &it->second.textureID);
+    s_dynamicTextures.erase(it);
+}
+
 // Draw an icon as an ImGui::Image using the original image file
 bool DrawIcon(const std::string& iconName, const ImVec2& size, const ImVec4& tint_col, const ImVec4& border_col) {
     IconTexture texture = LoadIconTexture(iconName);
@@ -41,7 +41,12 @@
 #include <CharacterEditor/PartLibrary.hpp>
 #include <CharacterEditor/CharacterManager.hpp>
 #include <Editors/Markdown/MarkdownEditor.hpp>
+#include <Editors/Markdown/ShaderProgramCache.hpp>
 #include <WorldMaps/Orbital/OrbitalEditor.hpp>
+#include <WorldMaps/World/QuadTreeBenchmark.hpp>
+#include <WorldMaps/World/NoiseBenchmark.hpp>
+#include <Editors/Markdown/FluidBenchmark.hpp>
+#include <cstring>
 
 static void glfw_error_callback(int error, const char* description)
 {
@@ -74,6 +79,47 @@ int main(int argc, char** argv)
     plog::init(plog::verbose, &consoleAppender);
     PLOGI << "plog initialized (verbose -> stderr)";
 
+    // Headless diagnostics
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--bench-quadtree") == 0) {
+            logQuadTreeBenchmark(runQuadTreeBenchmark());
+            return 0;
+        }
+        if (std::strcmp(argv[i], "--bench-noise") == 0) {
+            // The OpenCL half of the comparison is skipped when no context is available
+            try {
+                if (!OpenCLContext::get().init())
+                    PLOGW << "OpenCL unavailable; benchmarking the CPU noise backend only";
+            } catch (const std::exception& ex) {
+                PLOGW << "OpenCL unavailable (" << ex.what() << "); benchmarking the CPU noise backend only";
+            }
+            if (!initLoreBook_ResourcesEmbeddedVFS(argv[0]) || !mountLoreBook_ResourcesEmbeddedVFS()) {
+                PLOGE << "Failed to mount LoreBook embedded resources VFS!";
+                return 1;
+            }
+            auto conformance = runNoiseConformance();
+            auto throughput = runNoiseThroughput();
+            return logNoiseDiagnostics(conformance, throughput) ? 0 : 1;
+        }
+        if (std::strcmp(argv[i], "--bench-sph") == 0) {
+            try {
+                if (!OpenCLContext::get().init()) {
+                    PLOGE << "Failed to initialize OpenCL context!";
+                    return 1;
+                }
+            } catch (const std::exception& ex) {
+                PLOGE << "Failed to initialize OpenCL: " << ex.what();
+                return 1;
+            }
+            if (!initLoreBook_ResourcesEmbeddedVFS(argv[0]) || !mountLoreBook_ResourcesEmbeddedVFS()) {
+                PLOGE << "Failed to mount LoreBook embedded resources VFS!";
+                return 1;
+            }
+            auto results = Markdown::runFluidBenchmark();
+            return !results.empty() && Markdown::logFluidBenchmark(results) ? 0 : 1;
+        }
+    }
+
     try{
         if(!OpenCLContext::get().init()){
             PLOGE << "Failed to initialize OpenCL context!";
@@ -147,6 +193,10 @@ int main(int argc, char** argv)
     }
 
 
+    // Compile (or load cached binaries for) every OpenCL kernel in the background;
+    // the context is final now that interop has been set up.
+    OpenCLContext::get().warmUpPrograms("Kernels");
+
     std::vector<std::string> embeddedFiles = listLoreBook_ResourcesEmbeddedFiles("/", true);
     PLOGI << "Embedded resource files:";
     for(const auto& f : embeddedFiles){
@@ -1364,6 +1414,9 @@ int main(int argc, char** argv)
     }
 
     // Cleanup
+    // The shader pre-warm context is shared by every preview; stop it once,
+    // while the main context it shares with still exists
+    Markdown::ShaderProgramCache::get().finishPrewarm();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
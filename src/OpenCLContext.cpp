@@ -1,6 +1,9 @@
 #include <OpenCLContext.hpp>
 #include <plog/Log.h>
 #include <sstream>
+#include <Util/CacheFile.hpp>
+#include <atomic>
+#include <algorithm>
 #include <GL/glx.h>
 
 OpenCLContext &OpenCLContext::get()
@@ -84,7 +87,7 @@ bool OpenCLContext::init()
     }
 
     // Create command queue
-    clQueue = clCreateCommandQueue(clContext, clDevice, 0, &err);
+    clQueue = clCreateCommandQueue(clContext, clDevice, kernelProfiling_ ? CL_QUEUE_PROFILING_ENABLE : 0, &err);
     if (err != CL_SUCCESS)
     {
         PLOG_ERROR << "Failed to create OpenCL command queue";
@@ -151,7 +154,8 @@ bool OpenCLContext::initGLInterop()
         0
     };
 
-    // Release old context and queue
+    // Release old context and queue (programs built against it go with it)
+    releaseWarmPrograms();
     if (clQueue)
     {
         clReleaseCommandQueue(clQueue);
@@ -171,11 +175,11 @@ bool OpenCLContext::initGLInterop()
         PLOG_ERROR << "CL/GL interop: clCreateContext with GL sharing failed (err=" << err << ")";
         // Fall back: recreate plain context
         clContext = clCreateContext(nullptr, 1, &clDevice, nullptr, nullptr, &err);
-        clQueue = clCreateCommandQueue(clContext, clDevice, 0, &err);
+        clQueue = clCreateCommandQueue(clContext, clDevice, kernelProfiling_ ? CL_QUEUE_PROFILING_ENABLE : 0, &err);
         return false;
     }
 
-    clQueue = clCreateCommandQueue(clContext, clDevice, 0, &err);
+    clQueue = clCreateCommandQueue(clContext, clDevice, kernelProfiling_ ? CL_QUEUE_PROFILING_ENABLE : 0, &err);
     if (err != CL_SUCCESS)
     {
         PLOG_ERROR << "CL/GL interop: clCreateCommandQueue failed (err=" << err << ")";
@@ -183,10 +187,27 @@ bool OpenCLContext::initGLInterop()
     }
 
     clGLInterop = true;
-    PLOG_INFO << "CL/GL interop initialized successfully";
+    if (extensions.find("cl_khr_gl_event") != std::string::npos)
+        clGLEventFromSync = reinterpret_cast<CreateEventFromGLsyncFn>(
+            clGetExtensionFunctionAddressForPlatform(clPlatform, "clCreateEventFromGLsyncKHR"));
+    PLOG_INFO << "CL/GL interop initialized successfully"
+              << (clGLEventFromSync ? " (cl_khr_gl_event)" : "");
     return true;
 }
 
+cl_event OpenCLContext::createEventFromGLsync(GLsync sync)
+{
+    if (!clGLEventFromSync || !sync) return nullptr;
+    cl_int err = CL_SUCCESS;
+    cl_event ev = clGLEventFromSync(clContext, reinterpret_cast<cl_GLsync>(sync), &err);
+    if (err != CL_SUCCESS)
+    {
+        PLOG_WARNING << "clCreateEventFromGLsyncKHR failed (err=" << err << ")";
+        return nullptr;
+    }
+    return ev;
+}
+
 cl_mem OpenCLContext::createFromGLTexture(GLuint texID, cl_mem_flags flags, GLenum target, GLint mipLevel)
 {
     if (!clGLInterop)
@@ -210,24 +231,27 @@ cl_mem OpenCLContext::createFromGLTexture(GLuint texID, cl_mem_flags flags, GLen
     return mem;
 }
 
-void OpenCLContext::acquireGLObjects(cl_mem *memObjects, int count)
+void OpenCLContext::acquireGLObjects(cl_mem *memObjects, int count, cl_uint numEvents,
+                                     const cl_event *waitList, cl_event *event)
 {
     if (!clGLInterop || count <= 0) return;
-    cl_int err = clEnqueueAcquireGLObjects(clQueue, count, memObjects, 0, nullptr, nullptr);
+    cl_int err = clEnqueueAcquireGLObjects(clQueue, count, memObjects, numEvents, waitList, event);
     if (err != CL_SUCCESS)
         PLOG_ERROR << "clEnqueueAcquireGLObjects failed (err=" << err << ")";
 }
 
-void OpenCLContext::releaseGLObjects(cl_mem *memObjects, int count)
+void OpenCLContext::releaseGLObjects(cl_mem *memObjects, int count, cl_uint numEvents,
+                                     const cl_event *waitList, cl_event *event)
 {
     if (!clGLInterop || count <= 0) return;
-    cl_int err = clEnqueueReleaseGLObjects(clQueue, count, memObjects, 0, nullptr, nullptr);
+    cl_int err = clEnqueueReleaseGLObjects(clQueue, count, memObjects, numEvents, waitList, event);
     if (err != CL_SUCCESS)
         PLOG_ERROR << "clEnqueueReleaseGLObjects failed (err=" << err << ")";
 }
 
 void OpenCLContext::cleanup()
 {
+    releaseWarmPrograms();
     if (clQueue)
     {
         clReleaseCommandQueue(clQueue);
@@ -259,6 +283,8 @@ cl_mem OpenCLContext::createBuffer(cl_mem_flags flags, size_t size, void *hostPt
         std::lock_guard<std::mutex> lk(memTrackMutex_);
         memSizes_[mem] = size;
         totalAllocated_ += size;
+        buffersCreated_.fetch_add(1, std::memory_order_relaxed);
+        bytesCreated_.fetch_add(size, std::memory_order_relaxed);
         debugMemAllocations[debugTag]++;
         tagLookup[mem] = debugTag;
         TracyPlot("OpenCL Total Allocated", static_cast<double>(totalAllocated_));
@@ -342,31 +368,387 @@ size_t OpenCLContext::getTotalAllocated() const
     return totalAllocated_;
 }
 
+// --- Pipeline counters ---
+cl_int OpenCLContext::enqueueNDRangeKernel(cl_command_queue queue, cl_kernel kernel, cl_uint workDim,
+                                           const size_t *globalOffset, const size_t *globalSize,
+                                           const size_t *localSize, cl_uint numEvents,
+                                           const cl_event *waitList, cl_event *event)
+{
+    kernelLaunches_.fetch_add(1, std::memory_order_relaxed);
+    if (!kernelProfiling_)
+        return clEnqueueNDRangeKernel(queue, kernel, workDim, globalOffset, globalSize, localSize,
+                                      numEvents, waitList, event);
+
+    cl_event profiled = nullptr;
+    cl_int err = clEnqueueNDRangeKernel(queue, kernel, workDim, globalOffset, globalSize, localSize,
+                                        numEvents, waitList, &profiled);
+    if (err != CL_SUCCESS)
+        return err;
+    if (event)
+    {
+        clRetainEvent(profiled);
+        *event = profiled;
+    }
+    std::lock_guard<std::mutex> lk(profileMutex_);
+    profiledKernels_.emplace_back(kernel, profiled);
+    return err;
+}
+
+cl_int OpenCLContext::enqueueReadBuffer(cl_command_queue queue, cl_mem buffer, cl_bool blocking, size_t offset,
+                                        size_t size, void *ptr, cl_uint numEvents, const cl_event *waitList,
+                                        cl_event *event)
+{
+    cl_int err = clEnqueueReadBuffer(queue, buffer, blocking, offset, size, ptr, numEvents, waitList, event);
+    if (err == CL_SUCCESS)
+        bytesReadBack_.fetch_add(size, std::memory_order_relaxed);
+    return err;
+}
+
+void OpenCLContext::resolveProfiledKernels()
+{
+    std::vector<std::pair<cl_kernel, cl_event>> pending;
+    {
+        std::lock_guard<std::mutex> lk(profileMutex_);
+        pending.swap(profiledKernels_);
+    }
+    std::unordered_map<cl_kernel, std::string> names;
+    for (auto &[kernel, ev] : pending)
+    {
+        cl_ulong start = 0, end = 0;
+        if (clWaitForEvents(1, &ev) == CL_SUCCESS &&
+            clGetEventProfilingInfo(ev, CL_PROFILING_COMMAND_START, sizeof(start), &start, nullptr) == CL_SUCCESS &&
+            clGetEventProfilingInfo(ev, CL_PROFILING_COMMAND_END, sizeof(end), &end, nullptr) == CL_SUCCESS &&
+            end >= start)
+        {
+            auto it = names.find(kernel);
+            if (it == names.end())
+            {
+                char name[256] = {0};
+                clGetKernelInfo(kernel, CL_KERNEL_FUNCTION_NAME, sizeof(name) - 1, name, nullptr);
+                it = names.emplace(kernel, name).first;
+            }
+            std::lock_guard<std::mutex> lk(profileMutex_);
+            kernelMsByName_[it->second] += static_cast<double>(end - start) * 1e-6;
+        }
+        clReleaseEvent(ev);
+    }
+}
+
+OpenCLContext::Counters OpenCLContext::counters()
+{
+    resolveProfiledKernels();
+    Counters c;
+    c.buffersCreated = buffersCreated_.load();
+    c.bytesCreated = bytesCreated_.load();
+    c.bytesReadBack = bytesReadBack_.load();
+    c.kernelLaunches = kernelLaunches_.load();
+    std::lock_guard<std::mutex> lk(profileMutex_);
+    c.kernelMsByName = kernelMsByName_;
+    for (const auto &kv : kernelMsByName_)
+        c.kernelMs += kv.second;
+    return c;
+}
+
+void OpenCLContext::resetCounters()
+{
+    resolveProfiledKernels();
+    buffersCreated_ = 0;
+    bytesCreated_ = 0;
+    bytesReadBack_ = 0;
+    kernelLaunches_ = 0;
+    std::lock_guard<std::mutex> lk(profileMutex_);
+    kernelMsByName_.clear();
+}
+
 //kernel and program helpers
-void OpenCLContext::createProgram(cl_program& program,std::string file_path)
+
+// ── Program binary cache ──
+
+static std::string deviceInfoString(cl_device_id device, cl_device_info param)
+{
+    size_t size = 0;
+    if (clGetDeviceInfo(device, param, 0, nullptr, &size) != CL_SUCCESS || size == 0)
+        return {};
+    std::string value(size, '\0');
+    clGetDeviceInfo(device, param, size, &value[0], nullptr);
+    while (!value.empty() && value.back() == '\0')
+        value.pop_back();
+    return value;
+}
+
+static std::filesystem::path defaultProgramCacheDir()
+{
+    return CacheFile::defaultDir("cl_binaries");
+}
+
+// Cache entries (see CacheFile) hold the program binary as their payload
+static constexpr char kProgramCacheMagic[8] = {'L', 'B', 'C', 'L', 'B', 'I', 'N', '1'};
+
+void OpenCLContext::setProgramCacheDir(const std::filesystem::path &dir)
+{
+    std::lock_guard<std::mutex> lk(programMutex_);
+    programCacheDir_ = dir;
+}
+
+std::string OpenCLContext::programCacheKey(const std::string &source, const std::string &buildOptions)
 {
-    ZoneScopedN("OpenCLContext::createProgram");
-    if (program == nullptr)
     {
-        cl_int err = CL_SUCCESS;
-        //ZoneScopedN("LandTypeLayer::landtypeColorMap create program");
-        std::string kernel_code = preprocessCLIncludes(file_path);
-        const char *src = kernel_code.c_str();
-        size_t len = kernel_code.length();
-        program = clCreateProgramWithSource(getContext(), 1, &src, &len, &err);
-        if (err != CL_SUCCESS || program == nullptr){
-            throw std::runtime_error("clCreateProgramWithSource failed for " + file_path);
+        std::lock_guard<std::mutex> lk(programMutex_);
+        if (deviceFingerprint_.empty())
+        {
+            char platformVersion[256] = {0};
+            clGetPlatformInfo(clPlatform, CL_PLATFORM_VERSION, sizeof(platformVersion) - 1, platformVersion, nullptr);
+            deviceFingerprint_ = deviceInfoString(clDevice, CL_DEVICE_NAME) + "|" +
+                                 deviceInfoString(clDevice, CL_DEVICE_VERSION) + "|" +
+                                 deviceInfoString(clDevice, CL_DRIVER_VERSION) + "|" +
+                                 platformVersion;
         }
+    }
+    uint64_t h = CacheFile::fnv1a64(source);
+    h = CacheFile::fnv1a64("\0", 1, h);
+    h = CacheFile::fnv1a64(buildOptions, h);
+    h = CacheFile::fnv1a64("\0", 1, h);
+    h = CacheFile::fnv1a64(deviceFingerprint_, h);
+    return CacheFile::toHex(h);
+}
 
-        cl_device_id device= getDevice();
-        err = clBuildProgram(program, 1, &device, nullptr, nullptr, nullptr);
-        if (err != CL_SUCCESS)
+cl_program OpenCLContext::loadCachedProgram(const std::string &key, const std::string &buildOptions)
+{
+    ZoneScopedN("OpenCLContext::loadCachedProgram");
+    if (!programCacheEnabled_)
+        return nullptr;
+
+    std::filesystem::path file;
+    {
+        std::lock_guard<std::mutex> lk(programMutex_);
+        if (programCacheDir_.empty())
+            programCacheDir_ = defaultProgramCacheDir();
+        file = programCacheDir_ / (key + ".clbin");
+    }
+
+    std::optional<std::vector<char>> data = CacheFile::read(file, kProgramCacheMagic, key, "OpenCL program cache");
+    if (!data)
+        return nullptr;
+
+    const unsigned char *binary = reinterpret_cast<const unsigned char *>(data->data());
+    size_t binarySize = data->size();
+    cl_device_id device = getDevice();
+    cl_int binaryStatus = CL_SUCCESS;
+    cl_int err = CL_SUCCESS;
+    cl_program program = clCreateProgramWithBinary(getContext(), 1, &device, &binarySize, &binary, &binaryStatus, &err);
+    if (err == CL_SUCCESS && binaryStatus == CL_SUCCESS && program != nullptr)
+        err = clBuildProgram(program, 1, &device, buildOptions.empty() ? nullptr : buildOptions.c_str(), nullptr, nullptr);
+
+    if (err != CL_SUCCESS || binaryStatus != CL_SUCCESS || program == nullptr)
+    {
+        // Stale or rejected binary (e.g. driver changed without bumping its version string)
+        PLOG_WARNING << "OpenCL program cache: rejected " << file.string() << " (err=" << err << ", status=" << binaryStatus << "), rebuilding from source";
+        if (program)
+            clReleaseProgram(program);
+        CacheFile::discard(file);
+        return nullptr;
+    }
+    return program;
+}
+
+void OpenCLContext::storeCachedProgram(const std::string &key, cl_program program)
+{
+    ZoneScopedN("OpenCLContext::storeCachedProgram");
+    if (!programCacheEnabled_ || program == nullptr)
+        return;
+
+    size_t binarySize = 0;
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(binarySize), &binarySize, nullptr) != CL_SUCCESS || binarySize == 0)
+        return;
+    std::vector<unsigned char> binary(binarySize);
+    unsigned char *binaries[1] = {binary.data()};
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(binaries), binaries, nullptr) != CL_SUCCESS)
+        return;
+
+    std::filesystem::path file;
+    {
+        std::lock_guard<std::mutex> lk(programMutex_);
+        if (programCacheDir_.empty())
+            programCacheDir_ = defaultProgramCacheDir();
+        file = programCacheDir_ / (key + ".clbin");
+    }
+    CacheFile::write(file, kProgramCacheMagic, key,
+                     {std::string_view(reinterpret_cast<const char *>(binary.data()), binary.size())},
+                     "OpenCL program cache");
+}
+
+cl_program OpenCLContext::buildProgramFromSource(const std::string &source, const std::string &buildOptions, std::string *log)
+{
+    ZoneScopedN("OpenCLContext::buildProgramFromSource");
+    cl_int err = CL_SUCCESS;
+    const char *src = source.c_str();
+    size_t len = source.length();
+    cl_program program = clCreateProgramWithSource(getContext(), 1, &src, &len, &err);
+    if (err != CL_SUCCESS || program == nullptr)
+    {
+        if (log)
+            *log = "clCreateProgramWithSource failed (err=" + std::to_string(err) + ")";
+        return nullptr;
+    }
+
+    cl_device_id device = getDevice();
+    err = clBuildProgram(program, 1, &device, buildOptions.empty() ? nullptr : buildOptions.c_str(), nullptr, nullptr);
+    if (err != CL_SUCCESS)
+    {
+        if (log)
         {
             size_t log_size = 0;
             clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
-            std::string log;
-            log.resize(log_size);
-            clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, log_size, &log[0], nullptr);
+            log->resize(log_size);
+            if (log_size > 0)
+                clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, log_size, &(*log)[0], nullptr);
+        }
+        clReleaseProgram(program);
+        return nullptr;
+    }
+    return program;
+}
+
+void OpenCLContext::warmUpPrograms(const std::string &dir)
+{
+    ZoneScopedN("OpenCLContext::warmUpPrograms");
+    if (!clReady)
+        return;
+
+    // Preprocess on the calling thread (VFS reads), compile on workers
+    std::vector<std::pair<std::string, std::string>> jobs;
+    for (const std::string &name : listLoreBook_ResourcesEmbeddedFiles(dir.c_str()))
+    {
+        if (name.size() < 3 || name.compare(name.size() - 3, 3, ".cl") != 0)
+            continue;
+        std::string path = dir + "/" + name;
+        {
+            std::lock_guard<std::mutex> lk(programMutex_);
+            if (warmPrograms_.count(path))
+                continue;
+        }
+        try
+        {
+            std::string source = preprocessCLIncludes(path);
+            if (source.find("__kernel") == std::string::npos)
+                continue; // include-only library (e.g. Util.cl)
+            jobs.emplace_back(std::move(path), std::move(source));
+        }
+        catch (const std::exception &ex)
+        {
+            PLOG_WARNING << "OpenCL warm-up: skipping " << path << ": " << ex.what();
+        }
+    }
+    if (jobs.empty())
+        return;
+
+    auto promises = std::make_shared<std::vector<std::promise<cl_program>>>(jobs.size());
+    {
+        std::lock_guard<std::mutex> lk(programMutex_);
+        for (size_t i = 0; i < jobs.size(); ++i)
+            warmPrograms_[jobs[i].first] = (*promises)[i].get_future().share();
+    }
+
+    auto sharedJobs = std::make_shared<std::vector<std::pair<std::string, std::string>>>(std::move(jobs));
+    auto next = std::make_shared<std::atomic<size_t>>(0);
+    unsigned workers = std::max(1u, std::min<unsigned>(std::thread::hardware_concurrency(), static_cast<unsigned>(sharedJobs->size())));
+    PLOG_INFO << "OpenCL warm-up: building " << sharedJobs->size() << " programs on " << workers << " threads";
+
+    for (unsigned w = 0; w < workers; ++w)
+    {
+        warmWorkers_.emplace_back([this, sharedJobs, promises, next]() {
+            for (size_t i = (*next)++; i < sharedJobs->size(); i = (*next)++)
+            {
+                const auto &[path, source] = (*sharedJobs)[i];
+                cl_program program = nullptr;
+                try
+                {
+                    const std::string key = programCacheKey(source, "");
+                    program = loadCachedProgram(key, "");
+                    if (program == nullptr)
+                    {
+                        std::string log;
+                        program = buildProgramFromSource(source, "", &log);
+                        if (program)
+                            storeCachedProgram(key, program);
+                        else
+                            PLOG_WARNING << "OpenCL warm-up: " << path << " failed to build; deferring to on-demand build";
+                    }
+                }
+                catch (const std::exception &ex)
+                {
+                    PLOG_WARNING << "OpenCL warm-up: " << path << ": " << ex.what();
+                }
+                (*promises)[i].set_value(program);
+            }
+        });
+    }
+}
+
+void OpenCLContext::waitForWarmUp()
+{
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lk(programMutex_);
+        workers.swap(warmWorkers_);
+    }
+    for (auto &t : workers)
+        if (t.joinable())
+            t.join();
+}
+
+void OpenCLContext::releaseWarmPrograms()
+{
+    waitForWarmUp();
+    std::lock_guard<std::mutex> lk(programMutex_);
+    for (auto &kv : warmPrograms_)
+    {
+        cl_program program = kv.second.get();
+        if (program)
+            clReleaseProgram(program);
+    }
+    warmPrograms_.clear();
+    deviceFingerprint_.clear();
+}
+
+void OpenCLContext::createProgram(cl_program& program,std::string file_path, const std::string &buildOptions)
+{
+    ZoneScopedN("OpenCLContext::createProgram");
+    if (program == nullptr)
+    {
+        // A warm-up build for this file may already be done (or in flight)
+        if (buildOptions.empty())
+        {
+            std::shared_future<cl_program> pending;
+            {
+                std::lock_guard<std::mutex> lk(programMutex_);
+                auto it = warmPrograms_.find(file_path);
+                if (it != warmPrograms_.end())
+                    pending = it->second;
+            }
+            if (pending.valid())
+            {
+                cl_program warmed = pending.get();
+                if (warmed)
+                {
+                    clRetainProgram(warmed);
+                    program = warmed;
+                    return;
+                }
+            }
+        }
+
+        //ZoneScopedN("LandTypeLayer::landtypeColorMap create program");
+        std::string kernel_code = preprocessCLIncludes(file_path);
+        const std::string key = programCacheKey(kernel_code, buildOptions);
+        program = loadCachedProgram(key, buildOptions);
+        if (program)
+            return;
+
+        std::string log;
+        program = buildProgramFromSource(kernel_code, buildOptions, &log);
+        if (program == nullptr)
+        {
             //print the full source with line numbers for easier debugging
             {
                 std::istringstream iss(kernel_code);
@@ -382,6 +764,7 @@ void OpenCLContext::createProgram(cl_program& program,std::string file_path)
             }
             throw std::runtime_error(std::string("Failed to build " + file_path + " OpenCL program: ") + log);
         }
+        storeCachedProgram(key, program);
     }
 }
 
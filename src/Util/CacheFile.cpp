@@ -0,0 +1,100 @@
+#include <Util/CacheFile.hpp>
+#include <plog/Log.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace CacheFile {
+
+uint64_t fnv1a64(const void* data, size_t len, uint64_t h) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+std::string toHex(uint64_t h) {
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(h));
+    return hex;
+}
+
+std::filesystem::path defaultDir(const std::string& subdir) {
+    namespace fs = std::filesystem;
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg)
+        return fs::path(xdg) / "LoreBook" / subdir;
+    if (const char* home = std::getenv("HOME"); home && *home)
+        return fs::path(home) / ".cache" / "LoreBook" / subdir;
+    std::error_code ec;
+    fs::path tmp = fs::temp_directory_path(ec);
+    return (ec ? fs::current_path() : tmp) / "LoreBook" / subdir;
+}
+
+static constexpr size_t kKeyLength = 16;
+
+std::optional<std::vector<char>> read(const std::filesystem::path& file, const char (&magic)[8],
+                                      const std::string& key, const char* label) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) return std::nullopt;
+    std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    const size_t header = sizeof(magic) + kKeyLength;
+    if (key.size() != kKeyLength || data.size() <= header ||
+        std::memcmp(data.data(), magic, sizeof(magic)) != 0 ||
+        std::memcmp(data.data() + sizeof(magic), key.data(), kKeyLength) != 0) {
+        PLOG_WARNING << label << ": discarding malformed entry " << file.string();
+        discard(file);
+        return std::nullopt;
+    }
+    data.erase(data.begin(), data.begin() + header);
+    return data;
+}
+
+bool write(const std::filesystem::path& file, const char (&magic)[8], const std::string& key,
+           std::initializer_list<std::string_view> payload, const char* label) {
+    if (key.size() != kKeyLength) return false;
+
+    const std::filesystem::path dir = file.parent_path();
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+        PLOG_WARNING << label << ": cannot create " << dir.string() << ": " << ec.message();
+        return false;
+    }
+
+    std::ostringstream tmpName;
+    tmpName << file.filename().string() << "." << std::this_thread::get_id() << ".tmp";
+    const std::filesystem::path tmp = dir / tmpName.str();
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(magic, sizeof(magic));
+        out.write(key.data(), kKeyLength);
+        for (std::string_view part : payload)
+            out.write(part.data(), static_cast<std::streamsize>(part.size()));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmp, file, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+void discard(const std::filesystem::path& file) {
+    std::error_code ec;
+    std::filesystem::remove(file, ec);
+}
+
+} // namespace CacheFile
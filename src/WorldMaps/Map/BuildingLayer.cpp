@@ -6,6 +6,7 @@
 #include <sstream>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 // ── lifecycle ───────────────────────────────────────────────────────────────
 
@@ -15,35 +16,63 @@ BuildingLayer::~BuildingLayer()
         OpenCLContext::get().releaseMem(colorBuffer_);
         colorBuffer_ = nullptr;
     }
+    releaseGeometry();
 }
 
 // ── MapLayer interface ──────────────────────────────────────────────────────
 
 cl_mem BuildingLayer::sample()  { return getColor(); }
 
-cl_mem BuildingLayer::getColor()
+bool BuildingLayer::ensureLayout()
 {
-    ZoneScopedN("BuildingLayer::getColor");
-
     // If templates haven't been loaded yet and a vault is now available, retry
     if (!templatesLoaded_ && parentWorld && parentWorld->getVault()) {
         dirty_ = true;
     }
+    if (!dirty_) return false;
+
+    loadTemplates();
+    preparePlacement();
+    dirty_ = false;
+    return true;
+}
+
+cl_mem BuildingLayer::getColor()
+{
+    ZoneScopedN("BuildingLayer::getColor");
 
-    if (dirty_ || colorBuffer_ == nullptr) {
-        loadTemplatesAndScatter();
+    if (ensureLayout() || colorBuffer_ == nullptr) {
         rasterizeToGPU();
-        dirty_ = false;
     }
     return colorBuffer_;
 }
 
+cl_mem BuildingLayer::sampleRegion(float lonMinRad, float lonMaxRad,
+                                   float latMinRad, float latMaxRad,
+                                   int resX, int resY,
+                                   const LayerDelta* delta)
+{
+    // Mirrors sample(): the building layer has no scalar field of its own
+    return getColorRegion(lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY, delta);
+}
+
+cl_mem BuildingLayer::getColorRegion(float lonMinRad, float lonMaxRad,
+                                     float latMinRad, float latMaxRad,
+                                     int resX, int resY,
+                                     const LayerDelta* /*delta*/)
+{
+    ZoneScopedN("BuildingLayer::getColorRegion");
+
+    ensureLayout();
+    return rasterizeRegion(lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY);
+}
+
 // ── parseParameters ─────────────────────────────────────────────────────────
 
 void BuildingLayer::parseParameters(const std::string& params)
 {
     auto lock = lockParameters();
-    // Expected format: "minDistance:100,maxBuildings:200,seed:42,cellsPerMeter:3"
+    // Expected format: "minDistance:100,density:1.0,seed:42,cellsPerMeter:3"
     auto trim = [](std::string s) {
         s.erase(0, s.find_first_not_of(" \t"));
         s.erase(s.find_last_not_of(" \t") + 1);
@@ -59,7 +88,9 @@ void BuildingLayer::parseParameters(const std::string& params)
         std::string value = trim(token.substr(pos + 1));
         try {
             if      (key == "minDistance")    minDistance_    = std::stof(value);
-            else if (key == "maxBuildings")  maxBuildings_  = std::stoi(value);
+            else if (key == "density")       density_       = std::max(0.0f, std::stof(value));
+            else if (key == "maxBuildings")
+                PLOGW << "BuildingLayer: maxBuildings is no longer used; placement is density-based (density:N)";
             else if (key == "seed")          seed_          = static_cast<unsigned int>(std::stoul(value));
             else if (key == "cellsPerMeter") cellsPerMeter_ = std::stof(value);
         } catch (...) {
@@ -79,11 +110,11 @@ void BuildingLayer::setTemplates(const std::vector<FloorPlan>& t)
     dirty_           = true;
 }
 
-// ── loadTemplatesAndScatter ─────────────────────────────────────────────────
+// ── loadTemplates ───────────────────────────────────────────────────────────
 
-void BuildingLayer::loadTemplatesAndScatter()
+void BuildingLayer::loadTemplates()
 {
-    ZoneScopedN("BuildingLayer::loadTemplatesAndScatter");
+    ZoneScopedN("BuildingLayer::loadTemplates");
 
     // Load templates from vault if not already loaded
     if (!templatesLoaded_ && parentWorld) {
@@ -119,19 +150,28 @@ void BuildingLayer::loadTemplatesAndScatter()
             // Do NOT set templatesLoaded_ — retry when vault becomes available
         }
     }
+}
+
+// ── preparePlacement ────────────────────────────────────────────────────────
+
+void BuildingLayer::preparePlacement()
+{
+    ZoneScopedN("BuildingLayer::preparePlacement");
+
+    tiles_.clear();
+    releaseGeometry();
+    templateMeta_.clear();
+    candidatesPerTile_ = 0;
 
     if (templates_.empty()) {
         PLOGW << "BuildingLayer: no floorplan templates available — layer will be empty";
-        placedBuildings.clear();
         return;
     }
 
     // ── Pre-compute template metadata (centroid & half-extent) ──
-    struct TemplateMeta {
-        float centerX = 0, centerY = 0;
-        float halfExtentX = 0, halfExtentY = 0;
-    };
-    std::vector<TemplateMeta> tmeta(templates_.size());
+    maxBuildingRadius_ = 0.0f;
+    std::vector<TemplateMeta>& tmeta = templateMeta_;
+    tmeta.assign(templates_.size(), TemplateMeta{});
     float maxHalfExtent = 0.0f;
 
     for (size_t ti = 0; ti < templates_.size(); ++ti) {
@@ -158,88 +198,198 @@ void BuildingLayer::loadTemplatesAndScatter()
             tmeta[ti].centerX = sumX / n;
             tmeta[ti].centerY = sumY / n;
         }
+        float halfExtentX = 0.0f, halfExtentY = 0.0f;
         if (fMinX <= fMaxX) {
-            tmeta[ti].halfExtentX = std::max(fMaxX - tmeta[ti].centerX,
-                                              tmeta[ti].centerX - fMinX);
-            tmeta[ti].halfExtentY = std::max(fMaxY - tmeta[ti].centerY,
-                                              tmeta[ti].centerY - fMinY);
+            halfExtentX = std::max(fMaxX - tmeta[ti].centerX, tmeta[ti].centerX - fMinX);
+            halfExtentY = std::max(fMaxY - tmeta[ti].centerY, tmeta[ti].centerY - fMinY);
         }
-        maxHalfExtent = std::max(maxHalfExtent,
-            std::max(tmeta[ti].halfExtentX, tmeta[ti].halfExtentY));
+        maxHalfExtent = std::max(maxHalfExtent, std::max(halfExtentX, halfExtentY));
+
+        // Exact footprint around the scatter centre, so candidates can be
+        // tested against the map edge without building their geometry
+        PlacedBuilding probe;
+        probe.mapX = -tmeta[ti].centerX * cellsPerMeter_;
+        probe.mapY = -tmeta[ti].centerY * cellsPerMeter_;
+        probe.plan = fp;
+        computeBuildingBounds(probe);
+        tmeta[ti].localMinX = probe.minX;  tmeta[ti].localMinY = probe.minY;
+        tmeta[ti].localMaxX = probe.maxX;  tmeta[ti].localMaxY = probe.maxY;
+        maxBuildingRadius_ = std::max({maxBuildingRadius_, -probe.minX, -probe.minY,
+                                       probe.maxX, probe.maxY});
 
         PLOGI << "BuildingLayer: template " << ti
               << " center=(" << tmeta[ti].centerX << "," << tmeta[ti].centerY
-              << ") halfExtent=(" << tmeta[ti].halfExtentX
-              << "," << tmeta[ti].halfExtentY << ")";
+              << ") halfExtent=(" << halfExtentX << "," << halfExtentY << ")";
     }
 
-    // ── Compute dynamic scatter parameters ──
-    int latRes = parentWorld ? parentWorld->getWorldLatitudeResolution() : 4096;
-    int lonRes = parentWorld ? parentWorld->getWorldLongitudeResolution() : 4096;
+    // ── Placement parameters ──
+    latRes_ = parentWorld ? parentWorld->getWorldLatitudeResolution() : 4096;
+    lonRes_ = parentWorld ? parentWorld->getWorldLongitudeResolution() : 4096;
 
     float buildingRadiusCells = maxHalfExtent * cellsPerMeter_ + 20.0f;
-    float edgeMargin = buildingRadiusCells + 10.0f;
-    float effectiveMinDist = std::max(minDistance_, buildingRadiusCells * 2.1f);
-
-    if (edgeMargin * 2 >= (float)latRes || edgeMargin * 2 >= (float)lonRes) {
-        PLOGW << "BuildingLayer: buildings too large for map at cellsPerMeter="
-              << cellsPerMeter_ << " (edgeMargin=" << edgeMargin
-              << ", map=" << latRes << "x" << lonRes << ")";
-        placedBuildings.clear();
-        return;
+    effectiveMinDist_ = std::max(minDistance_, buildingRadiusCells * 2.1f);
+
+    // Deepest tile level whose tiles are still at least one minimum
+    // distance across, so every conflict lies within the 3×3 neighbourhood
+    float minTile = static_cast<float>(std::min(latRes_, lonRes_));
+    tileDepth_ = 0;
+    while (tileDepth_ < CHUNK_MAX_DEPTH && minTile / static_cast<float>(2 << tileDepth_) >= effectiveMinDist_)
+        ++tileDepth_;
+
+    float tileArea = (static_cast<float>(latRes_) / (1 << tileDepth_)) *
+                     (static_cast<float>(lonRes_) / (1 << tileDepth_));
+    candidatesPerTile_ = static_cast<int>(std::ceil(
+        density_ * tileArea / (effectiveMinDist_ * effectiveMinDist_)));
+
+    PLOGI << "BuildingLayer: placement tiles at depth " << tileDepth_
+          << ", " << candidatesPerTile_ << " candidate(s) per tile"
+          << " (effectiveMinDist=" << effectiveMinDist_ << ")";
+}
+
+// ── placement ───────────────────────────────────────────────────────────────
+
+namespace {
+
+uint32_t mixHash(uint32_t h, uint32_t v)
+{
+    h ^= v + 0x9e3779b9u + (h << 6) + (h >> 2);
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+    return h;
+}
+
+/// Platform-independent [0, 1) from an mt19937 draw.
+float unitFloat(std::mt19937& rng)
+{
+    return static_cast<float>(rng() >> 8) * (1.0f / 16777216.0f);
+}
+
+} // namespace
+
+void BuildingLayer::tileBoundsCells(int tileX, int tileY, float& minX, float& minY,
+                                    float& maxX, float& maxY) const
+{
+    // Map cells: X runs along latitude from the north edge, Y along longitude
+    // from the antimeridian; ChunkCoord y counts rows from the south.
+    int n = 1 << tileDepth_;
+    float tileH = static_cast<float>(latRes_) / n;
+    float tileW = static_cast<float>(lonRes_) / n;
+    minX = (n - 1 - tileY) * tileH;
+    maxX = minX + tileH;
+    minY = tileX * tileW;
+    maxY = minY + tileW;
+}
+
+std::vector<BuildingLayer::Candidate> BuildingLayer::tileCandidates(int tileX, int tileY) const
+{
+    std::vector<Candidate> out;
+    int n = 1 << tileDepth_;
+    if (tileX < 0 || tileY < 0 || tileX >= n || tileY >= n || templates_.empty()) return out;
+
+    float minX, minY, maxX, maxY;
+    tileBoundsCells(tileX, tileY, minX, minY, maxX, maxY);
+
+    // Seeded from the tile's ChunkCoord, so any tile can be regenerated alone
+    uint32_t h = mixHash(mixHash(mixHash(seed_, static_cast<uint32_t>(tileX)),
+                                 static_cast<uint32_t>(tileY)),
+                         static_cast<uint32_t>(tileDepth_));
+    std::mt19937 rng(h);
+    out.reserve(candidatesPerTile_);
+    for (int i = 0; i < candidatesPerTile_; ++i) {
+        Candidate c;
+        c.x = minX + unitFloat(rng) * (maxX - minX);
+        c.y = minY + unitFloat(rng) * (maxY - minY);
+        c.priority = rng();
+        c.templateIndex = rng() % static_cast<uint32_t>(templates_.size());
+        c.tileX = tileX;
+        c.tileY = tileY;
+        c.index = i;
+
+        // Drop candidates whose footprint leaves the map
+        const TemplateMeta& tm = templateMeta_[c.templateIndex];
+        if (c.x + tm.localMinX < 0.0f || c.y + tm.localMinY < 0.0f ||
+            c.x + tm.localMaxX >= static_cast<float>(latRes_) ||
+            c.y + tm.localMaxY >= static_cast<float>(lonRes_))
+            continue;
+        out.push_back(c);
     }
+    return out;
+}
 
-    std::mt19937 rng(seed_);
-    std::uniform_real_distribution<float> distX(edgeMargin, (float)latRes - edgeMargin);
-    std::uniform_real_distribution<float> distY(edgeMargin, (float)lonRes - edgeMargin);
-    std::uniform_int_distribution<size_t> templateDist(0, templates_.size() - 1);
-
-    placedBuildings.clear();
-    int maxAttempts = maxBuildings_ * 20;
-
-    for (int attempt = 0;
-         attempt < maxAttempts && (int)placedBuildings.size() < maxBuildings_;
-         ++attempt)
-    {
-        float x = distX(rng);
-        float y = distY(rng);
-
-        // Reject if too close to an existing building (using scatter centres)
-        bool tooClose = false;
-        for (const auto& existing : placedBuildings) {
-            float dx = x - existing.scatterX;
-            float dy = y - existing.scatterY;
-            if (dx * dx + dy * dy < effectiveMinDist * effectiveMinDist) {
-                tooClose = true;
-                break;
-            }
+const BuildingLayer::PlacementTile& BuildingLayer::placementTile(int tileX, int tileY)
+{
+    ChunkCoord key{tileX, tileY, tileDepth_};
+    auto it = tiles_.find(key);
+    if (it != tiles_.end()) return it->second;
+
+    ZoneScopedN("BuildingLayer::placementTile");
+
+    // Candidates of the 3×3 neighbourhood, bucketed into a spatial hash with
+    // cells one minimum distance across
+    std::vector<Candidate> candidates;
+    for (int dy = -1; dy <= 1; ++dy)
+        for (int dx = -1; dx <= 1; ++dx) {
+            auto c = tileCandidates(tileX + dx, tileY + dy);
+            candidates.insert(candidates.end(), c.begin(), c.end());
         }
-        if (tooClose) continue;
 
-        size_t ti = templateDist(rng);
-        const auto& tm = tmeta[ti];
+    auto cellOf = [&](float v) { return static_cast<int32_t>(std::floor(v / effectiveMinDist_)); };
+    auto cellKey = [](int32_t cx, int32_t cy) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+    };
+    std::unordered_map<uint64_t, std::vector<int>> grid;
+    for (int i = 0; i < static_cast<int>(candidates.size()); ++i)
+        grid[cellKey(cellOf(candidates[i].x), cellOf(candidates[i].y))].push_back(i);
+
+    // Strict order on candidates; ties on priority fall back to identity
+    auto outranks = [](const Candidate& a, const Candidate& b) {
+        if (a.priority != b.priority) return a.priority > b.priority;
+        if (a.tileX != b.tileX) return a.tileX > b.tileX;
+        if (a.tileY != b.tileY) return a.tileY > b.tileY;
+        return a.index > b.index;
+    };
 
+    // Keep this tile's candidates that outrank every neighbour within range
+    std::vector<PlacedBuilding> accepted;
+    float minDist2 = effectiveMinDist_ * effectiveMinDist_;
+    for (const Candidate& c : candidates) {
+        if (c.tileX != tileX || c.tileY != tileY) continue;
+        int32_t cx = cellOf(c.x), cy = cellOf(c.y);
+        bool keep = true;
+        for (int32_t gy = cy - 1; gy <= cy + 1 && keep; ++gy)
+            for (int32_t gx = cx - 1; gx <= cx + 1 && keep; ++gx) {
+                auto git = grid.find(cellKey(gx, gy));
+                if (git == grid.end()) continue;
+                for (int oi : git->second) {
+                    const Candidate& o = candidates[oi];
+                    if (&o == &c) continue;
+                    float ddx = c.x - o.x, ddy = c.y - o.y;
+                    if (ddx * ddx + ddy * ddy < minDist2 && outranks(o, c)) { keep = false; break; }
+                }
+            }
+        if (!keep) continue;
+
+        const TemplateMeta& tm = templateMeta_[c.templateIndex];
         PlacedBuilding pb;
-        pb.scatterX = x;
-        pb.scatterY = y;
+        pb.scatterX = c.x;
+        pb.scatterY = c.y;
         // Adjust origin so the floor plan centroid maps to the scatter centre
-        pb.mapX = x - tm.centerX * cellsPerMeter_;
-        pb.mapY = y - tm.centerY * cellsPerMeter_;
-        pb.plan = templates_[ti];
+        pb.mapX = c.x - tm.centerX * cellsPerMeter_;
+        pb.mapY = c.y - tm.centerY * cellsPerMeter_;
+        pb.plan = templates_[c.templateIndex];
         computeBuildingBounds(pb);
-
-        // Reject if any part of the building extends beyond the map
-        if (pb.minX < 0 || pb.minY < 0 ||
-            pb.maxX >= (float)latRes || pb.maxY >= (float)lonRes) {
-            continue;
-        }
-
-        placedBuildings.push_back(std::move(pb));
+        accepted.push_back(std::move(pb));
     }
 
-    PLOGI << "BuildingLayer: placed " << placedBuildings.size() << " building(s)"
-          << " (edgeMargin=" << edgeMargin
-          << ", effectiveMinDist=" << effectiveMinDist << ")";
+    PlacementTile tile;
+    tile.firstBuilding = geometry_.buildingCount;
+    appendGeometry(accepted);
+    // Empty when the upload failed; the tile is not retried until the next reset
+    tile.buildingCount = geometry_.buildingCount - tile.firstBuilding;
+    return tiles_.emplace(key, tile).first->second;
 }
 
 // ── computeBuildingBounds ───────────────────────────────────────────────────
@@ -291,47 +441,94 @@ static cl_float4 imcolToFloat4(ImU32 c)
     return f;
 }
 
-// ── rasterizeToGPU ──────────────────────────────────────────────────────────
+// ── kernels ─────────────────────────────────────────────────────────────────
 
-void BuildingLayer::rasterizeToGPU()
+bool BuildingLayer::ensureKernels(cl_kernel* full, cl_kernel* region)
 {
-    ZoneScopedN("BuildingLayer::rasterizeToGPU");
+    static cl_program program      = nullptr;
+    static cl_kernel  fullKernel   = nullptr;
+    static cl_kernel  regionKernel = nullptr;
+    try {
+        OpenCLContext::get().createProgram(program, "Kernels/Buildings.cl");
+        OpenCLContext::get().createKernelFromProgram(fullKernel, program, "drawBuildings");
+        OpenCLContext::get().createKernelFromProgram(regionKernel, program, "drawBuildingsRegion");
+    } catch (const std::runtime_error& e) {
+        PLOGE << "BuildingLayer OpenCL init error: " << e.what();
+        return false;
+    }
+    if (full)   *full   = fullKernel;
+    if (region) *region = regionKernel;
+    return true;
+}
 
-    if (!OpenCLContext::get().isReady() || !parentWorld) return;
+// ── geometry ────────────────────────────────────────────────────────────────
 
-    int latRes = parentWorld->getWorldLatitudeResolution();
-    int lonRes = parentWorld->getWorldLongitudeResolution();
-    size_t voxels = (size_t)latRes * (size_t)lonRes;
-    size_t outSize = voxels * sizeof(cl_float4);
+bool BuildingLayer::DeviceArray::append(const void* data, size_t n, size_t elemSize, const char* tag)
+{
     cl_int err = CL_SUCCESS;
     cl_command_queue queue = OpenCLContext::get().getQueue();
-
-    // Ensure output buffer exists
-    if (colorBuffer_ != nullptr) {
-        size_t bufferSize = 0;
-        err = clGetMemObjectInfo(colorBuffer_, CL_MEM_SIZE,
-                                 sizeof(size_t), &bufferSize, nullptr);
-        if (err != CL_SUCCESS || bufferSize < outSize) {
-            OpenCLContext::get().releaseMem(colorBuffer_);
-            colorBuffer_ = nullptr;
-        }
+    size_t needed = count + n;
+    if (!mem || needed > capacity) {
+        // Kernels need a valid cl_mem even when nothing has been appended
+        size_t newCapacity = std::max<size_t>(64, needed * 2);
+        cl_mem grown = OpenCLContext::get().createBuffer(
+            CL_MEM_READ_ONLY, newCapacity * elemSize, nullptr, &err, tag);
+        if (err != CL_SUCCESS || !grown) return false;
+        if (mem && count > 0)
+            err = clEnqueueCopyBuffer(queue, mem, grown, 0, 0, count * elemSize, 0, nullptr, nullptr);
+        if (mem) OpenCLContext::get().releaseMem(mem);
+        mem = grown;
+        capacity = newCapacity;
+        if (err != CL_SUCCESS) return false;
     }
-    if (colorBuffer_ == nullptr) {
-        colorBuffer_ = OpenCLContext::get().createBuffer(
-            CL_MEM_READ_WRITE, outSize, nullptr, &err, "BuildingLayer output");
-        if (err != CL_SUCCESS || !colorBuffer_) {
-            PLOGE << "BuildingLayer: failed to allocate output buffer";
-            return;
-        }
+    if (n > 0) {
+        err = clEnqueueWriteBuffer(queue, mem, CL_TRUE, count * elemSize, n * elemSize,
+                                   data, 0, nullptr, nullptr);
+        if (err != CL_SUCCESS) return false;
     }
+    count = needed;
+    return true;
+}
 
-    // If nothing to draw, clear to background colour and return
-    if (placedBuildings.empty()) {
-        cl_float4 bg = {{0.88f, 0.85f, 0.78f, 1.0f}};
-        clEnqueueFillBuffer(queue, colorBuffer_, &bg,
-                            sizeof(cl_float4), 0, outSize, 0, nullptr, nullptr);
-        return;
-    }
+void BuildingLayer::DeviceArray::release()
+{
+    if (mem) OpenCLContext::get().releaseMem(mem);
+    mem = nullptr;
+    count = 0;
+    capacity = 0;
+}
+
+void BuildingLayer::releaseGeometry()
+{
+    DeviceArray* arrays[] = {
+        &geometry_.roomVerts, &geometry_.roomStart, &geometry_.roomVertCount,
+        &geometry_.roomColors, &geometry_.roomBoundsDev,
+        &geometry_.coords, &geometry_.colors, &geometry_.thick,
+        &geometry_.bBounds, &geometry_.bSegStart, &geometry_.bSegEnd
+    };
+    for (DeviceArray* a : arrays) a->release();
+    geometry_.roomBounds.clear();
+    geometry_.buildingBounds.clear();
+    geometry_.buildingRoomStart.clear();
+    geometry_.buildingRoomEnd.clear();
+    geometry_.roomCount = 0;
+    geometry_.segCount = 0;
+    geometry_.vertCount = 0;
+    geometry_.buildingCount = 0;
+    geometry_.valid = true;
+}
+
+void BuildingLayer::appendGeometry(const std::vector<PlacedBuilding>& placedBuildings)
+{
+    ZoneScopedN("BuildingLayer::appendGeometry");
+
+    if (!OpenCLContext::get().isReady() || !geometry_.valid) return;
+
+    // Indices written below are global: this tile's data goes after
+    // everything appended for earlier tiles
+    const int roomBase = geometry_.roomCount;
+    const int segBase  = geometry_.segCount;
+    const int vertBase = geometry_.vertCount;
 
     // ================================================================
     // 1. Extract room polygons from all placed buildings
@@ -345,6 +542,7 @@ void BuildingLayer::rasterizeToGPU()
     std::vector<RoomData> allRooms;
 
     for (const auto& pb : placedBuildings) {
+        geometry_.buildingRoomStart.push_back(static_cast<cl_int>(roomBase + allRooms.size()));
         for (const auto& room : pb.plan.rooms) {
             auto boundary = room.getSampledBoundary(10);
             if (boundary.size() < 3) continue;
@@ -368,6 +566,7 @@ void BuildingLayer::rasterizeToGPU()
 
             allRooms.push_back(std::move(rd));
         }
+        geometry_.buildingRoomEnd.push_back(static_cast<cl_int>(roomBase + allRooms.size()));
     }
 
     // Flatten room data into GPU arrays
@@ -378,7 +577,7 @@ void BuildingLayer::rasterizeToGPU()
     std::vector<cl_float4> roomBoundsVec;
 
     for (const auto& rd : allRooms) {
-        roomVertStart.push_back(static_cast<cl_int>(flatRoomVerts.size()));
+        roomVertStart.push_back(static_cast<cl_int>(vertBase + flatRoomVerts.size()));
         roomVertCount.push_back(static_cast<cl_int>(rd.vertices.size()));
         roomFillColors.push_back(rd.fillColor);
         roomBoundsVec.push_back(rd.bounds);
@@ -558,14 +757,14 @@ void BuildingLayer::rasterizeToGPU()
     std::vector<cl_int>    allBuildingSegEnd;
 
     for (size_t bi = 0; bi < placedBuildings.size(); ++bi) {
-        allBuildingSegStart.push_back(totalSegCount);
+        allBuildingSegStart.push_back(segBase + totalSegCount);
         for (const auto& sd : buildingSegs[bi]) {
             allCoords.push_back(sd.coords);
             allColors.push_back(sd.color);
             allHalfThick.push_back(sd.halfThickness);
             ++totalSegCount;
         }
-        allBuildingSegEnd.push_back(totalSegCount);
+        allBuildingSegEnd.push_back(segBase + totalSegCount);
 
         const auto& pb = placedBuildings[bi];
         cl_float4 bounds;
@@ -575,83 +774,116 @@ void BuildingLayer::rasterizeToGPU()
     }
     int buildingCount = static_cast<int>(placedBuildings.size());
 
-    PLOGI << "BuildingLayer: rasterizing " << totalSegCount << " segments + "
-          << totalRoomCount << " rooms from " << buildingCount << " buildings"
-          << " (cellsPerMeter=" << cellsPerMeter_ << ")";
-    if (buildingCount > 0) {
-        const auto& first = placedBuildings[0];
-        PLOGI << "BuildingLayer: first building at (" << first.mapX << ", " << first.mapY
-              << ") bounds (" << first.minX << "," << first.minY
-              << ")-(" << first.maxX << "," << first.maxY << ")";
-    }
+    PLOGD << "BuildingLayer: appended " << totalSegCount << " segments + "
+          << totalRoomCount << " rooms from " << buildingCount << " buildings";
 
     // ================================================================
-    // 4. Upload to GPU and run the kernel
+    // 4. Append to the device arena shared by every dispatch
     // ================================================================
 
-    static cl_program program = nullptr;
-    static cl_kernel  kernel  = nullptr;
-    try {
-        OpenCLContext::get().createProgram(program, "Kernels/Buildings.cl");
-        OpenCLContext::get().createKernelFromProgram(kernel, program, "drawBuildings");
-    } catch (const std::runtime_error& e) {
-        PLOGE << "BuildingLayer OpenCL init error: " << e.what();
-        // Clear to background so we get a valid (visible) buffer
-        cl_float4 bg = {{0.88f, 0.85f, 0.78f, 1.0f}};
-        clEnqueueFillBuffer(queue, colorBuffer_, &bg,
-                            sizeof(cl_float4), 0, outSize, 0, nullptr, nullptr);
+    Geometry& g = geometry_;
+    bool ok = g.roomVerts.append(flatRoomVerts.data(), flatRoomVerts.size(), sizeof(cl_float2), "BL roomVerts")
+           && g.roomStart.append(roomVertStart.data(), roomVertStart.size(), sizeof(cl_int), "BL roomStart")
+           && g.roomVertCount.append(roomVertCount.data(), roomVertCount.size(), sizeof(cl_int), "BL roomCount")
+           && g.roomColors.append(roomFillColors.data(), roomFillColors.size(), sizeof(cl_float4), "BL roomColors")
+           && g.roomBoundsDev.append(roomBoundsVec.data(), roomBoundsVec.size(), sizeof(cl_float4), "BL roomBounds")
+           && g.coords.append(allCoords.data(), allCoords.size(), sizeof(cl_float4), "BL coords")
+           && g.colors.append(allColors.data(), allColors.size(), sizeof(cl_float4), "BL colors")
+           && g.thick.append(allHalfThick.data(), allHalfThick.size(), sizeof(float), "BL thick")
+           && g.bBounds.append(allBuildingBounds.data(), allBuildingBounds.size(), sizeof(cl_float4), "BL bBounds")
+           && g.bSegStart.append(allBuildingSegStart.data(), allBuildingSegStart.size(), sizeof(cl_int), "BL bSegStart")
+           && g.bSegEnd.append(allBuildingSegEnd.data(), allBuildingSegEnd.size(), sizeof(cl_int), "BL bSegEnd");
+    if (!ok) {
+        PLOGE << "BuildingLayer: failed to grow geometry buffers";
+        g.valid = false;
         return;
     }
 
-    // Helper: create read-only buffer, or a tiny dummy if the vector is empty
-    auto makeReadBuf = [&](const void* data, size_t elemSize, size_t count,
-                           const char* tag) -> cl_mem
-    {
-        if (count == 0) {
-            // Kernel still needs a valid cl_mem — allocate 1 element
-            return OpenCLContext::get().createBuffer(
-                CL_MEM_READ_ONLY, elemSize, nullptr, &err, tag);
+    g.roomBounds.insert(g.roomBounds.end(), roomBoundsVec.begin(), roomBoundsVec.end());
+    g.buildingBounds.insert(g.buildingBounds.end(), allBuildingBounds.begin(), allBuildingBounds.end());
+    g.vertCount     += static_cast<int>(flatRoomVerts.size());
+    g.roomCount     += totalRoomCount;
+    g.segCount      += totalSegCount;
+    g.buildingCount += buildingCount;
+}
+
+// ── rasterizeToGPU ──────────────────────────────────────────────────────────
+
+void BuildingLayer::rasterizeToGPU()
+{
+    ZoneScopedN("BuildingLayer::rasterizeToGPU");
+
+    if (!OpenCLContext::get().isReady() || !parentWorld) return;
+
+    int latRes = parentWorld->getWorldLatitudeResolution();
+    int lonRes = parentWorld->getWorldLongitudeResolution();
+    size_t voxels = (size_t)latRes * (size_t)lonRes;
+    size_t outSize = voxels * sizeof(cl_float4);
+    cl_int err = CL_SUCCESS;
+    cl_command_queue queue = OpenCLContext::get().getQueue();
+
+    // Ensure output buffer exists
+    if (colorBuffer_ != nullptr) {
+        size_t bufferSize = 0;
+        err = clGetMemObjectInfo(colorBuffer_, CL_MEM_SIZE,
+                                 sizeof(size_t), &bufferSize, nullptr);
+        if (err != CL_SUCCESS || bufferSize < outSize) {
+            OpenCLContext::get().releaseMem(colorBuffer_);
+            colorBuffer_ = nullptr;
         }
-        return OpenCLContext::get().createBuffer(
-            CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-            elemSize * count, const_cast<void*>(data), &err, tag);
-    };
+    }
+    if (colorBuffer_ == nullptr) {
+        colorBuffer_ = OpenCLContext::get().createBuffer(
+            CL_MEM_READ_WRITE, outSize, nullptr, &err, "BuildingLayer output");
+        if (err != CL_SUCCESS || !colorBuffer_) {
+            PLOGE << "BuildingLayer: failed to allocate output buffer";
+            return;
+        }
+    }
 
-    // Room buffers
-    cl_mem roomVertBuf   = makeReadBuf(flatRoomVerts.data(),  sizeof(cl_float2), flatRoomVerts.size(),  "BL roomVerts");
-    cl_mem roomStartBuf  = makeReadBuf(roomVertStart.data(),  sizeof(cl_int),    roomVertStart.size(),  "BL roomStart");
-    cl_mem roomCountBuf  = makeReadBuf(roomVertCount.data(),  sizeof(cl_int),    roomVertCount.size(),  "BL roomCount");
-    cl_mem roomColorBuf  = makeReadBuf(roomFillColors.data(), sizeof(cl_float4), roomFillColors.size(), "BL roomColors");
-    cl_mem roomBoundsBuf = makeReadBuf(roomBoundsVec.data(),  sizeof(cl_float4), roomBoundsVec.size(),  "BL roomBounds");
+    cl_float4 bg = {{0.88f, 0.85f, 0.78f, 1.0f}};
 
-    // Segment buffers
-    cl_mem coordsBuf   = makeReadBuf(allCoords.data(),     sizeof(cl_float4), allCoords.size(),     "BL coords");
-    cl_mem colorsBuf   = makeReadBuf(allColors.data(),     sizeof(cl_float4), allColors.size(),     "BL colors");
-    cl_mem thickBuf    = makeReadBuf(allHalfThick.data(),  sizeof(float),     allHalfThick.size(),  "BL thick");
+    // The full map needs every placement tile
+    if (candidatesPerTile_ > 0) {
+        int n = 1 << tileDepth_;
+        for (int ty = 0; ty < n; ++ty)
+            for (int tx = 0; tx < n; ++tx)
+                placementTile(tx, ty);
+    }
 
-    // Building culling buffers
-    cl_mem bBoundsBuf  = makeReadBuf(allBuildingBounds.data(),   sizeof(cl_float4), allBuildingBounds.size(),   "BL bBounds");
-    cl_mem bSegStartBuf= makeReadBuf(allBuildingSegStart.data(), sizeof(cl_int),    allBuildingSegStart.size(), "BL bSegStart");
-    cl_mem bSegEndBuf  = makeReadBuf(allBuildingSegEnd.data(),   sizeof(cl_int),    allBuildingSegEnd.size(),   "BL bSegEnd");
+    // If nothing to draw, clear to background colour and return
+    if (geometry_.buildingCount == 0 || !geometry_.valid) {
+        clEnqueueFillBuffer(queue, colorBuffer_, &bg,
+                            sizeof(cl_float4), 0, outSize, 0, nullptr, nullptr);
+        return;
+    }
+
+    cl_kernel kernel = nullptr;
+    if (!ensureKernels(&kernel, nullptr)) {
+        // Clear to background so we get a valid (visible) buffer
+        clEnqueueFillBuffer(queue, colorBuffer_, &bg,
+                            sizeof(cl_float4), 0, outSize, 0, nullptr, nullptr);
+        return;
+    }
 
     // Set kernel arguments (must match Buildings.cl signature exactly)
     int arg = 0;
-    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &roomVertBuf);
-    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &roomStartBuf);
-    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &roomCountBuf);
-    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &roomColorBuf);
-    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &roomBoundsBuf);
-    clSetKernelArg(kernel, arg++, sizeof(int),    &totalRoomCount);
-
-    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &coordsBuf);
-    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &colorsBuf);
-    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &thickBuf);
-    clSetKernelArg(kernel, arg++, sizeof(int),    &totalSegCount);
-
-    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &bBoundsBuf);
-    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &bSegStartBuf);
-    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &bSegEndBuf);
-    clSetKernelArg(kernel, arg++, sizeof(int),    &buildingCount);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.roomVerts.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.roomStart.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.roomVertCount.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.roomColors.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.roomBoundsDev.mem);
+    clSetKernelArg(kernel, arg++, sizeof(int),    &geometry_.roomCount);
+
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.coords.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.colors.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.thick.mem);
+    clSetKernelArg(kernel, arg++, sizeof(int),    &geometry_.segCount);
+
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.bBounds.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.bSegStart.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.bSegEnd.mem);
+    clSetKernelArg(kernel, arg++, sizeof(int),    &geometry_.buildingCount);
 
     clSetKernelArg(kernel, arg++, sizeof(int),    &latRes);
     clSetKernelArg(kernel, arg++, sizeof(int),    &lonRes);
@@ -659,23 +891,146 @@ void BuildingLayer::rasterizeToGPU()
 
     // Enqueue
     size_t global[2] = { (size_t)latRes, (size_t)lonRes };
-    err = clEnqueueNDRangeKernel(queue, kernel, 2, nullptr, global,
+    err = OpenCLContext::get().enqueueNDRangeKernel(queue, kernel, 2, nullptr, global,
                                  nullptr, 0, nullptr, nullptr);
     if (err != CL_SUCCESS) {
         PLOGE << "BuildingLayer: clEnqueueNDRangeKernel failed (" << err << ")";
     }
     clFinish(queue);
+}
+
+// ── rasterizeRegion ─────────────────────────────────────────────────────────
+
+cl_mem BuildingLayer::rasterizeRegion(float lonMinRad, float lonMaxRad,
+                                      float latMinRad, float latMaxRad,
+                                      int resX, int resY)
+{
+    ZoneScopedN("BuildingLayer::rasterizeRegion");
+
+    if (!OpenCLContext::get().isReady() || !parentWorld) return nullptr;
+
+    cl_int err = CL_SUCCESS;
+    cl_command_queue queue = OpenCLContext::get().getQueue();
+    size_t outSize = static_cast<size_t>(resX) * resY * sizeof(cl_float4);
+    cl_mem output = OpenCLContext::get().createBuffer(
+        CL_MEM_READ_WRITE, outSize, nullptr, &err, "BuildingLayer region");
+    if (err != CL_SUCCESS || !output) {
+        PLOGE << "BuildingLayer: failed to allocate region buffer";
+        return nullptr;
+    }
+
+    // Map the chunk's texel centres into building map cells. Cells use the
+    // full-map convention: X runs along latitude from the north edge, Y along
+    // longitude from the antimeridian, cell centres at integer coordinates.
+    const float pi = static_cast<float>(M_PI);
+    const float latRes = static_cast<float>(parentWorld->getWorldLatitudeResolution());
+    const float lonRes = static_cast<float>(parentWorld->getWorldLongitudeResolution());
+    float stepX = (latMaxRad - latMinRad) / pi * latRes / static_cast<float>(resY);
+    float stepY = (lonMaxRad - lonMinRad) / (2.0f * pi) * lonRes / static_cast<float>(resX);
+    float originX = (pi * 0.5f - latMaxRad) / pi * latRes + 0.5f * stepX - 0.5f;
+    float originY = (lonMinRad + pi) / (2.0f * pi) * lonRes + 0.5f * stepY - 0.5f;
+
+    // Chunk footprint in map cells, padded by the kernel's segment margin
+    const float margin = 20.0f + 0.5f * std::max(stepX, stepY);
+    float fMinX = originX - 0.5f * stepX - margin;
+    float fMaxX = originX + (resY - 0.5f) * stepX + margin;
+    float fMinY = originY - 0.5f * stepY - margin;
+    float fMaxY = originY + (resX - 0.5f) * stepY + margin;
+
+    // Placement tiles whose buildings can reach the footprint.  Generating
+    // them here is what makes placement lazy: only tiles near a requested
+    // chunk are ever scattered.
+    std::vector<PlacementTile> binned;
+    if (candidatesPerTile_ > 0) {
+        int n = 1 << tileDepth_;
+        float tileH = latRes / static_cast<float>(n);
+        float tileW = lonRes / static_cast<float>(n);
+        int rowMin = std::max(0, static_cast<int>(std::floor((fMinX - maxBuildingRadius_) / tileH)));
+        int rowMax = std::min(n - 1, static_cast<int>(std::floor((fMaxX + maxBuildingRadius_) / tileH)));
+        int colMin = std::max(0, static_cast<int>(std::floor((fMinY - maxBuildingRadius_) / tileW)));
+        int colMax = std::min(n - 1, static_cast<int>(std::floor((fMaxY + maxBuildingRadius_) / tileW)));
+        for (int row = rowMin; row <= rowMax; ++row)
+            for (int tx = colMin; tx <= colMax; ++tx)
+                binned.push_back(placementTile(tx, n - 1 - row));
+    }
+
+    // Footprint culling: only buildings (and their rooms) that overlap the
+    // chunk are handed to the kernel, so per-texel cost scales with local
+    // density instead of the total building count.
+    std::vector<cl_int> visibleBuildings;
+    std::vector<cl_int> visibleRooms;
+    if (geometry_.valid) {
+        for (const PlacementTile& tile : binned) {
+            for (int b = tile.firstBuilding; b < tile.firstBuilding + tile.buildingCount; ++b) {
+                const cl_float4& bb = geometry_.buildingBounds[b];
+                if (bb.s[2] < fMinX || bb.s[0] > fMaxX || bb.s[3] < fMinY || bb.s[1] > fMaxY)
+                    continue;
+                visibleBuildings.push_back(b);
+                for (int r = geometry_.buildingRoomStart[b]; r < geometry_.buildingRoomEnd[b]; ++r) {
+                    const cl_float4& rb = geometry_.roomBounds[r];
+                    if (rb.s[2] < fMinX || rb.s[0] > fMaxX || rb.s[3] < fMinY || rb.s[1] > fMaxY)
+                        continue;
+                    visibleRooms.push_back(r);
+                }
+            }
+        }
+    }
+
+    cl_kernel kernel = nullptr;
+    if (visibleBuildings.empty() || !ensureKernels(nullptr, &kernel)) {
+        cl_float4 bg = {{0.88f, 0.85f, 0.78f, 1.0f}};
+        clEnqueueFillBuffer(queue, output, &bg,
+                            sizeof(cl_float4), 0, outSize, 0, nullptr, nullptr);
+        return output;
+    }
+
+    int visibleRoomCount = static_cast<int>(visibleRooms.size());
+    int visibleBuildingCount = static_cast<int>(visibleBuildings.size());
+    if (visibleRooms.empty()) visibleRooms.push_back(0); // kernel still needs a valid cl_mem
+    cl_mem roomIdxBuf = OpenCLContext::get().createBuffer(
+        CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, visibleRooms.size() * sizeof(cl_int),
+        visibleRooms.data(), &err, "BL region rooms");
+    cl_mem bldgIdxBuf = OpenCLContext::get().createBuffer(
+        CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, visibleBuildings.size() * sizeof(cl_int),
+        visibleBuildings.data(), &err, "BL region buildings");
+
+    // Set kernel arguments (must match drawBuildingsRegion exactly)
+    int arg = 0;
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.roomVerts.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.roomStart.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.roomVertCount.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.roomColors.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.roomBoundsDev.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &roomIdxBuf);
+    clSetKernelArg(kernel, arg++, sizeof(int),    &visibleRoomCount);
+
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.coords.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.colors.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.thick.mem);
+
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.bBounds.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.bSegStart.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &geometry_.bSegEnd.mem);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &bldgIdxBuf);
+    clSetKernelArg(kernel, arg++, sizeof(int),    &visibleBuildingCount);
+
+    clSetKernelArg(kernel, arg++, sizeof(int),    &resY);
+    clSetKernelArg(kernel, arg++, sizeof(int),    &resX);
+    clSetKernelArg(kernel, arg++, sizeof(float),  &originX);
+    clSetKernelArg(kernel, arg++, sizeof(float),  &originY);
+    clSetKernelArg(kernel, arg++, sizeof(float),  &stepX);
+    clSetKernelArg(kernel, arg++, sizeof(float),  &stepY);
+    clSetKernelArg(kernel, arg++, sizeof(cl_mem), &output);
+
+    size_t global[2] = { (size_t)resY, (size_t)resX };
+    err = OpenCLContext::get().enqueueNDRangeKernel(queue, kernel, 2, nullptr, global,
+                                 nullptr, 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        PLOGE << "BuildingLayer: drawBuildingsRegion failed (" << err << ")";
+    }
 
-    // Release temporary buffers
-    OpenCLContext::get().releaseMem(roomVertBuf);
-    OpenCLContext::get().releaseMem(roomStartBuf);
-    OpenCLContext::get().releaseMem(roomCountBuf);
-    OpenCLContext::get().releaseMem(roomColorBuf);
-    OpenCLContext::get().releaseMem(roomBoundsBuf);
-    OpenCLContext::get().releaseMem(coordsBuf);
-    OpenCLContext::get().releaseMem(colorsBuf);
-    OpenCLContext::get().releaseMem(thickBuf);
-    OpenCLContext::get().releaseMem(bBoundsBuf);
-    OpenCLContext::get().releaseMem(bSegStartBuf);
-    OpenCLContext::get().releaseMem(bSegEndBuf);
+    // Released buffers stay alive until the enqueued kernel completes
+    OpenCLContext::get().releaseMem(roomIdxBuf);
+    OpenCLContext::get().releaseMem(bldgIdxBuf);
+    return output;
 }
@@ -0,0 +1,427 @@
+#include <WorldMaps/Map/CityLayer.hpp>
+#include <WorldMaps/World/World.hpp>
+#include <plog/Log.h>
+#include <tracy/Tracy.hpp>
+#include <sstream>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+
+inline uint64_t mixHash(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+// Hash of a candidate cell in global grid coordinates at the region depth
+inline uint64_t cellHash(uint32_t seed, int64_t gx, int64_t gy)
+{
+    uint64_t h = mixHash(0x9e3779b97f4a7c15ull ^ seed);
+    h = mixHash(h ^ static_cast<uint64_t>(gx));
+    return mixHash(h ^ (static_cast<uint64_t>(gy) << 32));
+}
+
+inline float unitFloat(uint64_t h)
+{
+    return static_cast<float>(h >> 40) * (1.0f / 16777216.0f);
+}
+
+// Settlements too small to anchor a nation
+constexpr float CAPITAL_MIN_POPULATION = 0.15f;
+
+} // namespace
+
+// ── SettlementGenerator ─────────────────────────────────────────────────────
+
+void SettlementGenerator::clear()
+{
+    std::lock_guard<std::mutex> lk(mutex_);
+    regions_.clear();
+}
+
+const std::vector<Settlement>& SettlementGenerator::region(const ChunkCoord& rc)
+{
+    std::lock_guard<std::mutex> lk(mutex_);
+    auto it = regions_.find(rc);
+    if (it != regions_.end()) return it->second;
+
+    static const std::vector<Settlement> none;
+    if (!OpenCLContext::get().isReady()) return none;
+    return regions_.emplace(rc, generate(rc)).first->second;
+}
+
+std::vector<Settlement> SettlementGenerator::generate(const ChunkCoord& rc)
+{
+    ZoneScopedN("SettlementGenerator::generate");
+    std::vector<Settlement> sites;
+
+    float lonMin, lonMax, latMin, latMax;
+    rc.getBoundsRadians(lonMin, lonMax, latMin, latMax);
+
+    // Read the same fields the elevation and land-type layers render, so
+    // settlements sit on the terrain the map shows
+    NoiseField elevationField{1.5f, 2.0f, 0.5f, 8, 12345u};
+    std::vector<NoiseField> landFields;
+    std::vector<LandTypeLayer::LandTypeProperties> landtypes;
+    if (world_) {
+        if (MapLayer* elevation = world_->getLayer("elevation")) {
+            std::vector<NoiseField> f = elevation->regionNoiseFields();
+            if (!f.empty()) elevationField = f.front();
+        }
+        if (auto* land = dynamic_cast<LandTypeLayer*>(world_->getLayer("landtype"))) {
+            landFields = land->regionNoiseFields();
+            landtypes = land->getLandtypes();
+            landFields.resize(std::min(landFields.size(), landtypes.size()));
+        }
+    }
+
+    // One small dispatch for the candidate grid; kept out of the world's
+    // region noise cache, which holds chunk-resolution planes
+    std::vector<NoiseField> fields{elevationField};
+    fields.insert(fields.end(), landFields.begin(), landFields.end());
+    size_t plane = static_cast<size_t>(gridRes_) * gridRes_;
+    std::vector<float> noise(plane * fields.size());
+    cl_mem noiseBuf = nullptr;
+    try {
+        perlinRegionFields(noiseBuf, gridRes_, gridRes_,
+                           static_cast<float>(M_PI / 2.0) - latMax, static_cast<float>(M_PI / 2.0) - latMin,
+                           lonMin + static_cast<float>(M_PI), lonMax + static_cast<float>(M_PI), fields);
+    } catch (const std::exception& ex) {
+        PLOGE << "SettlementGenerator: " << ex.what();
+    }
+    if (!noiseBuf) return sites;
+    cl_int err = OpenCLContext::get().enqueueReadBuffer(OpenCLContext::get().getQueue(), noiseBuf, CL_TRUE, 0,
+                                                        noise.size() * sizeof(float), noise.data(),
+                                                        0, nullptr, nullptr);
+    OpenCLContext::get().releaseMem(noiseBuf);
+    if (err != CL_SUCCESS) return sites;
+
+    const float cellW = (lonMax - lonMin) / gridRes_;
+    const float cellH = (latMax - latMin) / gridRes_;
+    const float land = std::max(1e-3f, 1.0f - seaLevel_);
+    const int half = gridRes_ / 2;
+    std::array<int, 4> quadrantBest{-1, -1, -1, -1};
+
+    for (int r = 0; r < gridRes_; ++r) {
+        float cellLat = latMax - (r + 0.5f) * cellH;
+        float latScore = std::sqrt(std::max(0.0f, std::cos(cellLat)));
+        for (int c = 0; c < gridRes_; ++c) {
+            size_t i = static_cast<size_t>(r) * gridRes_ + c;
+            float e = noise[i];
+            if (e < seaLevel_) continue;
+
+            // Lowlands first: nothing settles above ~40% of the land range
+            float h = (e - seaLevel_) / land;
+            float elevScore = std::clamp(1.0f - 2.5f * h, 0.0f, 1.0f);
+
+            float fertility = 0.5f;
+            if (!landFields.empty()) {
+                size_t dominant = 0;
+                for (size_t k = 1; k < landFields.size(); ++k)
+                    if (noise[(k + 1) * plane + i] > noise[(dominant + 1) * plane + i]) dominant = k;
+                fertility = 0.6f * landtypes[dominant].nutrient_content +
+                            0.4f * landtypes[dominant].water_retention;
+            }
+
+            float suitability = elevScore * (0.3f + 0.7f * fertility) * latScore;
+            if (suitability <= 0.0f) continue;
+
+            // Global cell coordinates (y from the south, like ChunkCoord)
+            int64_t gx = static_cast<int64_t>(rc.x) * gridRes_ + c;
+            int64_t gy = static_cast<int64_t>(rc.y) * gridRes_ + (gridRes_ - 1 - r);
+            uint64_t h0 = cellHash(seed_, gx, gy);
+            if (unitFloat(h0) >= density_ * suitability) continue;
+
+            uint64_t h1 = mixHash(h0 + 1);
+            uint64_t h2 = mixHash(h0 + 2);
+            Settlement s;
+            s.lon = lonMin + (c + 0.5f + 0.7f * (unitFloat(h1) - 0.5f)) * cellW;
+            s.lat = latMax - (r + 0.5f + 0.7f * (unitFloat(h2) - 0.5f)) * cellH;
+            float size = unitFloat(mixHash(h0 + 3));
+            s.population = std::max(1e-3f, suitability * (0.2f + 0.8f * size * size * size));
+            s.id = static_cast<uint32_t>(mixHash(h0 + 4) >> 40);
+
+            int q = (c >= half ? 1 : 0) + (r >= half ? 2 : 0);
+            int& best = quadrantBest[q];
+            if (s.population >= CAPITAL_MIN_POPULATION &&
+                (best < 0 || s.population > sites[best].population))
+                best = static_cast<int>(sites.size());
+            sites.push_back(s);
+        }
+    }
+
+    for (int best : quadrantBest)
+        if (best >= 0) sites[best].capital = true;
+    return sites;
+}
+
+void SettlementGenerator::gather(float lonMinRad, float lonMaxRad, float latMinRad, float latMaxRad,
+                                 float marginRad, bool capitalsOnly, std::vector<Settlement>& out)
+{
+    out.clear();
+    const float pi = static_cast<float>(M_PI);
+    const float twoPi = 2.0f * pi;
+
+    float latLo = std::max(latMinRad - marginRad, -pi / 2.0f);
+    float latHi = std::min(latMaxRad + marginRad, pi / 2.0f);
+    // A margin in radians of arc spans more longitude towards the poles
+    float maxAbsLat = std::max(std::abs(latLo), std::abs(latHi));
+    float lonMargin = std::min(marginRad / std::max(std::cos(maxAbsLat), 0.05f), pi);
+    float lonLo = lonMinRad - lonMargin;
+    float lonSpan = (lonMaxRad - lonMinRad) + 2.0f * lonMargin;
+    bool allLon = lonSpan >= twoPi;
+
+    int n = 1 << regionDepth_;
+    float cellW = twoPi / n;
+    float cellH = pi / n;
+    int y0 = std::clamp(static_cast<int>(std::floor((latLo + pi / 2.0f) / cellH)), 0, n - 1);
+    int y1 = std::clamp(static_cast<int>(std::floor((latHi + pi / 2.0f) / cellH)), 0, n - 1);
+    int x0 = allLon ? 0 : static_cast<int>(std::floor((lonLo + pi) / cellW));
+    int x1 = allLon ? n - 1 : static_cast<int>(std::floor((lonLo + lonSpan + pi) / cellW));
+    x1 = std::min(x1, x0 + n - 1);
+
+    for (int y = y0; y <= y1; ++y) {
+        for (int xi = x0; xi <= x1; ++xi) {
+            int x = ((xi % n) + n) % n;
+            for (const Settlement& s : region({x, y, regionDepth_})) {
+                if (capitalsOnly && !s.capital) continue;
+                if (s.lat < latLo || s.lat > latHi) continue;
+                if (!allLon) {
+                    float d = std::fmod(s.lon - lonLo, twoPi);
+                    if (d < 0.0f) d += twoPi;
+                    if (d > lonSpan) continue;
+                }
+                out.push_back(s);
+            }
+        }
+    }
+}
+
+// ── CityLayer lifecycle ─────────────────────────────────────────────────────
+
+CityLayer::~CityLayer()
+{
+    if (sampleBuffer_) {
+        OpenCLContext::get().releaseMem(sampleBuffer_);
+        sampleBuffer_ = nullptr;
+    }
+    if (colorBuffer_) {
+        OpenCLContext::get().releaseMem(colorBuffer_);
+        colorBuffer_ = nullptr;
+    }
+}
+
+SettlementGenerator& CityLayer::settlements()
+{
+    generator_.setWorld(parentWorld);
+    return generator_;
+}
+
+// ── MapLayer interface ──────────────────────────────────────────────────────
+
+cl_mem CityLayer::sample()
+{
+    if (!sampleBuffer_) sampleBuffer_ = renderWorld(false);
+    return sampleBuffer_;
+}
+
+cl_mem CityLayer::getColor()
+{
+    if (!colorBuffer_) colorBuffer_ = renderWorld(true);
+    return colorBuffer_;
+}
+
+cl_mem CityLayer::sampleRegion(float lonMinRad, float lonMaxRad,
+                               float latMinRad, float latMaxRad,
+                               int resX, int resY,
+                               const LayerDelta* /*delta*/)
+{
+    ZoneScopedN("CityLayer::sampleRegion");
+    cl_mem out = nullptr;
+    render(lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY, &out, nullptr);
+    return out;
+}
+
+cl_mem CityLayer::getColorRegion(float lonMinRad, float lonMaxRad,
+                                 float latMinRad, float latMaxRad,
+                                 int resX, int resY,
+                                 const LayerDelta* /*delta*/)
+{
+    ZoneScopedN("CityLayer::getColorRegion");
+    cl_mem out = nullptr;
+    render(lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY, nullptr, &out);
+    return out;
+}
+
+// ── parseParameters ─────────────────────────────────────────────────────────
+
+void CityLayer::parseParameters(const std::string& params)
+{
+    auto lock = lockParameters();
+    // Expected format: "seed:1337,density:0.12,radius:0.004,sealevel:0.5"
+    auto trim = [](std::string s) {
+        s.erase(0, s.find_first_not_of(" \t"));
+        s.erase(s.find_last_not_of(" \t") + 1);
+        return s;
+    };
+
+    std::istringstream iss(params);
+    std::string token;
+    while (std::getline(iss, token, ',')) {
+        auto pos = token.find(':');
+        if (pos == std::string::npos) continue;
+        std::string key   = trim(token.substr(0, pos));
+        std::string value = trim(token.substr(pos + 1));
+        try {
+            if      (key == "seed")     generator_.setSeed(static_cast<uint32_t>(std::stoul(value)));
+            else if (key == "density")  generator_.setDensity(std::clamp(std::stof(value), 0.0f, 1.0f));
+            else if (key == "sealevel") generator_.setSeaLevel(std::stof(value));
+            else if (key == "radius")   cityRadius_ = std::max(0.0f, std::stof(value));
+        } catch (...) {
+            PLOGW << "CityLayer::parseParameters: bad value for " << key;
+        }
+    }
+    for (cl_mem* buf : {&sampleBuffer_, &colorBuffer_}) {
+        if (*buf) OpenCLContext::get().releaseMem(*buf);
+        *buf = nullptr;
+    }
+}
+
+// ── Rendering ───────────────────────────────────────────────────────────────
+
+static cl_program gCitiesProgram = nullptr;
+
+bool CityLayer::render(float lonMinRad, float lonMaxRad, float latMinRad, float latMaxRad,
+                       int resX, int resY, cl_mem* sampleOut, cl_mem* colorOut)
+{
+    static cl_kernel gCitiesKernel = nullptr;
+    if (!OpenCLContext::get().isReady() || resX <= 0 || resY <= 0) return false;
+
+    try {
+        OpenCLContext::get().createProgram(gCitiesProgram, "Kernels/Cities.cl");
+        OpenCLContext::get().createKernelFromProgram(gCitiesKernel, gCitiesProgram, "cities_region");
+    } catch (const std::runtime_error& e) {
+        PLOGE << "CityLayer: failed to initialise OpenCL: " << e.what();
+        return false;
+    }
+
+    float texel = (latMaxRad - latMinRad) / resY;
+    float minRadius = minRadiusTexels_ * texel;
+    float maxRadius = std::max(cityRadius_ * 1.5f, minRadius);
+
+    std::vector<Settlement> sites;
+    settlements().gather(lonMinRad, lonMaxRad, latMinRad, latMaxRad, maxRadius, false, sites);
+
+    // Unit vector and squared chord of the disc radius per site
+    std::vector<cl_float4> siteData;
+    std::vector<cl_float2> siteInfo;
+    siteData.reserve(sites.size() + 1);
+    siteInfo.reserve(sites.size() + 1);
+    for (const Settlement& s : sites) {
+        float radius = std::max(cityRadius_ * (0.5f + std::sqrt(s.population)), minRadius);
+        float chord = 2.0f * std::sin(0.5f * radius);
+        float cl = std::cos(s.lat);
+        siteData.push_back({cl * std::cos(s.lon), cl * std::sin(s.lon), std::sin(s.lat), chord * chord});
+        siteInfo.push_back({s.population, s.capital ? 1.0f : 0.0f});
+    }
+    int siteCount = static_cast<int>(sites.size());
+    if (siteData.empty()) {
+        siteData.push_back({0.0f, 0.0f, 0.0f, 1.0f});
+        siteInfo.push_back({0.0f, 0.0f});
+    }
+
+    cl_int err = CL_SUCCESS;
+    size_t count = static_cast<size_t>(resX) * resY;
+    cl_mem siteBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+        siteData.size() * sizeof(cl_float4), siteData.data(), &err, "CityLayer sites");
+    cl_mem infoBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+        siteInfo.size() * sizeof(cl_float2), siteInfo.data(), &err, "CityLayer siteInfo");
+    cl_mem popBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, count * sizeof(float),
+        nullptr, &err, "CityLayer population");
+    cl_mem colorBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, count * sizeof(cl_float4),
+        nullptr, &err, "CityLayer color");
+
+    bool ok = siteBuf && infoBuf && popBuf && colorBuf;
+    if (ok) {
+        clSetKernelArg(gCitiesKernel, 0, sizeof(cl_mem), &siteBuf);
+        clSetKernelArg(gCitiesKernel, 1, sizeof(cl_mem), &infoBuf);
+        clSetKernelArg(gCitiesKernel, 2, sizeof(int), &siteCount);
+        clSetKernelArg(gCitiesKernel, 3, sizeof(int), &resY);
+        clSetKernelArg(gCitiesKernel, 4, sizeof(int), &resX);
+        clSetKernelArg(gCitiesKernel, 5, sizeof(float), &lonMinRad);
+        clSetKernelArg(gCitiesKernel, 6, sizeof(float), &lonMaxRad);
+        clSetKernelArg(gCitiesKernel, 7, sizeof(float), &latMinRad);
+        clSetKernelArg(gCitiesKernel, 8, sizeof(float), &latMaxRad);
+        clSetKernelArg(gCitiesKernel, 9, sizeof(cl_mem), &popBuf);
+        clSetKernelArg(gCitiesKernel, 10, sizeof(cl_mem), &colorBuf);
+
+        size_t global[2] = {static_cast<size_t>(resY), static_cast<size_t>(resX)};
+        ZoneScopedN("CityLayer::render Enqueue");
+        err = OpenCLContext::get().enqueueNDRangeKernel(OpenCLContext::get().getQueue(), gCitiesKernel,
+                                                        2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        ok = err == CL_SUCCESS;
+    }
+
+    if (siteBuf) OpenCLContext::get().releaseMem(siteBuf);
+    if (infoBuf) OpenCLContext::get().releaseMem(infoBuf);
+    if (ok && sampleOut) *sampleOut = popBuf;
+    else if (popBuf) OpenCLContext::get().releaseMem(popBuf);
+    if (ok && colorOut) *colorOut = colorBuf;
+    else if (colorBuf) OpenCLContext::get().releaseMem(colorBuf);
+    return ok;
+}
+
+cl_mem CityLayer::renderWorld(bool color)
+{
+    ZoneScopedN("CityLayer::renderWorld");
+    if (!parentWorld || !OpenCLContext::get().isReady()) return nullptr;
+
+    const int latRes = parentWorld->getWorldLatitudeResolution();
+    const int lonRes = parentWorld->getWorldLongitudeResolution();
+    const size_t elem = color ? sizeof(cl_float4) : sizeof(float);
+    cl_int err = CL_SUCCESS;
+    cl_mem world = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, static_cast<size_t>(latRes) * lonRes * elem,
+                                                     nullptr, &err, "CityLayer world");
+    if (err != CL_SUCCESS || !world) return nullptr;
+
+    // Tiles keep the per-texel site loop short: each only sees the
+    // settlements near it
+    const int tiles = std::min({16, latRes, lonRes});
+    const float pi = static_cast<float>(M_PI);
+    cl_command_queue queue = OpenCLContext::get().getQueue();
+    for (int ty = 0; ty < tiles; ++ty) {
+        int r0 = ty * latRes / tiles, r1 = (ty + 1) * latRes / tiles;
+        float latMax = pi / 2.0f - pi * r0 / latRes;
+        float latMin = pi / 2.0f - pi * r1 / latRes;
+        for (int tx = 0; tx < tiles; ++tx) {
+            int c0 = tx * lonRes / tiles, c1 = (tx + 1) * lonRes / tiles;
+            float lonMin = -pi + 2.0f * pi * c0 / lonRes;
+            float lonMax = -pi + 2.0f * pi * c1 / lonRes;
+
+            cl_mem tile = nullptr;
+            if (!render(lonMin, lonMax, latMin, latMax, c1 - c0, r1 - r0,
+                        color ? nullptr : &tile, color ? &tile : nullptr)) {
+                OpenCLContext::get().releaseMem(world);
+                return nullptr;
+            }
+            size_t srcOrigin[3] = {0, 0, 0};
+            size_t dstOrigin[3] = {static_cast<size_t>(c0) * elem, static_cast<size_t>(r0), 0};
+            size_t region[3] = {static_cast<size_t>(c1 - c0) * elem, static_cast<size_t>(r1 - r0), 1};
+            err = clEnqueueCopyBufferRect(queue, tile, world, srcOrigin, dstOrigin, region,
+                                          region[0], 0, static_cast<size_t>(lonRes) * elem, 0,
+                                          0, nullptr, nullptr);
+            OpenCLContext::get().releaseMem(tile);
+            if (err != CL_SUCCESS) {
+                OpenCLContext::get().releaseMem(world);
+                return nullptr;
+            }
+        }
+    }
+    return world;
+}
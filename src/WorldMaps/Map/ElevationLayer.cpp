@@ -70,33 +70,34 @@ cl_mem ElevationLayer::sampleRegion(float lonMinRad, float lonMaxRad,
     phiMax = lonMaxRad + static_cast<float>(M_PI);
 
     // Apply parameter overrides from delta if present
-    float freq = frequency_;
-    float lac  = lacunarity_;
-    int   oct  = octaves_;
-    float pers = persistence_;
-    unsigned int sd = seed_;
+    NoiseField field = regionNoiseFields().front();
     if (delta) {
-        freq = delta->getParam("frequency",   freq);
-        lac  = delta->getParam("lacunarity",  lac);
-        oct  = static_cast<int>(delta->getParam("octaves", static_cast<float>(oct)));
-        pers = delta->getParam("persistence", pers);
-        sd   = static_cast<unsigned int>(delta->getParam("seed", static_cast<float>(sd)));
+        field.frequency   = delta->getParam("frequency",   field.frequency);
+        field.lacunarity  = delta->getParam("lacunarity",  field.lacunarity);
+        field.octaves     = static_cast<int>(delta->getParam("octaves", static_cast<float>(field.octaves)));
+        field.persistence = delta->getParam("persistence", field.persistence);
+        field.seed        = static_cast<unsigned int>(delta->getParam("seed", static_cast<float>(field.seed)));
     }
 
-    // Generate noise for this sub-region
-    cl_mem regionBuf = nullptr;
-    perlinRegion(regionBuf, resY, resX,
-                 thetaMin, thetaMax, phiMin, phiMax,
-                 freq, lac, oct, pers, sd);
+    // Generate noise for this sub-region (shared with the other noise
+    // layers of the world when it has one)
+    cl_mem regionBuf = parentWorld
+        ? parentWorld->regionNoise(lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY, {field})
+        : nullptr;
+    if (!regionBuf)
+        perlinRegion(regionBuf, resY, resX,
+                     thetaMin, thetaMax, phiMin, phiMax,
+                     field.frequency, field.lacunarity, field.octaves, field.persistence, field.seed);
 
     // Apply per-sample deltas if present
-    if (delta && !delta->data.empty() &&
+    if (delta && delta->hasGridData() &&
         delta->resolution == resX && delta->resolution == resY) {
         cl_int err = CL_SUCCESS;
-        size_t deltaSize = delta->data.size() * sizeof(float);
+        std::vector<float> dense = delta->toDense();
+        size_t deltaSize = dense.size() * sizeof(float);
         cl_mem deltaBuf = OpenCLContext::get().createBuffer(
             CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-            deltaSize, const_cast<float*>(delta->data.data()),
+            deltaSize, dense.data(),
             &err, "elevation delta upload");
         if (err == CL_SUCCESS && deltaBuf) {
             applyDeltaScalar(regionBuf, deltaBuf, resY, resX,
@@ -195,7 +195,7 @@ void HumidityLayer::humidityMap(cl_mem &output,
     size_t global[2] = {(size_t)latitudeResolution, (size_t)longitudeResolution};
     {
         ZoneScopedN("HumidityLayer::humidityMap enqueue kernel");
-        err = clEnqueueNDRangeKernel(queue, kernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, kernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
         if (err != CL_SUCCESS)
         {
             printf("HumidityLayer::humidityMap: Failed to enqueue kernel: %d\n", err);
@@ -233,7 +233,7 @@ cl_mem HumidityLayer::sampleRegion(float lonMinRad, float lonMaxRad,
     if (elevLayer && elevLayer->supportsRegion()) {
         cl_mem buf = elevLayer->sampleRegion(lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY, nullptr);
         if (buf) {
-            clEnqueueReadBuffer(OpenCLContext::get().getQueue(), buf, CL_TRUE,
+            OpenCLContext::get().enqueueReadBuffer(OpenCLContext::get().getQueue(), buf, CL_TRUE,
                                 0, pixelCount * sizeof(float), elevData.data(), 0, nullptr, nullptr);
             OpenCLContext::get().releaseMem(buf);
         }
@@ -244,7 +244,7 @@ cl_mem HumidityLayer::sampleRegion(float lonMinRad, float lonMaxRad,
     if (waterLayer && waterLayer->supportsRegion()) {
         cl_mem buf = waterLayer->sampleRegion(lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY, nullptr);
         if (buf) {
-            clEnqueueReadBuffer(OpenCLContext::get().getQueue(), buf, CL_TRUE,
+            OpenCLContext::get().enqueueReadBuffer(OpenCLContext::get().getQueue(), buf, CL_TRUE,
                                 0, pixelCount * sizeof(float), waterData.data(), 0, nullptr, nullptr);
             OpenCLContext::get().releaseMem(buf);
         }
@@ -255,14 +255,23 @@ cl_mem HumidityLayer::sampleRegion(float lonMinRad, float lonMaxRad,
     if (tempLayer && tempLayer->supportsRegion()) {
         cl_mem buf = tempLayer->sampleRegion(lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY, nullptr);
         if (buf) {
-            clEnqueueReadBuffer(OpenCLContext::get().getQueue(), buf, CL_TRUE,
+            OpenCLContext::get().enqueueReadBuffer(OpenCLContext::get().getQueue(), buf, CL_TRUE,
                                 0, pixelCount * sizeof(float), tempData.data(), 0, nullptr, nullptr);
             OpenCLContext::get().releaseMem(buf);
         }
     }
 
-    // Rivers: not region-bounded, use zeros (rivers don't appear at chunk level)
+    // Rivers
+    MapLayer* riverLayer = parentWorld->getLayer("rivers");
     std::vector<float> riverData(pixelCount, 0.0f);
+    if (riverLayer && riverLayer->supportsRegion()) {
+        cl_mem buf = riverLayer->sampleRegion(lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY, nullptr);
+        if (buf) {
+            OpenCLContext::get().enqueueReadBuffer(OpenCLContext::get().getQueue(), buf, CL_TRUE,
+                                0, pixelCount * sizeof(float), riverData.data(), 0, nullptr, nullptr);
+            OpenCLContext::get().releaseMem(buf);
+        }
+    }
 
     // ── 2. Get landtype properties and compute landtype distribution via Perlin region ──
     LandTypeLayer* landtypeLayer = dynamic_cast<LandTypeLayer*>(parentWorld->getLayer("landtype"));
@@ -270,51 +279,40 @@ cl_mem HumidityLayer::sampleRegion(float lonMinRad, float lonMaxRad,
     const auto& landtypes = landtypeLayer ? landtypeLayer->getLandtypes()
                                            : std::vector<LandTypeLayer::LandTypeProperties>();
 
-    // Generate landtype noise channels
-    std::vector<float> ltNoiseData;
-    if (nTypes > 0) {
+    // Land type channels and weather noise in one request; a region the
+    // world has seen is served from the fused noise of all its layers.
+    std::vector<NoiseField> fields = landtypeLayer ? landtypeLayer->regionNoiseFields()
+                                                   : std::vector<NoiseField>();
+    fields.resize(nTypes);
+    fields.push_back(regionNoiseFields().front());
+
+    std::vector<float> noiseData;
+    bool haveNoise = parentWorld->readRegionNoise(lonMinRad, lonMaxRad, latMinRad, latMaxRad,
+                                                  resX, resY, fields, noiseData);
+    if (!haveNoise) {
         float thetaMin = static_cast<float>(M_PI / 2.0) - latMaxRad;
         float thetaMax = static_cast<float>(M_PI / 2.0) - latMinRad;
         float phiMin = lonMinRad + static_cast<float>(M_PI);
         float phiMax = lonMaxRad + static_cast<float>(M_PI);
 
-        std::vector<float> freq(nTypes, 1.5f);
-        std::vector<float> lac(nTypes, 2.0f);
-        std::vector<int>   oct(nTypes, 8);
-        std::vector<float> pers(nTypes, 0.5f);
-        std::vector<unsigned int> seeds(nTypes, 12345u);
-        for (int i = 0; i < nTypes; ++i) seeds[i] += i * 100;
-
-        cl_mem ltBuf = nullptr;
-        perlinRegionChannels(ltBuf, resY, resX, thetaMin, thetaMax, phiMin, phiMax,
-                              nTypes, freq, lac, oct, pers, seeds);
-
-        ltNoiseData.resize(static_cast<size_t>(nTypes) * pixelCount);
-        if (ltBuf) {
-            clEnqueueReadBuffer(OpenCLContext::get().getQueue(), ltBuf, CL_TRUE,
-                                0, ltNoiseData.size() * sizeof(float), ltNoiseData.data(), 0, nullptr, nullptr);
-            OpenCLContext::get().releaseMem(ltBuf);
+        cl_mem noiseBuf = nullptr;
+        perlinRegionFields(noiseBuf, resY, resX, thetaMin, thetaMax, phiMin, phiMax, fields);
+        if (noiseBuf) {
+            noiseData.resize(fields.size() * pixelCount);
+            haveNoise = OpenCLContext::get().enqueueReadBuffer(OpenCLContext::get().getQueue(), noiseBuf, CL_TRUE,
+                            0, noiseData.size() * sizeof(float), noiseData.data(), 0, nullptr, nullptr) == CL_SUCCESS;
+            OpenCLContext::get().releaseMem(noiseBuf);
         }
     }
 
-    // ── 3. Generate weather noise ──
-    float thetaMin = static_cast<float>(M_PI / 2.0) - latMaxRad;
-    float thetaMax = static_cast<float>(M_PI / 2.0) - latMinRad;
-    float phiMin = lonMinRad + static_cast<float>(M_PI);
-    float phiMax = lonMaxRad + static_cast<float>(M_PI);
-
-    cl_mem weatherBuf = nullptr;
-    perlinRegion(weatherBuf, resY, resX, thetaMin, thetaMax, phiMin, phiMax,
-                 0.008f, 2.0f, 6, 0.5f, 98765u);
-
+    std::vector<float> ltNoiseData;
     std::vector<float> weatherData(pixelCount, 0.5f);
-    if (weatherBuf) {
-        clEnqueueReadBuffer(OpenCLContext::get().getQueue(), weatherBuf, CL_TRUE,
-                            0, pixelCount * sizeof(float), weatherData.data(), 0, nullptr, nullptr);
-        OpenCLContext::get().releaseMem(weatherBuf);
+    if (haveNoise) {
+        ltNoiseData.assign(noiseData.begin(), noiseData.begin() + static_cast<size_t>(nTypes) * pixelCount);
+        weatherData.assign(noiseData.begin() + static_cast<size_t>(nTypes) * pixelCount, noiseData.end());
     }
 
-    // ── 4. Compute humidity on CPU (mirrors Humidity.cl logic) ──
+    // ── 3. Compute humidity on CPU (mirrors Humidity.cl logic) ──
     const float sharpness = 20.0f;
     std::vector<float> humidityData(pixelCount);
 
@@ -411,12 +409,13 @@ cl_mem HumidityLayer::sampleRegion(float lonMinRad, float lonMaxRad,
     if (err != CL_SUCCESS || !regionBuf) return nullptr;
 
     // Apply per-sample deltas
-    if (delta && !delta->data.empty() &&
+    if (delta && delta->hasGridData() &&
         delta->resolution == resX && delta->resolution == resY) {
-        size_t deltaSize = delta->data.size() * sizeof(float);
+        std::vector<float> dense = delta->toDense();
+        size_t deltaSize = dense.size() * sizeof(float);
         cl_mem deltaBuf = OpenCLContext::get().createBuffer(
             CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-            deltaSize, const_cast<float*>(delta->data.data()),
+            deltaSize, dense.data(),
             &err, "humidity delta upload");
         if (err == CL_SUCCESS && deltaBuf) {
             applyDeltaScalar(regionBuf, deltaBuf, resY, resX,
@@ -300,7 +300,7 @@ void LandTypeLayer::landtypeColorMap(
     size_t global[2] = {(size_t)latitudeResolution, (size_t)longitudeResolution};
     {
         //ZoneScopedN("LandTypeLayer::landtypeColorMap enqueue kernel");
-        err = clEnqueueNDRangeKernel(queue, kernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, kernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
     }
 
     OpenCLContext::get().releaseMem(propertiesBuf);
@@ -308,6 +308,15 @@ void LandTypeLayer::landtypeColorMap(
 
 // ── Region-bounded generation ────────────────────────────────────
 
+std::vector<NoiseField> LandTypeLayer::regionNoiseFields() const
+{
+    // Same parameters as sample(): one field per land type
+    std::vector<NoiseField> fields(landtypeCount, NoiseField{1.5f, 2.0f, 0.5f, 8, 12345u});
+    for (int i = 0; i < landtypeCount; ++i)
+        fields[i].seed += i * 100;
+    return fields;
+}
+
 cl_mem LandTypeLayer::sampleRegion(float lonMinRad, float lonMaxRad,
                                     float latMinRad, float latMaxRad,
                                     int resX, int resY,
@@ -326,38 +335,31 @@ cl_mem LandTypeLayer::getColorRegion(float lonMinRad, float lonMaxRad,
     ZoneScopedN("LandTypeLayer::getColorRegion");
     if (!OpenCLContext::get().isReady()) return nullptr;
 
-    // Convert lon/lat bounds to theta/phi
-    float thetaMin = static_cast<float>(M_PI / 2.0) - latMaxRad;
-    float thetaMax = static_cast<float>(M_PI / 2.0) - latMinRad;
-    float phiMin = lonMinRad + static_cast<float>(M_PI);
-    float phiMax = lonMaxRad + static_cast<float>(M_PI);
-
-    // Per-channel noise parameters (same defaults as sample())
+    // One noise channel per land type, shared with the world's other noise layers
     int nTypes = landtypeCount;
-    std::vector<float> freq(nTypes, 1.5f);
-    std::vector<float> lac(nTypes, 2.0f);
-    std::vector<int>   oct(nTypes, 8);
-    std::vector<float> pers(nTypes, 0.5f);
-    std::vector<unsigned int> seeds(nTypes, 12345u);
-    for (int i = 0; i < nTypes; ++i)
-        seeds[i] += i * 100;
-
-    // Generate multi-channel Perlin noise on GPU
-    cl_mem noiseBuf = nullptr;
-    perlinRegionChannels(noiseBuf, resY, resX,
-                          thetaMin, thetaMax, phiMin, phiMax,
-                          nTypes, freq, lac, oct, pers, seeds);
-    if (!noiseBuf) return nullptr;
-
-    // Read channel noise back to CPU
+    std::vector<NoiseField> fields = regionNoiseFields();
     size_t pixelCount = static_cast<size_t>(resX) * resY;
-    size_t totalFloats = static_cast<size_t>(nTypes) * pixelCount;
-    std::vector<float> noiseData(totalFloats);
-    cl_int err = clEnqueueReadBuffer(OpenCLContext::get().getQueue(), noiseBuf,
-                                      CL_TRUE, 0, totalFloats * sizeof(float),
-                                      noiseData.data(), 0, nullptr, nullptr);
-    OpenCLContext::get().releaseMem(noiseBuf);
-    if (err != CL_SUCCESS) return nullptr;
+    std::vector<float> noiseData;
+    cl_int err = CL_SUCCESS;
+    if (!parentWorld || !parentWorld->readRegionNoise(lonMinRad, lonMaxRad, latMinRad, latMaxRad,
+                                                      resX, resY, fields, noiseData)) {
+        float thetaMin = static_cast<float>(M_PI / 2.0) - latMaxRad;
+        float thetaMax = static_cast<float>(M_PI / 2.0) - latMinRad;
+        float phiMin = lonMinRad + static_cast<float>(M_PI);
+        float phiMax = lonMaxRad + static_cast<float>(M_PI);
+
+        cl_mem noiseBuf = nullptr;
+        perlinRegionFields(noiseBuf, resY, resX,
+                           thetaMin, thetaMax, phiMin, phiMax, fields);
+        if (!noiseBuf) return nullptr;
+
+        noiseData.resize(fields.size() * pixelCount);
+        err = OpenCLContext::get().enqueueReadBuffer(OpenCLContext::get().getQueue(), noiseBuf,
+                                          CL_TRUE, 0, noiseData.size() * sizeof(float),
+                                          noiseData.data(), 0, nullptr, nullptr);
+        OpenCLContext::get().releaseMem(noiseBuf);
+        if (err != CL_SUCCESS) return nullptr;
+    }
 
     // Compute RGBA color on CPU: exponential-softmax blend (mode=1)
     const float sharpness = 20.0f;
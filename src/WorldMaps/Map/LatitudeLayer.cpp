@@ -111,7 +111,7 @@ void LatitudeLayer::latitude(
     size_t global[2] = {(size_t)latitudeResolution, (size_t)longitudeResolution};
     {
         ZoneScopedN("Latitude Enqueue");
-        err = clEnqueueNDRangeKernel(queue, gLatitude, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, gLatitude, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
         if (err != CL_SUCCESS)
         {
             throw std::runtime_error("clEnqueueNDRangeKernel failed for latitude");
@@ -152,12 +152,13 @@ cl_mem LatitudeLayer::sampleRegion(float lonMinRad, float lonMaxRad,
     if (err != CL_SUCCESS || !regionBuf) return nullptr;
 
     // Apply per-sample deltas if present
-    if (delta && !delta->data.empty() &&
+    if (delta && delta->hasGridData() &&
         delta->resolution == resX && delta->resolution == resY) {
-        size_t deltaSize = delta->data.size() * sizeof(float);
+        std::vector<float> dense = delta->toDense();
+        size_t deltaSize = dense.size() * sizeof(float);
         cl_mem deltaBuf = OpenCLContext::get().createBuffer(
             CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-            deltaSize, const_cast<float*>(delta->data.data()),
+            deltaSize, dense.data(),
             &err, "latitude delta upload");
         if (err == CL_SUCCESS && deltaBuf) {
             applyDeltaScalar(regionBuf, deltaBuf, resY, resX,
@@ -0,0 +1,402 @@
+#include <WorldMaps/Map/PoliticalLayer.hpp>
+#include <WorldMaps/World/World.hpp>
+#include <plog/Log.h>
+#include <tracy/Tracy.hpp>
+#include <sstream>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// ── lifecycle ───────────────────────────────────────────────────────────────
+
+void PoliticalLayer::Flood::release()
+{
+    for (cl_mem* buf : {&owner, &seeds, &nations}) {
+        if (*buf) OpenCLContext::get().releaseMem(*buf);
+        *buf = nullptr;
+    }
+}
+
+PoliticalLayer::~PoliticalLayer()
+{
+    clearCache();
+    for (cl_mem* buf : {&sampleBuffer_, &colorBuffer_}) {
+        if (*buf) OpenCLContext::get().releaseMem(*buf);
+        *buf = nullptr;
+    }
+}
+
+void PoliticalLayer::clearCache()
+{
+    std::lock_guard<std::mutex> lk(cacheMutex_);
+    for (auto& [coord, f] : cache_) f.release();
+    cache_.clear();
+}
+
+SettlementGenerator& PoliticalLayer::settlements()
+{
+    if (parentWorld)
+        if (auto* cities = dynamic_cast<CityLayer*>(parentWorld->getLayer("cities")))
+            return cities->settlements();
+    ownSettlements_.setWorld(parentWorld);
+    return ownSettlements_;
+}
+
+// ── MapLayer interface ──────────────────────────────────────────────────────
+
+cl_mem PoliticalLayer::sample()
+{
+    if (!sampleBuffer_ && parentWorld) {
+        ZoneScopedN("PoliticalLayer::sample");
+        int latRes = parentWorld->getWorldLatitudeResolution();
+        int lonRes = parentWorld->getWorldLongitudeResolution();
+        const float pi = static_cast<float>(M_PI);
+        Flood f;
+        if (flood(-pi, pi, -pi / 2.0f, pi / 2.0f, lonRes, latRes, f))
+            resolve(f, -pi, pi, -pi / 2.0f, pi / 2.0f, &sampleBuffer_, nullptr);
+        f.release();
+    }
+    return sampleBuffer_;
+}
+
+cl_mem PoliticalLayer::getColor()
+{
+    if (!colorBuffer_ && parentWorld) {
+        ZoneScopedN("PoliticalLayer::getColor");
+        int latRes = parentWorld->getWorldLatitudeResolution();
+        int lonRes = parentWorld->getWorldLongitudeResolution();
+        const float pi = static_cast<float>(M_PI);
+        Flood f;
+        if (flood(-pi, pi, -pi / 2.0f, pi / 2.0f, lonRes, latRes, f))
+            resolve(f, -pi, pi, -pi / 2.0f, pi / 2.0f, nullptr, &colorBuffer_);
+        f.release();
+    }
+    return colorBuffer_;
+}
+
+cl_mem PoliticalLayer::sampleRegion(float lonMinRad, float lonMaxRad,
+                                    float latMinRad, float latMaxRad,
+                                    int resX, int resY,
+                                    const LayerDelta* /*delta*/)
+{
+    ZoneScopedN("PoliticalLayer::sampleRegion");
+    std::lock_guard<std::mutex> lk(cacheMutex_);
+    Flood scratch;
+    Flood* f = acquireFlood(lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY, scratch);
+    cl_mem out = nullptr;
+    if (f) resolve(*f, lonMinRad, lonMaxRad, latMinRad, latMaxRad, &out, nullptr);
+    scratch.release();
+    return out;
+}
+
+cl_mem PoliticalLayer::getColorRegion(float lonMinRad, float lonMaxRad,
+                                      float latMinRad, float latMaxRad,
+                                      int resX, int resY,
+                                      const LayerDelta* /*delta*/)
+{
+    ZoneScopedN("PoliticalLayer::getColorRegion");
+    std::lock_guard<std::mutex> lk(cacheMutex_);
+    Flood scratch;
+    Flood* f = acquireFlood(lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY, scratch);
+    cl_mem out = nullptr;
+    if (f) resolve(*f, lonMinRad, lonMaxRad, latMinRad, latMaxRad, nullptr, &out);
+    scratch.release();
+    return out;
+}
+
+// ── parseParameters ─────────────────────────────────────────────────────────
+
+void PoliticalLayer::parseParameters(const std::string& params)
+{
+    auto lock = lockParameters();
+    // Expected format: "range:0.25,seed:1337,sealevel:0.5,cache:64"
+    auto trim = [](std::string s) {
+        s.erase(0, s.find_first_not_of(" \t"));
+        s.erase(s.find_last_not_of(" \t") + 1);
+        return s;
+    };
+
+    std::istringstream iss(params);
+    std::string token;
+    while (std::getline(iss, token, ',')) {
+        auto pos = token.find(':');
+        if (pos == std::string::npos) continue;
+        std::string key   = trim(token.substr(0, pos));
+        std::string value = trim(token.substr(pos + 1));
+        try {
+            if      (key == "range")    range_ = std::max(0.0f, std::stof(value));
+            else if (key == "seed")     ownSettlements_.setSeed(static_cast<uint32_t>(std::stoul(value)));
+            else if (key == "sealevel") ownSettlements_.setSeaLevel(std::stof(value));
+            else if (key == "cache")    maxCachedChunks_ = std::max<size_t>(1, std::stoul(value));
+        } catch (...) {
+            PLOGW << "PoliticalLayer::parseParameters: bad value for " << key;
+        }
+    }
+    clearCache();
+    for (cl_mem* buf : {&sampleBuffer_, &colorBuffer_}) {
+        if (*buf) OpenCLContext::get().releaseMem(*buf);
+        *buf = nullptr;
+    }
+}
+
+// ── Flood cache ─────────────────────────────────────────────────────────────
+
+PoliticalLayer::Flood* PoliticalLayer::acquireFlood(float lonMinRad, float lonMaxRad,
+                                                    float latMinRad, float latMaxRad,
+                                                    int resX, int resY, Flood& scratch)
+{
+    // Recover the chunk these bounds belong to; unaligned requests (e.g.
+    // previews) are flooded without caching
+    const double twoPi = 2.0 * M_PI;
+    double span = static_cast<double>(lonMaxRad) - lonMinRad;
+    int depth = span > 0.0 ? static_cast<int>(std::lround(std::log2(twoPi / span))) : -1;
+    bool aligned = false;
+    ChunkCoord cc;
+    if (depth >= 0 && depth <= CHUNK_MAX_DEPTH) {
+        int n = 1 << depth;
+        cc.depth = depth;
+        cc.x = static_cast<int>(std::lround((lonMinRad + M_PI) / (twoPi / n)));
+        cc.y = static_cast<int>(std::lround((latMinRad + M_PI / 2.0) / (M_PI / n)));
+        float a, b, c, d;
+        cc.getBoundsRadians(a, b, c, d);
+        float eps = static_cast<float>(1e-4 * twoPi / n);
+        aligned = std::abs(a - lonMinRad) < eps && std::abs(b - lonMaxRad) < eps &&
+                  std::abs(c - latMinRad) < eps && std::abs(d - latMaxRad) < eps;
+    }
+
+    if (!aligned) {
+        return flood(lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY, scratch) ? &scratch : nullptr;
+    }
+
+    auto it = cache_.find(cc);
+    if (it != cache_.end() && it->second.resX == resX && it->second.resY == resY) {
+        it->second.lastUse = ++useCounter_;
+        return &it->second;
+    }
+
+    Flood fresh;
+    if (!flood(lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY, fresh)) return nullptr;
+    if (it != cache_.end()) {
+        it->second.release();
+        cache_.erase(it);
+    }
+    while (cache_.size() >= maxCachedChunks_) {
+        auto oldest = std::min_element(cache_.begin(), cache_.end(),
+            [](const auto& a, const auto& b) { return a.second.lastUse < b.second.lastUse; });
+        oldest->second.release();
+        cache_.erase(oldest);
+    }
+    fresh.lastUse = ++useCounter_;
+    return &cache_.emplace(cc, fresh).first->second;
+}
+
+// ── Jump flooding ───────────────────────────────────────────────────────────
+
+static cl_program gPoliticalProgram = nullptr;
+
+bool PoliticalLayer::flood(float lonMinRad, float lonMaxRad, float latMinRad, float latMaxRad,
+                           int resX, int resY, Flood& out)
+{
+    ZoneScopedN("PoliticalLayer::flood");
+    static cl_kernel gJfaStepKernel = nullptr;
+    if (!OpenCLContext::get().isReady() || resX <= 0 || resY <= 0) return false;
+
+    try {
+        OpenCLContext::get().createProgram(gPoliticalProgram, "Kernels/Political.cl");
+        OpenCLContext::get().createKernelFromProgram(gJfaStepKernel, gPoliticalProgram, "political_jfa_step");
+    } catch (const std::runtime_error& e) {
+        PLOGE << "PoliticalLayer: failed to initialise OpenCL: " << e.what();
+        return false;
+    }
+
+    const int margin = marginTexels_;
+    const int padX = resX + 2 * margin;
+    const int padY = resY + 2 * margin;
+    const float texelLat = (latMaxRad - latMinRad) / resY;
+    const float texelLon = (lonMaxRad - lonMinRad) / resX;
+
+    // Any capital whose weighted range reaches the padded grid
+    constexpr float MAX_WEIGHT = 1.5f;
+    std::vector<Settlement> capitals;
+    settlements().gather(lonMinRad, lonMaxRad, latMinRad, latMaxRad,
+                         range_ * MAX_WEIGHT + margin * texelLat, true, capitals);
+
+    std::vector<cl_float4> seeds;
+    std::vector<float> nations;
+    seeds.reserve(capitals.size() + 1);
+    nations.reserve(capitals.size() + 1);
+    for (const Settlement& s : capitals) {
+        // Population of capitals spans [0.15, 1] → weight [0.5, 1.5]
+        float weight = std::clamp(0.5f + (s.population - 0.15f) / 0.85f, 0.5f, MAX_WEIGHT);
+        float cl = std::cos(s.lat);
+        seeds.push_back({cl * std::cos(s.lon), cl * std::sin(s.lon), std::sin(s.lat), weight});
+        nations.push_back(static_cast<float>(s.id));
+    }
+
+    // Texel centre on the padded grid, matching political_texel_unit()
+    auto texelUnit = [&](int row, int col) {
+        float lat = latMaxRad - ((row - margin) + 0.5f) * texelLat;
+        float lon = lonMinRad + ((col - margin) + 0.5f) * texelLon;
+        lat = std::clamp(lat, static_cast<float>(-M_PI / 2.0), static_cast<float>(M_PI / 2.0));
+        float cl = std::cos(lat);
+        return std::array<float, 3>{cl * std::cos(lon), cl * std::sin(lon), std::sin(lat)};
+    };
+    auto cost = [](const std::array<float, 3>& p, const cl_float4& s) {
+        float d = std::clamp(p[0] * s.s[0] + p[1] * s.s[1] + p[2] * s.s[2], -1.0f, 1.0f);
+        return std::acos(d) / s.s[3];
+    };
+
+    // Plant every seed at its texel, clamped onto the padded grid; where
+    // several land on one texel the cheapest for that texel wins
+    std::vector<int> owner(static_cast<size_t>(padX) * padY, -1);
+    const float lonCentre = 0.5f * (lonMinRad + lonMaxRad);
+    const float twoPi = static_cast<float>(2.0 * M_PI);
+    for (size_t i = 0; i < capitals.size(); ++i) {
+        float dl = std::remainder(capitals[i].lon - lonCentre, twoPi);
+        int col = static_cast<int>(std::floor((dl + 0.5f * (lonMaxRad - lonMinRad)) / texelLon)) + margin;
+        int row = static_cast<int>(std::floor((latMaxRad - capitals[i].lat) / texelLat)) + margin;
+        col = std::clamp(col, 0, padX - 1);
+        row = std::clamp(row, 0, padY - 1);
+        int& slot = owner[static_cast<size_t>(row) * padX + col];
+        if (slot < 0) { slot = static_cast<int>(i); continue; }
+        auto p = texelUnit(row, col);
+        if (cost(p, seeds[i]) < cost(p, seeds[slot])) slot = static_cast<int>(i);
+    }
+    if (seeds.empty()) {
+        seeds.push_back({0.0f, 0.0f, 1.0f, 1.0f});
+        nations.push_back(0.0f);
+    }
+
+    cl_int err = CL_SUCCESS;
+    size_t gridBytes = owner.size() * sizeof(int);
+    out.resX = resX;
+    out.resY = resY;
+    out.margin = margin;
+    out.owner = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, gridBytes,
+                                                  owner.data(), &err, "PoliticalLayer owner");
+    out.seeds = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                                                  seeds.size() * sizeof(cl_float4), seeds.data(),
+                                                  &err, "PoliticalLayer seeds");
+    out.nations = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                                                    nations.size() * sizeof(float), nations.data(),
+                                                    &err, "PoliticalLayer nations");
+    if (!out.owner || !out.seeds || !out.nations) {
+        out.release();
+        return false;
+    }
+    if (capitals.empty()) return true;
+
+    cl_mem pong = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, gridBytes, nullptr, &err,
+                                                    "PoliticalLayer owner pong");
+    if (err != CL_SUCCESS || !pong) {
+        out.release();
+        return false;
+    }
+
+    // Steps N/2, N/4, …, 1, then one more pass at 1 (JFA+1) to fix the
+    // few texels the halving sequence misses
+    std::vector<int> steps;
+    int step = 1;
+    while (step * 2 < std::max(padX, padY)) step *= 2;
+    for (; step >= 1; step /= 2) steps.push_back(step);
+    steps.push_back(1);
+
+    cl_command_queue queue = OpenCLContext::get().getQueue();
+    size_t global[2] = {static_cast<size_t>(padY), static_cast<size_t>(padX)};
+    cl_mem src = out.owner, dst = pong;
+    for (int s : steps) {
+        clSetKernelArg(gJfaStepKernel, 0, sizeof(cl_mem), &src);
+        clSetKernelArg(gJfaStepKernel, 1, sizeof(cl_mem), &dst);
+        clSetKernelArg(gJfaStepKernel, 2, sizeof(cl_mem), &out.seeds);
+        clSetKernelArg(gJfaStepKernel, 3, sizeof(int), &padY);
+        clSetKernelArg(gJfaStepKernel, 4, sizeof(int), &padX);
+        clSetKernelArg(gJfaStepKernel, 5, sizeof(int), &s);
+        clSetKernelArg(gJfaStepKernel, 6, sizeof(int), &margin);
+        clSetKernelArg(gJfaStepKernel, 7, sizeof(int), &resY);
+        clSetKernelArg(gJfaStepKernel, 8, sizeof(int), &resX);
+        clSetKernelArg(gJfaStepKernel, 9, sizeof(float), &lonMinRad);
+        clSetKernelArg(gJfaStepKernel, 10, sizeof(float), &lonMaxRad);
+        clSetKernelArg(gJfaStepKernel, 11, sizeof(float), &latMinRad);
+        clSetKernelArg(gJfaStepKernel, 12, sizeof(float), &latMaxRad);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, gJfaStepKernel, 2, nullptr, global, nullptr,
+                                                        0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            OpenCLContext::get().releaseMem(pong);
+            out.release();
+            return false;
+        }
+        std::swap(src, dst);
+    }
+    // `src` holds the last step's output; keep it, drop the other
+    out.owner = src;
+    OpenCLContext::get().releaseMem(dst);
+    return true;
+}
+
+bool PoliticalLayer::resolve(const Flood& f, float lonMinRad, float lonMaxRad, float latMinRad, float latMaxRad,
+                             cl_mem* sampleOut, cl_mem* colorOut)
+{
+    static cl_kernel gResolveKernel = nullptr;
+    try {
+        OpenCLContext::get().createProgram(gPoliticalProgram, "Kernels/Political.cl");
+        OpenCLContext::get().createKernelFromProgram(gResolveKernel, gPoliticalProgram, "political_resolve");
+    } catch (const std::runtime_error& e) {
+        PLOGE << "PoliticalLayer: failed to initialise OpenCL: " << e.what();
+        return false;
+    }
+
+    const int resX = f.resX, resY = f.resY;
+    const int padX = resX + 2 * f.margin, padY = resY + 2 * f.margin;
+    size_t count = static_cast<size_t>(resX) * resY;
+    cl_int err = CL_SUCCESS;
+
+    // Ocean stays unclaimed; same elevation the map shows for this region
+    cl_mem elevation = nullptr;
+    if (parentWorld)
+        if (MapLayer* elevLayer = parentWorld->getLayer("elevation"))
+            elevation = elevLayer->sampleRegion(lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY, nullptr);
+    int hasElevation = elevation ? 1 : 0;
+    if (!elevation)
+        elevation = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY, sizeof(float), nullptr, &err,
+                                                      "PoliticalLayer elevation stub");
+    float seaLevel = settlements().seaLevel();
+
+    cl_mem sampleBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, count * sizeof(float),
+                                                         nullptr, &err, "PoliticalLayer sample");
+    cl_mem colorBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, count * sizeof(cl_float4),
+                                                        nullptr, &err, "PoliticalLayer color");
+    bool ok = elevation && sampleBuf && colorBuf;
+    if (ok) {
+        clSetKernelArg(gResolveKernel, 0, sizeof(cl_mem), &f.owner);
+        clSetKernelArg(gResolveKernel, 1, sizeof(cl_mem), &f.seeds);
+        clSetKernelArg(gResolveKernel, 2, sizeof(cl_mem), &f.nations);
+        clSetKernelArg(gResolveKernel, 3, sizeof(cl_mem), &elevation);
+        clSetKernelArg(gResolveKernel, 4, sizeof(int), &hasElevation);
+        clSetKernelArg(gResolveKernel, 5, sizeof(float), &seaLevel);
+        clSetKernelArg(gResolveKernel, 6, sizeof(float), &range_);
+        clSetKernelArg(gResolveKernel, 7, sizeof(int), &padY);
+        clSetKernelArg(gResolveKernel, 8, sizeof(int), &padX);
+        clSetKernelArg(gResolveKernel, 9, sizeof(int), &f.margin);
+        clSetKernelArg(gResolveKernel, 10, sizeof(int), &resY);
+        clSetKernelArg(gResolveKernel, 11, sizeof(int), &resX);
+        clSetKernelArg(gResolveKernel, 12, sizeof(float), &lonMinRad);
+        clSetKernelArg(gResolveKernel, 13, sizeof(float), &lonMaxRad);
+        clSetKernelArg(gResolveKernel, 14, sizeof(float), &latMinRad);
+        clSetKernelArg(gResolveKernel, 15, sizeof(float), &latMaxRad);
+        clSetKernelArg(gResolveKernel, 16, sizeof(cl_mem), &sampleBuf);
+        clSetKernelArg(gResolveKernel, 17, sizeof(cl_mem), &colorBuf);
+
+        size_t global[2] = {static_cast<size_t>(resY), static_cast<size_t>(resX)};
+        ZoneScopedN("PoliticalLayer::resolve Enqueue");
+        err = OpenCLContext::get().enqueueNDRangeKernel(OpenCLContext::get().getQueue(), gResolveKernel,
+                                                        2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        ok = err == CL_SUCCESS;
+    }
+
+    if (elevation) OpenCLContext::get().releaseMem(elevation);
+    if (ok && sampleOut) *sampleOut = sampleBuf;
+    else if (sampleBuf) OpenCLContext::get().releaseMem(sampleBuf);
+    if (ok && colorOut) *colorOut = colorBuf;
+    else if (colorBuf) OpenCLContext::get().releaseMem(colorBuf);
+    return ok;
+}
@@ -1,7 +1,28 @@
 #include <WorldMaps/Map/RiverLayer.hpp>
 #include <WorldMaps/WorldMap.hpp>
+#include <plog/Log.h>
 #include <algorithm>
 #include <cmath>
+#include <sstream>
+
+// ── Program / kernels ───────────────────────────────────────────────
+
+static cl_program gRiverProgram = nullptr;
+static cl_kernel gRiverGridRegionKernel = nullptr;
+static cl_kernel gRiverSegmentsRegionKernel = nullptr;
+
+static bool ensureRiverKernels()
+{
+    try {
+        OpenCLContext::get().createProgram(gRiverProgram, "Kernels/Rivers.cl");
+        OpenCLContext::get().createKernelFromProgram(gRiverGridRegionKernel, gRiverProgram, "river_grid_region");
+        OpenCLContext::get().createKernelFromProgram(gRiverSegmentsRegionKernel, gRiverProgram, "river_segments_region");
+    } catch (const std::runtime_error &e) {
+        printf("Error initializing Rivers OpenCL: %s\n", e.what());
+        return false;
+    }
+    return true;
+}
 
 RiverLayer::~RiverLayer()
 {
@@ -23,7 +44,7 @@ cl_mem RiverLayer::sample()
 
 cl_mem RiverLayer::getColor()
 {
-    // build new cl_mem buffer with RGBA colors based on river data (gray scale, full alpha)
+    // build new cl_mem buffer with RGBA colors based on river intensity
     cl_mem riverBuffer = getRiverBuffer();
     cl_int err = CL_SUCCESS;
     // Convert river scalar values to a blue ramp with transparency
@@ -32,149 +53,225 @@ cl_mem RiverLayer::getColor()
         MapLayer::rgba(0, 128, 255, 255)    // blue
     };
     static std::vector<float> weights = {1.0f, 1.0f};
-    if (coloredBuffer == nullptr)
+    if (coloredBuffer == nullptr && riverBuffer != nullptr)
     {
         weightedScalarToColor(coloredBuffer, riverBuffer, parentWorld->getWorldLatitudeResolution(), parentWorld->getWorldLongitudeResolution(), 2, blueRamp, weights);
     }
     return coloredBuffer;
 }
 
-cl_mem RiverLayer::getRiverBuffer()
+// ── Parameters ──────────────────────────────────────────────────────
+
+void RiverLayer::parseParameters(const std::string &params)
 {
-    if (riverBuffer == nullptr)
-    {
-        generateRiverPaths(parentWorld->getLayer("elevation")->sample(),
-                           parentWorld->getLayer("watertable")->sample(),
-                           riverBuffer,
-                           parentWorld->getWorldLatitudeResolution(),
-                           parentWorld->getWorldLongitudeResolution(),
-                           100); // maxSteps
+    auto lock = lockParameters();
+    auto trim = [](std::string s) {
+        s.erase(0, s.find_first_not_of(" \t"));
+        s.erase(s.find_last_not_of(" \t") + 1);
+        return s;
+    };
+
+    std::istringstream iss(params);
+    std::string token;
+    while (std::getline(iss, token, ',')) {
+        auto pos = token.find(':');
+        if (pos == std::string::npos) continue;
+        std::string key   = trim(token.substr(0, pos));
+        std::string value = trim(token.substr(pos + 1));
+        try {
+            if      (key == "resolution") gridRows_   = std::clamp(std::stoi(value), 64, 8192);
+            else if (key == "area")       riverArea_  = std::max(1.0f, std::stof(value));
+            else if (key == "width")      riverWidth_ = std::max(0.0f, std::stof(value));
+        } catch (...) {
+            PLOGW << "RiverLayer::parseParameters: bad value for " << key;
+        }
+    }
+    hydrology_.reset();
+    for (cl_mem* buf : {&riverBuffer, &coloredBuffer}) {
+        if (*buf) OpenCLContext::get().releaseMem(*buf);
+        *buf = nullptr;
     }
-    return riverBuffer;
 }
 
-void RiverLayer::generateRiverPaths(cl_mem elevationBuf,
-                               cl_mem waterTableBuf,
-                               cl_mem& riverBuf,
-                               int latitudeResolution, int longitudeResolution,
-                               uint32_t maxSteps)
+// ── Drainage network ────────────────────────────────────────────────
+
+const Hydrology* RiverLayer::ensureHydrology()
 {
-    ZoneScopedN("GenerateRiverPaths");
-    if (!OpenCLContext::get().isReady()) return;
+    if (!parentWorld) return nullptr;
 
-    cl_int err = CL_SUCCESS;
-    static cl_program gRiverPathsProgram = nullptr;
-    static cl_kernel gRiverFlowSourceKernel = nullptr;
-    static cl_kernel gRiverFlowAccumulateKernel = nullptr;
-    try {
-        OpenCLContext::get().createProgram(gRiverPathsProgram, "Kernels/Rivers.cl");
-        OpenCLContext::get().createKernelFromProgram(gRiverFlowSourceKernel, gRiverPathsProgram, "river_flow_source");
-        OpenCLContext::get().createKernelFromProgram(gRiverFlowAccumulateKernel, gRiverPathsProgram, "river_flow_accumulate");
-    } catch (const std::runtime_error &e) {
-        printf("Error initializing RiverPaths OpenCL: %s\n", e.what());
-        return;
+    // Keyed by what the network depends on, so a reseeded or re-levelled
+    // world picks up (or builds) the matching network
+    HydrologyKey key;
+    key.elevation = NoiseField{1.5f, 2.0f, 0.5f, 8, 12345u};
+    if (MapLayer* elevLayer = parentWorld->getLayer("elevation")) {
+        std::vector<NoiseField> fields = elevLayer->regionNoiseFields();
+        if (!fields.empty()) key.elevation = fields.front();
+    }
+    if (auto* water = dynamic_cast<WaterTableLayer*>(parentWorld->getLayer("watertable")))
+        key.seaLevel = water->water_table_level;
+    key.riverArea = riverArea_;
+    key.rows = gridRows_;
+    key.cols = gridRows_ * 2;
+
+    if (!hydrology_ || hydrology_->key() != key) {
+        hydrology_ = Hydrology::acquire(key);
+        if (riverBuffer) { OpenCLContext::get().releaseMem(riverBuffer); riverBuffer = nullptr; }
+        if (coloredBuffer) { OpenCLContext::get().releaseMem(coloredBuffer); coloredBuffer = nullptr; }
     }
+    return hydrology_.get();
+}
+
+// ── Region (chunk) path ─────────────────────────────────────────────
+
+cl_mem RiverLayer::sampleRegion(float lonMinRad, float lonMaxRad,
+                                 float latMinRad, float latMaxRad,
+                                 int resX, int resY,
+                                 const LayerDelta* delta)
+{
+    ZoneScopedN("RiverLayer::sampleRegion");
+    if (!OpenCLContext::get().isReady()) return nullptr;
+    const Hydrology* hydro = ensureHydrology();
+    if (!hydro) return nullptr;
 
-    size_t voxels = (size_t)latitudeResolution * (size_t)longitudeResolution;
-    size_t outSize = voxels * sizeof(cl_float);
+    cl_mem riverBuf = rasterizeRegion(*hydro, lonMinRad, lonMaxRad, latMinRad, latMaxRad, resX, resY);
 
-    // allocate & zero output if needed (use host-zero copy for simplicity)
-    if (riverBuf != nullptr) {
-        cl_int r = clGetMemObjectInfo(riverBuf, CL_MEM_SIZE, sizeof(size_t), &outSize, NULL);
-        if (r != CL_SUCCESS || outSize < voxels * sizeof(cl_float)) {
-            OpenCLContext::get().releaseMem(riverBuf);
-            riverBuf = nullptr;
+    // Apply per-sample deltas if present
+    cl_int err = CL_SUCCESS;
+    if (riverBuf && delta && delta->hasGridData() &&
+        delta->resolution == resX && delta->resolution == resY) {
+        std::vector<float> dense = delta->toDense();
+        size_t deltaSize = dense.size() * sizeof(float);
+        cl_mem deltaBuf = OpenCLContext::get().createBuffer(
+            CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+            deltaSize, dense.data(),
+            &err, "river delta upload");
+        if (err == CL_SUCCESS && deltaBuf) {
+            applyDeltaScalar(riverBuf, deltaBuf, resY, resX,
+                              static_cast<int>(delta->mode));
+            OpenCLContext::get().releaseMem(deltaBuf);
         }
     }
-    if (riverBuf == nullptr) {
-        std::vector<float> zeros(voxels, 0.0f);
-        riverBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, outSize, zeros.data(), &err, "generateRiverPaths riverBuf");
-        if (err != CL_SUCCESS || riverBuf == nullptr) {
-            throw std::runtime_error("clCreateBuffer failed for generateRiverPaths riverBuf");
+
+    return riverBuf;
+}
+
+cl_mem RiverLayer::rasterizeRegion(const Hydrology& hydro,
+                                   float lonMinRad, float lonMaxRad,
+                                   float latMinRad, float latMaxRad,
+                                   int resX, int resY)
+{
+    if (!ensureRiverKernels()) return nullptr;
+
+    cl_command_queue queue = OpenCLContext::get().getQueue();
+    cl_int err = CL_SUCCESS;
+    cl_mem riverBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE,
+        static_cast<size_t>(resX) * resY * sizeof(cl_float), nullptr, &err, "river region");
+    if (err != CL_SUCCESS || !riverBuf) return nullptr;
+
+    size_t global[2] = {static_cast<size_t>(resY), static_cast<size_t>(resX)};
+    const float texLat = (latMaxRad - latMinRad) / static_cast<float>(resY);
+
+    if (texLat >= 0.5f * hydro.cellLatRad()) {
+        // Texels at least half a drainage cell: look the grid up directly
+        cl_mem grid = hydro.intensityBuffer();
+        int gridRows = hydro.rows();
+        int gridCols = hydro.cols();
+        clSetKernelArg(gRiverGridRegionKernel, 0, sizeof(cl_mem), &grid);
+        clSetKernelArg(gRiverGridRegionKernel, 1, sizeof(int), &gridRows);
+        clSetKernelArg(gRiverGridRegionKernel, 2, sizeof(int), &gridCols);
+        clSetKernelArg(gRiverGridRegionKernel, 3, sizeof(int), &resY);
+        clSetKernelArg(gRiverGridRegionKernel, 4, sizeof(int), &resX);
+        clSetKernelArg(gRiverGridRegionKernel, 5, sizeof(float), &lonMinRad);
+        clSetKernelArg(gRiverGridRegionKernel, 6, sizeof(float), &lonMaxRad);
+        clSetKernelArg(gRiverGridRegionKernel, 7, sizeof(float), &latMinRad);
+        clSetKernelArg(gRiverGridRegionKernel, 8, sizeof(float), &latMaxRad);
+        clSetKernelArg(gRiverGridRegionKernel, 9, sizeof(cl_mem), &riverBuf);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, gRiverGridRegionKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+    } else {
+        // Finer than the grid: draw the river segments under the region as
+        // capsules so channels stay smooth instead of blocky
+        std::vector<Hydrology::Segment> pieces;
+        hydro.segments(lonMinRad, lonMaxRad, latMinRad, latMaxRad, pieces);
+
+        float lonScale = std::cos(0.5f * (latMinRad + latMaxRad));
+        std::vector<cl_float4> segs;
+        std::vector<cl_float2> info;
+        segs.reserve(pieces.size() + 1);
+        info.reserve(pieces.size() + 1);
+        for (const Hydrology::Segment& p : pieces) {
+            segs.push_back({(p.lonA - lonMinRad) * lonScale, p.latA, (p.lonB - lonMinRad) * lonScale, p.latB});
+            info.push_back({p.intensity, std::max(riverWidth_ * p.intensity, 0.5f * texLat)});
+        }
+        int segCount = static_cast<int>(pieces.size());
+        if (segs.empty()) {
+            segs.push_back({0.0f, 0.0f, 0.0f, 0.0f});
+            info.push_back({0.0f, 0.0f});
         }
-    }
 
-    cl_mem flowSourceBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, voxels * sizeof(cl_float), nullptr, &err, "generateRiverPaths flowSourceBuf");
-    if (err != CL_SUCCESS || flowSourceBuf == nullptr) {
-        throw std::runtime_error("clCreateBuffer failed for generateRiverPaths flowSourceBuf");
-    }
-    cl_mem flowAccBufA = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, voxels * sizeof(cl_float), nullptr, &err, "generateRiverPaths flowAccBufA");
-    if (err != CL_SUCCESS || flowAccBufA == nullptr) {
-        throw std::runtime_error("clCreateBuffer failed for generateRiverPaths flowAccBufA");
-    }
-    cl_mem flowAccBufB = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, voxels * sizeof(cl_float), nullptr, &err, "generateRiverPaths flowAccBufB");
-    if (err != CL_SUCCESS || flowAccBufB == nullptr) {
-        throw std::runtime_error("clCreateBuffer failed for generateRiverPaths flowAccBufB");
+        cl_mem segBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+            segs.size() * sizeof(cl_float4), segs.data(), &err, "river region segments");
+        cl_mem infoBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+            info.size() * sizeof(cl_float2), info.data(), &err, "river region segmentInfo");
+        if (segBuf && infoBuf) {
+            clSetKernelArg(gRiverSegmentsRegionKernel, 0, sizeof(cl_mem), &segBuf);
+            clSetKernelArg(gRiverSegmentsRegionKernel, 1, sizeof(cl_mem), &infoBuf);
+            clSetKernelArg(gRiverSegmentsRegionKernel, 2, sizeof(int), &segCount);
+            clSetKernelArg(gRiverSegmentsRegionKernel, 3, sizeof(int), &resY);
+            clSetKernelArg(gRiverSegmentsRegionKernel, 4, sizeof(int), &resX);
+            clSetKernelArg(gRiverSegmentsRegionKernel, 5, sizeof(float), &lonMinRad);
+            clSetKernelArg(gRiverSegmentsRegionKernel, 6, sizeof(float), &lonMaxRad);
+            clSetKernelArg(gRiverSegmentsRegionKernel, 7, sizeof(float), &latMinRad);
+            clSetKernelArg(gRiverSegmentsRegionKernel, 8, sizeof(float), &latMaxRad);
+            clSetKernelArg(gRiverSegmentsRegionKernel, 9, sizeof(float), &lonScale);
+            clSetKernelArg(gRiverSegmentsRegionKernel, 10, sizeof(cl_mem), &riverBuf);
+            err = OpenCLContext::get().enqueueNDRangeKernel(queue, gRiverSegmentsRegionKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        } else {
+            err = CL_OUT_OF_RESOURCES;
+        }
+        if (segBuf) OpenCLContext::get().releaseMem(segBuf);
+        if (infoBuf) OpenCLContext::get().releaseMem(infoBuf);
     }
 
-    // Momentum buffers (store velocity as float2: dx, dy)
-    cl_mem momentumBufA = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, voxels * sizeof(cl_float2), nullptr, &err, "generateRiverPaths momentumBufA");
-    if (err != CL_SUCCESS || momentumBufA == nullptr) {
-        throw std::runtime_error("clCreateBuffer failed for generateRiverPaths momentumBufA");
+    if (err != CL_SUCCESS) {
+        printf("RiverLayer::rasterizeRegion: kernel enqueue failed: %d\n", err);
+        OpenCLContext::get().releaseMem(riverBuf);
+        return nullptr;
     }
-    cl_mem momentumBufB = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, voxels * sizeof(cl_float2), nullptr, &err, "generateRiverPaths momentumBufB");
-    if (err != CL_SUCCESS || momentumBufB == nullptr) {
-        throw std::runtime_error("clCreateBuffer failed for generateRiverPaths momentumBufB");
-    }
-    // Zero initialize momentum buffers
-    std::vector<cl_float2> zeroMomentum(voxels, {0.0f, 0.0f});
-    err = clEnqueueWriteBuffer(OpenCLContext::get().getQueue(), momentumBufA, CL_FALSE, 0, voxels * sizeof(cl_float2), zeroMomentum.data(), 0, nullptr, nullptr);
-    err = clEnqueueWriteBuffer(OpenCLContext::get().getQueue(), momentumBufB, CL_FALSE, 0, voxels * sizeof(cl_float2), zeroMomentum.data(), 0, nullptr, nullptr);
+    return riverBuf;
+}
 
-    // Step 1: create Flow Sources
+cl_mem RiverLayer::getColorRegion(float lonMinRad, float lonMaxRad,
+                                   float latMinRad, float latMaxRad,
+                                   int resX, int resY,
+                                   const LayerDelta* delta)
+{
+    cl_mem scalarBuf = sampleRegion(lonMinRad, lonMaxRad,
+                                     latMinRad, latMaxRad,
+                                     resX, resY, delta);
+    if (!scalarBuf) return nullptr;
+
+    static std::vector<cl_float4> blueRamp = {
+        MapLayer::rgba(0, 0, 0, 0),
+        MapLayer::rgba(0, 128, 255, 255)
+    };
+    static std::vector<float> weights = {1.0f, 1.0f};
+
+    cl_mem colorBuf = nullptr;
+    weightedScalarToColor(colorBuf, scalarBuf, resY, resX, 2, blueRamp, weights);
+    OpenCLContext::get().releaseMem(scalarBuf);
+    return colorBuf;
+}
+
+cl_mem RiverLayer::getRiverBuffer()
+{
+    const Hydrology* hydro = ensureHydrology();
+    if (riverBuffer == nullptr && hydro)
     {
-        float minHeight = 0.6f;
-        float maxHeight = .61f;
-        float chance = 0.001f;
-        clSetKernelArg(gRiverFlowSourceKernel, 0, sizeof(cl_mem), &elevationBuf);
-        clSetKernelArg(gRiverFlowSourceKernel, 1, sizeof(cl_mem), &waterTableBuf);
-        clSetKernelArg(gRiverFlowSourceKernel, 2, sizeof(int), &latitudeResolution);
-        clSetKernelArg(gRiverFlowSourceKernel, 3, sizeof(int), &longitudeResolution);
-        clSetKernelArg(gRiverFlowSourceKernel, 4, sizeof(cl_mem), &flowSourceBuf);
-        clSetKernelArg(gRiverFlowSourceKernel, 5, sizeof(float), &minHeight);
-        clSetKernelArg(gRiverFlowSourceKernel, 6, sizeof(float), &maxHeight);
-        clSetKernelArg(gRiverFlowSourceKernel, 7, sizeof(float), &chance);
-
-        size_t global[2] = {(size_t)latitudeResolution, (size_t)longitudeResolution};
-        err = clEnqueueNDRangeKernel(OpenCLContext::get().getQueue(), gRiverFlowSourceKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
-        if (err != CL_SUCCESS) {
-            printf("river_flow_source kernel enqueue failed: %d\n", err);
-        }
+        ZoneScopedN("RiverLayer::getRiverBuffer");
+        const float pi = static_cast<float>(M_PI);
+        riverBuffer = rasterizeRegion(*hydro, -pi, pi, -pi / 2.0f, pi / 2.0f,
+                                      parentWorld->getWorldLongitudeResolution(),
+                                      parentWorld->getWorldLatitudeResolution());
     }
-    // Step 3: Iteratively accumulate flow
-    const int flowIterations = maxSteps;
-    float river_threshold = 0.1f;
-    float slope_epsilon = 0.0002f;
-    float height_epsilon = 0.001f;
-    float momentum_strength = 0.7f;  // How much rivers maintain their direction (0=no momentum, 1=all momentum)
-    for (int iter = 0; iter < flowIterations; ++iter) {
-
-        clSetKernelArg(gRiverFlowAccumulateKernel, 0, sizeof(cl_mem), &elevationBuf);
-        clSetKernelArg(gRiverFlowAccumulateKernel, 1, sizeof(cl_mem), &waterTableBuf);
-        clSetKernelArg(gRiverFlowAccumulateKernel, 2, sizeof(cl_mem), &flowSourceBuf);
-        clSetKernelArg(gRiverFlowAccumulateKernel, 3, sizeof(int), &latitudeResolution);
-        clSetKernelArg(gRiverFlowAccumulateKernel, 4, sizeof(int), &longitudeResolution);
-        clSetKernelArg(gRiverFlowAccumulateKernel, 5, sizeof(cl_mem), &flowAccBufA);
-        clSetKernelArg(gRiverFlowAccumulateKernel, 6, sizeof(cl_mem), &flowAccBufB);
-        clSetKernelArg(gRiverFlowAccumulateKernel, 7, sizeof(cl_mem), &momentumBufA);
-        clSetKernelArg(gRiverFlowAccumulateKernel, 8, sizeof(cl_mem), &momentumBufB);
-        clSetKernelArg(gRiverFlowAccumulateKernel, 9, sizeof(float), &river_threshold);
-        clSetKernelArg(gRiverFlowAccumulateKernel, 10, sizeof(float), &slope_epsilon);
-        clSetKernelArg(gRiverFlowAccumulateKernel, 11, sizeof(float), &height_epsilon);
-        clSetKernelArg(gRiverFlowAccumulateKernel, 12, sizeof(float), &momentum_strength);
-        size_t global[2] = {(size_t)latitudeResolution, (size_t)longitudeResolution};
-        err = clEnqueueNDRangeKernel(OpenCLContext::get().getQueue(), gRiverFlowAccumulateKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
-        if (err != CL_SUCCESS) {
-            printf("river_flow_accumulate kernel enqueue failed: %d\n", err);
-        }
-        // Swap buffers
-        std::swap(flowAccBufA, flowAccBufB);
-        std::swap(momentumBufA, momentumBufB);
-    }
-    // set the riverBuffer to the final accumulated flow buffer NO COPY
-    OpenCLContext::get().releaseMem(flowSourceBuf);
-    OpenCLContext::get().releaseMem(flowAccBufA);
-    OpenCLContext::get().releaseMem(momentumBufA);
-    OpenCLContext::get().releaseMem(momentumBufB);
-    riverBuf = flowAccBufB;
-}
\ No newline at end of file
+    return riverBuffer;
+}
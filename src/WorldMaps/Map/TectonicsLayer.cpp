@@ -1,8 +1,11 @@
 #include <WorldMaps/Map/TectonicsLayer.hpp>
 #include <WorldMaps/World/World.hpp>
+#include <Vault.hpp>
+#include <Util/CacheFile.hpp>
 #include <tracy/Tracy.hpp>
 #include <plog/Log.h>
 #include <sstream>
+#include <zstd.h>
 
 // Static OpenCL program and kernel handles
 static cl_program gTectonicsProgram = nullptr;
@@ -10,9 +13,14 @@ static cl_kernel gInitKernel = nullptr;
 static cl_kernel gStepKernel = nullptr;
 static cl_kernel gExtractKernel = nullptr;
 static cl_kernel gProjectKernel = nullptr;
+static cl_kernel gRegionKernel = nullptr;
+
+// Vault checkpoint namespace for this layer's simulation state
+static const char* kCheckpointLayerName = "tectonics";
 
 TectonicsLayer::~TectonicsLayer()
 {
+    pollCheckpoint(true);
     releaseBuffers();
 }
 
@@ -46,6 +54,9 @@ void TectonicsLayer::parseParameters(const std::string &params)
 
         try {
             if (key == "steps") { simulationSteps = std::stoi(value); }
+            else if (key == "stepsperframe") { stepsPerFrame = std::max(1, std::stoi(value)); }
+            else if (key == "preview") { previewInterval = std::max(1, std::stoi(value)); }
+            else if (key == "checkpoint") { checkpointInterval = std::max(1, std::stoi(value)); }
             else if (key == "uvres") { uvResolution = std::stoul(value); }
             else if (key == "dt") { dt = std::stof(value); }
             else if (key == "seed") { seed = std::stoul(value); }
@@ -54,23 +65,300 @@ void TectonicsLayer::parseParameters(const std::string &params)
             PLOGW << "TectonicsLayer::parseParameters: failed to parse " << key << "=" << value;
         }
     }
+    configuredParamHash.clear();   // recomputed on next use
+}
+
+bool TectonicsLayer::ensureSurface()
+{
+    // First use starts the simulation (resuming from a vault checkpoint when
+    // one matches); the steps themselves are advanced by tick().
+    if (state == SimulationState::Idle && !startSimulation()) return false;
+    return surfaceBuffer != nullptr && lastPreviewStep >= 0;
+}
+
+// ── Incremental simulation ──────────────────────────────────────────
+
+std::string TectonicsLayer::parameterHash() const
+{
+    // The kernel source is part of the key so checkpoints from an older
+    // simulation model are never resumed.
+    static const uint64_t kernelHash = []() -> uint64_t {
+        try { return CacheFile::fnv1a64(preprocessCLIncludes("Kernels/Tectonics.cl")); }
+        catch (const std::exception&) { return 0; }
+    }();
+
+    std::ostringstream oss;
+    oss << "uvres=" << uvResolution << ";dt=" << dt << ";seed=" << seed
+        << ";plates=" << numPlates << ";kernel=" << kernelHash;
+
+    return CacheFile::toHex(CacheFile::fnv1a64(oss.str()));
+}
+
+const std::string& TectonicsLayer::currentParamHash()
+{
+    if (configuredParamHash.empty()) configuredParamHash = parameterHash();
+    return configuredParamHash;
+}
+
+bool TectonicsLayer::startSimulation()
+{
+    ZoneScopedN("TectonicsLayer::startSimulation");
+
+    releaseBuffers();
+    activeParamHash = currentParamHash();
+    completedSteps = 0;
+    lastPreviewStep = -1;
+    lastCheckpointStep = 0;
+
+    PLOGI << "TectonicsLayer - starting simulation (" << simulationSteps
+          << " steps, " << stepsPerFrame << " per frame, params " << activeParamHash << ")";
+    if (!initializeSimulation()) {
+        PLOGE << "TectonicsLayer - initialization failed";
+        state = SimulationState::Failed;
+        return false;
+    }
+    lastCheckpointStep = completedSteps;
+
+    extractSurface();
+    lastPreviewStep = completedSteps;
+    state = completedSteps >= simulationSteps ? SimulationState::Complete : SimulationState::Running;
+    return true;
+}
+
+bool TectonicsLayer::tick()
+{
+    if (state == SimulationState::Idle || state == SimulationState::Failed) return false;
+
+    ZoneScopedN("TectonicsLayer::tick");
+    pollCheckpoint(false);
+
+    // Parameter edits (or fewer steps than already simulated) invalidate the run
+    if (activeParamHash != currentParamHash() || completedSteps > simulationSteps) {
+        PLOGI << "TectonicsLayer - parameters changed, restarting simulation";
+        outputChanged = false;
+        return startSimulation();
+    }
+    if (state == SimulationState::Complete && completedSteps < simulationSteps)
+        state = SimulationState::Running;
+
+    bool changed = std::exchange(outputChanged, false);
+    if (state != SimulationState::Running) return changed;
+
+    int steps = std::min(stepsPerFrame, simulationSteps - completedSteps);
+    if (steps > 0 && !stepSimulation(steps)) {
+        state = SimulationState::Failed;
+        return changed;
+    }
+
+    bool done = completedSteps >= simulationSteps;
+    if (done || completedSteps - lastCheckpointStep >= checkpointInterval)
+        saveCheckpoint();
+
+    if (done || completedSteps - lastPreviewStep >= previewInterval) {
+        extractSurface();
+        invalidateOutputs();
+        lastPreviewStep = completedSteps;
+        changed = true;
+    }
+    if (done) {
+        state = SimulationState::Complete;
+        PLOGI << "TectonicsLayer - simulation complete (" << completedSteps << " steps)";
+    }
+    return changed;
+}
+
+float TectonicsLayer::getProgress() const
+{
+    if (state == SimulationState::Complete || simulationSteps <= 0) return 1.0f;
+    return std::clamp(static_cast<float>(completedSteps) / static_cast<float>(simulationSteps), 0.0f, 1.0f);
+}
+
+void TectonicsLayer::cancel()
+{
+    if (state != SimulationState::Running) return;
+    saveCheckpoint();
+    if (lastPreviewStep != completedSteps) {
+        extractSurface();
+        invalidateOutputs();
+        lastPreviewStep = completedSteps;
+        outputChanged = true;
+    }
+    state = SimulationState::Cancelled;
+    PLOGI << "TectonicsLayer - simulation cancelled at step " << completedSteps;
+}
+
+void TectonicsLayer::resume()
+{
+    if (state == SimulationState::Cancelled) state = SimulationState::Running;
+}
+
+void TectonicsLayer::restart()
+{
+    if (Vault* vault = parentWorld ? parentWorld->getVault() : nullptr)
+        vault->deleteSimulationCheckpoint(kCheckpointLayerName, currentParamHash());
+    if (state == SimulationState::Idle) return;
+    startSimulation();
+    outputChanged = true;
+}
+
+bool TectonicsLayer::runToCompletion()
+{
+    ZoneScopedN("TectonicsLayer::runToCompletion");
+    if (state == SimulationState::Idle && !startSimulation()) return false;
+    if (state == SimulationState::Failed) return false;
+
+    int remaining = simulationSteps - completedSteps;
+    if (remaining > 0) {
+        runSimulation(remaining);
+        if (completedSteps < simulationSteps) {
+            state = SimulationState::Failed;
+            return false;
+        }
+        saveCheckpoint();
+        extractSurface();
+        invalidateOutputs();
+        lastPreviewStep = completedSteps;
+        outputChanged = true;
+    }
+    state = SimulationState::Complete;
+    return true;
+}
+
+void TectonicsLayer::invalidateOutputs()
+{
+    // Full-world products are re-derived lazily from the new surface
+    if (heightmapBuffer) { OpenCLContext::get().releaseMem(heightmapBuffer); heightmapBuffer = nullptr; }
+    if (coloredBuffer) { OpenCLContext::get().releaseMem(coloredBuffer); coloredBuffer = nullptr; }
+}
+
+bool TectonicsLayer::loadCheckpoint()
+{
+    ZoneScopedN("TectonicsLayer::loadCheckpoint");
+    Vault* vault = parentWorld ? parentWorld->getVault() : nullptr;
+    if (!vault || voxelBufferA == nullptr) return false;
+
+    int step = 0, totalSteps = 0;
+    uint64_t rawSize = 0;
+    std::vector<uint8_t> packed;
+    if (!vault->loadSimulationCheckpoint(kCheckpointLayerName, activeParamHash, step, totalSteps, rawSize, packed))
+        return false;
+
+    size_t expected = 6 * uvResolution * uvResolution * sizeof(TecVoxel);
+    if (rawSize != expected || packed.empty() || step > simulationSteps) {
+        PLOGI << "TectonicsLayer: ignoring checkpoint at step " << step << " (incompatible with current run)";
+        return false;
+    }
+
+    std::vector<uint8_t> raw(expected);
+    size_t got = ZSTD_decompress(raw.data(), raw.size(), packed.data(), packed.size());
+    if (ZSTD_isError(got) || got != expected) {
+        PLOGW << "TectonicsLayer: corrupt checkpoint for " << activeParamHash;
+        return false;
+    }
+
+    cl_int err = clEnqueueWriteBuffer(OpenCLContext::get().getQueue(), voxelBufferA, CL_TRUE, 0,
+                                      expected, raw.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        PLOGE << "TectonicsLayer: checkpoint upload failed: " << err;
+        return false;
+    }
+    completedSteps = step;
+    PLOGI << "TectonicsLayer: resumed from checkpoint at step " << step << "/" << simulationSteps;
+    return true;
+}
+
+void TectonicsLayer::saveCheckpoint()
+{
+    ZoneScopedN("TectonicsLayer::saveCheckpoint");
+    Vault* vault = parentWorld ? parentWorld->getVault() : nullptr;
+    if (!vault || voxelBufferA == nullptr || completedSteps == lastCheckpointStep) return;
+    if (pendingCheckpoint) return;   // one in flight; tick() retries once it lands
+
+    // Non-blocking readback; the in-order queue runs it before the next steps
+    // overwrite the buffer.  pollCheckpoint() takes it from there.
+    auto pending = std::make_unique<PendingCheckpoint>();
+    pending->raw.resize(6 * uvResolution * uvResolution * sizeof(TecVoxel));
+    pending->paramHash = activeParamHash;
+    pending->step = completedSteps;
+    pending->totalSteps = simulationSteps;
+    cl_command_queue queue = OpenCLContext::get().getQueue();
+    cl_int err = OpenCLContext::get().enqueueReadBuffer(queue, voxelBufferA, CL_FALSE, 0, pending->raw.size(),
+                                                        pending->raw.data(), 0, nullptr, &pending->readDone);
+    if (err != CL_SUCCESS) {
+        PLOGE << "TectonicsLayer: checkpoint readback failed: " << err;
+        return;
+    }
+    clFlush(queue);
+    pendingCheckpoint = std::move(pending);
+}
+
+void TectonicsLayer::pollCheckpoint(bool wait)
+{
+    PendingCheckpoint* pending = pendingCheckpoint.get();
+    if (!pending) return;
+
+    if (pending->readDone) {
+        cl_int status = CL_COMPLETE;
+        if (wait) {
+            clWaitForEvents(1, &pending->readDone);
+        } else {
+            clGetEventInfo(pending->readDone, CL_EVENT_COMMAND_EXECUTION_STATUS,
+                           sizeof(status), &status, nullptr);
+            if (status > CL_COMPLETE) return;   // still queued or running
+        }
+        clReleaseEvent(pending->readDone);
+        pending->readDone = nullptr;
+        if (status < 0) {
+            PLOGE << "TectonicsLayer: checkpoint readback failed: " << status;
+            pendingCheckpoint.reset();
+            return;
+        }
+
+        // Compression and the vault write run off the UI thread
+        Vault* vault = parentWorld ? parentWorld->getVault() : nullptr;
+        if (!vault) { pendingCheckpoint.reset(); return; }
+        pending->write = std::async(std::launch::async, [pending, vault]() {
+            ZoneScopedN("TectonicsLayer::writeCheckpoint");
+            std::vector<uint8_t> packed(ZSTD_compressBound(pending->raw.size()));
+            size_t packedSize = ZSTD_compress(packed.data(), packed.size(),
+                                              pending->raw.data(), pending->raw.size(), 3);
+            if (ZSTD_isError(packedSize)) {
+                PLOGW << "TectonicsLayer: checkpoint compression failed: " << ZSTD_getErrorName(packedSize);
+                return false;
+            }
+            packed.resize(packedSize);
+
+            if (!vault->saveSimulationCheckpoint(kCheckpointLayerName, pending->paramHash, pending->step,
+                                                 pending->totalSteps, pending->raw.size(), packed)) {
+                PLOGW << "TectonicsLayer: failed to store checkpoint at step " << pending->step;
+                return false;
+            }
+            PLOGI << "TectonicsLayer: checkpoint at step " << pending->step
+                  << " (" << (packedSize / 1024) << " KB)";
+            return true;
+        });
+    }
+
+    if (!wait && pending->write.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+    bool stored = pending->write.get();
+    // A restart since the readback makes the result irrelevant to this run
+    if (stored && pending->paramHash == activeParamHash && pending->step <= completedSteps)
+        lastCheckpointStep = std::max(lastCheckpointStep, pending->step);
+    pendingCheckpoint.reset();
 }
 
 cl_mem TectonicsLayer::sample()
 {
     ZoneScopedN("TectonicsLayer::sample");
     
-    if (!simulationComplete) {
-        PLOGW << "TectonicsLayer::sample - starting simulation";
-        if (initializeSimulation()) {
-            runSimulation(simulationSteps);
-            extractHeightmap();
-            simulationComplete = true;
-            PLOGW << "TectonicsLayer::sample - simulation complete";
-        } else {
-            PLOGE << "TectonicsLayer::sample - initialization failed";
-            return nullptr;
-        }
+    if (!ensureSurface()) return nullptr;
+
+    if (heightmapBuffer == nullptr) {
+        // Project to lat/lon
+        int latRes = parentWorld ? parentWorld->getWorldLatitudeResolution() : 4096;
+        int lonRes = parentWorld ? parentWorld->getWorldLongitudeResolution() : 4096;
+        cubemapToLatLon(surfaceBuffer, heightmapBuffer, latRes, lonRes);
+        clFinish(OpenCLContext::get().getQueue());
     }
     
     return heightmapBuffer;
@@ -95,6 +383,87 @@ cl_mem TectonicsLayer::getColor()
     return coloredBuffer;
 }
 
+cl_mem TectonicsLayer::sampleRegion(float lonMinRad, float lonMaxRad,
+                                     float latMinRad, float latMaxRad,
+                                     int resX, int resY,
+                                     const LayerDelta* delta)
+{
+    ZoneScopedN("TectonicsLayer::sampleRegion");
+
+    // The simulation itself is global (plates span the whole sphere), but
+    // once the cubemap surface exists each chunk only resamples its own
+    // footprint instead of projecting the full 4096² lat/lon heightmap.
+    if (!ensureSurface()) return nullptr;
+
+    cl_int err = CL_SUCCESS;
+    size_t pixelCount = static_cast<size_t>(resX) * resY;
+    cl_mem regionBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, pixelCount * sizeof(float),
+                                                         nullptr, &err, "tec region");
+    if (err != CL_SUCCESS || regionBuf == nullptr) {
+        PLOGE << "TectonicsLayer: Failed to allocate region buffer: " << err;
+        return nullptr;
+    }
+
+    int uvRes = static_cast<int>(uvResolution);
+    clSetKernelArg(gRegionKernel, 0, sizeof(cl_mem), &surfaceBuffer);
+    clSetKernelArg(gRegionKernel, 1, sizeof(cl_mem), &regionBuf);
+    clSetKernelArg(gRegionKernel, 2, sizeof(int), &uvRes);
+    clSetKernelArg(gRegionKernel, 3, sizeof(int), &resY);
+    clSetKernelArg(gRegionKernel, 4, sizeof(int), &resX);
+    clSetKernelArg(gRegionKernel, 5, sizeof(float), &lonMinRad);
+    clSetKernelArg(gRegionKernel, 6, sizeof(float), &lonMaxRad);
+    clSetKernelArg(gRegionKernel, 7, sizeof(float), &latMinRad);
+    clSetKernelArg(gRegionKernel, 8, sizeof(float), &latMaxRad);
+
+    size_t global[2] = { static_cast<size_t>(resY), static_cast<size_t>(resX) };
+    err = OpenCLContext::get().enqueueNDRangeKernel(OpenCLContext::get().getQueue(), gRegionKernel,
+                                 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        PLOGE << "TectonicsLayer: tec_cubemap_to_region failed: " << err;
+        OpenCLContext::get().releaseMem(regionBuf);
+        return nullptr;
+    }
+
+    // Apply per-sample deltas if present
+    if (delta && delta->hasGridData() &&
+        delta->resolution == resX && delta->resolution == resY) {
+        std::vector<float> dense = delta->toDense();
+        size_t deltaSize = dense.size() * sizeof(float);
+        cl_mem deltaBuf = OpenCLContext::get().createBuffer(
+            CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+            deltaSize, dense.data(),
+            &err, "tectonics delta upload");
+        if (err == CL_SUCCESS && deltaBuf) {
+            applyDeltaScalar(regionBuf, deltaBuf, resY, resX,
+                              static_cast<int>(delta->mode));
+            OpenCLContext::get().releaseMem(deltaBuf);
+        }
+    }
+
+    return regionBuf;
+}
+
+cl_mem TectonicsLayer::getColorRegion(float lonMinRad, float lonMaxRad,
+                                       float latMinRad, float latMaxRad,
+                                       int resX, int resY,
+                                       const LayerDelta* delta)
+{
+    cl_mem scalarBuf = sampleRegion(lonMinRad, lonMaxRad,
+                                     latMinRad, latMaxRad,
+                                     resX, resY, delta);
+    if (!scalarBuf) return nullptr;
+
+    static std::vector<cl_float4> grayRamp = {
+        MapLayer::rgba(0, 0, 0, 255),
+        MapLayer::rgba(255, 255, 255, 255)
+    };
+
+    cl_mem colorBuf = nullptr;
+    scalarToColor(colorBuf, scalarBuf, resY, resX, 2, grayRamp);
+    OpenCLContext::get().releaseMem(scalarBuf);
+    return colorBuf;
+}
+
 bool TectonicsLayer::initializeSimulation()
 {
     ZoneScopedN("TectonicsLayer::initializeSimulation");
@@ -120,6 +489,7 @@ bool TectonicsLayer::initializeSimulation()
         OpenCLContext::get().createKernelFromProgram(gStepKernel, gTectonicsProgram, "tec_step");
         OpenCLContext::get().createKernelFromProgram(gExtractKernel, gTectonicsProgram, "tec_extract_height");
         OpenCLContext::get().createKernelFromProgram(gProjectKernel, gTectonicsProgram, "tec_cubemap_to_latlon");
+        OpenCLContext::get().createKernelFromProgram(gRegionKernel, gTectonicsProgram, "tec_cubemap_to_region");
         PLOGW << "TectonicsLayer: Kernels created";
     }
     
@@ -138,6 +508,9 @@ bool TectonicsLayer::initializeSimulation()
     surfaceBuffer = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, numVoxels * sizeof(float), nullptr, &err, "tec surface");
     if (err != CL_SUCCESS) { PLOGE << "Failed to allocate surfaceBuffer: " << err; return false; }
     
+    // Resume from a stored checkpoint when the parameters match
+    if (loadCheckpoint()) return true;
+
     // Run initialization kernel
     cl_command_queue queue = OpenCLContext::get().getQueue();
     
@@ -153,7 +526,7 @@ bool TectonicsLayer::initializeSimulation()
     size_t global[2] = { 6 * uvResolution, uvResolution };
     PLOGW << "TectonicsLayer: Running tec_init (" << global[0] << "x" << global[1] << ")";
     
-    err = clEnqueueNDRangeKernel(queue, gInitKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+    err = OpenCLContext::get().enqueueNDRangeKernel(queue, gInitKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
     if (err != CL_SUCCESS) {
         PLOGE << "TectonicsLayer: tec_init failed: " << err;
         return false;
@@ -164,13 +537,13 @@ bool TectonicsLayer::initializeSimulation()
     return true;
 }
 
-void TectonicsLayer::runSimulation(int steps)
+bool TectonicsLayer::stepSimulation(int steps)
 {
-    ZoneScopedN("TectonicsLayer::runSimulation");
+    ZoneScopedN("TectonicsLayer::stepSimulation");
     
     if (!OpenCLContext::get().isReady() || voxelBufferA == nullptr) {
         PLOGE << "TectonicsLayer: Cannot run simulation - not initialized";
-        return;
+        return false;
     }
     
     cl_command_queue queue = OpenCLContext::get().getQueue();
@@ -181,41 +554,50 @@ void TectonicsLayer::runSimulation(int steps)
     cl_mem* inputBuffer = &voxelBufferA;
     cl_mem* outputBuffer = &voxelBufferB;
     
-    PLOGW << "TectonicsLayer: Running " << steps << " simulation steps";
-    
     size_t global[2] = { 6 * uvResolution, uvResolution };
     
+    // Enqueue only; the in-order queue serializes later reads behind these steps
+    bool ok = true;
     for (int step = 0; step < steps; step++) {
         clSetKernelArg(gStepKernel, 0, sizeof(cl_mem), inputBuffer);
         clSetKernelArg(gStepKernel, 1, sizeof(cl_mem), outputBuffer);
         clSetKernelArg(gStepKernel, 2, sizeof(int), &uvRes);
         clSetKernelArg(gStepKernel, 3, sizeof(float), &dt);
         
-        err = clEnqueueNDRangeKernel(queue, gStepKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, gStepKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
         if (err != CL_SUCCESS) {
-            PLOGE << "TectonicsLayer: tec_step failed at step " << step << ": " << err;
-            return;
+            PLOGE << "TectonicsLayer: tec_step failed at step " << (completedSteps + step) << ": " << err;
+            ok = false;
+            break;
         }
         
         // Ping-pong buffers
         std::swap(inputBuffer, outputBuffer);
+        ++completedSteps;
     }
     
-    // Make sure voxelBufferA has the final result
+    // Make sure voxelBufferA has the latest result
     if (inputBuffer != &voxelBufferA) {
         std::swap(voxelBufferA, voxelBufferB);
     }
-    
-    clFinish(queue);
+    return ok;
+}
+
+void TectonicsLayer::runSimulation(int steps)
+{
+    ZoneScopedN("TectonicsLayer::runSimulation");
+    PLOGW << "TectonicsLayer: Running " << steps << " simulation steps";
+    if (!stepSimulation(steps)) return;
+    clFinish(OpenCLContext::get().getQueue());
     PLOGW << "TectonicsLayer: Simulation complete";
 }
 
-void TectonicsLayer::extractHeightmap()
+void TectonicsLayer::extractSurface()
 {
-    ZoneScopedN("TectonicsLayer::extractHeightmap");
+    ZoneScopedN("TectonicsLayer::extractSurface");
     
     if (!OpenCLContext::get().isReady() || voxelBufferA == nullptr) {
-        PLOGE << "TectonicsLayer: Cannot extract heightmap - not ready";
+        PLOGE << "TectonicsLayer: Cannot extract surface - not ready";
         return;
     }
     
@@ -236,20 +618,14 @@ void TectonicsLayer::extractHeightmap()
     size_t global[2] = { 6 * uvResolution, uvResolution };
     PLOGW << "TectonicsLayer: Running tec_extract_height";
     
-    err = clEnqueueNDRangeKernel(queue, gExtractKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+    err = OpenCLContext::get().enqueueNDRangeKernel(queue, gExtractKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
     if (err != CL_SUCCESS) {
         PLOGE << "TectonicsLayer: tec_extract_height failed: " << err;
         return;
     }
     
-    // Project to lat/lon
-    int latRes = parentWorld ? parentWorld->getWorldLatitudeResolution() : 4096;
-    int lonRes = parentWorld ? parentWorld->getWorldLongitudeResolution() : 4096;
-    
-    cubemapToLatLon(surfaceBuffer, heightmapBuffer, latRes, lonRes);
-    
     clFinish(queue);
-    PLOGW << "TectonicsLayer: Heightmap extraction complete";
+    PLOGW << "TectonicsLayer: Surface extraction complete";
 }
 
 void TectonicsLayer::cubemapToLatLon(cl_mem cubemapSurface, cl_mem& latlonOutput,
@@ -283,7 +659,7 @@ void TectonicsLayer::cubemapToLatLon(cl_mem cubemapSurface, cl_mem& latlonOutput
     size_t global[2] = { static_cast<size_t>(latRes), static_cast<size_t>(lonRes) };
     PLOGW << "TectonicsLayer: Running tec_cubemap_to_latlon";
     
-    err = clEnqueueNDRangeKernel(OpenCLContext::get().getQueue(), gProjectKernel, 
+    err = OpenCLContext::get().enqueueNDRangeKernel(OpenCLContext::get().getQueue(), gProjectKernel, 
                                   2, nullptr, global, nullptr, 0, nullptr, nullptr);
     if (err != CL_SUCCESS) {
         PLOGE << "TectonicsLayer: tec_cubemap_to_latlon failed: " << err;
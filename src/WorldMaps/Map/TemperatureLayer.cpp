@@ -1,6 +1,7 @@
 #include <WorldMaps/Map/TemperatureLayer.hpp>
 #include <WorldMaps/WorldMap.hpp>
 #include <WorldMaps/World/LayerDelta.hpp>
+#include <plog/Log.h>
 #include <ctime>
 #include <cmath>
 
@@ -9,6 +10,20 @@ TemperatureLayer::TemperatureLayer()
     seed_ = static_cast<unsigned int>(time(0));
 }
 
+void TemperatureLayer::parseParameters(const std::string &params)
+{
+    auto lock = lockParameters();
+    for (const auto &token : splitBracketAware(params, ",")) {
+        auto kv = splitBracketAware(token, ":");
+        if (kv.size() != 2) continue;
+        try {
+            if (kv[0] == "seed") seed_ = static_cast<unsigned int>(std::stoul(kv[1]));
+        } catch (const std::exception &) {
+            PLOGW << "TemperatureLayer::parseParameters: bad value for " << kv[0];
+        }
+    }
+}
+
 TemperatureLayer::~TemperatureLayer()
 {
     if (temperatureBuffer != nullptr)
@@ -137,7 +152,7 @@ void TemperatureLayer::tempMap(cl_mem &output,
     size_t global[2] = {(size_t)latitudeResolution, (size_t)longitudeResolution};
     {
         // ZoneScopedN("LandTypeLayer::landtypeColorMap enqueue kernel");
-        err = clEnqueueNDRangeKernel(queue, kernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, kernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
     }
 }
 
@@ -152,43 +167,39 @@ cl_mem TemperatureLayer::sampleRegion(float lonMinRad, float lonMaxRad,
     if (!OpenCLContext::get().isReady()) return nullptr;
 
     // Apply parameter overrides from delta
-    float freq = frequency_;
-    float lac  = lacunarity_;
-    int   oct  = octaves_;
-    float pers = persistence_;
-    unsigned int sd = seed_;
+    NoiseField field = regionNoiseFields().front();
     if (delta) {
-        freq = delta->getParam("frequency",   freq);
-        lac  = delta->getParam("lacunarity",  lac);
-        oct  = static_cast<int>(delta->getParam("octaves", static_cast<float>(oct)));
-        pers = delta->getParam("persistence", pers);
-        sd   = static_cast<unsigned int>(delta->getParam("seed", static_cast<float>(sd)));
+        field.frequency   = delta->getParam("frequency",   field.frequency);
+        field.lacunarity  = delta->getParam("lacunarity",  field.lacunarity);
+        field.octaves     = static_cast<int>(delta->getParam("octaves", static_cast<float>(field.octaves)));
+        field.persistence = delta->getParam("persistence", field.persistence);
+        field.seed        = static_cast<unsigned int>(delta->getParam("seed", static_cast<float>(field.seed)));
     }
 
-    // Convert lon/lat bounds to theta/phi
-    float thetaMin = static_cast<float>(M_PI / 2.0) - latMaxRad;
-    float thetaMax = static_cast<float>(M_PI / 2.0) - latMinRad;
-    float phiMin = lonMinRad + static_cast<float>(M_PI);
-    float phiMax = lonMaxRad + static_cast<float>(M_PI);
+    // Noise for this region, shared with the world's other noise layers
+    size_t count = static_cast<size_t>(resX) * resY;
+    std::vector<float> noiseData;
+    cl_int err = CL_SUCCESS;
+    if (!parentWorld || !parentWorld->readRegionNoise(lonMinRad, lonMaxRad, latMinRad, latMaxRad,
+                                                      resX, resY, {field}, noiseData)) {
+        float thetaMin = static_cast<float>(M_PI / 2.0) - latMaxRad;
+        float thetaMax = static_cast<float>(M_PI / 2.0) - latMinRad;
+        float phiMin = lonMinRad + static_cast<float>(M_PI);
+        float phiMax = lonMaxRad + static_cast<float>(M_PI);
 
-    // Generate Perlin noise on GPU for this region
-    cl_mem noiseBuf = nullptr;
-    perlinRegion(noiseBuf, resY, resX,
-                 thetaMin, thetaMax, phiMin, phiMax,
-                 freq, lac, oct, pers, sd);
-    if (!noiseBuf) return nullptr;
+        cl_mem noiseBuf = nullptr;
+        perlinRegion(noiseBuf, resY, resX,
+                     thetaMin, thetaMax, phiMin, phiMax,
+                     field.frequency, field.lacunarity, field.octaves, field.persistence, field.seed);
+        if (!noiseBuf) return nullptr;
 
-    // Read noise back to CPU
-    size_t count = static_cast<size_t>(resX) * resY;
-    std::vector<float> noiseData(count);
-    cl_int err = clEnqueueReadBuffer(OpenCLContext::get().getQueue(), noiseBuf,
-                                      CL_TRUE, 0, count * sizeof(float),
-                                      noiseData.data(), 0, nullptr, nullptr);
-    if (err != CL_SUCCESS) {
+        noiseData.resize(count);
+        err = OpenCLContext::get().enqueueReadBuffer(OpenCLContext::get().getQueue(), noiseBuf,
+                                          CL_TRUE, 0, count * sizeof(float),
+                                          noiseData.data(), 0, nullptr, nullptr);
         OpenCLContext::get().releaseMem(noiseBuf);
-        return nullptr;
+        if (err != CL_SUCCESS) return nullptr;
     }
-    OpenCLContext::get().releaseMem(noiseBuf);
 
     // Compute temperature on CPU: latFactor * 0.5 + noise * 0.5
     // latFactor = 1.0 - |2 * latNorm - 1|, where latNorm ∈ [0,1] (north→south)
@@ -214,12 +225,13 @@ cl_mem TemperatureLayer::sampleRegion(float lonMinRad, float lonMaxRad,
     if (err != CL_SUCCESS || !regionBuf) return nullptr;
 
     // Apply per-sample deltas if present
-    if (delta && !delta->data.empty() &&
+    if (delta && delta->hasGridData() &&
         delta->resolution == resX && delta->resolution == resY) {
-        size_t deltaSize = delta->data.size() * sizeof(float);
+        std::vector<float> dense = delta->toDense();
+        size_t deltaSize = dense.size() * sizeof(float);
         cl_mem deltaBuf = OpenCLContext::get().createBuffer(
             CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-            deltaSize, const_cast<float*>(delta->data.data()),
+            deltaSize, dense.data(),
             &err, "temperature delta upload");
         if (err == CL_SUCCESS && deltaBuf) {
             applyDeltaScalar(regionBuf, deltaBuf, resY, resX,
@@ -94,7 +94,7 @@ cl_mem WaterTableLayer::getWaterTableBuffer()
 
         {
             ZoneScopedN("WaterTableLayer::getWaterTableBuffer Enqueue");
-            err = clEnqueueNDRangeKernel(
+            err = OpenCLContext::get().enqueueNDRangeKernel(
                 OpenCLContext::get().getQueue(),
                 gWaterTableKernel,
                 2,
@@ -193,7 +193,7 @@ void WaterTableLayer::waterTableWeightedScalarToColor(cl_mem& output,
     
     {
         ZoneScopedN("WeightedScalarToColor Enqueue");
-        err = clEnqueueNDRangeKernel(queue, gWeightedScalarToColorKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, gWeightedScalarToColorKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
     }
     OpenCLContext::get().releaseMem(paletteBuf);
     OpenCLContext::get().releaseMem(weightsBuf);
@@ -221,7 +221,7 @@ cl_mem WaterTableLayer::sampleRegion(float lonMinRad, float lonMaxRad,
     // Read elevation data back to CPU
     size_t count = static_cast<size_t>(resX) * resY;
     std::vector<float> elevData(count);
-    cl_int err = clEnqueueReadBuffer(OpenCLContext::get().getQueue(), elevBuf,
+    cl_int err = OpenCLContext::get().enqueueReadBuffer(OpenCLContext::get().getQueue(), elevBuf,
                                       CL_TRUE, 0, count * sizeof(float),
                                       elevData.data(), 0, nullptr, nullptr);
     OpenCLContext::get().releaseMem(elevBuf);
@@ -249,12 +249,13 @@ cl_mem WaterTableLayer::sampleRegion(float lonMinRad, float lonMaxRad,
     if (err != CL_SUCCESS || !regionBuf) return nullptr;
 
     // Apply per-sample deltas
-    if (delta && !delta->data.empty() &&
+    if (delta && delta->hasGridData() &&
         delta->resolution == resX && delta->resolution == resY) {
-        size_t deltaSize = delta->data.size() * sizeof(float);
+        std::vector<float> dense = delta->toDense();
+        size_t deltaSize = dense.size() * sizeof(float);
         cl_mem deltaBuf = OpenCLContext::get().createBuffer(
             CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-            deltaSize, const_cast<float*>(delta->data.data()),
+            deltaSize, dense.data(),
             &err, "watertable delta upload");
         if (err == CL_SUCCESS && deltaBuf) {
             applyDeltaScalar(regionBuf, deltaBuf, resY, resX,
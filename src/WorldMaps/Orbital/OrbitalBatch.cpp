@@ -0,0 +1,219 @@
+#include <WorldMaps/Orbital/OrbitalBatch.hpp>
+#include <tracy/Tracy.hpp>
+#include <cmath>
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define LOREBOOK_SIMD_ORBITS 1
+namespace stdx = std::experimental;
+#endif
+
+namespace Orbital {
+
+namespace {
+
+// ── Lane helpers ─────────────────────────────────────────────────────
+// The solver is written once against a lane type: double for the scalar
+// tail, native_simd<double> for the vector body.
+
+inline double loadLanes(const double* p, double) { return *p; }
+inline void storeLanes(double* p, double v) { *p = v; }
+inline double selectLanes(bool m, double a, double b) { return m ? a : b; }
+
+#ifdef LOREBOOK_SIMD_ORBITS
+using VecD = stdx::native_simd<double>;
+
+inline VecD loadLanes(const double* p, const VecD&) { return VecD(p, stdx::element_aligned); }
+inline void storeLanes(double* p, const VecD& v) { v.copy_to(p, stdx::element_aligned); }
+inline VecD selectLanes(const VecD::mask_type& m, const VecD& a, const VecD& b)
+{
+    VecD r = b;
+    stdx::where(m, r) = a;
+    return r;
+}
+#endif
+
+// Calls f(i, lane) over [0, n) with full vectors first, then scalars.
+template<class F>
+inline void forLanes(size_t n, F&& f)
+{
+    size_t i = 0;
+#ifdef LOREBOOK_SIMD_ORBITS
+    for (; i + VecD::size() <= n; i += VecD::size()) f(i, VecD());
+#endif
+    for (; i < n; ++i) f(i, 0.0);
+}
+
+template<class V>
+inline V keplerLanes(V M, const V& e)
+{
+    using std::cos; using std::floor; using std::sin;
+    const double twoPi = 2.0 * M_PI;
+    M = M - twoPi * floor(M * (1.0 / twoPi));   // [0, 2π)
+
+    // Danby's starting guess, then a fixed number of Newton steps
+    V k = e * 0.85;
+    V E = M + selectLanes(sin(M) < 0.0, V(-k), k);
+    for (int it = 0; it < KEPLER_BATCH_ITERATIONS; ++it)
+        E = E - (E - e * sin(E) - M) / (1.0 - e * cos(E));
+    return E;
+}
+
+} // namespace
+
+void solveKeplerBatch(const double* M, const double* e, double* E, size_t n)
+{
+    forLanes(n, [&](size_t i, auto lane) {
+        storeLanes(E + i, keplerLanes(loadLanes(M + i, lane), loadLanes(e + i, lane)));
+    });
+}
+
+// ── OrbitBatch ───────────────────────────────────────────────────────
+
+void OrbitBatch::clear()
+{
+    for (auto* v : { &meanAnomalyEpoch, &meanMotion, &eccentricity, &semiMajorAxis, &minorFactor,
+                     &px, &py, &pz, &qx, &qy, &qz })
+        v->clear();
+}
+
+void OrbitBatch::assign(const std::vector<KeplerianElements>& elements)
+{
+    clear();
+    for (auto* v : { &meanAnomalyEpoch, &meanMotion, &eccentricity, &semiMajorAxis, &minorFactor,
+                     &px, &py, &pz, &qx, &qy, &qz })
+        v->reserve(elements.size());
+    for (const auto& elem : elements) push(elem);
+}
+
+void OrbitBatch::push(const KeplerianElements& elem)
+{
+    // Invalid orbits get zero axes and motion, so they sit at the origin
+    // exactly like orbitalPosition()'s early-out.
+    bool valid = elem.period > 0.0 && elem.semiMajorAxis > 0.0;
+    double e = valid ? elem.eccentricity : 0.0;
+    meanAnomalyEpoch.push_back(valid ? elem.meanAnomalyEpoch : 0.0);
+    meanMotion.push_back(valid ? 2.0 * M_PI / elem.period : 0.0);
+    eccentricity.push_back(e);
+    semiMajorAxis.push_back(valid ? elem.semiMajorAxis : 0.0);
+    minorFactor.push_back(std::sqrt(std::max(0.0, 1.0 - e * e)));
+
+    // Same rotation as orbitalPosition: R_z(-Ω) · R_x(-i) · R_z(-ω)
+    double cosW = std::cos(elem.argPeriapsis), sinW = std::sin(elem.argPeriapsis);
+    double cosI = std::cos(elem.inclination),  sinI = std::sin(elem.inclination);
+    double cosO = std::cos(elem.longAscNode),  sinO = std::sin(elem.longAscNode);
+    px.push_back(cosO * cosW - sinO * sinW * cosI);
+    py.push_back(sinO * cosW + cosO * sinW * cosI);
+    pz.push_back(sinW * sinI);
+    qx.push_back(-cosO * sinW - sinO * cosW * cosI);
+    qy.push_back(-sinO * sinW + cosO * cosW * cosI);
+    qz.push_back(cosW * sinI);
+}
+
+// ── Batched positions ────────────────────────────────────────────────
+
+namespace {
+
+// Positions for orbit `orbit[i]` at mean anomaly M[i]; orbit == nullptr
+// means orbit i.  Writes planar x/y/z.
+void positionsFromMeanAnomaly(const OrbitBatch& b, const size_t* orbit, const double* M, size_t n,
+                              double* x, double* y, double* z)
+{
+    // Gather per-sample elements when several samples share an orbit
+    std::vector<double> gathered;
+    const double* src[9] = { b.eccentricity.data(), b.semiMajorAxis.data(), b.minorFactor.data(),
+                             b.px.data(), b.py.data(), b.pz.data(), b.qx.data(), b.qy.data(), b.qz.data() };
+    if (orbit) {
+        gathered.resize(9 * n);
+        for (int f = 0; f < 9; ++f) {
+            double* dst = gathered.data() + f * n;
+            for (size_t i = 0; i < n; ++i) dst[i] = src[f][orbit[i]];
+            src[f] = dst;
+        }
+    }
+
+    forLanes(n, [&](size_t i, auto lane) {
+        using V = decltype(lane);
+        using std::cos; using std::sin;
+        V e = loadLanes(src[0] + i, lane);
+        V E = keplerLanes(loadLanes(M + i, lane), e);
+        V cE = cos(E), sE = sin(E);
+        // Perifocal position straight from E (equivalent to r·cos v, r·sin v)
+        V a = loadLanes(src[1] + i, lane);
+        V xo = a * (cE - e);
+        V yo = a * loadLanes(src[2] + i, lane) * sE;
+        storeLanes(x + i, loadLanes(src[3] + i, lane) * xo + loadLanes(src[6] + i, lane) * yo);
+        storeLanes(y + i, loadLanes(src[4] + i, lane) * xo + loadLanes(src[7] + i, lane) * yo);
+        storeLanes(z + i, loadLanes(src[5] + i, lane) * xo + loadLanes(src[8] + i, lane) * yo);
+    });
+}
+
+} // namespace
+
+void orbitalPositionsBatch(const OrbitBatch& batch, double t, std::vector<glm::dvec3>& out)
+{
+    ZoneScopedN("orbitalPositionsBatch");
+    size_t n = batch.size();
+    std::vector<double> scratch(4 * n);
+    double* M = scratch.data();
+    for (size_t i = 0; i < n; ++i) M[i] = batch.meanAnomalyEpoch[i] + batch.meanMotion[i] * t;
+
+    double* x = M + n;
+    double* y = x + n;
+    double* z = y + n;
+    positionsFromMeanAnomaly(batch, nullptr, M, n, x, y, z);
+
+    out.resize(n);
+    for (size_t i = 0; i < n; ++i) out[i] = glm::dvec3(x[i], y[i], z[i]);
+}
+
+void orbitPathPointsBatch(const KeplerianElements& elem, int segments, std::vector<glm::dvec3>& out)
+{
+    out.clear();
+    if (segments <= 0) return;
+
+    OrbitBatch single;
+    single.push(elem);
+    size_t n = static_cast<size_t>(segments);
+    std::vector<double> scratch(4 * n);
+    std::vector<size_t> orbit(n, 0);
+    double* M = scratch.data();
+    // t = period · i / segments, so M advances by 2π / segments per sample
+    for (size_t i = 0; i < n; ++i)
+        M[i] = single.meanAnomalyEpoch[0] + single.meanMotion[0] * (elem.period * static_cast<double>(i) / static_cast<double>(segments));
+
+    double* x = M + n;
+    double* y = x + n;
+    double* z = y + n;
+    positionsFromMeanAnomaly(single, orbit.data(), M, n, x, y, z);
+
+    out.resize(n);
+    for (size_t i = 0; i < n; ++i) out[i] = glm::dvec3(x[i], y[i], z[i]);
+}
+
+// ── OrbitPathCache ───────────────────────────────────────────────────
+
+const std::vector<glm::dvec3>& OrbitPathCache::path(const KeplerianElements& elem, int segments)
+{
+    uint64_t key = orbitalElementsHash(elem) ^ (static_cast<uint64_t>(segments) * 0x9e3779b97f4a7c15ull);
+    Entry& entry = m_paths[key];
+    if (entry.points.empty() || entry.segments != segments || entry.elements != elem) {
+        ZoneScopedN("OrbitPathCache regenerate");
+        entry.elements = elem;
+        entry.segments = segments;
+        orbitPathPointsBatch(elem, segments, entry.points);
+    }
+    entry.used = true;
+    return entry.points;
+}
+
+void OrbitPathCache::sweep()
+{
+    for (auto it = m_paths.begin(); it != m_paths.end();) {
+        if (!it->second.used) { it = m_paths.erase(it); continue; }
+        it->second.used = false;
+        ++it;
+    }
+}
+
+} // namespace Orbital
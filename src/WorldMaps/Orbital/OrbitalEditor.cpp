@@ -9,7 +9,11 @@
 namespace Orbital {
 
 OrbitalEditor::~OrbitalEditor() {
-    if (m_texture) { glDeleteTextures(1, &m_texture); m_texture = 0; }
+    if (m_texture) {
+        ProjectionUpload::release(m_texture);
+        glDeleteTextures(1, &m_texture);
+        m_texture = 0;
+    }
 }
 
 void OrbitalEditor::render() {
@@ -163,6 +167,10 @@ void OrbitalEditor::renderMenuBar() {
             if (ImGui::MenuItem("Show Orbits", nullptr, &drawOrbits)) {
                 m_projection.setDrawOrbits(drawOrbits);
             }
+            bool gpuPaths = m_projection.gpuOrbitPaths();
+            if (ImGui::MenuItem("GPU Orbit Paths", nullptr, &gpuPaths)) {
+                m_projection.setGpuOrbitPaths(gpuPaths);
+            }
             ImGui::DragFloat2("Preview Size", &m_viewSize.x, 8.0f, 128.0f, 2048.0f, "%.0f");
             ImGui::EndMenu();
         }
@@ -356,6 +364,7 @@ void OrbitalEditor::renderViewport() {
     }
 
     // Project
+    m_projection.setUploadFormat(ProjectionUpload::Format::RGBA8);
     m_projection.project(m_system, w, h, m_texture);
 
     if (m_texture) {
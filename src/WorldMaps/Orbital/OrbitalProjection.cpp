@@ -11,11 +11,11 @@ namespace Orbital {
 cl_program OrbitalProjection::s_program = nullptr;
 cl_kernel OrbitalProjection::s_sphereKernel = nullptr;
 cl_kernel OrbitalProjection::s_orbitKernel = nullptr;
+cl_kernel OrbitalProjection::s_pathKernel = nullptr;
 
 OrbitalProjection::~OrbitalProjection() {
     if (m_outputBuffer) { OpenCLContext::get().releaseMem(m_outputBuffer); m_outputBuffer = nullptr; }
     if (m_bodyDefBuffer) { OpenCLContext::get().releaseMem(m_bodyDefBuffer); m_bodyDefBuffer = nullptr; }
-    if (m_orbitPointsBuffer) { OpenCLContext::get().releaseMem(m_orbitPointsBuffer); m_orbitPointsBuffer = nullptr; }
 }
 
 void OrbitalProjection::ensureProgram() {
@@ -96,17 +96,19 @@ void OrbitalProjection::project(OrbitalSystem& system, int width, int height, GL
     if (uLen < 1e-6f) uLen = 1.0f;
     uX /= uLen; uY /= uLen; uZ /= uLen;
 
-    // Compute body positions at current time (analytical or N-body)
+    // Compute body positions at current time (analytical or N-body).
+    // Orbit lines always hang off the analytic parent positions.
+    std::vector<OrbitalSystem::BodyPosition> analytic = system.bodyPositionsAt(m_time);
     std::vector<OrbitalSystem::BodyPosition> positions;
     if (m_useNBody) {
         try {
             positions = system.simulateNBodyPositions(m_time, m_nbodyDt);
         } catch (...) {
             // fallback to analytic if simulation fails
-            positions = system.bodyPositionsAt(m_time);
+            positions = analytic;
         }
     } else {
-        positions = system.bodyPositionsAt(m_time);
+        positions = analytic;
     }
 
     // Dispatch sphere kernel
@@ -118,43 +120,14 @@ void OrbitalProjection::project(OrbitalSystem& system, int width, int height, GL
 
     // Dispatch orbit lines on top
     if (m_drawOrbits) {
-        dispatchOrbitLines(system, width, height,
+        dispatchOrbitLines(system, analytic, width, height,
                            camPosX, camPosY, camPosZ,
                            fwdX, fwdY, fwdZ,
                            rX, rY, rZ,
                            uX, uY, uZ);
     }
 
-    // GL texture management
-    if (texture == 0) {
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
-    } else {
-        glBindTexture(GL_TEXTURE_2D, texture);
-        GLint tw = 0, th = 0;
-        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &tw);
-        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &th);
-        if (tw != width || th != height) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
-        }
-    }
-
-    // Readback
-    size_t bufSize = (size_t)width * (size_t)height * sizeof(float) * 4;
-    std::vector<float> hostBuf((size_t)width * (size_t)height * 4);
-    cl_int err = clEnqueueReadBuffer(OpenCLContext::get().getQueue(), m_outputBuffer, CL_TRUE,
-                                     0, bufSize, hostBuf.data(), 0, nullptr, nullptr);
-    if (err != CL_SUCCESS) {
-        PLOGE << "Orbital readback failed: " << err;
-        return;
-    }
-    clFinish(OpenCLContext::get().getQueue());
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_FLOAT, hostBuf.data());
+    ProjectionUpload::upload(m_outputBuffer, width, height, texture, m_uploadFormat, GL_CLAMP_TO_EDGE);
 }
 
 void OrbitalProjection::dispatchSpheres(
@@ -269,8 +242,109 @@ void OrbitalProjection::dispatchSpheres(
     OpenCLContext::get().releaseMem(heightBuf);
 }
 
+// Grow a device buffer to hold at least `bytes`; contents are not kept.
+static bool ensureDeviceCapacity(cl_mem& buf, size_t& capacity, size_t bytes, const char* tag) {
+    if (buf && capacity >= bytes) return true;
+    if (buf) { OpenCLContext::get().releaseMem(buf); buf = nullptr; }
+    cl_int err = CL_SUCCESS;
+    size_t grown = std::max(bytes, capacity * 2);
+    buf = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, grown, nullptr, &err, tag);
+    capacity = (err == CL_SUCCESS && buf) ? grown : 0;
+    return capacity != 0;
+}
+
+static glm::dvec3 parentOffset(const CelestialBody* body,
+                               const std::unordered_map<const CelestialBody*, glm::dvec3>& worldPos) {
+    if (!body->parent) return glm::dvec3(0.0);
+    auto it = worldPos.find(body->parent);
+    return it != worldPos.end() ? it->second : glm::dvec3(0.0);
+}
+
+int OrbitalProjection::preparePathsCPU(OrbitLineGroup& group,
+                                       const std::unordered_map<const CelestialBody*, glm::dvec3>& worldPos,
+                                       int pointsPerOrbit) {
+    // Paths come from the cache; only the parent offset changes per frame
+    group.hostPoints.clear();
+    group.hostPoints.reserve(group.bodies.size() * pointsPerOrbit);
+    for (const CelestialBody* body : group.bodies) {
+        glm::dvec3 parentPos = parentOffset(body, worldPos);
+        for (const glm::dvec3& p : m_pathCache.path(body->orbit, pointsPerOrbit)) {
+            glm::dvec3 worldPt = parentPos + p;
+            group.hostPoints.push_back({(float)worldPt.x, (float)worldPt.y, (float)worldPt.z, 0.0f});
+        }
+    }
+    if (group.hostPoints.empty()) return 0;
+
+    size_t bytes = group.hostPoints.size() * sizeof(cl_float4);
+    if (!ensureDeviceCapacity(group.points, group.pointCapacity, bytes, "orbital orbit points"))
+        return 0;
+    cl_int err = clEnqueueWriteBuffer(OpenCLContext::get().getQueue(), group.points, CL_TRUE, 0, bytes,
+                                      group.hostPoints.data(), 0, nullptr, nullptr);
+    return err == CL_SUCCESS ? (int)group.hostPoints.size() : 0;
+}
+
+int OrbitalProjection::preparePathsGPU(OrbitLineGroup& group,
+                                       const std::unordered_map<const CelestialBody*, glm::dvec3>& worldPos,
+                                       int pointsPerOrbit) {
+    cl_command_queue queue = OpenCLContext::get().getQueue();
+    cl_int err = CL_SUCCESS;
+    int orbitCount = (int)group.bodies.size();
+
+    // Orbit basis: re-uploaded only when some body's elements change
+    uint64_t h = 1469598103934665603ull ^ group.bodies.size();
+    for (const CelestialBody* body : group.bodies) h = orbitalElementsHash(body->orbit, h);
+    if (h != group.orbitsHash || !group.orbits) {
+        OrbitBatch batch;
+        for (const CelestialBody* body : group.bodies) batch.push(body->orbit);
+        group.hostOrbits.clear();
+        group.hostOrbits.reserve(orbitCount * 3);
+        for (int i = 0; i < orbitCount; ++i) {
+            // Reduced on the host so the float kernel sees a small angle
+            double M0 = std::fmod(batch.meanAnomalyEpoch[i], 2.0 * M_PI);
+            group.hostOrbits.push_back({(float)batch.px[i], (float)batch.py[i], (float)batch.pz[i], (float)batch.semiMajorAxis[i]});
+            group.hostOrbits.push_back({(float)batch.qx[i], (float)batch.qy[i], (float)batch.qz[i], (float)batch.eccentricity[i]});
+            group.hostOrbits.push_back({(float)M0, (float)batch.minorFactor[i], 0.0f, 0.0f});
+        }
+        size_t bytes = group.hostOrbits.size() * sizeof(cl_float4);
+        if (!ensureDeviceCapacity(group.orbits, group.orbitCapacity, bytes, "orbital path orbits"))
+            return 0;
+        err = clEnqueueWriteBuffer(queue, group.orbits, CL_TRUE, 0, bytes, group.hostOrbits.data(),
+                                   0, nullptr, nullptr);
+        if (err != CL_SUCCESS) return 0;
+        group.orbitsHash = h;
+    }
+
+    group.hostOffsets.clear();
+    for (const CelestialBody* body : group.bodies) {
+        glm::dvec3 p = parentOffset(body, worldPos);
+        group.hostOffsets.push_back({(float)p.x, (float)p.y, (float)p.z, 0.0f});
+    }
+    size_t offsetBytes = group.hostOffsets.size() * sizeof(cl_float4);
+    size_t pointCount = (size_t)orbitCount * pointsPerOrbit;
+    if (!ensureDeviceCapacity(group.offsets, group.offsetCapacity, offsetBytes, "orbital path offsets") ||
+        !ensureDeviceCapacity(group.points, group.pointCapacity, pointCount * sizeof(cl_float4), "orbital orbit points"))
+        return 0;
+    err = clEnqueueWriteBuffer(queue, group.offsets, CL_TRUE, 0, offsetBytes, group.hostOffsets.data(),
+                               0, nullptr, nullptr);
+    if (err != CL_SUCCESS) return 0;
+
+    clSetKernelArg(s_pathKernel, 0, sizeof(cl_mem), &group.orbits);
+    clSetKernelArg(s_pathKernel, 1, sizeof(cl_mem), &group.offsets);
+    clSetKernelArg(s_pathKernel, 2, sizeof(int), &orbitCount);
+    clSetKernelArg(s_pathKernel, 3, sizeof(int), &pointsPerOrbit);
+    clSetKernelArg(s_pathKernel, 4, sizeof(cl_mem), &group.points);
+    size_t global = pointCount;
+    err = clEnqueueNDRangeKernel(queue, s_pathKernel, 1, nullptr, &global, nullptr, 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        PLOGE << "orbital path kernel dispatch failed: " << err;
+        return 0;
+    }
+    return (int)pointCount;
+}
+
 void OrbitalProjection::dispatchOrbitLines(
     const OrbitalSystem& system,
+    const std::vector<OrbitalSystem::BodyPosition>& analytic,
     int width, int height,
     float camPosX, float camPosY, float camPosZ,
     float camFwdX, float camFwdY, float camFwdZ,
@@ -288,38 +362,40 @@ void OrbitalProjection::dispatchOrbitLines(
         }
     }
 
-    // Collect orbit path points for all non-root bodies
-    const int POINTS_PER_ORBIT = 128;
-    std::vector<cl_float4> allPoints;
-    std::vector<cl_float4> beltPoints; // asteroid belt orbits rendered separately (thicker band)
+    if (m_gpuOrbitPaths && !s_pathKernel) {
+        s_pathKernel = clCreateKernel(s_program, "orbital_orbit_paths", &err);
+        if (err != CL_SUCCESS) {
+            PLOGE << "Failed to create orbital_orbit_paths kernel: " << err << " (using host paths)";
+            s_pathKernel = nullptr;
+            m_gpuOrbitPaths = false;
+        }
+    }
 
+    // Sort orbiting bodies into plain orbits and asteroid belts (thicker band)
+    const int POINTS_PER_ORBIT = 128;
+    m_orbitLines.bodies.clear();
+    m_beltLines.bodies.clear();
     for (auto& body : system.bodies()) {
         if (body->parentBodyID < 0) continue;  // root bodies (stars) don't orbit
         if (body->orbit.period <= 0.0) continue;
+        (body->bodyType == BodyType::AsteroidBelt ? m_beltLines : m_orbitLines).bodies.push_back(body.get());
+    }
 
-        // Get parent position for offset
-        glm::dvec3 parentPos(0.0);
-        if (body->parent) {
-            parentPos = body->parent->worldPositionAt(m_time);
-        }
+    // Parent positions this frame
+    std::unordered_map<const CelestialBody*, glm::dvec3> worldPos;
+    worldPos.reserve(analytic.size());
+    for (const auto& bp : analytic) worldPos[bp.body] = bp.position;
 
-        auto pts = orbitPathPoints(body->orbit, POINTS_PER_ORBIT);
-
-        if (body->bodyType == BodyType::AsteroidBelt) {
-            // Asteroid belts: output as band points (rendered thicker)
-            for (auto& p : pts) {
-                glm::dvec3 worldPt = parentPos + p;
-                beltPoints.push_back({(float)worldPt.x, (float)worldPt.y, (float)worldPt.z, 0.0f});
-            }
-        } else {
-            for (auto& p : pts) {
-                glm::dvec3 worldPt = parentPos + p;
-                allPoints.push_back({(float)worldPt.x, (float)worldPt.y, (float)worldPt.z, 0.0f});
-            }
-        }
-    }
+    auto preparePaths = [&](OrbitLineGroup& group) {
+        if (group.bodies.empty()) return 0;
+        return m_gpuOrbitPaths ? preparePathsGPU(group, worldPos, POINTS_PER_ORBIT)
+                               : preparePathsCPU(group, worldPos, POINTS_PER_ORBIT);
+    };
+    int pointCount = preparePaths(m_orbitLines);
+    int beltCount = preparePaths(m_beltLines);
+    m_pathCache.sweep();
 
-    if (allPoints.empty() && beltPoints.empty()) return;
+    if (pointCount == 0 && beltCount == 0) return;
 
     cl_float3 camPos = {camPosX, camPosY, camPosZ};
     cl_float3 camFwd = {camFwdX, camFwdY, camFwdZ};
@@ -328,14 +404,8 @@ void OrbitalProjection::dispatchOrbitLines(
     size_t global[2] = {(size_t)width, (size_t)height};
 
     // Dispatch normal orbit lines
-    if (!allPoints.empty()) {
-        int pointCount = (int)allPoints.size();
-
-        if (m_orbitPointsBuffer) { OpenCLContext::get().releaseMem(m_orbitPointsBuffer); m_orbitPointsBuffer = nullptr; }
-        m_orbitPointsBuffer = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-            allPoints.size() * sizeof(cl_float4), allPoints.data(), &err, "orbital orbit points");
-
-        clSetKernelArg(s_orbitKernel, 0, sizeof(cl_mem), &m_orbitPointsBuffer);
+    if (pointCount > 0) {
+        clSetKernelArg(s_orbitKernel, 0, sizeof(cl_mem), &m_orbitLines.points);
         clSetKernelArg(s_orbitKernel, 1, sizeof(int), &pointCount);
         clSetKernelArg(s_orbitKernel, 2, sizeof(cl_mem), &m_outputBuffer);
         clSetKernelArg(s_orbitKernel, 3, sizeof(int), &width);
@@ -359,13 +429,8 @@ void OrbitalProjection::dispatchOrbitLines(
     }
 
     // Dispatch asteroid belt orbits as wider, semi-transparent bands
-    if (!beltPoints.empty()) {
-        int beltCount = (int)beltPoints.size();
-
-        cl_mem beltBuf = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-            beltPoints.size() * sizeof(cl_float4), beltPoints.data(), &err, "orbital belt points");
-
-        clSetKernelArg(s_orbitKernel, 0, sizeof(cl_mem), &beltBuf);
+    if (beltCount > 0) {
+        clSetKernelArg(s_orbitKernel, 0, sizeof(cl_mem), &m_beltLines.points);
         clSetKernelArg(s_orbitKernel, 1, sizeof(int), &beltCount);
         clSetKernelArg(s_orbitKernel, 2, sizeof(cl_mem), &m_outputBuffer);
         clSetKernelArg(s_orbitKernel, 3, sizeof(int), &width);
@@ -386,8 +451,6 @@ void OrbitalProjection::dispatchOrbitLines(
         if (err != CL_SUCCESS) {
             PLOGE << "orbital belt lines kernel dispatch failed: " << err;
         }
-
-        OpenCLContext::get().releaseMem(beltBuf);
     }
 }
 
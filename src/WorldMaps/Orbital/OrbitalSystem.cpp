@@ -2,6 +2,7 @@
 #include <Vault.hpp>
 #include <plog/Log.h>
 #include <functional>
+#include <unordered_map>
 
 namespace Orbital {
 
@@ -60,11 +61,58 @@ std::vector<CelestialBody*> OrbitalSystem::rootBodies() const {
     return roots;
 }
 
+void OrbitalSystem::refreshBatch() const {
+    // Bodies are edited in place by the editor, so fingerprint the orbits
+    // and parent links rather than relying on explicit invalidation.
+    uint64_t h = 1469598103934665603ull ^ m_bodies.size();
+    for (const auto& b : m_bodies) {
+        h = orbitalElementsHash(b->orbit, h);
+        h = (h ^ static_cast<uint64_t>(b->parentBodyID)) * 1099511628211ull;
+        h = (h ^ reinterpret_cast<uintptr_t>(b->parent)) * 1099511628211ull;
+    }
+    if (m_batchValid && h == m_batchHash) return;
+
+    std::vector<KeplerianElements> elements;
+    elements.reserve(m_bodies.size());
+    std::unordered_map<const CelestialBody*, int> index;
+    for (size_t i = 0; i < m_bodies.size(); ++i) {
+        elements.push_back(m_bodies[i]->orbit);
+        index[m_bodies[i].get()] = static_cast<int>(i);
+    }
+    m_batch.assign(elements);
+    m_batchParent.assign(m_bodies.size(), -1);
+    for (size_t i = 0; i < m_bodies.size(); ++i) {
+        auto it = index.find(m_bodies[i]->parent);
+        if (it != index.end()) m_batchParent[i] = it->second;
+    }
+    m_batchHash = h;
+    m_batchValid = true;
+}
+
 std::vector<OrbitalSystem::BodyPosition> OrbitalSystem::bodyPositionsAt(double t) const {
+    refreshBatch();
+    orbitalPositionsBatch(m_batch, t, m_batchLocal);
+
+    // Accumulate parent positions; parents may come after their children
+    size_t n = m_bodies.size();
+    std::vector<glm::dvec3> world(n, glm::dvec3(0.0));
+    std::vector<uint8_t> state(n, 0);   // 0 = pending, 1 = in progress, 2 = done
+    std::function<void(int)> resolve = [&](int i) {
+        if (state[i] == 2) return;
+        if (state[i] == 1) { world[i] = glm::dvec3(0.0); return; } // parent cycle
+        state[i] = 1;
+        glm::dvec3 local = (m_bodies[i]->parentBodyID >= 0) ? m_batchLocal[i] : glm::dvec3(0.0);
+        int p = m_batchParent[i];
+        if (p >= 0) resolve(p);
+        world[i] = (p >= 0 ? world[p] : glm::dvec3(0.0)) + local;
+        state[i] = 2;
+    };
+
     std::vector<BodyPosition> result;
-    result.reserve(m_bodies.size());
-    for (const auto& b : m_bodies) {
-        result.push_back({b.get(), b->worldPositionAt(t)});
+    result.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        resolve(static_cast<int>(i));
+        result.push_back({m_bodies[i].get(), world[i]});
     }
     return result;
 }
@@ -0,0 +1,293 @@
+#include <WorldMaps/World/BrushEngine.hpp>
+#include <plog/Log.h>
+#include <tracy/Tracy.hpp>
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+// ── Program / kernel ────────────────────────────────────────────────
+
+static cl_program gBrushProgram = nullptr;
+static cl_kernel gBrushStampKernel = nullptr;
+
+static bool ensureBrushKernel()
+{
+    try {
+        OpenCLContext::get().createProgram(gBrushProgram, "Kernels/BrushStamp.cl");
+        OpenCLContext::get().createKernelFromProgram(gBrushStampKernel, gBrushProgram, "brush_stamp_patches");
+    } catch (const std::runtime_error &e) {
+        PLOGE << "BrushEngine: failed to build brush kernel: " << e.what();
+        return false;
+    }
+    return true;
+}
+
+static bool ensureCapacity(cl_mem& buf, size_t& cap, size_t bytes, const char* tag)
+{
+    if (buf && cap >= bytes) return true;
+    if (buf) OpenCLContext::get().releaseMem(buf);
+    cl_int err = CL_SUCCESS;
+    size_t grown = std::max(bytes, cap * 2);
+    buf = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, grown, nullptr, &err, tag);
+    if (err != CL_SUCCESS || !buf) {
+        buf = nullptr;
+        cap = 0;
+        return false;
+    }
+    cap = grown;
+    return true;
+}
+
+static float wrapLon(float lon)
+{
+    const float twoPi = static_cast<float>(2.0 * M_PI);
+    lon = std::fmod(lon + static_cast<float>(M_PI), twoPi);
+    if (lon < 0.0f) lon += twoPi;
+    return lon - static_cast<float>(M_PI);
+}
+
+// ── Stroke lifecycle ────────────────────────────────────────────────
+
+BrushEngine::~BrushEngine()
+{
+    releaseBuffers();
+}
+
+void BrushEngine::releaseBuffers()
+{
+    if (patchBuf_)  { OpenCLContext::get().releaseMem(patchBuf_);  patchBuf_ = nullptr; }
+    if (rectBuf_)   { OpenCLContext::get().releaseMem(rectBuf_);   rectBuf_ = nullptr; }
+    if (originBuf_) { OpenCLContext::get().releaseMem(originBuf_); originBuf_ = nullptr; }
+    if (dabBuf_)    { OpenCLContext::get().releaseMem(dabBuf_);    dabBuf_ = nullptr; }
+    patchCap_ = rectCap_ = originCap_ = dabCap_ = 0;
+}
+
+void BrushEngine::beginStroke(const std::string& layerName, int depth)
+{
+    active_ = true;
+    hasLast_ = false;
+    carry_ = 0.0f;
+    layerName_ = layerName;
+    depth_ = std::clamp(depth, 0, CHUNK_MAX_DEPTH);
+}
+
+void BrushEngine::endStroke()
+{
+    active_ = false;
+    hasLast_ = false;
+    // Staging only lives for the stroke so nothing outlives the CL context
+    releaseBuffers();
+}
+
+void BrushEngine::strokeTo(World& world, float lonRad, float latRad, const Settings& settings)
+{
+    ZoneScopedN("BrushEngine::strokeTo");
+    if (!active_ || settings.radius <= 0.0f) return;
+
+    latRad = std::clamp(latRad, -static_cast<float>(M_PI) / 2.0f, static_cast<float>(M_PI) / 2.0f);
+    std::vector<Dab> dabs;
+    collectDabs(wrapLon(lonRad), latRad, settings, dabs);
+    if (!dabs.empty())
+        stamp(world, dabs, settings);
+}
+
+// ── Stroke interpolation ────────────────────────────────────────────
+
+void BrushEngine::collectDabs(float lonRad, float latRad, const Settings& settings, std::vector<Dab>& out)
+{
+    if (!hasLast_) {
+        out.push_back({ lonRad, latRad });
+        lastLon_ = lonRad;
+        lastLat_ = latRad;
+        carry_ = 0.0f;
+        hasLast_ = true;
+        return;
+    }
+
+    // Measure the segment in samples of the paint depth so spacing follows
+    // the brush radius regardless of zoom.
+    int cells = 1 << depth_;
+    float sampleW = static_cast<float>(2.0 * M_PI) / cells / CHUNK_BASE_RES;
+    float sampleH = static_cast<float>(M_PI) / cells / CHUNK_BASE_RES;
+
+    float dLon = wrapLon(lonRad - lastLon_);
+    float dLat = latRad - lastLat_;
+    float len = std::sqrt((dLon / sampleW) * (dLon / sampleW) + (dLat / sampleH) * (dLat / sampleH));
+    float step = std::max(0.5f, settings.radius * settings.spacing);
+
+    float pos = step - carry_;
+    while (len > 0.0f && pos <= len) {
+        float f = pos / len;
+        out.push_back({ wrapLon(lastLon_ + dLon * f), lastLat_ + dLat * f });
+        pos += step;
+    }
+    carry_ = len - (pos - step);
+    lastLon_ = lonRad;
+    lastLat_ = latRad;
+}
+
+// ── Chunk coverage ──────────────────────────────────────────────────
+
+void BrushEngine::collectPatches(World& world, const std::vector<Dab>& dabs, const Settings& settings,
+                                 std::vector<Patch>& out)
+{
+    const float pi = static_cast<float>(M_PI);
+    int paintCells = 1 << depth_;
+    float radiusLon = settings.radius * (2.0f * pi / paintCells / CHUNK_BASE_RES);
+    float radiusLat = settings.radius * (pi / paintCells / CHUNK_BASE_RES);
+
+    // Coarser depths while the brush still spans half a sample; finer
+    // depths only where chunks already exist (they are created lazily).
+    int coarsest = depth_;
+    while (coarsest > 0 && settings.radius * std::ldexp(1.0f, coarsest - 1 - depth_) >= 0.5f)
+        --coarsest;
+    int finest = std::min(CHUNK_MAX_DEPTH, depth_ + std::max(0, settings.extraDepths));
+
+    for (int depth = coarsest; depth <= finest; ++depth) {
+        int cells = 1 << depth;
+        float cellW = 2.0f * pi / cells;
+        float cellH = pi / cells;
+        float sW = cellW / CHUNK_BASE_RES;
+        float sH = cellH / CHUNK_BASE_RES;
+
+        // Union of touched texel rects per chunk (x0, y0, x1, y1 inclusive)
+        std::map<std::pair<int, int>, std::array<int, 4>> rects;
+        for (const Dab& dab : dabs) {
+            float lonLo = dab.lon - radiusLon, lonHi = dab.lon + radiusLon;
+            float latLo = std::max(dab.lat - radiusLat, -pi / 2.0f);
+            float latHi = std::min(dab.lat + radiusLat, pi / 2.0f);
+
+            int ixLo = static_cast<int>(std::floor((lonLo + pi) / cellW));
+            int ixHi = static_cast<int>(std::floor((lonHi + pi) / cellW));
+            int iyLo = std::clamp(static_cast<int>(std::floor((latLo + pi / 2.0f) / cellH)), 0, cells - 1);
+            int iyHi = std::clamp(static_cast<int>(std::floor((latHi + pi / 2.0f) / cellH)), 0, cells - 1);
+
+            for (int iy = iyLo; iy <= iyHi; ++iy) {
+                float cLatMax = -pi / 2.0f + (iy + 1) * cellH;
+                int y0 = std::clamp(static_cast<int>(std::floor((cLatMax - latHi) / sH)), 0, CHUNK_BASE_RES - 1);
+                int y1 = std::clamp(static_cast<int>(std::floor((cLatMax - latLo) / sH)), 0, CHUNK_BASE_RES - 1);
+                for (int ix = ixLo; ix <= ixHi; ++ix) {
+                    // ix is unwrapped so the texel math stays continuous across the antimeridian
+                    float cLonMin = -pi + ix * cellW;
+                    int x0 = std::clamp(static_cast<int>(std::floor((lonLo - cLonMin) / sW)), 0, CHUNK_BASE_RES - 1);
+                    int x1 = std::clamp(static_cast<int>(std::floor((lonHi - cLonMin) / sW)), 0, CHUNK_BASE_RES - 1);
+                    int wx = ((ix % cells) + cells) % cells;
+
+                    auto [it, inserted] = rects.try_emplace({ wx, iy }, std::array<int, 4>{ x0, y0, x1, y1 });
+                    if (!inserted) {
+                        auto& r = it->second;
+                        r[0] = std::min(r[0], x0); r[1] = std::min(r[1], y0);
+                        r[2] = std::max(r[2], x1); r[3] = std::max(r[3], y1);
+                    }
+                }
+            }
+        }
+
+        for (const auto& [key, r] : rects) {
+            ChunkCoord coord{ key.first, key.second, depth };
+            if (depth > depth_ && !world.getQuadTree().get(coord)) continue;
+            Patch p;
+            p.coord = coord;
+            p.x0 = r[0];
+            p.y0 = r[1];
+            p.w = r[2] - r[0] + 1;
+            p.h = r[3] - r[1] + 1;
+            out.push_back(p);
+        }
+    }
+}
+
+// ── GPU stamping ────────────────────────────────────────────────────
+
+void BrushEngine::stamp(World& world, const std::vector<Dab>& dabs, const Settings& settings)
+{
+    ZoneScopedN("BrushEngine::stamp");
+    if (!OpenCLContext::get().isReady() || !ensureBrushKernel()) return;
+
+    std::vector<Patch> patches;
+    collectPatches(world, dabs, settings, patches);
+    if (patches.empty()) return;
+
+    // Gather current delta values for every patch
+    std::vector<cl_int4> rects(patches.size());
+    std::vector<cl_float4> origins(patches.size());
+    std::vector<float> values;
+    int maxTexels = 0;
+    for (size_t i = 0; i < patches.size(); ++i) {
+        Patch& p = patches[i];
+        p.offset = values.size();
+        LayerDelta& delta = world.getOrCreateDelta(p.coord, layerName_);
+
+        float cLonMin, cLonMax, cLatMin, cLatMax;
+        p.coord.getBoundsRadians(cLonMin, cLonMax, cLatMin, cLatMax);
+        float sW = (cLonMax - cLonMin) / CHUNK_BASE_RES;
+        float sH = (cLatMax - cLatMin) / CHUNK_BASE_RES;
+
+        rects[i] = { { static_cast<cl_int>(p.offset), p.w, p.h, 0 } };
+        origins[i] = { { cLonMin + (p.x0 + 0.5f) * sW, cLatMax - (p.y0 + 0.5f) * sH, sW, sH } };
+        for (int y = 0; y < p.h; ++y)
+            for (int x = 0; x < p.w; ++x)
+                values.push_back(delta.getDelta(p.x0 + x, p.y0 + y));
+        maxTexels = std::max(maxTexels, p.w * p.h);
+    }
+
+    std::vector<cl_float2> dabData(dabs.size());
+    for (size_t i = 0; i < dabs.size(); ++i)
+        dabData[i] = { { dabs[i].lon, dabs[i].lat } };
+
+    if (!ensureCapacity(patchBuf_, patchCap_, values.size() * sizeof(float), "brush patches") ||
+        !ensureCapacity(rectBuf_, rectCap_, rects.size() * sizeof(cl_int4), "brush rects") ||
+        !ensureCapacity(originBuf_, originCap_, origins.size() * sizeof(cl_float4), "brush origins") ||
+        !ensureCapacity(dabBuf_, dabCap_, dabData.size() * sizeof(cl_float2), "brush dabs")) {
+        PLOGE << "BrushEngine: failed to allocate staging buffers";
+        return;
+    }
+
+    cl_command_queue queue = OpenCLContext::get().getQueue();
+    clEnqueueWriteBuffer(queue, patchBuf_, CL_FALSE, 0, values.size() * sizeof(float), values.data(), 0, nullptr, nullptr);
+    clEnqueueWriteBuffer(queue, rectBuf_, CL_FALSE, 0, rects.size() * sizeof(cl_int4), rects.data(), 0, nullptr, nullptr);
+    clEnqueueWriteBuffer(queue, originBuf_, CL_FALSE, 0, origins.size() * sizeof(cl_float4), origins.data(), 0, nullptr, nullptr);
+    clEnqueueWriteBuffer(queue, dabBuf_, CL_FALSE, 0, dabData.size() * sizeof(cl_float2), dabData.data(), 0, nullptr, nullptr);
+
+    const float pi = static_cast<float>(M_PI);
+    int paintCells = 1 << depth_;
+    float radiusLon = settings.radius * (2.0f * pi / paintCells / CHUNK_BASE_RES);
+    float radiusLat = settings.radius * (pi / paintCells / CHUNK_BASE_RES);
+    int dabCount = static_cast<int>(dabData.size());
+    int mode = static_cast<int>(settings.mode);
+    float strength = settings.strength;
+
+    clSetKernelArg(gBrushStampKernel, 0, sizeof(cl_mem), &patchBuf_);
+    clSetKernelArg(gBrushStampKernel, 1, sizeof(cl_mem), &rectBuf_);
+    clSetKernelArg(gBrushStampKernel, 2, sizeof(cl_mem), &originBuf_);
+    clSetKernelArg(gBrushStampKernel, 3, sizeof(cl_mem), &dabBuf_);
+    clSetKernelArg(gBrushStampKernel, 4, sizeof(int), &dabCount);
+    clSetKernelArg(gBrushStampKernel, 5, sizeof(float), &radiusLon);
+    clSetKernelArg(gBrushStampKernel, 6, sizeof(float), &radiusLat);
+    clSetKernelArg(gBrushStampKernel, 7, sizeof(float), &strength);
+    clSetKernelArg(gBrushStampKernel, 8, sizeof(int), &mode);
+
+    size_t global[2] = { patches.size(), static_cast<size_t>(maxTexels) };
+    cl_int err = OpenCLContext::get().enqueueNDRangeKernel(queue, gBrushStampKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        PLOGE << "BrushEngine: brush_stamp_patches failed: " << err;
+        return;
+    }
+    // Patches are a few KB; the blocking read also retires the writes above
+    err = OpenCLContext::get().enqueueReadBuffer(queue, patchBuf_, CL_TRUE, 0, values.size() * sizeof(float), values.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        PLOGE << "BrushEngine: patch readback failed: " << err;
+        return;
+    }
+
+    // Write back into the sparse deltas and refresh only the touched texels
+    for (const Patch& p : patches) {
+        LayerDelta& delta = world.getOrCreateDelta(p.coord, layerName_);
+        delta.mode = settings.mode;
+        const float* src = values.data() + p.offset;
+        for (int y = 0; y < p.h; ++y)
+            for (int x = 0; x < p.w; ++x)
+                delta.setDelta(p.x0 + x, p.y0 + y, 0, src[y * p.w + x]);
+        world.refreshChunkRect(p.coord, layerName_, p.x0, p.y0, p.w, p.h);
+    }
+}
@@ -0,0 +1,369 @@
+#include <WorldMaps/World/NoiseBackend.hpp>
+#include <plog/Log.h>
+#include <tracy/Tracy.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// The CPU backend keeps the arithmetic in the same order as
+// PerlinRegion.cl / Util.cl.  CMake builds this file with floating-point
+// contraction disabled so the scalar and SIMD paths round identically on
+// every target (NEON and AVX2 targets would otherwise fuse multiply-adds).
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define LOREBOOK_CPU_NOISE 1
+namespace stdx = std::experimental;
+
+namespace {
+
+template<class F>
+using IntOf = stdx::rebind_simd_t<int32_t, F>;
+template<class F>
+using UIntOf = stdx::rebind_simd_t<uint32_t, F>;
+
+// ── Util.cl hashing ─────────────────────────────────────────────────
+
+template<class U>
+inline U hashU(U x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+template<class F>
+inline F hash3Seeded(const IntOf<F>& px, const IntOf<F>& py, const IntOf<F>& pz, uint32_t seed)
+{
+    using U = UIntOf<F>;
+    U h = hashU(stdx::static_simd_cast<U>(px) + seed) ^
+          hashU(stdx::static_simd_cast<U>(py) + seed * 31u) ^
+          hashU(stdx::static_simd_cast<U>(pz) + seed * 131u);
+    // < 2^24, so the int conversion is exact
+    F v = stdx::static_simd_cast<F>(stdx::static_simd_cast<IntOf<F>>(h & 0x00FFFFFFu));
+    return v / 16777216.0f;
+}
+
+// ── Trigonometry ────────────────────────────────────────────────────
+// Cody-Waite reduction by π/2 and minimax polynomials on [-π/4, π/4].
+// Arguments here stay within a few turns, where this is ~1 ulp.
+
+template<class F>
+inline void sinCos(const F& x, F& s, F& c)
+{
+    F q = stdx::floor(x * 0.63661977236758134f + 0.5f);
+    F r = ((x - q * 1.5703125f) - q * 4.837512969970703125e-4f) - q * 7.54978995489188216e-8f;
+    F r2 = r * r;
+    F sp = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+    F cp = (1.0f - 0.5f * r2) +
+           r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+
+    F quadrant = q - 4.0f * stdx::floor(q * 0.25f); // 0..3
+    auto odd = (quadrant == 1.0f) || (quadrant == 3.0f);
+    s = sp;
+    c = cp;
+    stdx::where(odd, s) = cp;
+    stdx::where(odd, c) = sp;
+    stdx::where(quadrant >= 2.0f, s) = -s;
+    stdx::where((quadrant == 1.0f) || (quadrant == 2.0f), c) = -c;
+}
+
+template<class F>
+inline F cosOnly(const F& x)
+{
+    F s, c;
+    sinCos(x, s, c);
+    return c;
+}
+
+// ── PerlinRegion.cl ─────────────────────────────────────────────────
+
+template<class F>
+inline F fade(const F& t)
+{
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+template<class F>
+inline F mixF(const F& a, const F& b, const F& t)
+{
+    return a + (b - a) * t;
+}
+
+template<class F>
+inline F cornerDot(const IntOf<F>& ix, const IntOf<F>& iy, const IntOf<F>& iz,
+                   int ox, int oy, int oz, uint32_t seed,
+                   const F& fx, const F& fy, const F& fz)
+{
+    F h = hash3Seeded<F>(ix + ox, iy + oy, iz + oz, seed) * 6.2831853f;
+    F gs, gc;
+    sinCos(h, gs, gc);
+    F gz = cosOnly(F(h * 0.5f));
+    return gc * (fx - static_cast<float>(ox)) +
+           gs * (fy - static_cast<float>(oy)) +
+           gz * (fz - static_cast<float>(oz));
+}
+
+template<class F>
+inline F perlin3Region(const F& px, const F& py, const F& pz, uint32_t seed)
+{
+    using I = IntOf<F>;
+    F flx = stdx::floor(px), fly = stdx::floor(py), flz = stdx::floor(pz);
+    I ix = stdx::static_simd_cast<I>(flx);
+    I iy = stdx::static_simd_cast<I>(fly);
+    I iz = stdx::static_simd_cast<I>(flz);
+    F fx = px - flx, fy = py - fly, fz = pz - flz;
+    F ux = fade(fx), uy = fade(fy), uz = fade(fz);
+
+    F n000 = cornerDot<F>(ix, iy, iz, 0, 0, 0, seed, fx, fy, fz);
+    F n100 = cornerDot<F>(ix, iy, iz, 1, 0, 0, seed, fx, fy, fz);
+    F n010 = cornerDot<F>(ix, iy, iz, 0, 1, 0, seed, fx, fy, fz);
+    F n110 = cornerDot<F>(ix, iy, iz, 1, 1, 0, seed, fx, fy, fz);
+    F n001 = cornerDot<F>(ix, iy, iz, 0, 0, 1, seed, fx, fy, fz);
+    F n101 = cornerDot<F>(ix, iy, iz, 1, 0, 1, seed, fx, fy, fz);
+    F n011 = cornerDot<F>(ix, iy, iz, 0, 1, 1, seed, fx, fy, fz);
+    F n111 = cornerDot<F>(ix, iy, iz, 1, 1, 1, seed, fx, fy, fz);
+
+    F nx00 = mixF(n000, n100, ux);
+    F nx10 = mixF(n010, n110, ux);
+    F nx01 = mixF(n001, n101, ux);
+    F nx11 = mixF(n011, n111, ux);
+
+    F nxy0 = mixF(nx00, nx10, uy);
+    F nxy1 = mixF(nx01, nx11, uy);
+
+    return mixF(nxy0, nxy1, uz);
+}
+
+/// perlin_fbm_3d_sphere_region for rows [rowBegin, rowEnd), F::size()
+/// columns at a time.
+template<class F>
+void fbmRows(const PerlinRegionParams& p, int rowBegin, int rowEnd, float* out)
+{
+    constexpr int W = static_cast<int>(F::size());
+    const float thetaRange = p.thetaMax - p.thetaMin;
+    const float phiRange = p.phiMax - p.phiMin;
+    const F lane([](int i) { return static_cast<float>(i); });
+
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        F theta = p.thetaMin + (static_cast<float>(row) + 0.5f) / static_cast<float>(p.resLat) * thetaRange;
+        F sinT, cosT;
+        sinCos(theta, sinT, cosT);
+        float* dst = out + static_cast<size_t>(row) * p.resLon;
+
+        for (int col = 0; col < p.resLon; col += W) {
+            F lonIdx = lane + static_cast<float>(col);
+            F phi = p.phiMin + (lonIdx + 0.5f) / static_cast<float>(p.resLon) * phiRange;
+            F sinP, cosP;
+            sinCos(phi, sinP, cosP);
+
+            F px = sinT * cosP * p.frequency;
+            F py = sinT * sinP * p.frequency;
+            F pz = cosT * p.frequency;
+
+            F value = 0.0f;
+            float amplitude = 1.0f;
+            float maxAmp = 0.0f;
+            for (int i = 0; i < p.octaves; ++i) {
+                value += perlin3Region(px, py, pz, p.seed + static_cast<uint32_t>(i) * 101u) * amplitude;
+                maxAmp += amplitude;
+                amplitude *= p.persistence;
+                px *= p.lacunarity;
+                py *= p.lacunarity;
+                pz *= p.lacunarity;
+            }
+            if (maxAmp <= 0.0f)
+                value = 0.0f;
+            else
+                value = value / maxAmp;
+            F result = value * 0.5f + 0.5f;
+
+            if (col + W <= p.resLon) {
+                result.copy_to(dst + col, stdx::element_aligned);
+            } else {
+                for (int i = 0; col + i < p.resLon; ++i) dst[col + i] = result[i];
+            }
+        }
+    }
+}
+
+using NativeF = stdx::native_simd<float>;
+using ScalarF = stdx::simd<float, stdx::simd_abi::scalar>;
+
+} // namespace
+
+#endif
+
+// ── Row pool ─────────────────────────────────────────────────────────
+
+/// Persistent workers that split one region's rows between themselves and
+/// the calling thread.  Regions run one at a time.
+struct CpuNoiseBackend::Pool {
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::mutex callMutex;
+
+    std::function<void(int, int)> job;
+    int rows = 0;
+    int block = 1;
+    std::atomic<int> next{0};
+    int active = 0;
+    uint64_t generation = 0;
+    bool stop = false;
+
+    explicit Pool(unsigned count) { start(count); }
+    ~Pool() { shutdown(); }
+
+    void start(unsigned count) {
+        for (unsigned i = 0; i < count; ++i)
+            workers.emplace_back([this] { workerLoop(); });
+    }
+
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+        workers.clear();
+        stop = false;
+    }
+
+    void drain() {
+        for (;;) {
+            int r = next.fetch_add(block);
+            if (r >= rows) break;
+            job(r, std::min(rows, r + block));
+        }
+    }
+
+    void workerLoop() {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(mutex);
+                wake.wait(lk, [&] { return stop || generation != seen; });
+                if (stop) return;
+                seen = generation;
+                ++active;
+            }
+            drain();
+            {
+                std::lock_guard<std::mutex> lk(mutex);
+                if (--active == 0) idle.notify_all();
+            }
+        }
+    }
+
+    void run(int rowCount, std::function<void(int, int)> fn) {
+        std::lock_guard<std::mutex> call(callMutex);
+        if (workers.empty() || rowCount <= 1) {
+            fn(0, rowCount);
+            return;
+        }
+        {
+            std::unique_lock<std::mutex> lk(mutex);
+            // A worker that woke late for the previous region may still be
+            // leaving drain(); don't swap the job out from under it.
+            idle.wait(lk, [&] { return active == 0; });
+            job = std::move(fn);
+            rows = rowCount;
+            block = std::max(1, rowCount / static_cast<int>(4 * (workers.size() + 1)));
+            next.store(0);
+            ++generation;
+        }
+        wake.notify_all();
+        drain();
+        std::unique_lock<std::mutex> lk(mutex);
+        idle.wait(lk, [&] { return active == 0; });
+    }
+};
+
+// ── CpuNoiseBackend ──────────────────────────────────────────────────
+
+CpuNoiseBackend::CpuNoiseBackend()
+    : path_(available() ? Path::SIMD : Path::Scalar)
+{
+    unsigned hw = std::thread::hardware_concurrency();
+    pool_ = std::make_unique<Pool>(hw > 1 ? hw - 1 : 0);
+}
+
+CpuNoiseBackend::~CpuNoiseBackend() = default;
+
+bool CpuNoiseBackend::available()
+{
+#ifdef LOREBOOK_CPU_NOISE
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char* CpuNoiseBackend::name() const
+{
+    return path_ == Path::SIMD ? "CPU (SIMD)" : "CPU (scalar)";
+}
+
+void CpuNoiseBackend::setPath(Path path)
+{
+    path_ = path;
+}
+
+size_t CpuNoiseBackend::laneWidth() const
+{
+#ifdef LOREBOOK_CPU_NOISE
+    return path_ == Path::SIMD ? NativeF::size() : 1;
+#else
+    return 1;
+#endif
+}
+
+void CpuNoiseBackend::setThreadCount(unsigned workers)
+{
+    std::lock_guard<std::mutex> call(pool_->callMutex);
+    pool_->shutdown();
+    pool_->start(workers);
+}
+
+unsigned CpuNoiseBackend::threadCount() const
+{
+    return static_cast<unsigned>(pool_->workers.size());
+}
+
+bool CpuNoiseBackend::perlinRegion(const PerlinRegionParams& params, float* out)
+{
+#ifdef LOREBOOK_CPU_NOISE
+    ZoneScopedN("CpuNoise::perlinRegion");
+    if (!out || params.resLat <= 0 || params.resLon <= 0)
+        return false;
+    const bool simd = path_ == Path::SIMD;
+    pool_->run(params.resLat, [&](int r0, int r1) {
+        if (simd)
+            fbmRows<NativeF>(params, r0, r1, out);
+        else
+            fbmRows<ScalarF>(params, r0, r1, out);
+    });
+    return true;
+#else
+    (void)params;
+    (void)out;
+    return false;
+#endif
+}
+
+CpuNoiseBackend& cpuNoiseBackend()
+{
+    static CpuNoiseBackend backend;
+    return backend;
+}
@@ -0,0 +1,397 @@
+#include <WorldMaps/World/Hydrology.hpp>
+#include <OpenCLContext.hpp>
+#include <tracy/Tracy.hpp>
+#include <plog/Log.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+
+uint64_t HydrologyKey::hash() const
+{
+    uint32_t words[9];
+    std::memcpy(&words[0], &elevation.frequency, 4);
+    std::memcpy(&words[1], &elevation.lacunarity, 4);
+    std::memcpy(&words[2], &elevation.persistence, 4);
+    words[3] = static_cast<uint32_t>(elevation.octaves);
+    words[4] = elevation.seed;
+    std::memcpy(&words[5], &seaLevel, 4);
+    std::memcpy(&words[6], &riverArea, 4);
+    words[7] = static_cast<uint32_t>(rows);
+    words[8] = static_cast<uint32_t>(cols);
+    uint64_t h = 1469598103934665603ull;
+    for (uint32_t w : words) {
+        h ^= w;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// ── Shared instances ────────────────────────────────────────────────
+
+std::shared_ptr<const Hydrology> Hydrology::acquire(const HydrologyKey& key)
+{
+    // Networks stay alive while any layer holds them; a world rebuilt with
+    // the same seed and sea level finds its network still here
+    static std::mutex mutex;
+    static std::unordered_map<uint64_t, std::weak_ptr<const Hydrology>> networks;
+
+    std::lock_guard<std::mutex> lk(mutex);
+    uint64_t h = key.hash();
+    auto it = networks.find(h);
+    if (it != networks.end()) {
+        if (auto existing = it->second.lock(); existing && existing->key() == key)
+            return existing;
+    }
+
+    std::shared_ptr<Hydrology> network(new Hydrology(key));
+    if (!network->build()) return nullptr;
+    networks[h] = network;
+    return network;
+}
+
+Hydrology::~Hydrology()
+{
+    if (intensityBuf_) OpenCLContext::get().releaseMem(intensityBuf_);
+}
+
+float Hydrology::cellLatRad() const
+{
+    return static_cast<float>(M_PI) / key_.rows;
+}
+
+// ── Build ───────────────────────────────────────────────────────────
+
+bool Hydrology::build()
+{
+    ZoneScopedN("Hydrology::build");
+    if (!OpenCLContext::get().isReady() || key_.rows <= 1 || key_.cols <= 1) return false;
+
+    const int rows = key_.rows, cols = key_.cols;
+    const size_t count = static_cast<size_t>(rows) * cols;
+    std::vector<float> elevation(count);
+    {
+        ZoneScopedN("Hydrology elevation");
+        cl_mem elevBuf = nullptr;
+        try {
+            const NoiseField& f = key_.elevation;
+            perlinRegion(elevBuf, rows, cols, 0.0f, static_cast<float>(M_PI), 0.0f, static_cast<float>(2.0 * M_PI),
+                         f.frequency, f.lacunarity, f.octaves, f.persistence, f.seed);
+        } catch (const std::exception& ex) {
+            PLOGE << "Hydrology: " << ex.what();
+        }
+        if (!elevBuf) return false;
+        cl_int err = OpenCLContext::get().enqueueReadBuffer(OpenCLContext::get().getQueue(), elevBuf, CL_TRUE, 0,
+                                                            count * sizeof(float), elevation.data(), 0, nullptr, nullptr);
+        OpenCLContext::get().releaseMem(elevBuf);
+        if (err != CL_SUCCESS) return false;
+    }
+
+    fillDepressions(elevation);
+    routeD8();
+    if (!OpenCLContext::get().isGPU() || !accumulateGPU())
+        accumulateCPU();
+    computeIntensity();
+
+    cl_int err = CL_SUCCESS;
+    intensityBuf_ = OpenCLContext::get().createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                                                      count * sizeof(float), intensity_.data(),
+                                                      &err, "Hydrology intensity");
+    if (err != CL_SUCCESS || !intensityBuf_) return false;
+
+    PLOGI << "Hydrology: built " << cols << "x" << rows << " drainage network (seed " << key_.elevation.seed << ")";
+    return true;
+}
+
+// Calls f(neighbour) for the 8 neighbours of (r, c): longitude wraps,
+// nothing lies beyond the poles
+template<class F>
+static inline void forNeighbours(int r, int c, int rows, int cols, F&& f)
+{
+    for (int dr = -1; dr <= 1; ++dr) {
+        int nr = r + dr;
+        if (nr < 0 || nr >= rows) continue;
+        for (int dc = -1; dc <= 1; ++dc) {
+            if (dr == 0 && dc == 0) continue;
+            int nc = c + dc;
+            if (nc < 0) nc += cols;
+            else if (nc >= cols) nc -= cols;
+            f(nr, nc, dr, dc);
+        }
+    }
+}
+
+void Hydrology::fillDepressions(const std::vector<float>& elevation)
+{
+    ZoneScopedN("Hydrology::fillDepressions");
+    const int rows = key_.rows, cols = key_.cols;
+    const size_t count = elevation.size();
+    filled_ = elevation;
+    receivers_.assign(count, -1);
+
+    using Entry = std::pair<float, int32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    std::queue<int32_t> pit;
+    std::vector<uint8_t> closed(count, 0);
+
+    // The ocean is the outlet; a world without one drains to its lowest cell
+    for (size_t i = 0; i < count; ++i) {
+        if (elevation[i] < key_.seaLevel) {
+            closed[i] = 1;
+            open.push({elevation[i], static_cast<int32_t>(i)});
+        }
+    }
+    if (open.empty()) {
+        size_t lowest = static_cast<size_t>(std::min_element(elevation.begin(), elevation.end()) - elevation.begin());
+        closed[lowest] = 1;
+        open.push({elevation[lowest], static_cast<int32_t>(lowest)});
+    }
+
+    while (!open.empty() || !pit.empty()) {
+        int32_t c;
+        if (!pit.empty()) {
+            c = pit.front();
+            pit.pop();
+        } else {
+            c = open.top().second;
+            open.pop();
+        }
+        // Raise pits just above their spill cell so they still drain
+        float next = std::nextafter(filled_[c], std::numeric_limits<float>::infinity());
+        forNeighbours(c / cols, c % cols, rows, cols, [&](int nr, int nc, int, int) {
+            int32_t n = nr * cols + nc;
+            if (closed[n]) return;
+            closed[n] = 1;
+            if (filled_[n] <= next) {
+                filled_[n] = next;
+                pit.push(n);
+            } else {
+                open.push({filled_[n], n});
+            }
+        });
+    }
+}
+
+void Hydrology::routeD8()
+{
+    ZoneScopedN("Hydrology::routeD8");
+    const int rows = key_.rows, cols = key_.cols;
+    const float cellLat = cellLatRad();
+    const float cellLon = static_cast<float>(2.0 * M_PI) / cols;
+
+    for (int r = 0; r < rows; ++r) {
+        float lat = static_cast<float>(M_PI / 2.0) - (r + 0.5f) * cellLat;
+        float dx = std::max(cellLon * std::cos(lat), 1e-6f);
+        for (int c = 0; c < cols; ++c) {
+            int32_t i = r * cols + c;
+            if (filled_[i] < key_.seaLevel) continue;   // ocean is terminal
+            float best = 0.0f;
+            int32_t receiver = -1;
+            forNeighbours(r, c, rows, cols, [&](int nr, int nc, int dr, int dc) {
+                int32_t n = nr * cols + nc;
+                float drop = filled_[i] - filled_[n];
+                if (drop <= 0.0f) return;
+                float dist = std::sqrt(dr * dr * cellLat * cellLat + dc * dc * dx * dx);
+                float slope = drop / dist;
+                if (slope > best) {
+                    best = slope;
+                    receiver = n;
+                }
+            });
+            receivers_[i] = receiver;
+        }
+    }
+}
+
+// Rain falling on each cell: its area relative to an equator cell
+static inline float cellRain(int row, int rows)
+{
+    float lat = static_cast<float>(M_PI / 2.0) - (row + 0.5f) * static_cast<float>(M_PI) / rows;
+    return std::cos(lat);
+}
+
+void Hydrology::accumulateCPU()
+{
+    ZoneScopedN("Hydrology::accumulateCPU");
+    const int rows = key_.rows, cols = key_.cols;
+    const size_t count = receivers_.size();
+
+    std::vector<int32_t> pending(count, 0);
+    for (int32_t r : receivers_)
+        if (r >= 0) ++pending[r];
+
+    accumulation_.resize(count);
+    for (int r = 0; r < rows; ++r) {
+        float rain = cellRain(r, rows);
+        std::fill_n(accumulation_.begin() + static_cast<size_t>(r) * cols, cols, rain);
+    }
+
+    // Kahn's order: a cell passes its area on once all its donors have
+    std::vector<int32_t> ready;
+    ready.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        if (pending[i] == 0) ready.push_back(static_cast<int32_t>(i));
+    for (size_t k = 0; k < ready.size(); ++k) {
+        int32_t i = ready[k];
+        int32_t r = receivers_[i];
+        if (r < 0) continue;
+        accumulation_[r] += accumulation_[i];
+        if (--pending[r] == 0) ready.push_back(r);
+    }
+}
+
+static cl_program gHydrologyProgram = nullptr;
+
+bool Hydrology::accumulateGPU()
+{
+    ZoneScopedN("Hydrology::accumulateGPU");
+    static cl_kernel gFrontierKernel = nullptr;
+    static cl_kernel gPushKernel = nullptr;
+    try {
+        OpenCLContext::get().createProgram(gHydrologyProgram, "Kernels/Rivers.cl");
+        OpenCLContext::get().createKernelFromProgram(gFrontierKernel, gHydrologyProgram, "river_d8_frontier");
+        OpenCLContext::get().createKernelFromProgram(gPushKernel, gHydrologyProgram, "river_d8_push");
+    } catch (const std::runtime_error& e) {
+        PLOGW << "Hydrology: GPU accumulation unavailable: " << e.what();
+        return false;
+    }
+
+    const int rows = key_.rows, cols = key_.cols;
+    const size_t count = receivers_.size();
+    int countArg = static_cast<int>(count);
+
+    std::vector<int32_t> pending(count, 0);
+    for (int32_t r : receivers_)
+        if (r >= 0) ++pending[r];
+    std::vector<float> acc(count);
+    for (int r = 0; r < rows; ++r)
+        std::fill_n(acc.begin() + static_cast<size_t>(r) * cols, cols, cellRain(r, rows));
+
+    cl_int err = CL_SUCCESS;
+    auto& cl = OpenCLContext::get();
+    cl_mem receiverBuf = cl.createBuffer(CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, count * sizeof(int32_t),
+                                         receivers_.data(), &err, "Hydrology receivers");
+    cl_mem pendingBuf = cl.createBuffer(CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, count * sizeof(int32_t),
+                                        pending.data(), &err, "Hydrology pending");
+    cl_mem accBuf = cl.createBuffer(CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, count * sizeof(float),
+                                    acc.data(), &err, "Hydrology accumulation");
+    cl_mem doneBuf = cl.createBuffer(CL_MEM_READ_WRITE, count, nullptr, &err, "Hydrology done");
+    cl_mem frontierBuf = cl.createBuffer(CL_MEM_READ_WRITE, count, nullptr, &err, "Hydrology frontier");
+    cl_mem pushedBuf = cl.createBuffer(CL_MEM_READ_WRITE, sizeof(int32_t), nullptr, &err, "Hydrology pushed");
+
+    bool ok = receiverBuf && pendingBuf && accBuf && doneBuf && frontierBuf && pushedBuf;
+    cl_command_queue queue = cl.getQueue();
+    if (ok) {
+        const cl_uchar zero8 = 0;
+        const int32_t zero32 = 0;
+        clEnqueueFillBuffer(queue, doneBuf, &zero8, 1, 0, count, 0, nullptr, nullptr);
+        clEnqueueFillBuffer(queue, pushedBuf, &zero32, sizeof(int32_t), 0, sizeof(int32_t), 0, nullptr, nullptr);
+
+        clSetKernelArg(gFrontierKernel, 0, sizeof(cl_mem), &pendingBuf);
+        clSetKernelArg(gFrontierKernel, 1, sizeof(cl_mem), &doneBuf);
+        clSetKernelArg(gFrontierKernel, 2, sizeof(cl_mem), &frontierBuf);
+        clSetKernelArg(gFrontierKernel, 3, sizeof(int), &countArg);
+        clSetKernelArg(gPushKernel, 0, sizeof(cl_mem), &receiverBuf);
+        clSetKernelArg(gPushKernel, 1, sizeof(cl_mem), &frontierBuf);
+        clSetKernelArg(gPushKernel, 2, sizeof(cl_mem), &accBuf);
+        clSetKernelArg(gPushKernel, 3, sizeof(cl_mem), &pendingBuf);
+        clSetKernelArg(gPushKernel, 4, sizeof(cl_mem), &pushedBuf);
+        clSetKernelArg(gPushKernel, 5, sizeof(int), &countArg);
+
+        // One wavefront per launch pair; the queue is in order, so a cell
+        // only joins the frontier after its donors' pushes have landed.
+        // Progress is polled every few waves rather than every launch.
+        constexpr int WAVES_PER_POLL = 32;
+        size_t global = count;
+        size_t processed = 0;
+        while (ok && processed < count) {
+            for (int w = 0; w < WAVES_PER_POLL && ok; ++w) {
+                ok = cl.enqueueNDRangeKernel(queue, gFrontierKernel, 1, nullptr, &global, nullptr, 0, nullptr, nullptr) == CL_SUCCESS &&
+                     cl.enqueueNDRangeKernel(queue, gPushKernel, 1, nullptr, &global, nullptr, 0, nullptr, nullptr) == CL_SUCCESS;
+            }
+            int32_t pushed = 0;
+            ok = ok && cl.enqueueReadBuffer(queue, pushedBuf, CL_TRUE, 0, sizeof(int32_t), &pushed,
+                                            0, nullptr, nullptr) == CL_SUCCESS;
+            if (!ok) break;
+            if (pushed == 0) {
+                // Nothing moved: a receiver cycle, which routeD8 never produces
+                PLOGW << "Hydrology: GPU accumulation stalled at " << processed << "/" << count;
+                ok = false;
+                break;
+            }
+            processed += static_cast<size_t>(pushed);
+            clEnqueueFillBuffer(queue, pushedBuf, &zero32, sizeof(int32_t), 0, sizeof(int32_t), 0, nullptr, nullptr);
+        }
+        if (ok) {
+            accumulation_.resize(count);
+            ok = cl.enqueueReadBuffer(queue, accBuf, CL_TRUE, 0, count * sizeof(float), accumulation_.data(),
+                                      0, nullptr, nullptr) == CL_SUCCESS;
+        }
+    }
+
+    for (cl_mem buf : {receiverBuf, pendingBuf, accBuf, doneBuf, frontierBuf, pushedBuf})
+        if (buf) cl.releaseMem(buf);
+    return ok;
+}
+
+void Hydrology::computeIntensity()
+{
+    const size_t count = accumulation_.size();
+    intensity_.assign(count, 0.0f);
+    float maxAcc = key_.riverArea;
+    for (size_t i = 0; i < count; ++i)
+        if (filled_[i] >= key_.seaLevel) maxAcc = std::max(maxAcc, accumulation_[i]);
+    float range = std::log(maxAcc / key_.riverArea);
+    if (range <= 0.0f) return;
+    for (size_t i = 0; i < count; ++i) {
+        if (filled_[i] < key_.seaLevel || accumulation_[i] < key_.riverArea) continue;
+        // Sources start visible rather than at zero
+        intensity_[i] = std::clamp(0.1f + 0.9f * std::log(accumulation_[i] / key_.riverArea) / range, 0.0f, 1.0f);
+    }
+}
+
+// ── Queries ─────────────────────────────────────────────────────────
+
+void Hydrology::segments(float lonMinRad, float lonMaxRad, float latMinRad, float latMaxRad,
+                         std::vector<Segment>& out) const
+{
+    out.clear();
+    const int rows = key_.rows, cols = key_.cols;
+    const float pi = static_cast<float>(M_PI);
+    const float cellLat = cellLatRad();
+    const float cellLon = 2.0f * pi / cols;
+
+    // Cells whose centre lies within the bounds, plus one ring so segments
+    // entering from outside are included
+    int r0 = std::clamp(static_cast<int>(std::floor((pi / 2.0f - latMaxRad) / cellLat)) - 1, 0, rows - 1);
+    int r1 = std::clamp(static_cast<int>(std::floor((pi / 2.0f - latMinRad) / cellLat)) + 1, 0, rows - 1);
+    int c0 = static_cast<int>(std::floor((lonMinRad + pi) / cellLon)) - 1;
+    int c1 = static_cast<int>(std::floor((lonMaxRad + pi) / cellLon)) + 1;
+    c1 = std::min(c1, c0 + cols - 1);
+
+    for (int r = r0; r <= r1; ++r) {
+        for (int cu = c0; cu <= c1; ++cu) {
+            int c = ((cu % cols) + cols) % cols;
+            int32_t i = r * cols + c;
+            if (intensity_[i] <= 0.0f) continue;
+            int32_t rcv = receivers_[i];
+            if (rcv < 0) continue;
+            int rr = rcv / cols, rc = rcv % cols;
+            // Receiver column relative to this one, across the antimeridian
+            int dc = rc - c;
+            if (dc > 1) dc -= cols;
+            else if (dc < -1) dc += cols;
+
+            Segment s;
+            s.lonA = -pi + (cu + 0.5f) * cellLon;
+            s.latA = pi / 2.0f - (r + 0.5f) * cellLat;
+            s.lonB = s.lonA + dc * cellLon;
+            s.latB = pi / 2.0f - (rr + 0.5f) * cellLat;
+            s.intensity = intensity_[i];
+            out.push_back(s);
+        }
+    }
+}
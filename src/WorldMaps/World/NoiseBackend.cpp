@@ -0,0 +1,70 @@
+#include <WorldMaps/World/NoiseBackend.hpp>
+#include <OpenCLContext.hpp>
+#include <plog/Log.h>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+
+namespace {
+
+std::atomic<int> g_noiseBackend{-1};
+
+NoiseBackendKind settingFromEnvironment()
+{
+    const char* env = std::getenv("LOREBOOK_NOISE");
+    if (!env) return NoiseBackendKind::Auto;
+    std::string v(env);
+    if (v == "cpu") return NoiseBackendKind::CPU;
+    if (v == "opencl" || v == "gpu") return NoiseBackendKind::OpenCL;
+    if (v != "auto") PLOGW << "Unknown LOREBOOK_NOISE value '" << v << "', using auto";
+    return NoiseBackendKind::Auto;
+}
+
+/// True when the active OpenCL device is a CPU ICD, where the host SIMD
+/// path is faster.  GPUs and accelerators stay on OpenCL.  Cached per device;
+/// the row pool and warm-up threads ask concurrently, hence the lock.
+bool deviceIsCpuIcd(OpenCLContext& cl)
+{
+    static std::mutex cacheMutex;
+    static cl_device_id cachedDevice = nullptr;
+    static bool cachedCpu = false;
+    cl_device_id device = cl.getDevice();
+    std::lock_guard<std::mutex> lk(cacheMutex);
+    if (device != cachedDevice) {
+        cl_device_type type = 0;
+        cl_int err = clGetDeviceInfo(device, CL_DEVICE_TYPE, sizeof(type), &type, nullptr);
+        cachedCpu = err == CL_SUCCESS && (type & CL_DEVICE_TYPE_CPU) != 0 &&
+                    (type & (CL_DEVICE_TYPE_GPU | CL_DEVICE_TYPE_ACCELERATOR)) == 0;
+        cachedDevice = device;
+        PLOGI << "Noise backend (auto): " << (cachedCpu ? "CPU, OpenCL device is a CPU ICD" : "OpenCL device");
+    }
+    return cachedCpu;
+}
+
+} // namespace
+
+void setNoiseBackend(NoiseBackendKind kind)
+{
+    g_noiseBackend.store(static_cast<int>(kind));
+}
+
+NoiseBackendKind noiseBackendSetting()
+{
+    int v = g_noiseBackend.load();
+    if (v < 0) {
+        int initial = static_cast<int>(settingFromEnvironment());
+        g_noiseBackend.compare_exchange_strong(v, initial);
+        v = g_noiseBackend.load();
+    }
+    return static_cast<NoiseBackendKind>(v);
+}
+
+NoiseBackendKind activeNoiseBackend()
+{
+    if (!CpuNoiseBackend::available()) return NoiseBackendKind::OpenCL;
+    NoiseBackendKind kind = noiseBackendSetting();
+    if (kind != NoiseBackendKind::Auto) return kind;
+    // Only asked from inside perlinRegion*, which need a ready context
+    return deviceIsCpuIcd(OpenCLContext::get()) ? NoiseBackendKind::CPU : NoiseBackendKind::OpenCL;
+}
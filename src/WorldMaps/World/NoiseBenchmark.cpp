@@ -0,0 +1,192 @@
+#include <WorldMaps/World/NoiseBenchmark.hpp>
+#include <WorldMaps/World/NoiseBackend.hpp>
+#include <OpenCLContext.hpp>
+#include <plog/Log.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+struct NoiseCase {
+    const char* name;
+    PerlinRegionParams params;
+};
+
+/// Regions covering the cases that differ between implementations:
+/// whole sphere, poles, the phi seam, deep zoom, high octave counts and
+/// extreme seeds.
+std::vector<NoiseCase> conformanceCases()
+{
+    const float pi = static_cast<float>(M_PI);
+    return {
+        { "full sphere",     { 256, 512, 0.0f, pi, 0.0f, 2.0f * pi, 1.0f, 2.0f, 6, 0.5f, 1u } },
+        { "north pole",      { 128, 128, 0.0f, 0.05f, 0.0f, 2.0f * pi, 4.0f, 2.0f, 8, 0.5f, 42u } },
+        { "south pole",      { 128, 128, pi - 0.05f, pi, 1.0f, 1.5f, 4.0f, 2.0f, 8, 0.5f, 7u } },
+        { "phi seam",        { 64, 256, 1.2f, 1.4f, 2.0f * pi - 0.1f, 2.0f * pi, 2.5f, 2.2f, 5, 0.45f, 0u } },
+        { "deep zoom",       { 32, 32, 1.5707f, 1.5707f + 3.0e-6f, 3.0f, 3.0f + 6.0e-6f, 1.0f, 2.0f, 6, 0.5f, 123u } },
+        { "high frequency",  { 128, 256, 0.4f, 2.7f, 0.5f, 5.5f, 37.0f, 1.9f, 10, 0.6f, 0xFFFFFFFFu } },
+        { "single octave",   { 96, 96, 0.2f, 0.9f, 4.0f, 4.7f, 3.0f, 2.0f, 1, 0.5f, 0x9E3779B9u } },
+    };
+}
+
+NoiseConformanceResult compare(const char* name, const char* reference,
+                               const std::vector<float>& ref, const std::vector<float>& cpu,
+                               float tolerance)
+{
+    NoiseConformanceResult r;
+    r.name = name;
+    r.reference = reference;
+    r.samples = std::min(ref.size(), cpu.size());
+    double sum = 0.0;
+    for (size_t i = 0; i < r.samples; ++i) {
+        if (std::memcmp(&ref[i], &cpu[i], sizeof(float)) == 0) {
+            ++r.exactMatches;
+            continue;
+        }
+        float d = std::fabs(ref[i] - cpu[i]);
+        if (!(d <= r.maxAbsError)) r.maxAbsError = std::isnan(d) ? INFINITY : d;
+        sum += d;
+    }
+    r.meanAbsError = r.samples ? sum / static_cast<double>(r.samples) : 0.0;
+    r.pass = r.samples > 0 && r.maxAbsError <= tolerance;
+    return r;
+}
+
+/// Run PerlinRegion.cl regardless of the backend setting and read it back.
+bool openclRegion(const PerlinRegionParams& p, cl_mem& buf, std::vector<float>& out)
+{
+    NoiseBackendKind saved = noiseBackendSetting();
+    setNoiseBackend(NoiseBackendKind::OpenCL);
+    bool ok = true;
+    try {
+        perlinRegion(buf, p.resLat, p.resLon, p.thetaMin, p.thetaMax, p.phiMin, p.phiMax,
+                     p.frequency, p.lacunarity, p.octaves, p.persistence, p.seed);
+        out.resize(static_cast<size_t>(p.resLat) * p.resLon);
+        ok = buf && clEnqueueReadBuffer(OpenCLContext::get().getQueue(), buf, CL_TRUE, 0,
+                                        out.size() * sizeof(float), out.data(),
+                                        0, nullptr, nullptr) == CL_SUCCESS;
+    } catch (const std::exception& e) {
+        PLOGE << "Noise diagnostics: OpenCL region failed: " << e.what();
+        ok = false;
+    }
+    setNoiseBackend(saved);
+    return ok;
+}
+
+using BenchClock = std::chrono::steady_clock;
+
+/// Best-of-three samples/sec for `fn`, which produces `samples` values.
+template<typename Fn>
+double samplesPerSec(size_t samples, Fn&& fn)
+{
+    fn(); // warm-up (thread start, kernel build, page faults)
+    double best = 0.0;
+    for (int i = 0; i < 3; ++i) {
+        auto t0 = BenchClock::now();
+        if (!fn()) return 0.0;
+        double s = std::chrono::duration<double>(BenchClock::now() - t0).count();
+        if (s > 0.0) best = std::max(best, static_cast<double>(samples) / s);
+    }
+    return best;
+}
+
+} // namespace
+
+std::vector<NoiseConformanceResult> runNoiseConformance()
+{
+    std::vector<NoiseConformanceResult> results;
+    if (!CpuNoiseBackend::available()) {
+        PLOGW << "Noise diagnostics: CPU backend not compiled in";
+        return results;
+    }
+
+    CpuNoiseBackend simd, scalar;
+    simd.setPath(CpuNoiseBackend::Path::SIMD);
+    scalar.setPath(CpuNoiseBackend::Path::Scalar);
+    const bool gpu = OpenCLContext::get().isReady();
+    cl_mem buf = nullptr;
+
+    for (const auto& c : conformanceCases()) {
+        size_t n = static_cast<size_t>(c.params.resLat) * c.params.resLon;
+        std::vector<float> a(n), b(n);
+        simd.perlinRegion(c.params, a.data());
+        scalar.perlinRegion(c.params, b.data());
+        results.push_back(compare(c.name, "CPU scalar", b, a, 0.0f));
+
+        std::vector<float> g;
+        if (gpu && openclRegion(c.params, buf, g))
+            results.push_back(compare(c.name, "OpenCL", g, a, kNoiseGpuTolerance));
+    }
+    if (buf) OpenCLContext::get().releaseMem(buf);
+    return results;
+}
+
+std::vector<NoiseThroughputResult> runNoiseThroughput()
+{
+    std::vector<NoiseThroughputResult> results;
+    PerlinRegionParams p{ 512, 512, 0.3f, 2.8f, 0.5f, 5.5f, 2.0f, 2.0f, 8, 0.5f, 1337u };
+    const size_t n = static_cast<size_t>(p.resLat) * p.resLon;
+    std::vector<float> out(n);
+
+    if (CpuNoiseBackend::available()) {
+        CpuNoiseBackend cpu;
+        unsigned workers = std::max(1u, std::thread::hardware_concurrency()) - 1;
+        struct Config { const char* name; CpuNoiseBackend::Path path; unsigned workers; };
+        const Config configs[] = {
+            { "CPU scalar", CpuNoiseBackend::Path::Scalar, 0 },
+            { "CPU SIMD",   CpuNoiseBackend::Path::SIMD,   0 },
+            { "CPU SIMD",   CpuNoiseBackend::Path::SIMD,   workers },
+        };
+        for (const auto& cfg : configs) {
+            if (&cfg == &configs[2] && workers == 0) break; // single core: same as row 2
+            cpu.setPath(cfg.path);
+            cpu.setThreadCount(cfg.workers);
+            NoiseThroughputResult r;
+            r.backend = cfg.name;
+            r.threads = cfg.workers + 1;
+            r.lanes = cpu.laneWidth();
+            r.samplesPerSec = samplesPerSec(n, [&] { return cpu.perlinRegion(p, out.data()); });
+            results.push_back(r);
+        }
+    }
+
+    if (OpenCLContext::get().isReady()) {
+        cl_mem buf = nullptr;
+        NoiseThroughputResult r;
+        r.backend = "OpenCL + readback";
+        r.samplesPerSec = samplesPerSec(n, [&] { return openclRegion(p, buf, out); });
+        results.push_back(r);
+        if (buf) OpenCLContext::get().releaseMem(buf);
+    }
+    return results;
+}
+
+bool logNoiseDiagnostics(const std::vector<NoiseConformanceResult>& conformance,
+                         const std::vector<NoiseThroughputResult>& throughput)
+{
+    bool allPass = true;
+    PLOGI << "Noise conformance (CPU SIMD backend vs reference)";
+    PLOGI << "case              reference     samples    exact   max abs err  mean abs err  result";
+    for (const auto& r : conformance) {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-16s  %-12s %8zu %8zu   %11.3e  %12.3e  %s",
+                      r.name.c_str(), r.reference.c_str(), r.samples, r.exactMatches,
+                      r.maxAbsError, r.meanAbsError, r.pass ? "ok" : "FAIL");
+        if (r.pass) PLOGI << line; else PLOGE << line;
+        allPass = allPass && r.pass;
+    }
+
+    PLOGI << "Noise throughput (512x512 region, 8 octaves)";
+    PLOGI << "backend              threads  lanes   Msamples/s";
+    for (const auto& r : throughput) {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-20s %7u  %5zu   %10.2f",
+                      r.backend.c_str(), r.threads, r.lanes, r.samplesPerSec / 1.0e6);
+        PLOGI << line;
+    }
+    return allPass;
+}
@@ -24,9 +24,9 @@ void MercatorProjection::setViewCenterRadians(float lonRad, float latRad)
 }
 void MercatorProjection::setZoomLevel(float z) { zoomLevel = z; }
 
-void MercatorProjection::project(World &world, int width, int height, GLuint &texture, std::string layerName)
+cl_mem MercatorProjection::projectToBuffer(World &world, int width, int height, const std::string &layerName)
 {
-    ZoneScopedN("MercatorProjection::project");
+    ZoneScopedN("MercatorProjection::projectToBuffer");
     bool projected = false;
 
     // ── Try region-aware path for dynamic resolution ─────────────
@@ -96,62 +96,29 @@ void MercatorProjection::project(World &world, int width, int height, GLuint &te
             }
             catch (const std::exception &ex)
             {
-                return;
+                return nullptr;
             }
         }
         else
         {
-            return;
+            return nullptr;
         }
     }
 
-    // Recreate texture if needed or channels changed
-    if (texture == 0)
-    {
-        ZoneScopedN("MercatorProjection Texture Create");
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        // RGBA float texture
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
-        glBindTexture(GL_TEXTURE_2D, texture);
-    }
-    else
+    if (!mercatorBuffer)
     {
-        ZoneScopedN("MercatorProjection Texture Resize Check");
-        // Texture exists, make sure its the right size
-        glBindTexture(GL_TEXTURE_2D, texture);
-        GLint texWidth = 0, texHeight = 0;
-        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &texWidth);
-        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &texHeight);
-        if (texWidth != width || texHeight != height)
-        {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
-        }
+        PLOGE << "mercatorBuffer is null";
     }
+    return mercatorBuffer;
+}
 
-    // Download data from mercatorBuffer to a host buffer and upload to the GL texture
-    if (mercatorBuffer)
-    {
-        ZoneScopedN("MercatorProjection Readback");
-        cl_int err = CL_SUCCESS;
-        size_t bufSize = (size_t)width * (size_t)height * sizeof(cl_float4);
-        std::vector<cl_float4> hostBuf((size_t)width * (size_t)height);
-        err = clEnqueueReadBuffer(OpenCLContext::get().getQueue(), mercatorBuffer, CL_TRUE, 0, bufSize, hostBuf.data(), 0, nullptr, nullptr);
-        if (err != CL_SUCCESS)
-        {
-            PLOGE << "clEnqueueReadBuffer failed: " << err;
-        }
-        clFinish(OpenCLContext::get().getQueue());
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_FLOAT, hostBuf.data());
-    }
-    else
+void MercatorProjection::project(World &world, int width, int height, GLuint &texture, std::string layerName)
+{
+    ZoneScopedN("MercatorProjection::project");
+    cl_mem buffer = projectToBuffer(world, width, height, layerName);
+    if (buffer)
     {
-        PLOGE << "mercatorBuffer is null";
+        ProjectionUpload::upload(buffer, width, height, texture, uploadFormat, GL_REPEAT);
     }
 }
 
@@ -178,24 +145,7 @@ void MercatorProjection::mercatorProject(
     if (mercatorProgram == nullptr)
     {
         ZoneScopedN("MercatorProjection Program Init");
-        std::string kernel_code = preprocessCLIncludes("Kernels/Mercator.cl");
-        const char *src = kernel_code.c_str();
-        size_t len = kernel_code.length();
-        mercatorProgram = clCreateProgramWithSource(ctx, 1, &src, &len, &err);
-        if (err != CL_SUCCESS || mercatorProgram == nullptr)
-            throw std::runtime_error("clCreateProgramWithSource failed for MercatorProjection");
-
-        err = clBuildProgram(mercatorProgram, 1, &device, nullptr, nullptr, nullptr);
-        if (err != CL_SUCCESS)
-        {
-            // retrieve build log
-            size_t log_size = 0;
-            clGetProgramBuildInfo(mercatorProgram, device, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
-            std::string log;
-            log.resize(log_size);
-            clGetProgramBuildInfo(mercatorProgram, device, CL_PROGRAM_BUILD_LOG, log_size, &log[0], nullptr);
-            throw std::runtime_error(std::string("Failed to build MercatorProjection OpenCL program: ") + log);
-        }
+        OpenCLContext::get().createProgram(mercatorProgram, "Kernels/Mercator.cl");
     }
 
     if (mercatorKernel == nullptr)
@@ -262,7 +212,7 @@ void MercatorProjection::mercatorProject(
     size_t global[2] = {(size_t)outW, (size_t)outH};
     {
         ZoneScopedN("MercatorProjection Enqueue");
-        err = clEnqueueNDRangeKernel(queue, mercatorKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, mercatorKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
     }
 }
 
@@ -294,23 +244,7 @@ void MercatorProjection::mercatorProjectRegion(
     if (mercatorProgram == nullptr)
     {
         ZoneScopedN("MercatorProjection Program Init (Region)");
-        std::string kernel_code = preprocessCLIncludes("Kernels/Mercator.cl");
-        const char *src = kernel_code.c_str();
-        size_t len = kernel_code.length();
-        mercatorProgram = clCreateProgramWithSource(ctx, 1, &src, &len, &err);
-        if (err != CL_SUCCESS || mercatorProgram == nullptr)
-            throw std::runtime_error("clCreateProgramWithSource failed for MercatorProjection");
-
-        err = clBuildProgram(mercatorProgram, 1, &device, nullptr, nullptr, nullptr);
-        if (err != CL_SUCCESS)
-        {
-            size_t log_size = 0;
-            clGetProgramBuildInfo(mercatorProgram, device, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
-            std::string log;
-            log.resize(log_size);
-            clGetProgramBuildInfo(mercatorProgram, device, CL_PROGRAM_BUILD_LOG, log_size, &log[0], nullptr);
-            throw std::runtime_error(std::string("Failed to build MercatorProjection OpenCL program: ") + log);
-        }
+        OpenCLContext::get().createProgram(mercatorProgram, "Kernels/Mercator.cl");
     }
 
     if (mercatorRegionKernel == nullptr)
@@ -368,6 +302,6 @@ void MercatorProjection::mercatorProjectRegion(
     size_t global[2] = {(size_t)outW, (size_t)outH};
     {
         ZoneScopedN("MercatorProjection Region Enqueue");
-        err = clEnqueueNDRangeKernel(queue, mercatorRegionKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        err = OpenCLContext::get().enqueueNDRangeKernel(queue, mercatorRegionKernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
     }
 }
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include <WorldMaps/World/QuadTreeBenchmark.hpp>
+#include <WorldMaps/World/QuadTree.hpp>
+#include <plog/Log.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+/// The flat hash-map quadtree QuadTree replaced, kept only as the
+/// benchmark baseline (same node semantics, one mutex for everything).
+class LegacyQuadTree {
+public:
+    LegacyQuadTree() {
+        ChunkData root;
+        root.coord = {0, 0, 0};
+        nodes_[root.coord] = std::move(root);
+    }
+
+    void ensureDepth(float lonMin, float lonMax, float latMin, float latMax, int depth) {
+        std::lock_guard<std::mutex> lk(mutex_);
+        depth = std::clamp(depth, 0, CHUNK_MAX_DEPTH);
+        int cells = 1 << depth;
+        float cellW = static_cast<float>(2.0 * M_PI) / cells;
+        float cellH = static_cast<float>(M_PI) / cells;
+        int xMin = std::clamp(static_cast<int>(std::floor((lonMin + static_cast<float>(M_PI)) / cellW)), 0, cells - 1);
+        int xMax = std::clamp(static_cast<int>(std::floor((lonMax + static_cast<float>(M_PI)) / cellW)), 0, cells - 1);
+        int yMin = std::clamp(static_cast<int>(std::floor((latMin + static_cast<float>(M_PI / 2.0)) / cellH)), 0, cells - 1);
+        int yMax = std::clamp(static_cast<int>(std::floor((latMax + static_cast<float>(M_PI / 2.0)) / cellH)), 0, cells - 1);
+        for (int cy = yMin; cy <= yMax; ++cy)
+            for (int cx = xMin; cx <= xMax; ++cx)
+                ensureNode({cx, cy, depth});
+    }
+
+    std::vector<ChunkCoord> getLeavesInBounds(float lonMin, float lonMax, float latMin, float latMax,
+                                              int maxDepth = -1) {
+        std::lock_guard<std::mutex> lk(mutex_);
+        std::vector<ChunkCoord> result;
+        collectLeaves({0, 0, 0}, lonMin, lonMax, latMin, latMax, maxDepth, result);
+        return result;
+    }
+
+    ChunkData* get(const ChunkCoord& coord) {
+        std::lock_guard<std::mutex> lk(mutex_);
+        auto it = nodes_.find(coord);
+        return (it != nodes_.end()) ? &it->second : nullptr;
+    }
+
+    size_t nodeCount() const {
+        std::lock_guard<std::mutex> lk(mutex_);
+        return nodes_.size();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<ChunkCoord, ChunkData, ChunkCoordHash> nodes_;
+
+    void ensureNode(const ChunkCoord& coord) {
+        std::vector<ChunkCoord> toCreate;
+        ChunkCoord c = coord;
+        while (nodes_.find(c) == nodes_.end()) {
+            toCreate.push_back(c);
+            if (c.depth == 0) break;
+            c = c.parent();
+        }
+        for (int i = static_cast<int>(toCreate.size()) - 1; i >= 0; --i) {
+            auto pit = nodes_.find(toCreate[i].parent());
+            if (pit != nodes_.end() && toCreate[i].depth > 0) pit->second.isLeaf = false;
+            ChunkData d;
+            d.coord = toCreate[i];
+            nodes_[toCreate[i]] = std::move(d);
+        }
+    }
+
+    void collectLeaves(const ChunkCoord& coord, float lonMin, float lonMax, float latMin, float latMax,
+                       int maxDepth, std::vector<ChunkCoord>& out) {
+        auto it = nodes_.find(coord);
+        if (it == nodes_.end()) return;
+        float cLonMin, cLonMax, cLatMin, cLatMax;
+        coord.getBoundsRadians(cLonMin, cLonMax, cLatMin, cLatMax);
+        if (cLonMax <= lonMin || cLonMin >= lonMax || cLatMax <= latMin || cLatMin >= latMax)
+            return;
+        if (it->second.isLeaf || (maxDepth >= 0 && coord.depth >= maxDepth)) {
+            out.push_back(coord);
+            return;
+        }
+        for (auto& kid : coord.children())
+            collectLeaves(kid, lonMin, lonMax, latMin, latMax, maxDepth, out);
+    }
+};
+
+using BenchClock = std::chrono::steady_clock;
+
+double elapsedUs(BenchClock::time_point t0) {
+    return std::chrono::duration<double, std::micro>(BenchClock::now() - t0).count();
+}
+
+struct View { float lonMin, lonMax, latMin, latMax; };
+
+/// Viewport of a 1024px map at `depth`: 32 chunks of 32 texels per axis,
+/// panned a quarter width per frame along a diagonal.
+View viewForFrame(int depth, int frame) {
+    float cellW = static_cast<float>(2.0 * M_PI) / (1 << depth);
+    float cellH = static_cast<float>(M_PI) / (1 << depth);
+    float w = 32.0f * cellW, h = 32.0f * cellH;
+    float lon = 0.3f + frame * 0.25f * w;
+    float lat = 0.2f + frame * 0.1f * h;
+    return { lon - w * 0.5f, lon + w * 0.5f, lat - h * 0.5f, lat + h * 0.5f };
+}
+
+template<typename Tree>
+QuadTreeBenchTimings runWorkload(Tree& tree, int depth, int frames) {
+    QuadTreeBenchTimings t;
+    size_t lookups = 0;
+    double lookupUs = 0.0;
+    for (int f = 0; f < frames; ++f) {
+        View v = viewForFrame(depth, f);
+        auto t0 = BenchClock::now();
+        tree.ensureDepth(v.lonMin, v.lonMax, v.latMin, v.latMax, depth);
+        t.ensureUs += elapsedUs(t0);
+
+        t0 = BenchClock::now();
+        auto leaves = tree.getLeavesInBounds(v.lonMin, v.lonMax, v.latMin, v.latMax, depth);
+        t.queryUs += elapsedUs(t0);
+
+        t0 = BenchClock::now();
+        size_t found = 0;
+        for (const auto& c : leaves) found += tree.get(c) ? 1 : 0;
+        lookupUs += elapsedUs(t0);
+        lookups += leaves.size();
+        if (found != leaves.size()) PLOGW << "QuadTree benchmark: missing leaf at depth " << depth;
+    }
+    t.ensureUs /= frames;
+    t.queryUs /= frames;
+    t.lookupNs = lookups ? lookupUs * 1000.0 / static_cast<double>(lookups) : 0.0;
+
+    // Render-thread query latency while a generation thread keeps inserting
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        for (int f = frames; !stop.load(std::memory_order_relaxed) && f < frames * 4; ++f) {
+            View v = viewForFrame(depth, f);
+            tree.ensureDepth(v.lonMin, v.lonMax, v.latMin, v.latMax, depth);
+        }
+    });
+    std::vector<double> samples;
+    View fixed = viewForFrame(depth, frames / 2);
+    for (int i = 0; i < frames * 4; ++i) {
+        auto t0 = BenchClock::now();
+        auto leaves = tree.getLeavesInBounds(fixed.lonMin, fixed.lonMax, fixed.latMin, fixed.latMax, depth);
+        samples.push_back(elapsedUs(t0));
+    }
+    stop.store(true, std::memory_order_relaxed);
+    writer.join();
+    std::sort(samples.begin(), samples.end());
+    t.contendedP99Us = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    return t;
+}
+
+} // namespace
+
+std::vector<QuadTreeBenchResult> runQuadTreeBenchmark(int minDepth, int maxDepth, int frames)
+{
+    minDepth = std::clamp(minDepth, 0, CHUNK_MAX_DEPTH);
+    maxDepth = std::clamp(maxDepth, minDepth, CHUNK_MAX_DEPTH);
+    frames = std::max(frames, 1);
+
+    std::vector<QuadTreeBenchResult> results;
+    for (int depth = minDepth; depth <= maxDepth; ++depth) {
+        QuadTreeBenchResult r;
+        r.depth = depth;
+        {
+            LegacyQuadTree legacy;
+            r.legacy = runWorkload(legacy, depth, frames);
+        }
+        {
+            QuadTree linear;
+            r.linear = runWorkload(linear, depth, frames);
+            r.nodes = linear.nodeCount();
+        }
+        results.push_back(r);
+    }
+    return results;
+}
+
+void logQuadTreeBenchmark(const std::vector<QuadTreeBenchResult>& results)
+{
+    PLOGI << "QuadTree benchmark (legacy hash map -> linear Morton tree)";
+    PLOGI << "depth    nodes   ensure us         query us          get ns        contended p99 us";
+    for (const auto& r : results) {
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "%5d %8zu   %7.1f -> %7.1f  %7.1f -> %7.1f  %6.1f -> %6.1f  %7.1f -> %7.1f",
+                      r.depth, r.nodes,
+                      r.legacy.ensureUs, r.linear.ensureUs,
+                      r.legacy.queryUs, r.linear.queryUs,
+                      r.legacy.lookupNs, r.linear.lookupNs,
+                      r.legacy.contendedP99Us, r.linear.contendedP99Us);
+        PLOGI << line;
+    }
+}
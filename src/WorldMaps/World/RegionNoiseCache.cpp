@@ -0,0 +1,182 @@
+#include <WorldMaps/World/RegionNoiseCache.hpp>
+#include <OpenCLContext.hpp>
+#include <tracy/Tracy.hpp>
+#include <plog/Log.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+size_t RegionNoiseKeyHash::operator()(const RegionNoiseKey& k) const
+{
+    uint32_t words[6];
+    std::memcpy(&words[0], &k.lonMin, 4);
+    std::memcpy(&words[1], &k.lonMax, 4);
+    std::memcpy(&words[2], &k.latMin, 4);
+    std::memcpy(&words[3], &k.latMax, 4);
+    words[4] = static_cast<uint32_t>(k.resX);
+    words[5] = static_cast<uint32_t>(k.resY);
+    uint64_t h = 1469598103934665603ull;
+    for (uint32_t w : words) {
+        h ^= w;
+        h *= 1099511628211ull;
+    }
+    return static_cast<size_t>(h);
+}
+
+RegionNoiseCache::~RegionNoiseCache()
+{
+    clear();
+}
+
+void RegionNoiseCache::clear()
+{
+    std::lock_guard<std::mutex> lk(mutex_);
+    for (auto& [key, entry] : entries_)
+        if (entry.buffer) OpenCLContext::get().releaseMem(entry.buffer);
+    entries_.clear();
+}
+
+void RegionNoiseCache::setMaxRegions(size_t maxRegions)
+{
+    std::lock_guard<std::mutex> lk(mutex_);
+    maxRegions_ = std::max<size_t>(maxRegions, 1);
+    evict();
+}
+
+size_t RegionNoiseCache::size() const
+{
+    std::lock_guard<std::mutex> lk(mutex_);
+    return entries_.size();
+}
+
+void RegionNoiseCache::evict()
+{
+    while (entries_.size() > maxRegions_) {
+        auto oldest = std::min_element(entries_.begin(), entries_.end(),
+            [](const auto& a, const auto& b) { return a.second.lastUse < b.second.lastUse; });
+        if (oldest->second.buffer) OpenCLContext::get().releaseMem(oldest->second.buffer);
+        entries_.erase(oldest);
+    }
+}
+
+RegionNoiseCache::Entry* RegionNoiseCache::ensure(const RegionNoiseKey& key,
+                                                  const std::vector<NoiseField>& fields,
+                                                  const FieldProvider& declared,
+                                                  std::vector<size_t>& planes)
+{
+    auto findPlanes = [&](const Entry& e) {
+        planes.clear();
+        for (const NoiseField& f : fields) {
+            auto it = std::find(e.fields.begin(), e.fields.end(), f);
+            if (it == e.fields.end()) return false;
+            planes.push_back(static_cast<size_t>(it - e.fields.begin()));
+        }
+        return true;
+    };
+
+    auto it = entries_.find(key);
+    if (it != entries_.end() && findPlanes(it->second)) {
+        it->second.lastUse = ++useCounter_;
+        return &it->second;
+    }
+
+    ZoneScopedN("RegionNoiseCache miss");
+    // Everything the layers declare, plus what this request needs that they
+    // don't (e.g. per-chunk parameter overrides), deduplicated.  Declared
+    // order is kept so fields sharing a lattice stay adjacent for the kernel.
+    std::vector<NoiseField> all;
+    if (declared) all = declared();
+    for (const NoiseField& f : fields) all.push_back(f);
+    std::vector<NoiseField> unique;
+    unique.reserve(all.size());
+    for (const NoiseField& f : all)
+        if (std::find(unique.begin(), unique.end(), f) == unique.end())
+            unique.push_back(f);
+
+    float thetaMin = static_cast<float>(M_PI / 2.0) - key.latMax;
+    float thetaMax = static_cast<float>(M_PI / 2.0) - key.latMin;
+    float phiMin = key.lonMin + static_cast<float>(M_PI);
+    float phiMax = key.lonMax + static_cast<float>(M_PI);
+
+    cl_mem buffer = nullptr;
+    try {
+        perlinRegionFields(buffer, key.resY, key.resX, thetaMin, thetaMax, phiMin, phiMax, unique);
+    } catch (const std::exception& ex) {
+        PLOGE << "RegionNoiseCache: " << ex.what();
+        if (buffer) OpenCLContext::get().releaseMem(buffer);
+        return nullptr;
+    }
+    if (!buffer) return nullptr;
+
+    Entry& e = entries_[key];
+    if (e.buffer) OpenCLContext::get().releaseMem(e.buffer);
+    e.fields = std::move(unique);
+    e.buffer = buffer;
+    e.lastUse = ++useCounter_;
+    findPlanes(e);
+    evict();
+    // evict() never drops the newest entry
+    return &entries_.at(key);
+}
+
+cl_mem RegionNoiseCache::acquire(const RegionNoiseKey& key, const std::vector<NoiseField>& fields,
+                                 const FieldProvider& declared)
+{
+    ZoneScopedN("RegionNoiseCache::acquire");
+    if (!OpenCLContext::get().isReady() || fields.empty()) return nullptr;
+    std::lock_guard<std::mutex> lk(mutex_);
+    std::vector<size_t> planes;
+    Entry* e = ensure(key, fields, declared, planes);
+    if (!e) return nullptr;
+
+    size_t planeBytes = static_cast<size_t>(key.resX) * key.resY * sizeof(float);
+    cl_int err = CL_SUCCESS;
+    cl_mem out = OpenCLContext::get().createBuffer(CL_MEM_READ_WRITE, planeBytes * fields.size(),
+                                                   nullptr, &err, "RegionNoiseCache acquire");
+    if (err != CL_SUCCESS || !out) return nullptr;
+
+    cl_command_queue queue = OpenCLContext::get().getQueue();
+    for (size_t i = 0; i < planes.size(); ) {
+        // Copy runs of consecutive planes in one command
+        size_t run = 1;
+        while (i + run < planes.size() && planes[i + run] == planes[i] + run) ++run;
+        err = clEnqueueCopyBuffer(queue, e->buffer, out, planes[i] * planeBytes, i * planeBytes,
+                                  run * planeBytes, 0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            OpenCLContext::get().releaseMem(out);
+            return nullptr;
+        }
+        i += run;
+    }
+    return out;
+}
+
+bool RegionNoiseCache::read(const RegionNoiseKey& key, const std::vector<NoiseField>& fields,
+                            const FieldProvider& declared, std::vector<float>& out)
+{
+    ZoneScopedN("RegionNoiseCache::read");
+    if (!OpenCLContext::get().isReady() || fields.empty()) return false;
+    std::lock_guard<std::mutex> lk(mutex_);
+    std::vector<size_t> planes;
+    Entry* e = ensure(key, fields, declared, planes);
+    if (!e) return false;
+
+    size_t planeFloats = static_cast<size_t>(key.resX) * key.resY;
+    out.resize(planeFloats * fields.size());
+    cl_command_queue queue = OpenCLContext::get().getQueue();
+    for (size_t i = 0; i < planes.size(); ) {
+        size_t run = 1;
+        while (i + run < planes.size() && planes[i + run] == planes[i] + run) ++run;
+        bool last = i + run == planes.size();
+        cl_int err = OpenCLContext::get().enqueueReadBuffer(queue, e->buffer, last ? CL_TRUE : CL_FALSE,
+                                                            planes[i] * planeFloats * sizeof(float),
+                                                            run * planeFloats * sizeof(float),
+                                                            out.data() + i * planeFloats, 0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            clFinish(queue);
+            return false;
+        }
+        i += run;
+    }
+    return true;
+}
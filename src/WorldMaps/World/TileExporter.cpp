@@ -0,0 +1,445 @@
+#include <WorldMaps/World/TileExporter.hpp>
+#include <nlohmann/json.hpp>
+#include <plog/Log.h>
+#include <tracy/Tracy.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+/// One assembled region read back to the host (row 0 = north).
+struct RegionImage {
+    std::vector<float> texels;
+    int width = 0;
+    int height = 0;
+    int channels = 4;                   // 4 = RGBA color, 1 = scalar samples
+    float lonMinDeg = 0.0f, lonMaxDeg = 0.0f;
+    float latMinDeg = 0.0f, latMaxDeg = 0.0f;
+};
+
+struct TileJob {
+    std::shared_ptr<const RegionImage> region;
+    int zoom = 0, x = 0, y = 0;
+    std::filesystem::path path;
+};
+
+/// Bounded multi-consumer queue between the generating thread and the
+/// encode workers; push() blocks while full so readbacks cannot run ahead.
+class TileQueue {
+public:
+    explicit TileQueue(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {}
+
+    void push(TileJob job) {
+        std::unique_lock<std::mutex> lk(mutex_);
+        notFull_.wait(lk, [&] { return jobs_.size() < capacity_; });
+        jobs_.push_back(std::move(job));
+        notEmpty_.notify_one();
+    }
+
+    bool pop(TileJob& out) {
+        std::unique_lock<std::mutex> lk(mutex_);
+        notEmpty_.wait(lk, [&] { return closed_ || !jobs_.empty(); });
+        if (jobs_.empty()) return false;
+        out = std::move(jobs_.front());
+        jobs_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lk(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable notFull_, notEmpty_;
+    std::deque<TileJob> jobs_;
+    size_t capacity_;
+    bool closed_ = false;
+};
+
+/// Resample a region into one Mercator tile.  Same mapping as
+/// sphere_to_mercator_rgba_region in Mercator.cl, sampled at pixel
+/// centres; texels outside the region are left zero (transparent).
+void resampleTile(const RegionImage& region, int zoom, int tx, int ty, int size,
+                  std::vector<float>& out)
+{
+    const int ch = region.channels;
+    out.assign(static_cast<size_t>(size) * size * ch, 0.0f);
+    const double n = static_cast<double>(1 << zoom);
+    const double lonSpan = region.lonMaxDeg - region.lonMinDeg;
+    const double latSpan = region.latMaxDeg - region.latMinDeg;
+    if (lonSpan <= 0.0 || latSpan <= 0.0) return;
+
+    // Columns share a longitude and rows a latitude: resolve each once
+    std::vector<int> colTex(size), rowTex(size);
+    for (int u = 0; u < size; ++u) {
+        double lon = -180.0 + (tx + (u + 0.5) / size) * 360.0 / n;
+        double local = std::fmod(lon - region.lonMinDeg, 360.0);
+        if (local < 0.0) local += 360.0;
+        double texU = local / lonSpan;
+        colTex[u] = texU < 1.0 ? std::min(static_cast<int>(texU * region.width), region.width - 1) : -1;
+    }
+    for (int v = 0; v < size; ++v) {
+        double mercY = kPi * (1.0 - 2.0 * (ty + (v + 0.5) / size) / n);
+        double lat = std::atan(std::sinh(mercY)) * 180.0 / kPi;
+        double texV = (region.latMaxDeg - lat) / latSpan;
+        rowTex[v] = (texV >= 0.0 && texV < 1.0)
+                        ? std::min(static_cast<int>(texV * region.height), region.height - 1) : -1;
+    }
+
+    for (int v = 0; v < size; ++v) {
+        if (rowTex[v] < 0) continue;
+        const float* src = region.texels.data() + static_cast<size_t>(rowTex[v]) * region.width * ch;
+        float* dst = out.data() + static_cast<size_t>(v) * size * ch;
+        for (int u = 0; u < size; ++u) {
+            if (colTex[u] < 0) continue;
+            std::copy_n(src + static_cast<size_t>(colTex[u]) * ch, ch, dst + static_cast<size_t>(u) * ch);
+        }
+    }
+}
+
+/// Move a finished temporary file over `path` (rename does not replace
+/// existing files on every platform).
+bool replaceFile(const std::filesystem::path& tmp, const std::filesystem::path& path)
+{
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(path, ec);
+        std::filesystem::rename(tmp, path, ec);
+    }
+    return !ec;
+}
+
+bool writeTile(const TileJob& job, int size, TileFormat format)
+{
+    ZoneScopedN("TileExporter::writeTile");
+    std::vector<float> tile;
+    resampleTile(*job.region, job.zoom, job.x, job.y, size, tile);
+
+    std::error_code ec;
+    std::filesystem::create_directories(job.path.parent_path(), ec);
+    std::filesystem::path tmp = job.path;
+    tmp += ".tmp";
+
+    bool ok = false;
+    if (format == TileFormat::PNG) {
+        std::vector<uint8_t> rgba(tile.size());
+        for (size_t i = 0; i < tile.size(); ++i)
+            rgba[i] = static_cast<uint8_t>(std::clamp(tile[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+        ok = stbi_write_png(tmp.string().c_str(), size, size, 4, rgba.data(), size * 4) != 0;
+    } else {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        f.write(reinterpret_cast<const char*>(tile.data()),
+                static_cast<std::streamsize>(tile.size() * sizeof(float)));
+        ok = static_cast<bool>(f);
+    }
+    if (ok) ok = replaceFile(tmp, job.path);
+    if (!ok) {
+        std::filesystem::remove(tmp, ec);
+        PLOGE << "TileExporter: failed to write " << job.path.string();
+    }
+    return ok;
+}
+
+const char* formatName(TileFormat f) { return f == TileFormat::PNG ? "png" : "f32"; }
+
+nlohmann::json manifestBounds(const TileExportOptions& opts)
+{
+    return { opts.lonMinDeg, opts.latMinDeg, opts.lonMaxDeg, opts.latMaxDeg };
+}
+
+} // namespace
+
+// ── Tile math ────────────────────────────────────────────────────────
+
+int TileExporter::lonToTileX(float lonDeg, int zoom)
+{
+    int n = 1 << zoom;
+    int x = static_cast<int>(std::floor((lonDeg + 180.0) / 360.0 * n));
+    return std::clamp(x, 0, n - 1);
+}
+
+int TileExporter::latToTileY(float latDeg, int zoom)
+{
+    int n = 1 << zoom;
+    double lat = std::clamp(static_cast<double>(latDeg), -85.05112878, 85.05112878) * kPi / 180.0;
+    double y = (1.0 - std::log(std::tan(lat) + 1.0 / std::cos(lat)) / kPi) / 2.0 * n;
+    return std::clamp(static_cast<int>(std::floor(y)), 0, n - 1);
+}
+
+float TileExporter::tileXToLon(int x, int zoom)
+{
+    return static_cast<float>(x * 360.0 / (1 << zoom) - 180.0);
+}
+
+float TileExporter::tileYToLat(int y, int zoom)
+{
+    double mercY = kPi * (1.0 - 2.0 * y / (1 << zoom));
+    return static_cast<float>(std::atan(std::sinh(mercY)) * 180.0 / kPi);
+}
+
+// ── TileExporter ─────────────────────────────────────────────────────
+
+TileExporter::TileExporter(World& world, TileExportOptions options)
+    : world_(world), opts_(std::move(options))
+{
+    opts_.minZoom = std::clamp(opts_.minZoom, 0, 24);
+    opts_.maxZoom = std::clamp(opts_.maxZoom, opts_.minZoom, 24);
+    opts_.tileSize = std::clamp(opts_.tileSize, 16, 4096);
+    opts_.blockTiles = std::max(opts_.blockTiles, 1);
+    if (opts_.layers.empty()) opts_.layers = world_.getLayerNames();
+    std::sort(opts_.layers.begin(), opts_.layers.end());
+}
+
+void TileExporter::settleLayers(World& world, int maxTicks)
+{
+    ZoneScopedN("TileExporter::settleLayers");
+    auto pending = [&] {
+        for (const auto& name : world.getLayerNames()) {
+            const MapLayer* layer = world.getLayer(name);
+            if (layer && layer->getProgress() < 1.0f) return true;
+        }
+        return false;
+    };
+    int ticks = 0;
+    while (pending() && ticks < maxTicks) {
+        world.tick();
+        ++ticks;
+    }
+    if (ticks) PLOGI << "TileExporter: layers settled after " << ticks << " ticks";
+    if (pending()) PLOGW << "TileExporter: layers still incomplete after " << maxTicks << " ticks";
+}
+
+bool TileExporter::checkManifest() const
+{
+    std::filesystem::path path = opts_.outputDir / "manifest.json";
+    if (opts_.overwrite || !std::filesystem::exists(path)) return true;
+    try {
+        std::ifstream f(path);
+        nlohmann::json m = nlohmann::json::parse(f);
+        // Compared as JSON so the values match exactly what writeManifest() stored
+        const nlohmann::json layers = opts_.layers;
+        const nlohmann::json bounds = manifestBounds(opts_);
+        if (m.value("format", "") != formatName(opts_.format) ||
+            m.value("tileSize", 0) != opts_.tileSize ||
+            m.value("config", "") != opts_.configTag ||
+            m.value("layers", nlohmann::json()) != layers ||
+            m.value("bounds", nlohmann::json()) != bounds) {
+            PLOGE << "TileExporter: " << path.string() << " was written by a different job "
+                  << "(format/tile size/config/layers/bounds); pass overwrite to replace it";
+            return false;
+        }
+    } catch (const std::exception& e) {
+        PLOGW << "TileExporter: ignoring unreadable manifest: " << e.what();
+    }
+    return true;
+}
+
+void TileExporter::writeManifest(const TileExportStats& stats, bool complete) const
+{
+    nlohmann::json m;
+    m["scheme"] = "xyz";
+    m["format"] = formatName(opts_.format);
+    m["tileSize"] = opts_.tileSize;
+    m["config"] = opts_.configTag;
+    m["layers"] = opts_.layers;
+    m["minZoom"] = opts_.minZoom;
+    m["maxZoom"] = opts_.maxZoom;
+    m["bounds"] = manifestBounds(opts_);
+    m["progress"] = {
+        { "planned", stats.planned }, { "written", stats.written },
+        { "skipped", stats.skipped }, { "failed", stats.failed },
+        { "seconds", stats.seconds }, { "tilesPerSec", stats.tilesPerSec() },
+        { "complete", complete }
+    };
+
+    std::error_code ec;
+    std::filesystem::create_directories(opts_.outputDir, ec);
+    std::filesystem::path path = opts_.outputDir / "manifest.json";
+    std::filesystem::path tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::trunc);
+        f << m.dump(2);
+    }
+    replaceFile(tmp, path);
+}
+
+TileExportStats TileExporter::run(const std::atomic<bool>* cancel)
+{
+    ZoneScopedN("TileExporter::run");
+    TileExportStats stats;
+    if (!OpenCLContext::get().isReady()) {
+        PLOGE << "TileExporter: OpenCL context is not ready";
+        return stats;
+    }
+    if (!checkManifest()) return stats;
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    const bool scalar = opts_.format == TileFormat::Float32;
+    const int size = opts_.tileSize;
+    const int block = opts_.blockTiles;
+
+    // Tiles must not depend on what happened to be cached: no provisional
+    // parent crops, no parents filtered from children.
+    const ChunkLODOptions savedLOD = world_.getLODOptions();
+    world_.setLODOptions({false, false, savedLOD.refineBudget});
+
+    unsigned workers = opts_.workers;
+    if (workers == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        workers = hw > 1 ? hw - 1 : 1;
+    }
+
+    // ── Encode/write pool ────────────────────────────────────────
+    TileQueue queue(static_cast<size_t>(2 * block * block));
+    std::atomic<size_t> written{0}, failed{0};
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < workers; ++i) {
+        pool.emplace_back([&] {
+            TileJob job;
+            while (queue.pop(job)) {
+                if (writeTile(job, size, opts_.format)) written.fetch_add(1, std::memory_order_relaxed);
+                else failed.fetch_add(1, std::memory_order_relaxed);
+                job = TileJob{};
+            }
+        });
+    }
+
+    auto snapshot = [&] {
+        stats.written = written.load();
+        stats.failed = failed.load();
+        stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    };
+
+    // Plan
+    struct ZoomRange { int z, x0, x1, y0, y1; };
+    std::vector<ZoomRange> zooms;
+    for (int z = opts_.minZoom; z <= opts_.maxZoom; ++z) {
+        ZoomRange r{ z, lonToTileX(opts_.lonMinDeg, z), lonToTileX(opts_.lonMaxDeg, z),
+                     latToTileY(opts_.latMaxDeg, z), latToTileY(opts_.latMinDeg, z) };
+        stats.planned += static_cast<size_t>(r.x1 - r.x0 + 1) * (r.y1 - r.y0 + 1) * opts_.layers.size();
+        zooms.push_back(r);
+    }
+    PLOGI << "TileExporter: " << stats.planned << " tiles, zoom " << opts_.minZoom << "-" << opts_.maxZoom
+          << ", " << opts_.layers.size() << " layer(s), " << workers << " writer thread(s)";
+    writeManifest(stats, false);
+
+    cl_command_queue clQueue = OpenCLContext::get().getQueue();
+    auto lastReport = Clock::now();
+    bool cancelled = false;
+
+    for (const std::string& layerName : opts_.layers) {
+        MapLayer* layer = world_.getLayer(layerName);
+        if (!layer || !layer->supportsRegion()) {
+            PLOGW << "TileExporter: layer '" << layerName << "' has no region pipeline, skipped";
+            continue;
+        }
+        for (const ZoomRange& zr : zooms) {
+            const int depth = QuadTree::computeDepthForZoom(static_cast<float>(1 << zr.z), size);
+            for (int by = zr.y0; by <= zr.y1 && !cancelled; by += block) {
+                for (int bx = zr.x0; bx <= zr.x1 && !cancelled; bx += block) {
+                    if (cancel && cancel->load()) { cancelled = true; break; }
+                    const int bx1 = std::min(bx + block - 1, zr.x1);
+                    const int by1 = std::min(by + block - 1, zr.y1);
+
+                    // Resume: only generate blocks with missing tiles
+                    std::vector<TileJob> jobs;
+                    for (int ty = by; ty <= by1; ++ty)
+                        for (int tx = bx; tx <= bx1; ++tx) {
+                            std::filesystem::path p = opts_.outputDir / layerName / std::to_string(zr.z) /
+                                                      std::to_string(tx) /
+                                                      (std::to_string(ty) + "." + formatName(opts_.format));
+                            if (!opts_.overwrite && std::filesystem::exists(p)) { ++stats.skipped; continue; }
+                            jobs.push_back({ nullptr, zr.z, tx, ty, std::move(p) });
+                        }
+                    if (jobs.empty()) continue;
+
+                    // Generate and read back the block's region
+                    auto region = std::make_shared<RegionImage>();
+                    region->channels = scalar ? 1 : 4;
+                    region->lonMinDeg = tileXToLon(bx, zr.z);
+                    region->lonMaxDeg = tileXToLon(bx1 + 1, zr.z);
+                    region->latMinDeg = tileYToLat(by1 + 1, zr.z);
+                    region->latMaxDeg = tileYToLat(by, zr.z);
+                    cl_mem buf = nullptr;
+                    try {
+                        ZoneScopedN("TileExporter Generate Block");
+                        buf = scalar
+                            ? world_.getSampleForRegion(layerName, region->lonMinDeg, region->lonMaxDeg,
+                                                        region->latMinDeg, region->latMaxDeg,
+                                                        depth, region->width, region->height)
+                            : world_.getColorForRegion(layerName, region->lonMinDeg, region->lonMaxDeg,
+                                                       region->latMinDeg, region->latMaxDeg,
+                                                       depth, region->width, region->height);
+                        if (buf) {
+                            region->texels.resize(static_cast<size_t>(region->width) * region->height *
+                                                  region->channels);
+                            cl_event ready = world_.getAssemblyEvent();
+                            cl_int err = OpenCLContext::get().enqueueReadBuffer(clQueue, buf, CL_TRUE, 0,
+                                                             region->texels.size() * sizeof(float),
+                                                             region->texels.data(),
+                                                             ready ? 1 : 0, ready ? &ready : nullptr, nullptr);
+                            if (err != CL_SUCCESS) buf = nullptr;
+                        }
+                    } catch (const std::exception& e) {
+                        PLOGE << "TileExporter: region generation failed: " << e.what();
+                        buf = nullptr;
+                    }
+                    if (!buf) {
+                        failed.fetch_add(jobs.size());
+                        continue;
+                    }
+
+                    std::shared_ptr<const RegionImage> shared = std::move(region);
+                    for (auto& job : jobs) {
+                        job.region = shared;
+                        queue.push(std::move(job));
+                    }
+                    world_.evictChunkCaches(opts_.maxCachedChunks);
+
+                    if (Clock::now() - lastReport > std::chrono::seconds(5)) {
+                        lastReport = Clock::now();
+                        snapshot();
+                        PLOGI << "TileExporter: " << layerName << " z" << zr.z << "  "
+                              << (stats.written + stats.skipped) << "/" << stats.planned << " tiles, "
+                              << static_cast<int>(stats.tilesPerSec()) << " tiles/s";
+                        writeManifest(stats, false);
+                    }
+                }
+            }
+        }
+    }
+
+    queue.close();
+    for (auto& t : pool) t.join();
+    snapshot();
+    writeManifest(stats, !cancelled && stats.failed == 0);
+    world_.setLODOptions(savedLOD);
+
+    char line[200];
+    std::snprintf(line, sizeof(line),
+                  "TileExporter: %zu written, %zu skipped, %zu failed in %.1f s (%.1f tiles/s)%s",
+                  stats.written, stats.skipped, stats.failed, stats.seconds, stats.tilesPerSec(),
+                  cancelled ? " [cancelled]" : "");
+    PLOGI << line;
+    return stats;
+}
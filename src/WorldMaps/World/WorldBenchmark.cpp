@@ -0,0 +1,276 @@
+#include <WorldMaps/World/WorldBenchmark.hpp>
+#include <WorldMaps/World/World.hpp>
+#include <WorldMaps/World/TileExporter.hpp>
+#include <WorldMaps/World/NoiseBackend.hpp>
+#include <WorldMaps/World/Projections/MercatorProjection.hpp>
+#include <WorldMaps/World/Projections/SphereProjection.hpp>
+#include <OpenCLContext.hpp>
+#include <nlohmann/json.hpp>
+#include <plog/Log.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+
+namespace {
+
+using BenchClock = std::chrono::steady_clock;
+
+double percentile(std::vector<double> samples, int pct) {
+    if (samples.empty()) return 0.0;
+    std::sort(samples.begin(), samples.end());
+    return samples[std::min(samples.size() - 1, samples.size() * pct / 100)];
+}
+
+std::string deviceName() {
+    cl_device_id device = OpenCLContext::get().getDevice();
+    if (!device) return "none";
+    char name[256] = {0};
+    clGetDeviceInfo(device, CL_DEVICE_NAME, sizeof(name) - 1, name, nullptr);
+    return name;
+}
+
+const char* noiseBackendName() {
+    return activeNoiseBackend() == NoiseBackendKind::CPU ? cpuNoiseBackend().name() : "OpenCL";
+}
+
+/// Globe defaults from WorldMap (fov 45°).
+constexpr float kGlobeFovDeg = 45.0f;
+
+WorldBenchResult runScript(const WorldBenchConfig& cfg, const WorldBenchScript& script,
+                           const WorldBenchOptions& options) {
+    WorldBenchResult r;
+    r.config = cfg.name;
+    r.script = script.name;
+    if (script.view == WorldBenchScript::View::Globe && !options.useGL) {
+        r.skipped = true;
+        return r;
+    }
+
+    World world;
+    world.parseConfig(cfg.config);
+    TileExporter::settleLayers(world);
+    const std::string layer = options.layerOverride.empty() ? cfg.displayLayer : options.layerOverride;
+
+    RegionPipelineStats stats;
+    stats.synchronous = options.synchronous;
+    world.setPipelineStats(&stats);
+
+    MercatorProjection mercator;
+    SphericalProjection globe;
+    mercator.setUploadFormat(ProjectionUpload::Format::RGBA8);
+    globe.setUploadFormat(ProjectionUpload::Format::RGBA8);
+    globe.setFov(kGlobeFovDeg * static_cast<float>(M_PI) / 180.0f);
+    GLuint texture = 0;
+
+    const int frames = std::max(options.frames > 0 ? options.frames : script.frames, 1);
+    std::vector<double> frameMs;
+    frameMs.reserve(frames);
+    OpenCLContext::get().resetCounters();
+
+    for (int f = 0; f < frames; ++f) {
+        float t = frames > 1 ? static_cast<float>(f) / static_cast<float>(frames - 1) : 0.0f;
+        float lon = script.lon0 + (script.lon1 - script.lon0) * t;
+        float lat = script.lat0 + (script.lat1 - script.lat0) * t;
+        float zoom = script.zoom0 * std::pow(script.zoom1 / script.zoom0, t);
+        // Keep lon in [-180, 180) the way WorldMap wraps drags
+        lon = std::fmod(lon + 540.0f, 360.0f) - 180.0f;
+        float lonRad = lon * static_cast<float>(M_PI) / 180.0f;
+        float latRad = lat * static_cast<float>(M_PI) / 180.0f;
+
+        auto t0 = BenchClock::now();
+        world.tick();
+        if (script.view == WorldBenchScript::View::Globe) {
+            globe.setViewCenterRadians(lonRad, latRad);
+            globe.setZoomLevel(zoom);
+            globe.project(world, options.width, options.height, texture, layer);
+        } else {
+            mercator.setViewCenterRadians(lonRad, latRad);
+            mercator.setZoomLevel(zoom);
+            if (options.useGL)
+                mercator.project(world, options.width, options.height, texture, layer);
+            else
+                mercator.projectToBuffer(world, options.width, options.height, layer);
+        }
+        clFinish(OpenCLContext::get().getQueue());
+        if (options.useGL) glFinish();
+        frameMs.push_back(std::chrono::duration<double, std::milli>(BenchClock::now() - t0).count());
+    }
+
+    world.setPipelineStats(nullptr);
+    if (texture) glDeleteTextures(1, &texture);
+
+    OpenCLContext::Counters c = OpenCLContext::get().counters();
+    r.frames = frames;
+    r.frameP50Ms = percentile(frameMs, 50);
+    r.frameP99Ms = percentile(frameMs, 99);
+    r.chunkP50Us = percentile(stats.chunkUs, 50);
+    r.chunkP99Us = percentile(stats.chunkUs, 99);
+    r.chunksGenerated = stats.chunksGenerated;
+    r.chunksUpsampled = stats.chunksUpsampled;
+    r.chunksDownsampled = stats.chunksDownsampled;
+    r.regionCalls = stats.calls;
+    r.selectMs = stats.selectUs / 1000.0;
+    r.generateMs = stats.generateUs / 1000.0;
+    r.assembleMs = stats.assembleUs / 1000.0;
+    r.buffersCreated = c.buffersCreated;
+    r.bytesCreated = c.bytesCreated;
+    r.bytesReadBack = c.bytesReadBack;
+    r.kernelLaunches = c.kernelLaunches;
+    r.kernelMs = c.kernelMs;
+    r.topKernels.assign(c.kernelMsByName.begin(), c.kernelMsByName.end());
+    std::sort(r.topKernels.begin(), r.topKernels.end(),
+              [](const auto& a, const auto& b) { return a.second > b.second; });
+    if (r.topKernels.size() > 5) r.topKernels.resize(5);
+    return r;
+}
+
+} // namespace
+
+std::vector<WorldBenchConfig> defaultWorldBenchConfigs()
+{
+    return {
+        {"elevation", "elevation", "elevation"},
+        {"climate", "elevation,temperature(seed:231354),humidity,watertable,landtype", "landtype"},
+        {"full", "elevation,temperature(seed:231354),humidity,watertable,landtype,river,"
+                 "tectonics(seed:7,steps:200),buildings(seed:42)", "buildings"},
+    };
+}
+
+std::vector<WorldBenchScript> defaultWorldBenchScripts()
+{
+    using View = WorldBenchScript::View;
+    return {
+        {"mercator-pan",      View::Mercator, 120,   0.0f,  10.0f,  4.0f,  90.0f, 30.0f,   4.0f},
+        {"mercator-zoom-in",  View::Mercator, 120,  12.0f,  45.0f,  1.0f,  12.0f, 45.0f, 256.0f},
+        {"mercator-zoom-out", View::Mercator, 120,  12.0f,  45.0f, 256.0f, 12.0f, 45.0f,   1.0f},
+        {"mercator-zoom-pan", View::Mercator, 120, -40.0f, -10.0f,  2.0f,  20.0f, 25.0f,  64.0f},
+        {"globe-spin",        View::Globe,    120,   0.0f,  20.0f,  3.0f, 360.0f, 20.0f,   3.0f},
+    };
+}
+
+std::vector<WorldBenchResult> runWorldBenchmark(const std::vector<WorldBenchConfig>& configs,
+                                                const std::vector<WorldBenchScript>& scripts,
+                                                const WorldBenchOptions& options)
+{
+    std::vector<WorldBenchResult> results;
+    for (const auto& cfg : configs) {
+        for (const auto& script : scripts) {
+            PLOGI << "World benchmark: " << cfg.name << " / " << script.name;
+            results.push_back(runScript(cfg, script, options));
+        }
+    }
+    return results;
+}
+
+void logWorldBenchmark(const std::vector<WorldBenchResult>& results)
+{
+    PLOGI << "World benchmark on " << deviceName() << " (noise: " << noiseBackendName() << ")";
+    PLOGI << "config     script              frame p50/p99 ms   chunk p50/p99 us   chunks  select/gen/asm ms        buffers  MB read  kernels  kernel ms";
+    for (const auto& r : results) {
+        char line[320];
+        if (r.skipped) {
+            std::snprintf(line, sizeof(line), "%-10s %-18s  skipped (no GL)", r.config.c_str(), r.script.c_str());
+        } else {
+            std::snprintf(line, sizeof(line),
+                          "%-10s %-18s  %7.2f / %7.2f  %7.1f / %8.1f  %6zu  %7.1f / %7.1f / %6.1f  %7llu  %7.1f  %7llu  %9.1f",
+                          r.config.c_str(), r.script.c_str(),
+                          r.frameP50Ms, r.frameP99Ms, r.chunkP50Us, r.chunkP99Us, r.chunksGenerated,
+                          r.selectMs, r.generateMs, r.assembleMs,
+                          static_cast<unsigned long long>(r.buffersCreated),
+                          static_cast<double>(r.bytesReadBack) / (1024.0 * 1024.0),
+                          static_cast<unsigned long long>(r.kernelLaunches), r.kernelMs);
+        }
+        PLOGI << line;
+        if (r.chunksUpsampled || r.chunksDownsampled)
+            PLOGI << "    LOD reuse: " << r.chunksUpsampled << " upsampled, "
+                  << r.chunksDownsampled << " downsampled";
+        for (const auto& [name, ms] : r.topKernels)
+            PLOGI << "    " << name << ": " << ms << " ms";
+    }
+}
+
+std::string worldBenchmarkJson(const std::vector<WorldBenchResult>& results,
+                               const WorldBenchOptions& options, const std::string& tag)
+{
+    nlohmann::json j;
+    j["tag"] = tag;
+    j["device"] = deviceName();
+    j["noiseBackend"] = noiseBackendName();
+    j["kernelProfiling"] = OpenCLContext::get().isKernelProfiling();
+    j["width"] = options.width;
+    j["height"] = options.height;
+    j["gl"] = options.useGL;
+    j["synchronous"] = options.synchronous;
+    nlohmann::json runs = nlohmann::json::array();
+    for (const auto& r : results) {
+        nlohmann::json run;
+        run["config"] = r.config;
+        run["script"] = r.script;
+        run["skipped"] = r.skipped;
+        if (!r.skipped) {
+            run["frames"] = r.frames;
+            run["frameP50Ms"] = r.frameP50Ms;
+            run["frameP99Ms"] = r.frameP99Ms;
+            run["chunkP50Us"] = r.chunkP50Us;
+            run["chunkP99Us"] = r.chunkP99Us;
+            run["chunksGenerated"] = r.chunksGenerated;
+            run["chunksUpsampled"] = r.chunksUpsampled;
+            run["chunksDownsampled"] = r.chunksDownsampled;
+            run["regionCalls"] = r.regionCalls;
+            run["selectMs"] = r.selectMs;
+            run["generateMs"] = r.generateMs;
+            run["assembleMs"] = r.assembleMs;
+            run["buffersCreated"] = r.buffersCreated;
+            run["bytesCreated"] = r.bytesCreated;
+            run["bytesReadBack"] = r.bytesReadBack;
+            run["kernelLaunches"] = r.kernelLaunches;
+            run["kernelMs"] = r.kernelMs;
+            nlohmann::json kernels = nlohmann::json::object();
+            for (const auto& [name, ms] : r.topKernels) kernels[name] = ms;
+            run["topKernels"] = kernels;
+        }
+        runs.push_back(run);
+    }
+    j["results"] = runs;
+    return j.dump(2);
+}
+
+int compareWorldBenchmark(const std::vector<WorldBenchResult>& results,
+                          const std::string& baselineJson, double thresholdPct)
+{
+    nlohmann::json base = nlohmann::json::parse(baselineJson, nullptr, false);
+    if (base.is_discarded() || !base.contains("results")) {
+        PLOGE << "World benchmark: baseline is not a benchmark report";
+        return -1;
+    }
+    std::map<std::pair<std::string, std::string>, nlohmann::json> baseRuns;
+    for (const auto& run : base["results"])
+        if (!run.value("skipped", false))
+            baseRuns[{run.value("config", ""), run.value("script", "")}] = run;
+
+    PLOGI << "Comparing against baseline '" << base.value("tag", "") << "' on " << base.value("device", "?");
+    int regressions = 0;
+    auto check = [&](const WorldBenchResult& r, const char* metric, double before, double now) {
+        if (before <= 0.0) return;
+        double pct = (now - before) / before * 100.0;
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-10s %-18s %-11s %9.2f -> %9.2f  (%+.1f%%)",
+                      r.config.c_str(), r.script.c_str(), metric, before, now, pct);
+        if (pct > thresholdPct) {
+            PLOGW << line << "  REGRESSION";
+            ++regressions;
+        } else {
+            PLOGI << line;
+        }
+    };
+    for (const auto& r : results) {
+        if (r.skipped) continue;
+        auto it = baseRuns.find({r.config, r.script});
+        if (it == baseRuns.end()) continue;
+        check(r, "frame p99", it->second.value("frameP99Ms", 0.0), r.frameP99Ms);
+        check(r, "chunk p99", it->second.value("chunkP99Us", 0.0), r.chunkP99Us);
+    }
+    return regressions;
+}
@@ -13,6 +13,13 @@ void World::loadDeltasFromVault()
 
     PLOGI << "Loading " << records.size() << " layer deltas from vault";
 
+    // Create all referenced nodes in one quadtree publish
+    std::vector<ChunkCoord> coords;
+    coords.reserve(records.size());
+    for (const auto& rec : records)
+        coords.push_back({rec.chunkX, rec.chunkY, rec.chunkDepth});
+    quadTree_.ensureNodes(coords);
+
     for (const auto& rec : records) {
         ChunkCoord coord;
         coord.x = rec.chunkX;
@@ -40,6 +47,7 @@ void World::loadDeltasFromVault()
         if (!rec.paramOverrides.empty()) {
             delta.deserializeParams(rec.paramOverrides);
         }
+        delta.markClean(); // matches what is stored
 
         // Mark the chunk as dirty so the next render regenerates with the delta
         cd->markDirty(rec.layerName);
@@ -53,31 +61,54 @@ void World::saveDeltasToVault()
     ZoneScopedN("World::saveDeltasToVault");
     if (!m_vault) return;
 
-    int saved = 0;
+    // Collect only deltas changed since the last save.  Deltas that were
+    // edited back to empty are removed from the DB instead of rewritten.
+    struct Saved { ChunkCoord coord; std::string layerName; uint64_t revision; };
+    std::vector<Vault::LayerDeltaRecord> upserts;
+    std::vector<Vault::LayerDeltaRecord> removals;
+    std::vector<Saved> saved;
 
     quadTree_.forEachNode([&](const ChunkData& data) {
         for (const auto& [layerName, delta] : data.layerDeltas) {
-            if (!delta.hasEdits()) continue;
-
-            auto blob = delta.serializeData();
-            auto params = delta.serializeParams();
-
-            bool ok = m_vault->saveLayerDelta(
-                data.coord.x, data.coord.y, data.coord.depth,
-                layerName,
-                delta.channelCount, delta.resolution,
-                static_cast<int>(delta.mode),
-                blob, params);
-
-            if (ok) {
-                ++saved;
+            if (!delta.isDirty()) continue;
+
+            Vault::LayerDeltaRecord rec;
+            rec.chunkX = data.coord.x;
+            rec.chunkY = data.coord.y;
+            rec.chunkDepth = data.coord.depth;
+            rec.layerName = layerName;
+            rec.channelCount = delta.channelCount;
+            rec.resolution = delta.resolution;
+            rec.deltaMode = static_cast<int>(delta.mode);
+            if (delta.hasEdits()) {
+                rec.deltaData = delta.serializeData();
+                rec.paramOverrides = delta.serializeParams();
+                upserts.push_back(std::move(rec));
             } else {
-                PLOGW << "Failed to save delta for chunk ("
-                      << data.coord.x << "," << data.coord.y
-                      << "," << data.coord.depth << ") layer=" << layerName;
+                removals.push_back(std::move(rec));
             }
+            saved.push_back({data.coord, layerName, delta.revision()});
         }
     });
 
-    PLOGI << "Saved " << saved << " layer deltas to vault";
+    if (saved.empty()) {
+        PLOGI << "No layer delta changes to save";
+        return;
+    }
+
+    if (!m_vault->saveLayerDeltasBatch(upserts, removals)) {
+        PLOGW << "Failed to save " << saved.size() << " layer deltas (transaction rolled back)";
+        return;
+    }
+
+    // Mark clean at the revision that was written (later edits stay dirty)
+    for (const Saved& s : saved) {
+        ChunkData* cd = quadTree_.get(s.coord);
+        if (!cd) continue;
+        auto it = cd->layerDeltas.find(s.layerName);
+        if (it != cd->layerDeltas.end()) it->second.markClean(s.revision);
+    }
+
+    PLOGI << "Saved " << upserts.size() << " layer deltas to vault ("
+          << removals.size() << " removed)";
 }
@@ -1,11 +1,14 @@
 #include <WorldMaps/WorldMap.hpp>
 #include <Vault.hpp>
+#include <WorldMaps/World/BrushEngine.hpp>
+#include <WorldMaps/World/NoiseBackend.hpp>
 
 // ── Shared editing state (accessible from mercatorMap and worldMap) ────
 static int  g_editMode       = 0;     // 0=Browse, 1=Paint
 static float g_brushRadius   = 3.0f;  // in texels at current zoom
 static float g_brushStrength = 0.1f;
 static int   g_brushDeltaMode = 0;    // 0=Add, 1=Set
+static BrushEngine g_brush;           // active paint stroke
 
 void mercatorMap(const char *label, ImVec2 texSize, World &world)
 {
@@ -102,6 +105,7 @@ void mercatorMap(const char *label, ImVec2 texSize, World &world)
     // Update Mercator projection camera from UI state (deg -> rad)
     mercatorProj.setViewCenterRadians(mapCenterLon * static_cast<float>(M_PI) / 180.0f, mapCenterLat * static_cast<float>(M_PI) / 180.0f);
     mercatorProj.setZoomLevel(mapZoom);
+    mercatorProj.setUploadFormat(ProjectionUpload::Format::RGBA8);
 
     mercatorProj.project(world, texSize.x, texSize.y,worldMapTexture, selectedLayerName);
 
@@ -193,62 +197,25 @@ void mercatorMap(const char *label, ImVec2 texSize, World &world)
             // Determine current depth from zoom
             int depth = QuadTree::computeDepthForZoom(mapZoom, std::max(static_cast<int>(texSize.x), static_cast<int>(texSize.y)));
 
-            // Convert to radians for chunk lookup
+            // Stroke across chunks: dabs are interpolated from the previous
+            // frame's position and stamped into every overlapping chunk.
             float lonRad = lonDeg * static_cast<float>(M_PI) / 180.0f;
             float latRad = latDeg * static_cast<float>(M_PI) / 180.0f;
 
-            // Clamp to valid range
-            lonRad = std::clamp(lonRad, -static_cast<float>(M_PI), static_cast<float>(M_PI));
-            latRad = std::clamp(latRad, -static_cast<float>(M_PI) / 2.0f, static_cast<float>(M_PI) / 2.0f);
-
-            // Find the chunk containing this point
-            int cells = 1 << depth;
-            float lonRange = static_cast<float>(2.0 * M_PI);
-            float latRange = static_cast<float>(M_PI);
-            float cellW = lonRange / cells;
-            float cellH = latRange / cells;
-            int cx = static_cast<int>(std::floor((lonRad + static_cast<float>(M_PI)) / cellW));
-            int cy = static_cast<int>(std::floor((latRad + static_cast<float>(M_PI / 2.0)) / cellH));
-            cx = std::clamp(cx, 0, cells - 1);
-            cy = std::clamp(cy, 0, cells - 1);
-            ChunkCoord coord{cx, cy, depth};
-
-            // Find the sample position within the chunk
-            float cLonMin, cLonMax, cLatMin, cLatMax;
-            coord.getBoundsRadians(cLonMin, cLonMax, cLatMin, cLatMax);
-            float localU = (lonRad - cLonMin) / (cLonMax - cLonMin);
-            float localV = (latRad - cLatMin) / (cLatMax - cLatMin);
-
-            // Apply brush (iterate over brush radius in sample space)
-            int brushRadSamples = std::max(1, static_cast<int>(g_brushRadius));
-            int centerSX = static_cast<int>(localU * CHUNK_BASE_RES);
-            int centerSY = static_cast<int>(localV * CHUNK_BASE_RES);
-
-            LayerDelta& delta = world.getOrCreateDelta(coord, selectedLayerName);
-            delta.mode = static_cast<DeltaMode>(g_brushDeltaMode);
-
-            for (int bdy = -brushRadSamples; bdy <= brushRadSamples; ++bdy) {
-                for (int bdx = -brushRadSamples; bdx <= brushRadSamples; ++bdx) {
-                    int sx = centerSX + bdx;
-                    int sy = centerSY + bdy;
-                    if (sx < 0 || sx >= CHUNK_BASE_RES || sy < 0 || sy >= CHUNK_BASE_RES)
-                        continue;
-                    float dist = std::sqrt(static_cast<float>(bdx * bdx + bdy * bdy));
-                    if (dist > g_brushRadius) continue;
-                    float falloff = 1.0f - (dist / g_brushRadius);
-                    float strength = g_brushStrength * falloff;
-
-                    if (g_brushDeltaMode == 0) { // Add
-                        float old = delta.getDelta(sx, sy);
-                        delta.setDelta(sx, sy, 0, old + strength);
-                    } else { // Set
-                        delta.setDelta(sx, sy, 0, strength);
-                    }
-                }
-            }
-            world.markChunkDirty(coord, selectedLayerName);
+            if (!g_brush.isStroking())
+                g_brush.beginStroke(selectedLayerName, depth);
+
+            BrushEngine::Settings brush;
+            brush.radius = g_brushRadius;
+            brush.strength = g_brushStrength;
+            brush.mode = static_cast<DeltaMode>(g_brushDeltaMode);
+            g_brush.strokeTo(world, lonRad, latRad, brush);
         }
     }
+    else if (g_brush.isStroking())
+    {
+        g_brush.endStroke();
+    }
 
     // Overlay UI (translucent box at bottom-left of the Mercator preview)
     ImGui::BeginGroup();
@@ -438,6 +405,7 @@ void globeMap(const char *label, ImVec2 texSize, World &world)
     sphereProj.setViewCenterRadians(globeCenterLon * static_cast<float>(M_PI) / 180.0f, globeCenterLat * static_cast<float>(M_PI) / 180.0f);
     sphereProj.setZoomLevel(globeZoom);
     sphereProj.setFov(globeFovDeg * static_cast<float>(M_PI) / 180.0f);
+    sphereProj.setUploadFormat(ProjectionUpload::Format::RGBA8);
 
     std::string selectedLayerNameGlobe = selectedLayerName; // reuse selection
     sphereProj.project(world, texSize.x, texSize.y, globeTexture, selectedLayerNameGlobe);
@@ -596,6 +564,16 @@ void worldMap(bool& m_isOpen, Vault* vault)
             if (ImGui::BeginMenu("View"))
             {
                 ImGui::DragFloat2("Preview Size", &texSize.x, 8.0f, 128.0f, 2048.0f, "%.0f");
+
+                // Regenerate every cached chunk when the noise source changes
+                static const char* kNoiseBackends[] = { "Auto", "OpenCL", "CPU" };
+                int noiseBackend = static_cast<int>(noiseBackendSetting());
+                if (ImGui::Combo("Noise Backend", &noiseBackend, kNoiseBackends, IM_ARRAYSIZE(kNoiseBackends))) {
+                    setNoiseBackend(static_cast<NoiseBackendKind>(noiseBackend));
+                    world.getQuadTree().forEachNode([](ChunkData& d) { d.markAllDirty(); });
+                }
+                ImGui::TextDisabled("Active: %s", activeNoiseBackend() == NoiseBackendKind::CPU
+                                                      ? cpuNoiseBackend().name() : "OpenCL");
                 ImGui::EndMenu();
             }
 
@@ -635,6 +613,30 @@ void worldMap(bool& m_isOpen, Vault* vault)
             ImGui::PopStyleColor();
         }
 
+        // ── Incremental layer generation (tectonics simulation) ──
+        world.tick();
+        if (auto* tec = dynamic_cast<TectonicsLayer*>(world.getLayer("tectonics")))
+        {
+            using SimState = TectonicsLayer::SimulationState;
+            SimState simState = tec->getState();
+            if (simState == SimState::Running || simState == SimState::Cancelled)
+            {
+                char overlay[64];
+                snprintf(overlay, sizeof(overlay), "Tectonics %d / %d%s",
+                         tec->getCompletedSteps(), tec->getTotalSteps(),
+                         simState == SimState::Cancelled ? " (paused)" : "");
+                ImGui::ProgressBar(tec->getProgress(), ImVec2(-200.0f, 0.0f), overlay);
+                ImGui::SameLine();
+                if (simState == SimState::Running) {
+                    if (ImGui::Button("Cancel")) tec->cancel();
+                } else {
+                    if (ImGui::Button("Resume")) tec->resume();
+                }
+                ImGui::SameLine();
+                if (ImGui::Button("Restart")) tec->restart();
+            }
+        }
+
         mercatorMap("Mercator World Map", texSize, world);
         ImGui::SameLine();
         globeMap("Globe World Map", texSize, world);
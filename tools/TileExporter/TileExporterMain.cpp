@@ -0,0 +1,147 @@
+// Headless world tile pyramid exporter.
+//
+//   LoreBookTileExport --vault MyVault.db --world Terra --zoom 0 6 --out tiles/
+//   LoreBookTileExport --config "elevation,temperature" --layers elevation --format f32 --out raw/
+//
+// Re-running the same command resumes an interrupted export.
+
+#include <WorldMaps/World/TileExporter.hpp>
+#include <WorldMaps/World/NoiseBackend.hpp>
+#include <Vault.hpp>
+#include <LoreBook_Resources/LoreBook_ResourcesEmbeddedVFS.hpp>
+#include <CLI/CLI.hpp>
+#include <plog/Log.h>
+#include <plog/Init.h>
+#include <plog/Appenders/ConsoleAppender.h>
+#include <plog/Formatters/TxtFormatter.h>
+#include <csignal>
+
+namespace {
+
+std::atomic<bool> g_cancel{false};
+
+void onSignal(int) { g_cancel.store(true); }
+
+/// Find the config of world `worldName` in the vault's notes: the
+/// bracketed part of a vault://World/<name>(<config>)/<projection> embed.
+bool findWorldConfig(Vault& vault, const std::string& worldName, std::string& config)
+{
+    const std::string prefix = "vault://World/";
+    for (const auto& [id, itemName] : vault.getAllItemsPublic()) {
+        std::string content = vault.getItemContentPublic(id);
+        for (size_t pos = content.find(prefix); pos != std::string::npos;
+             pos = content.find(prefix, pos + 1)) {
+            // The URL ends at the markdown link's ')' or whitespace outside any brackets
+            size_t begin = pos + prefix.size(), end = begin;
+            int depth = 0;
+            for (; end < content.size(); ++end) {
+                char c = content[end];
+                if (c == '(' || c == '[' || c == '{') ++depth;
+                else if (c == ')' || c == ']' || c == '}') { if (depth == 0) break; --depth; }
+                else if (depth == 0 && std::isspace(static_cast<unsigned char>(c))) break;
+            }
+            std::vector<std::string> parts = splitBracketAware(content.substr(begin, end - begin), "/");
+            if (parts.empty()) continue;
+            std::string name, cfg;
+            splitNameConfig(parts[0], name, cfg);
+            if (name == worldName) {
+                PLOGI << "World '" << worldName << "' found in note '" << itemName << "'";
+                config = cfg;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    static plog::ConsoleAppender<plog::TxtFormatter> consoleAppender(plog::streamStdErr);
+    plog::init(plog::info, &consoleAppender);
+
+    CLI::App app{"LoreBook headless world tile pyramid exporter"};
+    std::string vaultPath, worldName, config, format = "png", noise = "auto";
+    std::vector<std::string> layers;
+    std::vector<int> zoom{0, 4};
+    std::vector<float> bounds{-180.0f, -85.0511f, 180.0f, 85.0511f};
+    TileExportOptions opts;
+    std::string outDir = "tiles";
+
+    app.add_option("--vault", vaultPath, "Vault database containing the world embed")->check(CLI::ExistingFile);
+    app.add_option("--world", worldName, "World name as used in vault://World/<name>(...)");
+    app.add_option("--config", config, "World config string (instead of --vault/--world)");
+    app.add_option("--layers", layers, "Layers to export (default: all)")->delimiter(',');
+    app.add_option("--zoom", zoom, "Min and max zoom")->expected(2);
+    app.add_option("--bounds", bounds, "lonMin latMin lonMax latMax in degrees")->expected(4);
+    app.add_option("--format", format, "Tile format")->check(CLI::IsMember({"png", "f32"}));
+    app.add_option("--tile-size", opts.tileSize, "Tile edge in pixels");
+    app.add_option("--threads", opts.workers, "Encode/write threads (0 = auto)");
+    app.add_option("--block", opts.blockTiles, "Tiles per axis generated per region request");
+    app.add_option("--noise", noise, "Noise backend")->check(CLI::IsMember({"auto", "opencl", "cpu"}));
+    app.add_option("--out", outDir, "Output directory");
+    app.add_flag("--overwrite", opts.overwrite, "Rewrite existing tiles and ignore the old manifest");
+    CLI11_PARSE(app, argc, argv);
+
+    if (config.empty() && (vaultPath.empty() || worldName.empty())) {
+        PLOGE << "Pass either --config or both --vault and --world";
+        return 2;
+    }
+
+    try {
+        if (!OpenCLContext::get().init()) {
+            PLOGE << "Failed to initialize OpenCL context!";
+            return 1;
+        }
+    } catch (const std::exception& ex) {
+        PLOGE << "Failed to initialize OpenCL: " << ex.what();
+        return 1;
+    }
+    if (!initLoreBook_ResourcesEmbeddedVFS(argv[0]) || !mountLoreBook_ResourcesEmbeddedVFS()) {
+        PLOGE << "Failed to mount LoreBook embedded resources VFS!";
+        return 1;
+    }
+    setNoiseBackend(noise == "cpu" ? NoiseBackendKind::CPU
+                    : noise == "opencl" ? NoiseBackendKind::OpenCL : NoiseBackendKind::Auto);
+    PLOGI << "Noise backend: " << (activeNoiseBackend() == NoiseBackendKind::CPU ? cpuNoiseBackend().name() : "OpenCL");
+
+    std::unique_ptr<Vault> vault;
+    if (!vaultPath.empty()) {
+        std::filesystem::path p(vaultPath);
+        vault = std::make_unique<Vault>(p.parent_path(), p.filename().string());
+        if (config.empty() && !findWorldConfig(*vault, worldName, config)) {
+            PLOGE << "No vault://World/" << worldName << "(...) embed found in " << vaultPath;
+            return 1;
+        }
+    }
+
+    World world;
+    world.parseConfig(config);
+    if (world.getLayerNames().empty()) {
+        PLOGE << "World config '" << config << "' defines no layers";
+        return 1;
+    }
+    if (vault) {
+        world.setVault(vault.get());
+        world.loadDeltasFromVault();
+    }
+    TileExporter::settleLayers(world);
+
+    opts.outputDir = outDir;
+    opts.layers = layers;
+    opts.minZoom = zoom[0];
+    opts.maxZoom = zoom[1];
+    opts.lonMinDeg = bounds[0];
+    opts.latMinDeg = bounds[1];
+    opts.lonMaxDeg = bounds[2];
+    opts.latMaxDeg = bounds[3];
+    opts.format = format == "f32" ? TileFormat::Float32 : TileFormat::PNG;
+    opts.configTag = config;
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    TileExporter exporter(world, opts);
+    TileExportStats stats = exporter.run(&g_cancel);
+    return (stats.failed == 0 && !g_cancel.load()) ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+// World generation benchmark.
+//
+//   LoreBookWorldBench --json bench.json --tag $(git rev-parse --short HEAD)
+//   LoreBookWorldBench --compare bench.json --threshold 10
+//   LoreBookWorldBench --configs climate --scripts mercator-zoom-in --frames 300
+//
+// Replays the canonical camera scripts over fixed-seed worlds through the
+// same World::tick + projection path WorldMap uses.  With --compare the
+// exit code is 3 when a frame or chunk p99 regressed past --threshold.
+
+#include <WorldMaps/World/WorldBenchmark.hpp>
+#include <WorldMaps/World/NoiseBackend.hpp>
+#include <OpenCLContext.hpp>
+#include <LoreBook_Resources/LoreBook_ResourcesEmbeddedVFS.hpp>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <CLI/CLI.hpp>
+#include <plog/Log.h>
+#include <plog/Init.h>
+#include <plog/Appenders/ConsoleAppender.h>
+#include <plog/Formatters/TxtFormatter.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+/// Hidden window so projections can upload textures like they do in the app.
+GLFWwindow* createHiddenGLContext()
+{
+    if (!glfwInit()) return nullptr;
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(64, 64, "LoreBookWorldBench", nullptr, nullptr);
+    if (!window) {
+        glfwTerminate();
+        return nullptr;
+    }
+    glfwMakeContextCurrent(window);
+    if (glewInit() != GLEW_OK) {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return nullptr;
+    }
+    return window;
+}
+
+template<typename T>
+std::vector<T> selectByName(std::vector<T> all, const std::vector<std::string>& names)
+{
+    if (names.empty()) return all;
+    all.erase(std::remove_if(all.begin(), all.end(), [&](const T& item) {
+                  return std::find(names.begin(), names.end(), item.name) == names.end();
+              }), all.end());
+    return all;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    static plog::ConsoleAppender<plog::TxtFormatter> consoleAppender(plog::streamStdErr);
+    plog::init(plog::info, &consoleAppender);
+
+    CLI::App app{"LoreBook world generation benchmark"};
+    WorldBenchOptions opts;
+    std::string jsonPath, comparePath, tag, noise = "auto";
+    std::vector<std::string> configNames, scriptNames;
+    std::vector<int> size{opts.width, opts.height};
+    double threshold = 10.0;
+    bool headless = false, async = false, noProfile = false;
+
+    app.add_option("--json", jsonPath, "Write the report to this file");
+    app.add_option("--tag", tag, "Label stored in the report (e.g. a commit hash)");
+    app.add_option("--compare", comparePath, "Baseline report to compare against")->check(CLI::ExistingFile);
+    app.add_option("--threshold", threshold, "Allowed p99 growth in percent");
+    app.add_option("--configs", configNames, "World configs to run (default: all)")->delimiter(',');
+    app.add_option("--scripts", scriptNames, "Camera scripts to run (default: all)")->delimiter(',');
+    app.add_option("--layer", opts.layerOverride, "Project this layer instead of each config's default");
+    app.add_option("--frames", opts.frames, "Frames per script (default: per script)");
+    app.add_option("--size", size, "Projected texture width and height")->expected(2);
+    app.add_option("--noise", noise, "Noise backend")->check(CLI::IsMember({"auto", "opencl", "cpu"}));
+    app.add_flag("--headless", headless, "Skip GL: project Mercator into an OpenCL buffer only");
+    app.add_flag("--async", async, "Do not synchronize between pipeline stages");
+    app.add_flag("--no-kernel-profiling", noProfile, "Leave the queue without profiling enabled");
+    CLI11_PARSE(app, argc, argv);
+
+    opts.width = std::max(size[0], 1);
+    opts.height = std::max(size[1], 1);
+    opts.synchronous = !async;
+
+    OpenCLContext::get().setKernelProfiling(!noProfile);
+    try {
+        if (!OpenCLContext::get().init()) {
+            PLOGE << "Failed to initialize OpenCL context!";
+            return 1;
+        }
+    } catch (const std::exception& ex) {
+        PLOGE << "Failed to initialize OpenCL: " << ex.what();
+        return 1;
+    }
+
+    GLFWwindow* window = headless ? nullptr : createHiddenGLContext();
+    if (!headless && !window)
+        PLOGW << "No OpenGL context; running headless (Mercator only, no texture upload)";
+    opts.useGL = window != nullptr;
+    if (window && !OpenCLContext::get().initGLInterop())
+        PLOGW << "CL/GL interop not available";
+
+    if (!initLoreBook_ResourcesEmbeddedVFS(argv[0]) || !mountLoreBook_ResourcesEmbeddedVFS()) {
+        PLOGE << "Failed to mount LoreBook embedded resources VFS!";
+        return 1;
+    }
+    setNoiseBackend(noise == "cpu" ? NoiseBackendKind::CPU
+                    : noise == "opencl" ? NoiseBackendKind::OpenCL : NoiseBackendKind::Auto);
+
+    // Keep kernel compilation out of the measured frames
+    OpenCLContext::get().warmUpPrograms("Kernels");
+    OpenCLContext::get().waitForWarmUp();
+
+    auto configs = selectByName(defaultWorldBenchConfigs(), configNames);
+    auto scripts = selectByName(defaultWorldBenchScripts(), scriptNames);
+    if (configs.empty() || scripts.empty()) {
+        PLOGE << "No matching configs or scripts";
+        return 2;
+    }
+
+    auto results = runWorldBenchmark(configs, scripts, opts);
+    logWorldBenchmark(results);
+
+    int exitCode = 0;
+    if (!jsonPath.empty()) {
+        std::ofstream out(jsonPath);
+        out << worldBenchmarkJson(results, opts, tag) << "\n";
+        if (!out) {
+            PLOGE << "Failed to write " << jsonPath;
+            exitCode = 1;
+        }
+    }
+    if (!comparePath.empty()) {
+        std::ifstream in(comparePath);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        int regressions = compareWorldBenchmark(results, ss.str(), threshold);
+        if (regressions < 0) exitCode = 1;
+        else if (regressions > 0) exitCode = 3;
+    }
+
+    if (window) {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
+    return exitCode;
+}